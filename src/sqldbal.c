@@ -13,13 +13,35 @@
 # define SQLDBAL_IS_WINDOWS
 #endif /* SQLDBAL_IS_WINDOWS */
 
+#if !defined(SQLDBAL_IS_WINDOWS) && !defined(_POSIX_C_SOURCE)
+/**
+ * The connection pool and the trace thread need the POSIX thread
+ * functions, and the statement metrics and the SQLite busy handling need
+ * the clock functions.
+ */
+# define _POSIX_C_SOURCE 200809L
+#endif /* POSIX */
+
+#if defined(SQLDBAL_POOL) || defined(SQLDBAL_SQLITE)
+/**
+ * Build @ref sqldbal_time_ms.
+ */
+# define SQLDBAL_HAS_TIME_MS
+#endif /* SQLDBAL_POOL || SQLDBAL_SQLITE */
+
 #ifdef SQLDBAL_IS_WINDOWS
 # include <winsock2.h>
 #else /* POSIX */
+# include <poll.h>
 # include <sys/select.h>
+# if defined(SQLDBAL_POOL) || defined(SQLDBAL_TRACE)
+#  include <pthread.h>
+# endif /* SQLDBAL_POOL || SQLDBAL_TRACE */
+# include <time.h>
 #endif /* SQLDBAL_IS_WINDOWS */
 
 #include <errno.h>
+#include <float.h>
 #include <inttypes.h>
 #include <limits.h>
 #include <stdint.h>
@@ -44,6 +66,200 @@
 # define SQLDBAL_LINKAGE static
 #endif /* SQLDBAL_TEST */
 
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+/**
+ * Give each thread its own copy of the error sentinels returned when the
+ * library cannot allocate a handle.
+ */
+# define SQLDBAL_THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+# define SQLDBAL_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+# define SQLDBAL_THREAD_LOCAL __thread
+#else /* Thread-local storage not available. */
+# define SQLDBAL_THREAD_LOCAL
+#endif /* __STDC_VERSION__ */
+
+#ifdef SQLDBAL_TRACE
+# ifdef _MSC_VER
+/**
+ * Atomically read a uint64_t shared between threads, ordered before the
+ * reads that follow it.
+ *
+ * @param[in] ptr Pointer to the value.
+ */
+#  define SQLDBAL_ATOMIC_LOAD(ptr) \
+  ((uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(ptr), 0, 0))
+
+/**
+ * Atomically write a uint64_t shared between threads, ordered after the
+ * writes that come before it.
+ *
+ * @param[in] ptr Pointer to the value.
+ * @param[in] val New value.
+ */
+#  define SQLDBAL_ATOMIC_STORE(ptr, val) \
+  InterlockedExchange64((volatile LONG64 *)(ptr), (LONG64)(val))
+
+/**
+ * Atomically add to a uint64_t counter shared between threads.
+ *
+ * @param[in] ptr Pointer to the counter.
+ * @param[in] val Amount to add.
+ */
+#  define SQLDBAL_ATOMIC_ADD(ptr, val) \
+  InterlockedExchangeAdd64((volatile LONG64 *)(ptr), (LONG64)(val))
+
+/**
+ * Atomically replace a uint64_t with @p desired if it still equals
+ * @p expected.
+ *
+ * @param[in] ptr      Pointer to the value.
+ * @param[in] expected Value read earlier.
+ * @param[in] desired  New value.
+ * @retval 1 Replaced the value.
+ * @retval 0 Another thread changed the value first.
+ */
+#  define SQLDBAL_ATOMIC_CAS(ptr, expected, desired)                  \
+  ((uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(ptr),   \
+                                          (LONG64)(desired),          \
+                                          (LONG64)(expected)) ==      \
+   (expected))
+# else /* GCC and Clang */
+#  define SQLDBAL_ATOMIC_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#  define SQLDBAL_ATOMIC_STORE(ptr, val) \
+  __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#  define SQLDBAL_ATOMIC_ADD(ptr, val) \
+  __atomic_fetch_add(ptr, val, __ATOMIC_RELAXED)
+#  define SQLDBAL_ATOMIC_CAS(ptr, expected, desired)            \
+  __atomic_compare_exchange_n(ptr, &(expected), desired, 1,     \
+                              __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+# endif /* _MSC_VER */
+
+/**
+ * Check if the library has to time the statements of a connection for
+ * @ref sqldbal_trace_attach, because the driver does not time them.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+# define SQLDBAL_TRACE_DISPATCH(db) ((db)->trace && (db)->trace_driver == 0)
+#else /* !(SQLDBAL_TRACE) */
+# define SQLDBAL_TRACE_DISPATCH(db) 0
+#endif /* SQLDBAL_TRACE */
+
+#ifdef SQLDBAL_SINGLE_DRIVER
+/**
+ * Paste the driver prefix into the name of its function table.
+ *
+ * @param[in] driver Driver prefix: mariadb, pq, or sqlite.
+ */
+# define SQLDBAL_SINGLE_FUNCTIONS_PASTE(driver) g_sqldbal_##driver##_functions
+
+/**
+ * Expand the driver prefix before pasting it into the table name.
+ *
+ * @param[in] driver Driver prefix: mariadb, pq, or sqlite.
+ */
+# define SQLDBAL_SINGLE_FUNCTIONS_NAME(driver) \
+  SQLDBAL_SINGLE_FUNCTIONS_PASTE(driver)
+
+/**
+ * Function table of the only driver that connections can use.
+ */
+# define SQLDBAL_SINGLE_FUNCTIONS \
+  SQLDBAL_SINGLE_FUNCTIONS_NAME(SQLDBAL_SINGLE_DRIVER)
+
+/**
+ * Get the driver functions of a connection.
+ *
+ * When building with SQLDBAL_SINGLE_DRIVER set to mariadb, pq, or sqlite,
+ * this refers to the constant table of that driver instead of loading it
+ * from the connection. The compiler can then resolve every driver call
+ * to a direct call and inline it into the public functions.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+# define SQLDBAL_FUNCTIONS(db) (&SQLDBAL_SINGLE_FUNCTIONS)
+#else /* !(SQLDBAL_SINGLE_DRIVER) */
+/**
+ * Get the driver functions of a connection.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+# define SQLDBAL_FUNCTIONS(db) ((db)->functions)
+#endif /* SQLDBAL_SINGLE_DRIVER */
+
+/**
+ * Chunks of a blob placeholder collected by @ref sqldbal_stmt_send_blob,
+ * for drivers that need the entire value before executing.
+ */
+struct sqldbal_stmt_stream{
+  /**
+   * Bytes sent since @ref sqldbal_stmt_bind_blob_stream.
+   */
+  char *buf;
+
+  /**
+   * Number of bytes used in @ref buf.
+   */
+  size_t len;
+
+  /**
+   * Number of bytes allocated in @ref buf.
+   */
+  size_t size;
+
+  /**
+   * Set to 1 after @ref sqldbal_stmt_bind_blob_stream.
+   */
+  int active;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Value bound to a placeholder of a statement that uses the
+ * @ref sqldbal_result_cache, which becomes part of the cache key.
+ */
+struct sqldbal_result_param{
+  /**
+   * Bytes of the value. Points to @ref buf, or to the application memory
+   * after a static bind, which must stay valid until the execution.
+   */
+  const void *data;
+
+  /**
+   * Copy of the value for the binds that let the application reuse its
+   * memory right away.
+   */
+  char *buf;
+
+  /**
+   * Number of bytes at @ref data.
+   */
+  size_t len;
+
+  /**
+   * Number of bytes allocated in @ref buf.
+   */
+  size_t size;
+
+  /**
+   * See @ref sqldbal_column_type.
+   */
+  enum sqldbal_column_type type;
+
+  /**
+   * Set to 1 if the value can be part of the cache key. Stays 0 before
+   * the first bind, after @ref sqldbal_stmt_bind_blob_stream, and after
+   * running out of memory while copying the value.
+   */
+  int cacheable;
+};
+
 /**
  * Prepared statement compiled by the driver.
  */
@@ -68,11 +284,156 @@ struct sqldbal_stmt{
    */
   void *handle;
 
+  /**
+   * Copy of the SQL text used as the key in the
+   * @ref sqldbal_stmt_cache, or NULL if @ref sqldbal_stmt_close should
+   * free the statement instead of returning it to the cache.
+   */
+  char *cache_sql;
+
+  /**
+   * Length of @ref cache_sql in bytes.
+   */
+  size_t cache_sql_len;
+
+  /**
+   * Hash of @ref cache_sql. See @ref sqldbal_stmt_cache_hash.
+   */
+  uint64_t cache_hash;
+
+  /**
+   * More recently used statement in the cache, or NULL if this statement
+   * has the most recent use.
+   */
+  struct sqldbal_stmt *cache_prev;
+
+  /**
+   * Less recently used statement in the cache, or NULL if this statement
+   * has the least recent use.
+   */
+  struct sqldbal_stmt *cache_next;
+
+  /**
+   * Next statement in the same hash bucket.
+   */
+  struct sqldbal_stmt *cache_bucket_next;
+
+  /**
+   * Number of rows fetched from the server-side cursor in each round trip,
+   * or 0 if the statement does not use a cursor.
+   *
+   * See @ref sqldbal_stmt_set_cursor.
+   */
+  size_t cursor_prefetch;
+
+  /**
+   * Measurements collected by the fetches of the current result set.
+   *
+   * See @ref SQLDBAL_METRICS_FETCH.
+   */
+  struct sqldbal_metrics metrics_fetch;
+
+  /**
+   * See @ref sqldbal_metrics::sql_hash.
+   */
+  uint64_t metrics_hash;
+
+  /**
+   * Number of text and blob bytes bound since the last execution while
+   * the metrics hook was set.
+   */
+  uint64_t metrics_bind_bytes;
+
+  /**
+   * Time when @ref sqldbal_stmt_execute_start sent the statement, or 0 if
+   * neither the metrics hook nor the trace measure the statement.
+   *
+   * See @ref sqldbal_time_ns.
+   */
+  uint64_t metrics_start_ns;
+
+  /**
+   * Copy of the SQL text used as the key in the
+   * @ref sqldbal_result_cache, or NULL if the statement does not only read
+   * data or got prepared while the cache was disabled.
+   */
+  char *result_sql;
+
+  /**
+   * Length of @ref result_sql in bytes.
+   */
+  size_t result_sql_len;
+
+  /**
+   * Copy of the SQL text passed to @ref sqldbal_trace_attach entries, or
+   * NULL if the statement got prepared without a trace attached.
+   */
+  char *trace_sql;
+
+  /**
+   * Length of the SQL text before truncating it into @ref trace_sql.
+   */
+  size_t trace_sql_len;
+
+  /**
+   * Value bound to each placeholder, with @ref num_params entries, or NULL
+   * unless @ref sqldbal_stmt_set_result_cache enabled the result cache for
+   * this statement.
+   */
+  struct sqldbal_result_param *result_param_list;
+
+  /**
+   * Cached result returned by the fetches instead of the driver, or NULL.
+   */
+  struct sqldbal_result_entry *result_entry;
+
+  /**
+   * Result being copied from the driver during the fetches, which goes
+   * into the @ref sqldbal_result_cache after the last row, or NULL.
+   */
+  struct sqldbal_result_entry *result_capture;
+
+  /**
+   * Number of rows of @ref result_entry fetched so far.
+   */
+  size_t result_row;
+
+  /**
+   * Blob placeholder values collected in chunks, with @ref num_params
+   * entries, or NULL if the statement has no streamed placeholders.
+   */
+  struct sqldbal_stmt_stream *stream_list;
+
   /**
    * Set to 1 if statement has been allocated and valid.
    */
   int valid;
 
+  /**
+   * Set to 1 if @ref sqldbal_stmt_fetch_columns fetched the current row but
+   * did not have room to return it, so the next fetch must return this row
+   * instead of advancing.
+   */
+  int fetch_pending;
+
+  /**
+   * Set to 1 after @ref sqldbal_stmt_fetch_columns reached the end of the
+   * result set.
+   */
+  int fetch_done;
+
+  /**
+   * Set to 1 between @ref sqldbal_stmt_execute_start and
+   * @ref sqldbal_stmt_execute_finish.
+   */
+  int async_pending;
+
+  /**
+   * Set to 1 if @ref metrics_fetch has measurements that have not been
+   * reported yet.
+   */
+  int metrics_fetch_active;
+
   /**
    * Padding structure to align.
    */
@@ -99,6 +460,28 @@ struct sqldbal_driver_functions{
                      const struct sqldbal_driver_option *const option_list,
                      size_t num_options);
 
+  /**
+   * Start connecting without blocking, for @ref sqldbal_open_parallel.
+   */
+  void
+  (*sqldbal_fp_connect_start)(struct sqldbal_db *const db,
+                              const char *const location,
+                              const char *const port,
+                              const char *const username,
+                              const char *const password,
+                              const char *const database,
+                              const struct sqldbal_driver_option *option_list,
+                              size_t num_options,
+                              int *const wait_events);
+
+  /**
+   * Continue connecting after the socket became ready for the events in
+   * @p wait_events, and return the events to wait for next.
+   */
+  void
+  (*sqldbal_fp_connect_poll)(struct sqldbal_db *const db,
+                             int *const wait_events);
+
   /**
    * Close connection to database/server.
    */
@@ -136,6 +519,74 @@ struct sqldbal_driver_functions{
   void
   (*sqldbal_fp_rollback)(struct sqldbal_db *const db);
 
+  /**
+   * Start queuing executed statements.
+   */
+  void
+  (*sqldbal_fp_pipeline_begin)(struct sqldbal_db *const db);
+
+  /**
+   * Read the results of the statements queued since
+   * @ref sqldbal_fp_pipeline_begin.
+   */
+  void
+  (*sqldbal_fp_pipeline_end)(struct sqldbal_db *const db);
+
+  /**
+   * Start loading rows into a table.
+   */
+  void
+  (*sqldbal_fp_bulk_begin)(struct sqldbal_bulk *const bulk,
+                           const char *const table,
+                           const char *const *const column_list);
+
+  /**
+   * Encode a row for the bulk load.
+   */
+  void
+  (*sqldbal_fp_bulk_row)(struct sqldbal_bulk *const bulk,
+                         const struct sqldbal_batch_param *const param_list,
+                         size_t row);
+
+  /**
+   * Send the remaining rows and free the driver bulk load state.
+   */
+  void
+  (*sqldbal_fp_bulk_end)(struct sqldbal_bulk *const bulk);
+
+  /**
+   * Open a large object for reading in chunks.
+   */
+  void
+  (*sqldbal_fp_blob_open)(struct sqldbal_blob *const blob,
+                          const char *const table,
+                          const char *const column,
+                          int64_t row_id);
+
+  /**
+   * Read part of a large object.
+   */
+  void
+  (*sqldbal_fp_blob_read)(struct sqldbal_blob *const blob,
+                          uint64_t offset,
+                          void *const buf,
+                          size_t len);
+
+  /**
+   * Write part of a large object.
+   */
+  void
+  (*sqldbal_fp_blob_write)(struct sqldbal_blob *const blob,
+                           uint64_t offset,
+                           const void *const buf,
+                           size_t len);
+
+  /**
+   * Close a large object.
+   */
+  void
+  (*sqldbal_fp_blob_close)(struct sqldbal_blob *const blob);
+
   /**
    * Directly execute a SQL statement, skipping the separate statement
    * compilation steps.
@@ -154,6 +605,25 @@ struct sqldbal_driver_functions{
                                const char *const name,
                                uint64_t *insert_id);
 
+  /**
+   * Check if the connection to the database still works.
+   */
+  void
+  (*sqldbal_fp_ping)(struct sqldbal_db *const db);
+
+  /**
+   * Get the socket connected to the database server.
+   */
+  void
+  (*sqldbal_fp_socket_fd)(struct sqldbal_db *const db,
+                          int *const fd);
+
+  /**
+   * Get the maximum number of placeholders in one statement.
+   */
+  size_t
+  (*sqldbal_fp_param_limit)(struct sqldbal_db *const db);
+
   /**
    * Compile a SQL statement.
    */
@@ -163,6 +633,13 @@ struct sqldbal_driver_functions{
                              size_t sql_len,
                              struct sqldbal_stmt *const stmt);
 
+  /**
+   * Read the results through a server-side cursor.
+   */
+  void
+  (*sqldbal_fp_stmt_cursor)(struct sqldbal_stmt *const stmt,
+                            size_t prefetch_rows);
+
   /**
    * Assign binary data to the compiled statement.
    */
@@ -190,57 +667,185 @@ struct sqldbal_driver_functions{
                                size_t slen);
 
   /**
-   * Assign a NULL value to the compiled statement.
+   * Assign binary data to the compiled statement without copying it.
    */
   void
-  (*sqldbal_fp_stmt_bind_null)(struct sqldbal_stmt *const stmt,
-                               size_t col_idx);
+  (*sqldbal_fp_stmt_bind_blob_static)(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      const void *const blob,
+                                      size_t blobsz);
 
   /**
-   * Execute a compiled statement with the previously bound parameters.
+   * Assign a string to the compiled statement without copying it.
    */
   void
-  (*sqldbal_fp_stmt_execute)(struct sqldbal_stmt *const stmt);
+  (*sqldbal_fp_stmt_bind_text_static)(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      const char *const s,
+                                      size_t slen);
 
   /**
-   * Get the next row in the result.
+   * Assign a double-precision floating point number to the compiled
+   * statement.
    */
-  enum sqldbal_fetch_result
-  (*sqldbal_fp_stmt_fetch)(struct sqldbal_stmt *const stmt);
+  void
+  (*sqldbal_fp_stmt_bind_double)(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 double d);
 
   /**
-   * Get the result column as a blob.
+   * Assign a timestamp to the compiled statement.
    */
   void
-  (*sqldbal_fp_stmt_column_blob)(struct sqldbal_stmt *const stmt,
-                                 size_t col_idx,
-                                 const void **blob,
-                                 size_t *blobsz);
+  (*sqldbal_fp_stmt_bind_timestamp)(struct sqldbal_stmt *const stmt,
+                                    size_t col_idx,
+                                    int64_t ts);
 
   /**
-   * Get the result column as a 64-bit integer.
+   * Assign a NULL value to the compiled statement.
    */
   void
-  (*sqldbal_fp_stmt_column_int64)(struct sqldbal_stmt *const stmt,
-                                  size_t col_idx,
-                                  int64_t *i64);
+  (*sqldbal_fp_stmt_bind_null)(struct sqldbal_stmt *const stmt,
+                               size_t col_idx);
 
   /**
-   * Get the result column as UTF-8 text.
+   * Start a blob placeholder value that gets sent in chunks.
    */
   void
-  (*sqldbal_fp_stmt_column_text)(struct sqldbal_stmt *const stmt,
-                                 size_t col_idx,
-                                 const char **text,
-                                 size_t *textsz);
+  (*sqldbal_fp_stmt_bind_blob_stream)(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx);
 
   /**
-   * Get the column data type.
+   * Send the next chunk of a streamed blob placeholder.
+   */
+  void
+  (*sqldbal_fp_stmt_send_blob)(struct sqldbal_stmt *const stmt,
+                               size_t col_idx,
+                               const void *const chunk,
+                               size_t chunksz);
+
+  /**
+   * Execute a compiled statement with the previously bound parameters.
+   */
+  void
+  (*sqldbal_fp_stmt_execute)(struct sqldbal_stmt *const stmt);
+
+  /**
+   * Execute a compiled statement once for each row of column-wise values.
+   */
+  void
+  (*sqldbal_fp_stmt_execute_batch)(
+    struct sqldbal_stmt *const stmt,
+    const struct sqldbal_batch_param *const param_list,
+    size_t num_rows);
+
+  /**
+   * Send a compiled statement without waiting for the result.
+   */
+  void
+  (*sqldbal_fp_stmt_execute_start)(struct sqldbal_stmt *const stmt);
+
+  /**
+   * Continue sending or receiving a statement started by
+   * @ref sqldbal_fp_stmt_execute_start without blocking.
+   */
+  void
+  (*sqldbal_fp_stmt_execute_poll)(struct sqldbal_stmt *const stmt,
+                                  int *const wait_events);
+
+  /**
+   * Prepare the result of a statement started by
+   * @ref sqldbal_fp_stmt_execute_start for fetching.
+   */
+  void
+  (*sqldbal_fp_stmt_execute_finish)(struct sqldbal_stmt *const stmt);
+
+  /**
+   * Get the next row in the result.
+   */
+  enum sqldbal_fetch_result
+  (*sqldbal_fp_stmt_fetch)(struct sqldbal_stmt *const stmt);
+
+  /**
+   * Get the number of rows in a buffered result set.
+   */
+  void
+  (*sqldbal_fp_stmt_num_rows)(struct sqldbal_stmt *const stmt,
+                              uint64_t *num_rows);
+
+  /**
+   * Move to a row in the result set.
+   */
+  void
+  (*sqldbal_fp_stmt_seek)(struct sqldbal_stmt *const stmt,
+                          uint64_t row);
+
+  /**
+   * Get the result column as a blob.
+   */
+  void
+  (*sqldbal_fp_stmt_column_blob)(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 const void **blob,
+                                 size_t *blobsz);
+
+  /**
+   * Copy part of the result column into a buffer.
+   */
+  void
+  (*sqldbal_fp_stmt_column_blob_read)(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      uint64_t offset,
+                                      void *const buf,
+                                      size_t bufsz,
+                                      size_t *const len);
+
+  /**
+   * Get the result column as a 64-bit integer.
+   */
+  void
+  (*sqldbal_fp_stmt_column_int64)(struct sqldbal_stmt *const stmt,
+                                  size_t col_idx,
+                                  int64_t *i64);
+
+  /**
+   * Get the result column as UTF-8 text.
+   */
+  void
+  (*sqldbal_fp_stmt_column_text)(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 const char **text,
+                                 size_t *textsz);
+
+  /**
+   * Get the result column as a double-precision floating point number.
+   */
+  void
+  (*sqldbal_fp_stmt_column_double)(struct sqldbal_stmt *const stmt,
+                                   size_t col_idx,
+                                   double *d);
+
+  /**
+   * Get the result column as a timestamp.
+   */
+  void
+  (*sqldbal_fp_stmt_column_timestamp)(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      int64_t *ts);
+
+  /**
+   * Get the column data type.
    */
   enum sqldbal_column_type
   (*sqldbal_fp_stmt_column_type)(struct sqldbal_stmt *const stmt,
                                  size_t col_idx);
 
+  /**
+   * Discard pending results and clear the bound parameters.
+   */
+  void
+  (*sqldbal_fp_stmt_reset)(struct sqldbal_stmt *const stmt);
+
   /**
    * Free resources associated with a prepared statement.
    */
@@ -248,6 +853,213 @@ struct sqldbal_driver_functions{
   (*sqldbal_fp_stmt_close)(struct sqldbal_stmt *const stmt);
 };
 
+#ifdef SQLDBAL_SINGLE_DRIVER
+/**
+ * Function table of the only driver, defined with the driver functions.
+ */
+static const struct sqldbal_driver_functions SQLDBAL_SINGLE_FUNCTIONS;
+#endif /* SQLDBAL_SINGLE_DRIVER */
+
+/**
+ * Least recently used cache of prepared statements not currently in use,
+ * keyed by the SQL text.
+ *
+ * See @ref sqldbal_stmt_cache_set_capacity.
+ */
+struct sqldbal_stmt_cache{
+  /**
+   * Hash table of cached statements with @ref num_buckets entries.
+   */
+  struct sqldbal_stmt **bucket_list;
+
+  /**
+   * Number of entries in @ref bucket_list, always a power of two.
+   */
+  size_t num_buckets;
+
+  /**
+   * Most recently used statement.
+   */
+  struct sqldbal_stmt *lru_head;
+
+  /**
+   * Least recently used statement, which gets evicted first.
+   */
+  struct sqldbal_stmt *lru_tail;
+
+  /**
+   * Number of statements currently in the cache.
+   */
+  size_t num_stmts;
+
+  /**
+   * Maximum number of statements to keep, or 0 if the cache is disabled.
+   */
+  size_t capacity;
+
+  /**
+   * Number of times @ref sqldbal_stmt_prepare found a cached statement.
+   */
+  uint64_t num_hits;
+
+  /**
+   * Number of times @ref sqldbal_stmt_prepare had to compile a new
+   * statement while the cache was enabled.
+   */
+  uint64_t num_misses;
+};
+
+/**
+ * Client-side cache of query results.
+ *
+ * See @ref sqldbal_result_cache_set.
+ */
+struct sqldbal_result_cache{
+  /**
+   * Hash table of cached results with @ref num_buckets entries.
+   */
+  struct sqldbal_result_entry **bucket_list;
+
+  /**
+   * Number of entries in @ref bucket_list, always a power of two.
+   */
+  size_t num_buckets;
+
+  /**
+   * Most recently used result.
+   */
+  struct sqldbal_result_entry *lru_head;
+
+  /**
+   * Least recently used result, which gets evicted first.
+   */
+  struct sqldbal_result_entry *lru_tail;
+
+  /**
+   * Number of bytes used by the cached results.
+   */
+  size_t num_bytes;
+
+  /**
+   * Maximum value of @ref num_bytes, or 0 if the cache is disabled.
+   */
+  size_t max_bytes;
+
+  /**
+   * Number of nanoseconds a result stays valid, or UINT64_MAX to keep
+   * results until evicted or invalidated.
+   */
+  uint64_t ttl_ns;
+
+  /**
+   * Number of queries answered from the cache.
+   */
+  uint64_t num_hits;
+
+  /**
+   * Number of cacheable queries sent to the database.
+   */
+  uint64_t num_misses;
+};
+
+/**
+ * Settings and counters for retrying statements while the database is
+ * locked by another connection.
+ *
+ * Only the SQLite driver uses these. See @ref sqldbal_busy_stats.
+ */
+struct sqldbal_busy{
+  /**
+   * Number of times a statement waited before trying again.
+   */
+  uint64_t num_retries;
+
+  /**
+   * Total number of milliseconds spent waiting before the retries.
+   */
+  uint64_t wait_ms;
+
+  /**
+   * Time when the current statement first found the database locked.
+   *
+   * See @ref sqldbal_time_ms.
+   */
+  uint64_t start_ms;
+
+  /**
+   * State of the pseudo-random generator that adds jitter to the wait
+   * times.
+   */
+  uint64_t rand_state;
+
+  /**
+   * Give up retrying after waiting this many milliseconds in total.
+   */
+  unsigned int timeout_ms;
+
+  /**
+   * Wait time before the first retry.
+   */
+  unsigned int backoff_min_ms;
+
+  /**
+   * The wait time doubles after each retry up to this limit.
+   */
+  unsigned int backoff_max_ms;
+
+  /**
+   * Set to 1 if the driver should retry statements itself, or 0 if the
+   * database engine already retries them internally.
+   */
+  unsigned int retry_step;
+};
+
+/**
+ * Copy of the connection parameters passed to @ref sqldbal_open, for
+ * connecting again after that function returns.
+ */
+struct sqldbal_params{
+  /**
+   * Buffer containing copies of all the strings below.
+   */
+  char *str_buf;
+
+  /**
+   * See @ref sqldbal_open.
+   */
+  const char *location;
+
+  /**
+   * See @ref sqldbal_open.
+   */
+  const char *port;
+
+  /**
+   * See @ref sqldbal_open.
+   */
+  const char *username;
+
+  /**
+   * See @ref sqldbal_open.
+   */
+  const char *password;
+
+  /**
+   * See @ref sqldbal_open.
+   */
+  const char *database;
+
+  /**
+   * Copy of the driver options with the strings stored in @ref str_buf.
+   */
+  struct sqldbal_driver_option *option_list;
+
+  /**
+   * Number of entries in @ref option_list.
+   */
+  size_t num_options;
+};
+
 /**
  * SQL database connection/handle.
  */
@@ -261,6 +1073,12 @@ struct sqldbal_db{
    */
   char *errstr;
 
+  /**
+   * Number of bytes allocated in @ref errstr, which gets reused by later
+   * errors that fit.
+   */
+  size_t errstr_size;
+
   /**
    * Driver-specific database context.
    */
@@ -269,9 +1087,75 @@ struct sqldbal_db{
   /**
    * List of functions SQL drivers must implement.
    *
+   * Every connection using the same driver shares one read-only list.
+   *
    * See @ref sqldbal_driver_functions.
    */
-  struct sqldbal_driver_functions functions;
+  const struct sqldbal_driver_functions *functions;
+
+  /**
+   * See @ref sqldbal_stmt_cache.
+   */
+  struct sqldbal_stmt_cache stmt_cache;
+
+  /**
+   * See @ref sqldbal_busy.
+   */
+  struct sqldbal_busy busy;
+
+  /**
+   * See @ref sqldbal_result_cache.
+   */
+  struct sqldbal_result_cache result_cache;
+
+  /**
+   * See @ref sqldbal_metrics_hook.
+   */
+  sqldbal_metrics_fp metrics_fp;
+
+  /**
+   * Passed to @ref metrics_fp.
+   */
+  void *metrics_user_data;
+
+  /**
+   * Replica connections added with @ref sqldbal_replica_add.
+   */
+  struct sqldbal_db **replica_list;
+
+  /**
+   * Number of connections in @ref replica_list.
+   */
+  size_t num_replicas;
+
+  /**
+   * Index in @ref replica_list where the next replica search starts, so
+   * that equally loaded replicas take turns.
+   */
+  size_t replica_next;
+
+  /**
+   * Routing state if this connection is a replica of another connection,
+   * or NULL.
+   */
+  struct sqldbal_replica *replica;
+
+  /**
+   * See @ref sqldbal_trace_attach.
+   */
+  struct sqldbal_trace *trace;
+
+  /**
+   * Connection parameters saved by @ref SQLDBAL_FLAG_LAZY_CONNECT until
+   * the connection connects, or NULL.
+   */
+  struct sqldbal_params *lazy;
+
+  /**
+   * Pool that handed out this connection with @ref sqldbal_pool_acquire,
+   * or NULL while the connection sits idle or does not come from a pool.
+   */
+  struct sqldbal_pool *pool;
 
   /**
    * Previous error set by the library or database driver.
@@ -287,12 +1171,107 @@ struct sqldbal_db{
    */
   enum sqldbal_driver type;
 
+  /**
+   * Set to 1 between @ref sqldbal_pipeline_begin and
+   * @ref sqldbal_pipeline_end.
+   */
+  int pipeline;
+
+  /**
+   * Set to 1 between @ref sqldbal_begin_transaction and
+   * @ref sqldbal_commit or @ref sqldbal_rollback, and while a BEGIN run
+   * through @ref sqldbal_exec has not been committed or rolled back.
+   */
+  int transaction;
+
+  /**
+   * Set to 1 if the driver times the statements recorded in @ref trace.
+   */
+  int trace_driver;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+
   /**
    * See @ref sqldbal_flag.
    */
   unsigned long flags;
 };
 
+/**
+ * Bulk load started by @ref sqldbal_bulk_begin.
+ */
+struct sqldbal_bulk{
+  /**
+   * Database receiving the rows.
+   */
+  struct sqldbal_db *db;
+
+  /**
+   * Driver-specific bulk load state.
+   */
+  void *handle;
+
+  /**
+   * Multi-row INSERT state if started by @ref sqldbal_bulk_begin_insert,
+   * or NULL if the driver loads the rows.
+   */
+  struct sqldbal_bulk_insert *insert;
+
+  /**
+   * Rows encoded by the driver that have not been sent yet. The drivers
+   * also use this buffer to build the SQL statements.
+   */
+  char *buf;
+
+  /**
+   * Number of bytes used in @ref buf.
+   */
+  size_t buf_len;
+
+  /**
+   * Number of bytes allocated in @ref buf.
+   */
+  size_t buf_size;
+
+  /**
+   * Number of columns in each row.
+   */
+  size_t num_cols;
+};
+
+/**
+ * Large object opened by @ref sqldbal_blob_open.
+ */
+struct sqldbal_blob{
+  /**
+   * Database connection holding the object.
+   */
+  struct sqldbal_db *db;
+
+  /**
+   * SQLite incremental blob handle.
+   */
+  void *handle;
+
+  /**
+   * Number of bytes in the object.
+   */
+  uint64_t size;
+
+  /**
+   * PostgreSQL large object descriptor, or -1 if not open.
+   */
+  int fd;
+
+  /**
+   * Set to 1 if opened for writing.
+   */
+  int write;
+};
+
 /**
  * Add two size_t values and check for wrap.
  *
@@ -662,7 +1641,9 @@ sqldbal_strtoi64(struct sqldbal_db *const db,
     *i64 = 0;
   }
 }
+#endif /* defined(SQLDBAL_MARIADB) || defined(SQLDBAL_POSTGRESQL) */
 
+#if defined(SQLDBAL_MARIADB) || defined(SQLDBAL_SQLITE)
 /**
  * Convert a string into unsigned integer and set status code if error.
  *
@@ -694,1170 +1675,1560 @@ sqldbal_strtoui(struct sqldbal_db *const db,
   }
   return sqldbal_status_code_get(db);
 }
-#endif /* defined(SQLDBAL_MARIADB) || defined(SQLDBAL_POSTGRESQL) */
+#endif /* defined(SQLDBAL_MARIADB) || defined(SQLDBAL_SQLITE) */
 
 /**
- * Free the existing error string and replace with a new error string.
- *
- * @param[in] db     See @ref sqldbal_db.
- * @param[in] errstr Error string to set in the database context. This
- *                   function makes a copy of the string.
+ * Number of bytes needed to hold any string generated by
+ * @ref sqldbal_double_to_str or @ref sqldbal_timestamp_to_str, including
+ * the null-terminator.
  */
-SQLDBAL_LINKAGE void
-sqldbal_errstr_set(struct sqldbal_db *const db,
-                   const char *const errstr){
-  free(db->errstr);
-  db->errstr = sqldbal_strdup(errstr);
-  if(db->errstr == NULL){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-  }
-}
+#define SQLDBAL_CONV_STR_SZ 32
 
 /**
- * Convenience function that sets both the error status code and error string.
- *
- * @param[in] db          See @ref sqldbal_db.
- * @param[in] status_code See @ref sqldbal_status_code.
- * @param[in] errstr      Error string to set in the database context.
+ * Number of microseconds in one second.
  */
-static void
-sqldbal_err_set(struct sqldbal_db *const db,
-                enum sqldbal_status_code status_code,
-                const char *const errstr){
-  sqldbal_status_code_set(db, status_code);
-  sqldbal_errstr_set(db, errstr);
-}
+#define SQLDBAL_USEC_PER_SEC INT64_C(1000000)
 
-#ifdef SQLDBAL_MARIADB
-
-#include <mysql.h>
-
-#if MYSQL_VERSION_ID >= 50600
 /**
- * MariaDB did not add the MYSQL_OPT_SSL_* options until version 5.6.
+ * Number of microseconds in one day.
  */
-# define SQLDBAL_MARIADB_HAS_SSL
-#endif /* MYSQL_VERSION_ID >= 50600 */
+#define SQLDBAL_USEC_PER_DAY (INT64_C(86400) * SQLDBAL_USEC_PER_SEC)
 
 /**
- * Highest port number available.
+ * Broken-down UTC time used to convert timestamps.
+ *
+ * See @ref sqldbal_stmt_bind_timestamp.
  */
-#define SQLDBAL_MAX_PORT_NUMBER 65535
+struct sqldbal_tm{
+  /**
+   * Year in the proleptic Gregorian calendar.
+   */
+  int64_t year;
 
-/**
- * Maximum number of seconds allowed in the CONNECT_TIMEOUT option.
- */
-#define SQLDBAL_MARIADB_MAX_CONNECT_TIMEOUT 1000
+  /**
+   * Month of the year [1, 12].
+   */
+  unsigned int month;
 
-/**
- * Driver-specific compiled statement handle for MariaDB.
- */
-struct sqldbal_mariadb_stmt{
   /**
-   * MariaDB statement handle.
+   * Day of the month [1, 31].
    */
-  MYSQL_STMT *stmt;
+  unsigned int day;
 
   /**
-   * Parameters to bind for outgoing statement.
+   * Hours since midnight [0, 23].
    */
-  MYSQL_BIND *bind_out;
+  unsigned int hour;
 
   /**
-   * Store the fetched row into this bind list.
+   * Minutes after the hour [0, 59].
    */
-  MYSQL_BIND *bind_in_list;
+  unsigned int minute;
 
   /**
-   * Length of stored result for corresponding entry in @ref bind_in_list.
+   * Seconds after the minute [0, 59].
    */
-  unsigned long *bind_in_length_list;
+  unsigned int second;
 
   /**
-   * Null value flag for corresponding entry in @ref bind_in_list.
+   * Microseconds after the second [0, 999999].
    */
-  char *bind_in_null_list;
+  unsigned int usec;
 };
 
 /**
- * Convenience function that sets the status code and the error string
- * generated by the database function.
+ * Get the number of days between 1970-01-01 and a calendar date.
  *
- * @param[in] db          See @ref sqldbal_db.
- * @param[in] mysql_db    MariaDB database handle.
- * @param[in] status_code See @ref sqldbal_status_code.
+ * @param[in] year  Year in the proleptic Gregorian calendar.
+ * @param[in] month Month of the year [1, 12].
+ * @param[in] day   Day of the month [1, 31].
+ * @return Number of days since 1970-01-01, negative for earlier dates.
  */
-static void
-sqldbal_mariadb_error(struct sqldbal_db *const db,
-                      MYSQL *const mysql_db,
-                      enum sqldbal_status_code status_code){
-  const char *error;
+SQLDBAL_LINKAGE int64_t
+sqldbal_days_from_civil(int64_t year,
+                        unsigned int month,
+                        unsigned int day){
+  int64_t era;
+  int64_t year_of_era;
+  int64_t day_of_year;
+  int64_t day_of_era;
+  int64_t month_from_march;
+
+  /* Count the years from March so that the leap day comes last. */
+  if(month <= 2){
+    year -= 1;
+    month_from_march = (int64_t)month + 9;
+  }
+  else{
+    month_from_march = (int64_t)month - 3;
+  }
+  if(year >= 0){
+    era = year / 400;
+  }
+  else{
+    era = (year - 399) / 400;
+  }
+  year_of_era = year - era * 400;
+  day_of_year = (153 * month_from_march + 2) / 5 + (int64_t)day - 1;
+  day_of_era  = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 +
+                day_of_year;
+  return era * 146097 + day_of_era - 719468;
+}
 
-  /* https://mariadb.com/kb/en/library/mysql_error */
-  error = mysql_error(mysql_db);
-  sqldbal_err_set(db, status_code, error);
+/**
+ * Get the number of days in a month.
+ *
+ * @param[in] year  Year in the proleptic Gregorian calendar.
+ * @param[in] month Month of the year [1, 12].
+ * @return Number of days in @p month.
+ */
+static unsigned int
+sqldbal_days_in_month(int64_t year,
+                      unsigned int month){
+  static const unsigned char days_list[] = {
+    31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+  };
+  unsigned int days;
+
+  days = days_list[month - 1];
+  if(month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)){
+    days += 1;
+  }
+  return days;
 }
 
 /**
- * Convenience function that sets the status code and the error string
- * generated by the statement.
+ * Split a timestamp into calendar fields.
  *
- * @param[in] stmt        See @ref sqldbal_stmt.
- * @param[in] status_code See @ref sqldbal_status_code.
+ * @param[in]  ts Microseconds since 1970-01-01 00:00:00 UTC.
+ * @param[out] tm See @ref sqldbal_tm.
  */
 static void
-sqldbal_mariadb_stmt_error(const struct sqldbal_stmt *const stmt,
-                           enum sqldbal_status_code status_code){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  const char *stmt_error;
+sqldbal_timestamp_to_tm(int64_t ts,
+                        struct sqldbal_tm *const tm){
+  int64_t days;
+  int64_t usec_of_day;
+  int64_t era;
+  int64_t day_of_era;
+  int64_t year_of_era;
+  int64_t day_of_year;
+  int64_t month_from_march;
+
+  days        = ts / SQLDBAL_USEC_PER_DAY;
+  usec_of_day = ts % SQLDBAL_USEC_PER_DAY;
+  if(usec_of_day < 0){
+    usec_of_day += SQLDBAL_USEC_PER_DAY;
+    days -= 1;
+  }
 
-  mariadb_stmt = stmt->handle;
+  /* Inverse of sqldbal_days_from_civil. */
+  days += 719468;
+  if(days >= 0){
+    era = days / 146097;
+  }
+  else{
+    era = (days - 146096) / 146097;
+  }
+  day_of_era  = days - era * 146097;
+  year_of_era = (day_of_era -
+                 day_of_era / 1460 +
+                 day_of_era / 36524 -
+                 day_of_era / 146096) / 365;
+  day_of_year = day_of_era - (365 * year_of_era +
+                              year_of_era / 4 -
+                              year_of_era / 100);
+  month_from_march = (5 * day_of_year + 2) / 153;
+
+  tm->year = year_of_era + era * 400;
+  tm->day  = (unsigned int)(day_of_year - (153 * month_from_march + 2) / 5 + 1);
+  if(month_from_march < 10){
+    tm->month = (unsigned int)(month_from_march + 3);
+  }
+  else{
+    tm->month = (unsigned int)(month_from_march - 9);
+    tm->year += 1;
+  }
 
-  /* https://mariadb.com/kb/en/mysql_stmt_error */
-  stmt_error = mysql_stmt_error(mariadb_stmt->stmt);
-  sqldbal_err_set(stmt->db, status_code, stmt_error);
+  tm->usec   = (unsigned int)(usec_of_day % SQLDBAL_USEC_PER_SEC);
+  usec_of_day /= SQLDBAL_USEC_PER_SEC;
+  tm->second = (unsigned int)(usec_of_day % 60);
+  usec_of_day /= 60;
+  tm->minute = (unsigned int)(usec_of_day % 60);
+  tm->hour   = (unsigned int)(usec_of_day / 60);
 }
 
 /**
- * Wrapper for the mysql_options function.
+ * Combine calendar fields into a timestamp.
  *
- * @param[in] db     See @ref sqldbal_db.
- * @param[in] option One of the available options in MariaDB.
- * @param[in] arg    Option value.
+ * @param[in] tm See @ref sqldbal_tm. The year must stay within
+ *               [-290000, 290000] so that the result does not overflow.
+ * @return Microseconds since 1970-01-01 00:00:00 UTC.
  */
-static void
-sqldbal_mariadb_mysql_options(struct sqldbal_db *const db,
-                              enum mysql_option option,
-                              const void *arg){
-  MYSQL *mysql;
+static int64_t
+sqldbal_tm_to_timestamp(const struct sqldbal_tm *const tm){
+  int64_t seconds;
+
+  seconds = ((int64_t)tm->hour * 60 + (int64_t)tm->minute) * 60 +
+            (int64_t)tm->second;
+  return sqldbal_days_from_civil(tm->year, tm->month, tm->day) *
+         SQLDBAL_USEC_PER_DAY +
+         seconds * SQLDBAL_USEC_PER_SEC +
+         (int64_t)tm->usec;
+}
 
-  mysql = db->handle;
+#if defined(SQLDBAL_POSTGRESQL) || defined(SQLDBAL_SQLITE)
+/**
+ * Convert a timestamp to an ISO 8601 string in UTC.
+ *
+ * The string has the format "YYYY-MM-DD HH:MM:SS", followed by ".ffffff"
+ * if the timestamp has a fractional second. INT64_MAX and INT64_MIN get
+ * converted to "infinity" and "-infinity".
+ *
+ * @param[in]  ts  Microseconds since 1970-01-01 00:00:00 UTC.
+ * @param[out] str Buffer with at least @ref SQLDBAL_CONV_STR_SZ bytes.
+ * @return Number of bytes in @p str, excluding the null-terminator.
+ */
+SQLDBAL_LINKAGE size_t
+sqldbal_timestamp_to_str(int64_t ts,
+                         char *const str){
+  struct sqldbal_tm tm;
+  int slen;
 
-  /* https://mariadb.com/kb/en/mysql_options */
-  if(mysql_options(mysql, option, arg) != 0){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  if(ts == INT64_MAX){
+    slen = sprintf(str, "infinity");
+  }
+  else if(ts == INT64_MIN){
+    slen = sprintf(str, "-infinity");
+  }
+  else{
+    sqldbal_timestamp_to_tm(ts, &tm);
+    slen = sprintf(str,
+                   "%04" PRIi64 "-%02u-%02u %02u:%02u:%02u",
+                   tm.year,
+                   tm.month,
+                   tm.day,
+                   tm.hour,
+                   tm.minute,
+                   tm.second);
+    if(tm.usec){
+      slen += sprintf(&str[slen], ".%06u", tm.usec);
+    }
   }
+  return (size_t)slen;
 }
 
+#endif /* SQLDBAL_POSTGRESQL || SQLDBAL_SQLITE */
+
 /**
- * Handle driver-specific options for MariaDB.
+ * Parse a separator followed by a fixed number of decimal digits.
  *
- * @param[in] db          See @ref sqldbal_db.
- * @param[in] num_options Number of entries in @p opt_list.
- * @param[in] opt_list    See @ref sqldbal_driver_option.
- * @return sqldbal_status_code.
+ * @param[in,out] str     Text to parse, which gets advanced past the
+ *                        digits on success.
+ * @param[in]     sep     Required separator character, or '\0' if the
+ *                        digits do not have a separator.
+ * @param[in]     ndigits Number of digits to parse.
+ * @return Value of the digits, or -1 if @p str does not match.
  */
-static enum sqldbal_status_code
-sqldbal_mariadb_set_options(struct sqldbal_db *const db,
-                            size_t num_options,
-                            const struct sqldbal_driver_option *const opt_list){
+static int64_t
+sqldbal_parse_digits(const char **const str,
+                     char sep,
+                     size_t ndigits){
+  const char *s;
+  int64_t value;
   size_t i;
-  const struct sqldbal_driver_option *option;
-  unsigned int timeout;
 
-  for(i = 0; i < num_options; i++){
-    option = &opt_list[i];
-    if(strcmp(option->key, "CONNECT_TIMEOUT") == 0){
-      if(sqldbal_strtoui(db,
-                         option->value,
-                         SQLDBAL_MARIADB_MAX_CONNECT_TIMEOUT,
-                         &timeout) == SQLDBAL_STATUS_OK){
-        sqldbal_mariadb_mysql_options(db,
-                                      MYSQL_OPT_CONNECT_TIMEOUT,
-                                      (void*)&timeout);
-      }
+  s = *str;
+  value = 0;
+  if(sep != '\0'){
+    if(*s == sep){
+      s += 1;
     }
-#ifdef SQLDBAL_MARIADB_HAS_SSL
-    else if(strcmp(option->key, "TLS_KEY") == 0){
-      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_KEY, option->value);
+    else{
+      value = -1;
     }
-    else if(strcmp(option->key, "TLS_CERT") == 0){
-      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CERT, option->value);
+  }
+  for(i = 0; i < ndigits && value >= 0; i++){
+    if(s[i] >= '0' && s[i] <= '9'){
+      value = value * 10 + (s[i] - '0');
     }
-    else if(strcmp(option->key, "TLS_CA") == 0){
-      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CA, option->value);
+    else{
+      value = -1;
     }
-    else if(strcmp(option->key, "TLS_CAPATH") == 0){
-      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CAPATH, option->value);
+  }
+  if(value >= 0){
+    *str = &s[ndigits];
+  }
+  return value;
+}
+
+/**
+ * Convert an ISO 8601 date or timestamp string to a timestamp and verify
+ * the result.
+ *
+ * The string must have the format "YYYY-MM-DD", optionally followed by a
+ * space or 'T' and "HH:MM[:SS[.fraction]]", optionally followed by 'Z' or
+ * an offset "+HH[[:]MM[:SS]]". Strings without an offset get treated as
+ * UTC. Digits after the first six in the fraction get truncated. The
+ * strings "infinity" and "-infinity" get converted to INT64_MAX and
+ * INT64_MIN.
+ *
+ * @param[in]  db   See @ref sqldbal_db.
+ * @param[in]  text String to convert.
+ * @param[out] ts   Microseconds since 1970-01-01 00:00:00 UTC.
+ */
+SQLDBAL_LINKAGE void
+sqldbal_strtotimestamp(struct sqldbal_db *const db,
+                       const char *const text,
+                       int64_t *const ts){
+  const char *s;
+  struct sqldbal_tm tm;
+  int64_t year;
+  int64_t month;
+  int64_t day;
+  int64_t hour;
+  int64_t minute;
+  int64_t second;
+  int64_t usec;
+  int64_t scale;
+  int64_t offset_hour;
+  int64_t offset_minute;
+  int64_t offset_second;
+  int64_t offset_sign;
+  int valid;
+
+  s = text;
+  hour          = 0;
+  minute        = 0;
+  second        = 0;
+  usec          = 0;
+  offset_hour   = 0;
+  offset_minute = 0;
+  offset_second = 0;
+  offset_sign   = 0;
+  valid         = 1;
+
+  year  = sqldbal_parse_digits(&s, '\0', 4);
+  month = sqldbal_parse_digits(&s, '-', 2);
+  day   = sqldbal_parse_digits(&s, '-', 2);
+  if(*s == ' ' || *s == 'T'){
+    s += 1;
+    hour   = sqldbal_parse_digits(&s, '\0', 2);
+    minute = sqldbal_parse_digits(&s, ':', 2);
+    if(*s == ':'){
+      second = sqldbal_parse_digits(&s, ':', 2);
+      if(*s == '.'){
+        s += 1;
+        valid = *s >= '0' && *s <= '9';
+        for(scale = SQLDBAL_USEC_PER_SEC / 10; *s >= '0' && *s <= '9'; s++){
+          usec += (*s - '0') * scale;
+          scale /= 10;
+        }
+      }
     }
-    else if(strcmp(option->key, "TLS_CIPHER") == 0){
-      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CIPHER, option->value);
+  }
+  if(*s == 'Z'){
+    s += 1;
+  }
+  else if(*s == '+' || *s == '-'){
+    if(*s == '+'){
+      offset_sign = 1;
     }
-#endif /* SQLDBAL_MARIADB_HAS_SSL */
     else{
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+      offset_sign = -1;
+    }
+    s += 1;
+    offset_hour = sqldbal_parse_digits(&s, '\0', 2);
+    if(*s == ':'){
+      offset_minute = sqldbal_parse_digits(&s, ':', 2);
+      if(*s == ':'){
+        offset_second = sqldbal_parse_digits(&s, ':', 2);
+      }
+    }
+    else if(*s >= '0' && *s <= '9'){
+      offset_minute = sqldbal_parse_digits(&s, '\0', 2);
     }
   }
 
-  return sqldbal_status_code_get(db);
+  if(strcmp(text, "infinity") == 0){
+    *ts = INT64_MAX;
+  }
+  else if(strcmp(text, "-infinity") == 0){
+    *ts = INT64_MIN;
+  }
+  else if(!valid || *s != '\0' ||
+          year < 0 ||
+          month < 1 || month > 12 ||
+          day < 1 ||
+          day > sqldbal_days_in_month(year, (unsigned int)month) ||
+          hour < 0 || hour > 23 ||
+          minute < 0 || minute > 59 ||
+          second < 0 || second > 59 ||
+          offset_hour < 0 || offset_hour > 15 ||
+          offset_minute < 0 || offset_minute > 59 ||
+          offset_second < 0 || offset_second > 59){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_COLUMN_COERCE);
+    *ts = 0;
+  }
+  else{
+    tm.year   = year;
+    tm.month  = (unsigned int)month;
+    tm.day    = (unsigned int)day;
+    tm.hour   = (unsigned int)hour;
+    tm.minute = (unsigned int)minute;
+    tm.second = (unsigned int)second;
+    tm.usec   = (unsigned int)usec;
+    *ts = sqldbal_tm_to_timestamp(&tm) -
+          offset_sign * ((offset_hour * 60 + offset_minute) * 60 +
+                         offset_second) * SQLDBAL_USEC_PER_SEC;
+  }
 }
 
+#if defined(SQLDBAL_MARIADB) || defined(SQLDBAL_POSTGRESQL)
 /**
- * Connect to MariaDB server.
+ * Safely convert a string to a double and verify the result.
  *
- * @param[in] db          See @ref sqldbal_db.
- * @param[in] location    IP address or hostname.
- * @param[in] port        Server port number to connect to.
- * @param[in] username    User name to connect with.
- * @param[in] password    Optional password for @p username. Set to NULL if
- *                        user does not have a password.
- * @param[in] database    Optional database to open after connecting to the
- *                        server. Set this to NULL to prevent opening a
- *                        database after initially connecting.
- * @param[in] option_list See @ref sqldbal_driver_option.
- * @param[in] num_options Number of entries in @p option_list.
+ * @param[in]  db   See @ref sqldbal_db.
+ * @param[in]  text String to convert.
+ * @param[out] d    Converted value.
  */
-static void
-sqldbal_mariadb_open(struct sqldbal_db *const db,
-                     const char *const location,
-                     const char *const port,
-                     const char *const username,
-                     const char *const password,
-                     const char *const database,
-                     const struct sqldbal_driver_option *const option_list,
-                     size_t num_options){
-  MYSQL *mysql_db;
-  unsigned int port_i;
+SQLDBAL_LINKAGE void
+sqldbal_strtod(struct sqldbal_db *const db,
+               const char *const text,
+               double *const d){
+  char *ep;
 
-  if(sqldbal_strtoui(db,
-                     port,
-                     SQLDBAL_MAX_PORT_NUMBER,
-                     &port_i) != SQLDBAL_STATUS_OK){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  errno = 0;
+  *d = strtod(text, &ep);
+  if(text[0] == '\0' || *ep != '\0' ||
+     (errno == ERANGE && (*d > DBL_MAX || *d < -DBL_MAX))){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_COLUMN_COERCE);
+    *d = 0;
   }
-  else{
-    if(db->flags & SQLDBAL_FLAG_DEBUG){
-      /* https://mariadb.com/kb/en/mysql_debug */
-      mysql_debug("d");
-    }
+}
 
-    /* https://mariadb.com/kb/en/mysql_init */
-    mysql_db = mysql_init(NULL);
-    if(mysql_db == NULL){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-    }
-    else{
-      db->handle = mysql_db;
+/**
+ * Convert a double to the shortest string with up to 17 significant digits
+ * that converts back to the same value.
+ *
+ * @param[in]  d   Value to convert.
+ * @param[out] str Buffer with at least @ref SQLDBAL_CONV_STR_SZ bytes.
+ * @return Number of bytes in @p str, excluding the null-terminator.
+ */
+SQLDBAL_LINKAGE size_t
+sqldbal_double_to_str(double d,
+                      char *const str){
+  double round_trip;
+  int slen;
 
-      if(sqldbal_mariadb_set_options(db,
-                                     num_options,
-                                     option_list) == SQLDBAL_STATUS_OK){
-        /* https://mariadb.com/kb/en/mysql_real_connect */
-        if(mysql_real_connect(mysql_db,
-                              location,
-                              username,
-                              password,
-                              database,
-                              port_i,
-                              NULL,
-                              0) == NULL){
-          sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_OPEN);
-        }
-      }
-    }
+  slen = sprintf(str, "%.15g", d);
+  round_trip = strtod(str, NULL);
+  if(memcmp(&round_trip, &d, sizeof(d)) != 0){
+    slen = sprintf(str, "%.17g", d);
   }
+  return (size_t)slen;
 }
+#endif /* defined(SQLDBAL_MARIADB) || defined(SQLDBAL_POSTGRESQL) */
 
+#ifdef SQLDBAL_HAS_TIME_MS
 /**
- * Close the database connection.
+ * Get a monotonic time in milliseconds.
  *
- * @param[in] db See @ref sqldbal_db.
+ * @return Milliseconds since an unspecified starting point.
  */
-static void
-sqldbal_mariadb_close(struct sqldbal_db *const db){
-  MYSQL *mysql_db;
-
-  mysql_db = db->handle;
+static uint64_t
+sqldbal_time_ms(void){
+  uint64_t ms;
+#ifdef SQLDBAL_IS_WINDOWS
+  ms = GetTickCount64();
+#else /* POSIX */
+  struct timespec ts;
 
-  /* https://mariadb.com/kb/en/mysql_close */
-  mysql_close(mysql_db);
+  ts.tv_sec = 0;
+  ts.tv_nsec = 0;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  ms = (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#endif /* SQLDBAL_IS_WINDOWS */
+  return ms;
 }
+#endif /* SQLDBAL_HAS_TIME_MS */
 
 /**
- * Get the MariaDB database handle.
+ * Get a monotonic time in nanoseconds.
  *
- * @param[in] db See @ref sqldbal_db.
- * @return MYSQL*.
+ * @return Nanoseconds since an unspecified starting point.
  */
-static void *
-sqldbal_mariadb_db_handle(const struct sqldbal_db *const db){
-  MYSQL *mysql_db;
+static uint64_t
+sqldbal_time_ns(void){
+  uint64_t ns;
+#ifdef SQLDBAL_IS_WINDOWS
+  LARGE_INTEGER counter;
+  LARGE_INTEGER freq;
+  uint64_t ticks;
+  uint64_t ticks_per_sec;
+
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&freq);
+  ticks = (uint64_t)counter.QuadPart;
+  ticks_per_sec = (uint64_t)freq.QuadPart;
+  /* Split the conversion so that the multiplication does not overflow. */
+  ns = ticks / ticks_per_sec * 1000000000 +
+       ticks % ticks_per_sec * 1000000000 / ticks_per_sec;
+#else /* POSIX */
+  struct timespec ts;
 
-  mysql_db = db->handle;
-  return mysql_db;
+  ts.tv_sec = 0;
+  ts.tv_nsec = 0;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  ns = (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif /* SQLDBAL_IS_WINDOWS */
+  return ns;
 }
 
 /**
- * Get the MariaDB statement handle.
+ * Hash the SQL text of a statement using 64-bit FNV-1a.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
- * @return MYSQL_STMT*.
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes.
+ * @return            Hash value used by the @ref sqldbal_stmt_cache.
  */
-static void *
-sqldbal_mariadb_stmt_handle(const struct sqldbal_stmt *const stmt){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
+SQLDBAL_LINKAGE uint64_t
+sqldbal_stmt_cache_hash(const char *const sql,
+                        size_t sql_len){
+  uint64_t hash;
+  size_t i;
 
-  mariadb_stmt = stmt->handle;
-  return mariadb_stmt->stmt;
+  hash = UINT64_C(14695981039346656037);
+  for(i = 0; i < sql_len; i++){
+    hash ^= (unsigned char)sql[i];
+    hash *= UINT64_C(1099511628211);
+  }
+  return hash;
 }
 
+#ifdef SQLDBAL_TRACE
 /**
- * Begin MariaDB transaction.
+ * Ring buffer slot holding one @ref sqldbal_trace_entry.
+ */
+struct sqldbal_trace_slot{
+  /**
+   * Ring position allowed to write this slot next, or that position plus
+   * 1 after the entry has been written and is ready to drain.
+   */
+  uint64_t seq;
+
+  /**
+   * See @ref sqldbal_trace_entry.
+   */
+  struct sqldbal_trace_entry entry;
+};
+
+/**
+ * Lock-free ring buffer filled by the connections attached with
+ * @ref sqldbal_trace_attach.
  *
- * @param[in] db See @ref sqldbal_db.
+ * Any number of threads can record entries at the same time by claiming
+ * ring positions from @ref head. The drains take turns using
+ * @ref drain_mutex and read the slots in order starting from @ref tail.
  */
-static void
-sqldbal_mariadb_begin_transaction(struct sqldbal_db *const db){
-  MYSQL *mysql_db;
+struct sqldbal_trace{
+  /**
+   * Ring buffer with a power of 2 number of slots.
+   */
+  struct sqldbal_trace_slot *slot_list;
 
-  mysql_db = db->handle;
+  /**
+   * Number of slots in @ref slot_list minus 1.
+   */
+  uint64_t mask;
 
-  /* https://mariadb.com/kb/en/mysql_autocommit */
-  if(mysql_autocommit(mysql_db, 0)){
-    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
+  /**
+   * Next ring position to record into, shared by all threads.
+   */
+  uint64_t head;
+
+  /**
+   * Next ring position to drain, protected by @ref drain_mutex.
+   */
+  uint64_t tail;
+
+  /**
+   * See @ref sqldbal_trace_open.
+   */
+  uint64_t slow_ns;
+
+  /**
+   * Sample a statement if the upper 32 bits of a random number fall below
+   * this value, which is the sample rate times 2^32.
+   */
+  uint64_t sample_threshold;
+
+  /**
+   * Number of entries added to the ring buffer.
+   */
+  uint64_t num_recorded;
+
+  /**
+   * Number of entries dropped because the ring buffer was full.
+   */
+  uint64_t num_dropped;
+
+  /**
+   * See @ref sqldbal_trace_open.
+   */
+  sqldbal_trace_fp callback;
+
+  /**
+   * See @ref sqldbal_trace_open.
+   */
+  void *user_data;
+
+  /**
+   * See @ref sqldbal_trace_open.
+   */
+  long flush_interval_ms;
+
+#ifdef SQLDBAL_IS_WINDOWS
+  /**
+   * Lets one thread drain at a time.
+   */
+  CRITICAL_SECTION drain_mutex;
+
+  /**
+   * Protects @ref stop.
+   */
+  CRITICAL_SECTION thread_mutex;
+
+  /**
+   * Wakes up the background thread when closing.
+   */
+  CONDITION_VARIABLE thread_cond;
+
+  /**
+   * Background thread draining the entries.
+   */
+  HANDLE thread;
+#else /* POSIX */
+  /**
+   * Lets one thread drain at a time.
+   */
+  pthread_mutex_t drain_mutex;
+
+  /**
+   * Protects @ref stop.
+   */
+  pthread_mutex_t thread_mutex;
+
+  /**
+   * Wakes up the background thread when closing.
+   */
+  pthread_cond_t thread_cond;
+
+  /**
+   * Background thread draining the entries.
+   */
+  pthread_t thread;
+#endif /* SQLDBAL_IS_WINDOWS */
+
+  /**
+   * Set to 1 if the background thread has started.
+   */
+  int has_thread;
+
+  /**
+   * Set to 1 when the background thread should exit.
+   */
+  int stop;
+};
+
+/**
+ * xorshift64 state used to sample statements in each thread.
+ */
+static SQLDBAL_THREAD_LOCAL uint64_t g_trace_rand_state;
+
+/**
+ * Decide whether to record a statement.
+ *
+ * @param[in]  trace      See @ref sqldbal_trace.
+ * @param[in]  elapsed_ns Time spent running the statement.
+ * @param[out] slow       Set to 1 if the statement reached the slow query
+ *                        threshold.
+ * @retval 1 Record the statement.
+ * @retval 0 Skip the statement.
+ */
+static int
+sqldbal_trace_keep(const struct sqldbal_trace *const trace,
+                   uint64_t elapsed_ns,
+                   int *const slow){
+  uint64_t x;
+  int keep;
+
+  *slow = elapsed_ns >= trace->slow_ns;
+  keep = *slow;
+  if(keep == 0 && trace->sample_threshold){
+    x = g_trace_rand_state;
+    if(x == 0){
+      x = (uint64_t)(uintptr_t)&x ^ sqldbal_time_ns();
+      x |= 1;
+    }
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    g_trace_rand_state = x;
+    keep = (x >> 32) < trace->sample_threshold;
   }
+  return keep;
 }
 
 /**
- * Commit a MariaDB transaction.
+ * Copy a statement into the ring buffer without waiting for other threads.
  *
- * @param[in] db See @ref sqldbal_db.
+ * The entry gets dropped if the ring buffer is full.
+ *
+ * @param[in] db         See @ref sqldbal_db.
+ * @param[in] event      See @ref sqldbal_trace_entry::event.
+ * @param[in] sql        SQL text, or NULL if not known.
+ * @param[in] sql_len    Length of @p sql in bytes.
+ * @param[in] sql_hash   See @ref sqldbal_trace_entry::sql_hash.
+ * @param[in] elapsed_ns See @ref sqldbal_trace_entry::elapsed_ns.
+ * @param[in] num_rows   See @ref sqldbal_trace_entry::num_rows.
+ * @param[in] slow       See @ref sqldbal_trace_entry::slow.
  */
 static void
-sqldbal_mariadb_commit(struct sqldbal_db *const db){
-  MYSQL *mysql_db;
-
-  mysql_db = db->handle;
+sqldbal_trace_push(const struct sqldbal_db *const db,
+                   enum sqldbal_metrics_event event,
+                   const char *const sql,
+                   size_t sql_len,
+                   uint64_t sql_hash,
+                   uint64_t elapsed_ns,
+                   uint64_t num_rows,
+                   int slow){
+  struct sqldbal_trace *trace;
+  struct sqldbal_trace_slot *candidate;
+  struct sqldbal_trace_slot *slot;
+  struct sqldbal_trace_entry *entry;
+  uint64_t pos;
+  uint64_t seq;
+  size_t copy_len;
+  int full;
+
+  trace = db->trace;
+  slot = NULL;
+  full = 0;
+  pos = SQLDBAL_ATOMIC_LOAD(&trace->head);
+  while(slot == NULL && full == 0){
+    candidate = &trace->slot_list[pos & trace->mask];
+    seq = SQLDBAL_ATOMIC_LOAD(&candidate->seq);
+    if(seq == pos && SQLDBAL_ATOMIC_CAS(&trace->head, pos, pos + 1)){
+      slot = candidate;
+    }
+    else if(seq < pos){
+      /* The slot still holds an entry from the previous lap. */
+      full = 1;
+    }
+    else{
+      /* Another thread claimed this position first. */
+      pos = SQLDBAL_ATOMIC_LOAD(&trace->head);
+    }
+  }
 
-  /* https://mariadb.com/kb/en/mysql_commit     */
-  /* https://mariadb.com/kb/en/mysql_autocommit */
-  if(mysql_commit(mysql_db) ||
-     mysql_autocommit(mysql_db, 1)){
-    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
+  if(slot == NULL){
+    SQLDBAL_ATOMIC_ADD(&trace->num_dropped, 1);
+  }
+  else{
+    entry = &slot->entry;
+    copy_len = 0;
+    if(sql){
+      copy_len = sql_len;
+      if(copy_len > SQLDBAL_TRACE_SQL_MAX - 1){
+        copy_len = SQLDBAL_TRACE_SQL_MAX - 1;
+      }
+      memcpy(entry->sql, sql, copy_len);
+    }
+    entry->sql[copy_len] = '\0';
+    entry->sql_len    = sql_len;
+    entry->sql_hash   = sql_hash;
+    entry->elapsed_ns = elapsed_ns;
+    entry->num_rows   = num_rows;
+    entry->driver     = db->type;
+    entry->event      = event;
+    entry->status     = sqldbal_status_code_get(db);
+    entry->slow       = slow;
+    SQLDBAL_ATOMIC_STORE(&slot->seq, pos + 1);
+    SQLDBAL_ATOMIC_ADD(&trace->num_recorded, 1);
   }
 }
+#endif /* SQLDBAL_TRACE */
 
 /**
- * Rollback a MariaDB transaction.
+ * Free the existing error string and replace with a new error string.
  *
- * @param[in] db See @ref sqldbal_db.
+ * @param[in] db     See @ref sqldbal_db.
+ * @param[in] errstr Error string to set in the database context. This
+ *                   function makes a copy of the string, reusing the
+ *                   buffer from the previous error if large enough.
  */
-static void
-sqldbal_mariadb_rollback(struct sqldbal_db *const db){
-  MYSQL *mysql_db;
-
-  mysql_db = db->handle;
+SQLDBAL_LINKAGE void
+sqldbal_errstr_set(struct sqldbal_db *const db,
+                   const char *const errstr){
+  size_t errstr_size;
 
-  /* https://mariadb.com/kb/en/mysql_rollback   */
-  /* https://mariadb.com/kb/en/mysql_autocommit */
-  if(mysql_rollback(mysql_db) ||
-     mysql_autocommit(mysql_db, 1)){
-    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
+  errstr_size = strlen(errstr);
+  if(errstr_size == SIZE_MAX){
+    free(db->errstr);
+    db->errstr = NULL;
+    db->errstr_size = 0;
+  }
+  else{
+    errstr_size += 1;
+    if(errstr_size > db->errstr_size){
+      free(db->errstr);
+      db->errstr_size = 0;
+      db->errstr = malloc(errstr_size);
+      if(db->errstr){
+        db->errstr_size = errstr_size;
+      }
+    }
+    if(db->errstr){
+      memcpy(db->errstr, errstr, errstr_size);
+    }
+  }
+  if(db->errstr == NULL){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
   }
 }
 
 /**
- * Convert unsigned long values returned by mysql_fetch_lengths() into
- * a size_t list while checking for wrapping.
+ * Convenience function that sets both the error status code and error string.
  *
- * @param[in]  lengths         List of unsigned long values to convert
- *                             to size_t.
- * @param[out] col_length_list Store the converted values in this list.
- * @param[in]  num_fields      Number of entries in @p lengths.
- * @retval 0 All length values converted to a size_t.
- * @retval 1 At least one length value did not fit into a size_t.
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] status_code See @ref sqldbal_status_code.
+ * @param[in] errstr      Error string to set in the database context.
+ */
+static void
+sqldbal_err_set(struct sqldbal_db *const db,
+                enum sqldbal_status_code status_code,
+                const char *const errstr){
+  sqldbal_status_code_set(db, status_code);
+  sqldbal_errstr_set(db, errstr);
+}
+
+/**
+ * Check if a row in a batch parameter has a NULL value.
+ *
+ * @param[in] param See @ref sqldbal_batch_param.
+ * @param[in] row   Row index starting at 0.
+ * @retval 1 Row has a NULL value.
+ * @retval 0 Row has a non-NULL value.
  */
 static int
-sqldbal_mariadb_fetch_lengths_conv_size(const unsigned long *const lengths,
-                                        size_t *const col_length_list,
-                                        unsigned int num_fields){
-  unsigned int i;
-  int rc;
-  size_t size_conv;
+sqldbal_batch_is_null(const struct sqldbal_batch_param *const param,
+                      size_t row){
+  int is_null;
 
-  rc = 0;
-  for(i = 0; i < num_fields; i++){
-    if(si_ulong_to_size(lengths[i], &size_conv)){
-      rc = 1;
-      break;
-    }
-    col_length_list[i] = size_conv;
+  is_null = 0;
+  if(param->type == SQLDBAL_TYPE_NULL){
+    is_null = 1;
   }
-  return rc;
+  else if(param->null_bitmap){
+    is_null = (param->null_bitmap[row / 8] >> (row % 8)) & 1;
+  }
+  return is_null;
 }
 
 /**
- * Execute a direct SQL statement.
+ * Bind every placeholder in a statement to the values from one batch row.
  *
- * @param[in] db        See @ref sqldbal_db.
- * @param[in] sql       SQL command to execute.
- * @param[in] callback  Invokes this callback function for every returned row
- *                      in the query result set. Set this to NULL if query
- *                      results not needed.
- * @param[in] user_data Pass this to the first argument in the
- *                      @p callback function.
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] row        Row index starting at 0.
  */
 static void
-sqldbal_mariadb_exec(struct sqldbal_db *const db,
-                     const char *const sql,
-                     sqldbal_exec_callback_fp callback,
-                     void *user_data){
-  MYSQL *mysql_db;
-  MYSQL_RES *result;
-  MYSQL_ROW row;
-  unsigned int num_fields;
-  size_t num_rows;
-  size_t i;
-  unsigned long *lengths;
-  size_t *col_length_list;
-
-  mysql_db = db->handle;
+sqldbal_stmt_batch_bind_row(struct sqldbal_stmt *const stmt,
+                            const struct sqldbal_batch_param *const param_list,
+                            size_t row){
+  const struct sqldbal_batch_param *param;
+  const struct sqldbal_driver_functions *func;
+  size_t col_idx;
+  size_t slen;
 
-  /* https://mariadb.com/kb/en/mysql_real_query */
-  if(mysql_real_query(mysql_db, sql, strlen(sql))){
-    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
-  }
-  else{
-    /* https://mariadb.com/kb/en/mysql_store_result */
-    result = mysql_store_result(mysql_db);
-    if(result){
-      if(callback){
-        /* https://mariadb.com/kb/en/mysql_num_fields */
-        num_fields = mysql_num_fields(result);
+  func = SQLDBAL_FUNCTIONS(stmt->db);
+  for(col_idx = 0;
+      col_idx < stmt->num_params &&
+      sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK;
+      col_idx++){
+    param = &param_list[col_idx];
+    if(sqldbal_batch_is_null(param, row)){
+      func->sqldbal_fp_stmt_bind_null(stmt, col_idx);
+    }
+    else if(param->type == SQLDBAL_TYPE_INT){
+      func->sqldbal_fp_stmt_bind_int64(stmt, col_idx, param->i64_list[row]);
+    }
+    else if(param->type == SQLDBAL_TYPE_TEXT){
+      if(param->length_list){
+        slen = param->length_list[row];
+      }
+      else{
+        slen = strlen(param->text_list[row]);
+      }
 
-        col_length_list = sqldbal_reallocarray(NULL,
-                                               num_fields,
-                                               sizeof(*col_length_list));
-        if(col_length_list == NULL){
-          sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-        }
-        else{
-          /* https://mariadb.com/kb/en/mysql_num_rows */
-          num_rows = mysql_num_rows(result);
-          for(i = 0; i < num_rows; i++){
-            /* https://mariadb.com/kb/en/mysql_fetch_row */
-            row = mysql_fetch_row(result);
-            /* https://mariadb.com/kb/en/mysql_fetch_lengths */
-            lengths = mysql_fetch_lengths(result);
-            if(sqldbal_mariadb_fetch_lengths_conv_size(lengths, col_length_list, num_fields)){
-              sqldbal_status_code_set(db, SQLDBAL_STATUS_OVERFLOW);
-            }
-            else{
-              if(callback(user_data,
-                          num_fields,
-                          row,
-                          col_length_list)){
-                sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
-                break;
-              }
-            }
-          }
-          free(col_length_list);
-        }
+      /* Include null-terminator like sqldbal_stmt_bind_text. */
+      if(si_add_size_t(slen, 1, &slen)){
+        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        func->sqldbal_fp_stmt_bind_text(stmt,
+                                        col_idx,
+                                        param->text_list[row],
+                                        slen);
       }
-      /* https://mariadb.com/kb/en/mysql_free_result */
-      mysql_free_result(result);
     }
-    else if(mysql_errno(mysql_db)){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
+    else{
+      func->sqldbal_fp_stmt_bind_blob(stmt,
+                                      col_idx,
+                                      param->blob_list[row],
+                                      param->length_list[row]);
     }
   }
 }
 
 /**
- * Get the insert id from the last SQL insert statement.
+ * Execute a batch by binding and executing the statement for each row.
  *
- * @param[in]  db        See @ref sqldbal_db.
- * @param[in]  name      Unused.
- * @param[out] insert_id Last insert id.
+ * Used by drivers that do not have a native bulk execution interface, and
+ * also used as a fallback when the native interface cannot get used.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in @p param_list.
  */
 static void
-sqldbal_mariadb_last_insert_id(struct sqldbal_db *const db,
-                               const char *const name,
-                               uint64_t *insert_id){
-  MYSQL *mysql_db;
-  my_ulonglong ull;
-
-  (void)name;
-
-  mysql_db = db->handle;
-
-  /* https://mariadb.com/kb/en/mysql_insert_id */
-  ull = mysql_insert_id(mysql_db);
-  *insert_id = ull;
+sqldbal_stmt_execute_batch_loop(
+  struct sqldbal_stmt *const stmt,
+  const struct sqldbal_batch_param *const param_list,
+  size_t num_rows){
+  size_t row;
+
+  for(row = 0;
+      row < num_rows &&
+      sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK;
+      row++){
+    sqldbal_stmt_batch_bind_row(stmt, param_list, row);
+    if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_execute(stmt);
+    }
+  }
 }
 
 /**
- * Query prepared statement properties (column count, blob size, ...)
- * and allocate memory resources based on that information.
- *
- * @param[in] db   See @ref sqldbal_db.
- * @param[in] stmt See @ref sqldbal_stmt.
+ * Send the rows buffered by a bulk load once the buffer reaches this many
+ * bytes.
  */
-static void
-sqldbal_mariadb_stmt_get_num_cols(struct sqldbal_db *const db,
-                                  struct sqldbal_stmt *const stmt){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  MYSQL_RES *metadata;
+#define SQLDBAL_BULK_FLUSH_SIZE (64 * 1024)
 
-  mariadb_stmt = stmt->handle;
-
-  /* https://mariadb.com/kb/en/mysql_stmt_result_metadata */
-  metadata = mysql_stmt_result_metadata(mariadb_stmt->stmt);
-  if(metadata == NULL){
-    stmt->num_cols_result = 0;
-    /* https://mariadb.com/kb/en/mysql_stmt_errno */
-    if(mysql_stmt_errno(mariadb_stmt->stmt)){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-    }
+/**
+ * Make room for more bytes at the end of @ref sqldbal_bulk::buf.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ * @param[in] len  Number of bytes needed.
+ * @retval char* Start of the unused space in @ref sqldbal_bulk::buf.
+ * @retval NULL  Memory allocation failed.
+ */
+static char *
+sqldbal_bulk_reserve(struct sqldbal_bulk *const bulk,
+                     size_t len){
+  char *buf;
+  size_t need;
+  size_t buf_size;
+
+  buf = NULL;
+  if(si_add_size_t(bulk->buf_len, len, &need)){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+  }
+  else if(need <= bulk->buf_size){
+    buf = &bulk->buf[bulk->buf_len];
   }
   else{
-    /* https://mariadb.com/kb/en/mysql_num_fields */
-    stmt->num_cols_result = mysql_num_fields(metadata);
+    /* Grow geometrically so that appending stays amortized O(1). */
+    if(si_mul_size_t(bulk->buf_size, 2, &buf_size) || buf_size < need){
+      buf_size = need;
+    }
+    buf = realloc(bulk->buf, buf_size);
+    if(buf == NULL){
+      sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      bulk->buf = buf;
+      bulk->buf_size = buf_size;
+      buf = &bulk->buf[bulk->buf_len];
+    }
+  }
+  return buf;
+}
 
-    /* https://mariadb.com/kb/en/mysql_free_result */
-    mysql_free_result(metadata);
+/**
+ * Append bytes to @ref sqldbal_bulk::buf.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ * @param[in] data Bytes to append.
+ * @param[in] len  Number of bytes in @p data.
+ */
+static void
+sqldbal_bulk_append(struct sqldbal_bulk *const bulk,
+                    const void *const data,
+                    size_t len){
+  char *buf;
+
+  buf = sqldbal_bulk_reserve(bulk, len);
+  if(buf && len){
+    memcpy(buf, data, len);
+    bulk->buf_len += len;
   }
 }
 
 /**
- * Prepare a database statement.
+ * Append a string to @ref sqldbal_bulk::buf, without the null-terminator.
  *
- * @param[in] db      See @ref sqldbal_db.
- * @param[in] sql     SQL query to prepare.
- * @param[in] sql_len Length in bytes of @p sql, or -1 if null-terminated.
- * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] bulk See @ref sqldbal_bulk.
+ * @param[in] str  Null-terminated string.
  */
 static void
-sqldbal_mariadb_stmt_prepare(struct sqldbal_db *const db,
-                             const char *const sql,
-                             size_t sql_len,
-                             struct sqldbal_stmt *const stmt){
-  MYSQL *mysql_db;
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  unsigned long num_bind_out;
+sqldbal_bulk_append_str(struct sqldbal_bulk *const bulk,
+                        const char *const str){
+  sqldbal_bulk_append(bulk, str, strlen(str));
+}
 
-  mysql_db = db->handle;
+/**
+ * Append a SQL statement in the form: prefix table (col1, col2) suffix.
+ *
+ * @param[in] bulk        See @ref sqldbal_bulk.
+ * @param[in] prefix      SQL before the table name.
+ * @param[in] table       See @ref sqldbal_bulk_begin.
+ * @param[in] column_list See @ref sqldbal_bulk_begin.
+ * @param[in] suffix      SQL after the column list.
+ */
+static void
+sqldbal_bulk_append_sql(struct sqldbal_bulk *const bulk,
+                        const char *const prefix,
+                        const char *const table,
+                        const char *const *const column_list,
+                        const char *const suffix){
+  size_t i;
 
-  mariadb_stmt = malloc(sizeof(*mariadb_stmt));
-  if(mariadb_stmt == NULL){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  sqldbal_bulk_append_str(bulk, prefix);
+  sqldbal_bulk_append_str(bulk, table);
+  sqldbal_bulk_append_str(bulk, " (");
+  for(i = 0; i < bulk->num_cols; i++){
+    if(i){
+      sqldbal_bulk_append_str(bulk, ", ");
+    }
+    sqldbal_bulk_append_str(bulk, column_list[i]);
   }
-  else{
-    stmt->handle = mariadb_stmt;
-    mariadb_stmt->bind_out            = NULL;
-    mariadb_stmt->bind_in_list        = NULL;
-    mariadb_stmt->bind_in_length_list = NULL;
-    mariadb_stmt->bind_in_null_list   = NULL;
+  sqldbal_bulk_append_str(bulk, ")");
+  sqldbal_bulk_append_str(bulk, suffix);
+}
 
-    /* https://mariadb.com/kb/en/mysql_stmt_init */
-    mariadb_stmt->stmt = mysql_stmt_init(mysql_db);
-    if(mariadb_stmt->stmt == NULL){
-      sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_PREPARE);
+/**
+ * Get a text or blob value from a batch parameter.
+ *
+ * @param[in]  param See @ref sqldbal_batch_param.
+ * @param[in]  row   Row index starting at 0.
+ * @param[out] len   Number of bytes in the returned value.
+ * @return Value bytes.
+ */
+static const void *
+sqldbal_batch_data(const struct sqldbal_batch_param *const param,
+                   size_t row,
+                   size_t *const len){
+  const void *data;
+
+  if(param->type == SQLDBAL_TYPE_TEXT){
+    data = param->text_list[row];
+    if(param->length_list){
+      *len = param->length_list[row];
     }
     else{
-      if(sql_len == SIZE_MAX){
-        sql_len = strlen(sql);
-      }
-
-      /* https://mariadb.com/kb/en/mysql_stmt_prepare */
-      if(mysql_stmt_prepare(mariadb_stmt->stmt, sql, sql_len) != 0){
-        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_PREPARE);
-      }
-      else{
-        /* https://mariadb.com/kb/en/mysql_stmt_param_count */
-        num_bind_out = mysql_stmt_param_count(mariadb_stmt->stmt);
-        stmt->num_params = (size_t)num_bind_out;
-        mariadb_stmt->bind_out =
-          sqldbal_reallocarray(NULL,
-                               stmt->num_params,
-                               sizeof(*mariadb_stmt->bind_out));
-        if(mariadb_stmt->bind_out == NULL){
-          sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-
-          /* https://mariadb.com/kb/en/mysql_stmt_close */
-          mysql_stmt_close(mariadb_stmt->stmt);
-          mariadb_stmt->stmt = NULL;
-        }
-        else{
-          sqldbal_mariadb_stmt_get_num_cols(db, stmt);
-          memset(mariadb_stmt->bind_out,
-                 0,
-                 stmt->num_params * sizeof(*mariadb_stmt->bind_out));
-        }
-      }
+      *len = strlen(param->text_list[row]);
     }
   }
+  else{
+    data = param->blob_list[row];
+    *len = param->length_list[row];
+  }
+  return data;
 }
 
 /**
- * Free the MariaDB bind buffer if it has already been allocated.
+ * Copy a row into @ref sqldbal_bulk::buf.
  *
- * The bind buffer can get re-used across statement executions.
+ * Each value gets stored as a @ref sqldbal_column_type byte, followed by
+ * the int64_t value or by the size_t length and the bytes. Text includes
+ * the null-terminator.
  *
- * @param[in] bind MariaDB bind structure.
+ * @param[in] bulk       See @ref sqldbal_bulk.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] row        Row index starting at 0.
  */
 static void
-sqldbal_mariadb_stmt_bind_free_buf(MYSQL_BIND *bind){
-  if(bind->buffer){
-    free(bind->buffer);
-    bind->buffer = NULL;
+sqldbal_bulk_append_row(struct sqldbal_bulk *const bulk,
+                        const struct sqldbal_batch_param *const param_list,
+                        size_t row){
+  const struct sqldbal_batch_param *param;
+  const void *data;
+  size_t col_idx;
+  size_t len;
+  size_t len_nul;
+  char type;
+
+  for(col_idx = 0; col_idx < bulk->num_cols; col_idx++){
+    param = &param_list[col_idx];
+    if(sqldbal_batch_is_null(param, row)){
+      type = SQLDBAL_TYPE_NULL;
+      sqldbal_bulk_append(bulk, &type, 1);
+    }
+    else if(param->type == SQLDBAL_TYPE_INT){
+      type = SQLDBAL_TYPE_INT;
+      sqldbal_bulk_append(bulk, &type, 1);
+      sqldbal_bulk_append(bulk,
+                          &param->i64_list[row],
+                          sizeof(param->i64_list[row]));
+    }
+    else if(param->type == SQLDBAL_TYPE_TEXT){
+      /* Include null-terminator like sqldbal_stmt_bind_text. */
+      type = SQLDBAL_TYPE_TEXT;
+      data = sqldbal_batch_data(param, row, &len);
+      len_nul = len + 1;
+      sqldbal_bulk_append(bulk, &type, 1);
+      sqldbal_bulk_append(bulk, &len_nul, sizeof(len_nul));
+      sqldbal_bulk_append(bulk, data, len);
+      sqldbal_bulk_append(bulk, "", 1);
+    }
+    else{
+      type = SQLDBAL_TYPE_BLOB;
+      data = sqldbal_batch_data(param, row, &len);
+      sqldbal_bulk_append(bulk, &type, 1);
+      sqldbal_bulk_append(bulk, &len, sizeof(len));
+      sqldbal_bulk_append(bulk, data, len);
+    }
   }
 }
 
 /**
- * Assign binary data to a prepared statement placeholder.
+ * Copy part of a value that the driver already holds in memory.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] blob    Binary data saved to BLOB or BYTEA types.
- * @param[in] blobsz  Length of @p blob in bytes.
+ * @param[in]  data    Value bytes.
+ * @param[in]  datasz  Number of bytes in @p data.
+ * @param[in]  offset  Copy the bytes starting at this position.
+ * @param[out] buf     Buffer receiving the bytes.
+ * @param[in]  bufsz   Maximum number of bytes to copy.
+ * @param[out] len     Number of bytes copied, which is 0 if @p offset does
+ *                     not come before the end of the value.
  */
 static void
-sqldbal_mariadb_stmt_bind_blob(struct sqldbal_stmt *const stmt,
-                               size_t col_idx,
-                               const void *const blob,
-                               size_t blobsz){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  MYSQL_BIND *bind_col;
-  void *blob_copy;
-
-  blob_copy = malloc(blobsz);
-  if(blob_copy == NULL){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-  }
-  else{
-    memcpy(blob_copy, blob, blobsz);
-
-    mariadb_stmt = stmt->handle;
-    bind_col = &mariadb_stmt->bind_out[col_idx];
-    sqldbal_mariadb_stmt_bind_free_buf(bind_col);
+sqldbal_blob_copy(const void *const data,
+                  size_t datasz,
+                  uint64_t offset,
+                  void *const buf,
+                  size_t bufsz,
+                  size_t *const len){
+  const char *bytes;
 
-    bind_col->buffer_type   = MYSQL_TYPE_BLOB;
-    bind_col->buffer        = blob_copy;
-    bind_col->buffer_length = blobsz;
-    bind_col->length        = &bind_col->buffer_length;
-    bind_col->is_null       = NULL;
-    bind_col->is_unsigned   = 0;
-    bind_col->error         = NULL;
+  *len = 0;
+  if(data && offset < datasz){
+    *len = datasz - (size_t)offset;
+    if(*len > bufsz){
+      *len = bufsz;
+    }
+    bytes = data;
+    memcpy(buf, &bytes[offset], *len);
   }
 }
 
 /**
- * Assign a 64-bit integer to a prepared statement placeholder.
+ * Start collecting a blob placeholder value in @ref sqldbal_stmt::stream_list.
  *
  * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] i64     Integer to bind.
+ * @param[in] col_idx Placeholder index.
+ * @retval  0 Started an empty value.
+ * @retval -1 Memory allocation failed.
  */
-static void
-sqldbal_mariadb_stmt_bind_int64(struct sqldbal_stmt *const stmt,
-                                size_t col_idx,
-                                int64_t i64){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  MYSQL_BIND *bind_col;
-  long long ll;
-  long long *ill;
+static int
+sqldbal_stmt_stream_begin(struct sqldbal_stmt *const stmt,
+                          size_t col_idx){
+  int rc;
 
-  if(si_int64_to_llong(i64, &ll)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  rc = -1;
+  if(stmt->stream_list == NULL){
+    stmt->stream_list = calloc(stmt->num_params, sizeof(*stmt->stream_list));
+  }
+  if(stmt->stream_list == NULL){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
   }
   else{
-    ill = malloc(sizeof(*ill));
-    if(ill == NULL){
-      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-    }
-    else{
-      *ill = ll;
-
-      mariadb_stmt = stmt->handle;
-      bind_col = &mariadb_stmt->bind_out[col_idx];
-      sqldbal_mariadb_stmt_bind_free_buf(bind_col);
-
-      bind_col->buffer_type   = MYSQL_TYPE_LONGLONG;
-      bind_col->buffer        = ill;
-      bind_col->buffer_length = sizeof(*ill);
-      bind_col->length        = &bind_col->buffer_length;
-      bind_col->is_null       = NULL;
-      bind_col->is_unsigned   = 0;
-      bind_col->error         = NULL;
-    }
+    stmt->stream_list[col_idx].len    = 0;
+    stmt->stream_list[col_idx].active = 1;
+    rc = 0;
   }
+  return rc;
 }
 
 /**
- * Assign a text string to a prepared statement placeholder.
+ * Add a chunk to a blob placeholder value started by
+ * @ref sqldbal_stmt_stream_begin.
+ *
+ * The buffer doubles in size when the chunk does not fit, so that sending
+ * many small chunks does not copy the value each time.
  *
  * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] s       Text string saved to a SQL text type.
- * @param[in] slen    Length of @p s in bytes.
+ * @param[in] col_idx Placeholder index.
+ * @param[in] chunk   Next bytes of the value.
+ * @param[in] chunksz Number of bytes in @p chunk.
+ * @return            Value collected so far, or NULL if the placeholder
+ *                    does not have a streamed value or on error.
  */
-static void
-sqldbal_mariadb_stmt_bind_text(struct sqldbal_stmt *const stmt,
-                               size_t col_idx,
-                               const char *const s,
-                               size_t slen){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  MYSQL_BIND *bind_col;
-  char *s_copy;
+static struct sqldbal_stmt_stream *
+sqldbal_stmt_stream_append(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           const void *const chunk,
+                           size_t chunksz){
+  struct sqldbal_stmt_stream *stream;
+  size_t len;
+  size_t size;
+  char *buf;
 
-  s_copy = malloc(slen);
-  if(s_copy == NULL){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+  stream = NULL;
+  if(stmt->stream_list){
+    stream = &stmt->stream_list[col_idx];
+  }
+  if(stream == NULL || stream->active == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+    stream = NULL;
+  }
+  else if(si_add_size_t(stream->len, chunksz, &len)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+    stream = NULL;
   }
   else{
-    strcpy(s_copy, s);
-
-    mariadb_stmt = stmt->handle;
-    bind_col = &mariadb_stmt->bind_out[col_idx];
-    sqldbal_mariadb_stmt_bind_free_buf(bind_col);
-
-    bind_col->buffer_type   = MYSQL_TYPE_STRING;
-    bind_col->buffer        = s_copy;
-    bind_col->buffer_length = slen;
-    bind_col->length        = &bind_col->buffer_length;
-    bind_col->is_null       = NULL;
-    bind_col->is_unsigned   = 0;
-    bind_col->error         = NULL;
+    if(len > stream->size){
+      size = stream->size ? stream->size : 4096;
+      while(size < len && size <= SIZE_MAX / 2){
+        size *= 2;
+      }
+      if(size < len){
+        size = len;
+      }
+      buf = realloc(stream->buf, size);
+      if(buf == NULL){
+        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+        stream = NULL;
+      }
+      else{
+        stream->buf  = buf;
+        stream->size = size;
+      }
+    }
+    if(stream){
+      if(chunksz){
+        memcpy(&stream->buf[stream->len], chunk, chunksz);
+      }
+      stream->len = len;
+    }
   }
+  return stream;
 }
 
 /**
- * Assign a NULL value to a prepared statement placeholder.
+ * Maximum buffer size for 64-bit signed integer.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * Minimum 64-bit integer:
+ * -9223372036854775808
+ * 123456789012345678901
+ *         10        20 -> 21 bytes
  */
-static void
-sqldbal_mariadb_stmt_bind_null(struct sqldbal_stmt *const stmt,
-                               size_t col_idx){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  MYSQL_BIND *bind_col;
-
-  mariadb_stmt = stmt->handle;
-  bind_col = &mariadb_stmt->bind_out[col_idx];
-  sqldbal_mariadb_stmt_bind_free_buf(bind_col);
-
-  bind_col->buffer_type   = MYSQL_TYPE_NULL;
-  bind_col->buffer        = NULL;
-  bind_col->buffer_length = 0;
-  bind_col->length        = NULL;
-  bind_col->is_null       = NULL;
-  bind_col->is_unsigned   = 0;
-  bind_col->error         = NULL;
-}
+#define MAX_I64_STR_SZ 21
 
+#if defined(SQLDBAL_MARIADB) || defined(SQLDBAL_POSTGRESQL)
 /**
- * Allocate memory for binding variables used when fetching data.
+ * Escape a value for the tab-separated text format used by LOAD DATA in
+ * MariaDB and by COPY in PostgreSQL.
  *
- * @param[in] stmt     See @ref sqldbal_stmt.
- * @param[in] metadata Statement metadata from mysql_stmt_result_metadata().
- * @return See @ref sqldbal_status_code.
+ * Backslash, tab, newline, carriage return, and NUL bytes get replaced by
+ * a backslash escape sequence.
+ *
+ * @param[in]  src Bytes to escape.
+ * @param[in]  len Number of bytes in @p src.
+ * @param[out] dst Buffer with at least twice the length of @p src.
+ * @return Number of bytes written to @p dst.
  */
-static enum sqldbal_status_code
-sqldbal_mariadb_stmt_allocate_bind_in_list(struct sqldbal_stmt *const stmt,
-                                           MYSQL_RES *const metadata){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
+SQLDBAL_LINKAGE size_t
+sqldbal_bulk_escape(const void *const src,
+                    size_t len,
+                    char *const dst){
+  const unsigned char *src_bytes;
+  size_t dst_len;
   size_t i;
-  char *blob_buf;
-  MYSQL_BIND *bind;
-  MYSQL_FIELD *field_blob;
-  unsigned int fieldnr;
-
-  mariadb_stmt = stmt->handle;
-
-  mariadb_stmt->bind_in_list = calloc(stmt->num_cols_result,
-                                      sizeof(*mariadb_stmt->bind_in_list));
-
-  mariadb_stmt->bind_in_length_list = calloc(
-    stmt->num_cols_result,
-    sizeof(*mariadb_stmt->bind_in_length_list));
-
-  mariadb_stmt->bind_in_null_list = calloc(
-    stmt->num_cols_result,
-    sizeof(*mariadb_stmt->bind_in_null_list));
 
-  if(mariadb_stmt->bind_in_list        == NULL ||
-     mariadb_stmt->bind_in_length_list == NULL ||
-     mariadb_stmt->bind_in_null_list   == NULL){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-  }
-  else{
-    for(i = 0; i < stmt->num_cols_result; i++){
-      if(si_size_to_uint(i, &fieldnr)){
-        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+  src_bytes = src;
+  dst_len = 0;
+  for(i = 0; i < len; i++){
+    switch(src_bytes[i]){
+      case '\\':
+        dst[dst_len++] = '\\';
+        dst[dst_len++] = '\\';
+        break;
+      case '\t':
+        dst[dst_len++] = '\\';
+        dst[dst_len++] = 't';
+        break;
+      case '\n':
+        dst[dst_len++] = '\\';
+        dst[dst_len++] = 'n';
+        break;
+      case '\r':
+        dst[dst_len++] = '\\';
+        dst[dst_len++] = 'r';
+        break;
+      case '\0':
+        dst[dst_len++] = '\\';
+        dst[dst_len++] = '0';
+        break;
+      default:
+        dst[dst_len++] = (char)src_bytes[i];
         break;
-      }
-      else{
-        /* https://mariadb.com/kb/en/mysql_fetch_field_direct */
-        field_blob = mysql_fetch_field_direct(metadata, fieldnr);
-        blob_buf = malloc(field_blob->max_length);
-        if(blob_buf == NULL){
-          sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-          break;
-        }
-        else{
-          bind = &mariadb_stmt->bind_in_list[i];
-          bind->buffer_type   = MYSQL_TYPE_BLOB;
-          bind->buffer        = blob_buf;
-          bind->buffer_length = field_blob->max_length;
-          bind->length        = &mariadb_stmt->bind_in_length_list[i];
-          bind->error         = NULL;
-          bind->is_null       = &mariadb_stmt->bind_in_null_list[i];
-        }
-      }
     }
   }
-  return sqldbal_status_code_get(stmt->db);
+  return dst_len;
 }
 
 /**
- * Execute a compiled statement with bound parameters.
+ * Append an escaped value to @ref sqldbal_bulk::buf.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
+ * See @ref sqldbal_bulk_escape.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ * @param[in] data Bytes to escape.
+ * @param[in] len  Number of bytes in @p data.
  */
 static void
-sqldbal_mariadb_stmt_execute(struct sqldbal_stmt *const stmt){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  char update_max_length;
-  MYSQL_RES *metadata;
-
-  mariadb_stmt = stmt->handle;
-
-  update_max_length = 1;
-  /* https://mariadb.com/kb/en/mysql_stmt_attr_set */
-  /* https://mariadb.com/kb/en/mysql_stmt_bind_param   */
-  /* https://mariadb.com/kb/en/mysql_stmt_execute      */
-  /* https://mariadb.com/kb/en/mysql_stmt_store_result */
-  if(mysql_stmt_attr_set(mariadb_stmt->stmt,
-                         STMT_ATTR_UPDATE_MAX_LENGTH,
-                         &update_max_length) ||
-     mysql_stmt_bind_param  (mariadb_stmt->stmt, mariadb_stmt->bind_out) ||
-     mysql_stmt_execute     (mariadb_stmt->stmt) ||
-     mysql_stmt_store_result(mariadb_stmt->stmt)){
-    sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
+sqldbal_bulk_append_escaped(struct sqldbal_bulk *const bulk,
+                            const void *const data,
+                            size_t len){
+  char *buf;
+  size_t escape_len;
+
+  if(si_mul_size_t(len, 2, &escape_len)){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
   }
   else{
-    if(stmt->num_cols_result){
-      /* https://mariadb.com/kb/en/mysql_stmt_result_metadata */
-      metadata = mysql_stmt_result_metadata(mariadb_stmt->stmt);
-
-      if(metadata){
-        if(sqldbal_mariadb_stmt_allocate_bind_in_list(
-                                              stmt,
-                                              metadata) == SQLDBAL_STATUS_OK){
-          /* https://mariadb.com/kb/en/mysql_stmt_bind_result */
-          if(mysql_stmt_bind_result(mariadb_stmt->stmt,
-                                    mariadb_stmt->bind_in_list)){
-            sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
-          }
-        }
-        mysql_free_result(metadata);
-      }
-      else{
-        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_NOMEM);
-      }
+    buf = sqldbal_bulk_reserve(bulk, escape_len);
+    if(buf){
+      bulk->buf_len += sqldbal_bulk_escape(data, len, buf);
     }
   }
 }
 
 /**
- * Get the next row in the result set.
- *
- * @param[in] stmt See @ref sqldbal_stmt.
- * @return See @ref sqldbal_fetch_result.
- */
-static enum sqldbal_fetch_result
-sqldbal_mariadb_stmt_fetch(struct sqldbal_stmt *const stmt){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  enum sqldbal_fetch_result fetch_result;
-
-  mariadb_stmt = stmt->handle;
-
-  /* https://mariadb.com/kb/en/mysql_stmt_fetch */
-  switch(mysql_stmt_fetch(mariadb_stmt->stmt)){
-    case 0:
-      fetch_result = SQLDBAL_FETCH_ROW;
-      break;
-    case MYSQL_NO_DATA:
-      fetch_result = SQLDBAL_FETCH_DONE;
-      break;
-    default:
-      sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_FETCH);
-      fetch_result = SQLDBAL_FETCH_ERROR;
-      break;
-  }
-
-  return fetch_result;
-}
-
-/**
- * Get the column result as blob/binary data.
+ * Append an integer in decimal text to @ref sqldbal_bulk::buf.
  *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @param[out] blob    Binary data.
- * @param[out] blobsz  Number of bytes in @p blob.
+ * @param[in] bulk See @ref sqldbal_bulk.
+ * @param[in] i64  Integer to append.
  */
 static void
-sqldbal_mariadb_stmt_column_blob(struct sqldbal_stmt *const stmt,
-                                 size_t col_idx,
-                                 const void **blob,
-                                 size_t *blobsz){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-
-  mariadb_stmt = stmt->handle;
+sqldbal_bulk_append_int64(struct sqldbal_bulk *const bulk,
+                          int64_t i64){
+  char i64_str[MAX_I64_STR_SZ];
+  int slen;
 
-  if(mariadb_stmt->bind_in_null_list[col_idx]){
-    *blob   = NULL;
-    *blobsz = 0;
+  slen = sprintf(i64_str, "%" PRIi64, i64);
+  if(slen < 0){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_BIND);
   }
   else{
-    *blob   = mariadb_stmt->bind_in_list[col_idx].buffer;
-    *blobsz = mariadb_stmt->bind_in_length_list[col_idx];
+    sqldbal_bulk_append(bulk, i64_str, (size_t)slen);
   }
 }
+#endif /* SQLDBAL_MARIADB || SQLDBAL_POSTGRESQL */
 
+#ifdef SQLDBAL_MARIADB
+
+#include <mysql.h>
+
+#if MYSQL_VERSION_ID >= 50600
 /**
- * Get the column result as a 64-bit integer.
- *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @param[out] i64     64-bit integer.
+ * MariaDB did not add the MYSQL_OPT_SSL_* options until version 5.6.
  */
-static void
-sqldbal_mariadb_stmt_column_int64(struct sqldbal_stmt *const stmt,
-                                  size_t col_idx,
-                                  int64_t *i64){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  const char *buf;
+# define SQLDBAL_MARIADB_HAS_SSL
+#endif /* MYSQL_VERSION_ID >= 50600 */
 
-  mariadb_stmt = stmt->handle;
+#if defined(MARIADB_PACKAGE_VERSION_ID) && \
+    MARIADB_PACKAGE_VERSION_ID >= 30000
+/**
+ * MariaDB Connector/C added array binding (STMT_ATTR_ARRAY_SIZE) in
+ * version 3.0.
+ */
+# define SQLDBAL_MARIADB_HAS_BULK
 
-  if(mariadb_stmt->bind_in_null_list[col_idx]){
-    *i64 = 0;
-  }
-  else{
-    buf = mariadb_stmt->bind_in_list[col_idx].buffer;
-    sqldbal_strtoi64(stmt->db, buf, i64);
-  }
-}
+/**
+ * Earliest MariaDB server version that supports array binding.
+ */
+# define SQLDBAL_MARIADB_BULK_SERVER_VERSION 100206
+#endif /* MARIADB_PACKAGE_VERSION_ID >= 30000 */
 
+#ifdef MYSQL_WAIT_READ
 /**
- * Get the column result as a string.
- *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @param[out] text    Null-terminated string.
- * @param[out] textsz  Number of bytes in @p text.
+ * MariaDB Connector/C provides the non-blocking client API
+ * (mysql_*_start and mysql_*_cont).
  */
-static void
-sqldbal_mariadb_stmt_column_text(struct sqldbal_stmt *const stmt,
-                                 size_t col_idx,
-                                 const char **text,
-                                 size_t *textsz){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
+# define SQLDBAL_MARIADB_HAS_NONBLOCK
+#endif /* MYSQL_WAIT_READ */
 
-  mariadb_stmt = stmt->handle;
+/**
+ * Highest port number available.
+ */
+#define SQLDBAL_MAX_PORT_NUMBER 65535
 
-  if(mariadb_stmt->bind_in_null_list[col_idx]){
-    *text   = NULL;
-    *textsz = 0;
-  }
-  else{
-    *text   = mariadb_stmt->bind_in_list[col_idx].buffer;
-    *textsz = mariadb_stmt->bind_in_length_list[col_idx] - 1;
-  }
-}
+/**
+ * Maximum number of seconds allowed in the CONNECT_TIMEOUT option.
+ */
+#define SQLDBAL_MARIADB_MAX_CONNECT_TIMEOUT 1000
 
 /**
- * Get the column data type.
+ * Largest initial size of each non-integer column buffer in a statement
+ * result.
  *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @return See @ref sqldbal_column_type.
+ * Columns that do not fit get read again into a larger buffer with
+ * mysql_stmt_fetch_column.
  */
-static enum sqldbal_column_type
-sqldbal_mariadb_stmt_column_type(struct sqldbal_stmt *const stmt,
-                                 size_t col_idx){
-  enum sqldbal_column_type type;
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-
-  mariadb_stmt = stmt->handle;
-  if(mariadb_stmt->bind_in_null_list[col_idx]){
-    type = SQLDBAL_TYPE_NULL;
-  }
-  else{
-    type = SQLDBAL_TYPE_BLOB;
-  }
-  return type;
-}
+#define SQLDBAL_MARIADB_FETCH_BUF_SZ 256
 
 /**
- * Free a prepared statement resource.
+ * Storage owned by a MariaDB statement for one placeholder.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
+ * The buffers get reused by later binds so that rebinding a statement does
+ * not allocate memory once the values stop growing.
  */
-static void
-sqldbal_mariadb_stmt_close(struct sqldbal_stmt *const stmt){
-  struct sqldbal_mariadb_stmt *mariadb_stmt;
-  MYSQL_BIND *bind_col;
-  size_t i;
-
-  mariadb_stmt = stmt->handle;
+struct sqldbal_mariadb_param{
+  /**
+   * Copy of the bound blob or text value.
+   */
+  void *buf;
 
-  if(mariadb_stmt){
-    for(i = 0; i < stmt->num_params; i++){
-      bind_col = &mariadb_stmt->bind_out[i];
-      sqldbal_mariadb_stmt_bind_free_buf(bind_col);
-    }
-
-    free(mariadb_stmt->bind_out);
-
-    if(mariadb_stmt->bind_in_list){
-      for(i = 0; i < stmt->num_cols_result; i++){
-        free(mariadb_stmt->bind_in_list[i].buffer);
-      }
-      free(mariadb_stmt->bind_in_list);
-    }
-    free(mariadb_stmt->bind_in_length_list);
-    free(mariadb_stmt->bind_in_null_list);
-
-    /* https://mariadb.com/kb/en/mysql_stmt_close */
-    if(mariadb_stmt->stmt){
-      mysql_stmt_close(mariadb_stmt->stmt);
-    }
-    free(mariadb_stmt);
-  }
-}
-
-#endif /* SQLDBAL_MARIADB */
-
-#ifdef SQLDBAL_POSTGRESQL
+  /**
+   * Number of bytes allocated in @ref buf.
+   */
+  size_t buf_sz;
 
-#include <libpq-fe.h>
-#include <pg_config.h>
+  /**
+   * Bound integer value.
+   */
+  long long ll;
 
-/**
- * Maximum buffer size for 64-bit signed integer.
- *
- * Minimum 64-bit integer:
- * -9223372036854775808
- * 123456789012345678901
- *         10        20 -> 21 bytes
- */
-#define MAX_I64_STR_SZ 21
+  /**
+   * Bound floating point value.
+   */
+  double d;
 
-#if PG_VERSION_NUM >= 90600
-/**
- * PostgreSQL did not add the PQsetErrorContextVisibility function until
- * version 9.6.
- */
-# define SQLDBAL_PQ_HAS_ERROR_CONTEXT_VISIBILITY
-#endif /* PG_VERSION_NUM >= 90600 */
+  /**
+   * Bound timestamp value.
+   */
+  MYSQL_TIME tm;
+};
 
 /**
- * Oid to data type mapping table.
- *
- * Each data type in PostgreSQL has a unique integer (oid). We need to
- * query the server to get these values.
+ * Per-column state for a MariaDB statement result.
  */
-struct sqldbal_pq_oid_typname{
+struct sqldbal_mariadb_column{
   /**
-   * Unique data type id number.
+   * Buffer used to convert numeric and timestamp columns to strings.
    */
-  Oid oid;
+  char conv_str[SQLDBAL_CONV_STR_SZ];
 
   /**
-   * Data type.
-   *
-   * The returned typname will get cut off if larger than this buffer.
-   * This value gets used internally and we only need to check a few
-   * typnames.
+   * Column data type reported by @ref sqldbal_stmt_column_type.
    */
-  char typname[48];
+  enum sqldbal_column_type type;
 };
 
 /**
- * Driver-specific database handle for PostgreSQL.
+ * Non-blocking call in progress for a statement started by
+ * @ref sqldbal_mariadb_stmt_execute_start.
  */
-struct sqldbal_pq_db{
-  /**
-   * PostgreSQL database connection object.
-   */
-  PGconn *db;
-
+enum sqldbal_mariadb_async{
   /**
-   * Increments when a new SQL statement gets prepared.
+   * No call in progress.
    */
-  unsigned long stmt_counter;
+  SQLDBAL_MARIADB_ASYNC_NONE,
 
   /**
-   * Map oid values to data types.
+   * Waiting on mysql_stmt_execute_cont().
    */
-  struct sqldbal_pq_oid_typname *oid_typname_list;
+  SQLDBAL_MARIADB_ASYNC_EXECUTE,
 
   /**
-   * Number of elements in @ref oid_typname_list.
+   * Waiting on mysql_stmt_store_result_cont().
    */
-  size_t num_oid_typnames;
+  SQLDBAL_MARIADB_ASYNC_STORE_RESULT
 };
 
 /**
- * Driver-specific compiled statement handle for PostgreSQL.
+ * Driver-specific compiled statement handle for MariaDB.
  */
-struct sqldbal_pq_stmt{
+struct sqldbal_mariadb_stmt{
   /**
-   * Unique statement name in the current session.
+   * MariaDB statement handle.
    */
-  char *name;
+  MYSQL_STMT *stmt;
 
   /**
-   * Parameter values to send with the query.
+   * Parameters to bind for outgoing statement.
    */
-  char **param_value_list;
+  MYSQL_BIND *bind_out;
 
   /**
-   * Length of binary data in @ref param_value_list.
+   * Storage for the corresponding entry in @ref bind_out.
    */
-  int *param_length_list;
+  struct sqldbal_mariadb_param *param_list;
 
   /**
-   * Indicates if the corresponding parameter in @ref param_value_list has
-   * a text (0) or binary (1) format.
+   * Store the fetched row into this bind list.
    */
-  int *param_format_list;
+  MYSQL_BIND *bind_in_list;
+
+  /**
+   * Length of stored result for corresponding entry in @ref bind_in_list.
+   */
+  unsigned long *bind_in_length_list;
 
   /**
-   * Stores the column values in the prepared statement results.
+   * Null value flag for corresponding entry in @ref bind_in_list.
    */
-  char **column_value_list;
+  char *bind_in_null_list;
 
   /**
-   * Store the result of the prepared statement.
+   * Column state for corresponding entry in @ref bind_in_list.
    */
-  PGresult *exec_result;
+  struct sqldbal_mariadb_column *bind_in_column_list;
 
   /**
-   * Number of rows returned in @ref exec_result.
+   * See @ref sqldbal_mariadb_async.
    */
-  int exec_row_count;
+  enum sqldbal_mariadb_async async;
 
   /**
-   * Current row to fetch from @ref exec_result.
+   * Events returned by the last mysql_*_start or mysql_*_cont call.
    */
-  int fetch_row_index;
-};
+  int async_status;
 
-/**
- * Attributes for columns returned in @ref sqldbal_pq_exec.
- */
-struct sqldbal_pq_col_attribute{
   /**
-   * Indicates if memory allocated by library.
+   * Set to 1 if the client holds the full result set of the last
+   * execution, which allows @ref sqldbal_mariadb_stmt_seek.
    */
-  int mem_allocated;
+  int stored_result;
+
+  /**
+   * Set to 1 after @ref sqldbal_mariadb_stmt_send_blob bound the
+   * placeholders and sent chunks to the server for the next execution.
+   */
+  int long_data;
 };
 
 /**
@@ -1865,633 +3236,589 @@ struct sqldbal_pq_col_attribute{
  * generated by the database function.
  *
  * @param[in] db          See @ref sqldbal_db.
+ * @param[in] mysql_db    MariaDB database handle.
  * @param[in] status_code See @ref sqldbal_status_code.
  */
 static void
-sqldbal_pq_error(struct sqldbal_db *const db,
-                 enum sqldbal_status_code status_code){
+sqldbal_mariadb_error(struct sqldbal_db *const db,
+                      MYSQL *const mysql_db,
+                      enum sqldbal_status_code status_code){
   const char *error;
-  struct sqldbal_pq_db *pq_db;
 
-  pq_db = db->handle;
-  error = PQerrorMessage(pq_db->db);
+  /* https://mariadb.com/kb/en/library/mysql_error */
+  error = mysql_error(mysql_db);
   sqldbal_err_set(db, status_code, error);
 }
 
 /**
- * Copy a string and get the pointer to the end of the copied buffer.
- *
- * This function behaves similar to POSIX stpcpy(), useful for
- * concatenating multiple strings onto a buffer. It always adds a
- * null-terminated byte at the end of the string.
+ * Convenience function that sets the status code and the error string
+ * generated by the statement.
  *
- * @param[in] s1 Destination buffer.
- * @param[in] s2 Null-terminated source string to copy to @p s1.
- * @return Pointer to location in @p s1 after the last copied byte.
+ * @param[in] stmt        See @ref sqldbal_stmt.
+ * @param[in] status_code See @ref sqldbal_status_code.
  */
-SQLDBAL_LINKAGE char *
-sqldbal_stpcpy(char *s1,
-               const char *s2){
-  size_t i;
+static void
+sqldbal_mariadb_stmt_error(const struct sqldbal_stmt *const stmt,
+                           enum sqldbal_status_code status_code){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  const char *stmt_error;
 
-  i = 0;
-  do{
-    s1[i] = s2[i];
-  } while(s2[i++] != '\0');
-  return &s1[i-1];
+  mariadb_stmt = stmt->handle;
+
+  /* https://mariadb.com/kb/en/mysql_stmt_error */
+  stmt_error = mysql_stmt_error(mariadb_stmt->stmt);
+  sqldbal_err_set(stmt->db, status_code, stmt_error);
 }
 
 /**
- * Generate a unique statement name for use by PostgreSQL and store
- * it in @ref sqldbal_pq_stmt::name.
+ * Wrapper for the mysql_options function.
  *
- * @param[in] db      See @ref sqldbal_db.
- * @param[in] pq_stmt See @ref sqldbal_pq_stmt.
- * @return See @ref sqldbal_status_code.
+ * @param[in] db     See @ref sqldbal_db.
+ * @param[in] option One of the available options in MariaDB.
+ * @param[in] arg    Option value.
  */
-static enum sqldbal_status_code
-sqldbal_pq_gen_stmt_name(struct sqldbal_db *const db,
-                         struct sqldbal_pq_stmt *const pq_stmt){
-  const char *const prefix_str = "pqs";
-  struct sqldbal_pq_db *pq_db;
-  size_t namesz;
-  size_t int_count;
-  size_t i;
-  int name_len;
+static void
+sqldbal_mariadb_mysql_options(struct sqldbal_db *const db,
+                              enum mysql_option option,
+                              const void *arg){
+  MYSQL *mysql;
 
-  pq_db = db->handle;
+  mysql = db->handle;
 
-  /*
-   * Get the number of characters in the counter.
-   * For example, the longest 64-bit unsigned number:
-   * 18446744073709551615
-   * 12345678901234567890
-   *         10        20
-   * This means int_count has a maximum of 20 digits.
-   */
-  int_count = 1;
-  for(i = pq_db->stmt_counter; i >= 10; i /= 10){
-    int_count += 1;
+  /* https://mariadb.com/kb/en/mysql_options */
+  if(mysql_options(mysql, option, arg) != 0){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
   }
+}
 
-  /*
-   * Does not wrap.
-   * 3 + [1-20] + 1
-   */
-  namesz = strlen(prefix_str) + int_count + 1;
-  pq_stmt->name = malloc(namesz);
-  if(pq_stmt->name == NULL){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-  }
-  else{
-    name_len = sprintf(pq_stmt->name,
-                       "%s%lu",
-                       prefix_str,
-                       pq_db->stmt_counter);
-    if(name_len < 0){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+/**
+ * Handle driver-specific options for MariaDB.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] num_options Number of entries in @p opt_list.
+ * @param[in] opt_list    See @ref sqldbal_driver_option.
+ * @return sqldbal_status_code.
+ */
+static enum sqldbal_status_code
+sqldbal_mariadb_set_options(struct sqldbal_db *const db,
+                            size_t num_options,
+                            const struct sqldbal_driver_option *const opt_list){
+  size_t i;
+  const struct sqldbal_driver_option *option;
+  unsigned int timeout;
+
+  for(i = 0; i < num_options; i++){
+    option = &opt_list[i];
+    if(strcmp(option->key, "CONNECT_TIMEOUT") == 0){
+      if(sqldbal_strtoui(db,
+                         option->value,
+                         SQLDBAL_MARIADB_MAX_CONNECT_TIMEOUT,
+                         &timeout) == SQLDBAL_STATUS_OK){
+        sqldbal_mariadb_mysql_options(db,
+                                      MYSQL_OPT_CONNECT_TIMEOUT,
+                                      (void*)&timeout);
+      }
     }
+#ifdef SQLDBAL_MARIADB_HAS_SSL
+    else if(strcmp(option->key, "TLS_KEY") == 0){
+      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_KEY, option->value);
+    }
+    else if(strcmp(option->key, "TLS_CERT") == 0){
+      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CERT, option->value);
+    }
+    else if(strcmp(option->key, "TLS_CA") == 0){
+      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CA, option->value);
+    }
+    else if(strcmp(option->key, "TLS_CAPATH") == 0){
+      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CAPATH, option->value);
+    }
+    else if(strcmp(option->key, "TLS_CIPHER") == 0){
+      sqldbal_mariadb_mysql_options(db, MYSQL_OPT_SSL_CIPHER, option->value);
+    }
+#endif /* SQLDBAL_MARIADB_HAS_SSL */
     else{
-      pq_db->stmt_counter += 1;
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
     }
   }
 
+  if(db->flags & SQLDBAL_FLAG_MARIADB_NONBLOCK){
+#ifdef SQLDBAL_MARIADB_HAS_NONBLOCK
+    /* Use the default stack size. */
+    sqldbal_mariadb_mysql_options(db, MYSQL_OPT_NONBLOCK, NULL);
+#else /* !(SQLDBAL_MARIADB_HAS_NONBLOCK) */
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+#endif /* SQLDBAL_MARIADB_HAS_NONBLOCK */
+  }
+
   return sqldbal_status_code_get(db);
 }
 
 /**
- * Get the length of key=value string to add to the conninfo parameter.
- *
- * The following shows an example key=value pair inside the quotes.
- * " key=value"
- *
- * Each key=value sequence gets preceded by a space.
- * See @ref sqldbal_pq_append_conninfo_param.
+ * Create the MariaDB connection handle and apply the connection options
+ * before connecting.
  *
- * @param[in]  key   Parameter key.
- * @param[in]  value Parameter value, NULL if this parameter does not exist.
- * @param[out] len   String length of key=value pair.
- * @retval 0 Length calculation did not wrap.
- * @retval 1 Length calculation wrapped.
+ * @param[in]  db          See @ref sqldbal_db.
+ * @param[in]  port        Server port number to connect to.
+ * @param[in]  option_list See @ref sqldbal_driver_option.
+ * @param[in]  num_options Number of entries in @p option_list.
+ * @param[out] port_i      Port number converted to an integer.
+ * @retval MYSQL* Connection handle ready to connect.
+ * @retval NULL   Failed to create the handle or to apply the options.
  */
-static int
-sqldbal_pq_conninfo_param_len(const char *const key,
-                              const char *const value,
-                              size_t *const len){
-  size_t key_len;
-  size_t value_len;
+static MYSQL *
+sqldbal_mariadb_init(struct sqldbal_db *const db,
+                     const char *const port,
+                     const struct sqldbal_driver_option *const option_list,
+                     size_t num_options,
+                     unsigned int *const port_i){
+  MYSQL *mysql_db;
 
-  *len = 0;
-  if(value){
-    key_len = strlen(key);
-    value_len = strlen(value);
-    /*
-     *        SPACE     key     =     value
-     * len +=   1   + key_len + 1 + value_len;
-     */
-    if(si_add_size_t(key_len, value_len, len) ||
-       si_add_size_t(*len, 2, len)){
-      return 1;
-    }
+  mysql_db = NULL;
+  if(sqldbal_strtoui(db,
+                     port,
+                     SQLDBAL_MAX_PORT_NUMBER,
+                     port_i) != SQLDBAL_STATUS_OK){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
   }
-  return 0;
-}
+  else{
+    if(db->flags & SQLDBAL_FLAG_DEBUG){
+      /* https://mariadb.com/kb/en/mysql_debug */
+      mysql_debug("d");
+    }
 
-/**
- * Append a conninfo paramater if the value exists.
- *
- * @param[in] conninfo Pointer to the first unwritten byte in conninfo string.
- * @param[in] key      Paramater key.
- * @param[in] value    Paramater value, NULL if this parameter does not exist.
- * @return Pointer to the next unwritten byte in @p conninfo.
- */
-static char *
-sqldbal_pq_append_conninfo_param(char *const conninfo,
-                                 const char *const key,
-                                 const char *const value){
-  char *cip;
+    /* https://mariadb.com/kb/en/mysql_init */
+    mysql_db = mysql_init(NULL);
+    if(mysql_db == NULL){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      db->handle = mysql_db;
 
-  cip = conninfo;
-  if(value){
-    cip = sqldbal_stpcpy(conninfo, " ");
-    cip = sqldbal_stpcpy(cip, key);
-    cip = sqldbal_stpcpy(cip, "=");
-    cip = sqldbal_stpcpy(cip, value);
+      if(sqldbal_mariadb_set_options(db,
+                                     num_options,
+                                     option_list) != SQLDBAL_STATUS_OK){
+        mysql_db = NULL;
+      }
+    }
   }
-  return cip;
+  return mysql_db;
 }
 
 /**
- * Generate the conninfo parameter to send to libpq when opening a
- * database connection.
+ * Connect to MariaDB server.
  *
  * @param[in] db          See @ref sqldbal_db.
  * @param[in] location    IP address or hostname.
  * @param[in] port        Server port number to connect to.
- * @param[in] username    Username to connect with.
- * @param[in] password    Password corresponding to @p username.
+ * @param[in] username    User name to connect with.
+ * @param[in] password    Optional password for @p username. Set to NULL if
+ *                        user does not have a password.
  * @param[in] database    Optional database to open after connecting to the
  *                        server. Set this to NULL to prevent opening a
  *                        database after initially connecting.
- * @param[in] num_options Number of entries in @p option_list.
  * @param[in] option_list See @ref sqldbal_driver_option.
- * @retval char* The conninfo parameter to use in PQconnectdb().
- *               The caller must free() this memory after use.
- * @retval NULL  Memory allocation failed. This function will also set the
- *               status in @ref sqldbal_db to @ref SQLDBAL_STATUS_NOMEM.
+ * @param[in] num_options Number of entries in @p option_list.
  */
-static char *
-sqldbal_pq_conninfo(struct sqldbal_db *const db,
-                    const char *const location,
-                    const char *const port,
-                    const char *const username,
-                    const char *const password,
-                    const char *const database,
-                    size_t num_options,
-                    const struct sqldbal_driver_option *const option_list){
-  size_t conninfo_sz;
-  size_t inc_sz;
-  char *conninfo;
-  size_t i;
-  const struct sqldbal_driver_option *option;
-  char *cip;
-  struct sqldbal_driver_option param_list[] = {
-    {"host"                     , location}, /* 0  */
-    {"hostaddr"                 , NULL    }, /* 1  */
-    {"port"                     , port    }, /* 2  */
-    {"dbname"                   , database}, /* 3  */
-    {"user"                     , username}, /* 4  */
-    {"password"                 , password}, /* 5  */
-    {"passfile"                 , NULL    }, /* 6  */
-    {"connect_timeout"          , NULL    }, /* 7  */
-    {"client_encoding"          , NULL    }, /* 8  */
-    {"options"                  , NULL    }, /* 9  */
-    {"application_name"         , NULL    }, /* 10 */
-    {"fallback_application_name", NULL    }, /* 11 */
-    {"keepalives"               , NULL    }, /* 12 */
-    {"keepalives_idle"          , NULL    }, /* 13 */
-    {"keepalives_interval"      , NULL    }, /* 14 */
-    {"keepalives_count"         , NULL    }, /* 15 */
-    {"tty"                      , NULL    }, /* 16 */
-    {"replication"              , NULL    }, /* 17 */
-    {"sslmode"                  , NULL    }, /* 18 */
-    {"requiressl"               , NULL    }, /* 19 */
-    {"sslcompression"           , NULL    }, /* 20 */
-    {"sslcert"                  , NULL    }, /* 21 */
-    {"sslkey"                   , NULL    }, /* 22 */
-    {"sslrootcert"              , NULL    }, /* 23 */
-    {"sslcrl"                   , NULL    }, /* 24 */
-    {"requirepeer"              , NULL    }, /* 25 */
-    {"krbsrvname"               , NULL    }, /* 26 */
-    {"gsslib"                   , NULL    }, /* 27 */
-    {"service"                  , NULL    }, /* 28 */
-    {"target_session_attrs"     , NULL    }  /* 29 */
-  };
-  const size_t num_possible_params = sizeof(param_list) / sizeof(param_list[0]);
+static void
+sqldbal_mariadb_open(struct sqldbal_db *const db,
+                     const char *const location,
+                     const char *const port,
+                     const char *const username,
+                     const char *const password,
+                     const char *const database,
+                     const struct sqldbal_driver_option *const option_list,
+                     size_t num_options){
+  MYSQL *mysql_db;
+  unsigned int port_i;
 
-  for(i = 0; i < num_options; i++){
-    option = &option_list[i];
-    if(strcmp(option->key, "CONNECT_TIMEOUT") == 0){
-      param_list[7].value = option->value;
-    }
-    else if(strcmp(option->key, "TLS_MODE") == 0){
-      param_list[18].value = option->value;
-    }
-    else if(strcmp(option->key, "TLS_CERT") == 0){
-      param_list[21].value = option->value;
-    }
-    else if(strcmp(option->key, "TLS_KEY") == 0){
-      param_list[22].value = option->value;
-    }
-    else if(strcmp(option->key, "TLS_CA") == 0){
-      param_list[23].value = option->value;
-    }
-    else{
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  mysql_db = sqldbal_mariadb_init(db,
+                                  port,
+                                  option_list,
+                                  num_options,
+                                  &port_i);
+  if(mysql_db){
+    /* https://mariadb.com/kb/en/mysql_real_connect */
+    if(mysql_real_connect(mysql_db,
+                          location,
+                          username,
+                          password,
+                          database,
+                          port_i,
+                          NULL,
+                          0) == NULL){
+      sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_OPEN);
     }
   }
+}
 
-  conninfo_sz = 0;
-  for(i = 0; i < num_possible_params; i++){
-    if(sqldbal_pq_conninfo_param_len(param_list[i].key,
-                                     param_list[i].value,
-                                     &inc_sz) ||
-       si_add_size_t(conninfo_sz, inc_sz, &conninfo_sz)){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-    }
+#ifdef SQLDBAL_MARIADB_HAS_NONBLOCK
+/**
+ * Convert the events returned by a mysql_*_start or mysql_*_cont call to
+ * a set of @ref sqldbal_wait_event.
+ *
+ * @param[in] async_status MYSQL_WAIT_* events.
+ * @return Set of @ref sqldbal_wait_event.
+ */
+static int
+sqldbal_mariadb_wait_events(int async_status){
+  int wait_events;
+
+  wait_events = 0;
+  if(async_status & MYSQL_WAIT_WRITE){
+    wait_events |= SQLDBAL_WAIT_WRITE;
   }
-  if(si_add_size_t(conninfo_sz, 1, &conninfo_sz)){ /* null-terminator */
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  /*
+   * The library does not set any read timeouts on the connection, so a
+   * timeout always comes together with a read.
+   */
+  if(async_status & ~MYSQL_WAIT_WRITE){
+    wait_events |= SQLDBAL_WAIT_READ;
   }
+  return wait_events;
+}
 
-  if(sqldbal_status_code_get(db) != SQLDBAL_STATUS_OK){
-    conninfo = NULL;
+/**
+ * Handle the result from mysql_real_connect_start or
+ * mysql_real_connect_cont.
+ *
+ * @param[in]  db           See @ref sqldbal_db.
+ * @param[in]  async_status Events returned by the call, or 0 if the
+ *                          connection has completed.
+ * @param[in]  ret          Return value of the completed call.
+ * @param[out] wait_events  See @ref sqldbal_wait_event.
+ */
+static void
+sqldbal_mariadb_connect_next(struct sqldbal_db *const db,
+                             int async_status,
+                             const MYSQL *const ret,
+                             int *const wait_events){
+  *wait_events = 0;
+  if(async_status){
+    *wait_events = sqldbal_mariadb_wait_events(async_status);
   }
-  else{
-    conninfo = malloc(conninfo_sz);
-    if(conninfo == NULL){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-    }
-    else{
-      conninfo[0] = '\0';
-
-      cip = conninfo;
-      for(i = 0; i < num_possible_params; i++){
-        cip = sqldbal_pq_append_conninfo_param(cip,
-                                               param_list[i].key,
-                                               param_list[i].value);
-      }
-    }
+  else if(ret == NULL){
+    sqldbal_mariadb_error(db, db->handle, SQLDBAL_STATUS_OPEN);
   }
-
-  return conninfo;
 }
 
 /**
- * Query the database to get the Oid values and corresponding typname.
+ * Start connecting to the MariaDB server using the non-blocking client
+ * API.
  *
- * PostgreSQL has the PQftype function to get the column type of a PGresult.
- * However, we need to query the pg_type table to get the mapping of types.
+ * This enables MYSQL_OPT_NONBLOCK on the connection even without
+ * @ref SQLDBAL_FLAG_MARIADB_NONBLOCK. The blocking functions continue to
+ * work.
  *
- * @param[in] db    See @ref sqldbal_db.
- * @param[in] pq_db See @ref sqldbal_pq_db.
- * @return See @ref sqldbal_status_code.
+ * @param[in]  db          See @ref sqldbal_db.
+ * @param[in]  location    See @ref sqldbal_mariadb_open.
+ * @param[in]  port        See @ref sqldbal_mariadb_open.
+ * @param[in]  username    See @ref sqldbal_mariadb_open.
+ * @param[in]  password    See @ref sqldbal_mariadb_open.
+ * @param[in]  database    See @ref sqldbal_mariadb_open.
+ * @param[in]  option_list See @ref sqldbal_mariadb_open.
+ * @param[in]  num_options See @ref sqldbal_mariadb_open.
+ * @param[out] wait_events See @ref sqldbal_wait_event.
  */
-static enum sqldbal_status_code
-sqldbal_pq_query_oid_list(struct sqldbal_db *const db,
-                          struct sqldbal_pq_db *const pq_db){
-  PGresult *result_list;
-  int nrows;
-  size_t nrows_size_t;
-  size_t size;
-  int i;
-  struct sqldbal_pq_oid_typname *oid_typname;
-  const char *oid_str;
-  Oid oid_conv;
-  enum sqldbal_status_code status_code;
-
-  const char *const sql =
-  "SELECT oid, typname FROM pg_type ORDER BY oid ASC";
-
-  status_code = SQLDBAL_STATUS_OK;
-  result_list = PQexec(pq_db->db, sql);
-  if(PQresultStatus(result_list) != PGRES_TUPLES_OK){
-    status_code = SQLDBAL_STATUS_EXEC;
+static void
+sqldbal_mariadb_connect_start(struct sqldbal_db *const db,
+                              const char *const location,
+                              const char *const port,
+                              const char *const username,
+                              const char *const password,
+                              const char *const database,
+                              const struct sqldbal_driver_option *option_list,
+                              size_t num_options,
+                              int *const wait_events){
+  MYSQL *mysql_db;
+  MYSQL *ret;
+  unsigned int port_i;
+  int async_status;
+
+  *wait_events = 0;
+  mysql_db = sqldbal_mariadb_init(db,
+                                  port,
+                                  option_list,
+                                  num_options,
+                                  &port_i);
+  if(mysql_db && (db->flags & SQLDBAL_FLAG_MARIADB_NONBLOCK) == 0){
+    /* Use the default stack size. */
+    sqldbal_mariadb_mysql_options(db, MYSQL_OPT_NONBLOCK, NULL);
   }
-  else{
-    nrows = PQntuples(result_list);
-
-    /* Number of rows limited to INT_MAX. */
-    nrows_size_t = (size_t)nrows;
-
-    size = sizeof(*pq_db->oid_typname_list);
-    pq_db->oid_typname_list = sqldbal_reallocarray(NULL, nrows_size_t, size);
-    if(pq_db->oid_typname_list == NULL){
-      status_code = SQLDBAL_STATUS_NOMEM;
-    }
-    else{
-      for(i = 0; i < nrows; i++){
-        oid_typname = &pq_db->oid_typname_list[i];
-
-        oid_str = PQgetvalue(result_list, i, 0);
-
-        if(sqldbal_strtoui(db,
-                           oid_str,
-                           OID_MAX,
-                           &oid_conv) != SQLDBAL_STATUS_OK){
-          status_code = SQLDBAL_STATUS_COLUMN_COERCE;
-          free(pq_db->oid_typname_list);
-          break;
-        }
-        else{
-          oid_typname->oid = oid_conv;
-          oid_typname->typname[0] = '\0';
-          strncat(oid_typname->typname,
-                  PQgetvalue(result_list, i, 1),
-                  sizeof(oid_typname->typname) - 1);
-        }
-      }
-      pq_db->num_oid_typnames = nrows_size_t;
-    }
-    PQclear(result_list);
+  if(mysql_db && sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    ret = NULL;
+    /* https://mariadb.com/kb/en/mysql_real_connect_start */
+    async_status = mysql_real_connect_start(&ret,
+                                            mysql_db,
+                                            location,
+                                            username,
+                                            password,
+                                            database,
+                                            port_i,
+                                            NULL,
+                                            0);
+    sqldbal_mariadb_connect_next(db, async_status, ret, wait_events);
   }
-  return status_code;
 }
 
-#ifdef SQLDBAL_TEST
 /**
- * Get the PostgreSQL database structure, used by test suite.
+ * Continue the connection started by @ref sqldbal_mariadb_connect_start.
  *
- * @param[in] db See @ref sqldbal_db.
- * @return See @ref sqldbal_pq_db.
+ * @param[in]     db          See @ref sqldbal_db.
+ * @param[in,out] wait_events Events the socket became ready for, and then
+ *                            the events to wait for next.
  */
-SQLDBAL_LINKAGE const struct sqldbal_pq_db *
-sqldbal_pq_get_pq_db_handle(const struct sqldbal_db *const db){
-  return db->handle;
+static void
+sqldbal_mariadb_connect_poll(struct sqldbal_db *const db,
+                             int *const wait_events){
+  MYSQL *ret;
+  int ready_status;
+  int async_status;
+
+  ready_status = 0;
+  if(*wait_events & SQLDBAL_WAIT_READ){
+    ready_status |= MYSQL_WAIT_READ;
+  }
+  if(*wait_events & SQLDBAL_WAIT_WRITE){
+    ready_status |= MYSQL_WAIT_WRITE;
+  }
+  ret = NULL;
+  /* https://mariadb.com/kb/en/mysql_real_connect_cont */
+  async_status = mysql_real_connect_cont(&ret, db->handle, ready_status);
+  sqldbal_mariadb_connect_next(db, async_status, ret, wait_events);
 }
-#endif /* SQLDBAL_TEST */
-
+#else /* !(SQLDBAL_MARIADB_HAS_NONBLOCK) */
 /**
- * Check if the oid corresponds to the given data type.
+ * The client library does not provide the non-blocking API, so this
+ * connects before returning.
  *
- * Uses a linear search instead of bsearch because the only oid we
- * care about (bytea) exists close to the beginning of the list.
- *
- * @param[in] pq_db   See @ref sqldbal_pq_db.
- * @param[in] oid     Unique data type id in PostgreSQL.
- * @param[in] typname Name of column data type.
- * @retval 0 The @p oid corresponds to @p typname.
- * @retval 1 The @p oid does not correspond to @p typname, or it does not
- *           exist in the Oid list.
+ * @param[in]  db          See @ref sqldbal_db.
+ * @param[in]  location    See @ref sqldbal_mariadb_open.
+ * @param[in]  port        See @ref sqldbal_mariadb_open.
+ * @param[in]  username    See @ref sqldbal_mariadb_open.
+ * @param[in]  password    See @ref sqldbal_mariadb_open.
+ * @param[in]  database    See @ref sqldbal_mariadb_open.
+ * @param[in]  option_list See @ref sqldbal_mariadb_open.
+ * @param[in]  num_options See @ref sqldbal_mariadb_open.
+ * @param[out] wait_events Always set to 0.
  */
-SQLDBAL_LINKAGE int
-sqldbal_pq_is_oid(const struct sqldbal_pq_db *const pq_db,
-                  Oid oid,
-                  const char *const typname){
-  size_t i;
-
-  for(i = 0; i < pq_db->num_oid_typnames; i++){
-    if(oid == pq_db->oid_typname_list[i].oid){
-      return strcmp(pq_db->oid_typname_list[i].typname, typname);
-    }
-  }
-  return 1;
+static void
+sqldbal_mariadb_connect_start(struct sqldbal_db *const db,
+                              const char *const location,
+                              const char *const port,
+                              const char *const username,
+                              const char *const password,
+                              const char *const database,
+                              const struct sqldbal_driver_option *option_list,
+                              size_t num_options,
+                              int *const wait_events){
+  sqldbal_mariadb_open(db,
+                       location,
+                       port,
+                       username,
+                       password,
+                       database,
+                       option_list,
+                       num_options);
+  *wait_events = 0;
 }
 
 /**
- * Convert hexadecimal string sequence to binary data.
- *
- * The hex string must have a multiple of 2 characters.
+ * Never gets called because @ref sqldbal_mariadb_connect_start always
+ * finishes connecting.
  *
- * @param[in]  hex_str Hexadecimal string to convert to binary.
- * @param[out] binlen  Number of bytes in the returned binary data.
- * @retval char* Pointer to binary data converted from @p hex_str. This
- *               memory must get free'd by the caller.
- * @retval NULL  Error occurred.
+ * @param[in]     db          Unused.
+ * @param[in,out] wait_events Always set to 0.
  */
-SQLDBAL_LINKAGE char *
-sqldbal_str_hex2bin(const char *const hex_str,
-                    size_t *const binlen){
-  char *snew;
-  size_t slen;
-  size_t i;
-  size_t j;
-  unsigned long ulval;
-  char hexbuf[3];
-  char *ep;
-
-  snew = NULL;
-  *binlen = 0;
-
-  slen = strlen(hex_str);
-
-  if(slen % 2 != 1){
-    snew = malloc(slen / 2 + 1);
-    if(snew){
-      snew[0] = '\0';
-      *binlen = slen / 2;
-
-      hexbuf[2] = '\0';
-      for(i = 0, j = 0; hex_str[i]; i += 2, j++){
-        hexbuf[0] = hex_str[i];
-        hexbuf[1] = hex_str[i+1];
-        ulval = strtoul(hexbuf, &ep, 16);
-        if(*ep != 0){
-          free(snew);
-          snew = NULL;
-          *binlen = 0;
-          break;
-        }
-        /* ulval within range of char because hexbuf has only 2 hex chars. */
-        snew[j] = (char)ulval;
-      }
-    }
-  }
-
-  return snew;
+static void
+sqldbal_mariadb_connect_poll(struct sqldbal_db *const db,
+                             int *const wait_events){
+  (void)db;
+  *wait_events = 0;
 }
+#endif /* SQLDBAL_MARIADB_HAS_NONBLOCK */
 
 /**
- * Open database connection to server.
+ * Close the database connection.
  *
- * @param[in] db          See @ref sqldbal_db.
- * @param[in] location    IP address or hostname.
- * @param[in] port        Server port number to connect to.
- * @param[in] username    Username to connect with.
- * @param[in] password    Password corresponding to @p username.
- * @param[in] database    Optional database to open after connecting to the
- *                        server. Set this to NULL to prevent opening a
- *                        database after initially connecting.
- * @param[in] option_list See @ref sqldbal_driver_option.
- * @param[in] num_options Number of entries in @p option_list.
+ * @param[in] db See @ref sqldbal_db.
  */
 static void
-sqldbal_pq_open(struct sqldbal_db *const db,
-                const char *const location,
-                const char *const port,
-                const char *const username,
-                const char *const password,
-                const char *const database,
-                const struct sqldbal_driver_option *const option_list,
-                size_t num_options){
-  struct sqldbal_pq_db *pq_db;
-  char *conninfo;
-  enum sqldbal_status_code status_code;
-
-  pq_db = malloc(sizeof(*pq_db));
-  if(pq_db == NULL){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-  }
-  else{
-    db->handle = NULL;
-    pq_db->stmt_counter = 1;
+sqldbal_mariadb_close(struct sqldbal_db *const db){
+  MYSQL *mysql_db;
 
-    conninfo = sqldbal_pq_conninfo(db,
-                                   location,
-                                   port,
-                                   username,
-                                   password,
-                                   database,
-                                   num_options,
-                                   option_list);
-    if(conninfo == NULL){
-      free(pq_db);
-    }
-    else{
-      pq_db->db = PQconnectdb(conninfo);
-      if(pq_db->db == NULL){
-        sqldbal_status_code_set(db, SQLDBAL_STATUS_OPEN);
-        free(pq_db);
-      }
-      else{
-        if(PQstatus(pq_db->db) != CONNECTION_OK){
-          sqldbal_status_code_set(db, SQLDBAL_STATUS_OPEN);
-          PQfinish(pq_db->db);
-          free(pq_db);
-        }
-        else{
-          if(db->flags & SQLDBAL_FLAG_DEBUG){
-            PQsetErrorVerbosity(pq_db->db, PQERRORS_VERBOSE);
-#ifdef SQLDBAL_PQ_HAS_ERROR_CONTEXT_VISIBILITY
-            PQsetErrorContextVisibility(pq_db->db, PQSHOW_CONTEXT_ALWAYS);
-#endif /* SQLDBAL_PQ_HAS_ERROR_CONTEXT_VISIBILITY */
-            PQtrace(pq_db->db, stderr);
-          }
+  mysql_db = db->handle;
 
-          status_code = sqldbal_pq_query_oid_list(db, pq_db);
-          if(status_code != SQLDBAL_STATUS_OK){
-            PQfinish(pq_db->db);
-            free(pq_db);
-            sqldbal_status_code_set(db, status_code);
-          }
-          else{
-            db->handle = pq_db;
-          }
-        }
-      }
-      free(conninfo);
-    }
-  }
+  /* https://mariadb.com/kb/en/mysql_close */
+  mysql_close(mysql_db);
 }
 
 /**
- * Close database connection.
+ * Get the MariaDB database handle.
  *
  * @param[in] db See @ref sqldbal_db.
+ * @return MYSQL*.
  */
-static void
-sqldbal_pq_close(struct sqldbal_db *const db){
-  struct sqldbal_pq_db *pq_db;
+static void *
+sqldbal_mariadb_db_handle(const struct sqldbal_db *const db){
+  MYSQL *mysql_db;
 
-  pq_db = db->handle;
-  if(pq_db){
-    PQfinish(pq_db->db);
-    free(pq_db->oid_typname_list);
-    free(pq_db);
-  }
+  mysql_db = db->handle;
+  return mysql_db;
 }
 
 /**
- * Get the PostgreSQL database handle.
+ * Get the MariaDB statement handle.
  *
- * @param[in] db See @ref sqldbal_db.
- * @return PGconn*.
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return MYSQL_STMT*.
  */
 static void *
-sqldbal_pq_db_handle(const struct sqldbal_db *const db){
-  struct sqldbal_pq_db *pq_db;
+sqldbal_mariadb_stmt_handle(const struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
 
-  pq_db = db->handle;
-  return pq_db->db;
+  mariadb_stmt = stmt->handle;
+  return mariadb_stmt->stmt;
 }
 
 /**
- * Get the PostgreSQL statement handle.
+ * Maximum number of placeholders in a MariaDB statement, because the
+ * client protocol sends the number of parameters in 2 bytes.
+ */
+#define SQLDBAL_MARIADB_MAX_PARAMS 65535
+
+/**
+ * Get the maximum number of placeholders in a MariaDB statement.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
- * @return char* (statement name).
+ * @param[in] db Unused.
+ * @return       @ref SQLDBAL_MARIADB_MAX_PARAMS.
  */
-static void *
-sqldbal_pq_stmt_handle(const struct sqldbal_stmt *const stmt){
-  struct sqldbal_pq_stmt *pq_stmt;
+static size_t
+sqldbal_mariadb_param_limit(struct sqldbal_db *const db){
+  (void)db;
+  return SQLDBAL_MARIADB_MAX_PARAMS;
+}
 
-  pq_stmt = stmt->handle;
-  return pq_stmt->name;
+/**
+ * Get the socket connected to the MariaDB server.
+ *
+ * @param[in]  db See @ref sqldbal_db.
+ * @param[out] fd Socket descriptor.
+ */
+static void
+sqldbal_mariadb_socket_fd(struct sqldbal_db *const db,
+                          int *const fd){
+  MYSQL *mysql_db;
+
+  mysql_db = db->handle;
+
+  /* https://mariadb.com/kb/en/mysql_get_socket */
+  *fd = (int)mysql_get_socket(mysql_db);
 }
 
 /**
- * Directly execute SQL statement that does not return any data.
+ * Begin MariaDB transaction.
  *
- * @param[in] db  See @ref sqldbal_db.
- * @param[in] sql Database statement to execute.
+ * @param[in] db See @ref sqldbal_db.
  */
 static void
-sqldbal_pq_exec_noresult(struct sqldbal_db *const db,
-                         const char *const sql){
-  struct sqldbal_pq_db *pq_db;
-  PGresult *result;
+sqldbal_mariadb_begin_transaction(struct sqldbal_db *const db){
+  MYSQL *mysql_db;
 
-  pq_db = db->handle;
-  result = PQexec(pq_db->db, sql);
-  if(result == NULL){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-  }
-  else{
-    if(PQresultStatus(result) != PGRES_COMMAND_OK){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
-    }
-    PQclear(result);
+  mysql_db = db->handle;
+
+  /* https://mariadb.com/kb/en/mysql_autocommit */
+  if(mysql_autocommit(mysql_db, 0)){
+    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
   }
 }
 
 /**
- * Begin a PostgreSQL transaction.
+ * Commit a MariaDB transaction.
  *
  * @param[in] db See @ref sqldbal_db.
  */
 static void
-sqldbal_pq_begin_transaction(struct sqldbal_db *const db){
-  sqldbal_pq_exec_noresult(db, "BEGIN");
+sqldbal_mariadb_commit(struct sqldbal_db *const db){
+  MYSQL *mysql_db;
+
+  mysql_db = db->handle;
+
+  /* https://mariadb.com/kb/en/mysql_commit     */
+  /* https://mariadb.com/kb/en/mysql_autocommit */
+  if(mysql_commit(mysql_db) ||
+     mysql_autocommit(mysql_db, 1)){
+    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
+  }
 }
 
 /**
- * Commit a PostgreSQL transaction.
+ * Rollback a MariaDB transaction.
  *
  * @param[in] db See @ref sqldbal_db.
  */
 static void
-sqldbal_pq_commit(struct sqldbal_db *const db){
-  sqldbal_pq_exec_noresult(db, "COMMIT");
+sqldbal_mariadb_rollback(struct sqldbal_db *const db){
+  MYSQL *mysql_db;
+
+  mysql_db = db->handle;
+
+  /* https://mariadb.com/kb/en/mysql_rollback   */
+  /* https://mariadb.com/kb/en/mysql_autocommit */
+  if(mysql_rollback(mysql_db) ||
+     mysql_autocommit(mysql_db, 1)){
+    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
+  }
 }
 
 /**
- * Rollback a PostgreSQL transaction.
+ * MariaDB executes each statement immediately, so a pipeline does not need
+ * any setup.
  *
- * @param[in] db See @ref sqldbal_db.
+ * @param[in] db Unused.
  */
 static void
-sqldbal_pq_rollback(struct sqldbal_db *const db){
-  sqldbal_pq_exec_noresult(db, "ROLLBACK");
+sqldbal_mariadb_pipeline_begin(struct sqldbal_db *const db){
+  (void)db;
+}
+
+/**
+ * Every statement in the pipeline has already completed.
+ *
+ * @param[in] db Unused.
+ */
+static void
+sqldbal_mariadb_pipeline_end(struct sqldbal_db *const db){
+  (void)db;
+}
+
+/**
+ * Convert unsigned long values returned by mysql_fetch_lengths() into
+ * a size_t list while checking for wrapping.
+ *
+ * @param[in]  lengths         List of unsigned long values to convert
+ *                             to size_t.
+ * @param[out] col_length_list Store the converted values in this list.
+ * @param[in]  num_fields      Number of entries in @p lengths.
+ * @retval 0 All length values converted to a size_t.
+ * @retval 1 At least one length value did not fit into a size_t.
+ */
+static int
+sqldbal_mariadb_fetch_lengths_conv_size(const unsigned long *const lengths,
+                                        size_t *const col_length_list,
+                                        unsigned int num_fields){
+  unsigned int i;
+  int rc;
+  size_t size_conv;
+
+  rc = 0;
+  for(i = 0; i < num_fields; i++){
+    if(si_ulong_to_size(lengths[i], &size_conv)){
+      rc = 1;
+      break;
+    }
+    col_length_list[i] = size_conv;
+  }
+  return rc;
 }
 
 /**
@@ -2506,131 +3833,75 @@ sqldbal_pq_rollback(struct sqldbal_db *const db){
  *                      @p callback function.
  */
 static void
-sqldbal_pq_exec(struct sqldbal_db *const db,
-                const char *const sql,
-                sqldbal_exec_callback_fp callback,
-                void *user_data){
-  struct sqldbal_pq_db *pq_db;
-  PGresult *result;
-  ExecStatusType result_status;
-  int pq_nfields;
-  size_t num_cols;
-  int num_rows;
-  int row_i;
-  size_t col_i;
-  int pq_column_number_i;
-  char *col_value;
-  int pq_length;
-  size_t col_length;
-  int mem_allocated;
-  size_t binlen;
-  char **col_result_list;
+sqldbal_mariadb_exec(struct sqldbal_db *const db,
+                     const char *const sql,
+                     sqldbal_exec_callback_fp callback,
+                     void *user_data){
+  MYSQL *mysql_db;
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  unsigned int num_fields;
+  unsigned long *lengths;
   size_t *col_length_list;
-  struct sqldbal_pq_col_attribute *col_attribute_list;
-  Oid data_type_id;
 
-  pq_db = db->handle;
-  result = PQexecParams(pq_db->db, sql, 0, NULL, NULL, NULL, NULL, 0);
-  if(result == NULL){
-    sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+  mysql_db = db->handle;
+
+  /* https://mariadb.com/kb/en/mysql_real_query */
+  if(mysql_real_query(mysql_db, sql, strlen(sql))){
+    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
   }
   else{
-    result_status = PQresultStatus(result);
-    if(result_status == PGRES_COMMAND_OK){
-      /* Insert/update does not have any rows returned to the caller. */
+    if(db->flags & SQLDBAL_FLAG_STREAM_RESULTS){
+      /* https://mariadb.com/kb/en/mysql_use_result */
+      result = mysql_use_result(mysql_db);
     }
-    else if(result_status == PGRES_TUPLES_OK){
+    else{
+      /* https://mariadb.com/kb/en/mysql_store_result */
+      result = mysql_store_result(mysql_db);
+    }
+    if(result){
       if(callback){
-        pq_nfields = PQnfields(result);
-        num_rows = PQntuples(result);
+        /* https://mariadb.com/kb/en/mysql_num_fields */
+        num_fields = mysql_num_fields(result);
 
-        if(si_int_to_size(pq_nfields, &num_cols)){
-          sqldbal_pq_error(db, SQLDBAL_STATUS_NOMEM);
-        }
-        else{
-          col_result_list = sqldbal_reallocarray(NULL,
-                                                 num_cols,
-                                                 sizeof(*col_result_list));
-          col_length_list = sqldbal_reallocarray(NULL,
-                                                 num_cols,
-                                                 sizeof(*col_length_list));
-          col_attribute_list = sqldbal_reallocarray(
-                                 NULL,
-                                 num_cols,
-                                 sizeof(*col_attribute_list));
-          if(col_result_list == NULL ||
-             col_length_list == NULL ||
-             col_attribute_list == NULL){
-            sqldbal_pq_error(db, SQLDBAL_STATUS_NOMEM);
-          }
-          else{
-            for(row_i = 0; row_i < num_rows; row_i++){
-              for(col_i = 0; col_i < num_cols; col_i++){
-                col_attribute_list[col_i].mem_allocated = 0;
-                if(si_size_to_int(col_i, &pq_column_number_i)){
-                  sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-                }
-                else{
-                  pq_length = PQgetlength(result, row_i, pq_column_number_i);
-                  if(si_int_to_size(pq_length, &col_length)){
-                    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-                  }
-                  else{
-                    mem_allocated = 0;
-                    if(PQgetisnull(result, row_i, pq_column_number_i)){
-                      col_value = NULL;
-                    }
-                    else{
-                      col_value = PQgetvalue(result, row_i, pq_column_number_i);
-                      data_type_id = PQftype(result, pq_column_number_i);
-                      if(sqldbal_pq_is_oid(pq_db, data_type_id, "bytea") == 0){
-                        /*
-                         * The bytea type should begin with "\\x", so
-                         * start the conversion at the 3rd character.
-                         */
-                        col_value = sqldbal_str_hex2bin(&col_value[2],
-                                                        &binlen);
-                        if(col_value){
-                          col_length = binlen;
-                          mem_allocated = 1;
-                        }
-                        else{
-                          col_length = 0;
-                          sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-                        }
-                      }
-                    }
-                    col_result_list[col_i] = col_value;
-                    col_length_list[col_i] = col_length;
-                    col_attribute_list[col_i].mem_allocated = mem_allocated;
-                  }
-                }
-              }
-              if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
-                if(callback(user_data,
-                            num_cols,
-                            col_result_list,
-                            col_length_list)){
-                  sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
-                }
-              }
-              for(col_i = 0; col_i < num_cols; col_i++){
-                if(col_attribute_list[col_i].mem_allocated){
-                  free(col_result_list[col_i]);
-                }
+        col_length_list = sqldbal_reallocarray(NULL,
+                                               num_fields,
+                                               sizeof(*col_length_list));
+        if(col_length_list == NULL){
+          sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+        }
+        else{
+          /* https://mariadb.com/kb/en/mysql_fetch_row */
+          while((row = mysql_fetch_row(result)) != NULL){
+            /* https://mariadb.com/kb/en/mysql_fetch_lengths */
+            lengths = mysql_fetch_lengths(result);
+            if(sqldbal_mariadb_fetch_lengths_conv_size(lengths, col_length_list, num_fields)){
+              sqldbal_status_code_set(db, SQLDBAL_STATUS_OVERFLOW);
+            }
+            else{
+              if(callback(user_data,
+                          num_fields,
+                          row,
+                          col_length_list)){
+                sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
+                break;
               }
             }
           }
-          free(col_result_list);
           free(col_length_list);
-          free(col_attribute_list);
+
+          /* Unbuffered results report read errors after the last row. */
+          if(row == NULL && mysql_errno(mysql_db)){
+            sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
+          }
         }
       }
+      /* https://mariadb.com/kb/en/mysql_free_result */
+      mysql_free_result(result);
     }
-    else{
-      sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+    else if(mysql_errno(mysql_db)){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
     }
-    PQclear(result);
   }
 }
 
@@ -2638,1382 +3909,2025 @@ sqldbal_pq_exec(struct sqldbal_db *const db,
  * Get the insert id from the last SQL insert statement.
  *
  * @param[in]  db        See @ref sqldbal_db.
- * @param[in]  name      Sequence name.
+ * @param[in]  name      Unused.
  * @param[out] insert_id Last insert id.
  */
 static void
-sqldbal_pq_last_insert_id(struct sqldbal_db *const db,
-                          const char *const name,
-                          uint64_t *insert_id){
-  const char *const sql = "SELECT currval($1)";
-  struct sqldbal_stmt *stmt;
-  int64_t i64_insert_id;
+sqldbal_mariadb_last_insert_id(struct sqldbal_db *const db,
+                               const char *const name,
+                               uint64_t *insert_id){
+  MYSQL *mysql_db;
+  my_ulonglong ull;
 
-  /*
-   * Static analyzer complains that this unset when calling
-   * @ref si_int64_to_uint64.
-   */
-  i64_insert_id = 0;
+  (void)name;
 
-  sqldbal_stmt_prepare(db, sql, (size_t)-1, &stmt);
-  sqldbal_stmt_bind_text(stmt, 0, name, (size_t)-1);
-  sqldbal_stmt_execute(stmt);
-  sqldbal_stmt_fetch(stmt);
-  sqldbal_stmt_column_int64(stmt, 0, &i64_insert_id);
-  if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
-    if(si_int64_to_uint64(i64_insert_id, insert_id)){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_COLUMN_COERCE);
-    }
+  mysql_db = db->handle;
+
+  /* https://mariadb.com/kb/en/mysql_insert_id */
+  ull = mysql_insert_id(mysql_db);
+  *insert_id = ull;
+}
+
+/**
+ * Check if the connection to the database server still works.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_mariadb_ping(struct sqldbal_db *const db){
+  MYSQL *mysql_db;
+
+  mysql_db = db->handle;
+
+  /* https://mariadb.com/kb/en/mysql_ping */
+  if(mysql_ping(mysql_db) != 0){
+    sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_EXEC);
   }
-  sqldbal_stmt_close(stmt);
 }
 
 /**
- * Preallocate memory used to bind parameters.
+ * Query prepared statement properties (column count, blob size, ...)
+ * and allocate memory resources based on that information.
  *
- * @param[in] db      See @ref sqldbal_db.
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] pq_stmt See @ref sqldbal_pq_stmt.
- * @retval  0 Success.
- * @retval -1 Error occurred.
+ * @param[in] db   See @ref sqldbal_db.
+ * @param[in] stmt See @ref sqldbal_stmt.
  */
-static int
-sqldbal_pq_stmt_allocate_param_list(struct sqldbal_db *const db,
-                                    struct sqldbal_stmt *const stmt,
-                                    struct sqldbal_pq_stmt *const pq_stmt){
-  struct sqldbal_pq_db *pq_db;
-  PGresult *stmt_describe;
-  int pq_nparams;
-  int rc;
+static void
+sqldbal_mariadb_stmt_get_num_cols(struct sqldbal_db *const db,
+                                  struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  MYSQL_RES *metadata;
 
-  rc = 0;
-  pq_db = db->handle;
-  stmt_describe = PQdescribePrepared(pq_db->db, pq_stmt->name);
-  if(PQresultStatus(stmt_describe) != PGRES_COMMAND_OK){
-    rc = -1;
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_PREPARE);
+  mariadb_stmt = stmt->handle;
+
+  /* https://mariadb.com/kb/en/mysql_stmt_result_metadata */
+  metadata = mysql_stmt_result_metadata(mariadb_stmt->stmt);
+  if(metadata == NULL){
+    stmt->num_cols_result = 0;
+    /* https://mariadb.com/kb/en/mysql_stmt_errno */
+    if(mysql_stmt_errno(mariadb_stmt->stmt)){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
   }
   else{
-    pq_nparams = PQnparams(stmt_describe);
-    if(si_int_to_size(pq_nparams, &stmt->num_params)){
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_OVERFLOW);
-    }
-    else{
-      pq_stmt->param_value_list = calloc(stmt->num_params,
-                                         sizeof(*pq_stmt->param_value_list));
-      pq_stmt->param_length_list = sqldbal_reallocarray(NULL,
-                                                        stmt->num_params,
-                                          sizeof(*pq_stmt->param_length_list));
-      pq_stmt->param_format_list = sqldbal_reallocarray(
-                                     NULL,
-                                     stmt->num_params,
-                                     sizeof(*pq_stmt->param_format_list));
-      if(pq_stmt->param_value_list == NULL  ||
-         pq_stmt->param_length_list == NULL ||
-         pq_stmt->param_format_list == NULL){
-        rc = -1;
-        sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-        free(pq_stmt->param_value_list);
-        free(pq_stmt->param_length_list);
-        free(pq_stmt->param_format_list);
-      }
-    }
+    /* https://mariadb.com/kb/en/mysql_num_fields */
+    stmt->num_cols_result = mysql_num_fields(metadata);
+
+    /* https://mariadb.com/kb/en/mysql_free_result */
+    mysql_free_result(metadata);
   }
-  PQclear(stmt_describe);
-  return rc;
 }
 
 /**
- * Compile statement in PostgreSQL.
+ * Prepare a database statement.
  *
  * @param[in] db      See @ref sqldbal_db.
- * @param[in] sql     SQL statement to compile.
- * @param[in] sql_len Unused.
+ * @param[in] sql     SQL query to prepare.
+ * @param[in] sql_len Length in bytes of @p sql, or -1 if null-terminated.
  * @param[in] stmt    See @ref sqldbal_stmt.
  */
 static void
-sqldbal_pq_stmt_prepare(struct sqldbal_db *const db,
-                        const char *const sql,
-                        size_t sql_len,
-                        struct sqldbal_stmt *stmt){
-  struct sqldbal_pq_db *pq_db;
-  struct sqldbal_pq_stmt *pq_stmt;
-  PGresult *stmt_result;
-
-  (void)sql_len;
+sqldbal_mariadb_stmt_prepare(struct sqldbal_db *const db,
+                             const char *const sql,
+                             size_t sql_len,
+                             struct sqldbal_stmt *const stmt){
+  MYSQL *mysql_db;
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  unsigned long num_bind_out;
 
-  pq_db = db->handle;
+  mysql_db = db->handle;
 
-  pq_stmt = malloc(sizeof(*pq_stmt));
-  if(pq_stmt == NULL){
+  mariadb_stmt = malloc(sizeof(*mariadb_stmt));
+  if(mariadb_stmt == NULL){
     sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
   }
   else{
-    stmt->handle = NULL;
+    stmt->handle = mariadb_stmt;
+    mariadb_stmt->bind_out            = NULL;
+    mariadb_stmt->param_list          = NULL;
+    mariadb_stmt->bind_in_list        = NULL;
+    mariadb_stmt->bind_in_length_list = NULL;
+    mariadb_stmt->bind_in_null_list   = NULL;
+    mariadb_stmt->bind_in_column_list = NULL;
+    mariadb_stmt->async               = SQLDBAL_MARIADB_ASYNC_NONE;
+    mariadb_stmt->async_status        = 0;
+    mariadb_stmt->stored_result       = 0;
+    mariadb_stmt->long_data           = 0;
 
-    pq_stmt->param_value_list  = NULL;
-    pq_stmt->param_length_list = NULL;
-    pq_stmt->param_format_list = NULL;
-    pq_stmt->exec_result       = NULL;
-    pq_stmt->column_value_list = NULL;
+    /* https://mariadb.com/kb/en/mysql_stmt_init */
+    mariadb_stmt->stmt = mysql_stmt_init(mysql_db);
+    if(mariadb_stmt->stmt == NULL){
+      sqldbal_mariadb_error(db, mysql_db, SQLDBAL_STATUS_PREPARE);
+    }
+    else{
+      if(sql_len == SIZE_MAX){
+        sql_len = strlen(sql);
+      }
 
-    if(sqldbal_pq_gen_stmt_name(db, pq_stmt) == SQLDBAL_STATUS_OK){
-      stmt_result = PQprepare(pq_db->db, pq_stmt->name, sql, 0, NULL);
-      if(stmt_result == NULL){
-        sqldbal_pq_error(db, SQLDBAL_STATUS_PREPARE);
-        free(pq_stmt->name);
-        free(pq_stmt);
+      /* https://mariadb.com/kb/en/mysql_stmt_prepare */
+      if(mysql_stmt_prepare(mariadb_stmt->stmt, sql, sql_len) != 0){
+        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_PREPARE);
       }
       else{
-        if(PQresultStatus(stmt_result) != PGRES_COMMAND_OK){
-          sqldbal_status_code_set(db, SQLDBAL_STATUS_PREPARE);
-          sqldbal_errstr_set(db, PQresultErrorMessage(stmt_result));
-          free(pq_stmt->name);
-          free(pq_stmt);
-        }
-        else if(sqldbal_pq_stmt_allocate_param_list(db, stmt, pq_stmt) < 0){
-          free(pq_stmt->name);
-          free(pq_stmt);
+        /* https://mariadb.com/kb/en/mysql_stmt_param_count */
+        num_bind_out = mysql_stmt_param_count(mariadb_stmt->stmt);
+        stmt->num_params = (size_t)num_bind_out;
+        mariadb_stmt->bind_out =
+          sqldbal_reallocarray(NULL,
+                               stmt->num_params,
+                               sizeof(*mariadb_stmt->bind_out));
+        mariadb_stmt->param_list =
+          calloc(stmt->num_params, sizeof(*mariadb_stmt->param_list));
+        if(mariadb_stmt->bind_out == NULL || mariadb_stmt->param_list == NULL){
+          sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+          free(mariadb_stmt->bind_out);
+          free(mariadb_stmt->param_list);
+          mariadb_stmt->bind_out   = NULL;
+          mariadb_stmt->param_list = NULL;
+
+          /* https://mariadb.com/kb/en/mysql_stmt_close */
+          mysql_stmt_close(mariadb_stmt->stmt);
+          mariadb_stmt->stmt = NULL;
         }
         else{
-          stmt->handle = pq_stmt;
+          sqldbal_mariadb_stmt_get_num_cols(db, stmt);
+          memset(mariadb_stmt->bind_out,
+                 0,
+                 stmt->num_params * sizeof(*mariadb_stmt->bind_out));
         }
-        PQclear(stmt_result);
       }
     }
-    else{
-      free(pq_stmt->name);
-      free(pq_stmt);
-    }
   }
 }
 
 /**
- * Assign binary data to a prepared statement placeholder.
+ * Open a read-only cursor when executing the statement so that
+ * @ref sqldbal_mariadb_stmt_fetch reads @p prefetch_rows rows from the
+ * server at a time.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] blob    Binary data saved to BLOB or BYTEA types.
- * @param[in] blobsz  Length of @p blob in bytes.
+ * @param[in] stmt          See @ref sqldbal_stmt.
+ * @param[in] prefetch_rows See @ref sqldbal_stmt_set_cursor.
  */
 static void
-sqldbal_pq_stmt_bind_blob(struct sqldbal_stmt *const stmt,
-                          size_t col_idx,
-                          const void *const blob,
-                          size_t blobsz){
-  char *blob_copy;
-  struct sqldbal_pq_stmt *pq_stmt;
-  int blobsz_i;
+sqldbal_mariadb_stmt_cursor(struct sqldbal_stmt *const stmt,
+                            size_t prefetch_rows){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  unsigned long cursor_type;
+  unsigned long prefetch_ul;
 
-  if(si_size_to_int(blobsz, &blobsz_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  mariadb_stmt = stmt->handle;
+  if(prefetch_rows > ULONG_MAX){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
   }
   else{
-    blob_copy = malloc(blobsz);
-    if(blob_copy == NULL){
-      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+    cursor_type = CURSOR_TYPE_NO_CURSOR;
+    prefetch_ul = 1;
+    if(prefetch_rows){
+      cursor_type = CURSOR_TYPE_READ_ONLY;
+      prefetch_ul = (unsigned long)prefetch_rows;
     }
-    else{
-      pq_stmt = stmt->handle;
-      memcpy(blob_copy, blob, blobsz);
-      if(pq_stmt->param_value_list[col_idx]){
-        free(pq_stmt->param_value_list[col_idx]);
-        pq_stmt->param_value_list[col_idx] = NULL;
-      }
-      pq_stmt->param_value_list [col_idx] = blob_copy;
-      pq_stmt->param_length_list[col_idx] = blobsz_i;
-      pq_stmt->param_format_list[col_idx] = 1;
+    /* https://mariadb.com/kb/en/mysql_stmt_attr_set */
+    if(mysql_stmt_attr_set(mariadb_stmt->stmt,
+                           STMT_ATTR_CURSOR_TYPE,
+                           &cursor_type) ||
+       mysql_stmt_attr_set(mariadb_stmt->stmt,
+                           STMT_ATTR_PREFETCH_ROWS,
+                           &prefetch_ul)){
+      sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_PARAM);
     }
   }
 }
 
 /**
- * Assign a 64-bit integer to a prepared statement placeholder.
+ * Assign a blob or text buffer to a prepared statement placeholder.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] i64     Integer to bind.
+ * When copying, the value goes into the placeholder buffer owned by the
+ * statement, which only grows when a value does not fit.
+ *
+ * @param[in] stmt        See @ref sqldbal_stmt.
+ * @param[in] col_idx     Placeholder index referenced in prepared statement.
+ * @param[in] buffer_type MariaDB data type of @p buf.
+ * @param[in] buf         Value to bind.
+ * @param[in] bufsz       Length of @p buf in bytes.
+ * @param[in] copy        Set to 1 to copy @p buf, or 0 to reference @p buf
+ *                        directly.
  */
 static void
-sqldbal_pq_stmt_bind_int64(struct sqldbal_stmt *const stmt,
-                           size_t col_idx,
-                           int64_t i64){
-  char i64_str[MAX_I64_STR_SZ];
-  int slen;
-  size_t slen_sz;
-  struct sqldbal_pq_stmt *pq_stmt;
+sqldbal_mariadb_stmt_bind_buf(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              enum enum_field_types buffer_type,
+                              const void *const buf,
+                              size_t bufsz,
+                              int copy){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  struct sqldbal_mariadb_param *param;
+  MYSQL_BIND *bind_col;
+  void *bind_buf;
+  size_t alloc_sz;
 
-  pq_stmt = stmt->handle;
+  mariadb_stmt = stmt->handle;
+  param = &mariadb_stmt->param_list[col_idx];
+  bind_col = &mariadb_stmt->bind_out[col_idx];
 
-  slen = sprintf(i64_str, "%" PRIi64, i64);
-  if(slen < 0){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_BIND);
+  /* MYSQL_BIND does not modify the input buffer but lacks a const type. */
+  memcpy(&bind_buf, &buf, sizeof(bind_buf));
+  if(copy){
+    if(param->buf == NULL || bufsz > param->buf_sz){
+      /* realloc can return NULL for 0 bytes, so empty values get 1 byte. */
+      alloc_sz = bufsz ? bufsz : 1;
+      bind_buf = realloc(param->buf, alloc_sz);
+      if(bind_buf){
+        param->buf    = bind_buf;
+        param->buf_sz = alloc_sz;
+      }
+    }
+    else{
+      bind_buf = param->buf;
+    }
+    if(bind_buf && bufsz){
+      memcpy(bind_buf, buf, bufsz);
+    }
+  }
+
+  if(bind_buf == NULL){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
   }
   else{
-    slen_sz = (size_t)slen;
-    slen_sz += 1;
-    i64_str[slen_sz] = '\0';
-    sqldbal_pq_stmt_bind_blob(stmt, col_idx, i64_str, slen_sz);
-    pq_stmt->param_format_list[col_idx] = 0;
+    bind_col->buffer_type   = buffer_type;
+    bind_col->buffer        = bind_buf;
+    bind_col->buffer_length = bufsz;
+    bind_col->length        = &bind_col->buffer_length;
+    bind_col->is_null       = NULL;
+    bind_col->is_unsigned   = 0;
+    bind_col->error         = NULL;
   }
 }
 
 /**
- * Assign a text string to a prepared statement placeholder.
+ * Assign binary data to a prepared statement placeholder.
  *
  * @param[in] stmt    See @ref sqldbal_stmt.
  * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] s       Text string saved to a SQL text type.
- * @param[in] slen    Length of @p s in bytes.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
  */
 static void
-sqldbal_pq_stmt_bind_text(struct sqldbal_stmt *const stmt,
-                          size_t col_idx,
-                          const char *const s,
-                          size_t slen){
-  struct sqldbal_pq_stmt *pq_stmt;
-
-  pq_stmt = stmt->handle;
-  sqldbal_pq_stmt_bind_blob(stmt, col_idx, s, slen);
-  pq_stmt->param_format_list[col_idx] = 0;
+sqldbal_mariadb_stmt_bind_blob(struct sqldbal_stmt *const stmt,
+                               size_t col_idx,
+                               const void *const blob,
+                               size_t blobsz){
+  sqldbal_mariadb_stmt_bind_buf(stmt,
+                                col_idx,
+                                MYSQL_TYPE_BLOB,
+                                blob,
+                                blobsz,
+                                1);
 }
 
 /**
- * Assign a NULL value to a prepared statement placeholder.
+ * Reference binary data from a prepared statement placeholder without
+ * copying it.
  *
  * @param[in] stmt    See @ref sqldbal_stmt.
  * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
  */
 static void
-sqldbal_pq_stmt_bind_null(struct sqldbal_stmt *const stmt,
-                          size_t col_idx){
-  struct sqldbal_pq_stmt *pq_stmt;
-
-  pq_stmt = stmt->handle;
-  pq_stmt->param_value_list [col_idx] = NULL;
-  pq_stmt->param_length_list[col_idx] = 0;
-  pq_stmt->param_format_list[col_idx] = 0;
+sqldbal_mariadb_stmt_bind_blob_static(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      const void *const blob,
+                                      size_t blobsz){
+  sqldbal_mariadb_stmt_bind_buf(stmt,
+                                col_idx,
+                                MYSQL_TYPE_BLOB,
+                                blob,
+                                blobsz,
+                                0);
 }
 
 /**
- * Execute a compiled statement with bound parameters.
+ * Assign a 64-bit integer to a prepared statement placeholder.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] i64     Integer to bind.
  */
 static void
-sqldbal_pq_stmt_execute(struct sqldbal_stmt *const stmt){
-  struct sqldbal_pq_db *pq_db;
-  struct sqldbal_pq_stmt *pq_stmt;
-  int pq_num_param_list;
-  const char *const *const_param_value_list;
-  ExecStatusType pq_status;
-  int pq_nfields;
-
-  pq_db = stmt->db->handle;
-  pq_stmt = stmt->handle;
-
-  if(pq_stmt->exec_result){
-    free(pq_stmt->exec_result);
-    pq_stmt->exec_result = NULL;
-  }
-
-  /*
-   * Already compatible with int because of conversion in
-   * @ref sqldbal_pq_stmt_allocate_param_list.
-   */
-  pq_num_param_list = (int)stmt->num_params;
+sqldbal_mariadb_stmt_bind_int64(struct sqldbal_stmt *const stmt,
+                                size_t col_idx,
+                                int64_t i64){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  struct sqldbal_mariadb_param *param;
+  MYSQL_BIND *bind_col;
+  long long ll;
 
-  const_param_value_list = (const char *const *)pq_stmt->param_value_list;
-  pq_stmt->exec_result = PQexecPrepared(pq_db->db,
-                                        pq_stmt->name,
-                                        pq_num_param_list,
-                                        const_param_value_list,
-                                        pq_stmt->param_length_list,
-                                        pq_stmt->param_format_list,
-                                        0);
-  pq_status = PQresultStatus(pq_stmt->exec_result);
-  if(pq_status != PGRES_COMMAND_OK && pq_status != PGRES_TUPLES_OK){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_EXEC);
-    sqldbal_errstr_set(stmt->db, PQresultErrorMessage(pq_stmt->exec_result));
+  if(si_int64_to_llong(i64, &ll)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
   }
   else{
-    pq_stmt->exec_row_count = PQntuples(pq_stmt->exec_result);
-    pq_nfields = PQnfields(pq_stmt->exec_result);
-    if(si_int_to_size(pq_nfields, &stmt->num_cols_result)){
-      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-    }
-    else if(stmt->num_cols_result){
-      pq_stmt->column_value_list = calloc(stmt->num_cols_result,
-                                          sizeof(*pq_stmt->column_value_list));
-      if(pq_stmt->column_value_list == NULL){
-        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-      }
-    }
+    mariadb_stmt = stmt->handle;
+    param = &mariadb_stmt->param_list[col_idx];
+    bind_col = &mariadb_stmt->bind_out[col_idx];
+    param->ll = ll;
+
+    bind_col->buffer_type   = MYSQL_TYPE_LONGLONG;
+    bind_col->buffer        = &param->ll;
+    bind_col->buffer_length = sizeof(param->ll);
+    bind_col->length        = &bind_col->buffer_length;
+    bind_col->is_null       = NULL;
+    bind_col->is_unsigned   = 0;
+    bind_col->error         = NULL;
   }
-  pq_stmt->fetch_row_index = 0;
 }
 
 /**
- * Free the column values held in the @ref sqldbal_pq_stmt::column_value_list.
- *
- * This does not free the actual list. It will eventually get free'd in
- * @ref sqldbal_pq_stmt_close
+ * Assign a text string to a prepared statement placeholder.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] s       Text string saved to a SQL text type.
+ * @param[in] slen    Length of @p s in bytes.
  */
 static void
-sqldbal_pq_stmt_free_column_values(struct sqldbal_stmt *const stmt){
-  struct sqldbal_pq_stmt *pq_stmt;
-  size_t i;
+sqldbal_mariadb_stmt_bind_text(struct sqldbal_stmt *const stmt,
+                               size_t col_idx,
+                               const char *const s,
+                               size_t slen){
+  sqldbal_mariadb_stmt_bind_buf(stmt,
+                                col_idx,
+                                MYSQL_TYPE_STRING,
+                                s,
+                                slen,
+                                1);
+}
 
-  pq_stmt = stmt->handle;
-  if(pq_stmt->column_value_list){
-    for(i = 0; i < stmt->num_cols_result; i++){
-      free(pq_stmt->column_value_list[i]);
-      pq_stmt->column_value_list[i] = NULL;
-    }
-  }
+/**
+ * Reference a text string from a prepared statement placeholder without
+ * copying it.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] s       Text string saved to a SQL text type.
+ * @param[in] slen    Length of @p s in bytes.
+ */
+static void
+sqldbal_mariadb_stmt_bind_text_static(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      const char *const s,
+                                      size_t slen){
+  sqldbal_mariadb_stmt_bind_buf(stmt,
+                                col_idx,
+                                MYSQL_TYPE_STRING,
+                                s,
+                                slen,
+                                0);
 }
 
 /**
- * Get the next row in the result set.
+ * Assign a double-precision floating point number to a prepared statement
+ * placeholder.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
- * @return See @ref sqldbal_fetch_result.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] d       Floating point number to bind.
  */
-static enum sqldbal_fetch_result
-sqldbal_pq_stmt_fetch(struct sqldbal_stmt *const stmt){
-  enum sqldbal_fetch_result fetch_result;
-  struct sqldbal_pq_stmt *pq_stmt;
+static void
+sqldbal_mariadb_stmt_bind_double(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 double d){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  struct sqldbal_mariadb_param *param;
+  MYSQL_BIND *bind_col;
 
-  sqldbal_pq_stmt_free_column_values(stmt);
+  mariadb_stmt = stmt->handle;
+  param = &mariadb_stmt->param_list[col_idx];
+  bind_col = &mariadb_stmt->bind_out[col_idx];
+  param->d = d;
 
-  pq_stmt = stmt->handle;
-  if(pq_stmt->fetch_row_index >= pq_stmt->exec_row_count){
-    fetch_result = SQLDBAL_FETCH_DONE;
-  }
-  else{
-    pq_stmt->fetch_row_index += 1;
-    fetch_result = SQLDBAL_FETCH_ROW;
-  }
-  return fetch_result;
+  bind_col->buffer_type   = MYSQL_TYPE_DOUBLE;
+  bind_col->buffer        = &param->d;
+  bind_col->buffer_length = sizeof(param->d);
+  bind_col->length        = &bind_col->buffer_length;
+  bind_col->is_null       = NULL;
+  bind_col->is_unsigned   = 0;
+  bind_col->error         = NULL;
 }
 
 /**
- * Get the column result as blob/binary data.
+ * Assign a timestamp to a prepared statement placeholder.
  *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @param[out] blob    Binary data.
- * @param[out] blobsz  Number of bytes in @p blob.
+ * MariaDB DATETIME values do not have a time zone, so the timestamp gets
+ * sent in UTC.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] ts      Microseconds since 1970-01-01 00:00:00 UTC.
  */
 static void
-sqldbal_pq_stmt_column_blob(struct sqldbal_stmt *const stmt,
-                            size_t col_idx,
-                            const void **blob,
-                            size_t *blobsz){
-  struct sqldbal_pq_stmt *pq_stmt;
-  int row_number;
-  int col_no_i;
-  const char *blob_offset;
-  char *hex2bin;
-  int pq_length;
-
-  pq_stmt = stmt->handle;
-  row_number = pq_stmt->fetch_row_index - 1;
+sqldbal_mariadb_stmt_bind_timestamp(struct sqldbal_stmt *const stmt,
+                                    size_t col_idx,
+                                    int64_t ts){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  struct sqldbal_mariadb_param *param;
+  MYSQL_BIND *bind_col;
+  struct sqldbal_tm tm;
 
-  if(si_size_to_int(col_idx, &col_no_i)){
+  sqldbal_timestamp_to_tm(ts, &tm);
+  if(tm.year < 0 || tm.year > 9999){
     sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
-    *blob = NULL;
   }
   else{
-    *blob = PQgetvalue(pq_stmt->exec_result,
-                       row_number,
-                       col_no_i);
-    pq_length = PQgetlength(pq_stmt->exec_result,
-                            row_number,
-                            col_no_i);
-    if(si_int_to_size(pq_length, blobsz)){
-      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
-    }
-    else if(*blobsz == 0 &&
-       PQgetisnull(pq_stmt->exec_result, row_number, col_no_i)){
-      *blob = NULL;
-    }
-    else if(strncmp(*blob, "\\x", 2) == 0){
-      blob_offset = *blob;
-      blob_offset += 2;
+    mariadb_stmt = stmt->handle;
+    param = &mariadb_stmt->param_list[col_idx];
+    bind_col = &mariadb_stmt->bind_out[col_idx];
 
-      hex2bin = sqldbal_str_hex2bin(blob_offset, blobsz);
-      if(hex2bin == NULL){
-        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-      }
-      *blob = hex2bin;
-      pq_stmt->column_value_list[col_idx] = hex2bin;
-    }
+    memset(&param->tm, 0, sizeof(param->tm));
+    param->tm.year        = (unsigned int)tm.year;
+    param->tm.month       = tm.month;
+    param->tm.day         = tm.day;
+    param->tm.hour        = tm.hour;
+    param->tm.minute      = tm.minute;
+    param->tm.second      = tm.second;
+    param->tm.second_part = tm.usec;
+    param->tm.time_type   = MYSQL_TIMESTAMP_DATETIME;
+
+    bind_col->buffer_type   = MYSQL_TYPE_DATETIME;
+    bind_col->buffer        = &param->tm;
+    bind_col->buffer_length = sizeof(param->tm);
+    bind_col->length        = &bind_col->buffer_length;
+    bind_col->is_null       = NULL;
+    bind_col->is_unsigned   = 0;
+    bind_col->error         = NULL;
   }
 }
 
 /**
- * Get the column result as a string.
+ * Assign a NULL value to a prepared statement placeholder.
  *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @param[out] text    Null-terminated string.
- * @param[out] textsz  Number of bytes in @p text.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
  */
 static void
-sqldbal_pq_stmt_column_text(struct sqldbal_stmt *const stmt,
-                            size_t col_idx,
-                            const char **text,
-                            size_t *textsz){
-  const void *blob;
+sqldbal_mariadb_stmt_bind_null(struct sqldbal_stmt *const stmt,
+                               size_t col_idx){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  MYSQL_BIND *bind_col;
 
-  sqldbal_pq_stmt_column_blob(stmt, col_idx, &blob, textsz);
-  *text = blob;
+  mariadb_stmt = stmt->handle;
+  bind_col = &mariadb_stmt->bind_out[col_idx];
+
+  bind_col->buffer_type   = MYSQL_TYPE_NULL;
+  bind_col->buffer        = NULL;
+  bind_col->buffer_length = 0;
+  bind_col->length        = NULL;
+  bind_col->is_null       = NULL;
+  bind_col->is_unsigned   = 0;
+  bind_col->error         = NULL;
 }
 
 /**
- * Get the column data type.
+ * Start a blob placeholder value that gets sent to the server in chunks
+ * with mysql_stmt_send_long_data.
  *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @return See @ref sqldbal_column_type.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
  */
-static enum sqldbal_column_type
-sqldbal_pq_stmt_column_type(struct sqldbal_stmt *const stmt,
-                            size_t col_idx){
-  enum sqldbal_column_type type;
-  struct sqldbal_pq_stmt *pq_stmt;
-  int col_no_i;
-  int row_number;
+static void
+sqldbal_mariadb_stmt_bind_blob_stream(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  MYSQL_BIND *bind_col;
 
-  if(si_size_to_int(col_idx, &col_no_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
-    type = SQLDBAL_TYPE_ERROR;
+  mariadb_stmt = stmt->handle;
+  bind_col = &mariadb_stmt->bind_out[col_idx];
+
+  /* Binding again would discard the chunks already sent. */
+  if(mariadb_stmt->long_data){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
   }
   else{
-    pq_stmt = stmt->handle;
-    row_number = pq_stmt->fetch_row_index - 1;
-    if(PQgetisnull(pq_stmt->exec_result, row_number, col_no_i)){
-      type = SQLDBAL_TYPE_NULL;
-    }
-    else{
-      type = SQLDBAL_TYPE_BLOB;
-    }
+    bind_col->buffer_type   = MYSQL_TYPE_LONG_BLOB;
+    bind_col->buffer        = NULL;
+    bind_col->buffer_length = 0;
+    bind_col->length        = &bind_col->buffer_length;
+    bind_col->is_null       = NULL;
+    bind_col->is_unsigned   = 0;
+    bind_col->error         = NULL;
   }
-  return type;
 }
 
 /**
- * Get the column result as a 64-bit integer.
+ * Send the next chunk of a blob placeholder value directly to the server.
  *
- * @param[in]  stmt    See @ref sqldbal_stmt.
- * @param[in]  col_idx Column index.
- * @param[out] i64     64-bit integer.
+ * The first chunk binds every placeholder, so the other placeholders must
+ * have their values by then.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] chunk   Next bytes of the value.
+ * @param[in] chunksz Number of bytes in @p chunk.
  */
 static void
-sqldbal_pq_stmt_column_int64(struct sqldbal_stmt *const stmt,
-                             size_t col_idx,
-                             int64_t *i64){
-  const char *text;
-  size_t textsz;
-
-  sqldbal_pq_stmt_column_text(stmt, col_idx, &text, &textsz);
+sqldbal_mariadb_stmt_send_blob(struct sqldbal_stmt *const stmt,
+                               size_t col_idx,
+                               const void *const chunk,
+                               size_t chunksz){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  unsigned int param_number;
 
-  if(text){
-    sqldbal_strtoi64(stmt->db, text, i64);
+  mariadb_stmt = stmt->handle;
+  if(mariadb_stmt->bind_out[col_idx].buffer_type != MYSQL_TYPE_LONG_BLOB){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else if(si_size_to_uint(col_idx, &param_number) || chunksz > ULONG_MAX){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
   }
   else{
-    *i64 = 0;
+    /* https://mariadb.com/kb/en/mysql_stmt_bind_param */
+    if(mariadb_stmt->long_data == 0 &&
+       mysql_stmt_bind_param(mariadb_stmt->stmt, mariadb_stmt->bind_out)){
+      sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_BIND);
+    }
+    else{
+      mariadb_stmt->long_data = 1;
+      /* https://mariadb.com/kb/en/mysql_stmt_send_long_data */
+      if(mysql_stmt_send_long_data(mariadb_stmt->stmt,
+                                   param_number,
+                                   chunk,
+                                   (unsigned long)chunksz)){
+        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_BIND);
+      }
+    }
   }
 }
 
 /**
- * Delete a pq prepared statement.
+ * Get the data type reported for a result column.
  *
- * pq does not have an explicit function for closing a prepared statement.
- * Instead, we have to use the DEALLOCATE SQL statement with the name of
- * the prepared statement.
+ * @param[in] field Column metadata.
+ * @return See @ref sqldbal_column_type.
+ */
+static enum sqldbal_column_type
+sqldbal_mariadb_field_type(const MYSQL_FIELD *const field){
+  enum sqldbal_column_type type;
+
+  switch(field->type){
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_YEAR:
+      type = SQLDBAL_TYPE_INT;
+      break;
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+      type = SQLDBAL_TYPE_DOUBLE;
+      break;
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+      type = SQLDBAL_TYPE_TIMESTAMP;
+      break;
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+      /* Character set number 63 means binary data. */
+      if(field->charsetnr == 63){
+        type = SQLDBAL_TYPE_BLOB;
+      }
+      else{
+        type = SQLDBAL_TYPE_TEXT;
+      }
+      break;
+    default:
+      type = SQLDBAL_TYPE_OTHER;
+      break;
+  }
+  return type;
+}
+
+/**
+ * Free the binding variables used when fetching data.
  *
  * @param[in] stmt See @ref sqldbal_stmt.
  */
 static void
-sqldbal_pq_stmt_close(struct sqldbal_stmt *const stmt){
-  const char *const DEALLOCATE_PREFIX_STR = "DEALLOCATE ";
-  /*
-   * Allocate the SQL buffer which must hold the longest statement id.
-   *
-   * For example, the longest 64-bit unsigned number:
-   * 18446744073709551615
-   * 12345678901234567890
-   *         10        20
-   * This means int_count has a maximum of 20 digits.
-   *                11               +        20         +       1
-   *   strlen(DEALLOCATE_PREFIX_STR) + max 64-bit length + null-terminator
-   */
-  char sql[11 + 20 + 1];
-  struct sqldbal_pq_stmt *pq_stmt;
+sqldbal_mariadb_stmt_free_bind_in_list(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
   size_t i;
 
-  pq_stmt = stmt->handle;
-
-  if(pq_stmt){
-    PQclear(pq_stmt->exec_result);
+  mariadb_stmt = stmt->handle;
+  if(mariadb_stmt->bind_in_list){
+    for(i = 0; i < stmt->num_cols_result; i++){
+      free(mariadb_stmt->bind_in_list[i].buffer);
+    }
+    free(mariadb_stmt->bind_in_list);
+    mariadb_stmt->bind_in_list = NULL;
+  }
+  free(mariadb_stmt->bind_in_length_list);
+  free(mariadb_stmt->bind_in_null_list);
+  free(mariadb_stmt->bind_in_column_list);
+  mariadb_stmt->bind_in_length_list = NULL;
+  mariadb_stmt->bind_in_null_list   = NULL;
+  mariadb_stmt->bind_in_column_list = NULL;
+}
 
-    strcpy(sql, DEALLOCATE_PREFIX_STR);
-    strcat(sql, pq_stmt->name);
-    sqldbal_exec(stmt->db, sql, NULL, NULL);
+/**
+ * Allocate memory for binding variables used when fetching data.
+ *
+ * The bind list gets allocated on the first execution and then reused by
+ * later executions of the same statement. Integer, floating point, and
+ * timestamp columns bind directly to their native representation. The
+ * other columns start with a small buffer which grows in
+ * @ref sqldbal_mariadb_stmt_column_load when a value does not fit.
+ *
+ * @param[in] stmt     See @ref sqldbal_stmt.
+ * @param[in] metadata Statement metadata from mysql_stmt_result_metadata().
+ * @return See @ref sqldbal_status_code.
+ */
+static enum sqldbal_status_code
+sqldbal_mariadb_stmt_allocate_bind_in_list(struct sqldbal_stmt *const stmt,
+                                           MYSQL_RES *const metadata){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  size_t i;
+  void *buf;
+  size_t buf_sz;
+  MYSQL_BIND *bind;
+  MYSQL_FIELD *field;
+  struct sqldbal_mariadb_column *column;
+  unsigned int fieldnr;
 
-    if(pq_stmt->param_value_list){
-      for(i = 0; i < stmt->num_params; i++){
-        free(pq_stmt->param_value_list[i]);
-      }
-      free(pq_stmt->param_value_list);
+  mariadb_stmt = stmt->handle;
+  if(mariadb_stmt->bind_in_list == NULL){
+    mariadb_stmt->bind_in_list = calloc(stmt->num_cols_result,
+                                        sizeof(*mariadb_stmt->bind_in_list));
+
+    mariadb_stmt->bind_in_length_list = calloc(
+      stmt->num_cols_result,
+      sizeof(*mariadb_stmt->bind_in_length_list));
+
+    mariadb_stmt->bind_in_null_list = calloc(
+      stmt->num_cols_result,
+      sizeof(*mariadb_stmt->bind_in_null_list));
+
+    mariadb_stmt->bind_in_column_list = calloc(
+      stmt->num_cols_result,
+      sizeof(*mariadb_stmt->bind_in_column_list));
+
+    if(mariadb_stmt->bind_in_list        == NULL ||
+       mariadb_stmt->bind_in_length_list == NULL ||
+       mariadb_stmt->bind_in_null_list   == NULL ||
+       mariadb_stmt->bind_in_column_list == NULL){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
     }
-
-    if(pq_stmt->param_length_list){
-      free(pq_stmt->param_length_list);
+    else{
+      for(i = 0; i < stmt->num_cols_result; i++){
+        if(si_size_to_uint(i, &fieldnr)){
+          sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+          break;
+        }
+        else{
+          bind = &mariadb_stmt->bind_in_list[i];
+          /* https://mariadb.com/kb/en/mysql_fetch_field_direct */
+          field = mysql_fetch_field_direct(metadata, fieldnr);
+          column = &mariadb_stmt->bind_in_column_list[i];
+          column->type = sqldbal_mariadb_field_type(field);
+          if(column->type == SQLDBAL_TYPE_INT){
+            bind->buffer_type = MYSQL_TYPE_LONGLONG;
+            bind->is_unsigned = (field->flags & UNSIGNED_FLAG) != 0;
+            buf_sz = sizeof(long long);
+          }
+          else if(column->type == SQLDBAL_TYPE_DOUBLE){
+            bind->buffer_type = MYSQL_TYPE_DOUBLE;
+            bind->is_unsigned = 0;
+            buf_sz = sizeof(double);
+          }
+          else if(column->type == SQLDBAL_TYPE_TIMESTAMP){
+            bind->buffer_type = MYSQL_TYPE_DATETIME;
+            bind->is_unsigned = 0;
+            buf_sz = sizeof(MYSQL_TIME);
+          }
+          else{
+            bind->buffer_type = MYSQL_TYPE_BLOB;
+            bind->is_unsigned = 0;
+            if(field->length < SQLDBAL_MARIADB_FETCH_BUF_SZ){
+              /* Leave room for the null-terminator. */
+              buf_sz = field->length + 1;
+            }
+            else{
+              buf_sz = SQLDBAL_MARIADB_FETCH_BUF_SZ;
+            }
+          }
+          buf = malloc(buf_sz);
+          if(buf == NULL){
+            sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+            break;
+          }
+          else{
+            bind->buffer        = buf;
+            bind->buffer_length = buf_sz;
+            bind->length        = &mariadb_stmt->bind_in_length_list[i];
+            bind->error         = NULL;
+            bind->is_null       = &mariadb_stmt->bind_in_null_list[i];
+          }
+        }
+      }
     }
-
-    if(pq_stmt->param_format_list){
-      free(pq_stmt->param_format_list);
+    if(sqldbal_status_code_get(stmt->db) != SQLDBAL_STATUS_OK){
+      sqldbal_mariadb_stmt_free_bind_in_list(stmt);
     }
-
-    sqldbal_pq_stmt_free_column_values(stmt);
-
-    free(pq_stmt->column_value_list);
-
-    free(pq_stmt->name);
-
-    free(pq_stmt);
   }
+  return sqldbal_status_code_get(stmt->db);
 }
 
-#endif /* SQLDBAL_POSTGRESQL */
-
-#ifdef SQLDBAL_SQLITE
-
-#include <sqlite3.h>
-
-#if SQLITE_VERSION_NUMBER >= 3014000
 /**
- * SQLite has the sqlite3_trace_v2 api since version 3.14.0.
+ * Bind the result columns after executing a statement that returns rows.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
  */
-# define SQLDBAL_SQLITE_HAS_TRACE_V2
-#endif /* SQLITE_VERSION_NUMBER >= 3014000 */
+static void
+sqldbal_mariadb_stmt_bind_result_list(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  MYSQL_RES *metadata;
 
-/**
- * Maximum number of retries to do when SQLITE_BUSY gets returned.
- */
-#define SQLDBAL_SQLITE_MAX_NUM_RETRIES 10
+  mariadb_stmt = stmt->handle;
+  if(stmt->num_cols_result){
+    /* Reuse the bind list from the previous execution. */
+    if(mariadb_stmt->bind_in_list == NULL){
+      /* https://mariadb.com/kb/en/mysql_stmt_result_metadata */
+      metadata = mysql_stmt_result_metadata(mariadb_stmt->stmt);
+
+      if(metadata){
+        sqldbal_mariadb_stmt_allocate_bind_in_list(stmt, metadata);
+        mysql_free_result(metadata);
+      }
+      else{
+        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_NOMEM);
+      }
+    }
+
+    if(mariadb_stmt->bind_in_list){
+      /* https://mariadb.com/kb/en/mysql_stmt_bind_result */
+      if(mysql_stmt_bind_result(mariadb_stmt->stmt,
+                                mariadb_stmt->bind_in_list)){
+        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
+      }
+    }
+  }
+}
 
 /**
- * This data gets passed to the sqite3_exec function which allows the SQLite
- * callback function to invoke the SQLDBAL callback function.
+ * Pass the bound placeholders to the client library before executing.
+ *
+ * Skipped once @ref sqldbal_mariadb_stmt_send_blob has bound them,
+ * because binding again would drop the chunks sent with
+ * mysql_stmt_send_long_data.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @retval 0 Bound the placeholders.
+ * @retval 1 mysql_stmt_bind_param failed.
  */
-struct sqldbal_sqlite_cb_data{
-  /**
-   * See @ref sqldbal_db.
-   */
-  struct sqldbal_db *db;
-
-  /**
-   * Application callback function which sends rows from a SELECT query.
-   */
-  sqldbal_exec_callback_fp callback;
+static int
+sqldbal_mariadb_stmt_bind_param(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  int rc;
 
-  /**
-   * This gets passed to the application-provided callback function
-   * in @ref callback.
-   */
-  void *user_data;
-};
+  mariadb_stmt = stmt->handle;
+  rc = 0;
+  if(mariadb_stmt->long_data){
+    mariadb_stmt->long_data = 0;
+  }
+  /* https://mariadb.com/kb/en/mysql_stmt_bind_param */
+  else if(mysql_stmt_bind_param(mariadb_stmt->stmt, mariadb_stmt->bind_out)){
+    rc = 1;
+  }
+  return rc;
+}
 
 /**
- * Convenience function that sets the status code and the error string
- * generated by the database function.
+ * Execute a compiled statement with bound parameters.
  *
- * @param[in] db          See @ref sqldbal_db.
- * @param[in] sqlite_rc   Return code from SQLite function call. Only used if
- *                        the sqlite3* database handle has not been created.
- * @param[in] status_code See @ref sqldbal_status_code.
+ * @param[in] stmt See @ref sqldbal_stmt.
  */
 static void
-sqldbal_sqlite_error(struct sqldbal_db *const db,
-                     int sqlite_rc,
-                     enum sqldbal_status_code status_code){
-  sqlite3 *sqlite_db;
-  const char *errstr;
+sqldbal_mariadb_stmt_execute(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  int stream;
 
-  sqlite_db = db->handle;
+  mariadb_stmt = stmt->handle;
 
-  /* https://www.sqlite.org/c3ref/errcode.html */
-  if(sqlite_db){
-    errstr = sqlite3_errmsg(sqlite_db);
+  /* A cursor fetches the rows from the server in prefetch sized batches. */
+  stream = (stmt->db->flags & SQLDBAL_FLAG_STREAM_RESULTS) != 0 ||
+           stmt->cursor_prefetch;
+
+  /* Discard any unread rows from the previous execution. */
+  /* https://mariadb.com/kb/en/mysql_stmt_free_result */
+  mysql_stmt_free_result(mariadb_stmt->stmt);
+  mariadb_stmt->stored_result = 0;
+
+  /* https://mariadb.com/kb/en/mysql_stmt_execute      */
+  /* https://mariadb.com/kb/en/mysql_stmt_store_result */
+  if(sqldbal_mariadb_stmt_bind_param(stmt) ||
+     mysql_stmt_execute     (mariadb_stmt->stmt) ||
+     (!stream && mysql_stmt_store_result(mariadb_stmt->stmt))){
+    sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
   }
   else{
-    errstr = sqlite3_errstr(sqlite_rc);
+    mariadb_stmt->stored_result = !stream;
+    sqldbal_mariadb_stmt_bind_result_list(stmt);
   }
-  sqldbal_err_set(db, status_code, errstr);
 }
 
-#ifdef SQLDBAL_SQLITE_HAS_TRACE_V2
-/**
- * Trace mask used in sqlite3_trace_v2.
- */
-#define SQLDBAL_SQLITE_TRACE_ALL SQLITE_TRACE_STMT    | \
-                                 SQLITE_TRACE_PROFILE | \
-                                 SQLITE_TRACE_ROW     | \
-                                 SQLITE_TRACE_CLOSE
 
+#ifdef SQLDBAL_MARIADB_HAS_NONBLOCK
 /**
- * Print trace information to stderr.
+ * Handle the result from a mysql_*_start or mysql_*_cont call and start the
+ * next call needed to complete the statement.
  *
- * @param[in] mask    One of the values in @ref SQLDBAL_SQLITE_TRACE_ALL.
- * @param[in] context User parameter provided to the callback - unused.
- * @param[in] P       SQLite prepared statement or database handle, depending
- *                    on the value of @p mask.
- * @param[in] X       Parameter type set depending on value of @p mask.
- * @retval 0 Return value currently unused.
+ * @param[in] stmt         See @ref sqldbal_stmt.
+ * @param[in] async_status Events returned by the last call, or 0 if that
+ *                         call has completed.
+ * @param[in] ret          Return value of the completed call.
  */
-SQLDBAL_LINKAGE int
-sqldbal_sqlite_trace_hook(unsigned mask,
-                          void *context,
-                          void *P,
-                          void *X){
-  const char *trace_stmt;
-  int64_t i64;
-  long l;
-  const char *more_than;
+static void
+sqldbal_mariadb_stmt_async_next(struct sqldbal_stmt *const stmt,
+                                int async_status,
+                                int ret){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  int stream;
 
-  (void)context;
-  (void)P;
+  mariadb_stmt = stmt->handle;
+  stream = (stmt->db->flags & SQLDBAL_FLAG_STREAM_RESULTS) != 0;
+  while(async_status == 0 && mariadb_stmt->async != SQLDBAL_MARIADB_ASYNC_NONE){
+    if(ret){
+      sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
+      mariadb_stmt->async = SQLDBAL_MARIADB_ASYNC_NONE;
+    }
+    else if(mariadb_stmt->async == SQLDBAL_MARIADB_ASYNC_EXECUTE && !stream){
+      mariadb_stmt->async = SQLDBAL_MARIADB_ASYNC_STORE_RESULT;
+      /* https://mariadb.com/kb/en/mysql_stmt_store_result_start */
+      async_status = mysql_stmt_store_result_start(&ret, mariadb_stmt->stmt);
+    }
+    else{
+      mariadb_stmt->stored_result =
+        mariadb_stmt->async == SQLDBAL_MARIADB_ASYNC_STORE_RESULT;
+      mariadb_stmt->async = SQLDBAL_MARIADB_ASYNC_NONE;
+    }
+  }
+  mariadb_stmt->async_status = async_status;
+}
 
-  switch(mask){
-    case SQLITE_TRACE_STMT:
-      trace_stmt = X;
-      fprintf(stderr, "SQLITE_TRACE_STMT: %s\n", trace_stmt);
-      break;
-    case SQLITE_TRACE_PROFILE:
-      i64 = *(int64_t*)X;
-      l = i64;
-      if(i64 > LONG_MAX){
-        more_than = "more than ";
-      }
-      else{
-        more_than = "";
-      }
-      fprintf(stderr,
-              "SQLITE_TRACE_PROFILE: query took %s%ld us\n",
-              more_than,
-              l);
-      break;
-    case SQLITE_TRACE_ROW:
-      fputs("SQLITE_TRACE_ROW: statement generated new row\n", stderr);
-      break;
-    case SQLITE_TRACE_CLOSE:
-      fputs("SQLITE_TRACE_CLOSE: database connection closed\n", stderr);
-      break;
-    default:
-      fputs("SQLITE_TRACE_UNKNOWN: unknown trace mask\n", stderr);
-      break;
+/**
+ * Send a compiled statement using the non-blocking client API.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_mariadb_stmt_execute_start(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  int async_status;
+  int ret;
+
+  mariadb_stmt = stmt->handle;
+  if((stmt->db->flags & SQLDBAL_FLAG_MARIADB_NONBLOCK) == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
   }
+  else{
+    /* https://mariadb.com/kb/en/mysql_stmt_free_result */
+    mysql_stmt_free_result(mariadb_stmt->stmt);
+    mariadb_stmt->stored_result = 0;
 
-  return 0;
+    if(sqldbal_mariadb_stmt_bind_param(stmt)){
+      sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
+    }
+    else{
+      mariadb_stmt->async = SQLDBAL_MARIADB_ASYNC_EXECUTE;
+      /* https://mariadb.com/kb/en/mysql_stmt_execute_start */
+      async_status = mysql_stmt_execute_start(&ret, mariadb_stmt->stmt);
+      sqldbal_mariadb_stmt_async_next(stmt, async_status, ret);
+    }
+  }
 }
-#endif /* SQLDBAL_SQLITE_HAS_TRACE_V2 */
 
 /**
- * Open a SQLite database file.
+ * Continue the non-blocking call started by
+ * @ref sqldbal_mariadb_stmt_execute_start.
  *
- * @param[in] db          See @ref sqldbal_db.
- * @param[in] location    Path to database file.
- * @param[in] port        Unused.
- * @param[in] username    Unused.
- * @param[in] password    Unused.
- * @param[in] database    Unused.
- * @param[in] option_list Driver-specific options to pass to SQLite.
- * @param[in] num_options Number of entries in @p option_list.
+ * @param[in]  stmt        See @ref sqldbal_stmt.
+ * @param[out] wait_events See @ref sqldbal_wait_event.
  */
 static void
-sqldbal_sqlite_open(struct sqldbal_db *const db,
-                    const char *const location,
-                    const char *const port,
-                    const char *const username,
-                    const char *const password,
-                    const char *const database,
-                    const struct sqldbal_driver_option *const option_list,
-                    size_t num_options){
-  sqlite3 *sqlite_db;
-  const struct sqldbal_driver_option *option;
-  size_t i;
-  int flags;
-  int sqlite_err;
-  const char *vfs;
-
-  (void)port;
-  (void)username;
-  (void)password;
-  (void)database;
+sqldbal_mariadb_stmt_execute_poll(struct sqldbal_stmt *const stmt,
+                                  int *const wait_events){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  int async_status;
+  int ready_status;
+  int ret;
 
-  flags = 0;
-  vfs = NULL;
+  mariadb_stmt = stmt->handle;
 
-  for(i = 0; i < num_options; i++){
-    option = &option_list[i];
-    if(strcmp(option->key, "VFS") == 0){
-      vfs = option->value;
-    }
-    else{
-      sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
-    }
+  /* Reporting a timeout would make the pending call fail. */
+  ready_status = mariadb_stmt->async_status & ~MYSQL_WAIT_TIMEOUT;
+  ret = 0;
+  async_status = 0;
+  if(mariadb_stmt->async == SQLDBAL_MARIADB_ASYNC_EXECUTE){
+    /* https://mariadb.com/kb/en/mysql_stmt_execute_cont */
+    async_status = mysql_stmt_execute_cont(&ret,
+                                           mariadb_stmt->stmt,
+                                           ready_status);
+  }
+  else if(mariadb_stmt->async == SQLDBAL_MARIADB_ASYNC_STORE_RESULT){
+    /* https://mariadb.com/kb/en/mysql_stmt_store_result_cont */
+    async_status = mysql_stmt_store_result_cont(&ret,
+                                                mariadb_stmt->stmt,
+                                                ready_status);
   }
+  sqldbal_mariadb_stmt_async_next(stmt, async_status, ret);
+  *wait_events = sqldbal_mariadb_wait_events(mariadb_stmt->async_status);
+}
+#else /* !(SQLDBAL_MARIADB_HAS_NONBLOCK) */
+/**
+ * The client library does not provide the non-blocking API.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_mariadb_stmt_execute_start(struct sqldbal_stmt *const stmt){
+  sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+}
 
-  if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
-    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_READONLY){
-      flags |= SQLITE_OPEN_READONLY;
-    }
+/**
+ * Never gets called because @ref sqldbal_mariadb_stmt_execute_start always
+ * fails.
+ *
+ * @param[in]  stmt        Unused.
+ * @param[out] wait_events Always set to 0.
+ */
+static void
+sqldbal_mariadb_stmt_execute_poll(struct sqldbal_stmt *const stmt,
+                                  int *const wait_events){
+  (void)stmt;
+  *wait_events = 0;
+}
+#endif /* SQLDBAL_MARIADB_HAS_NONBLOCK */
 
-    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_READWRITE){
-      flags |= SQLITE_OPEN_READWRITE;
-    }
+/**
+ * Bind the result columns of a statement started by
+ * @ref sqldbal_mariadb_stmt_execute_start.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_mariadb_stmt_execute_finish(struct sqldbal_stmt *const stmt){
+  if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+    sqldbal_mariadb_stmt_bind_result_list(stmt);
+  }
+}
 
-    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_CREATE){
-      flags |= SQLITE_OPEN_CREATE;
-    }
+/**
+ * Error number reported by the local infile callbacks, which has the same
+ * value as CR_UNKNOWN_ERROR in errmsg.h.
+ */
+#define SQLDBAL_MARIADB_BULK_ERRNO 2000
 
-    if(flags == 0){
-      flags |= SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
-    }
+/**
+ * Bulk load state for MariaDB.
+ */
+struct sqldbal_mariadb_bulk{
+  /**
+   * Temporary file holding the rows in the LOAD DATA text format until
+   * @ref sqldbal_mariadb_bulk_end sends them.
+   */
+  FILE *spool;
 
-    /* https://www.sqlite.org/c3ref/open.html */
-    sqlite_err = sqlite3_open_v2(location, &sqlite_db, flags, vfs);
-    if(sqlite_err != SQLITE_OK){
-      sqldbal_sqlite_error(db, sqlite_err, SQLDBAL_STATUS_OPEN);
+  /**
+   * LOAD DATA statement.
+   */
+  char *sql;
+};
+
+/**
+ * Start a LOAD DATA bulk load.
+ *
+ * The server reads the data while LOAD DATA runs, so the rows get written
+ * to a temporary file until @ref sqldbal_mariadb_bulk_end.
+ *
+ * @param[in] bulk        See @ref sqldbal_bulk.
+ * @param[in] table       See @ref sqldbal_bulk_begin.
+ * @param[in] column_list See @ref sqldbal_bulk_begin.
+ */
+static void
+sqldbal_mariadb_bulk_begin(struct sqldbal_bulk *const bulk,
+                           const char *const table,
+                           const char *const *const column_list){
+  struct sqldbal_mariadb_bulk *mariadb_bulk;
+
+  mariadb_bulk = malloc(sizeof(*mariadb_bulk));
+  if(mariadb_bulk == NULL){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    bulk->handle = mariadb_bulk;
+    mariadb_bulk->sql = NULL;
+    mariadb_bulk->spool = tmpfile();
+    if(mariadb_bulk->spool == NULL){
+      sqldbal_err_set(bulk->db, SQLDBAL_STATUS_EXEC, strerror(errno));
     }
     else{
-      if(db->flags & SQLDBAL_FLAG_DEBUG){
-#ifdef SQLDBAL_SQLITE_HAS_TRACE_V2
-        /* https://www.sqlite.org/c3ref/trace_v2.html */
-        if(sqlite3_trace_v2(sqlite_db,
-                            SQLDBAL_SQLITE_TRACE_ALL,
-                            sqldbal_sqlite_trace_hook,
-                            NULL) != SQLITE_OK){
-          sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_OPEN);
+      /* The default field and line terminators match the row encoding. */
+      sqldbal_bulk_append_sql(bulk,
+                              "LOAD DATA LOCAL INFILE 'sqldbal' INTO TABLE ",
+                              table,
+                              column_list,
+                              "");
+      sqldbal_bulk_append(bulk, "", 1);
+      if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+        mariadb_bulk->sql = sqldbal_strdup(bulk->buf);
+        if(mariadb_bulk->sql == NULL){
+          sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
         }
-#endif /* SQLDBAL_SQLITE_HAS_TRACE_V2 */
       }
     }
-
-    db->handle = sqlite_db;
   }
+  bulk->buf_len = 0;
 }
 
 /**
- * Close SQLite database handle.
+ * Write the buffered rows to the temporary file.
  *
- * @param[in] db See @ref sqldbal_db.
+ * @param[in] bulk See @ref sqldbal_bulk.
  */
 static void
-sqldbal_sqlite_close(struct sqldbal_db *const db){
-  sqlite3 *sqlite_db;
+sqldbal_mariadb_bulk_flush(struct sqldbal_bulk *const bulk){
+  struct sqldbal_mariadb_bulk *mariadb_bulk;
 
-  sqlite_db = db->handle;
+  mariadb_bulk = bulk->handle;
+  if(fwrite(bulk->buf, 1, bulk->buf_len, mariadb_bulk->spool) !=
+     bulk->buf_len){
+    sqldbal_err_set(bulk->db, SQLDBAL_STATUS_EXEC, strerror(errno));
+  }
+  bulk->buf_len = 0;
+}
 
-  /* https://www.sqlite.org/c3ref/close.html */
-  if(sqlite3_close_v2(sqlite_db) != SQLITE_OK){
-    sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_CLOSE);
+/**
+ * Encode a row in the tab-separated LOAD DATA text format.
+ *
+ * @param[in] bulk       See @ref sqldbal_bulk.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] row        Row index starting at 0.
+ */
+static void
+sqldbal_mariadb_bulk_row(struct sqldbal_bulk *const bulk,
+                         const struct sqldbal_batch_param *const param_list,
+                         size_t row){
+  const struct sqldbal_batch_param *param;
+  const void *data;
+  size_t len;
+  size_t col_idx;
+
+  for(col_idx = 0; col_idx < bulk->num_cols; col_idx++){
+    param = &param_list[col_idx];
+    if(col_idx){
+      sqldbal_bulk_append(bulk, "\t", 1);
+    }
+    if(sqldbal_batch_is_null(param, row)){
+      sqldbal_bulk_append(bulk, "\\N", 2);
+    }
+    else if(param->type == SQLDBAL_TYPE_INT){
+      sqldbal_bulk_append_int64(bulk, param->i64_list[row]);
+    }
+    else{
+      data = sqldbal_batch_data(param, row, &len);
+      sqldbal_bulk_append_escaped(bulk, data, len);
+    }
+  }
+  sqldbal_bulk_append(bulk, "\n", 1);
+  if(bulk->buf_len >= SQLDBAL_BULK_FLUSH_SIZE &&
+     sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    sqldbal_mariadb_bulk_flush(bulk);
   }
 }
 
 /**
- * Get the SQLite3 database handle.
+ * Local infile callback that starts reading the temporary file.
  *
- * @param[in] db See @ref sqldbal_db.
- * @return SQLite3 database handle.
+ * @param[out] ptr      Set to @p userdata.
+ * @param[in]  filename Ignored.
+ * @param[in]  userdata See @ref sqldbal_mariadb_bulk.
+ * @return Always 0.
  */
-static void *
-sqldbal_sqlite_db_handle(const struct sqldbal_db *const db){
-  sqlite3 *sqlite_db;
+static int
+sqldbal_mariadb_bulk_infile_init(void **ptr,
+                                 const char *filename,
+                                 void *userdata){
+  (void)filename;
+  *ptr = userdata;
+  return 0;
+}
 
-  sqlite_db = db->handle;
-  return sqlite_db;
+/**
+ * Local infile callback that reads the next part of the temporary file.
+ *
+ * @param[in]  ptr     See @ref sqldbal_mariadb_bulk.
+ * @param[out] buf     Buffer receiving the rows.
+ * @param[in]  buf_len Number of bytes available in @p buf.
+ * @return Number of bytes read, 0 at the end of the file, or -1 on error.
+ */
+static int
+sqldbal_mariadb_bulk_infile_read(void *ptr,
+                                 char *buf,
+                                 unsigned int buf_len){
+  struct sqldbal_mariadb_bulk *mariadb_bulk;
+  size_t nread;
+  int rc;
+
+  mariadb_bulk = ptr;
+  nread = fread(buf, 1, buf_len, mariadb_bulk->spool);
+  if(ferror(mariadb_bulk->spool)){
+    rc = -1;
+  }
+  else{
+    rc = (int)nread;
+  }
+  return rc;
 }
 
 /**
- * Get the SQLite3 statement handle.
+ * Local infile callback called after reading the temporary file.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
- * @return SQLite statement handle.
+ * @param[in] ptr Unused because @ref sqldbal_mariadb_bulk_end closes the
+ *                temporary file.
  */
-static void *
-sqldbal_sqlite_stmt_handle(const struct sqldbal_stmt *const stmt){
-  sqlite3_stmt *sqlite_stmt;
+static void
+sqldbal_mariadb_bulk_infile_end(void *ptr){
+  (void)ptr;
+}
 
-  sqlite_stmt = stmt->handle;
-  return sqlite_stmt;
+/**
+ * Local infile callback that describes a read error.
+ *
+ * @param[in]  ptr           Unused.
+ * @param[out] error_msg     Buffer receiving the error message.
+ * @param[in]  error_msg_len Number of bytes in @p error_msg.
+ * @return See @ref SQLDBAL_MARIADB_BULK_ERRNO.
+ */
+static int
+sqldbal_mariadb_bulk_infile_error(void *ptr,
+                                  char *error_msg,
+                                  unsigned int error_msg_len){
+  (void)ptr;
+  snprintf(error_msg, error_msg_len, "failed to read bulk load rows");
+  return SQLDBAL_MARIADB_BULK_ERRNO;
 }
 
 /**
- * Execute a database statement that does not have a result set.
+ * Run the LOAD DATA statement and free the bulk load state.
  *
- * @param[in] db  See @ref sqldbal_db.
- * @param[in] sql SQL statement to execute.
+ * LOCAL INFILE only stays enabled while the LOAD DATA statement runs.
+ * Otherwise the server could ask for any client file during a later query.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
  */
 static void
-sqldbal_sqlite_noresult(struct sqldbal_db *const db,
-                        const char *const sql){
-  sqlite3 *sqlite_db;
-  char *errmsg;
+sqldbal_mariadb_bulk_end(struct sqldbal_bulk *const bulk){
+  struct sqldbal_mariadb_bulk *mariadb_bulk;
+  MYSQL *mysql_db;
+  unsigned int local_infile;
+  unsigned int local_infile_prev;
+  enum sqldbal_status_code status;
 
-  sqlite_db = db->handle;
-  /* https://www.sqlite.org/c3ref/exec.html */
-  if(sqlite3_exec(sqlite_db, sql, NULL, NULL, &errmsg) != SQLITE_OK){
-    sqldbal_err_set(db, SQLDBAL_STATUS_EXEC, errmsg);
-    /* https://www.sqlite.org/c3ref/free.html */
-    sqlite3_free(errmsg);
+  mariadb_bulk = bulk->handle;
+  mysql_db = bulk->db->handle;
+  if(mariadb_bulk){
+    if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+      sqldbal_mariadb_bulk_flush(bulk);
+    }
+    if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK &&
+       fseek(mariadb_bulk->spool, 0, SEEK_SET) != 0){
+      sqldbal_err_set(bulk->db, SQLDBAL_STATUS_EXEC, strerror(errno));
+    }
+    local_infile_prev = 0;
+    if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+      /* https://mariadb.com/kb/en/mysql_get_option */
+      mysql_get_option(mysql_db, MYSQL_OPT_LOCAL_INFILE, &local_infile_prev);
+      local_infile = 1;
+      sqldbal_mariadb_mysql_options(bulk->db,
+                                    MYSQL_OPT_LOCAL_INFILE,
+                                    &local_infile);
+    }
+    if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+      /* https://mariadb.com/kb/en/mysql_set_local_infile_handler */
+      mysql_set_local_infile_handler(mysql_db,
+                                     sqldbal_mariadb_bulk_infile_init,
+                                     sqldbal_mariadb_bulk_infile_read,
+                                     sqldbal_mariadb_bulk_infile_end,
+                                     sqldbal_mariadb_bulk_infile_error,
+                                     mariadb_bulk);
+      /* https://mariadb.com/kb/en/mysql_real_query */
+      if(mysql_real_query(mysql_db,
+                          mariadb_bulk->sql,
+                          strlen(mariadb_bulk->sql))){
+        sqldbal_mariadb_error(bulk->db, mysql_db, SQLDBAL_STATUS_EXEC);
+      }
+      /* https://mariadb.com/kb/en/mysql_set_local_infile_default */
+      mysql_set_local_infile_default(mysql_db);
+
+      /* Keep the LOAD DATA error if the statement failed. */
+      status = sqldbal_status_code_get(bulk->db);
+      sqldbal_mariadb_mysql_options(bulk->db,
+                                    MYSQL_OPT_LOCAL_INFILE,
+                                    &local_infile_prev);
+      if(status != SQLDBAL_STATUS_OK){
+        sqldbal_status_code_set(bulk->db, status);
+      }
+    }
+    if(mariadb_bulk->spool){
+      fclose(mariadb_bulk->spool);
+    }
+    free(mariadb_bulk->sql);
+    free(mariadb_bulk);
   }
 }
 
 /**
- * Begin a SQLite transaction.
+ * MariaDB does not have a large object handle.
  *
- * @param[in] db See @ref sqldbal_db.
+ * Use @ref sqldbal_stmt_send_blob and @ref sqldbal_stmt_column_blob_read
+ * to move large values in chunks.
+ *
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] table  Unused.
+ * @param[in] column Unused.
+ * @param[in] row_id Unused.
  */
 static void
-sqldbal_sqlite_begin_transaction(struct sqldbal_db *const db){
-  sqldbal_sqlite_noresult(db, "BEGIN");
+sqldbal_mariadb_blob_open(struct sqldbal_blob *const blob,
+                          const char *const table,
+                          const char *const column,
+                          int64_t row_id){
+  (void)table;
+  (void)column;
+  (void)row_id;
+  sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
 }
 
 /**
- * Commit a SQLite transaction.
+ * MariaDB does not have a large object handle.
  *
- * @param[in] db See @ref sqldbal_db.
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] offset Unused.
+ * @param[in] buf    Unused.
+ * @param[in] len    Unused.
  */
 static void
-sqldbal_sqlite_commit(struct sqldbal_db *const db){
-  sqldbal_sqlite_noresult(db, "COMMIT");
+sqldbal_mariadb_blob_read(struct sqldbal_blob *const blob,
+                          uint64_t offset,
+                          void *const buf,
+                          size_t len){
+  (void)offset;
+  (void)buf;
+  (void)len;
+  sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
 }
 
 /**
- * Rollback a SQLite transaction.
+ * MariaDB does not have a large object handle.
  *
- * @param[in] db See @ref sqldbal_db.
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] offset Unused.
+ * @param[in] buf    Unused.
+ * @param[in] len    Unused.
  */
 static void
-sqldbal_sqlite_rollback(struct sqldbal_db *const db){
-  sqldbal_sqlite_noresult(db, "ROLLBACK");
+sqldbal_mariadb_blob_write(struct sqldbal_blob *const blob,
+                           uint64_t offset,
+                           const void *const buf,
+                           size_t len){
+  (void)offset;
+  (void)buf;
+  (void)len;
+  sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+}
+
+/**
+ * Nothing to release because @ref sqldbal_mariadb_blob_open never opens
+ * a handle.
+ *
+ * @param[in] blob See @ref sqldbal_blob.
+ */
+static void
+sqldbal_mariadb_blob_close(struct sqldbal_blob *const blob){
+  (void)blob;
 }
 
+#ifdef SQLDBAL_MARIADB_HAS_BULK
 /**
- * Called by sqlite3_exec to process each row in the result set.
+ * Check if the connected server supports array binding.
  *
- * This function copies the row data to the callback provided by the
- * application.
+ * MySQL servers and older MariaDB servers do not support this feature.
  *
- * @param[in] cb_argument     See @ref sqldbal_sqlite_cb_data.
- * @param[in] num_cols        Number of entries in @p col_result_list
- *                            and @p col_name_list.
- * @param[in] col_result_list Column values that have been coerced to strings.
- * @param[in] col_name_list   Column names - not used.
- * @retval SQLITE_OK    Success.
- * @retval SQLITE_ABORT An error occurred.
+ * @param[in] db See @ref sqldbal_db.
+ * @retval 1 Server supports array binding.
+ * @retval 0 Server does not support array binding.
  */
 static int
-sqldbal_sqlite_exec_callback(void *cb_argument,
-                             int num_cols,
-                             char **col_result_list,
-                             char **col_name_list){
-  struct sqldbal_sqlite_cb_data *cb_data;
-  int rc;
-  int col_i;
-  size_t num_cols_size_t;
-  size_t *col_length_list;
+sqldbal_mariadb_has_bulk(const struct sqldbal_db *const db){
+  MYSQL *mysql;
+  const char *server_info;
+  int has_bulk;
 
-  (void)col_name_list;
+  mysql = db->handle;
+  has_bulk = 0;
+  /* https://mariadb.com/kb/en/mysql_get_server_version */
+  if(mysql_get_server_version(mysql) >= SQLDBAL_MARIADB_BULK_SERVER_VERSION){
+    /* https://mariadb.com/kb/en/mysql_get_server_info */
+    server_info = mysql_get_server_info(mysql);
+    if(server_info && strstr(server_info, "MariaDB")){
+      has_bulk = 1;
+    }
+  }
+  return has_bulk;
+}
 
-  cb_data = cb_argument;
+/**
+ * Fill in the array bind structure for one placeholder in a batch.
+ *
+ * @param[in]  stmt     See @ref sqldbal_stmt.
+ * @param[in]  param    See @ref sqldbal_batch_param.
+ * @param[in]  num_rows Number of rows in @p param.
+ * @param[out] bind     Array bind structure with dynamically allocated
+ *                      buffers that the caller must free.
+ */
+static void
+sqldbal_mariadb_stmt_bind_array(struct sqldbal_stmt *const stmt,
+                                const struct sqldbal_batch_param *const param,
+                                size_t num_rows,
+                                MYSQL_BIND *const bind){
+  size_t row;
+  long long *ll_list;
+  unsigned long *length_list;
+  size_t slen;
 
-  /* The callback does not provide a negative number for column count. */
-  num_cols_size_t = (size_t)num_cols;
+  bind->u.indicator = malloc(num_rows);
+  if(param->type == SQLDBAL_TYPE_INT){
+    bind->buffer_type = MYSQL_TYPE_LONGLONG;
+    bind->buffer = sqldbal_reallocarray(NULL, num_rows, sizeof(*ll_list));
+  }
+  else if(param->type == SQLDBAL_TYPE_TEXT ||
+          param->type == SQLDBAL_TYPE_BLOB){
+    if(param->type == SQLDBAL_TYPE_TEXT){
+      bind->buffer_type = MYSQL_TYPE_STRING;
+    }
+    else{
+      bind->buffer_type = MYSQL_TYPE_BLOB;
+    }
+    bind->buffer = sqldbal_reallocarray(NULL,
+                                        num_rows,
+                                        sizeof(param->blob_list[0]));
+    bind->length = sqldbal_reallocarray(NULL, num_rows, sizeof(*length_list));
+  }
+  else{
+    bind->buffer_type = MYSQL_TYPE_NULL;
+  }
 
-  col_length_list = sqldbal_reallocarray(NULL,
-                                         num_cols_size_t,
-                                         sizeof(*col_length_list));
-  if(col_length_list == NULL){
-    sqldbal_status_code_set(cb_data->db, SQLDBAL_STATUS_NOMEM);
-    rc = SQLITE_ABORT;
+  if(bind->u.indicator == NULL ||
+     (bind->buffer_type != MYSQL_TYPE_NULL && bind->buffer == NULL) ||
+     ((bind->buffer_type == MYSQL_TYPE_STRING ||
+       bind->buffer_type == MYSQL_TYPE_BLOB) && bind->length == NULL)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
   }
   else{
-    for(col_i = 0; col_i < num_cols; col_i++){
-      if(col_result_list[col_i]){
-        col_length_list[col_i] = strlen(col_result_list[col_i]);
+    ll_list = bind->buffer;
+    length_list = bind->length;
+    if(param->type == SQLDBAL_TYPE_TEXT){
+      memcpy(bind->buffer,
+             param->text_list,
+             num_rows * sizeof(param->text_list[0]));
+    }
+    else if(param->type == SQLDBAL_TYPE_BLOB){
+      memcpy(bind->buffer,
+             param->blob_list,
+             num_rows * sizeof(param->blob_list[0]));
+    }
+    for(row = 0; row < num_rows; row++){
+      if(sqldbal_batch_is_null(param, row)){
+        bind->u.indicator[row] = STMT_INDICATOR_NULL;
       }
       else{
-        col_length_list[col_i] = 0;
+        bind->u.indicator[row] = STMT_INDICATOR_NONE;
+        if(param->type == SQLDBAL_TYPE_INT){
+          if(si_int64_to_llong(param->i64_list[row], &ll_list[row])){
+            sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+            break;
+          }
+        }
+        else if(param->type == SQLDBAL_TYPE_TEXT){
+          if(param->length_list){
+            slen = param->length_list[row];
+          }
+          else{
+            slen = strlen(param->text_list[row]);
+          }
+
+          /* Include null-terminator like sqldbal_stmt_bind_text. */
+          length_list[row] = slen + 1;
+        }
+        else{
+          length_list[row] = param->length_list[row];
+        }
       }
     }
-
-    rc = cb_data->callback(cb_data->user_data,
-                           num_cols_size_t,
-                           col_result_list,
-                           col_length_list);
-    if(rc == 0){
-      rc = SQLITE_OK;
-    }
-    else{
-      sqldbal_status_code_set(cb_data->db, SQLDBAL_STATUS_EXEC);
-      rc = SQLITE_ABORT;
-    }
-    free(col_length_list);
   }
-
-  return rc;
 }
 
 /**
- * Execute a direct SQL statement.
+ * Execute a batch using MariaDB array binding.
  *
- * @param[in] db        See @ref sqldbal_db.
- * @param[in] sql       SQL command to execute.
- * @param[in] callback  Invokes this callback function for every returned row
- *                      in the query result set. Set this to NULL if query
- *                      results not needed.
- * @param[in] user_data Pass this to the first argument in the
- *                      @p callback function.
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in @p param_list.
  */
 static void
-sqldbal_sqlite_exec(struct sqldbal_db *const db,
-                    const char *const sql,
-                    sqldbal_exec_callback_fp callback,
-                    void *user_data){
-  sqlite3 *sqlite_db;
-  char *errmsg;
-  struct sqldbal_sqlite_cb_data cb_data;
-  int (*sqlite_exec_fp)(void *, int, char **, char **);
+sqldbal_mariadb_stmt_execute_bulk(
+  struct sqldbal_stmt *const stmt,
+  const struct sqldbal_batch_param *const param_list,
+  size_t num_rows){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  MYSQL_BIND *bind_list;
+  unsigned int array_size;
+  size_t i;
 
-  sqlite_db = db->handle;
+  mariadb_stmt = stmt->handle;
 
-  cb_data.db = db;
-  cb_data.callback = callback;
-  cb_data.user_data = user_data;
+  /* Discard any unread rows from the previous execution. */
+  /* https://mariadb.com/kb/en/mysql_stmt_free_result */
+  mysql_stmt_free_result(mariadb_stmt->stmt);
+  mariadb_stmt->stored_result = 0;
 
-  if(callback == NULL){
-    sqlite_exec_fp = NULL;
+  bind_list = calloc(stmt->num_params + 1, sizeof(*bind_list));
+  if(bind_list == NULL){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
   }
-  else{
-    sqlite_exec_fp = sqldbal_sqlite_exec_callback;
+  else if(si_size_to_uint(num_rows, &array_size)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
   }
+  else{
+    for(i = 0;
+        i < stmt->num_params &&
+        sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK;
+        i++){
+      sqldbal_mariadb_stmt_bind_array(stmt,
+                                      &param_list[i],
+                                      num_rows,
+                                      &bind_list[i]);
+    }
+    if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      /* https://mariadb.com/kb/en/bulk-insert-column-wise-binding */
+      /* https://mariadb.com/kb/en/mysql_stmt_attr_set */
+      /* https://mariadb.com/kb/en/mysql_stmt_bind_param */
+      /* https://mariadb.com/kb/en/mysql_stmt_execute */
+      if(mysql_stmt_attr_set (mariadb_stmt->stmt,
+                              STMT_ATTR_ARRAY_SIZE,
+                              &array_size) ||
+         mysql_stmt_bind_param(mariadb_stmt->stmt, bind_list) ||
+         mysql_stmt_execute   (mariadb_stmt->stmt)){
+        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
+      }
 
-  /* https://www.sqlite.org/c3ref/exec.html */
-  sqlite3_exec(sqlite_db, sql, sqlite_exec_fp, &cb_data, &errmsg);
-  if(errmsg){
-    sqldbal_err_set(db, SQLDBAL_STATUS_EXEC, errmsg);
-    /* https://www.sqlite.org/c3ref/free.html */
-    sqlite3_free(errmsg);
+      /* Return to single row execution for sqldbal_stmt_execute. */
+      array_size = 0;
+      mysql_stmt_attr_set(mariadb_stmt->stmt,
+                          STMT_ATTR_ARRAY_SIZE,
+                          &array_size);
+    }
+  }
+  if(bind_list){
+    for(i = 0; i < stmt->num_params; i++){
+      free(bind_list[i].buffer);
+      free(bind_list[i].length);
+      free(bind_list[i].u.indicator);
+    }
+    free(bind_list);
   }
 }
+#endif /* SQLDBAL_MARIADB_HAS_BULK */
 
 /**
- * Get the insert id from the last SQL insert statement.
+ * Execute a compiled statement once for each row of column-wise values.
  *
- * @param[in]  db        See @ref sqldbal_db.
- * @param[in]  name      Unused.
- * @param[out] insert_id Last insert id.
+ * Uses array binding if the server supports it, otherwise executes the
+ * statement for each row.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in @p param_list.
  */
 static void
-sqldbal_sqlite_last_insert_id(struct sqldbal_db *const db,
-                              const char *const name,
-                              uint64_t *insert_id){
-  sqlite3 *sqlite_db;
-  sqlite3_int64 sqlite_rowid;
-
-  (void)name;
-
-  sqlite_db = db->handle;
-
-  /* https://www.sqlite.org/c3ref/last_insert_rowid.html */
-  sqlite_rowid = sqlite3_last_insert_rowid(sqlite_db);
-
-  /*
-   * SQLite normally wouldn't return a negative value, but a virtual table
-   * implementation might.
-   */
-  if(si_int64_to_uint64(sqlite_rowid, insert_id)){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_OVERFLOW);
+sqldbal_mariadb_stmt_execute_batch(
+  struct sqldbal_stmt *const stmt,
+  const struct sqldbal_batch_param *const param_list,
+  size_t num_rows){
+#ifdef SQLDBAL_MARIADB_HAS_BULK
+  if(stmt->num_params && sqldbal_mariadb_has_bulk(stmt->db)){
+    sqldbal_mariadb_stmt_execute_bulk(stmt, param_list, num_rows);
+  }
+  else{
+    sqldbal_stmt_execute_batch_loop(stmt, param_list, num_rows);
   }
+#else /* !(SQLDBAL_MARIADB_HAS_BULK) */
+  sqldbal_stmt_execute_batch_loop(stmt, param_list, num_rows);
+#endif /* SQLDBAL_MARIADB_HAS_BULK */
 }
 
 /**
- * Prepare SQLite statement.
+ * Check if the fetch buffer holds only part of a column value.
+ *
+ * @param[in] mariadb_stmt See @ref sqldbal_mariadb_stmt.
+ * @param[in] col_idx      Column index.
+ * @retval 1 The value and its null-terminator did not fit in the buffer.
+ * @retval 0 The buffer holds the entire value, or the value is NULL.
+ */
+static int
+sqldbal_mariadb_stmt_column_truncated(
+  const struct sqldbal_mariadb_stmt *const mariadb_stmt,
+  size_t col_idx){
+  const MYSQL_BIND *bind;
+
+  bind = &mariadb_stmt->bind_in_list[col_idx];
+  return bind->buffer_type == MYSQL_TYPE_BLOB &&
+         mariadb_stmt->bind_in_null_list[col_idx] == 0 &&
+         mariadb_stmt->bind_in_length_list[col_idx] >= bind->buffer_length;
+}
+
+/**
+ * Read a column from the current row that did not fit in the fetch buffer.
+ *
+ * Truncated values only get read when the application asks for the entire
+ * value, so @ref sqldbal_mariadb_stmt_column_blob_read can read large
+ * values in chunks without holding them in memory. This grows the column
+ * buffer to fit the value and reads it again with mysql_stmt_fetch_column.
+ * The larger buffer gets reused for the remaining rows.
  *
- * @param[in] db      See @ref sqldbal_db.
- * @param[in] sql     SQL query to compile.
- * @param[in] sql_len Length of @p sql in bytes, or -1 if null-terminated.
  * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Column index.
+ * @retval  0 The fetch buffer holds the entire value.
+ * @retval -1 Failed to read the value.
  */
-static void
-sqldbal_sqlite_stmt_prepare(struct sqldbal_db *const db,
-                            const char *const sql,
-                            size_t sql_len,
-                            struct sqldbal_stmt *stmt){
-  sqlite3 *sqlite_db;
-  sqlite3_stmt *sqlite_stmt;
-  int nbyte;
-  int col_count;
-  int param_count;
+static int
+sqldbal_mariadb_stmt_column_load(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  MYSQL_BIND *bind;
+  size_t length;
+  size_t buf_sz;
+  char *buf;
+  unsigned int fieldnr;
+  int rc;
 
-  sqlite_db = db->handle;
-  if(sql_len == SIZE_MAX){
-    nbyte = -1;
+  mariadb_stmt = stmt->handle;
+  bind = &mariadb_stmt->bind_in_list[col_idx];
+  rc = -1;
+  if(sqldbal_mariadb_stmt_column_truncated(mariadb_stmt, col_idx) == 0){
+    rc = 0;
   }
-  else if(sql_len > INT_MAX){
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
-    nbyte = -2;
+  else if(si_ulong_to_size(mariadb_stmt->bind_in_length_list[col_idx],
+                           &length) ||
+          si_add_size_t(length, 1, &buf_sz) ||
+          si_size_to_uint(col_idx, &fieldnr)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
   }
   else{
-    /* Within range because above condition ensures sql_len <= INT_MAX. */
-    nbyte = (int)sql_len;
-  }
-
-  if(nbyte != -2){
-    /* https://www.sqlite.org/c3ref/prepare.html */
-    if(sqlite3_prepare_v2(sqlite_db,
-                          sql,
-                          nbyte,
-                          &sqlite_stmt,
-                          NULL) != SQLITE_OK){
-      sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_PREPARE);
+    buf = realloc(bind->buffer, buf_sz);
+    if(buf == NULL){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      bind->buffer        = buf;
+      bind->buffer_length = buf_sz;
+
+      /* https://mariadb.com/kb/en/mysql_stmt_fetch_column */
+      /* https://mariadb.com/kb/en/mysql_stmt_bind_result */
+      if(mysql_stmt_fetch_column(mariadb_stmt->stmt, bind, fieldnr, 0) ||
+         mysql_stmt_bind_result(mariadb_stmt->stmt,
+                                mariadb_stmt->bind_in_list)){
+        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_FETCH);
+      }
+      else{
+        buf[length] = '\0';
+        rc = 0;
+      }
     }
-    stmt->handle = sqlite_stmt;
-
-    /*
-     * https://www.sqlite.org/c3ref/column_count.html
-     * This function should always return a positive value.
-     */
-    col_count = sqlite3_column_count(sqlite_stmt);
-    stmt->num_cols_result = (size_t)col_count;
-
-    /*
-     * https://www.sqlite.org/c3ref/bind_parameter_count.html
-     * This function should always return a positive value.
-     */
-    param_count = sqlite3_bind_parameter_count(sqlite_stmt);
-    stmt->num_params = (size_t)param_count;
   }
+  return rc;
 }
 
 /**
- * Convert the bind index to a 1-based index system required by SQLite.
- *
- * The driver interface expects a 0-based column index provided by
- * the application, but SQLite uses a 1-based colum index for the
- * bind_* functions.
+ * Get the next row in the result set.
  *
- * @param[in]  col_idx_in  The 0-based column index provided by the driver.
- * @param[out] col_idx_out The converted 1-based column index.
- * @retval  0 Successfully converted column index.
- * @retval !0 Error occurred when converting column index.
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return See @ref sqldbal_fetch_result.
  */
-static int
-sqldbal_sqlite_get_col_idx(size_t col_idx_in,
-                           int *col_idx_out){
-  size_t col_idx_sum;
+static enum sqldbal_fetch_result
+sqldbal_mariadb_stmt_fetch(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  enum sqldbal_fetch_result fetch_result;
 
-  if(si_add_size_t(col_idx_in, 1, &col_idx_sum) ||
-     si_size_to_int(col_idx_sum, col_idx_out)){
-    return 1;
+  mariadb_stmt = stmt->handle;
+
+  /* https://mariadb.com/kb/en/mysql_stmt_fetch */
+  switch(mysql_stmt_fetch(mariadb_stmt->stmt)){
+    case 0:
+    case MYSQL_DATA_TRUNCATED:
+      fetch_result = SQLDBAL_FETCH_ROW;
+      break;
+    case MYSQL_NO_DATA:
+      fetch_result = SQLDBAL_FETCH_DONE;
+      break;
+    default:
+      sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_FETCH);
+      fetch_result = SQLDBAL_FETCH_ERROR;
+      break;
   }
-  return 0;
+
+  return fetch_result;
 }
 
 /**
- * Assign binary data to a prepared statement placeholder.
+ * Get the number of rows in the result set stored by
+ * mysql_stmt_store_result.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] blob    Binary data saved to BLOB or BYTEA types.
- * @param[in] blobsz  Length of @p blob in bytes.
+ * @param[in]  stmt     See @ref sqldbal_stmt.
+ * @param[out] num_rows Number of rows in the result set.
  */
 static void
-sqldbal_sqlite_stmt_bind_blob(struct sqldbal_stmt *const stmt,
-                              size_t col_idx,
-                              const void *const blob,
-                              size_t blobsz){
-  sqlite3_stmt *sqlite_stmt;
-  int blobsz_int;
-  int col_idx_i;
+sqldbal_mariadb_stmt_num_rows(struct sqldbal_stmt *const stmt,
+                              uint64_t *num_rows){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
 
-  if(si_size_to_int(blobsz, &blobsz_int) ||
-     sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  mariadb_stmt = stmt->handle;
+  if(mariadb_stmt->stored_result == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
   }
   else{
-    sqlite_stmt = stmt->handle;
-
-    /* https://www.sqlite.org/c3ref/bind_blob.html */
-    if(sqlite3_bind_blob(sqlite_stmt,
-                         col_idx_i,
-                         blob,
-                         blobsz_int,
-                         SQLITE_TRANSIENT) != SQLITE_OK){
-      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
-    }
+    /* https://mariadb.com/kb/en/mysql_stmt_num_rows */
+    *num_rows = mysql_stmt_num_rows(mariadb_stmt->stmt);
   }
 }
 
 /**
- * Assign a 64-bit integer to a prepared statement placeholder.
+ * Move to a row in the result set stored by mysql_stmt_store_result.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] i64     Integer to bind.
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @param[in] row  Row number starting at 0.
  */
 static void
-sqldbal_sqlite_stmt_bind_int64(struct sqldbal_stmt *const stmt,
-                               size_t col_idx,
-                               int64_t i64){
-  sqlite3_stmt *sqlite_stmt;
-  int col_idx_i;
-
-  sqlite_stmt = stmt->handle;
+sqldbal_mariadb_stmt_seek(struct sqldbal_stmt *const stmt,
+                          uint64_t row){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
 
-  if(sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  mariadb_stmt = stmt->handle;
+  if(mariadb_stmt->stored_result == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+  }
+  else if(row > mysql_stmt_num_rows(mariadb_stmt->stmt)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
   }
   else{
-    /* https://www.sqlite.org/c3ref/bind_blob.html */
-    if(sqlite3_bind_int64(sqlite_stmt,
-                          col_idx_i,
-                          i64) != SQLITE_OK){
-      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
-    }
+    /* https://mariadb.com/kb/en/mysql_stmt_data_seek */
+    mysql_stmt_data_seek(mariadb_stmt->stmt, row);
   }
 }
 
 /**
- * Assign a text string to a prepared statement placeholder.
+ * Convert an integer, floating point, or timestamp column result to a
+ * string.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
- * @param[in] s       Text string saved to a SQL text type.
- * @param[in] slen    Length of @p s in bytes.
+ * The string gets stored in the per-column slot of the
+ * @ref sqldbal_mariadb_stmt::bind_in_column_list buffer so that it remains
+ * valid until the next fetch.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] textsz  Number of bytes in the string, excluding the
+ *                     null-terminator.
+ * @return Null-terminated string.
  */
-static void
-sqldbal_sqlite_stmt_bind_text(struct sqldbal_stmt *const stmt,
-                              size_t col_idx,
-                              const char *const s,
-                              size_t slen){
-  sqlite3_stmt *sqlite_stmt;
-  int bind_len;
-  int col_idx_i;
+static const char *
+sqldbal_mariadb_stmt_column_conv_str(struct sqldbal_stmt *const stmt,
+                                     size_t col_idx,
+                                     size_t *textsz){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  const MYSQL_BIND *bind;
+  const MYSQL_TIME *tm;
+  char *conv_str;
+  int slen;
 
-  if(si_size_to_int(slen, &bind_len) ||
-     sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  mariadb_stmt = stmt->handle;
+  bind = &mariadb_stmt->bind_in_list[col_idx];
+  conv_str = mariadb_stmt->bind_in_column_list[col_idx].conv_str;
+  if(bind->buffer_type == MYSQL_TYPE_DOUBLE){
+    slen = (int)sqldbal_double_to_str(*(double *)bind->buffer, conv_str);
+  }
+  else if(bind->buffer_type == MYSQL_TYPE_DATETIME){
+    tm = bind->buffer;
+    slen = sprintf(conv_str, "%04u-%02u-%02u", tm->year, tm->month, tm->day);
+    if(tm->time_type != MYSQL_TIMESTAMP_DATE){
+      slen += sprintf(&conv_str[slen],
+                      " %02u:%02u:%02u",
+                      tm->hour,
+                      tm->minute,
+                      tm->second);
+      if(tm->second_part){
+        slen += sprintf(&conv_str[slen], ".%06lu", tm->second_part);
+      }
+    }
+  }
+  else if(bind->is_unsigned){
+    slen = sprintf(conv_str, "%llu", *(unsigned long long *)bind->buffer);
   }
   else{
-    sqlite_stmt = stmt->handle;
+    slen = sprintf(conv_str, "%lld", *(long long *)bind->buffer);
+  }
+  *textsz = (size_t)slen;
+  return conv_str;
+}
 
-    /* https://www.sqlite.org/c3ref/bind_blob.html */
-    if(sqlite3_bind_text(sqlite_stmt,
-                         col_idx_i,
-                         s,
-                         bind_len,
-                         SQLITE_TRANSIENT) != SQLITE_OK){
-      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
-    }
-  }
+/**
+ * Check if a column result uses a buffer with a native data type instead
+ * of a string.
+ *
+ * @param[in] bind Result bind structure for the column.
+ * @retval 1 Integer, floating point, or timestamp buffer.
+ * @retval 0 String or binary buffer.
+ */
+static int
+sqldbal_mariadb_is_native_bind(const MYSQL_BIND *const bind){
+  return bind->buffer_type == MYSQL_TYPE_LONGLONG ||
+         bind->buffer_type == MYSQL_TYPE_DOUBLE ||
+         bind->buffer_type == MYSQL_TYPE_DATETIME;
 }
 
 /**
- * Assign a NULL value to a prepared statement placeholder.
+ * Get the column result as blob/binary data.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] blob    Binary data.
+ * @param[out] blobsz  Number of bytes in @p blob.
  */
 static void
-sqldbal_sqlite_stmt_bind_null(struct sqldbal_stmt *const stmt,
-                              size_t col_idx){
-  sqlite3_stmt *sqlite_stmt;
-  int col_idx_i;
+sqldbal_mariadb_stmt_column_blob(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 const void **blob,
+                                 size_t *blobsz){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
 
-  sqlite_stmt = stmt->handle;
+  mariadb_stmt = stmt->handle;
 
-  if(sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  if(mariadb_stmt->bind_in_null_list[col_idx] ||
+     sqldbal_mariadb_stmt_column_load(stmt, col_idx)){
+    *blob   = NULL;
+    *blobsz = 0;
+  }
+  else if(sqldbal_mariadb_is_native_bind(
+            &mariadb_stmt->bind_in_list[col_idx])){
+    *blob = sqldbal_mariadb_stmt_column_conv_str(stmt, col_idx, blobsz);
   }
   else{
-    /* https://www.sqlite.org/c3ref/bind_blob.html */
-    if(sqlite3_bind_null(sqlite_stmt,
-                         col_idx_i) != SQLITE_OK){
-      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
-    }
+    *blob   = mariadb_stmt->bind_in_list[col_idx].buffer;
+    *blobsz = mariadb_stmt->bind_in_length_list[col_idx];
   }
 }
 
 /**
- * Pause between SQLITE_BUSY results.
- */
-static void
-sqldbal_sqlite_busy_sleep(void){
-  struct timeval timeout;
-
-  timeout.tv_sec = 0;
-  timeout.tv_usec = 10000;
-  select(0, NULL, NULL, NULL, &timeout);
-}
-
-/**
- * Execute a compiled statement with bound parameters.
+ * Copy part of the column result into a buffer.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
+ * Values that did not fit in the fetch buffer get read from the client
+ * library with mysql_stmt_fetch_column at @p offset, so only @p bufsz bytes
+ * get copied at a time.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[in]  offset  Read the bytes starting at this position.
+ * @param[out] buf     Buffer receiving the bytes.
+ * @param[in]  bufsz   Maximum number of bytes to read.
+ * @param[out] len     Number of bytes read.
  */
 static void
-sqldbal_sqlite_stmt_execute(struct sqldbal_stmt *const stmt){
-  sqlite3_stmt *sqlite_stmt;
-  int step_rc;
-  unsigned int num_retries;
-  unsigned int retry_execute;
-
-  sqlite_stmt = stmt->handle;
+sqldbal_mariadb_stmt_column_blob_read(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      uint64_t offset,
+                                      void *const buf,
+                                      size_t bufsz,
+                                      size_t *const len){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  MYSQL_BIND chunk_bind;
+  unsigned long chunk_length;
+  unsigned long length;
+  unsigned int fieldnr;
+  const char *text;
+  size_t textsz;
 
-  num_retries = 0;
-  do{
-    retry_execute = 0;
+  mariadb_stmt = stmt->handle;
+  length = mariadb_stmt->bind_in_length_list[col_idx];
+  *len = 0;
 
-    /* https://www.sqlite.org/c3ref/step.html */
-    step_rc = sqlite3_step(sqlite_stmt);
-    if(step_rc == SQLITE_DONE || step_rc == SQLITE_ROW){
-      /* https://www.sqlite.org/c3ref/reset.html */
-      if(sqlite3_reset(sqlite_stmt) != SQLITE_OK){
-        sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_EXEC);
-      }
+  if(mariadb_stmt->bind_in_null_list[col_idx]){
+    /* Nothing to read. */
+  }
+  else if(sqldbal_mariadb_is_native_bind(
+            &mariadb_stmt->bind_in_list[col_idx])){
+    text = sqldbal_mariadb_stmt_column_conv_str(stmt, col_idx, &textsz);
+    sqldbal_blob_copy(text, textsz, offset, buf, bufsz, len);
+  }
+  else if(sqldbal_mariadb_stmt_column_truncated(mariadb_stmt,
+                                                col_idx) == 0){
+    sqldbal_blob_copy(mariadb_stmt->bind_in_list[col_idx].buffer,
+                      length,
+                      offset,
+                      buf,
+                      bufsz,
+                      len);
+  }
+  else if(offset < length){
+    chunk_length = length - (unsigned long)offset;
+    if(chunk_length > bufsz){
+      chunk_length = (unsigned long)bufsz;
+    }
+    if(si_size_to_uint(col_idx, &fieldnr)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
     }
-    else if(step_rc == SQLITE_BUSY){
-      if(num_retries < SQLDBAL_SQLITE_MAX_NUM_RETRIES){
-        sqldbal_sqlite_busy_sleep();
-        num_retries += 1;
-        retry_execute = 1;
+    else{
+      memset(&chunk_bind, 0, sizeof(chunk_bind));
+      chunk_bind.buffer_type   = MYSQL_TYPE_BLOB;
+      chunk_bind.buffer        = buf;
+      chunk_bind.buffer_length = chunk_length;
+      chunk_bind.length        = &length;
+
+      /* https://mariadb.com/kb/en/mysql_stmt_fetch_column */
+      if(mysql_stmt_fetch_column(mariadb_stmt->stmt,
+                                 &chunk_bind,
+                                 fieldnr,
+                                 (unsigned long)offset)){
+        sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_FETCH);
       }
       else{
-        sqldbal_sqlite_error(stmt->db, step_rc, SQLDBAL_STATUS_EXEC);
+        *len = chunk_length;
       }
     }
-    else{
-      sqldbal_sqlite_error(stmt->db, step_rc, SQLDBAL_STATUS_EXEC);
-    }
-  } while(retry_execute);
+  }
 }
 
 /**
- * Get the next row in the result set.
+ * Get the column result as a 64-bit integer.
  *
- * @param[in] stmt See @ref sqldbal_stmt.
- * @return See @ref sqldbal_fetch_result.
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] i64     64-bit integer.
  */
-static enum sqldbal_fetch_result
-sqldbal_sqlite_stmt_fetch(struct sqldbal_stmt *const stmt){
-  int step_rc;
-  sqlite3_stmt *sqlite_stmt;
-  unsigned int num_retries;
-  unsigned int retry_execute;
-  enum sqldbal_fetch_result fetch_result;
-
-  sqlite_stmt = stmt->handle;
-  num_retries = 0;
+static void
+sqldbal_mariadb_stmt_column_int64(struct sqldbal_stmt *const stmt,
+                                  size_t col_idx,
+                                  int64_t *i64){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  const MYSQL_BIND *bind;
+  unsigned long long ull;
+  const char *text;
+  size_t textsz;
 
-  fetch_result = SQLDBAL_FETCH_ERROR;
-  do{
-    retry_execute = 0;
+  mariadb_stmt = stmt->handle;
+  bind = &mariadb_stmt->bind_in_list[col_idx];
 
-    /* https://www.sqlite.org/c3ref/step.html */
-    step_rc = sqlite3_step(sqlite_stmt);
-    if(step_rc == SQLITE_ROW){
-      fetch_result = SQLDBAL_FETCH_ROW;
-    }
-    else if(step_rc == SQLITE_DONE){
-      fetch_result = SQLDBAL_FETCH_DONE;
-    }
-    else if(step_rc == SQLITE_BUSY){
-      if(num_retries < SQLDBAL_SQLITE_MAX_NUM_RETRIES){
-        sqldbal_sqlite_busy_sleep();
-        num_retries += 1;
-        retry_execute = 1;
+  if(mariadb_stmt->bind_in_null_list[col_idx] ||
+     sqldbal_mariadb_stmt_column_load(stmt, col_idx)){
+    *i64 = 0;
+  }
+  else if(bind->buffer_type == MYSQL_TYPE_LONGLONG){
+    if(bind->is_unsigned){
+      ull = *(unsigned long long *)bind->buffer;
+      if(ull > INT64_MAX){
+        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+        *i64 = 0;
       }
       else{
-        sqldbal_sqlite_error(stmt->db, step_rc, SQLDBAL_STATUS_FETCH);
+        *i64 = (int64_t)ull;
       }
     }
-    else{
-      sqldbal_sqlite_error(stmt->db, step_rc, SQLDBAL_STATUS_FETCH);
+    else if(si_llong_to_int64(*(long long *)bind->buffer, i64)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+      *i64 = 0;
     }
-  } while(retry_execute);
-
-  return fetch_result;
+  }
+  else if(sqldbal_mariadb_is_native_bind(bind)){
+    text = sqldbal_mariadb_stmt_column_conv_str(stmt, col_idx, &textsz);
+    sqldbal_strtoi64(stmt->db, text, i64);
+  }
+  else{
+    sqldbal_strtoi64(stmt->db, bind->buffer, i64);
+  }
 }
 
 /**
- * Get the column result as blob/binary data.
+ * Get the column result as a double-precision floating point number.
  *
  * @param[in]  stmt    See @ref sqldbal_stmt.
  * @param[in]  col_idx Column index.
- * @param[out] blob    Binary data.
- * @param[out] blobsz  Number of bytes in @p blob.
+ * @param[out] d       Floating point number.
  */
 static void
-sqldbal_sqlite_stmt_column_blob(struct sqldbal_stmt *const stmt,
-                                size_t col_idx,
-                                const void **blob,
-                                size_t *blobsz){
-  sqlite3_stmt *sqlite_stmt;
-  int col_no_i;
-  int col_bytes;
+sqldbal_mariadb_stmt_column_double(struct sqldbal_stmt *const stmt,
+                                   size_t col_idx,
+                                   double *d){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  const MYSQL_BIND *bind;
+  const char *text;
+  size_t textsz;
 
-  sqlite_stmt = stmt->handle;
+  mariadb_stmt = stmt->handle;
+  bind = &mariadb_stmt->bind_in_list[col_idx];
 
-  if(si_size_to_int(col_idx, &col_no_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  if(mariadb_stmt->bind_in_null_list[col_idx] ||
+     sqldbal_mariadb_stmt_column_load(stmt, col_idx)){
+    *d = 0;
   }
-  else{
-    /* https://www.sqlite.org/c3ref/column_blob.html */
-    col_bytes = sqlite3_column_bytes(sqlite_stmt, col_no_i);
-    *blob = sqlite3_column_blob(sqlite_stmt, col_no_i);
-
-    if(si_int_to_size(col_bytes, blobsz)){
-      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  else if(bind->buffer_type == MYSQL_TYPE_DOUBLE){
+    *d = *(double *)bind->buffer;
+  }
+  else if(bind->buffer_type == MYSQL_TYPE_LONGLONG){
+    if(bind->is_unsigned){
+      *d = (double)*(unsigned long long *)bind->buffer;
     }
     else{
-      if(*blobsz && *blob == NULL){
-        sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_NOMEM);
-      }
+      *d = (double)*(long long *)bind->buffer;
     }
   }
+  else if(bind->buffer_type == MYSQL_TYPE_DATETIME){
+    text = sqldbal_mariadb_stmt_column_conv_str(stmt, col_idx, &textsz);
+    sqldbal_strtod(stmt->db, text, d);
+  }
+  else{
+    sqldbal_strtod(stmt->db, bind->buffer, d);
+  }
 }
 
 /**
- * Get the column result as a 64-bit integer.
+ * Get the column result as a timestamp.
+ *
+ * MariaDB DATETIME values do not have a time zone, so they get treated as
+ * UTC.
  *
  * @param[in]  stmt    See @ref sqldbal_stmt.
  * @param[in]  col_idx Column index.
- * @param[out] i64     64-bit integer.
+ * @param[out] ts      Microseconds since 1970-01-01 00:00:00 UTC.
  */
 static void
-sqldbal_sqlite_stmt_column_int64(struct sqldbal_stmt *const stmt,
-                                 size_t col_idx,
-                                 int64_t *i64){
-  sqlite3_stmt *sqlite_stmt;
-  int col_no_i;
+sqldbal_mariadb_stmt_column_timestamp(struct sqldbal_stmt *const stmt,
+                                      size_t col_idx,
+                                      int64_t *ts){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  const MYSQL_BIND *bind;
+  const MYSQL_TIME *mysql_tm;
+  struct sqldbal_tm tm;
+  const char *text;
+  size_t textsz;
 
-  if(si_size_to_int(col_idx, &col_no_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  mariadb_stmt = stmt->handle;
+  bind = &mariadb_stmt->bind_in_list[col_idx];
+
+  if(mariadb_stmt->bind_in_null_list[col_idx] ||
+     sqldbal_mariadb_stmt_column_load(stmt, col_idx)){
+    *ts = 0;
+  }
+  else if(bind->buffer_type == MYSQL_TYPE_DATETIME){
+    mysql_tm = bind->buffer;
+    /* Reject zero dates such as 0000-00-00. */
+    if(mysql_tm->month < 1 || mysql_tm->month > 12 || mysql_tm->day < 1){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+      *ts = 0;
+    }
+    else{
+      tm.year   = mysql_tm->year;
+      tm.month  = mysql_tm->month;
+      tm.day    = mysql_tm->day;
+      tm.hour   = mysql_tm->hour;
+      tm.minute = mysql_tm->minute;
+      tm.second = mysql_tm->second;
+      tm.usec   = (unsigned int)mysql_tm->second_part;
+      *ts = sqldbal_tm_to_timestamp(&tm);
+    }
+  }
+  else if(sqldbal_mariadb_is_native_bind(bind)){
+    text = sqldbal_mariadb_stmt_column_conv_str(stmt, col_idx, &textsz);
+    sqldbal_strtotimestamp(stmt->db, text, ts);
   }
   else{
-    sqlite_stmt = stmt->handle;
-
-    /* https://www.sqlite.org/c3ref/column_blob.html */
-    *i64 = sqlite3_column_int64(sqlite_stmt, col_no_i);
+    sqldbal_strtotimestamp(stmt->db, bind->buffer, ts);
   }
 }
 
@@ -4026,35 +5940,26 @@ sqldbal_sqlite_stmt_column_int64(struct sqldbal_stmt *const stmt,
  * @param[out] textsz  Number of bytes in @p text.
  */
 static void
-sqldbal_sqlite_stmt_column_text(struct sqldbal_stmt *const stmt,
-                                size_t col_idx,
-                                const char **text,
-                                size_t *textsz){
-  sqlite3_stmt *sqlite_stmt;
-  int col_no_i;
-  int col_bytes;
+sqldbal_mariadb_stmt_column_text(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 const char **text,
+                                 size_t *textsz){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
 
-  if(si_size_to_int(col_idx, &col_no_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  mariadb_stmt = stmt->handle;
+
+  if(mariadb_stmt->bind_in_null_list[col_idx] ||
+     sqldbal_mariadb_stmt_column_load(stmt, col_idx)){
+    *text   = NULL;
+    *textsz = 0;
+  }
+  else if(sqldbal_mariadb_is_native_bind(
+            &mariadb_stmt->bind_in_list[col_idx])){
+    *text = sqldbal_mariadb_stmt_column_conv_str(stmt, col_idx, textsz);
   }
   else{
-    sqlite_stmt = stmt->handle;
-
-    /* https://www.sqlite.org/c3ref/column_blob.html */
-    col_bytes = sqlite3_column_bytes(sqlite_stmt, col_no_i);
-    *text = (const char*)sqlite3_column_text(sqlite_stmt, col_no_i);
-
-    if(si_int_to_size(col_bytes, textsz)){
-      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
-    }
-    else{
-      if(*textsz){
-        *textsz -= 1;
-        if(*text == NULL){
-          sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_NOMEM);
-        }
-      }
-    }
+    *text   = mariadb_stmt->bind_in_list[col_idx].buffer;
+    *textsz = mariadb_stmt->bind_in_length_list[col_idx] - 1;
   }
 }
 
@@ -4066,572 +5971,13464 @@ sqldbal_sqlite_stmt_column_text(struct sqldbal_stmt *const stmt,
  * @return See @ref sqldbal_column_type.
  */
 static enum sqldbal_column_type
-sqldbal_sqlite_stmt_column_type(struct sqldbal_stmt *const stmt,
-                                size_t col_idx){
-  sqlite3_stmt *sqlite_stmt;
-  enum sqldbal_column_type col_type;
-  int sqlite_col_type;
-  int col_no_i;
+sqldbal_mariadb_stmt_column_type(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx){
+  enum sqldbal_column_type type;
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
 
-  if(si_size_to_int(col_idx, &col_no_i)){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
-    col_type = SQLDBAL_TYPE_ERROR;
+  mariadb_stmt = stmt->handle;
+  if(mariadb_stmt->bind_in_null_list[col_idx]){
+    type = SQLDBAL_TYPE_NULL;
   }
   else{
-    sqlite_stmt = stmt->handle;
-
-    /* https://www.sqlite.org/c3ref/column_blob.html */
-    sqlite_col_type = sqlite3_column_type(sqlite_stmt, col_no_i);
+    type = mariadb_stmt->bind_in_column_list[col_idx].type;
+  }
+  return type;
+}
 
-    switch(sqlite_col_type){
-      case SQLITE_INTEGER:
-        col_type = SQLDBAL_TYPE_INT;
-        break;
-      case SQLITE_TEXT:
-        col_type = SQLDBAL_TYPE_TEXT;
-        break;
-      case SQLITE_BLOB:
-        col_type = SQLDBAL_TYPE_BLOB;
-        break;
-      case SQLITE_NULL:
-        col_type = SQLDBAL_TYPE_NULL;
-        break;
-      default:
-        col_type = SQLDBAL_TYPE_OTHER;
-        break;
+/**
+ * Discard unread rows and set every placeholder back to NULL.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_mariadb_stmt_reset(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  size_t i;
+
+  mariadb_stmt = stmt->handle;
+
+  /* https://mariadb.com/kb/en/mysql_stmt_free_result */
+  if(mysql_stmt_free_result(mariadb_stmt->stmt)){
+    sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
+  }
+  mariadb_stmt->stored_result = 0;
+
+  /* Discard chunks sent for an execution that did not happen. */
+  if(mariadb_stmt->long_data){
+    mariadb_stmt->long_data = 0;
+    /* https://mariadb.com/kb/en/mysql_stmt_reset */
+    if(mysql_stmt_reset(mariadb_stmt->stmt)){
+      sqldbal_mariadb_stmt_error(stmt, SQLDBAL_STATUS_EXEC);
     }
   }
-  return col_type;
+  for(i = 0; i < stmt->num_params; i++){
+    sqldbal_mariadb_stmt_bind_null(stmt, i);
+  }
 }
 
 /**
- * Free prepared statement resources.
+ * Free a prepared statement resource.
  *
  * @param[in] stmt See @ref sqldbal_stmt.
  */
 static void
-sqldbal_sqlite_stmt_close(struct sqldbal_stmt *const stmt){
-  sqlite3_stmt *sqlite_stmt;
+sqldbal_mariadb_stmt_close(struct sqldbal_stmt *const stmt){
+  struct sqldbal_mariadb_stmt *mariadb_stmt;
+  size_t i;
 
-  sqlite_stmt = stmt->handle;
+  mariadb_stmt = stmt->handle;
 
-  /* https://www.sqlite.org/c3ref/finalize.html */
-  if(sqlite3_finalize(sqlite_stmt) != SQLITE_OK){
-    sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_CLOSE);
-  }
-}
+  if(mariadb_stmt){
+    if(mariadb_stmt->param_list){
+      for(i = 0; i < stmt->num_params; i++){
+        free(mariadb_stmt->param_list[i].buf);
+      }
+      free(mariadb_stmt->param_list);
+    }
 
-#endif /* SQLDBAL_SQLITE */
+    free(mariadb_stmt->bind_out);
 
-enum sqldbal_status_code
-sqldbal_status_code_get(const struct sqldbal_db *const db){
-  return db->status_code;
+    sqldbal_mariadb_stmt_free_bind_in_list(stmt);
+
+    /* https://mariadb.com/kb/en/mysql_stmt_close */
+    if(mariadb_stmt->stmt){
+      mysql_stmt_close(mariadb_stmt->stmt);
+    }
+    free(mariadb_stmt);
+  }
 }
 
-enum sqldbal_status_code
-sqldbal_status_code_clear(struct sqldbal_db *const db){
-  enum sqldbal_status_code status;
+#endif /* SQLDBAL_MARIADB */
 
-  status = sqldbal_status_code_get(db);
-  sqldbal_status_code_set(db, SQLDBAL_STATUS_OK);
-  return status;
-}
+#ifdef SQLDBAL_POSTGRESQL
 
-enum sqldbal_driver
-sqldbal_driver_type(const struct sqldbal_db *const db){
-  return db->type;
-}
+#include <libpq-fe.h>
+#include <libpq/libpq-fs.h>
+#include <pg_config.h>
 
-enum sqldbal_status_code
-sqldbal_errstr(const struct sqldbal_db *const db,
-               const char **errstr){
-  enum sqldbal_status_code status;
-  const char *const sqldbal_errstr_list[] = {
-    /* SQLDBAL_STATUS_OK */
-    "Success",
-    /* SQLDBAL_STATUS_PARAM */
-    "Invalid parameter",
-    /* SQLDBAL_STATUS_NOMEM */
-    "Memory allocation failed",
-    /* SQLDBAL_STATUS_OVERFLOW */
-    "Overflow/wrap/conversion",
-    /* SQLDBAL_STATUS_EXEC */
-    "Failed to execute SQL statement",
-    /* SQLDBAL_STATUS_PREPARE */
-    "Failed to prepare statement",
-    /* SQLDBAL_STATUS_BIND */
-    "Failed to bind parameter",
-    /* SQLDBAL_STATUS_FETCH */
-    "Failed to fetch next statement result",
-    /* SQLDBAL_STATUS_COLUMN_COERCE */
-    "Error coercing the requested column value",
-    /* SQLDBAL_STATUS_DRIVER_NOSUPPORT */
-    "Driver not supported",
-    /* SQLDBAL_STATUS_OPEN */
-    "Failed to open database context",
-    /* SQLDBAL_STATUS_CLOSE */
-    "Failed to close database context",
-    /* SQLDBAL_STATUS__LAST */
-    "Unknown error"
-  };
+#if PG_VERSION_NUM >= 90600
+/**
+ * PostgreSQL did not add the PQsetErrorContextVisibility function until
+ * version 9.6.
+ */
+# define SQLDBAL_PQ_HAS_ERROR_CONTEXT_VISIBILITY
+#endif /* PG_VERSION_NUM >= 90600 */
 
-  status = sqldbal_status_code_get(db);
-  if(db->errstr){
-    *errstr = db->errstr;
-  }
-  else{
-    if((unsigned)status >= SQLDBAL_STATUS__LAST){
-      status = SQLDBAL_STATUS__LAST;
-    }
-    *errstr = sqldbal_errstr_list[status];
-  }
-  return status;
-}
+#ifdef __SSE2__
+/**
+ * Decode hexadecimal bytea values 32 characters at a time using SSE2.
+ *
+ * SSE2 always exists on x86-64, so the compiler flag alone selects this
+ * path without having to detect the processor features at runtime.
+ */
+# define SQLDBAL_PQ_HAS_SSE2
+# include <emmintrin.h>
+#endif /* __SSE2__ */
 
 /**
- * This error structure used for the single error case where we cannot
- * initially allocate memory.
+ * Data types which have a binary format that the PostgreSQL driver can
+ * send or decode.
  *
- * This makes it easier to propagate any error codes when calling
- * other external header functions because the caller will always
- * get a valid SQLDBAL structure returned.
- */
-static struct sqldbal_db g_db_error = {
-  NULL,                        /* errstr                       */
-  NULL,                        /* handle                       */
-  {                            /* functions                    */
-    NULL,                      /* sqldbal_fp_open              */
-    NULL,                      /* sqldbal_fp_close             */
-    NULL,                      /* sqldbal_fp_db_handle         */
-    NULL,                      /* sqldbal_fp_stmt_handle       */
-    NULL,                      /* sqldbal_fp_begin_transaction */
-    NULL,                      /* sqldbal_fp_commit            */
-    NULL,                      /* sqldbal_fp_rollback          */
-    NULL,                      /* sqldbal_fp_exec              */
-    NULL,                      /* sqldbal_fp_last_insert_id    */
-    NULL,                      /* sqldbal_fp_stmt_prepare      */
-    NULL,                      /* sqldbal_fp_stmt_bind_blob    */
-    NULL,                      /* sqldbal_fp_stmt_bind_int64   */
-    NULL,                      /* sqldbal_fp_stmt_bind_text    */
-    NULL,                      /* sqldbal_fp_stmt_bind_null    */
-    NULL,                      /* sqldbal_fp_stmt_execute      */
-    NULL,                      /* sqldbal_fp_stmt_fetch        */
-    NULL,                      /* sqldbal_fp_stmt_column_blob  */
-    NULL,                      /* sqldbal_fp_stmt_column_int64 */
-    NULL,                      /* sqldbal_fp_stmt_column_text  */
-    NULL,                      /* sqldbal_fp_stmt_column_type  */
-    NULL,                      /* sqldbal_fp_stmt_close        */
-  },                           /* functions                    */
-  SQLDBAL_STATUS_NOMEM,        /* status_code                  */
-  SQLDBAL_DRIVER_INVALID,      /* type                         */
-  SQLDBAL_FLAG_INVALID_MEMORY  /* flags                        */
-};
+ * See @ref SQLDBAL_FLAG_PQ_BINARY.
+ */
+enum sqldbal_pq_type{
+  /**
+   * Any other data type, which must use the text format.
+   */
+  SQLDBAL_PQ_TYPE_OTHER,
 
-enum sqldbal_status_code
-sqldbal_open(enum sqldbal_driver driver,
-             const char *const location,
-             const char *const port,
-             const char *const username,
-             const char *const password,
-             const char *const database,
-             const unsigned long flags,
-             const struct sqldbal_driver_option *const option_list,
-             size_t num_options,
-             struct sqldbal_db **db){
-  struct sqldbal_db *new_db;
-  struct sqldbal_driver_functions *func;
-  int found_driver;
+  /**
+   * 2-byte integer (int2).
+   */
+  SQLDBAL_PQ_TYPE_INT2,
 
-  new_db = malloc(sizeof(*new_db));
-  if(new_db == NULL){
-    *db = &g_db_error;
-    sqldbal_status_code_set(*db, SQLDBAL_STATUS_NOMEM);
-  }
-  else{
-    *db = new_db;
+  /**
+   * 4-byte integer (int4).
+   */
+  SQLDBAL_PQ_TYPE_INT4,
 
-    sqldbal_status_code_set(new_db, SQLDBAL_STATUS_OK);
-    new_db->errstr = NULL;
-    new_db->flags = flags;
-    new_db->type = driver;
-    new_db->handle = NULL;
+  /**
+   * 8-byte integer (int8).
+   */
+  SQLDBAL_PQ_TYPE_INT8,
 
-    func = &new_db->functions;
-    found_driver = 0;
-#ifdef SQLDBAL_MARIADB
-    if(driver == SQLDBAL_DRIVER_MARIADB ||
-       driver == SQLDBAL_DRIVER_MYSQL){
-      found_driver = 1;
-      func->sqldbal_fp_open              = sqldbal_mariadb_open;
-      func->sqldbal_fp_close             = sqldbal_mariadb_close;
-      func->sqldbal_fp_db_handle         = sqldbal_mariadb_db_handle;
-      func->sqldbal_fp_stmt_handle       = sqldbal_mariadb_stmt_handle;
-      func->sqldbal_fp_begin_transaction = sqldbal_mariadb_begin_transaction;
-      func->sqldbal_fp_commit            = sqldbal_mariadb_commit;
-      func->sqldbal_fp_rollback          = sqldbal_mariadb_rollback;
-      func->sqldbal_fp_exec              = sqldbal_mariadb_exec;
-      func->sqldbal_fp_last_insert_id    = sqldbal_mariadb_last_insert_id;
-      func->sqldbal_fp_stmt_prepare      = sqldbal_mariadb_stmt_prepare;
-      func->sqldbal_fp_stmt_bind_blob    = sqldbal_mariadb_stmt_bind_blob;
-      func->sqldbal_fp_stmt_bind_int64   = sqldbal_mariadb_stmt_bind_int64;
-      func->sqldbal_fp_stmt_bind_text    = sqldbal_mariadb_stmt_bind_text;
-      func->sqldbal_fp_stmt_bind_null    = sqldbal_mariadb_stmt_bind_null;
-      func->sqldbal_fp_stmt_execute      = sqldbal_mariadb_stmt_execute;
-      func->sqldbal_fp_stmt_fetch        = sqldbal_mariadb_stmt_fetch;
-      func->sqldbal_fp_stmt_column_blob  = sqldbal_mariadb_stmt_column_blob;
-      func->sqldbal_fp_stmt_column_int64 = sqldbal_mariadb_stmt_column_int64;
-      func->sqldbal_fp_stmt_column_text  = sqldbal_mariadb_stmt_column_text;
-      func->sqldbal_fp_stmt_column_type  = sqldbal_mariadb_stmt_column_type;
-      func->sqldbal_fp_stmt_close        = sqldbal_mariadb_stmt_close;
-    }
-#endif /* SQLDBAL_MARIADB */
-#ifdef SQLDBAL_POSTGRESQL
-    if(driver == SQLDBAL_DRIVER_POSTGRESQL){
-      found_driver = 1;
-      func->sqldbal_fp_open              = sqldbal_pq_open;
-      func->sqldbal_fp_close             = sqldbal_pq_close;
-      func->sqldbal_fp_db_handle         = sqldbal_pq_db_handle;
-      func->sqldbal_fp_stmt_handle       = sqldbal_pq_stmt_handle;
-      func->sqldbal_fp_begin_transaction = sqldbal_pq_begin_transaction;
-      func->sqldbal_fp_commit            = sqldbal_pq_commit;
-      func->sqldbal_fp_rollback          = sqldbal_pq_rollback;
-      func->sqldbal_fp_exec              = sqldbal_pq_exec;
-      func->sqldbal_fp_last_insert_id    = sqldbal_pq_last_insert_id;
-      func->sqldbal_fp_stmt_prepare      = sqldbal_pq_stmt_prepare;
-      func->sqldbal_fp_stmt_bind_blob    = sqldbal_pq_stmt_bind_blob;
-      func->sqldbal_fp_stmt_bind_int64   = sqldbal_pq_stmt_bind_int64;
-      func->sqldbal_fp_stmt_bind_text    = sqldbal_pq_stmt_bind_text;
-      func->sqldbal_fp_stmt_bind_null    = sqldbal_pq_stmt_bind_null;
-      func->sqldbal_fp_stmt_execute      = sqldbal_pq_stmt_execute;
-      func->sqldbal_fp_stmt_fetch        = sqldbal_pq_stmt_fetch;
-      func->sqldbal_fp_stmt_column_blob  = sqldbal_pq_stmt_column_blob;
-      func->sqldbal_fp_stmt_column_int64 = sqldbal_pq_stmt_column_int64;
-      func->sqldbal_fp_stmt_column_text  = sqldbal_pq_stmt_column_text;
-      func->sqldbal_fp_stmt_column_type  = sqldbal_pq_stmt_column_type;
-      func->sqldbal_fp_stmt_close        = sqldbal_pq_stmt_close;
-    }
-#endif /* SQLDBAL_POSTGRESQL */
-#ifdef SQLDBAL_SQLITE
-    if(driver == SQLDBAL_DRIVER_SQLITE){
-      found_driver = 1;
-      func->sqldbal_fp_open              = sqldbal_sqlite_open;
-      func->sqldbal_fp_close             = sqldbal_sqlite_close;
-      func->sqldbal_fp_db_handle         = sqldbal_sqlite_db_handle;
-      func->sqldbal_fp_stmt_handle       = sqldbal_sqlite_stmt_handle;
-      func->sqldbal_fp_begin_transaction = sqldbal_sqlite_begin_transaction;
-      func->sqldbal_fp_commit            = sqldbal_sqlite_commit;
-      func->sqldbal_fp_rollback          = sqldbal_sqlite_rollback;
-      func->sqldbal_fp_exec              = sqldbal_sqlite_exec;
-      func->sqldbal_fp_last_insert_id    = sqldbal_sqlite_last_insert_id;
-      func->sqldbal_fp_stmt_prepare      = sqldbal_sqlite_stmt_prepare;
-      func->sqldbal_fp_stmt_bind_blob    = sqldbal_sqlite_stmt_bind_blob;
-      func->sqldbal_fp_stmt_bind_int64   = sqldbal_sqlite_stmt_bind_int64;
-      func->sqldbal_fp_stmt_bind_text    = sqldbal_sqlite_stmt_bind_text;
-      func->sqldbal_fp_stmt_bind_null    = sqldbal_sqlite_stmt_bind_null;
-      func->sqldbal_fp_stmt_execute      = sqldbal_sqlite_stmt_execute;
-      func->sqldbal_fp_stmt_fetch        = sqldbal_sqlite_stmt_fetch;
-      func->sqldbal_fp_stmt_column_blob  = sqldbal_sqlite_stmt_column_blob;
-      func->sqldbal_fp_stmt_column_int64 = sqldbal_sqlite_stmt_column_int64;
-      func->sqldbal_fp_stmt_column_text  = sqldbal_sqlite_stmt_column_text;
-      func->sqldbal_fp_stmt_column_type  = sqldbal_sqlite_stmt_column_type;
-      func->sqldbal_fp_stmt_close        = sqldbal_sqlite_stmt_close;
-    }
-#endif /* SQLDBAL_SQLITE */
+  /**
+   * Binary data (bytea).
+   */
+  SQLDBAL_PQ_TYPE_BYTEA,
 
-    if(!found_driver){
-      sqldbal_status_code_set(new_db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
-    }
-    else{
-      new_db->functions.sqldbal_fp_open(new_db,
-                                        location,
-                                        port,
-                                        username,
-                                        password,
-                                        database,
-                                        option_list,
-                                        num_options);
-    }
-  }
-  return sqldbal_status_code_get(*db);
-}
+  /**
+   * Character types which have the same binary and text format (text,
+   * varchar, bpchar, name).
+   */
+  SQLDBAL_PQ_TYPE_TEXT,
 
-enum sqldbal_status_code
-sqldbal_close(struct sqldbal_db *db){
-  enum sqldbal_status_code status;
+  /**
+   * Boolean (bool).
+   */
+  SQLDBAL_PQ_TYPE_BOOL,
 
-  status = sqldbal_status_code_get(db);
-  if((db->flags & SQLDBAL_FLAG_INVALID_MEMORY) == 0){
-    if(status != SQLDBAL_STATUS_DRIVER_NOSUPPORT){
-      db->functions.sqldbal_fp_close(db);
-      if(status == SQLDBAL_STATUS_OK){
-        status = sqldbal_status_code_get(db);
-      }
-    }
-    if(status != SQLDBAL_STATUS_CLOSE){
-      free(db->errstr);
-      free(db);
-    }
-  }
-  return status;
-}
+  /**
+   * Single-precision floating point number (float4).
+   */
+  SQLDBAL_PQ_TYPE_FLOAT4,
 
-void *
-sqldbal_db_handle(const struct sqldbal_db *const db){
-  return db->functions.sqldbal_fp_db_handle(db);
-}
+  /**
+   * Double-precision floating point number (float8).
+   */
+  SQLDBAL_PQ_TYPE_FLOAT8,
 
-void *
-sqldbal_stmt_handle(const struct sqldbal_stmt *const stmt){
-  return stmt->db->functions.sqldbal_fp_stmt_handle(stmt);
-}
+  /**
+   * Calendar date (date).
+   */
+  SQLDBAL_PQ_TYPE_DATE,
 
-enum sqldbal_status_code
-sqldbal_begin_transaction(struct sqldbal_db *const db){
-  db->functions.sqldbal_fp_begin_transaction(db);
-  return sqldbal_status_code_get(db);
-}
+  /**
+   * Timestamp without time zone (timestamp).
+   */
+  SQLDBAL_PQ_TYPE_TIMESTAMP,
 
-enum sqldbal_status_code
-sqldbal_commit(struct sqldbal_db *const db){
-  db->functions.sqldbal_fp_commit(db);
-  return sqldbal_status_code_get(db);
-}
+  /**
+   * Timestamp with time zone (timestamptz), which the server sends in UTC
+   * when using the binary format.
+   */
+  SQLDBAL_PQ_TYPE_TIMESTAMPTZ
+};
 
-enum sqldbal_status_code
-sqldbal_rollback(struct sqldbal_db *const db){
-  db->functions.sqldbal_fp_rollback(db);
-  return sqldbal_status_code_get(db);
-}
+/*
+ * Oid values of the built-in data types. PostgreSQL assigns these in the
+ * system catalog (pg_type.dat) and never changes them between releases,
+ * so the driver does not need to query the pg_type table.
+ */
 
-enum sqldbal_status_code
-sqldbal_exec(struct sqldbal_db *const db,
-             const char *const sql,
-             sqldbal_exec_callback_fp callback,
-             void *user_data){
-  db->functions.sqldbal_fp_exec(db, sql, callback, user_data);
-  return sqldbal_status_code_get(db);
-}
+/**
+ * Oid of the bool data type.
+ */
+#define SQLDBAL_PQ_OID_BOOL    16
 
-enum sqldbal_status_code
-sqldbal_last_insert_id(struct sqldbal_db *const db,
-                       const char *const name,
-                       uint64_t *insert_id){
-  db->functions.sqldbal_fp_last_insert_id(db, name, insert_id);
-  return sqldbal_status_code_get(db);
+/**
+ * Oid of the bytea data type.
+ */
+#define SQLDBAL_PQ_OID_BYTEA   17
+
+/**
+ * Oid of the name data type.
+ */
+#define SQLDBAL_PQ_OID_NAME    19
+
+/**
+ * Oid of the int8 data type.
+ */
+#define SQLDBAL_PQ_OID_INT8    20
+
+/**
+ * Oid of the int2 data type.
+ */
+#define SQLDBAL_PQ_OID_INT2    21
+
+/**
+ * Oid of the int4 data type.
+ */
+#define SQLDBAL_PQ_OID_INT4    23
+
+/**
+ * Oid of the text data type.
+ */
+#define SQLDBAL_PQ_OID_TEXT    25
+
+/**
+ * Oid of the float4 data type.
+ */
+#define SQLDBAL_PQ_OID_FLOAT4  700
+
+/**
+ * Oid of the float8 data type.
+ */
+#define SQLDBAL_PQ_OID_FLOAT8  701
+
+/**
+ * Oid of the bpchar data type.
+ */
+#define SQLDBAL_PQ_OID_BPCHAR  1042
+
+/**
+ * Oid of the varchar data type.
+ */
+#define SQLDBAL_PQ_OID_VARCHAR 1043
+
+/**
+ * Oid of the date data type.
+ */
+#define SQLDBAL_PQ_OID_DATE    1082
+
+/**
+ * Oid of the timestamp data type.
+ */
+#define SQLDBAL_PQ_OID_TIMESTAMP 1114
+
+/**
+ * Oid of the timestamptz data type.
+ */
+#define SQLDBAL_PQ_OID_TIMESTAMPTZ 1184
+
+/**
+ * Number of days between 1970-01-01 and 2000-01-01, which PostgreSQL uses
+ * as the epoch for the binary date and timestamp formats.
+ */
+#define SQLDBAL_PQ_EPOCH_DAYS INT64_C(10957)
+
+/**
+ * Driver-specific database handle for PostgreSQL.
+ */
+struct sqldbal_pq_db{
+  /**
+   * PostgreSQL database connection object.
+   */
+  PGconn *db;
+
+  /**
+   * Increments when a new SQL statement gets prepared.
+   */
+  unsigned long stmt_counter;
+
+  /**
+   * Statements queued in pipeline mode, in the order the server returns
+   * their results. NULL entries belong to commands without a statement.
+   */
+  struct sqldbal_stmt **pipeline_list;
+
+  /**
+   * Number of entries in @ref pipeline_list.
+   */
+  size_t pipeline_len;
+
+  /**
+   * Number of entries allocated in @ref pipeline_list.
+   */
+  size_t pipeline_size;
+};
+
+/**
+ * Driver-specific compiled statement handle for PostgreSQL.
+ */
+struct sqldbal_pq_stmt{
+  /**
+   * Unique statement name in the current session.
+   */
+  char *name;
+
+  /**
+   * Parameter values to send with the query, pointing either into
+   * @ref param_buf_list or to a value bound without copying.
+   */
+  const char **param_value_list;
+
+  /**
+   * Copies of the bound parameter values. Each buffer gets reused by later
+   * binds and only grows when a value does not fit.
+   */
+  char **param_buf_list;
+
+  /**
+   * Number of bytes allocated for each buffer in @ref param_buf_list.
+   */
+  size_t *param_buf_size_list;
+
+  /**
+   * Length of binary data in @ref param_value_list.
+   */
+  int *param_length_list;
+
+  /**
+   * Indicates if the corresponding parameter in @ref param_value_list has
+   * a text (0) or binary (1) format.
+   */
+  int *param_format_list;
+
+  /**
+   * Data type of each parameter in @ref param_value_list.
+   */
+  enum sqldbal_pq_type *param_type_list;
+
+  /**
+   * Data type of each column in the prepared statement results.
+   */
+  enum sqldbal_pq_type *column_type_list;
+
+  /**
+   * Number of elements in @ref column_type_list.
+   */
+  size_t num_column_types;
+
+  /**
+   * Stores the decoded bytea column values in the prepared statement
+   * results. Each buffer gets reused by later rows and only grows when a
+   * value does not fit.
+   */
+  char **column_value_list;
+
+  /**
+   * Number of bytes allocated for each buffer in @ref column_value_list.
+   */
+  size_t *column_value_size_list;
+
+  /**
+   * Buffer with @ref SQLDBAL_CONV_STR_SZ bytes for each column, used to
+   * convert binary integer, floating point, boolean, and timestamp results
+   * to strings.
+   */
+  char *column_conv_str_list;
+
+  /**
+   * Store the result of the prepared statement.
+   */
+  PGresult *exec_result;
+
+  /**
+   * Number of rows returned in @ref exec_result.
+   */
+  int exec_row_count;
+
+  /**
+   * Current row to fetch from @ref exec_result.
+   */
+  int fetch_row_index;
+
+  /**
+   * Set to 1 if streaming the results and the connection still has more
+   * results to read for this statement.
+   *
+   * See @ref SQLDBAL_FLAG_STREAM_RESULTS.
+   */
+  int stream_pending;
+
+  /**
+   * Format of the results requested from the server: text (0) or
+   * binary (1).
+   */
+  int result_format;
+
+  /**
+   * Set to 1 while the server-side cursor named after this statement has
+   * more rows to fetch.
+   *
+   * See @ref sqldbal_stmt_set_cursor.
+   */
+  int cursor_open;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+
+  /**
+   * Copy of the SQL text, used to declare the cursor.
+   */
+  char *sql;
+};
+
+/**
+ * Column buffers passed to the application callback in
+ * @ref sqldbal_pq_exec, reused for every row of the query.
+ */
+struct sqldbal_pq_exec_buf{
+  /**
+   * Column values in the current row.
+   */
+  char **col_result_list;
+
+  /**
+   * Length of the corresponding column in @ref col_result_list.
+   */
+  size_t *col_length_list;
+
+  /**
+   * Column data types, classified once for each result.
+   */
+  enum sqldbal_pq_type *col_type_list;
+
+  /**
+   * Holds the decoded bytea columns of the current row.
+   */
+  char *bin;
+
+  /**
+   * Number of bytes allocated in @ref bin.
+   */
+  size_t bin_size;
+};
+
+/**
+ * Convenience function that sets the status code and the error string
+ * generated by the database function.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] status_code See @ref sqldbal_status_code.
+ */
+static void
+sqldbal_pq_error(struct sqldbal_db *const db,
+                 enum sqldbal_status_code status_code){
+  const char *error;
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = db->handle;
+  error = PQerrorMessage(pq_db->db);
+  sqldbal_err_set(db, status_code, error);
+}
+
+/**
+ * Copy a string and get the pointer to the end of the copied buffer.
+ *
+ * This function behaves similar to POSIX stpcpy(), useful for
+ * concatenating multiple strings onto a buffer. It always adds a
+ * null-terminated byte at the end of the string.
+ *
+ * @param[in] s1 Destination buffer.
+ * @param[in] s2 Null-terminated source string to copy to @p s1.
+ * @return Pointer to location in @p s1 after the last copied byte.
+ */
+SQLDBAL_LINKAGE char *
+sqldbal_stpcpy(char *s1,
+               const char *s2){
+  size_t i;
+
+  i = 0;
+  do{
+    s1[i] = s2[i];
+  } while(s2[i++] != '\0');
+  return &s1[i-1];
+}
+
+/**
+ * Generate a unique statement name for use by PostgreSQL and store
+ * it in @ref sqldbal_pq_stmt::name.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] pq_stmt See @ref sqldbal_pq_stmt.
+ * @return See @ref sqldbal_status_code.
+ */
+static enum sqldbal_status_code
+sqldbal_pq_gen_stmt_name(struct sqldbal_db *const db,
+                         struct sqldbal_pq_stmt *const pq_stmt){
+  const char *const prefix_str = "pqs";
+  struct sqldbal_pq_db *pq_db;
+  size_t namesz;
+  size_t int_count;
+  size_t i;
+  int name_len;
+
+  pq_db = db->handle;
+
+  /*
+   * Get the number of characters in the counter.
+   * For example, the longest 64-bit unsigned number:
+   * 18446744073709551615
+   * 12345678901234567890
+   *         10        20
+   * This means int_count has a maximum of 20 digits.
+   */
+  int_count = 1;
+  for(i = pq_db->stmt_counter; i >= 10; i /= 10){
+    int_count += 1;
+  }
+
+  /*
+   * Does not wrap.
+   * 3 + [1-20] + 1
+   */
+  namesz = strlen(prefix_str) + int_count + 1;
+  pq_stmt->name = malloc(namesz);
+  if(pq_stmt->name == NULL){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    name_len = sprintf(pq_stmt->name,
+                       "%s%lu",
+                       prefix_str,
+                       pq_db->stmt_counter);
+    if(name_len < 0){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      pq_db->stmt_counter += 1;
+    }
+  }
+
+  return sqldbal_status_code_get(db);
+}
+
+/**
+ * Get the length of key=value string to add to the conninfo parameter.
+ *
+ * The following shows an example key=value pair inside the quotes.
+ * " key=value"
+ *
+ * Each key=value sequence gets preceded by a space.
+ * See @ref sqldbal_pq_append_conninfo_param.
+ *
+ * @param[in]  key   Parameter key.
+ * @param[in]  value Parameter value, NULL if this parameter does not exist.
+ * @param[out] len   String length of key=value pair.
+ * @retval 0 Length calculation did not wrap.
+ * @retval 1 Length calculation wrapped.
+ */
+static int
+sqldbal_pq_conninfo_param_len(const char *const key,
+                              const char *const value,
+                              size_t *const len){
+  size_t key_len;
+  size_t value_len;
+
+  *len = 0;
+  if(value){
+    key_len = strlen(key);
+    value_len = strlen(value);
+    /*
+     *        SPACE     key     =     value
+     * len +=   1   + key_len + 1 + value_len;
+     */
+    if(si_add_size_t(key_len, value_len, len) ||
+       si_add_size_t(*len, 2, len)){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Append a conninfo paramater if the value exists.
+ *
+ * @param[in] conninfo Pointer to the first unwritten byte in conninfo string.
+ * @param[in] key      Paramater key.
+ * @param[in] value    Paramater value, NULL if this parameter does not exist.
+ * @return Pointer to the next unwritten byte in @p conninfo.
+ */
+static char *
+sqldbal_pq_append_conninfo_param(char *const conninfo,
+                                 const char *const key,
+                                 const char *const value){
+  char *cip;
+
+  cip = conninfo;
+  if(value){
+    cip = sqldbal_stpcpy(conninfo, " ");
+    cip = sqldbal_stpcpy(cip, key);
+    cip = sqldbal_stpcpy(cip, "=");
+    cip = sqldbal_stpcpy(cip, value);
+  }
+  return cip;
+}
+
+/**
+ * Generate the conninfo parameter to send to libpq when opening a
+ * database connection.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] location    IP address or hostname.
+ * @param[in] port        Server port number to connect to.
+ * @param[in] username    Username to connect with.
+ * @param[in] password    Password corresponding to @p username.
+ * @param[in] database    Optional database to open after connecting to the
+ *                        server. Set this to NULL to prevent opening a
+ *                        database after initially connecting.
+ * @param[in] num_options Number of entries in @p option_list.
+ * @param[in] option_list See @ref sqldbal_driver_option.
+ * @retval char* The conninfo parameter to use in PQconnectdb().
+ *               The caller must free() this memory after use.
+ * @retval NULL  Memory allocation failed. This function will also set the
+ *               status in @ref sqldbal_db to @ref SQLDBAL_STATUS_NOMEM.
+ */
+static char *
+sqldbal_pq_conninfo(struct sqldbal_db *const db,
+                    const char *const location,
+                    const char *const port,
+                    const char *const username,
+                    const char *const password,
+                    const char *const database,
+                    size_t num_options,
+                    const struct sqldbal_driver_option *const option_list){
+  size_t conninfo_sz;
+  size_t inc_sz;
+  char *conninfo;
+  size_t i;
+  const struct sqldbal_driver_option *option;
+  char *cip;
+  struct sqldbal_driver_option param_list[] = {
+    {"host"                     , location}, /* 0  */
+    {"hostaddr"                 , NULL    }, /* 1  */
+    {"port"                     , port    }, /* 2  */
+    {"dbname"                   , database}, /* 3  */
+    {"user"                     , username}, /* 4  */
+    {"password"                 , password}, /* 5  */
+    {"passfile"                 , NULL    }, /* 6  */
+    {"connect_timeout"          , NULL    }, /* 7  */
+    {"client_encoding"          , NULL    }, /* 8  */
+    {"options"                  , NULL    }, /* 9  */
+    {"application_name"         , NULL    }, /* 10 */
+    {"fallback_application_name", NULL    }, /* 11 */
+    {"keepalives"               , NULL    }, /* 12 */
+    {"keepalives_idle"          , NULL    }, /* 13 */
+    {"keepalives_interval"      , NULL    }, /* 14 */
+    {"keepalives_count"         , NULL    }, /* 15 */
+    {"tty"                      , NULL    }, /* 16 */
+    {"replication"              , NULL    }, /* 17 */
+    {"sslmode"                  , NULL    }, /* 18 */
+    {"requiressl"               , NULL    }, /* 19 */
+    {"sslcompression"           , NULL    }, /* 20 */
+    {"sslcert"                  , NULL    }, /* 21 */
+    {"sslkey"                   , NULL    }, /* 22 */
+    {"sslrootcert"              , NULL    }, /* 23 */
+    {"sslcrl"                   , NULL    }, /* 24 */
+    {"requirepeer"              , NULL    }, /* 25 */
+    {"krbsrvname"               , NULL    }, /* 26 */
+    {"gsslib"                   , NULL    }, /* 27 */
+    {"service"                  , NULL    }, /* 28 */
+    {"target_session_attrs"     , NULL    }  /* 29 */
+  };
+  const size_t num_possible_params = sizeof(param_list) / sizeof(param_list[0]);
+
+  for(i = 0; i < num_options; i++){
+    option = &option_list[i];
+    if(strcmp(option->key, "CONNECT_TIMEOUT") == 0){
+      param_list[7].value = option->value;
+    }
+    else if(strcmp(option->key, "TLS_MODE") == 0){
+      param_list[18].value = option->value;
+    }
+    else if(strcmp(option->key, "TLS_CERT") == 0){
+      param_list[21].value = option->value;
+    }
+    else if(strcmp(option->key, "TLS_KEY") == 0){
+      param_list[22].value = option->value;
+    }
+    else if(strcmp(option->key, "TLS_CA") == 0){
+      param_list[23].value = option->value;
+    }
+    else{
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+    }
+  }
+
+  conninfo_sz = 0;
+  for(i = 0; i < num_possible_params; i++){
+    if(sqldbal_pq_conninfo_param_len(param_list[i].key,
+                                     param_list[i].value,
+                                     &inc_sz) ||
+       si_add_size_t(conninfo_sz, inc_sz, &conninfo_sz)){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+  }
+  if(si_add_size_t(conninfo_sz, 1, &conninfo_sz)){ /* null-terminator */
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+
+  if(sqldbal_status_code_get(db) != SQLDBAL_STATUS_OK){
+    conninfo = NULL;
+  }
+  else{
+    conninfo = malloc(conninfo_sz);
+    if(conninfo == NULL){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      conninfo[0] = '\0';
+
+      cip = conninfo;
+      for(i = 0; i < num_possible_params; i++){
+        cip = sqldbal_pq_append_conninfo_param(cip,
+                                               param_list[i].key,
+                                               param_list[i].value);
+      }
+    }
+  }
+
+  return conninfo;
+}
+
+/**
+ * Classify the data type of a column or parameter.
+ *
+ * User-defined types, including domains, get classified as
+ * @ref SQLDBAL_PQ_TYPE_OTHER and use the text format.
+ *
+ * @param[in] oid Unique data type id in PostgreSQL.
+ * @return See @ref sqldbal_pq_type.
+ */
+static enum sqldbal_pq_type
+sqldbal_pq_oid_type(Oid oid){
+  enum sqldbal_pq_type type;
+
+  switch(oid){
+    case SQLDBAL_PQ_OID_INT8:
+      type = SQLDBAL_PQ_TYPE_INT8;
+      break;
+    case SQLDBAL_PQ_OID_INT4:
+      type = SQLDBAL_PQ_TYPE_INT4;
+      break;
+    case SQLDBAL_PQ_OID_INT2:
+      type = SQLDBAL_PQ_TYPE_INT2;
+      break;
+    case SQLDBAL_PQ_OID_BYTEA:
+      type = SQLDBAL_PQ_TYPE_BYTEA;
+      break;
+    case SQLDBAL_PQ_OID_TEXT:
+    case SQLDBAL_PQ_OID_VARCHAR:
+    case SQLDBAL_PQ_OID_BPCHAR:
+    case SQLDBAL_PQ_OID_NAME:
+      type = SQLDBAL_PQ_TYPE_TEXT;
+      break;
+    case SQLDBAL_PQ_OID_BOOL:
+      type = SQLDBAL_PQ_TYPE_BOOL;
+      break;
+    case SQLDBAL_PQ_OID_FLOAT4:
+      type = SQLDBAL_PQ_TYPE_FLOAT4;
+      break;
+    case SQLDBAL_PQ_OID_FLOAT8:
+      type = SQLDBAL_PQ_TYPE_FLOAT8;
+      break;
+    case SQLDBAL_PQ_OID_DATE:
+      type = SQLDBAL_PQ_TYPE_DATE;
+      break;
+    case SQLDBAL_PQ_OID_TIMESTAMP:
+      type = SQLDBAL_PQ_TYPE_TIMESTAMP;
+      break;
+    case SQLDBAL_PQ_OID_TIMESTAMPTZ:
+      type = SQLDBAL_PQ_TYPE_TIMESTAMPTZ;
+      break;
+    default:
+      type = SQLDBAL_PQ_TYPE_OTHER;
+      break;
+  }
+  return type;
+}
+
+/**
+ * Get the number of bytes used by the binary format of an integer type.
+ *
+ * @param[in] type See @ref sqldbal_pq_type.
+ * @return Number of bytes in the binary integer, or 0 if @p type does not
+ *         have an integer data type.
+ */
+static size_t
+sqldbal_pq_type_int_size(enum sqldbal_pq_type type){
+  size_t nbytes;
+
+  if(type == SQLDBAL_PQ_TYPE_INT8){
+    nbytes = 8;
+  }
+  else if(type == SQLDBAL_PQ_TYPE_INT4){
+    nbytes = 4;
+  }
+  else if(type == SQLDBAL_PQ_TYPE_INT2){
+    nbytes = 2;
+  }
+  else{
+    nbytes = 0;
+  }
+  return nbytes;
+}
+
+/**
+ * Convert an integer to the PostgreSQL binary format, which uses network
+ * byte order.
+ *
+ * @param[in]  i64    Integer to convert. The caller must make sure the value
+ *                    fits in @p nbytes.
+ * @param[in]  nbytes Number of bytes in @p bin (2, 4, or 8).
+ * @param[out] bin    Buffer with at least @p nbytes bytes.
+ */
+SQLDBAL_LINKAGE void
+sqldbal_pq_int_to_bin(int64_t i64,
+                      size_t nbytes,
+                      unsigned char *const bin){
+  uint64_t u64;
+  size_t i;
+
+  u64 = (uint64_t)i64;
+  for(i = nbytes; i > 0; i--){
+    bin[i - 1] = (unsigned char)(u64 & 0xff);
+    u64 >>= 8;
+  }
+}
+
+/**
+ * Convert an integer in the PostgreSQL binary format to a 64-bit integer.
+ *
+ * @param[in] bin    Signed integer in network byte order.
+ * @param[in] nbytes Number of bytes in @p bin (2, 4, or 8).
+ * @return Integer converted from @p bin.
+ */
+SQLDBAL_LINKAGE int64_t
+sqldbal_pq_bin_to_int(const unsigned char *const bin,
+                      size_t nbytes){
+  uint64_t u64;
+  int64_t i64;
+  size_t i;
+
+  u64 = 0;
+  for(i = 0; i < nbytes; i++){
+    u64 = (u64 << 8) | bin[i];
+  }
+
+  /* Sign extend the smaller integer types. */
+  if(nbytes < 8 && (bin[0] & 0x80)){
+    u64 |= UINT64_MAX << (nbytes * 8);
+  }
+
+  if(u64 > INT64_MAX){
+    i64 = -(int64_t)(~u64) - 1;
+  }
+  else{
+    i64 = (int64_t)u64;
+  }
+  return i64;
+}
+
+/**
+ * Get the number of bytes used by the binary format of a floating point
+ * type.
+ *
+ * @param[in] type See @ref sqldbal_pq_type.
+ * @return Number of bytes in the binary value, or 0 if @p type does not
+ *         have a floating point data type.
+ */
+static size_t
+sqldbal_pq_type_float_size(enum sqldbal_pq_type type){
+  size_t nbytes;
+
+  if(type == SQLDBAL_PQ_TYPE_FLOAT8){
+    nbytes = 8;
+  }
+  else if(type == SQLDBAL_PQ_TYPE_FLOAT4){
+    nbytes = 4;
+  }
+  else{
+    nbytes = 0;
+  }
+  return nbytes;
+}
+
+/**
+ * Get the number of bytes used by the binary format of a date or timestamp
+ * type.
+ *
+ * @param[in] type See @ref sqldbal_pq_type.
+ * @return 8 for timestamps, 4 for dates, or 0 for other data types.
+ */
+static size_t
+sqldbal_pq_type_timestamp_size(enum sqldbal_pq_type type){
+  size_t nbytes;
+
+  if(type == SQLDBAL_PQ_TYPE_TIMESTAMP ||
+     type == SQLDBAL_PQ_TYPE_TIMESTAMPTZ){
+    nbytes = 8;
+  }
+  else if(type == SQLDBAL_PQ_TYPE_DATE){
+    nbytes = 4;
+  }
+  else{
+    nbytes = 0;
+  }
+  return nbytes;
+}
+
+/**
+ * Convert a double to the PostgreSQL binary format of float4 or float8,
+ * which stores the IEEE 754 bits in network byte order.
+ *
+ * @param[in]  d      Floating point number to convert.
+ * @param[in]  nbytes Number of bytes in @p bin (4 or 8).
+ * @param[out] bin    Buffer with at least @p nbytes bytes.
+ */
+SQLDBAL_LINKAGE void
+sqldbal_pq_double_to_bin(double d,
+                         size_t nbytes,
+                         unsigned char *const bin){
+  float f;
+  uint32_t u32;
+  uint64_t u64;
+  size_t i;
+
+  if(nbytes == 4){
+    f = (float)d;
+    memcpy(&u32, &f, sizeof(u32));
+    u64 = u32;
+  }
+  else{
+    memcpy(&u64, &d, sizeof(u64));
+  }
+  for(i = nbytes; i > 0; i--){
+    bin[i - 1] = (unsigned char)(u64 & 0xff);
+    u64 >>= 8;
+  }
+}
+
+/**
+ * Convert a float4 or float8 in the PostgreSQL binary format to a double.
+ *
+ * @param[in] bin    IEEE 754 bits in network byte order.
+ * @param[in] nbytes Number of bytes in @p bin (4 or 8).
+ * @return Floating point number converted from @p bin.
+ */
+SQLDBAL_LINKAGE double
+sqldbal_pq_bin_to_double(const unsigned char *const bin,
+                         size_t nbytes){
+  float f;
+  double d;
+  uint32_t u32;
+  uint64_t u64;
+  size_t i;
+
+  u64 = 0;
+  for(i = 0; i < nbytes; i++){
+    u64 = (u64 << 8) | bin[i];
+  }
+  if(nbytes == 4){
+    u32 = (uint32_t)u64;
+    memcpy(&f, &u32, sizeof(f));
+    d = (double)f;
+  }
+  else{
+    memcpy(&d, &u64, sizeof(d));
+  }
+  return d;
+}
+
+/**
+ * Convert a date or timestamp in the PostgreSQL binary format to a
+ * timestamp.
+ *
+ * PostgreSQL stores timestamps as microseconds and dates as days since
+ * 2000-01-01. The largest and smallest values represent infinity and get
+ * converted to INT64_MAX and INT64_MIN.
+ *
+ * @param[in]  bin    Binary value in network byte order.
+ * @param[in]  nbytes 8 for timestamps, or 4 for dates.
+ * @param[out] ts     Microseconds since 1970-01-01 00:00:00 UTC.
+ * @retval  0 Value converted.
+ * @retval -1 Value does not fit in @p ts.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_pq_bin_to_timestamp(const unsigned char *const bin,
+                            size_t nbytes,
+                            int64_t *const ts){
+  int64_t value;
+  int64_t limit;
+  int rc;
+
+  rc = 0;
+  value = sqldbal_pq_bin_to_int(bin, nbytes);
+  if(nbytes == 4){
+    limit = INT64_MAX / SQLDBAL_USEC_PER_DAY - SQLDBAL_PQ_EPOCH_DAYS;
+    if(value == INT32_MAX){
+      *ts = INT64_MAX;
+    }
+    else if(value == INT32_MIN){
+      *ts = INT64_MIN;
+    }
+    else if(value > limit || value < -limit){
+      rc = -1;
+    }
+    else{
+      *ts = (value + SQLDBAL_PQ_EPOCH_DAYS) * SQLDBAL_USEC_PER_DAY;
+    }
+  }
+  else{
+    limit = SQLDBAL_PQ_EPOCH_DAYS * SQLDBAL_USEC_PER_DAY;
+    if(value == INT64_MAX || value == INT64_MIN){
+      *ts = value;
+    }
+    else if(value > INT64_MAX - limit){
+      rc = -1;
+    }
+    else{
+      *ts = value + limit;
+    }
+  }
+  return rc;
+}
+
+/**
+ * Convert a timestamp to the PostgreSQL binary timestamp format.
+ *
+ * @param[in]  ts  Microseconds since 1970-01-01 00:00:00 UTC.
+ * @param[out] bin Buffer with at least 8 bytes.
+ * @retval  0 Value converted.
+ * @retval -1 Value does not fit in the PostgreSQL timestamp format.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_pq_timestamp_to_bin(int64_t ts,
+                            unsigned char *const bin){
+  int64_t limit;
+  int rc;
+
+  rc = 0;
+  limit = SQLDBAL_PQ_EPOCH_DAYS * SQLDBAL_USEC_PER_DAY;
+  if(ts == INT64_MAX || ts == INT64_MIN){
+    sqldbal_pq_int_to_bin(ts, 8, bin);
+  }
+  else if(ts < INT64_MIN + limit){
+    rc = -1;
+  }
+  else{
+    sqldbal_pq_int_to_bin(ts - limit, 8, bin);
+  }
+  return rc;
+}
+
+/**
+ * Map each character to its hexadecimal digit value, or -1 if the character
+ * is not a hexadecimal digit.
+ */
+static const signed char g_sqldbal_hex_table[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+#ifdef SQLDBAL_PQ_HAS_SSE2
+/**
+ * Convert 16 hexadecimal characters to their digit values.
+ *
+ * @param[in]  hex   16 hexadecimal characters.
+ * @param[out] valid Set to 0 if any character is not a hexadecimal digit.
+ * @return Digit value of each character.
+ */
+static __m128i
+sqldbal_hex2bin_sse2_digits(__m128i hex,
+                            int *const valid){
+  __m128i digit;
+  __m128i alpha;
+  __m128i is_digit;
+  __m128i is_alpha;
+
+  /*
+   * The subtraction wraps, so each result lands in the range only for the
+   * characters '0' - '9' or 'a' - 'f' (after forcing lower case).
+   */
+  digit = _mm_sub_epi8(hex, _mm_set1_epi8('0'));
+  alpha = _mm_sub_epi8(_mm_or_si128(hex, _mm_set1_epi8(0x20)),
+                       _mm_set1_epi8('a'));
+  is_digit = _mm_and_si128(_mm_cmpgt_epi8(digit, _mm_set1_epi8(-1)),
+                           _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+  is_alpha = _mm_and_si128(_mm_cmpgt_epi8(alpha, _mm_set1_epi8(-1)),
+                           _mm_cmplt_epi8(alpha, _mm_set1_epi8(6)));
+  if(_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xffff){
+    *valid = 0;
+  }
+  return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                      _mm_and_si128(is_alpha,
+                                    _mm_add_epi8(alpha,
+                                                 _mm_set1_epi8(10))));
+}
+
+/**
+ * Combine the pairs of hexadecimal digit values into bytes.
+ *
+ * @param[in] digits 16 digit values from @ref sqldbal_hex2bin_sse2_digits.
+ * @return 8 bytes, each stored in the low half of a 16-bit lane.
+ */
+static __m128i
+sqldbal_hex2bin_sse2_pack(__m128i digits){
+  __m128i high;
+  __m128i low;
+
+  high = _mm_slli_epi16(_mm_and_si128(digits, _mm_set1_epi16(0x00ff)), 4);
+  low  = _mm_srli_epi16(digits, 8);
+  return _mm_or_si128(high, low);
+}
+#endif /* SQLDBAL_PQ_HAS_SSE2 */
+
+/**
+ * Convert a hexadecimal string sequence to binary data.
+ *
+ * Upper and lower case digits are both accepted. Uses SSE2 to convert 32
+ * characters at a time when available, and a lookup table for the rest.
+ *
+ * @param[in]  hex_str Hexadecimal characters to convert. This does not need
+ *                     to have a null-terminator.
+ * @param[in]  hexlen  Number of characters in @p hex_str, which must be a
+ *                     multiple of 2.
+ * @param[out] bin     Buffer with at least @p hexlen / 2 bytes.
+ * @retval  0 Converted the entire @p hex_str.
+ * @retval -1 The @p hexlen has an odd number of characters, or
+ *            @p hex_str contains a character which is not a hexadecimal
+ *            digit. The contents of @p bin are undefined.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_hex2bin_buf(const char *const hex_str,
+                    size_t hexlen,
+                    unsigned char *const bin){
+  const unsigned char *hex;
+  size_t i;
+  size_t j;
+  int high;
+  int low;
+  int rc;
+#ifdef SQLDBAL_PQ_HAS_SSE2
+  __m128i first;
+  __m128i second;
+  int valid;
+#endif /* SQLDBAL_PQ_HAS_SSE2 */
+
+  rc = 0;
+  hex = (const unsigned char *)hex_str;
+  i = 0;
+  j = 0;
+  if(hexlen % 2){
+    rc = -1;
+  }
+#ifdef SQLDBAL_PQ_HAS_SSE2
+  else{
+    valid = 1;
+    for(; hexlen - i >= 32 && valid; i += 32, j += 16){
+      first  = _mm_loadu_si128((const __m128i *)(const void *)&hex[i]);
+      second = _mm_loadu_si128((const __m128i *)(const void *)&hex[i + 16]);
+      first  = sqldbal_hex2bin_sse2_digits(first, &valid);
+      second = sqldbal_hex2bin_sse2_digits(second, &valid);
+      _mm_storeu_si128((__m128i *)(void *)&bin[j],
+                       _mm_packus_epi16(sqldbal_hex2bin_sse2_pack(first),
+                                        sqldbal_hex2bin_sse2_pack(second)));
+    }
+    if(valid == 0){
+      rc = -1;
+    }
+  }
+#endif /* SQLDBAL_PQ_HAS_SSE2 */
+
+  if(rc == 0){
+    for(; i < hexlen; i += 2, j++){
+      high = g_sqldbal_hex_table[hex[i]];
+      low  = g_sqldbal_hex_table[hex[i + 1]];
+      if(high < 0 || low < 0){
+        rc = -1;
+        break;
+      }
+      bin[j] = (unsigned char)((high << 4) | low);
+    }
+  }
+  return rc;
+}
+
+/**
+ * Allocate the PostgreSQL connection state and connect, or start
+ * connecting, to the server.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] location    IP address or hostname.
+ * @param[in] port        Server port number to connect to.
+ * @param[in] username    Username to connect with.
+ * @param[in] password    Password corresponding to @p username.
+ * @param[in] database    Optional database to open after connecting to the
+ *                        server. Set this to NULL to prevent opening a
+ *                        database after initially connecting.
+ * @param[in] option_list See @ref sqldbal_driver_option.
+ * @param[in] num_options Number of entries in @p option_list.
+ * @param[in] connect_fp  PQconnectdb or PQconnectStart.
+ */
+static void
+sqldbal_pq_connect(struct sqldbal_db *const db,
+                   const char *const location,
+                   const char *const port,
+                   const char *const username,
+                   const char *const password,
+                   const char *const database,
+                   const struct sqldbal_driver_option *const option_list,
+                   size_t num_options,
+                   PGconn *(*connect_fp)(const char *conninfo)){
+  struct sqldbal_pq_db *pq_db;
+  char *conninfo;
+
+  pq_db = malloc(sizeof(*pq_db));
+  if(pq_db == NULL){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    db->handle = NULL;
+    pq_db->stmt_counter  = 1;
+    pq_db->pipeline_list = NULL;
+    pq_db->pipeline_len  = 0;
+    pq_db->pipeline_size = 0;
+
+    conninfo = sqldbal_pq_conninfo(db,
+                                   location,
+                                   port,
+                                   username,
+                                   password,
+                                   database,
+                                   num_options,
+                                   option_list);
+    if(conninfo == NULL){
+      free(pq_db);
+    }
+    else{
+      pq_db->db = connect_fp(conninfo);
+      if(pq_db->db == NULL){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_OPEN);
+        free(pq_db);
+      }
+      else if(PQstatus(pq_db->db) == CONNECTION_BAD){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_OPEN);
+        PQfinish(pq_db->db);
+        free(pq_db);
+      }
+      else{
+        db->handle = pq_db;
+      }
+      free(conninfo);
+    }
+  }
+}
+
+/**
+ * Turn on the debug output after the connection completes.
+ *
+ * See @ref SQLDBAL_FLAG_DEBUG.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_connected(struct sqldbal_db *const db){
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = db->handle;
+  if(db->flags & SQLDBAL_FLAG_DEBUG){
+    PQsetErrorVerbosity(pq_db->db, PQERRORS_VERBOSE);
+#ifdef SQLDBAL_PQ_HAS_ERROR_CONTEXT_VISIBILITY
+    PQsetErrorContextVisibility(pq_db->db, PQSHOW_CONTEXT_ALWAYS);
+#endif /* SQLDBAL_PQ_HAS_ERROR_CONTEXT_VISIBILITY */
+    PQtrace(pq_db->db, stderr);
+  }
+}
+
+/**
+ * Open database connection to server.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] location    IP address or hostname.
+ * @param[in] port        Server port number to connect to.
+ * @param[in] username    Username to connect with.
+ * @param[in] password    Password corresponding to @p username.
+ * @param[in] database    Optional database to open after connecting to the
+ *                        server. Set this to NULL to prevent opening a
+ *                        database after initially connecting.
+ * @param[in] option_list See @ref sqldbal_driver_option.
+ * @param[in] num_options Number of entries in @p option_list.
+ */
+static void
+sqldbal_pq_open(struct sqldbal_db *const db,
+                const char *const location,
+                const char *const port,
+                const char *const username,
+                const char *const password,
+                const char *const database,
+                const struct sqldbal_driver_option *const option_list,
+                size_t num_options){
+  /* https://www.postgresql.org/docs/current/libpq-connect.html */
+  sqldbal_pq_connect(db,
+                     location,
+                     port,
+                     username,
+                     password,
+                     database,
+                     option_list,
+                     num_options,
+                     PQconnectdb);
+  if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    sqldbal_pq_connected(db);
+  }
+}
+
+/**
+ * Start connecting to the server without blocking.
+ *
+ * @param[in]  db          See @ref sqldbal_db.
+ * @param[in]  location    See @ref sqldbal_pq_open.
+ * @param[in]  port        See @ref sqldbal_pq_open.
+ * @param[in]  username    See @ref sqldbal_pq_open.
+ * @param[in]  password    See @ref sqldbal_pq_open.
+ * @param[in]  database    See @ref sqldbal_pq_open.
+ * @param[in]  option_list See @ref sqldbal_pq_open.
+ * @param[in]  num_options See @ref sqldbal_pq_open.
+ * @param[out] wait_events See @ref sqldbal_wait_event.
+ */
+static void
+sqldbal_pq_connect_start(struct sqldbal_db *const db,
+                         const char *const location,
+                         const char *const port,
+                         const char *const username,
+                         const char *const password,
+                         const char *const database,
+                         const struct sqldbal_driver_option *const option_list,
+                         size_t num_options,
+                         int *const wait_events){
+  /* https://www.postgresql.org/docs/current/libpq-connect.html */
+  sqldbal_pq_connect(db,
+                     location,
+                     port,
+                     username,
+                     password,
+                     database,
+                     option_list,
+                     num_options,
+                     PQconnectStart);
+  *wait_events = 0;
+  if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    /* libpq expects a writable socket before the first PQconnectPoll. */
+    *wait_events = SQLDBAL_WAIT_WRITE;
+  }
+}
+
+/**
+ * Continue the connection started by @ref sqldbal_pq_connect_start.
+ *
+ * @param[in]     db          See @ref sqldbal_db.
+ * @param[in,out] wait_events Events the socket became ready for, and then
+ *                            the events to wait for next.
+ */
+static void
+sqldbal_pq_connect_poll(struct sqldbal_db *const db,
+                        int *const wait_events){
+  struct sqldbal_pq_db *pq_db;
+  PostgresPollingStatusType poll_status;
+
+  pq_db = db->handle;
+  *wait_events = 0;
+
+  /* https://www.postgresql.org/docs/current/libpq-connect.html */
+  poll_status = PQconnectPoll(pq_db->db);
+  if(poll_status == PGRES_POLLING_READING){
+    *wait_events = SQLDBAL_WAIT_READ;
+  }
+  else if(poll_status == PGRES_POLLING_WRITING){
+    *wait_events = SQLDBAL_WAIT_WRITE;
+  }
+  else if(poll_status == PGRES_POLLING_OK){
+    sqldbal_pq_connected(db);
+  }
+  else{
+    sqldbal_pq_error(db, SQLDBAL_STATUS_OPEN);
+  }
+}
+
+/**
+ * Close database connection.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_close(struct sqldbal_db *const db){
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = db->handle;
+  if(pq_db){
+    PQfinish(pq_db->db);
+    free(pq_db->pipeline_list);
+    free(pq_db);
+  }
+}
+
+/**
+ * Get the PostgreSQL database handle.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @return PGconn*.
+ */
+static void *
+sqldbal_pq_db_handle(const struct sqldbal_db *const db){
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = db->handle;
+  return pq_db->db;
+}
+
+/**
+ * Maximum number of placeholders in a PostgreSQL statement, because the
+ * Bind message sends the number of parameters as a 16-bit integer.
+ */
+#define SQLDBAL_PQ_MAX_PARAMS 65535
+
+/**
+ * Get the maximum number of placeholders in a PostgreSQL statement.
+ *
+ * @param[in] db Unused.
+ * @return       @ref SQLDBAL_PQ_MAX_PARAMS.
+ */
+static size_t
+sqldbal_pq_param_limit(struct sqldbal_db *const db){
+  (void)db;
+  return SQLDBAL_PQ_MAX_PARAMS;
+}
+
+/**
+ * Get the socket connected to the PostgreSQL server.
+ *
+ * @param[in]  db See @ref sqldbal_db.
+ * @param[out] fd Socket descriptor.
+ */
+static void
+sqldbal_pq_socket_fd(struct sqldbal_db *const db,
+                     int *const fd){
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = db->handle;
+
+  /* https://www.postgresql.org/docs/current/libpq-status.html */
+  *fd = PQsocket(pq_db->db);
+}
+
+/**
+ * Get the PostgreSQL statement handle.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return char* (statement name).
+ */
+static void *
+sqldbal_pq_stmt_handle(const struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+  return pq_stmt->name;
+}
+
+/**
+ * Directly execute SQL statement that does not return any data.
+ *
+ * @param[in] db  See @ref sqldbal_db.
+ * @param[in] sql Database statement to execute.
+ */
+static void
+sqldbal_pq_exec_noresult(struct sqldbal_db *const db,
+                         const char *const sql){
+  struct sqldbal_pq_db *pq_db;
+  PGresult *result;
+
+  pq_db = db->handle;
+  result = PQexec(pq_db->db, sql);
+  if(result == NULL){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    if(PQresultStatus(result) != PGRES_COMMAND_OK){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
+    }
+    PQclear(result);
+  }
+}
+
+/**
+ * Begin a PostgreSQL transaction.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_begin_transaction(struct sqldbal_db *const db){
+  sqldbal_pq_exec_noresult(db, "BEGIN");
+}
+
+/**
+ * Commit a PostgreSQL transaction.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_commit(struct sqldbal_db *const db){
+  sqldbal_pq_exec_noresult(db, "COMMIT");
+}
+
+/**
+ * Rollback a PostgreSQL transaction.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_rollback(struct sqldbal_db *const db){
+  sqldbal_pq_exec_noresult(db, "ROLLBACK");
+}
+
+/**
+ * Make sure the bytea buffer can hold every bytea column in a row.
+ *
+ * Sizing the buffer before decoding keeps the pointers into it valid until
+ * the application callback returns.
+ *
+ * @param[in]     result   Query result containing rows.
+ * @param[in]     row_i    Row number in @p result.
+ * @param[in]     num_cols Number of columns in @p result.
+ * @param[in,out] buf      See @ref sqldbal_pq_exec_buf.
+ * @retval  0 Success.
+ * @retval -1 Failed to allocate memory.
+ */
+static int
+sqldbal_pq_exec_buf_reserve_bin(PGresult *const result,
+                                int row_i,
+                                size_t num_cols,
+                                struct sqldbal_pq_exec_buf *const buf){
+  size_t col_i;
+  size_t bin_size;
+  char *bin;
+  int rc;
+
+  rc = 0;
+  bin_size = 0;
+  for(col_i = 0; col_i < num_cols; col_i++){
+    if(buf->col_type_list[col_i] == SQLDBAL_PQ_TYPE_BYTEA){
+      /*
+       * Number of columns limited to INT_MAX and the length is never
+       * negative. Include room for a null-terminator.
+       */
+      bin_size += (size_t)PQgetlength(result, row_i, (int)col_i) / 2 + 1;
+    }
+  }
+  if(bin_size > buf->bin_size){
+    if(bin_size < buf->bin_size * 2){
+      bin_size = buf->bin_size * 2;
+    }
+    bin = realloc(buf->bin, bin_size);
+    if(bin == NULL){
+      rc = -1;
+    }
+    else{
+      buf->bin = bin;
+      buf->bin_size = bin_size;
+    }
+  }
+  return rc;
+}
+
+/**
+ * Invoke the application callback for every row in a query result.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] result    Query result containing rows.
+ * @param[in] num_cols  Number of columns in @p result.
+ * @param[in] buf       See @ref sqldbal_pq_exec_buf.
+ * @param[in] callback  Invokes this callback function for every row
+ *                      in @p result.
+ * @param[in] user_data Pass this to the first argument in the
+ *                      @p callback function.
+ */
+static void
+sqldbal_pq_exec_result_rows(struct sqldbal_db *const db,
+                            PGresult *const result,
+                            size_t num_cols,
+                            struct sqldbal_pq_exec_buf *const buf,
+                            sqldbal_exec_callback_fp callback,
+                            void *user_data){
+  int num_rows;
+  int row_i;
+  size_t col_i;
+  int pq_column_number_i;
+  char *col_value;
+  int pq_length;
+  size_t col_length;
+  size_t bin_offset;
+
+  /* Number of columns limited to INT_MAX. */
+  for(col_i = 0; col_i < num_cols; col_i++){
+    buf->col_type_list[col_i] = sqldbal_pq_oid_type(
+                                  PQftype(result, (int)col_i));
+  }
+
+  num_rows = PQntuples(result);
+  for(row_i = 0;
+      row_i < num_rows && sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK;
+      row_i++){
+    if(sqldbal_pq_exec_buf_reserve_bin(result, row_i, num_cols, buf)){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    bin_offset = 0;
+    for(col_i = 0;
+        col_i < num_cols && sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK;
+        col_i++){
+      if(si_size_to_int(col_i, &pq_column_number_i)){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        pq_length = PQgetlength(result, row_i, pq_column_number_i);
+        if(si_int_to_size(pq_length, &col_length)){
+          sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+        }
+        else{
+          if(PQgetisnull(result, row_i, pq_column_number_i)){
+            col_value = NULL;
+          }
+          else{
+            col_value = PQgetvalue(result, row_i, pq_column_number_i);
+            if(buf->col_type_list[col_i] == SQLDBAL_PQ_TYPE_BYTEA){
+              /*
+               * The bytea type should begin with "\\x", so
+               * start the conversion at the 3rd character.
+               */
+              if(col_length < 2 ||
+                 sqldbal_hex2bin_buf(&col_value[2],
+                                     col_length - 2,
+                                     (unsigned char *)&buf->bin[bin_offset])){
+                sqldbal_status_code_set(db, SQLDBAL_STATUS_COLUMN_COERCE);
+                col_length = 0;
+              }
+              else{
+                col_length = (col_length - 2) / 2;
+              }
+              col_value = &buf->bin[bin_offset];
+              col_value[col_length] = '\0';
+              bin_offset += col_length + 1;
+            }
+          }
+          buf->col_result_list[col_i] = col_value;
+          buf->col_length_list[col_i] = col_length;
+        }
+      }
+    }
+    if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+      if(callback(user_data,
+                  num_cols,
+                  buf->col_result_list,
+                  buf->col_length_list)){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
+      }
+    }
+  }
+}
+
+/**
+ * Send a direct SQL statement and request the results one row at a time.
+ *
+ * @param[in] db  See @ref sqldbal_db.
+ * @param[in] sql SQL command to execute.
+ * @return First result from the query, or NULL if the query failed to send.
+ */
+static PGresult *
+sqldbal_pq_exec_stream(struct sqldbal_db *const db,
+                       const char *const sql){
+  struct sqldbal_pq_db *pq_db;
+  PGresult *result;
+
+  pq_db = db->handle;
+  result = NULL;
+  /* https://www.postgresql.org/docs/current/libpq-async.html */
+  if(PQsendQueryParams(pq_db->db, sql, 0, NULL, NULL, NULL, NULL, 0) != 1){
+    sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+  }
+  else{
+    /* https://www.postgresql.org/docs/current/libpq-single-row-mode.html */
+    if(PQsetSingleRowMode(pq_db->db) != 1){
+      sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+    }
+    result = PQgetResult(pq_db->db);
+  }
+  return result;
+}
+
+/**
+ * Execute a direct SQL statement.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sql       SQL command to execute.
+ * @param[in] callback  Invokes this callback function for every returned row
+ *                      in the query result set. Set this to NULL if query
+ *                      results not needed.
+ * @param[in] user_data Pass this to the first argument in the
+ *                      @p callback function.
+ */
+static void
+sqldbal_pq_exec(struct sqldbal_db *const db,
+                const char *const sql,
+                sqldbal_exec_callback_fp callback,
+                void *user_data){
+  struct sqldbal_pq_db *pq_db;
+  PGresult *result;
+  ExecStatusType result_status;
+  int pq_nfields;
+  size_t num_cols;
+  struct sqldbal_pq_exec_buf buf;
+  int stream;
+
+  pq_db = db->handle;
+  buf.col_result_list = NULL;
+  buf.col_length_list = NULL;
+  buf.col_type_list = NULL;
+  buf.bin = NULL;
+  buf.bin_size = 0;
+  num_cols = 0;
+  stream = (db->flags & SQLDBAL_FLAG_STREAM_RESULTS) != 0;
+  if(stream){
+    result = sqldbal_pq_exec_stream(db, sql);
+  }
+  else{
+    result = PQexecParams(pq_db->db, sql, 0, NULL, NULL, NULL, NULL, 0);
+    if(result == NULL){
+      sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+    }
+  }
+
+  /* Streamed queries return one result for each row. */
+  while(result){
+    result_status = PQresultStatus(result);
+    if(result_status == PGRES_COMMAND_OK){
+      /* Insert/update does not have any rows returned to the caller. */
+    }
+    else if(result_status == PGRES_TUPLES_OK ||
+            result_status == PGRES_SINGLE_TUPLE){
+      if(callback &&
+         buf.col_result_list == NULL &&
+         sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+        pq_nfields = PQnfields(result);
+        if(si_int_to_size(pq_nfields, &num_cols)){
+          sqldbal_pq_error(db, SQLDBAL_STATUS_NOMEM);
+        }
+        else{
+          buf.col_result_list = sqldbal_reallocarray(
+                                  NULL,
+                                  num_cols,
+                                  sizeof(*buf.col_result_list));
+          buf.col_length_list = sqldbal_reallocarray(
+                                  NULL,
+                                  num_cols,
+                                  sizeof(*buf.col_length_list));
+          buf.col_type_list = sqldbal_reallocarray(
+                                NULL,
+                                num_cols,
+                                sizeof(*buf.col_type_list));
+          if(buf.col_result_list == NULL ||
+             buf.col_length_list == NULL ||
+             buf.col_type_list == NULL){
+            sqldbal_pq_error(db, SQLDBAL_STATUS_NOMEM);
+          }
+        }
+      }
+      if(callback && sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+        sqldbal_pq_exec_result_rows(db,
+                                    result,
+                                    num_cols,
+                                    &buf,
+                                    callback,
+                                    user_data);
+      }
+    }
+    else{
+      sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+    }
+    PQclear(result);
+
+    if(stream){
+      result = PQgetResult(pq_db->db);
+    }
+    else{
+      result = NULL;
+    }
+  }
+  free(buf.col_result_list);
+  free(buf.col_length_list);
+  free(buf.col_type_list);
+  free(buf.bin);
+}
+
+/**
+ * Get the insert id from the last SQL insert statement.
+ *
+ * @param[in]  db        See @ref sqldbal_db.
+ * @param[in]  name      Sequence name.
+ * @param[out] insert_id Last insert id.
+ */
+static void
+sqldbal_pq_last_insert_id(struct sqldbal_db *const db,
+                          const char *const name,
+                          uint64_t *insert_id){
+  const char *const sql = "SELECT currval($1)";
+  struct sqldbal_stmt *stmt;
+  int64_t i64_insert_id;
+
+  /*
+   * Static analyzer complains that this unset when calling
+   * @ref si_int64_to_uint64.
+   */
+  i64_insert_id = 0;
+
+  sqldbal_stmt_prepare(db, sql, (size_t)-1, &stmt);
+  sqldbal_stmt_bind_text(stmt, 0, name, (size_t)-1);
+  sqldbal_stmt_execute(stmt);
+  sqldbal_stmt_fetch(stmt);
+  sqldbal_stmt_column_int64(stmt, 0, &i64_insert_id);
+  if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    if(si_int64_to_uint64(i64_insert_id, insert_id)){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_COLUMN_COERCE);
+    }
+  }
+  sqldbal_stmt_close(stmt);
+}
+
+/**
+ * Check if the connection to the database server still works.
+ *
+ * This sends an empty query because the connection status only changes
+ * after the pq library notices a failure while communicating with the
+ * server.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_ping(struct sqldbal_db *const db){
+  struct sqldbal_pq_db *pq_db;
+  PGresult *result;
+
+  pq_db = db->handle;
+
+  /* https://www.postgresql.org/docs/current/libpq-exec.html */
+  result = PQexec(pq_db->db, "");
+  if(PQresultStatus(result) != PGRES_EMPTY_QUERY ||
+     PQstatus(pq_db->db) != CONNECTION_OK){
+    sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+  }
+  PQclear(result);
+}
+
+/**
+ * Save the parameter and result column data types of a prepared statement.
+ *
+ * When using @ref SQLDBAL_FLAG_PQ_BINARY, this also decides whether to
+ * request the results in the binary format. The pq library only allows
+ * one format for all result columns, so the statement only uses binary
+ * results when the driver can handle the binary format of every column.
+ *
+ * @param[in] db            See @ref sqldbal_db.
+ * @param[in] stmt          See @ref sqldbal_stmt.
+ * @param[in] pq_stmt       See @ref sqldbal_pq_stmt.
+ * @param[in] stmt_describe Result from PQdescribePrepared().
+ * @retval  0 Success.
+ * @retval -1 Memory allocation failed.
+ */
+static int
+sqldbal_pq_stmt_describe_types(struct sqldbal_db *const db,
+                               struct sqldbal_stmt *const stmt,
+                               struct sqldbal_pq_stmt *const pq_stmt,
+                               const PGresult *const stmt_describe){
+  size_t i;
+  int rc;
+
+  rc = 0;
+
+  /* Number of fields limited to INT_MAX. */
+  pq_stmt->num_column_types = (size_t)PQnfields(stmt_describe);
+
+  pq_stmt->param_type_list = sqldbal_reallocarray(
+                               NULL,
+                               stmt->num_params,
+                               sizeof(*pq_stmt->param_type_list));
+  pq_stmt->column_type_list = sqldbal_reallocarray(
+                                NULL,
+                                pq_stmt->num_column_types,
+                                sizeof(*pq_stmt->column_type_list));
+  pq_stmt->column_conv_str_list = sqldbal_reallocarray(
+                                    NULL,
+                                    pq_stmt->num_column_types,
+                                    SQLDBAL_CONV_STR_SZ);
+  if(pq_stmt->param_type_list      == NULL ||
+     pq_stmt->column_type_list     == NULL ||
+     pq_stmt->column_conv_str_list == NULL){
+    rc = -1;
+    free(pq_stmt->param_type_list);
+    free(pq_stmt->column_type_list);
+    free(pq_stmt->column_conv_str_list);
+  }
+  else{
+    for(i = 0; i < stmt->num_params; i++){
+      /* https://www.postgresql.org/docs/current/libpq-exec.html */
+      pq_stmt->param_type_list[i] = sqldbal_pq_oid_type(
+                                      PQparamtype(stmt_describe, (int)i));
+    }
+
+    pq_stmt->result_format = (db->flags & SQLDBAL_FLAG_PQ_BINARY) &&
+                             pq_stmt->num_column_types > 0;
+    for(i = 0; i < pq_stmt->num_column_types; i++){
+      pq_stmt->column_type_list[i] = sqldbal_pq_oid_type(
+                                       PQftype(stmt_describe, (int)i));
+      if(pq_stmt->column_type_list[i] == SQLDBAL_PQ_TYPE_OTHER){
+        pq_stmt->result_format = 0;
+      }
+    }
+  }
+  return rc;
+}
+
+/**
+ * Preallocate memory used to bind parameters.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] pq_stmt See @ref sqldbal_pq_stmt.
+ * @retval  0 Success.
+ * @retval -1 Error occurred.
+ */
+static int
+sqldbal_pq_stmt_allocate_param_list(struct sqldbal_db *const db,
+                                    struct sqldbal_stmt *const stmt,
+                                    struct sqldbal_pq_stmt *const pq_stmt){
+  struct sqldbal_pq_db *pq_db;
+  PGresult *stmt_describe;
+  int pq_nparams;
+  int rc;
+
+  rc = 0;
+  pq_db = db->handle;
+  stmt_describe = PQdescribePrepared(pq_db->db, pq_stmt->name);
+  if(PQresultStatus(stmt_describe) != PGRES_COMMAND_OK){
+    rc = -1;
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PREPARE);
+  }
+  else{
+    pq_nparams = PQnparams(stmt_describe);
+    if(si_int_to_size(pq_nparams, &stmt->num_params)){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_OVERFLOW);
+    }
+    else{
+      pq_stmt->param_value_list = calloc(stmt->num_params,
+                                         sizeof(*pq_stmt->param_value_list));
+      pq_stmt->param_buf_list = calloc(stmt->num_params,
+                                       sizeof(*pq_stmt->param_buf_list));
+      pq_stmt->param_buf_size_list = calloc(
+                                       stmt->num_params,
+                                       sizeof(*pq_stmt->param_buf_size_list));
+      pq_stmt->param_length_list = sqldbal_reallocarray(NULL,
+                                                        stmt->num_params,
+                                          sizeof(*pq_stmt->param_length_list));
+      pq_stmt->param_format_list = sqldbal_reallocarray(
+                                     NULL,
+                                     stmt->num_params,
+                                     sizeof(*pq_stmt->param_format_list));
+      if(pq_stmt->param_value_list == NULL  ||
+         pq_stmt->param_buf_list == NULL    ||
+         pq_stmt->param_buf_size_list == NULL ||
+         pq_stmt->param_length_list == NULL ||
+         pq_stmt->param_format_list == NULL ||
+         sqldbal_pq_stmt_describe_types(db,
+                                        stmt,
+                                        pq_stmt,
+                                        stmt_describe) < 0){
+        rc = -1;
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+        free(pq_stmt->param_value_list);
+        free(pq_stmt->param_buf_list);
+        free(pq_stmt->param_buf_size_list);
+        free(pq_stmt->param_length_list);
+        free(pq_stmt->param_format_list);
+      }
+    }
+  }
+  PQclear(stmt_describe);
+  return rc;
+}
+
+/**
+ * Compile statement in PostgreSQL.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] sql     SQL statement to compile.
+ * @param[in] sql_len Unused.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_prepare(struct sqldbal_db *const db,
+                        const char *const sql,
+                        size_t sql_len,
+                        struct sqldbal_stmt *stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  PGresult *stmt_result;
+
+  (void)sql_len;
+
+  pq_db = db->handle;
+
+  pq_stmt = malloc(sizeof(*pq_stmt));
+  if(pq_stmt == NULL){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    stmt->handle = NULL;
+
+    pq_stmt->param_value_list    = NULL;
+    pq_stmt->param_buf_list      = NULL;
+    pq_stmt->param_buf_size_list = NULL;
+    pq_stmt->param_length_list   = NULL;
+    pq_stmt->param_format_list   = NULL;
+    pq_stmt->param_type_list     = NULL;
+    pq_stmt->column_type_list    = NULL;
+    pq_stmt->num_column_types    = 0;
+    pq_stmt->exec_result         = NULL;
+    pq_stmt->column_value_list   = NULL;
+    pq_stmt->column_value_size_list = NULL;
+    pq_stmt->column_conv_str_list = NULL;
+    pq_stmt->stream_pending      = 0;
+    pq_stmt->result_format       = 0;
+    pq_stmt->cursor_open         = 0;
+    pq_stmt->sql                 = sqldbal_strdup(sql);
+
+    if(pq_stmt->sql == NULL){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+      free(pq_stmt);
+    }
+    else if(sqldbal_pq_gen_stmt_name(db, pq_stmt) == SQLDBAL_STATUS_OK){
+      stmt_result = PQprepare(pq_db->db, pq_stmt->name, sql, 0, NULL);
+      if(stmt_result == NULL){
+        sqldbal_pq_error(db, SQLDBAL_STATUS_PREPARE);
+        free(pq_stmt->sql);
+        free(pq_stmt->name);
+        free(pq_stmt);
+      }
+      else{
+        if(PQresultStatus(stmt_result) != PGRES_COMMAND_OK){
+          sqldbal_status_code_set(db, SQLDBAL_STATUS_PREPARE);
+          sqldbal_errstr_set(db, PQresultErrorMessage(stmt_result));
+          free(pq_stmt->sql);
+          free(pq_stmt->name);
+          free(pq_stmt);
+        }
+        else if(sqldbal_pq_stmt_allocate_param_list(db, stmt, pq_stmt) < 0){
+          free(pq_stmt->sql);
+          free(pq_stmt->name);
+          free(pq_stmt);
+        }
+        else{
+          stmt->handle = pq_stmt;
+        }
+        PQclear(stmt_result);
+      }
+    }
+    else{
+      free(pq_stmt->sql);
+      free(pq_stmt->name);
+      free(pq_stmt);
+    }
+  }
+}
+
+/**
+ * The cursor gets declared when executing the statement, so this only
+ * checks that FETCH can take the prefetch count.
+ *
+ * @param[in] stmt          See @ref sqldbal_stmt.
+ * @param[in] prefetch_rows See @ref sqldbal_stmt_set_cursor.
+ */
+static void
+sqldbal_pq_stmt_cursor(struct sqldbal_stmt *const stmt,
+                       size_t prefetch_rows){
+  if(prefetch_rows > INT_MAX){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+}
+
+/**
+ * Assign a parameter value to a prepared statement placeholder.
+ *
+ * When copying, the value goes into the placeholder buffer owned by the
+ * statement, which only grows when a value does not fit.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] buf     Value to bind.
+ * @param[in] bufsz   Length of @p buf in bytes.
+ * @param[in] format  Text (0) or binary (1) format of @p buf.
+ * @param[in] copy    Set to 1 to copy @p buf, or 0 to reference @p buf
+ *                    directly.
+ */
+static void
+sqldbal_pq_stmt_bind_buf(struct sqldbal_stmt *const stmt,
+                         size_t col_idx,
+                         const void *const buf,
+                         size_t bufsz,
+                         int format,
+                         int copy){
+  struct sqldbal_pq_stmt *pq_stmt;
+  char *buf_copy;
+  const char *value;
+  size_t alloc_sz;
+  int bufsz_i;
+
+  if(si_size_to_int(bufsz, &bufsz_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    pq_stmt = stmt->handle;
+    value = buf;
+    if(copy){
+      buf_copy = pq_stmt->param_buf_list[col_idx];
+      if(buf_copy == NULL || bufsz > pq_stmt->param_buf_size_list[col_idx]){
+        /* realloc can return NULL for 0 bytes, so empty values get 1 byte. */
+        alloc_sz = bufsz ? bufsz : 1;
+        buf_copy = realloc(buf_copy, alloc_sz);
+        if(buf_copy){
+          pq_stmt->param_buf_list     [col_idx] = buf_copy;
+          pq_stmt->param_buf_size_list[col_idx] = alloc_sz;
+        }
+      }
+      if(buf_copy && bufsz){
+        memcpy(buf_copy, buf, bufsz);
+      }
+      value = buf_copy;
+    }
+
+    if(value == NULL){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      pq_stmt->param_value_list [col_idx] = value;
+      pq_stmt->param_length_list[col_idx] = bufsz_i;
+      pq_stmt->param_format_list[col_idx] = format;
+    }
+  }
+}
+
+/**
+ * Assign binary data to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
+ */
+static void
+sqldbal_pq_stmt_bind_blob(struct sqldbal_stmt *const stmt,
+                          size_t col_idx,
+                          const void *const blob,
+                          size_t blobsz){
+  sqldbal_pq_stmt_bind_buf(stmt, col_idx, blob, blobsz, 1, 1);
+}
+
+/**
+ * Reference binary data from a prepared statement placeholder without
+ * copying it.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
+ */
+static void
+sqldbal_pq_stmt_bind_blob_static(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 const void *const blob,
+                                 size_t blobsz){
+  sqldbal_pq_stmt_bind_buf(stmt, col_idx, blob, blobsz, 1, 0);
+}
+
+/**
+ * Assign a 64-bit integer to a prepared statement placeholder.
+ *
+ * Uses the binary format if the placeholder has an integer type large
+ * enough to hold @p i64 and the database has the
+ * @ref SQLDBAL_FLAG_PQ_BINARY flag. Otherwise, the integer gets sent as
+ * text and the server reports any range errors.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] i64     Integer to bind.
+ */
+static void
+sqldbal_pq_stmt_bind_int64(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           int64_t i64){
+  char i64_str[MAX_I64_STR_SZ];
+  unsigned char i64_bin[8];
+  int slen;
+  size_t slen_sz;
+  size_t nbytes;
+  int64_t limit;
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+
+  nbytes = 0;
+  if(stmt->db->flags & SQLDBAL_FLAG_PQ_BINARY){
+    nbytes = sqldbal_pq_type_int_size(pq_stmt->param_type_list[col_idx]);
+    if(nbytes > 0 && nbytes < 8){
+      limit = (int64_t)1 << (nbytes * 8 - 1);
+      if(i64 < -limit || i64 >= limit){
+        nbytes = 0;
+      }
+    }
+  }
+
+  if(nbytes){
+    sqldbal_pq_int_to_bin(i64, nbytes, i64_bin);
+    sqldbal_pq_stmt_bind_buf(stmt, col_idx, i64_bin, nbytes, 1, 1);
+  }
+  else{
+    slen = sprintf(i64_str, "%" PRIi64, i64);
+    if(slen < 0){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_BIND);
+    }
+    else{
+      /* Include the null-terminator. */
+      slen_sz = (size_t)slen;
+      slen_sz += 1;
+      sqldbal_pq_stmt_bind_buf(stmt, col_idx, i64_str, slen_sz, 0, 1);
+    }
+  }
+}
+
+/**
+ * Assign a text string to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] s       Text string saved to a SQL text type.
+ * @param[in] slen    Length of @p s in bytes.
+ */
+static void
+sqldbal_pq_stmt_bind_text(struct sqldbal_stmt *const stmt,
+                          size_t col_idx,
+                          const char *const s,
+                          size_t slen){
+  sqldbal_pq_stmt_bind_buf(stmt, col_idx, s, slen, 0, 1);
+}
+
+/**
+ * Reference a text string from a prepared statement placeholder without
+ * copying it.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] s       Text string saved to a SQL text type.
+ * @param[in] slen    Length of @p s in bytes.
+ */
+static void
+sqldbal_pq_stmt_bind_text_static(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 const char *const s,
+                                 size_t slen){
+  sqldbal_pq_stmt_bind_buf(stmt, col_idx, s, slen, 0, 0);
+}
+
+/**
+ * Assign a double-precision floating point number to a prepared statement
+ * placeholder.
+ *
+ * Uses the binary format if the placeholder has a floating point type and
+ * the database has the @ref SQLDBAL_FLAG_PQ_BINARY flag. Otherwise, the
+ * number gets sent as text with enough digits to restore the same value.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] d       Floating point number to bind.
+ */
+static void
+sqldbal_pq_stmt_bind_double(struct sqldbal_stmt *const stmt,
+                            size_t col_idx,
+                            double d){
+  char d_str[SQLDBAL_CONV_STR_SZ];
+  unsigned char d_bin[8];
+  size_t nbytes;
+  size_t slen;
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+
+  nbytes = 0;
+  if(stmt->db->flags & SQLDBAL_FLAG_PQ_BINARY){
+    nbytes = sqldbal_pq_type_float_size(pq_stmt->param_type_list[col_idx]);
+  }
+
+  if(nbytes){
+    sqldbal_pq_double_to_bin(d, nbytes, d_bin);
+    sqldbal_pq_stmt_bind_buf(stmt, col_idx, d_bin, nbytes, 1, 1);
+  }
+  else{
+    /* Include the null-terminator. */
+    slen = sqldbal_double_to_str(d, d_str) + 1;
+    sqldbal_pq_stmt_bind_buf(stmt, col_idx, d_str, slen, 0, 1);
+  }
+}
+
+/**
+ * Assign a timestamp to a prepared statement placeholder.
+ *
+ * Uses the binary format if the placeholder has a timestamp type and the
+ * database has the @ref SQLDBAL_FLAG_PQ_BINARY flag. Otherwise, the
+ * timestamp gets sent as text with a UTC offset so that timestamptz
+ * placeholders do not depend on the session time zone.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] ts      Microseconds since 1970-01-01 00:00:00 UTC.
+ */
+static void
+sqldbal_pq_stmt_bind_timestamp(struct sqldbal_stmt *const stmt,
+                               size_t col_idx,
+                               int64_t ts){
+  char ts_str[SQLDBAL_CONV_STR_SZ];
+  unsigned char ts_bin[8];
+  size_t slen;
+  int binary;
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+
+  binary = 0;
+  if((stmt->db->flags & SQLDBAL_FLAG_PQ_BINARY) &&
+     sqldbal_pq_type_timestamp_size(pq_stmt->param_type_list[col_idx]) == 8 &&
+     sqldbal_pq_timestamp_to_bin(ts, ts_bin) == 0){
+    binary = 1;
+  }
+
+  if(binary){
+    sqldbal_pq_stmt_bind_buf(stmt, col_idx, ts_bin, sizeof(ts_bin), 1, 1);
+  }
+  else{
+    slen = sqldbal_timestamp_to_str(ts, ts_str);
+    if(ts != INT64_MAX && ts != INT64_MIN){
+      strcpy(&ts_str[slen], "+00");
+      slen += 3;
+    }
+    /* Include the null-terminator. */
+    sqldbal_pq_stmt_bind_buf(stmt, col_idx, ts_str, slen + 1, 0, 1);
+  }
+}
+
+/**
+ * Assign a NULL value to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ */
+static void
+sqldbal_pq_stmt_bind_null(struct sqldbal_stmt *const stmt,
+                          size_t col_idx){
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+  pq_stmt->param_value_list [col_idx] = NULL;
+  pq_stmt->param_length_list[col_idx] = 0;
+  pq_stmt->param_format_list[col_idx] = 0;
+}
+
+/**
+ * Start a blob placeholder value that gets sent in chunks.
+ *
+ * PQexecPrepared needs the entire value when executing, so the chunks get
+ * collected in @ref sqldbal_stmt::stream_list and an empty value gets bound
+ * until the first chunk arrives.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ */
+static void
+sqldbal_pq_stmt_bind_blob_stream(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx){
+  if(sqldbal_stmt_stream_begin(stmt, col_idx) == 0){
+    sqldbal_pq_stmt_bind_blob_static(stmt, col_idx, "", 0);
+  }
+}
+
+/**
+ * Add the next chunk to a streamed blob placeholder value.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] chunk   Next bytes of the value.
+ * @param[in] chunksz Number of bytes in @p chunk.
+ */
+static void
+sqldbal_pq_stmt_send_blob(struct sqldbal_stmt *const stmt,
+                          size_t col_idx,
+                          const void *const chunk,
+                          size_t chunksz){
+  struct sqldbal_stmt_stream *stream;
+
+  stream = sqldbal_stmt_stream_append(stmt, col_idx, chunk, chunksz);
+  if(stream){
+    sqldbal_pq_stmt_bind_blob_static(stmt, col_idx, stream->buf, stream->len);
+  }
+}
+
+/**
+ * Discard the remaining rows in a streamed result.
+ *
+ * The connection cannot run other statements until it has read every
+ * result from the streamed query.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_stream_discard(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  PGresult *result;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+  if(pq_stmt->stream_pending){
+    /* https://www.postgresql.org/docs/current/libpq-async.html */
+    while((result = PQgetResult(pq_db->db)) != NULL){
+      PQclear(result);
+    }
+    pq_stmt->stream_pending = 0;
+  }
+}
+
+/**
+ * Send a compiled statement and request the results one row at a time.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return First result from the statement, or NULL if the statement failed
+ *         to send.
+ */
+static PGresult *
+sqldbal_pq_stmt_execute_stream(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  const char *const *const_param_value_list;
+  PGresult *result;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+  result = NULL;
+
+  const_param_value_list = (const char *const *)pq_stmt->param_value_list;
+  /* https://www.postgresql.org/docs/current/libpq-async.html */
+  if(PQsendQueryPrepared(pq_db->db,
+                         pq_stmt->name,
+                         (int)stmt->num_params,
+                         const_param_value_list,
+                         pq_stmt->param_length_list,
+                         pq_stmt->param_format_list,
+                         pq_stmt->result_format) == 1){
+    /*
+     * Failing to set single-row mode only means all rows arrive in the
+     * first result, which the fetch routine handles the same way.
+     */
+    /* https://www.postgresql.org/docs/current/libpq-single-row-mode.html */
+    PQsetSingleRowMode(pq_db->db);
+    pq_stmt->stream_pending = 1;
+    result = PQgetResult(pq_db->db);
+  }
+  return result;
+}
+
+/**
+ * Check if statements should get queued in pipeline mode.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @retval 1 Between @ref sqldbal_pipeline_begin and
+ *           @ref sqldbal_pipeline_end.
+ * @retval 0 Execute statements immediately.
+ */
+static int
+sqldbal_pq_pipeline_active(const struct sqldbal_db *const db){
+#ifdef LIBPQ_HAS_PIPELINING
+  return db->pipeline;
+#else /* !(LIBPQ_HAS_PIPELINING) */
+  (void)db;
+  return 0;
+#endif /* LIBPQ_HAS_PIPELINING */
+}
+
+/**
+ * Send a command in pipeline mode and remember which statement gets its
+ * result.
+ *
+ * @param[in] db   See @ref sqldbal_db.
+ * @param[in] stmt Send this compiled statement with its bound parameters.
+ * @param[in] sql  Send this command instead if @p stmt is NULL.
+ */
+static void
+sqldbal_pq_pipeline_queue(struct sqldbal_db *const db,
+                          struct sqldbal_stmt *const stmt,
+                          const char *const sql){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  struct sqldbal_stmt **pipeline_list;
+  size_t pipeline_size;
+  int rc;
+
+  pq_db = db->handle;
+  if(pq_db->pipeline_len == pq_db->pipeline_size){
+    pipeline_size = pq_db->pipeline_size ? pq_db->pipeline_size * 2 : 16;
+    pipeline_list = sqldbal_reallocarray(pq_db->pipeline_list,
+                                         pipeline_size,
+                                         sizeof(*pipeline_list));
+    if(pipeline_list == NULL){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      pq_db->pipeline_list = pipeline_list;
+      pq_db->pipeline_size = pipeline_size;
+    }
+  }
+
+  if(pq_db->pipeline_len < pq_db->pipeline_size){
+    /* https://www.postgresql.org/docs/current/libpq-async.html */
+    if(stmt){
+      pq_stmt = stmt->handle;
+      rc = PQsendQueryPrepared(
+        pq_db->db,
+        pq_stmt->name,
+        (int)stmt->num_params,
+        (const char *const *)pq_stmt->param_value_list,
+        pq_stmt->param_length_list,
+        pq_stmt->param_format_list,
+        pq_stmt->result_format);
+    }
+    else{
+      rc = PQsendQueryParams(pq_db->db, sql, 0, NULL, NULL, NULL, NULL, 0);
+    }
+    if(rc != 1){
+      sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+    }
+    else{
+      pq_db->pipeline_list[pq_db->pipeline_len] = stmt;
+      pq_db->pipeline_len += 1;
+    }
+  }
+}
+
+/**
+ * Check the first result of an executed statement and prepare the
+ * statement for fetching rows.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_execute_result(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  ExecStatusType pq_status;
+  int pq_nfields;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+  pq_status = PQresultStatus(pq_stmt->exec_result);
+  if(pq_status != PGRES_COMMAND_OK &&
+     pq_status != PGRES_TUPLES_OK &&
+     pq_status != PGRES_SINGLE_TUPLE){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_EXEC);
+    if(pq_stmt->exec_result){
+      sqldbal_errstr_set(stmt->db,
+                         PQresultErrorMessage(pq_stmt->exec_result));
+    }
+    else{
+      sqldbal_errstr_set(stmt->db, PQerrorMessage(pq_db->db));
+    }
+    pq_stmt->exec_row_count = 0;
+  }
+  else{
+    pq_stmt->exec_row_count = PQntuples(pq_stmt->exec_result);
+    pq_nfields = PQnfields(pq_stmt->exec_result);
+    if(si_int_to_size(pq_nfields, &stmt->num_cols_result)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else if(stmt->num_cols_result && pq_stmt->column_value_list == NULL){
+      pq_stmt->column_value_list = calloc(stmt->num_cols_result,
+                                          sizeof(*pq_stmt->column_value_list));
+      pq_stmt->column_value_size_list = calloc(
+        stmt->num_cols_result,
+        sizeof(*pq_stmt->column_value_size_list));
+      if(pq_stmt->column_value_list      == NULL ||
+         pq_stmt->column_value_size_list == NULL){
+        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+        free(pq_stmt->column_value_list);
+        free(pq_stmt->column_value_size_list);
+        pq_stmt->column_value_list      = NULL;
+        pq_stmt->column_value_size_list = NULL;
+      }
+    }
+  }
+
+  /* Keep reading the streamed rows in sqldbal_pq_stmt_fetch. */
+  if(pq_status != PGRES_SINGLE_TUPLE){
+    sqldbal_pq_stmt_stream_discard(stmt);
+  }
+  pq_stmt->fetch_row_index = 0;
+}
+
+/**
+ * Close the server-side cursor if it has rows left to fetch.
+ *
+ * Errors get ignored because the cursor no longer exists if the
+ * transaction that declared it failed.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_cursor_close(struct sqldbal_stmt *const stmt){
+  /* strlen("CLOSE ") + longest statement name + null-terminator */
+  char sql[6 + 23 + 1];
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+  if(pq_stmt->cursor_open){
+    pq_stmt->cursor_open = 0;
+    strcpy(sql, "CLOSE ");
+    strcat(sql, pq_stmt->name);
+    if(sqldbal_pq_pipeline_active(stmt->db)){
+      sqldbal_pq_pipeline_queue(stmt->db, NULL, sql);
+    }
+    else{
+      PQclear(PQexec(pq_db->db, sql));
+    }
+  }
+}
+
+/**
+ * Fetch the next batch of rows from the server-side cursor into
+ * @ref sqldbal_pq_stmt::exec_result.
+ *
+ * The cursor gets closed after a batch with fewer rows than requested.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_cursor_fetch(struct sqldbal_stmt *const stmt){
+  /*
+   * strlen("FETCH FORWARD ") + longest prefetch count + strlen(" FROM ") +
+   * longest statement name + null-terminator
+   */
+  char sql[14 + 20 + 6 + 23 + 1];
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+
+  PQclear(pq_stmt->exec_result);
+  sprintf(sql,
+          "FETCH FORWARD %lu FROM %s",
+          (unsigned long)stmt->cursor_prefetch,
+          pq_stmt->name);
+  /* https://www.postgresql.org/docs/current/sql-fetch.html */
+  pq_stmt->exec_result = PQexecParams(pq_db->db,
+                                      sql,
+                                      0,
+                                      NULL,
+                                      NULL,
+                                      NULL,
+                                      NULL,
+                                      pq_stmt->result_format);
+  sqldbal_pq_stmt_execute_result(stmt);
+  if(sqldbal_status_code_get(stmt->db) != SQLDBAL_STATUS_OK ||
+     (size_t)pq_stmt->exec_row_count < stmt->cursor_prefetch){
+    sqldbal_pq_stmt_cursor_close(stmt);
+  }
+}
+
+/**
+ * Declare a server-side cursor for the statement and fetch the first batch
+ * of rows.
+ *
+ * The cursor gets declared WITH HOLD so that it stays open after the
+ * transaction commits. Outside of a transaction, the server computes the
+ * full result when declaring the cursor and keeps it until the cursor
+ * closes, while the client still only holds one batch of rows.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_execute_cursor(struct sqldbal_stmt *const stmt){
+  const char *const declare_start = "DECLARE ";
+  const char *const declare_end = " NO SCROLL CURSOR WITH HOLD FOR ";
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  PGresult *result;
+  char *sql;
+  size_t sql_len;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+
+  sqldbal_pq_stmt_cursor_close(stmt);
+
+  /* The cursor shares the name of the prepared statement. */
+  sql_len = strlen(declare_start) + strlen(pq_stmt->name) +
+            strlen(declare_end) + strlen(pq_stmt->sql) + 1;
+  sql = malloc(sql_len);
+  if(sql == NULL){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    strcpy(sql, declare_start);
+    strcat(sql, pq_stmt->name);
+    strcat(sql, declare_end);
+    strcat(sql, pq_stmt->sql);
+    /* https://www.postgresql.org/docs/current/sql-declare.html */
+    result = PQexecParams(pq_db->db,
+                          sql,
+                          (int)stmt->num_params,
+                          NULL,
+                          (const char *const *)pq_stmt->param_value_list,
+                          pq_stmt->param_length_list,
+                          pq_stmt->param_format_list,
+                          0);
+    if(PQresultStatus(result) != PGRES_COMMAND_OK){
+      sqldbal_err_set(stmt->db,
+                      SQLDBAL_STATUS_EXEC,
+                      PQresultErrorMessage(result));
+    }
+    else{
+      pq_stmt->cursor_open = 1;
+      sqldbal_pq_stmt_cursor_fetch(stmt);
+    }
+    PQclear(result);
+    free(sql);
+  }
+}
+
+/**
+ * Execute a compiled statement with bound parameters.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_execute(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  int pq_num_param_list;
+  const char *const *const_param_value_list;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+
+  sqldbal_pq_stmt_stream_discard(stmt);
+  sqldbal_pq_stmt_cursor_close(stmt);
+  if(pq_stmt->exec_result){
+    PQclear(pq_stmt->exec_result);
+    pq_stmt->exec_result = NULL;
+  }
+
+  /*
+   * Already compatible with int because of conversion in
+   * @ref sqldbal_pq_stmt_allocate_param_list.
+   */
+  pq_num_param_list = (int)stmt->num_params;
+
+  if(sqldbal_pq_pipeline_active(stmt->db)){
+    /* The result gets read by sqldbal_pq_pipeline_end. */
+    pq_stmt->exec_row_count  = 0;
+    pq_stmt->fetch_row_index = 0;
+    sqldbal_pq_pipeline_queue(stmt->db, stmt, NULL);
+  }
+  else if(stmt->cursor_prefetch && pq_stmt->num_column_types){
+    /* Only statements that return rows can use a cursor. */
+    sqldbal_pq_stmt_execute_cursor(stmt);
+  }
+  else{
+    if(stmt->db->flags & SQLDBAL_FLAG_STREAM_RESULTS){
+      pq_stmt->exec_result = sqldbal_pq_stmt_execute_stream(stmt);
+    }
+    else{
+      const_param_value_list = (const char *const *)pq_stmt->param_value_list;
+      pq_stmt->exec_result = PQexecPrepared(pq_db->db,
+                                            pq_stmt->name,
+                                            pq_num_param_list,
+                                            const_param_value_list,
+                                            pq_stmt->param_length_list,
+                                            pq_stmt->param_format_list,
+                                            pq_stmt->result_format);
+    }
+    sqldbal_pq_stmt_execute_result(stmt);
+  }
+}
+
+/**
+ * Send a compiled statement without waiting for the result.
+ *
+ * The connection stays in non-blocking mode until
+ * @ref sqldbal_pq_stmt_execute_finish.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_execute_start(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  const char *const *const_param_value_list;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+
+  sqldbal_pq_stmt_stream_discard(stmt);
+  sqldbal_pq_stmt_cursor_close(stmt);
+  PQclear(pq_stmt->exec_result);
+  pq_stmt->exec_result = NULL;
+
+  const_param_value_list = (const char *const *)pq_stmt->param_value_list;
+  /* https://www.postgresql.org/docs/current/libpq-async.html */
+  if(PQsetnonblocking(pq_db->db, 1) != 0 ||
+     PQsendQueryPrepared(pq_db->db,
+                         pq_stmt->name,
+                         (int)stmt->num_params,
+                         const_param_value_list,
+                         pq_stmt->param_length_list,
+                         pq_stmt->param_format_list,
+                         pq_stmt->result_format) != 1){
+    sqldbal_pq_error(stmt->db, SQLDBAL_STATUS_EXEC);
+    PQsetnonblocking(pq_db->db, 0);
+  }
+  else if(stmt->db->flags & SQLDBAL_FLAG_STREAM_RESULTS){
+    /* https://www.postgresql.org/docs/current/libpq-single-row-mode.html */
+    PQsetSingleRowMode(pq_db->db);
+  }
+}
+
+/**
+ * Send any queued data and read the data available on the socket without
+ * blocking.
+ *
+ * @param[in]  stmt        See @ref sqldbal_stmt.
+ * @param[out] wait_events See @ref sqldbal_wait_event.
+ */
+static void
+sqldbal_pq_stmt_execute_poll(struct sqldbal_stmt *const stmt,
+                             int *const wait_events){
+  struct sqldbal_pq_db *pq_db;
+  int flush_rc;
+
+  pq_db = stmt->db->handle;
+
+  /* https://www.postgresql.org/docs/current/libpq-async.html */
+  flush_rc = PQflush(pq_db->db);
+  if(flush_rc < 0 || PQconsumeInput(pq_db->db) != 1){
+    sqldbal_pq_error(stmt->db, SQLDBAL_STATUS_EXEC);
+    *wait_events = 0;
+  }
+  else if(flush_rc == 1){
+    /* The server might need to send data before it accepts more. */
+    *wait_events = SQLDBAL_WAIT_READ | SQLDBAL_WAIT_WRITE;
+  }
+  else if(PQisBusy(pq_db->db)){
+    *wait_events = SQLDBAL_WAIT_READ;
+  }
+  else{
+    *wait_events = 0;
+  }
+}
+
+/**
+ * Read the result of a statement started by
+ * @ref sqldbal_pq_stmt_execute_start and put the connection back into
+ * blocking mode.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_execute_finish(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+
+  /* https://www.postgresql.org/docs/current/libpq-async.html */
+  if(PQsetnonblocking(pq_db->db, 0) != 0){
+    sqldbal_pq_error(stmt->db, SQLDBAL_STATUS_EXEC);
+  }
+
+  /* The remaining results get read in the same way as a streamed query. */
+  pq_stmt->stream_pending = 1;
+  pq_stmt->exec_result = PQgetResult(pq_db->db);
+  sqldbal_pq_stmt_execute_result(stmt);
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+/**
+ * Read every result queued in pipeline mode up to the synchronization point.
+ *
+ * The first statement error gets saved in the database context.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_pipeline_consume(struct sqldbal_db *const db){
+  struct sqldbal_pq_db *pq_db;
+  PGresult *result;
+  ExecStatusType pq_status;
+  int prev_null;
+  int done;
+
+  pq_db = db->handle;
+  prev_null = 0;
+  done = 0;
+  while(!done){
+    /* https://www.postgresql.org/docs/current/libpq-pipeline-mode.html */
+    result = PQgetResult(pq_db->db);
+    if(result == NULL){
+      /* Two NULL results in a row means nothing else remains queued. */
+      done = prev_null;
+      prev_null = 1;
+    }
+    else{
+      prev_null = 0;
+      pq_status = PQresultStatus(result);
+      if(pq_status == PGRES_PIPELINE_SYNC){
+        done = 1;
+      }
+      else if(pq_status == PGRES_FATAL_ERROR &&
+              sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+        sqldbal_err_set(db,
+                        SQLDBAL_STATUS_EXEC,
+                        PQresultErrorMessage(result));
+      }
+      PQclear(result);
+    }
+  }
+}
+
+/**
+ * Queue a statement without parameters in pipeline mode.
+ *
+ * @param[in] db  See @ref sqldbal_db.
+ * @param[in] sql SQL command to queue.
+ */
+static void
+sqldbal_pq_pipeline_send_noparam(struct sqldbal_db *const db,
+                                 const char *const sql){
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = db->handle;
+  /* https://www.postgresql.org/docs/current/libpq-async.html */
+  if(PQsendQueryParams(pq_db->db, sql, 0, NULL, NULL, NULL, NULL, 0) != 1){
+    sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+  }
+}
+
+/**
+ * Execute a batch by queuing every row in pipeline mode.
+ *
+ * All rows get sent before reading any of the results, which avoids waiting
+ * on a network round trip for each row.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in @p param_list.
+ */
+static void
+sqldbal_pq_stmt_execute_pipeline(
+  struct sqldbal_stmt *const stmt,
+  const struct sqldbal_batch_param *const param_list,
+  size_t num_rows){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  const char *const *const_param_value_list;
+  int pq_num_param_list;
+  int implicit_transaction;
+  size_t row;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+
+  /*
+   * Already compatible with int because of conversion in
+   * @ref sqldbal_pq_stmt_allocate_param_list.
+   */
+  pq_num_param_list = (int)stmt->num_params;
+
+  /* https://www.postgresql.org/docs/current/libpq-status.html */
+  implicit_transaction = PQtransactionStatus(pq_db->db) == PQTRANS_IDLE;
+
+  /* https://www.postgresql.org/docs/current/libpq-pipeline-mode.html */
+  if(PQenterPipelineMode(pq_db->db) != 1){
+    sqldbal_pq_error(stmt->db, SQLDBAL_STATUS_EXEC);
+  }
+  else{
+    if(implicit_transaction){
+      sqldbal_pq_pipeline_send_noparam(stmt->db, "BEGIN");
+    }
+    const_param_value_list = (const char *const *)pq_stmt->param_value_list;
+    for(row = 0;
+        row < num_rows &&
+        sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK;
+        row++){
+      sqldbal_stmt_batch_bind_row(stmt, param_list, row);
+      if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK &&
+         PQsendQueryPrepared(pq_db->db,
+                             pq_stmt->name,
+                             pq_num_param_list,
+                             const_param_value_list,
+                             pq_stmt->param_length_list,
+                             pq_stmt->param_format_list,
+                             0) != 1){
+        sqldbal_pq_error(stmt->db, SQLDBAL_STATUS_EXEC);
+      }
+    }
+    if(implicit_transaction &&
+       sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      sqldbal_pq_pipeline_send_noparam(stmt->db, "COMMIT");
+    }
+    if(PQpipelineSync(pq_db->db) != 1){
+      if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+        sqldbal_pq_error(stmt->db, SQLDBAL_STATUS_EXEC);
+      }
+    }
+    else{
+      sqldbal_pq_pipeline_consume(stmt->db);
+    }
+    PQexitPipelineMode(pq_db->db);
+
+    /* Discard every row if the transaction did not get committed. */
+    if(implicit_transaction &&
+       PQtransactionStatus(pq_db->db) != PQTRANS_IDLE){
+      PQclear(PQexec(pq_db->db, "ROLLBACK"));
+    }
+  }
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
+/**
+ * Enter pipeline mode.
+ *
+ * Statements execute immediately if the pq library does not support
+ * pipeline mode.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_pipeline_begin(struct sqldbal_db *const db){
+#ifdef LIBPQ_HAS_PIPELINING
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = db->handle;
+  pq_db->pipeline_len = 0;
+  /* https://www.postgresql.org/docs/current/libpq-pipeline-mode.html */
+  if(PQenterPipelineMode(pq_db->db) != 1){
+    sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+  }
+#else /* !(LIBPQ_HAS_PIPELINING) */
+  (void)db;
+#endif /* LIBPQ_HAS_PIPELINING */
+}
+
+/**
+ * Send the synchronization point, give each queued statement its result,
+ * and leave pipeline mode.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_pq_pipeline_end(struct sqldbal_db *const db){
+#ifdef LIBPQ_HAS_PIPELINING
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  struct sqldbal_stmt *stmt;
+  PGresult *result;
+  PGresult *extra;
+  size_t i;
+
+  pq_db = db->handle;
+
+  /* https://www.postgresql.org/docs/current/libpq-pipeline-mode.html */
+  if(PQpipelineSync(pq_db->db) != 1){
+    sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+  }
+  else{
+    for(i = 0; i < pq_db->pipeline_len; i++){
+      result = PQgetResult(pq_db->db);
+      if(result == NULL){
+        if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+          sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+        }
+      }
+      else{
+        /* Each queued command ends with a NULL result. */
+        while((extra = PQgetResult(pq_db->db)) != NULL){
+          PQclear(extra);
+        }
+        stmt = pq_db->pipeline_list[i];
+        if(stmt){
+          pq_stmt = stmt->handle;
+          PQclear(pq_stmt->exec_result);
+          pq_stmt->exec_result = result;
+
+          /* Statements after a failure only return PGRES_PIPELINE_ABORTED. */
+          if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+            sqldbal_pq_stmt_execute_result(stmt);
+          }
+        }
+        else{
+          if(PQresultStatus(result) == PGRES_FATAL_ERROR &&
+             sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+            sqldbal_err_set(db,
+                            SQLDBAL_STATUS_EXEC,
+                            PQresultErrorMessage(result));
+          }
+          PQclear(result);
+        }
+      }
+    }
+    sqldbal_pq_pipeline_consume(db);
+  }
+  pq_db->pipeline_len = 0;
+  if(PQexitPipelineMode(pq_db->db) != 1 &&
+     sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    sqldbal_pq_error(db, SQLDBAL_STATUS_EXEC);
+  }
+#else /* !(LIBPQ_HAS_PIPELINING) */
+  (void)db;
+#endif /* LIBPQ_HAS_PIPELINING */
+}
+
+/**
+ * Execute a compiled statement once for each row of column-wise values.
+ *
+ * Uses pipeline mode when available. Older versions of the pq library
+ * execute the statement for each row in a single transaction.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in @p param_list.
+ */
+static void
+sqldbal_pq_stmt_execute_batch(
+  struct sqldbal_stmt *const stmt,
+  const struct sqldbal_batch_param *const param_list,
+  size_t num_rows){
+  struct sqldbal_pq_stmt *pq_stmt;
+#ifndef LIBPQ_HAS_PIPELINING
+  struct sqldbal_pq_db *pq_db;
+  int implicit_transaction;
+
+  pq_db = stmt->db->handle;
+#endif /* !(LIBPQ_HAS_PIPELINING) */
+
+  pq_stmt = stmt->handle;
+
+  sqldbal_pq_stmt_stream_discard(stmt);
+  if(num_rows < 2 || sqldbal_pq_pipeline_active(stmt->db)){
+    /* Each row gets queued when already in pipeline mode. */
+    sqldbal_stmt_execute_batch_loop(stmt, param_list, num_rows);
+  }
+  else{
+#ifdef LIBPQ_HAS_PIPELINING
+    sqldbal_pq_stmt_execute_pipeline(stmt, param_list, num_rows);
+#else /* !(LIBPQ_HAS_PIPELINING) */
+    implicit_transaction = PQtransactionStatus(pq_db->db) == PQTRANS_IDLE;
+    if(implicit_transaction){
+      sqldbal_pq_begin_transaction(stmt->db);
+    }
+    sqldbal_stmt_execute_batch_loop(stmt, param_list, num_rows);
+    if(implicit_transaction){
+      if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+        sqldbal_pq_commit(stmt->db);
+      }
+      else{
+        PQclear(PQexec(pq_db->db, "ROLLBACK"));
+      }
+    }
+#endif /* LIBPQ_HAS_PIPELINING */
+  }
+
+  /* Batches do not produce a result set for sqldbal_stmt_fetch. */
+  PQclear(pq_stmt->exec_result);
+  pq_stmt->exec_result     = NULL;
+  pq_stmt->exec_row_count  = 0;
+  pq_stmt->fetch_row_index = 0;
+}
+
+/**
+ * Free the column values held in the @ref sqldbal_pq_stmt::column_value_list.
+ *
+ * This does not free the actual list. It will eventually get free'd in
+ * @ref sqldbal_pq_stmt_close
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_free_column_values(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_stmt *pq_stmt;
+  size_t i;
+
+  pq_stmt = stmt->handle;
+  if(pq_stmt->column_value_list){
+    for(i = 0; i < stmt->num_cols_result; i++){
+      free(pq_stmt->column_value_list[i]);
+      pq_stmt->column_value_list[i] = NULL;
+    }
+  }
+}
+
+/**
+ * Read the next row from a streamed result.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return See @ref sqldbal_fetch_result.
+ */
+static enum sqldbal_fetch_result
+sqldbal_pq_stmt_fetch_stream(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_stmt *pq_stmt;
+  ExecStatusType pq_status;
+  enum sqldbal_fetch_result fetch_result;
+
+  pq_db = stmt->db->handle;
+  pq_stmt = stmt->handle;
+
+  PQclear(pq_stmt->exec_result);
+  /* https://www.postgresql.org/docs/current/libpq-single-row-mode.html */
+  pq_stmt->exec_result = PQgetResult(pq_db->db);
+  pq_stmt->exec_row_count = 0;
+  pq_stmt->fetch_row_index = 0;
+  pq_status = PQresultStatus(pq_stmt->exec_result);
+  if(pq_status == PGRES_SINGLE_TUPLE || pq_status == PGRES_TUPLES_OK){
+    pq_stmt->exec_row_count = PQntuples(pq_stmt->exec_result);
+    if(pq_stmt->exec_row_count > 0){
+      pq_stmt->fetch_row_index = 1;
+      fetch_result = SQLDBAL_FETCH_ROW;
+    }
+    else{
+      fetch_result = SQLDBAL_FETCH_DONE;
+    }
+  }
+  else{
+    sqldbal_err_set(stmt->db,
+                    SQLDBAL_STATUS_FETCH,
+                    PQresultErrorMessage(pq_stmt->exec_result));
+    fetch_result = SQLDBAL_FETCH_ERROR;
+  }
+
+  if(pq_status != PGRES_SINGLE_TUPLE){
+    sqldbal_pq_stmt_stream_discard(stmt);
+  }
+  return fetch_result;
+}
+
+/**
+ * Get the next row in the result set.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return See @ref sqldbal_fetch_result.
+ */
+static enum sqldbal_fetch_result
+sqldbal_pq_stmt_fetch(struct sqldbal_stmt *const stmt){
+  enum sqldbal_fetch_result fetch_result;
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+  if(pq_stmt->fetch_row_index < pq_stmt->exec_row_count){
+    pq_stmt->fetch_row_index += 1;
+    fetch_result = SQLDBAL_FETCH_ROW;
+  }
+  else if(pq_stmt->stream_pending){
+    fetch_result = sqldbal_pq_stmt_fetch_stream(stmt);
+  }
+  else if(pq_stmt->cursor_open){
+    sqldbal_pq_stmt_cursor_fetch(stmt);
+    if(sqldbal_status_code_get(stmt->db) != SQLDBAL_STATUS_OK){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_FETCH);
+      fetch_result = SQLDBAL_FETCH_ERROR;
+    }
+    else if(pq_stmt->exec_row_count > 0){
+      pq_stmt->fetch_row_index = 1;
+      fetch_result = SQLDBAL_FETCH_ROW;
+    }
+    else{
+      fetch_result = SQLDBAL_FETCH_DONE;
+    }
+  }
+  else{
+    fetch_result = SQLDBAL_FETCH_DONE;
+  }
+  return fetch_result;
+}
+
+/**
+ * Get the number of rows in the result set held in
+ * @ref sqldbal_pq_stmt::exec_result.
+ *
+ * Streamed results and cursors only hold part of the rows.
+ *
+ * @param[in]  stmt     See @ref sqldbal_stmt.
+ * @param[out] num_rows Number of rows in the result set.
+ */
+static void
+sqldbal_pq_stmt_num_rows(struct sqldbal_stmt *const stmt,
+                         uint64_t *num_rows){
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+  if(pq_stmt->stream_pending || pq_stmt->cursor_open){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+  }
+  else{
+    *num_rows = (uint64_t)pq_stmt->exec_row_count;
+  }
+}
+
+/**
+ * Move to a row in the result set held in
+ * @ref sqldbal_pq_stmt::exec_result.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @param[in] row  Row number starting at 0.
+ */
+static void
+sqldbal_pq_stmt_seek(struct sqldbal_stmt *const stmt,
+                     uint64_t row){
+  struct sqldbal_pq_stmt *pq_stmt;
+
+  pq_stmt = stmt->handle;
+  if(pq_stmt->stream_pending || pq_stmt->cursor_open){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+  }
+  else if(row > (uint64_t)pq_stmt->exec_row_count){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    /* The next fetch moves to this row. */
+    pq_stmt->fetch_row_index = (int)row;
+  }
+}
+
+/**
+ * Get a buffer from @ref sqldbal_pq_stmt::column_value_list that can hold
+ * at least @p size bytes.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Column index.
+ * @param[in] size    Number of bytes needed.
+ * @return Column buffer, or NULL if the memory allocation failed.
+ */
+static char *
+sqldbal_pq_stmt_column_buf(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           size_t size){
+  struct sqldbal_pq_stmt *pq_stmt;
+  char *buf;
+
+  pq_stmt = stmt->handle;
+  buf = pq_stmt->column_value_list[col_idx];
+  if(size > pq_stmt->column_value_size_list[col_idx]){
+    buf = realloc(buf, size);
+    if(buf){
+      pq_stmt->column_value_list[col_idx] = buf;
+      pq_stmt->column_value_size_list[col_idx] = size;
+    }
+  }
+  return buf;
+}
+
+/**
+ * Convert a binary column result to a string that matches the text format
+ * sent by the server.
+ *
+ * The string gets stored in the per-column slot of the
+ * @ref sqldbal_pq_stmt::column_conv_str_list buffer so that it remains
+ * valid until the next fetch.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[in]  bin     Binary value from the result.
+ * @param[out] textsz  Number of bytes in the string, excluding the
+ *                     null-terminator.
+ * @return Null-terminated string, or NULL if the value could not get
+ *         converted.
+ */
+static const char *
+sqldbal_pq_stmt_column_conv_str(struct sqldbal_stmt *const stmt,
+                                size_t col_idx,
+                                const unsigned char *const bin,
+                                size_t *textsz){
+  struct sqldbal_pq_stmt *pq_stmt;
+  enum sqldbal_pq_type type;
+  char *conv_str;
+  const char *date_end;
+  size_t nbytes;
+  int64_t ts;
+  float f;
+  float round_trip;
+
+  pq_stmt = stmt->handle;
+  type = pq_stmt->column_type_list[col_idx];
+  conv_str = &pq_stmt->column_conv_str_list[col_idx * SQLDBAL_CONV_STR_SZ];
+  *textsz = 0;
+
+  if((nbytes = sqldbal_pq_type_int_size(type)) != 0){
+    *textsz = (size_t)sprintf(conv_str,
+                              "%" PRIi64,
+                              sqldbal_pq_bin_to_int(bin, nbytes));
+  }
+  else if(type == SQLDBAL_PQ_TYPE_FLOAT4){
+    /* Use the fewest digits that restore the same float4 value. */
+    f = (float)sqldbal_pq_bin_to_double(bin, 4);
+    *textsz = (size_t)sprintf(conv_str, "%.6g", (double)f);
+    round_trip = strtof(conv_str, NULL);
+    if(memcmp(&round_trip, &f, sizeof(f)) != 0){
+      *textsz = (size_t)sprintf(conv_str, "%.9g", (double)f);
+    }
+  }
+  else if(type == SQLDBAL_PQ_TYPE_FLOAT8){
+    *textsz = sqldbal_double_to_str(sqldbal_pq_bin_to_double(bin, 8),
+                                    conv_str);
+  }
+  else if(type == SQLDBAL_PQ_TYPE_BOOL){
+    conv_str[0] = bin[0] ? 't' : 'f';
+    conv_str[1] = '\0';
+    *textsz = 1;
+  }
+  else if(sqldbal_pq_bin_to_timestamp(bin,
+                                      sqldbal_pq_type_timestamp_size(type),
+                                      &ts)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+    conv_str = NULL;
+  }
+  else{
+    *textsz = sqldbal_timestamp_to_str(ts, conv_str);
+    if(ts == INT64_MAX || ts == INT64_MIN){
+      /* Keep "infinity" and "-infinity" unchanged. */
+    }
+    else if(type == SQLDBAL_PQ_TYPE_DATE){
+      date_end = strchr(conv_str, ' ');
+      *textsz = (size_t)(date_end - conv_str);
+      conv_str[*textsz] = '\0';
+    }
+    else if(type == SQLDBAL_PQ_TYPE_TIMESTAMPTZ){
+      strcpy(&conv_str[*textsz], "+00");
+      *textsz += 3;
+    }
+  }
+  return conv_str;
+}
+
+/**
+ * Get the column result as blob/binary data.
+ *
+ * Binary format results need no decoding, except for the numeric, boolean,
+ * and timestamp types which get converted to a string.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] blob    Binary data.
+ * @param[out] blobsz  Number of bytes in @p blob.
+ */
+static void
+sqldbal_pq_stmt_column_blob(struct sqldbal_stmt *const stmt,
+                            size_t col_idx,
+                            const void **blob,
+                            size_t *blobsz){
+  struct sqldbal_pq_stmt *pq_stmt;
+  int row_number;
+  int col_no_i;
+  const char *blob_offset;
+  char *hex2bin;
+  int pq_length;
+  size_t hexlen;
+
+  pq_stmt = stmt->handle;
+  row_number = pq_stmt->fetch_row_index - 1;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+    *blob = NULL;
+  }
+  else{
+    *blob = PQgetvalue(pq_stmt->exec_result,
+                       row_number,
+                       col_no_i);
+    pq_length = PQgetlength(pq_stmt->exec_result,
+                            row_number,
+                            col_no_i);
+    if(si_int_to_size(pq_length, blobsz)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+    }
+    else if(*blobsz == 0 &&
+       PQgetisnull(pq_stmt->exec_result, row_number, col_no_i)){
+      *blob = NULL;
+    }
+    else if(pq_stmt->result_format){
+      if(pq_stmt->column_type_list[col_idx] != SQLDBAL_PQ_TYPE_BYTEA &&
+         pq_stmt->column_type_list[col_idx] != SQLDBAL_PQ_TYPE_TEXT){
+        *blob = sqldbal_pq_stmt_column_conv_str(stmt, col_idx, *blob, blobsz);
+      }
+    }
+    else if(strncmp(*blob, "\\x", 2) == 0){
+      blob_offset = *blob;
+      blob_offset += 2;
+      hexlen = *blobsz - 2;
+
+      /* Include room for a null-terminator. */
+      hex2bin = sqldbal_pq_stmt_column_buf(stmt, col_idx, hexlen / 2 + 1);
+      if(hex2bin == NULL){
+        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+        *blobsz = 0;
+      }
+      else if(sqldbal_hex2bin_buf(blob_offset,
+                                  hexlen,
+                                  (unsigned char *)hex2bin) < 0){
+        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+        hex2bin = NULL;
+        *blobsz = 0;
+      }
+      else{
+        *blobsz = hexlen / 2;
+        hex2bin[*blobsz] = '\0';
+      }
+      *blob = hex2bin;
+    }
+  }
+}
+
+/**
+ * Copy part of the column result into a buffer.
+ *
+ * Text format BYTEA values only get decoded for the requested range, which
+ * avoids converting the entire value for each chunk.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[in]  offset  Read the bytes starting at this position.
+ * @param[out] buf     Buffer receiving the bytes.
+ * @param[in]  bufsz   Maximum number of bytes to read.
+ * @param[out] len     Number of bytes read.
+ */
+static void
+sqldbal_pq_stmt_column_blob_read(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 uint64_t offset,
+                                 void *const buf,
+                                 size_t bufsz,
+                                 size_t *const len){
+  struct sqldbal_pq_stmt *pq_stmt;
+  int row_number;
+  int col_no_i;
+  const char *value;
+  const void *blob;
+  size_t blobsz;
+  size_t binsz;
+
+  pq_stmt = stmt->handle;
+  row_number = pq_stmt->fetch_row_index - 1;
+  *len = 0;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    value = PQgetvalue(pq_stmt->exec_result, row_number, col_no_i);
+    if(pq_stmt->result_format == 0 && strncmp(value, "\\x", 2) == 0){
+      if(si_int_to_size(PQgetlength(pq_stmt->exec_result,
+                                    row_number,
+                                    col_no_i),
+                        &binsz)){
+        sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+      }
+      else{
+        binsz = (binsz - 2) / 2;
+        if(offset < binsz){
+          *len = binsz - (size_t)offset;
+          if(*len > bufsz){
+            *len = bufsz;
+          }
+          if(sqldbal_hex2bin_buf(&value[2 + offset * 2],
+                                 *len * 2,
+                                 buf) < 0){
+            sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+            *len = 0;
+          }
+        }
+      }
+    }
+    else{
+      sqldbal_pq_stmt_column_blob(stmt, col_idx, &blob, &blobsz);
+      sqldbal_blob_copy(blob, blobsz, offset, buf, bufsz, len);
+    }
+  }
+}
+
+/**
+ * Get the column result as a string.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] text    Null-terminated string.
+ * @param[out] textsz  Number of bytes in @p text.
+ */
+static void
+sqldbal_pq_stmt_column_text(struct sqldbal_stmt *const stmt,
+                            size_t col_idx,
+                            const char **text,
+                            size_t *textsz){
+  const void *blob;
+
+  sqldbal_pq_stmt_column_blob(stmt, col_idx, &blob, textsz);
+  *text = blob;
+}
+
+/**
+ * Get the column data type.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @return See @ref sqldbal_column_type.
+ */
+static enum sqldbal_column_type
+sqldbal_pq_stmt_column_type(struct sqldbal_stmt *const stmt,
+                            size_t col_idx){
+  enum sqldbal_column_type type;
+  struct sqldbal_pq_stmt *pq_stmt;
+  int col_no_i;
+  int row_number;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+    type = SQLDBAL_TYPE_ERROR;
+  }
+  else{
+    pq_stmt = stmt->handle;
+    row_number = pq_stmt->fetch_row_index - 1;
+    if(PQgetisnull(pq_stmt->exec_result, row_number, col_no_i)){
+      type = SQLDBAL_TYPE_NULL;
+    }
+    else{
+      switch(pq_stmt->column_type_list[col_idx]){
+        case SQLDBAL_PQ_TYPE_INT2:
+        case SQLDBAL_PQ_TYPE_INT4:
+        case SQLDBAL_PQ_TYPE_INT8:
+          type = SQLDBAL_TYPE_INT;
+          break;
+        case SQLDBAL_PQ_TYPE_FLOAT4:
+        case SQLDBAL_PQ_TYPE_FLOAT8:
+          type = SQLDBAL_TYPE_DOUBLE;
+          break;
+        case SQLDBAL_PQ_TYPE_BOOL:
+          type = SQLDBAL_TYPE_BOOL;
+          break;
+        case SQLDBAL_PQ_TYPE_DATE:
+        case SQLDBAL_PQ_TYPE_TIMESTAMP:
+        case SQLDBAL_PQ_TYPE_TIMESTAMPTZ:
+          type = SQLDBAL_TYPE_TIMESTAMP;
+          break;
+        case SQLDBAL_PQ_TYPE_TEXT:
+          type = SQLDBAL_TYPE_TEXT;
+          break;
+        case SQLDBAL_PQ_TYPE_BYTEA:
+          type = SQLDBAL_TYPE_BLOB;
+          break;
+        case SQLDBAL_PQ_TYPE_OTHER:
+        default:
+          type = SQLDBAL_TYPE_OTHER;
+          break;
+      }
+    }
+  }
+  return type;
+}
+
+/**
+ * Get the binary value of a column result.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] bin     Binary value, or NULL if the column has a NULL value
+ *                     or an error occurred.
+ */
+static void
+sqldbal_pq_stmt_column_bin(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           const unsigned char **bin){
+  struct sqldbal_pq_stmt *pq_stmt;
+  int col_no_i;
+  int row_number;
+
+  pq_stmt = stmt->handle;
+  *bin = NULL;
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    row_number = pq_stmt->fetch_row_index - 1;
+    if(PQgetisnull(pq_stmt->exec_result, row_number, col_no_i) == 0){
+      *bin = (const unsigned char *)PQgetvalue(pq_stmt->exec_result,
+                                               row_number,
+                                               col_no_i);
+    }
+  }
+}
+
+/**
+ * Get the column result as a 64-bit integer.
+ *
+ * Boolean columns return 1 for true and 0 for false.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] i64     64-bit integer.
+ */
+static void
+sqldbal_pq_stmt_column_int64(struct sqldbal_stmt *const stmt,
+                             size_t col_idx,
+                             int64_t *i64){
+  struct sqldbal_pq_stmt *pq_stmt;
+  enum sqldbal_pq_type type;
+  const unsigned char *bin;
+  const char *text;
+  size_t textsz;
+  size_t nbytes;
+
+  pq_stmt = stmt->handle;
+  type = pq_stmt->column_type_list[col_idx];
+
+  nbytes = 0;
+  if(pq_stmt->result_format){
+    nbytes = sqldbal_pq_type_int_size(type);
+  }
+
+  *i64 = 0;
+  if(nbytes){
+    sqldbal_pq_stmt_column_bin(stmt, col_idx, &bin);
+    if(bin){
+      *i64 = sqldbal_pq_bin_to_int(bin, nbytes);
+    }
+  }
+  else if(type == SQLDBAL_PQ_TYPE_BOOL){
+    sqldbal_pq_stmt_column_bin(stmt, col_idx, &bin);
+    if(bin){
+      if(pq_stmt->result_format){
+        *i64 = bin[0] != 0;
+      }
+      else{
+        *i64 = bin[0] == 't';
+      }
+    }
+  }
+  else{
+    sqldbal_pq_stmt_column_text(stmt, col_idx, &text, &textsz);
+    if(text){
+      sqldbal_strtoi64(stmt->db, text, i64);
+    }
+  }
+}
+
+/**
+ * Get the column result as a double-precision floating point number.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] d       Floating point number.
+ */
+static void
+sqldbal_pq_stmt_column_double(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              double *d){
+  struct sqldbal_pq_stmt *pq_stmt;
+  enum sqldbal_pq_type type;
+  const unsigned char *bin;
+  const char *text;
+  size_t textsz;
+  size_t nbytes;
+  int64_t i64;
+
+  pq_stmt = stmt->handle;
+  type = pq_stmt->column_type_list[col_idx];
+
+  nbytes = 0;
+  if(pq_stmt->result_format){
+    nbytes = sqldbal_pq_type_float_size(type);
+  }
+
+  *d = 0;
+  if(nbytes){
+    sqldbal_pq_stmt_column_bin(stmt, col_idx, &bin);
+    if(bin){
+      *d = sqldbal_pq_bin_to_double(bin, nbytes);
+    }
+  }
+  else if(pq_stmt->result_format && sqldbal_pq_type_int_size(type)){
+    sqldbal_pq_stmt_column_int64(stmt, col_idx, &i64);
+    *d = (double)i64;
+  }
+  else{
+    sqldbal_pq_stmt_column_text(stmt, col_idx, &text, &textsz);
+    if(text){
+      sqldbal_strtod(stmt->db, text, d);
+    }
+  }
+}
+
+/**
+ * Get the column result as a timestamp.
+ *
+ * Timestamps without a time zone get treated as UTC.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] ts      Microseconds since 1970-01-01 00:00:00 UTC.
+ */
+static void
+sqldbal_pq_stmt_column_timestamp(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 int64_t *ts){
+  struct sqldbal_pq_stmt *pq_stmt;
+  const unsigned char *bin;
+  const char *text;
+  size_t textsz;
+  size_t nbytes;
+
+  pq_stmt = stmt->handle;
+
+  nbytes = 0;
+  if(pq_stmt->result_format){
+    nbytes = sqldbal_pq_type_timestamp_size(
+               pq_stmt->column_type_list[col_idx]);
+  }
+
+  *ts = 0;
+  if(nbytes){
+    sqldbal_pq_stmt_column_bin(stmt, col_idx, &bin);
+    if(bin && sqldbal_pq_bin_to_timestamp(bin, nbytes, ts)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+      *ts = 0;
+    }
+  }
+  else{
+    sqldbal_pq_stmt_column_text(stmt, col_idx, &text, &textsz);
+    if(text){
+      sqldbal_strtotimestamp(stmt->db, text, ts);
+    }
+  }
+}
+
+/**
+ * Discard pending results and set every placeholder back to NULL.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_reset(struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_stmt *pq_stmt;
+  size_t i;
+
+  pq_stmt = stmt->handle;
+  sqldbal_pq_stmt_stream_discard(stmt);
+  sqldbal_pq_stmt_cursor_close(stmt);
+  PQclear(pq_stmt->exec_result);
+  pq_stmt->exec_result     = NULL;
+  pq_stmt->exec_row_count  = 0;
+  pq_stmt->fetch_row_index = 0;
+  for(i = 0; i < stmt->num_params; i++){
+    sqldbal_pq_stmt_bind_null(stmt, i);
+  }
+}
+
+/**
+ * Signature, flags, and header extension length at the start of the binary
+ * COPY format.
+ */
+static const unsigned char g_sqldbal_pq_copy_header[] = {
+  'P', 'G', 'C', 'O', 'P', 'Y', '\n', 0xff, '\r', '\n', '\0',
+  0, 0, 0, 0,
+  0, 0, 0, 0
+};
+
+/**
+ * Bulk load state for PostgreSQL.
+ */
+struct sqldbal_pq_bulk{
+  /**
+   * Data type of each column receiving values.
+   */
+  enum sqldbal_pq_type *type_list;
+
+  /**
+   * Set to 1 after the server accepted the COPY statement.
+   */
+  int copy_in;
+
+  /**
+   * Set to 1 if the rows use the binary COPY format, or 0 for the text
+   * format.
+   */
+  int binary;
+};
+
+/**
+ * Check if the binary COPY format can encode the values for a column.
+ *
+ * @param[in] type See @ref sqldbal_pq_type.
+ * @retval 1 Use the binary format.
+ * @retval 0 No binary encoding available for this type.
+ */
+static int
+sqldbal_pq_bulk_binary_type(enum sqldbal_pq_type type){
+  return sqldbal_pq_type_int_size(type) > 0 ||
+         sqldbal_pq_type_timestamp_size(type) == 8 ||
+         type == SQLDBAL_PQ_TYPE_BOOL ||
+         type == SQLDBAL_PQ_TYPE_TEXT ||
+         type == SQLDBAL_PQ_TYPE_BYTEA;
+}
+
+/**
+ * Get the data type of each column and start a COPY FROM STDIN command.
+ *
+ * @param[in] bulk        See @ref sqldbal_bulk.
+ * @param[in] table       See @ref sqldbal_bulk_begin.
+ * @param[in] column_list See @ref sqldbal_bulk_begin.
+ */
+static void
+sqldbal_pq_bulk_begin(struct sqldbal_bulk *const bulk,
+                      const char *const table,
+                      const char *const *const column_list){
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_bulk *pq_bulk;
+  PGresult *result;
+  size_t i;
+
+  pq_db = bulk->db->handle;
+  pq_bulk = malloc(sizeof(*pq_bulk));
+  if(pq_bulk == NULL){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    bulk->handle = pq_bulk;
+    pq_bulk->copy_in = 0;
+    pq_bulk->binary = 1;
+    pq_bulk->type_list = calloc(bulk->num_cols, sizeof(*pq_bulk->type_list));
+    if(pq_bulk->type_list == NULL){
+      sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else if(bulk->num_cols > INT16_MAX){
+      /* The binary format stores the column count in 16 bits. */
+      sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_PARAM);
+    }
+    else{
+      /* Binary values must match the column types exactly. */
+      sqldbal_bulk_append_str(bulk, "SELECT ");
+      for(i = 0; i < bulk->num_cols; i++){
+        if(i){
+          sqldbal_bulk_append_str(bulk, ", ");
+        }
+        sqldbal_bulk_append_str(bulk, column_list[i]);
+      }
+      sqldbal_bulk_append_str(bulk, " FROM ");
+      sqldbal_bulk_append_str(bulk, table);
+      sqldbal_bulk_append(bulk, " LIMIT 0", sizeof(" LIMIT 0"));
+      if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+        result = PQexec(pq_db->db, bulk->buf);
+        if(PQresultStatus(result) != PGRES_TUPLES_OK){
+          sqldbal_pq_error(bulk->db, SQLDBAL_STATUS_EXEC);
+        }
+        else{
+          for(i = 0; i < bulk->num_cols; i++){
+            pq_bulk->type_list[i] = sqldbal_pq_oid_type(PQftype(result,
+                                                                (int)i));
+            if(!sqldbal_pq_bulk_binary_type(pq_bulk->type_list[i])){
+              pq_bulk->binary = 0;
+            }
+          }
+        }
+        PQclear(result);
+      }
+
+      bulk->buf_len = 0;
+      sqldbal_bulk_append_sql(bulk,
+                              "COPY ",
+                              table,
+                              column_list,
+                              " FROM STDIN");
+      if(pq_bulk->binary){
+        sqldbal_bulk_append_str(bulk, " (FORMAT binary)");
+      }
+      sqldbal_bulk_append(bulk, "", 1);
+      if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+        /* https://www.postgresql.org/docs/current/libpq-copy.html */
+        result = PQexec(pq_db->db, bulk->buf);
+        if(PQresultStatus(result) != PGRES_COPY_IN){
+          sqldbal_pq_error(bulk->db, SQLDBAL_STATUS_EXEC);
+        }
+        else{
+          pq_bulk->copy_in = 1;
+        }
+        PQclear(result);
+      }
+    }
+  }
+  bulk->buf_len = 0;
+  if(pq_bulk && pq_bulk->copy_in && pq_bulk->binary){
+    sqldbal_bulk_append(bulk,
+                        g_sqldbal_pq_copy_header,
+                        sizeof(g_sqldbal_pq_copy_header));
+  }
+}
+
+/**
+ * Send the buffered rows to the server.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ */
+static void
+sqldbal_pq_bulk_flush(struct sqldbal_bulk *const bulk){
+  struct sqldbal_pq_db *pq_db;
+  size_t offset;
+  size_t chunk;
+
+  pq_db = bulk->db->handle;
+  for(offset = 0;
+      offset < bulk->buf_len &&
+      sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK;
+      offset += chunk){
+    chunk = bulk->buf_len - offset;
+    if(chunk > SQLDBAL_BULK_FLUSH_SIZE){
+      chunk = SQLDBAL_BULK_FLUSH_SIZE;
+    }
+    /* https://www.postgresql.org/docs/current/libpq-copy.html */
+    if(PQputCopyData(pq_db->db, &bulk->buf[offset], (int)chunk) != 1){
+      sqldbal_pq_error(bulk->db, SQLDBAL_STATUS_EXEC);
+    }
+  }
+  bulk->buf_len = 0;
+}
+
+/**
+ * Encode a value in the binary COPY format.
+ *
+ * @param[in] bulk  See @ref sqldbal_bulk.
+ * @param[in] type  Data type of the column receiving the value.
+ * @param[in] param See @ref sqldbal_batch_param.
+ * @param[in] row   Row index starting at 0.
+ */
+static void
+sqldbal_pq_bulk_value_bin(struct sqldbal_bulk *const bulk,
+                          enum sqldbal_pq_type type,
+                          const struct sqldbal_batch_param *const param,
+                          size_t row){
+  char i64_str[MAX_I64_STR_SZ];
+  unsigned char bin[8];
+  unsigned char len_bin[4];
+  const void *data;
+  size_t len;
+  int64_t i64;
+  int64_t limit;
+  int slen;
+
+  data = NULL;
+  len = 0;
+  if(sqldbal_batch_is_null(param, row)){
+    sqldbal_pq_int_to_bin(-1, sizeof(len_bin), len_bin);
+    sqldbal_bulk_append(bulk, len_bin, sizeof(len_bin));
+  }
+  else if(param->type == SQLDBAL_TYPE_INT){
+    i64 = param->i64_list[row];
+    len = sqldbal_pq_type_int_size(type);
+    if(len){
+      if(len < 8){
+        limit = (int64_t)1 << (len * 8 - 1);
+        if(i64 < -limit || i64 >= limit){
+          len = 0;
+        }
+      }
+      if(len){
+        sqldbal_pq_int_to_bin(i64, len, bin);
+        data = bin;
+      }
+    }
+    else if(type == SQLDBAL_PQ_TYPE_BOOL){
+      bin[0] = (unsigned char)(i64 != 0);
+      data = bin;
+      len = 1;
+    }
+    else if(sqldbal_pq_type_timestamp_size(type) == 8){
+      if(sqldbal_pq_timestamp_to_bin(i64, bin) == 0){
+        data = bin;
+        len = sizeof(bin);
+      }
+    }
+    else if(type == SQLDBAL_PQ_TYPE_TEXT){
+      slen = sprintf(i64_str, "%" PRIi64, i64);
+      if(slen > 0){
+        data = i64_str;
+        len = (size_t)slen;
+      }
+    }
+  }
+  else if(type == SQLDBAL_PQ_TYPE_TEXT || type == SQLDBAL_PQ_TYPE_BYTEA){
+    /* Both types use the raw bytes as the binary format. */
+    data = sqldbal_batch_data(param, row, &len);
+    if(len > INT32_MAX){
+      data = NULL;
+    }
+  }
+
+  if(data){
+    sqldbal_pq_int_to_bin((int64_t)len, sizeof(len_bin), len_bin);
+    sqldbal_bulk_append(bulk, len_bin, sizeof(len_bin));
+    sqldbal_bulk_append(bulk, data, len);
+  }
+  else if(!sqldbal_batch_is_null(param, row)){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_BIND);
+  }
+}
+
+/**
+ * Encode a value in the text COPY format.
+ *
+ * @param[in] bulk  See @ref sqldbal_bulk.
+ * @param[in] type  Data type of the column receiving the value.
+ * @param[in] param See @ref sqldbal_batch_param.
+ * @param[in] row   Row index starting at 0.
+ */
+static void
+sqldbal_pq_bulk_value_text(struct sqldbal_bulk *const bulk,
+                           enum sqldbal_pq_type type,
+                           const struct sqldbal_batch_param *const param,
+                           size_t row){
+  char ts_str[SQLDBAL_CONV_STR_SZ];
+  const unsigned char *data;
+  char *buf;
+  size_t len;
+  size_t i;
+  int64_t ts;
+
+  if(sqldbal_batch_is_null(param, row)){
+    sqldbal_bulk_append(bulk, "\\N", 2);
+  }
+  else if(param->type == SQLDBAL_TYPE_INT){
+    if(sqldbal_pq_type_timestamp_size(type) == 8){
+      ts = param->i64_list[row];
+      len = sqldbal_timestamp_to_str(ts, ts_str);
+      sqldbal_bulk_append(bulk, ts_str, len);
+      if(ts != INT64_MAX && ts != INT64_MIN){
+        sqldbal_bulk_append(bulk, "+00", 3);
+      }
+    }
+    else{
+      sqldbal_bulk_append_int64(bulk, param->i64_list[row]);
+    }
+  }
+  else{
+    data = sqldbal_batch_data(param, row, &len);
+    if(type == SQLDBAL_PQ_TYPE_BYTEA){
+      /* Escaped backslash followed by the bytea hex format. */
+      sqldbal_bulk_append(bulk, "\\\\x", 3);
+      if(si_mul_size_t(len, 2, &i)){
+        sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        buf = sqldbal_bulk_reserve(bulk, i);
+        if(buf){
+          for(i = 0; i < len; i++){
+            buf[i * 2]     = "0123456789abcdef"[data[i] >> 4];
+            buf[i * 2 + 1] = "0123456789abcdef"[data[i] & 0xf];
+          }
+          bulk->buf_len += len * 2;
+        }
+      }
+    }
+    else{
+      sqldbal_bulk_append_escaped(bulk, data, len);
+    }
+  }
+}
+
+/**
+ * Encode a row in the COPY format.
+ *
+ * @param[in] bulk       See @ref sqldbal_bulk.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] row        Row index starting at 0.
+ */
+static void
+sqldbal_pq_bulk_row(struct sqldbal_bulk *const bulk,
+                    const struct sqldbal_batch_param *const param_list,
+                    size_t row){
+  struct sqldbal_pq_bulk *pq_bulk;
+  unsigned char num_cols_bin[2];
+  size_t col_idx;
+
+  pq_bulk = bulk->handle;
+  if(pq_bulk->binary){
+    sqldbal_pq_int_to_bin((int64_t)bulk->num_cols,
+                          sizeof(num_cols_bin),
+                          num_cols_bin);
+    sqldbal_bulk_append(bulk, num_cols_bin, sizeof(num_cols_bin));
+  }
+  for(col_idx = 0; col_idx < bulk->num_cols; col_idx++){
+    if(pq_bulk->binary){
+      sqldbal_pq_bulk_value_bin(bulk,
+                                pq_bulk->type_list[col_idx],
+                                &param_list[col_idx],
+                                row);
+    }
+    else{
+      if(col_idx){
+        sqldbal_bulk_append(bulk, "\t", 1);
+      }
+      sqldbal_pq_bulk_value_text(bulk,
+                                 pq_bulk->type_list[col_idx],
+                                 &param_list[col_idx],
+                                 row);
+    }
+  }
+  if(!pq_bulk->binary){
+    sqldbal_bulk_append(bulk, "\n", 1);
+  }
+  if(bulk->buf_len >= SQLDBAL_BULK_FLUSH_SIZE &&
+     sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    sqldbal_pq_bulk_flush(bulk);
+  }
+}
+
+/**
+ * Send the remaining rows and end the COPY command, or cancel the COPY
+ * command if an error occurred.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ */
+static void
+sqldbal_pq_bulk_end(struct sqldbal_bulk *const bulk){
+  const unsigned char trailer[] = {0xff, 0xff};
+  struct sqldbal_pq_db *pq_db;
+  struct sqldbal_pq_bulk *pq_bulk;
+  const char *errormsg;
+  PGresult *result;
+
+  pq_db = bulk->db->handle;
+  pq_bulk = bulk->handle;
+  if(pq_bulk){
+    if(pq_bulk->copy_in){
+      if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+        if(pq_bulk->binary){
+          sqldbal_bulk_append(bulk, trailer, sizeof(trailer));
+        }
+        sqldbal_pq_bulk_flush(bulk);
+      }
+
+      errormsg = NULL;
+      if(sqldbal_status_code_get(bulk->db) != SQLDBAL_STATUS_OK){
+        errormsg = "bulk load canceled";
+      }
+      /* https://www.postgresql.org/docs/current/libpq-copy.html */
+      if(PQputCopyEnd(pq_db->db, errormsg) != 1 &&
+         sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+        sqldbal_pq_error(bulk->db, SQLDBAL_STATUS_EXEC);
+      }
+      while((result = PQgetResult(pq_db->db)) != NULL){
+        if(PQresultStatus(result) != PGRES_COMMAND_OK &&
+           sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+          sqldbal_err_set(bulk->db,
+                          SQLDBAL_STATUS_EXEC,
+                          PQresultErrorMessage(result));
+        }
+        PQclear(result);
+      }
+    }
+    free(pq_bulk->type_list);
+    free(pq_bulk);
+  }
+}
+
+/**
+ * Open a large object.
+ *
+ * PostgreSQL keeps large objects outside of tables, so @p row_id holds the
+ * large object Oid and the other identifiers do not get used. Large object
+ * descriptors only remain valid until the end of the transaction.
+ *
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] table  Unused.
+ * @param[in] column Unused.
+ * @param[in] row_id Large object Oid.
+ */
+static void
+sqldbal_pq_blob_open(struct sqldbal_blob *const blob,
+                     const char *const table,
+                     const char *const column,
+                     int64_t row_id){
+  struct sqldbal_pq_db *pq_db;
+  pg_int64 size;
+  int mode;
+
+  (void)table;
+  (void)column;
+  pq_db = blob->db->handle;
+  if(row_id <= 0 || row_id > UINT_MAX){
+    sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    mode = INV_READ;
+    if(blob->write){
+      mode |= INV_WRITE;
+    }
+    /* https://www.postgresql.org/docs/current/lo-interfaces.html */
+    blob->fd = lo_open(pq_db->db, (Oid)row_id, mode);
+    if(blob->fd < 0){
+      sqldbal_pq_error(blob->db, SQLDBAL_STATUS_EXEC);
+    }
+    else{
+      size = lo_lseek64(pq_db->db, blob->fd, 0, SEEK_END);
+      if(size < 0){
+        sqldbal_pq_error(blob->db, SQLDBAL_STATUS_EXEC);
+      }
+      else{
+        blob->size = (uint64_t)size;
+      }
+    }
+  }
+}
+
+/**
+ * Move the large object descriptor to a byte offset.
+ *
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] offset Byte offset from the start of the large object.
+ * @retval  0 Moved to @p offset.
+ * @retval -1 Failed to move, which sets the error status.
+ */
+static int
+sqldbal_pq_blob_seek(struct sqldbal_blob *const blob,
+                     uint64_t offset){
+  struct sqldbal_pq_db *pq_db;
+  int rc;
+
+  pq_db = blob->db->handle;
+  rc = 0;
+  /* https://www.postgresql.org/docs/current/lo-interfaces.html */
+  if(offset > INT64_MAX ||
+     lo_lseek64(pq_db->db, blob->fd, (pg_int64)offset, SEEK_SET) < 0){
+    sqldbal_pq_error(blob->db, SQLDBAL_STATUS_EXEC);
+    rc = -1;
+  }
+  return rc;
+}
+
+/**
+ * Read part of a large object.
+ *
+ * @param[in]  blob   See @ref sqldbal_blob.
+ * @param[in]  offset Byte offset from the start of the large object.
+ * @param[out] buf    Buffer receiving @p len bytes.
+ * @param[in]  len    Number of bytes to read.
+ */
+static void
+sqldbal_pq_blob_read(struct sqldbal_blob *const blob,
+                     uint64_t offset,
+                     void *const buf,
+                     size_t len){
+  struct sqldbal_pq_db *pq_db;
+  char *bytes;
+  size_t chunksz;
+  int nread;
+
+  pq_db = blob->db->handle;
+  bytes = buf;
+  if(sqldbal_pq_blob_seek(blob, offset) == 0){
+    while(len){
+      chunksz = len;
+      if(chunksz > INT_MAX){
+        chunksz = INT_MAX;
+      }
+      /* https://www.postgresql.org/docs/current/lo-interfaces.html */
+      nread = lo_read(pq_db->db, blob->fd, bytes, chunksz);
+      if(nread <= 0){
+        sqldbal_pq_error(blob->db, SQLDBAL_STATUS_EXEC);
+        break;
+      }
+      bytes += nread;
+      len -= (size_t)nread;
+    }
+  }
+}
+
+/**
+ * Write part of a large object.
+ *
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] offset Byte offset from the start of the large object.
+ * @param[in] buf    Bytes to write.
+ * @param[in] len    Number of bytes in @p buf.
+ */
+static void
+sqldbal_pq_blob_write(struct sqldbal_blob *const blob,
+                      uint64_t offset,
+                      const void *const buf,
+                      size_t len){
+  struct sqldbal_pq_db *pq_db;
+  const char *bytes;
+  size_t chunksz;
+  int nwrite;
+
+  pq_db = blob->db->handle;
+  bytes = buf;
+  if(sqldbal_pq_blob_seek(blob, offset) == 0){
+    while(len){
+      chunksz = len;
+      if(chunksz > INT_MAX){
+        chunksz = INT_MAX;
+      }
+      /* https://www.postgresql.org/docs/current/lo-interfaces.html */
+      nwrite = lo_write(pq_db->db, blob->fd, bytes, chunksz);
+      if(nwrite <= 0){
+        sqldbal_pq_error(blob->db, SQLDBAL_STATUS_EXEC);
+        break;
+      }
+      bytes += nwrite;
+      len -= (size_t)nwrite;
+      offset += (size_t)nwrite;
+    }
+    /* Writing past the end grows the large object. */
+    if(offset > blob->size){
+      blob->size = offset;
+    }
+  }
+}
+
+/**
+ * Close a large object descriptor.
+ *
+ * @param[in] blob See @ref sqldbal_blob.
+ */
+static void
+sqldbal_pq_blob_close(struct sqldbal_blob *const blob){
+  struct sqldbal_pq_db *pq_db;
+
+  pq_db = blob->db->handle;
+  if(blob->fd >= 0){
+    /* https://www.postgresql.org/docs/current/lo-interfaces.html */
+    if(lo_close(pq_db->db, blob->fd) < 0){
+      sqldbal_pq_error(blob->db, SQLDBAL_STATUS_CLOSE);
+    }
+    blob->fd = -1;
+  }
+}
+
+/**
+ * Remove a statement from the pipeline queue so that
+ * @ref sqldbal_pq_pipeline_end discards its result.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_pipeline_forget(const struct sqldbal_stmt *const stmt){
+  struct sqldbal_pq_db *pq_db;
+  size_t i;
+
+  pq_db = stmt->db->handle;
+  for(i = 0; i < pq_db->pipeline_len; i++){
+    if(pq_db->pipeline_list[i] == stmt){
+      pq_db->pipeline_list[i] = NULL;
+    }
+  }
+}
+
+/**
+ * Delete a pq prepared statement.
+ *
+ * pq does not have an explicit function for closing a prepared statement.
+ * Instead, we have to use the DEALLOCATE SQL statement with the name of
+ * the prepared statement.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_pq_stmt_close(struct sqldbal_stmt *const stmt){
+  const char *const DEALLOCATE_PREFIX_STR = "DEALLOCATE ";
+  /*
+   * Allocate the SQL buffer which must hold the longest statement id.
+   *
+   * For example, the longest 64-bit unsigned number:
+   * 18446744073709551615
+   * 12345678901234567890
+   *         10        20
+   * This means int_count has a maximum of 20 digits.
+   *                11               +        20         +       1
+   *   strlen(DEALLOCATE_PREFIX_STR) + max 64-bit length + null-terminator
+   */
+  char sql[11 + 20 + 1];
+  struct sqldbal_pq_stmt *pq_stmt;
+  size_t i;
+
+  pq_stmt = stmt->handle;
+
+  if(pq_stmt){
+    sqldbal_pq_stmt_stream_discard(stmt);
+    sqldbal_pq_stmt_cursor_close(stmt);
+    PQclear(pq_stmt->exec_result);
+
+    strcpy(sql, DEALLOCATE_PREFIX_STR);
+    strcat(sql, pq_stmt->name);
+    if(sqldbal_pq_pipeline_active(stmt->db)){
+      sqldbal_pq_pipeline_forget(stmt);
+      sqldbal_pq_pipeline_queue(stmt->db, NULL, sql);
+    }
+    else{
+      sqldbal_exec(stmt->db, sql, NULL, NULL);
+    }
+
+    if(pq_stmt->param_buf_list){
+      for(i = 0; i < stmt->num_params; i++){
+        free(pq_stmt->param_buf_list[i]);
+      }
+      free(pq_stmt->param_buf_list);
+    }
+    free(pq_stmt->param_value_list);
+    free(pq_stmt->param_buf_size_list);
+
+    if(pq_stmt->param_length_list){
+      free(pq_stmt->param_length_list);
+    }
+
+    if(pq_stmt->param_format_list){
+      free(pq_stmt->param_format_list);
+    }
+
+    free(pq_stmt->param_type_list);
+    free(pq_stmt->column_type_list);
+
+    sqldbal_pq_stmt_free_column_values(stmt);
+
+    free(pq_stmt->column_value_list);
+    free(pq_stmt->column_value_size_list);
+    free(pq_stmt->column_conv_str_list);
+
+    free(pq_stmt->sql);
+    free(pq_stmt->name);
+
+    free(pq_stmt);
+  }
+}
+
+#endif /* SQLDBAL_POSTGRESQL */
+
+#ifdef SQLDBAL_SQLITE
+
+#include <sqlite3.h>
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+/**
+ * SQLite has the sqlite3_trace_v2 api since version 3.14.0.
+ */
+# define SQLDBAL_SQLITE_HAS_TRACE_V2
+#endif /* SQLITE_VERSION_NUMBER >= 3014000 */
+
+/**
+ * Default for the BUSY_TIMEOUT_MS option: total milliseconds to keep
+ * retrying a statement that returned SQLITE_BUSY.
+ */
+#define SQLDBAL_SQLITE_BUSY_TIMEOUT_MS 100
+
+/**
+ * Default for the BUSY_BACKOFF_MIN_MS option: milliseconds to wait before
+ * the first retry.
+ */
+#define SQLDBAL_SQLITE_BUSY_BACKOFF_MIN_MS 1
+
+/**
+ * Default for the BUSY_BACKOFF_MAX_MS option: upper limit in milliseconds
+ * on the wait time between retries.
+ */
+#define SQLDBAL_SQLITE_BUSY_BACKOFF_MAX_MS 50
+
+/**
+ * Column buffers passed to the application callback in
+ * @ref sqldbal_sqlite_exec, reused for every row of every statement.
+ */
+struct sqldbal_sqlite_exec_buf{
+  /**
+   * Column values in the current row.
+   */
+  char **col_result_list;
+
+  /**
+   * Length of the corresponding column in @ref col_result_list.
+   */
+  size_t *col_length_list;
+
+  /**
+   * Number of entries allocated in @ref col_result_list and
+   * @ref col_length_list.
+   */
+  size_t num_cols_alloc;
+};
+
+/**
+ * Convenience function that sets the status code and the error string
+ * generated by the database function.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] sqlite_rc   Return code from SQLite function call. Only used if
+ *                        the sqlite3* database handle has not been created.
+ * @param[in] status_code See @ref sqldbal_status_code.
+ */
+static void
+sqldbal_sqlite_error(struct sqldbal_db *const db,
+                     int sqlite_rc,
+                     enum sqldbal_status_code status_code){
+  sqlite3 *sqlite_db;
+  const char *errstr;
+
+  sqlite_db = db->handle;
+
+  /* https://www.sqlite.org/c3ref/errcode.html */
+  if(sqlite_db){
+    errstr = sqlite3_errmsg(sqlite_db);
+  }
+  else{
+    errstr = sqlite3_errstr(sqlite_rc);
+  }
+  sqldbal_err_set(db, status_code, errstr);
+}
+
+#if defined(SQLDBAL_TRACE) && defined(SQLDBAL_SQLITE_HAS_TRACE_V2)
+/**
+ * Record the SQLITE_TRACE_PROFILE timings in the @ref sqldbal_trace of
+ * the connection.
+ *
+ * @param[in] mask    Only SQLITE_TRACE_PROFILE gets recorded.
+ * @param[in] context See @ref sqldbal_db.
+ * @param[in] P       SQLite prepared statement.
+ * @param[in] X       Nanoseconds spent running the statement.
+ * @retval 0 Return value currently unused.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_sqlite_trace_profile(unsigned mask,
+                             void *context,
+                             void *P,
+                             void *X){
+  struct sqldbal_db *db;
+  const char *sql;
+  size_t sql_len;
+  uint64_t elapsed_ns;
+  int slow;
+
+  db = context;
+  if(mask == SQLITE_TRACE_PROFILE && db->trace){
+    elapsed_ns = (uint64_t)*(sqlite3_int64 *)X;
+    if(sqldbal_trace_keep(db->trace, elapsed_ns, &slow)){
+      /* https://www.sqlite.org/c3ref/expanded_sql.html */
+      sql = sqlite3_sql(P);
+      if(sql == NULL){
+        sql = "";
+      }
+      sql_len = strlen(sql);
+      sqldbal_trace_push(db,
+                         SQLDBAL_METRICS_EXECUTE,
+                         sql,
+                         sql_len,
+                         sqldbal_stmt_cache_hash(sql, sql_len),
+                         elapsed_ns,
+                         0,
+                         slow);
+    }
+  }
+  return 0;
+}
+#endif /* SQLDBAL_TRACE && SQLDBAL_SQLITE_HAS_TRACE_V2 */
+
+#ifdef SQLDBAL_TRACE
+/**
+ * Install or remove the SQLITE_TRACE_PROFILE callback after
+ * @ref sqldbal_trace_attach changed the trace of the connection.
+ *
+ * Without sqlite3_trace_v2, the library times the statements instead.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_sqlite_trace_set(struct sqldbal_db *const db){
+#ifdef SQLDBAL_SQLITE_HAS_TRACE_V2
+  unsigned mask;
+
+  mask = 0;
+  if(db->trace){
+    mask = SQLITE_TRACE_PROFILE;
+  }
+  /* https://www.sqlite.org/c3ref/trace_v2.html */
+  if(sqlite3_trace_v2(db->handle,
+                      mask,
+                      sqldbal_sqlite_trace_profile,
+                      db) != SQLITE_OK){
+    sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_EXEC);
+    db->trace = NULL;
+  }
+  db->trace_driver = db->trace != NULL;
+#else /* !(SQLDBAL_SQLITE_HAS_TRACE_V2) */
+  (void)db;
+#endif /* SQLDBAL_SQLITE_HAS_TRACE_V2 */
+}
+#endif /* SQLDBAL_TRACE */
+
+/**
+ * Pause between SQLITE_BUSY results.
+ *
+ * @param[in] ms Number of milliseconds to wait.
+ */
+static void
+sqldbal_sqlite_busy_sleep(unsigned int ms){
+  struct timeval timeout;
+
+  timeout.tv_sec = (long)(ms / 1000);
+  timeout.tv_usec = (long)(ms % 1000) * 1000;
+  select(0, NULL, NULL, NULL, &timeout);
+}
+
+/**
+ * Wait before retrying a statement that found the database locked.
+ *
+ * The wait time starts at @ref sqldbal_busy::backoff_min_ms and doubles
+ * with each attempt up to @ref sqldbal_busy::backoff_max_ms. A random
+ * jitter picks the actual wait time between half and all of that value so
+ * that competing connections do not keep retrying at the same moment.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] attempt Number of retries already done for this statement.
+ * @retval 1 Waited, so the caller should try again.
+ * @retval 0 The statement has already waited for
+ *           @ref sqldbal_busy::timeout_ms and should fail.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_sqlite_busy_wait(struct sqldbal_db *const db,
+                         unsigned int attempt){
+  struct sqldbal_busy *busy;
+  uint64_t now_ms;
+  uint64_t elapsed_ms;
+  uint64_t delay_ms;
+  uint64_t x;
+  int retry;
+
+  busy = &db->busy;
+  now_ms = sqldbal_time_ms();
+  if(attempt == 0){
+    busy->start_ms = now_ms;
+  }
+  elapsed_ms = now_ms - busy->start_ms;
+  if(elapsed_ms >= busy->timeout_ms){
+    retry = 0;
+  }
+  else{
+    delay_ms = busy->backoff_max_ms;
+    if(attempt < 32){
+      delay_ms = (uint64_t)busy->backoff_min_ms << attempt;
+      if(delay_ms > busy->backoff_max_ms){
+        delay_ms = busy->backoff_max_ms;
+      }
+    }
+
+    /* xorshift64 */
+    x = busy->rand_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    busy->rand_state = x;
+    delay_ms = delay_ms - delay_ms / 2 + x % (delay_ms / 2 + 1);
+
+    if(delay_ms > busy->timeout_ms - elapsed_ms){
+      delay_ms = busy->timeout_ms - elapsed_ms;
+    }
+
+    /* delay_ms <= timeout_ms, which fits in an unsigned int. */
+    sqldbal_sqlite_busy_sleep((unsigned int)delay_ms);
+    busy->num_retries += 1;
+    busy->wait_ms += sqldbal_time_ms() - now_ms;
+    retry = 1;
+  }
+  return retry;
+}
+
+/**
+ * Busy handler that SQLite calls while the database is locked if using
+ * the BUSY_HANDLER=HANDLER option.
+ *
+ * @param[in] context See @ref sqldbal_db.
+ * @param[in] count   Number of times SQLite already called this handler
+ *                    for the same locking event.
+ * @retval 1 SQLite should try again.
+ * @retval 0 SQLite should return SQLITE_BUSY.
+ */
+static int
+sqldbal_sqlite_busy_handler(void *context,
+                            int count){
+  struct sqldbal_db *db;
+  unsigned int attempt;
+
+  db = context;
+  if(count < 0){
+    attempt = 0;
+  }
+  else{
+    attempt = (unsigned int)count;
+  }
+  return sqldbal_sqlite_busy_wait(db, attempt);
+}
+
+/**
+ * Keywords accepted by the JOURNAL_MODE option.
+ */
+static const char *const g_sqldbal_sqlite_journal_mode_list[] = {
+  "DELETE",
+  "TRUNCATE",
+  "PERSIST",
+  "MEMORY",
+  "WAL",
+  "OFF",
+  NULL
+};
+
+/**
+ * Keywords accepted by the SYNCHRONOUS option.
+ */
+static const char *const g_sqldbal_sqlite_synchronous_list[] = {
+  "OFF",
+  "NORMAL",
+  "FULL",
+  "EXTRA",
+  NULL
+};
+
+/**
+ * Keywords accepted by the TEMP_STORE option.
+ */
+static const char *const g_sqldbal_sqlite_temp_store_list[] = {
+  "DEFAULT",
+  "FILE",
+  "MEMORY",
+  NULL
+};
+
+/**
+ * SQLite open option that maps directly to a PRAGMA statement.
+ */
+struct sqldbal_sqlite_pragma{
+  /**
+   * Option key, which also serves as the PRAGMA name.
+   */
+  const char *key;
+
+  /**
+   * NULL-terminated list of keywords the option accepts, or NULL if the
+   * option takes an integer value.
+   */
+  const char *const *keyword_list;
+
+  /**
+   * Set to 1 if the integer value can have a leading minus sign.
+   */
+  int allow_negative;
+
+  /**
+   * Set to 1 if the PRAGMA returns the new setting and it must match the
+   * requested value.
+   */
+  int check_result;
+};
+
+/**
+ * PRAGMA options in the order they get applied after opening the
+ * database.
+ *
+ * The page size must come first because it only takes effect before the
+ * database has any content, and switching to WAL mode locks it in.
+ */
+static const struct sqldbal_sqlite_pragma g_sqldbal_sqlite_pragma_list[] = {
+  {"PAGE_SIZE",    NULL,                               0, 0},
+  {"JOURNAL_MODE", g_sqldbal_sqlite_journal_mode_list, 0, 1},
+  {"SYNCHRONOUS",  g_sqldbal_sqlite_synchronous_list,  0, 0},
+  {"CACHE_SIZE",   NULL,                               1, 0},
+  {"MMAP_SIZE",    NULL,                               0, 0},
+  {"TEMP_STORE",   g_sqldbal_sqlite_temp_store_list,   0, 0}
+};
+
+/**
+ * Number of entries in @ref g_sqldbal_sqlite_pragma_list.
+ */
+#define SQLDBAL_SQLITE_NUM_PRAGMA (sizeof(g_sqldbal_sqlite_pragma_list) / \
+                                   sizeof(g_sqldbal_sqlite_pragma_list[0]))
+
+/**
+ * Maximum number of digits allowed in an integer PRAGMA value, which keeps
+ * the value within the range of a signed 64-bit integer.
+ */
+#define SQLDBAL_SQLITE_PRAGMA_MAX_DIGITS 18
+
+/**
+ * Maximum length of a PRAGMA statement built by
+ * @ref sqldbal_sqlite_pragma_apply, including the null-terminator.
+ */
+#define SQLDBAL_SQLITE_PRAGMA_SQL_SZ 64
+
+/**
+ * Check if an option value can be safely placed in a PRAGMA statement.
+ *
+ * @param[in] pragma See @ref sqldbal_sqlite_pragma.
+ * @param[in] value  Option value.
+ * @retval 1 Valid value.
+ * @retval 0 Invalid value.
+ */
+static int
+sqldbal_sqlite_pragma_valid(const struct sqldbal_sqlite_pragma *const pragma,
+                            const char *value){
+  size_t i;
+  int valid;
+
+  valid = 0;
+  if(value){
+    if(pragma->keyword_list){
+      for(i = 0; pragma->keyword_list[i]; i++){
+        /* https://www.sqlite.org/c3ref/stricmp.html */
+        if(sqlite3_stricmp(value, pragma->keyword_list[i]) == 0){
+          valid = 1;
+        }
+      }
+    }
+    else{
+      if(pragma->allow_negative && *value == '-'){
+        value += 1;
+      }
+      for(i = 0; value[i] >= '0' && value[i] <= '9'; i++){
+      }
+      if(i > 0 && i <= SQLDBAL_SQLITE_PRAGMA_MAX_DIGITS && value[i] == '\0'){
+        valid = 1;
+      }
+    }
+  }
+  return valid;
+}
+
+/**
+ * Callback for sqlite3_exec that saves whether the first column of the
+ * PRAGMA result matches the requested value.
+ *
+ * @param[in] context   Requested value on input and set to NULL if the
+ *                      result matches.
+ * @param[in] num_cols  Number of columns in @p col_list.
+ * @param[in] col_list  Column values in the result row.
+ * @param[in] name_list Unused.
+ * @retval 0 Always continue the statement.
+ */
+static int
+sqldbal_sqlite_pragma_result(void *context,
+                             int num_cols,
+                             char **col_list,
+                             char **name_list){
+  const char **expect;
+
+  (void)name_list;
+
+  expect = context;
+  if(*expect && num_cols > 0 && col_list[0] &&
+     sqlite3_stricmp(col_list[0], *expect) == 0){
+    *expect = NULL;
+  }
+  return 0;
+}
+
+/**
+ * Run the PRAGMA statement for a SQLite open option.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sqlite_db Newly opened SQLite database handle.
+ * @param[in] pragma    See @ref sqldbal_sqlite_pragma.
+ * @param[in] value     Option value checked by
+ *                      @ref sqldbal_sqlite_pragma_valid.
+ */
+static void
+sqldbal_sqlite_pragma_apply(struct sqldbal_db *const db,
+                            sqlite3 *const sqlite_db,
+                            const struct sqldbal_sqlite_pragma *const pragma,
+                            const char *const value){
+  char sql[SQLDBAL_SQLITE_PRAGMA_SQL_SZ];
+  const char *expect;
+  char *errmsg;
+
+  strcpy(sql, "PRAGMA ");
+  strcat(sql, pragma->key);
+  strcat(sql, "=");
+  strcat(sql, value);
+
+  expect = value;
+  errmsg = NULL;
+  /* https://www.sqlite.org/c3ref/exec.html */
+  if(sqlite3_exec(sqlite_db,
+                  sql,
+                  sqldbal_sqlite_pragma_result,
+                  &expect,
+                  &errmsg) != SQLITE_OK){
+    sqldbal_err_set(db, SQLDBAL_STATUS_OPEN, errmsg);
+    /* https://www.sqlite.org/c3ref/free.html */
+    sqlite3_free(errmsg);
+  }
+  else if(pragma->check_result && expect){
+    sqldbal_err_set(db, SQLDBAL_STATUS_OPEN, sql);
+  }
+}
+
+/**
+ * Open a SQLite database file.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] location    Path to database file.
+ * @param[in] port        Unused.
+ * @param[in] username    Unused.
+ * @param[in] password    Unused.
+ * @param[in] database    Unused.
+ * @param[in] option_list Driver-specific options to pass to SQLite.
+ * @param[in] num_options Number of entries in @p option_list.
+ */
+static void
+sqldbal_sqlite_open(struct sqldbal_db *const db,
+                    const char *const location,
+                    const char *const port,
+                    const char *const username,
+                    const char *const password,
+                    const char *const database,
+                    const struct sqldbal_driver_option *const option_list,
+                    size_t num_options){
+  sqlite3 *sqlite_db;
+  const struct sqldbal_driver_option *option;
+  size_t i;
+  int flags;
+  int sqlite_err;
+  const char *vfs;
+  const char *busy_handler;
+  int busy_timeout_ms;
+  const char *pragma_value_list[SQLDBAL_SQLITE_NUM_PRAGMA];
+  size_t pragma_idx;
+
+  (void)port;
+  (void)username;
+  (void)password;
+  (void)database;
+
+  flags = 0;
+  vfs = NULL;
+  busy_handler = "SQLDBAL";
+  memset(pragma_value_list, 0, sizeof(pragma_value_list));
+  db->busy.timeout_ms     = SQLDBAL_SQLITE_BUSY_TIMEOUT_MS;
+  db->busy.backoff_min_ms = SQLDBAL_SQLITE_BUSY_BACKOFF_MIN_MS;
+  db->busy.backoff_max_ms = SQLDBAL_SQLITE_BUSY_BACKOFF_MAX_MS;
+  db->busy.retry_step     = 1;
+  db->busy.rand_state     = (uint64_t)(uintptr_t)db ^ sqldbal_time_ms();
+
+  for(i = 0; i < num_options; i++){
+    option = &option_list[i];
+    if(strcmp(option->key, "VFS") == 0){
+      vfs = option->value;
+    }
+    else if(strcmp(option->key, "BUSY_HANDLER") == 0){
+      busy_handler = option->value;
+    }
+    else if(strcmp(option->key, "BUSY_TIMEOUT_MS") == 0){
+      sqldbal_strtoui(db, option->value, INT_MAX, &db->busy.timeout_ms);
+    }
+    else if(strcmp(option->key, "BUSY_BACKOFF_MIN_MS") == 0){
+      sqldbal_strtoui(db, option->value, INT_MAX, &db->busy.backoff_min_ms);
+    }
+    else if(strcmp(option->key, "BUSY_BACKOFF_MAX_MS") == 0){
+      sqldbal_strtoui(db, option->value, INT_MAX, &db->busy.backoff_max_ms);
+    }
+    else{
+      for(pragma_idx = 0;
+          pragma_idx < SQLDBAL_SQLITE_NUM_PRAGMA &&
+          strcmp(option->key, g_sqldbal_sqlite_pragma_list[pragma_idx].key);
+          pragma_idx++){
+      }
+      if(pragma_idx < SQLDBAL_SQLITE_NUM_PRAGMA &&
+         sqldbal_sqlite_pragma_valid(&g_sqldbal_sqlite_pragma_list[pragma_idx],
+                                     option->value)){
+        pragma_value_list[pragma_idx] = option->value;
+      }
+      else{
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+      }
+    }
+  }
+
+  if(db->busy.backoff_min_ms == 0 ||
+     db->busy.backoff_max_ms < db->busy.backoff_min_ms ||
+     busy_handler == NULL ||
+     (strcmp(busy_handler, "SQLDBAL") != 0 &&
+      strcmp(busy_handler, "HANDLER") != 0 &&
+      strcmp(busy_handler, "TIMEOUT") != 0)){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  }
+
+  if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_READONLY){
+      flags |= SQLITE_OPEN_READONLY;
+    }
+
+    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_READWRITE){
+      flags |= SQLITE_OPEN_READWRITE;
+    }
+
+    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_CREATE){
+      flags |= SQLITE_OPEN_CREATE;
+    }
+
+    if(flags == 0){
+      flags |= SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+    }
+
+    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_NOMUTEX){
+      flags |= SQLITE_OPEN_NOMUTEX;
+    }
+
+    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_FULLMUTEX){
+      flags |= SQLITE_OPEN_FULLMUTEX;
+    }
+
+    if(db->flags & SQLDBAL_FLAG_SQLITE_OPEN_SHAREDCACHE){
+      flags |= SQLITE_OPEN_SHAREDCACHE;
+    }
+
+    /* https://www.sqlite.org/c3ref/open.html */
+    sqlite_err = sqlite3_open_v2(location, &sqlite_db, flags, vfs);
+    if(sqlite_err != SQLITE_OK){
+      sqldbal_sqlite_error(db, sqlite_err, SQLDBAL_STATUS_OPEN);
+    }
+    else{
+      for(pragma_idx = 0; pragma_idx < SQLDBAL_SQLITE_NUM_PRAGMA; pragma_idx++){
+        if(pragma_value_list[pragma_idx] &&
+           sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+          sqldbal_sqlite_pragma_apply(db,
+                                      sqlite_db,
+                                      &g_sqldbal_sqlite_pragma_list[pragma_idx],
+                                      pragma_value_list[pragma_idx]);
+        }
+      }
+      if(strcmp(busy_handler, "HANDLER") == 0){
+        db->busy.retry_step = 0;
+        /* https://www.sqlite.org/c3ref/busy_handler.html */
+        sqlite3_busy_handler(sqlite_db, sqldbal_sqlite_busy_handler, db);
+      }
+      else if(strcmp(busy_handler, "TIMEOUT") == 0){
+        db->busy.retry_step = 0;
+        /* timeout_ms <= INT_MAX as checked by sqldbal_strtoui. */
+        busy_timeout_ms = (int)db->busy.timeout_ms;
+        /* https://www.sqlite.org/c3ref/busy_timeout.html */
+        sqlite3_busy_timeout(sqlite_db, busy_timeout_ms);
+      }
+    }
+
+    db->handle = sqlite_db;
+  }
+}
+
+/**
+ * SQLite does not connect over the network, so this opens the database
+ * file before returning.
+ *
+ * @param[in]  db          See @ref sqldbal_db.
+ * @param[in]  location    See @ref sqldbal_sqlite_open.
+ * @param[in]  port        Unused.
+ * @param[in]  username    Unused.
+ * @param[in]  password    Unused.
+ * @param[in]  database    Unused.
+ * @param[in]  option_list See @ref sqldbal_sqlite_open.
+ * @param[in]  num_options See @ref sqldbal_sqlite_open.
+ * @param[out] wait_events Always set to 0.
+ */
+static void
+sqldbal_sqlite_connect_start(struct sqldbal_db *const db,
+                             const char *const location,
+                             const char *const port,
+                             const char *const username,
+                             const char *const password,
+                             const char *const database,
+                             const struct sqldbal_driver_option *option_list,
+                             size_t num_options,
+                             int *const wait_events){
+  sqldbal_sqlite_open(db,
+                      location,
+                      port,
+                      username,
+                      password,
+                      database,
+                      option_list,
+                      num_options);
+  *wait_events = 0;
+}
+
+/**
+ * Never gets called because @ref sqldbal_sqlite_connect_start always
+ * finishes opening the database.
+ *
+ * @param[in]     db          Unused.
+ * @param[in,out] wait_events Always set to 0.
+ */
+static void
+sqldbal_sqlite_connect_poll(struct sqldbal_db *const db,
+                            int *const wait_events){
+  (void)db;
+  *wait_events = 0;
+}
+
+/**
+ * Close SQLite database handle.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_sqlite_close(struct sqldbal_db *const db){
+  sqlite3 *sqlite_db;
+
+  sqlite_db = db->handle;
+
+  /* https://www.sqlite.org/c3ref/close.html */
+  if(sqlite3_close_v2(sqlite_db) != SQLITE_OK){
+    sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_CLOSE);
+  }
+}
+
+/**
+ * Get the SQLite3 database handle.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @return SQLite3 database handle.
+ */
+static void *
+sqldbal_sqlite_db_handle(const struct sqldbal_db *const db){
+  sqlite3 *sqlite_db;
+
+  sqlite_db = db->handle;
+  return sqlite_db;
+}
+
+/**
+ * Get the maximum number of placeholders in a SQLite statement, which
+ * depends on SQLITE_MAX_VARIABLE_NUMBER and the connection limits.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @return       Maximum number of placeholders.
+ */
+static size_t
+sqldbal_sqlite_param_limit(struct sqldbal_db *const db){
+  int max_vars;
+
+  /* https://www.sqlite.org/c3ref/limit.html */
+  max_vars = sqlite3_limit(db->handle, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+  return (size_t)max_vars;
+}
+
+/**
+ * SQLite does not use a socket.
+ *
+ * @param[in]  db Unused.
+ * @param[out] fd Always set to -1.
+ */
+static void
+sqldbal_sqlite_socket_fd(struct sqldbal_db *const db,
+                         int *const fd){
+  (void)db;
+  *fd = -1;
+}
+
+/**
+ * Get the SQLite3 statement handle.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return SQLite statement handle.
+ */
+static void *
+sqldbal_sqlite_stmt_handle(const struct sqldbal_stmt *const stmt){
+  sqlite3_stmt *sqlite_stmt;
+
+  sqlite_stmt = stmt->handle;
+  return sqlite_stmt;
+}
+
+/**
+ * Execute a database statement that does not have a result set.
+ *
+ * @param[in] db  See @ref sqldbal_db.
+ * @param[in] sql SQL statement to execute.
+ */
+static void
+sqldbal_sqlite_noresult(struct sqldbal_db *const db,
+                        const char *const sql){
+  sqlite3 *sqlite_db;
+  char *errmsg;
+
+  sqlite_db = db->handle;
+  /* https://www.sqlite.org/c3ref/exec.html */
+  if(sqlite3_exec(sqlite_db, sql, NULL, NULL, &errmsg) != SQLITE_OK){
+    sqldbal_err_set(db, SQLDBAL_STATUS_EXEC, errmsg);
+    /* https://www.sqlite.org/c3ref/free.html */
+    sqlite3_free(errmsg);
+  }
+}
+
+/**
+ * Begin a SQLite transaction.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_sqlite_begin_transaction(struct sqldbal_db *const db){
+  sqldbal_sqlite_noresult(db, "BEGIN");
+}
+
+/**
+ * Commit a SQLite transaction.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_sqlite_commit(struct sqldbal_db *const db){
+  sqldbal_sqlite_noresult(db, "COMMIT");
+}
+
+/**
+ * Rollback a SQLite transaction.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_sqlite_rollback(struct sqldbal_db *const db){
+  sqldbal_sqlite_noresult(db, "ROLLBACK");
+}
+
+/**
+ * SQLite executes each statement immediately, so a pipeline does not need
+ * any setup.
+ *
+ * @param[in] db Unused.
+ */
+static void
+sqldbal_sqlite_pipeline_begin(struct sqldbal_db *const db){
+  (void)db;
+}
+
+/**
+ * Every statement in the pipeline has already completed.
+ *
+ * @param[in] db Unused.
+ */
+static void
+sqldbal_sqlite_pipeline_end(struct sqldbal_db *const db){
+  (void)db;
+}
+
+/**
+ * Make sure the column buffers have room for at least @p num_cols columns.
+ *
+ * @param[in,out] buf      See @ref sqldbal_sqlite_exec_buf.
+ * @param[in]     num_cols Number of columns in the next result set.
+ * @retval  0 Success.
+ * @retval -1 Failed to allocate memory.
+ */
+static int
+sqldbal_sqlite_exec_buf_reserve(struct sqldbal_sqlite_exec_buf *const buf,
+                                size_t num_cols){
+  char **col_result_list;
+  size_t *col_length_list;
+  int rc;
+
+  rc = 0;
+  if(num_cols > buf->num_cols_alloc){
+    col_result_list = sqldbal_reallocarray(buf->col_result_list,
+                                           num_cols,
+                                           sizeof(*col_result_list));
+    if(col_result_list == NULL){
+      rc = -1;
+    }
+    else{
+      buf->col_result_list = col_result_list;
+      col_length_list = sqldbal_reallocarray(buf->col_length_list,
+                                             num_cols,
+                                             sizeof(*col_length_list));
+      if(col_length_list == NULL){
+        rc = -1;
+      }
+      else{
+        buf->col_length_list = col_length_list;
+        buf->num_cols_alloc = num_cols;
+      }
+    }
+  }
+  return rc;
+}
+
+/**
+ * Run one compiled statement from @ref sqldbal_sqlite_exec and pass each
+ * returned row to the application callback.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] sqlite_stmt Compiled statement.
+ * @param[in] callback    Invokes this callback function for every returned
+ *                        row, or NULL to discard the rows.
+ * @param[in] user_data   Pass this to the first argument in the
+ *                        @p callback function.
+ * @param[in] buf         See @ref sqldbal_sqlite_exec_buf.
+ */
+static void
+sqldbal_sqlite_exec_stmt(struct sqldbal_db *const db,
+                         sqlite3_stmt *const sqlite_stmt,
+                         sqldbal_exec_callback_fp callback,
+                         void *user_data,
+                         struct sqldbal_sqlite_exec_buf *const buf){
+  const unsigned char *text;
+  int step_rc;
+  int num_cols;
+  int col_i;
+  unsigned int num_retries;
+
+  /* https://www.sqlite.org/c3ref/column_count.html */
+  num_cols = sqlite3_column_count(sqlite_stmt);
+  if(callback && sqldbal_sqlite_exec_buf_reserve(buf, (size_t)num_cols)){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+
+  num_retries = 0;
+  step_rc = SQLITE_ROW;
+  while(step_rc != SQLITE_DONE &&
+        sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    /* https://www.sqlite.org/c3ref/step.html */
+    step_rc = sqlite3_step(sqlite_stmt);
+    if(step_rc == SQLITE_ROW){
+      for(col_i = 0; callback && col_i < num_cols; col_i++){
+        /* https://www.sqlite.org/c3ref/column_blob.html */
+        text = sqlite3_column_text(sqlite_stmt, col_i);
+        if(text == NULL &&
+           sqlite3_column_type(sqlite_stmt, col_i) != SQLITE_NULL){
+          sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+        }
+
+        /* The callback takes the same mutable strings as sqlite3_exec. */
+        buf->col_result_list[col_i] = (char *)(uintptr_t)text;
+        buf->col_length_list[col_i] = (size_t)sqlite3_column_bytes(
+                                                sqlite_stmt,
+                                                col_i);
+      }
+      if(callback &&
+         sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK &&
+         callback(user_data,
+                  (size_t)num_cols,
+                  buf->col_result_list,
+                  buf->col_length_list)){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
+      }
+    }
+    else if(step_rc == SQLITE_DONE){
+      /* Continue with the next statement. */
+    }
+    else if(step_rc == SQLITE_BUSY         &&
+            db->busy.retry_step           &&
+            sqldbal_sqlite_busy_wait(db, num_retries)){
+      num_retries += 1;
+    }
+    else{
+      sqldbal_sqlite_error(db, step_rc, SQLDBAL_STATUS_EXEC);
+    }
+  }
+}
+
+/**
+ * Execute a direct SQL statement.
+ *
+ * Compiles and runs each statement in @p sql one at a time. The column
+ * buffers passed to @p callback get allocated once and reused for every
+ * row.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sql       SQL command to execute.
+ * @param[in] callback  Invokes this callback function for every returned row
+ *                      in the query result set. Set this to NULL if query
+ *                      results not needed.
+ * @param[in] user_data Pass this to the first argument in the
+ *                      @p callback function.
+ */
+static void
+sqldbal_sqlite_exec(struct sqldbal_db *const db,
+                    const char *const sql,
+                    sqldbal_exec_callback_fp callback,
+                    void *user_data){
+  sqlite3 *sqlite_db;
+  sqlite3_stmt *sqlite_stmt;
+  const char *sql_next;
+  struct sqldbal_sqlite_exec_buf buf;
+
+  sqlite_db = db->handle;
+
+  buf.col_result_list = NULL;
+  buf.col_length_list = NULL;
+  buf.num_cols_alloc = 0;
+
+  sql_next = sql;
+  while(*sql_next != '\0' &&
+        sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    /* https://www.sqlite.org/c3ref/prepare.html */
+    if(sqlite3_prepare_v2(sqlite_db,
+                          sql_next,
+                          -1,
+                          &sqlite_stmt,
+                          &sql_next) != SQLITE_OK){
+      sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_EXEC);
+    }
+    else if(sqlite_stmt){
+      sqldbal_sqlite_exec_stmt(db, sqlite_stmt, callback, user_data, &buf);
+
+      /* https://www.sqlite.org/c3ref/finalize.html */
+      sqlite3_finalize(sqlite_stmt);
+    }
+    else{
+      /* Only whitespace or a comment remained. */
+    }
+  }
+  free(buf.col_result_list);
+  free(buf.col_length_list);
+}
+
+/**
+ * Get the insert id from the last SQL insert statement.
+ *
+ * @param[in]  db        See @ref sqldbal_db.
+ * @param[in]  name      Unused.
+ * @param[out] insert_id Last insert id.
+ */
+static void
+sqldbal_sqlite_last_insert_id(struct sqldbal_db *const db,
+                              const char *const name,
+                              uint64_t *insert_id){
+  sqlite3 *sqlite_db;
+  sqlite3_int64 sqlite_rowid;
+
+  (void)name;
+
+  sqlite_db = db->handle;
+
+  /* https://www.sqlite.org/c3ref/last_insert_rowid.html */
+  sqlite_rowid = sqlite3_last_insert_rowid(sqlite_db);
+
+  /*
+   * SQLite normally wouldn't return a negative value, but a virtual table
+   * implementation might.
+   */
+  if(si_int64_to_uint64(sqlite_rowid, insert_id)){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_OVERFLOW);
+  }
+}
+
+/**
+ * Check if the connection to the database still works.
+ *
+ * SQLite databases do not have a server connection, so this always
+ * succeeds.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_sqlite_ping(struct sqldbal_db *const db){
+  (void)db;
+}
+
+/**
+ * Prepare SQLite statement.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] sql     SQL query to compile.
+ * @param[in] sql_len Length of @p sql in bytes, or -1 if null-terminated.
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_sqlite_stmt_prepare(struct sqldbal_db *const db,
+                            const char *const sql,
+                            size_t sql_len,
+                            struct sqldbal_stmt *stmt){
+  sqlite3 *sqlite_db;
+  sqlite3_stmt *sqlite_stmt;
+  int nbyte;
+  int col_count;
+  int param_count;
+
+  sqlite_db = db->handle;
+  if(sql_len == SIZE_MAX){
+    nbyte = -1;
+  }
+  else if(sql_len > INT_MAX){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+    nbyte = -2;
+  }
+  else{
+    /* Within range because above condition ensures sql_len <= INT_MAX. */
+    nbyte = (int)sql_len;
+  }
+
+  if(nbyte != -2){
+    /* https://www.sqlite.org/c3ref/prepare.html */
+    if(sqlite3_prepare_v2(sqlite_db,
+                          sql,
+                          nbyte,
+                          &sqlite_stmt,
+                          NULL) != SQLITE_OK){
+      sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_PREPARE);
+    }
+    stmt->handle = sqlite_stmt;
+
+    /*
+     * https://www.sqlite.org/c3ref/column_count.html
+     * This function should always return a positive value.
+     */
+    col_count = sqlite3_column_count(sqlite_stmt);
+    stmt->num_cols_result = (size_t)col_count;
+
+    /*
+     * https://www.sqlite.org/c3ref/bind_parameter_count.html
+     * This function should always return a positive value.
+     */
+    param_count = sqlite3_bind_parameter_count(sqlite_stmt);
+    stmt->num_params = (size_t)param_count;
+  }
+}
+
+/**
+ * SQLite already steps through the results one row at a time without
+ * buffering them, so this does nothing.
+ *
+ * @param[in] stmt          See @ref sqldbal_stmt.
+ * @param[in] prefetch_rows See @ref sqldbal_stmt_set_cursor.
+ */
+static void
+sqldbal_sqlite_stmt_cursor(struct sqldbal_stmt *const stmt,
+                           size_t prefetch_rows){
+  (void)stmt;
+  (void)prefetch_rows;
+}
+
+/**
+ * Convert the bind index to a 1-based index system required by SQLite.
+ *
+ * The driver interface expects a 0-based column index provided by
+ * the application, but SQLite uses a 1-based colum index for the
+ * bind_* functions.
+ *
+ * @param[in]  col_idx_in  The 0-based column index provided by the driver.
+ * @param[out] col_idx_out The converted 1-based column index.
+ * @retval  0 Successfully converted column index.
+ * @retval !0 Error occurred when converting column index.
+ */
+static int
+sqldbal_sqlite_get_col_idx(size_t col_idx_in,
+                           int *col_idx_out){
+  size_t col_idx_sum;
+
+  if(si_add_size_t(col_idx_in, 1, &col_idx_sum) ||
+     si_size_to_int(col_idx_sum, col_idx_out)){
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Assign binary data to a prepared statement placeholder.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] col_idx    Placeholder index referenced in prepared statement.
+ * @param[in] blob       Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz     Length of @p blob in bytes.
+ * @param[in] destructor SQLITE_TRANSIENT to copy @p blob or SQLITE_STATIC
+ *                       to reference @p blob directly.
+ */
+static void
+sqldbal_sqlite_stmt_bind_blob_destructor(struct sqldbal_stmt *const stmt,
+                                         size_t col_idx,
+                                         const void *const blob,
+                                         size_t blobsz,
+                                         sqlite3_destructor_type destructor){
+  sqlite3_stmt *sqlite_stmt;
+  int blobsz_int;
+  int col_idx_i;
+
+  if(si_size_to_int(blobsz, &blobsz_int) ||
+     sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    sqlite_stmt = stmt->handle;
+
+    /* https://www.sqlite.org/c3ref/bind_blob.html */
+    if(sqlite3_bind_blob(sqlite_stmt,
+                         col_idx_i,
+                         blob,
+                         blobsz_int,
+                         destructor) != SQLITE_OK){
+      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
+    }
+  }
+}
+
+/**
+ * Assign binary data to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
+ */
+static void
+sqldbal_sqlite_stmt_bind_blob(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              const void *const blob,
+                              size_t blobsz){
+  sqldbal_sqlite_stmt_bind_blob_destructor(stmt,
+                                           col_idx,
+                                           blob,
+                                           blobsz,
+                                           SQLITE_TRANSIENT);
+}
+
+/**
+ * Reference binary data from a prepared statement placeholder without
+ * copying it.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
+ */
+static void
+sqldbal_sqlite_stmt_bind_blob_static(struct sqldbal_stmt *const stmt,
+                                     size_t col_idx,
+                                     const void *const blob,
+                                     size_t blobsz){
+  sqldbal_sqlite_stmt_bind_blob_destructor(stmt,
+                                           col_idx,
+                                           blob,
+                                           blobsz,
+                                           SQLITE_STATIC);
+}
+
+/**
+ * Assign a 64-bit integer to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] i64     Integer to bind.
+ */
+static void
+sqldbal_sqlite_stmt_bind_int64(struct sqldbal_stmt *const stmt,
+                               size_t col_idx,
+                               int64_t i64){
+  sqlite3_stmt *sqlite_stmt;
+  int col_idx_i;
+
+  sqlite_stmt = stmt->handle;
+
+  if(sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    /* https://www.sqlite.org/c3ref/bind_blob.html */
+    if(sqlite3_bind_int64(sqlite_stmt,
+                          col_idx_i,
+                          i64) != SQLITE_OK){
+      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
+    }
+  }
+}
+
+/**
+ * Assign a text string to a prepared statement placeholder.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] col_idx    Placeholder index referenced in prepared statement.
+ * @param[in] s          Text string saved to a SQL text type.
+ * @param[in] slen       Length of @p s in bytes.
+ * @param[in] destructor SQLITE_TRANSIENT to copy @p s or SQLITE_STATIC to
+ *                       reference @p s directly.
+ */
+static void
+sqldbal_sqlite_stmt_bind_text_destructor(struct sqldbal_stmt *const stmt,
+                                         size_t col_idx,
+                                         const char *const s,
+                                         size_t slen,
+                                         sqlite3_destructor_type destructor){
+  sqlite3_stmt *sqlite_stmt;
+  int bind_len;
+  int col_idx_i;
+
+  if(si_size_to_int(slen, &bind_len) ||
+     sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    sqlite_stmt = stmt->handle;
+
+    /* https://www.sqlite.org/c3ref/bind_blob.html */
+    if(sqlite3_bind_text(sqlite_stmt,
+                         col_idx_i,
+                         s,
+                         bind_len,
+                         destructor) != SQLITE_OK){
+      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
+    }
+  }
+}
+
+/**
+ * Assign a text string to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] s       Text string saved to a SQL text type.
+ * @param[in] slen    Length of @p s in bytes.
+ */
+static void
+sqldbal_sqlite_stmt_bind_text(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              const char *const s,
+                              size_t slen){
+  sqldbal_sqlite_stmt_bind_text_destructor(stmt,
+                                           col_idx,
+                                           s,
+                                           slen,
+                                           SQLITE_TRANSIENT);
+}
+
+/**
+ * Reference a text string from a prepared statement placeholder without
+ * copying it.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] s       Text string saved to a SQL text type.
+ * @param[in] slen    Length of @p s in bytes.
+ */
+static void
+sqldbal_sqlite_stmt_bind_text_static(struct sqldbal_stmt *const stmt,
+                                     size_t col_idx,
+                                     const char *const s,
+                                     size_t slen){
+  sqldbal_sqlite_stmt_bind_text_destructor(stmt,
+                                           col_idx,
+                                           s,
+                                           slen,
+                                           SQLITE_STATIC);
+}
+
+/**
+ * Assign a double-precision floating point number to a prepared statement
+ * placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] d       Floating point number to bind.
+ */
+static void
+sqldbal_sqlite_stmt_bind_double(struct sqldbal_stmt *const stmt,
+                                size_t col_idx,
+                                double d){
+  sqlite3_stmt *sqlite_stmt;
+  int col_idx_i;
+
+  sqlite_stmt = stmt->handle;
+
+  if(sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    /* https://www.sqlite.org/c3ref/bind_blob.html */
+    if(sqlite3_bind_double(sqlite_stmt, col_idx_i, d) != SQLITE_OK){
+      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
+    }
+  }
+}
+
+/**
+ * Assign a timestamp to a prepared statement placeholder.
+ *
+ * SQLite does not have a timestamp type, so this binds the text format
+ * understood by the SQLite date and time functions.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] ts      Microseconds since 1970-01-01 00:00:00 UTC.
+ */
+static void
+sqldbal_sqlite_stmt_bind_timestamp(struct sqldbal_stmt *const stmt,
+                                   size_t col_idx,
+                                   int64_t ts){
+  char ts_str[SQLDBAL_CONV_STR_SZ];
+  size_t slen;
+
+  /* Include the null-terminator like sqldbal_stmt_bind_text. */
+  slen = sqldbal_timestamp_to_str(ts, ts_str) + 1;
+  sqldbal_sqlite_stmt_bind_text_destructor(stmt,
+                                           col_idx,
+                                           ts_str,
+                                           slen,
+                                           SQLITE_TRANSIENT);
+}
+
+/**
+ * Assign a NULL value to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ */
+static void
+sqldbal_sqlite_stmt_bind_null(struct sqldbal_stmt *const stmt,
+                              size_t col_idx){
+  sqlite3_stmt *sqlite_stmt;
+  int col_idx_i;
+
+  sqlite_stmt = stmt->handle;
+
+  if(sqldbal_sqlite_get_col_idx(col_idx, &col_idx_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    /* https://www.sqlite.org/c3ref/bind_blob.html */
+    if(sqlite3_bind_null(sqlite_stmt,
+                         col_idx_i) != SQLITE_OK){
+      sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_BIND);
+    }
+  }
+}
+
+/**
+ * Start a blob placeholder value that gets sent in chunks.
+ *
+ * SQLite binds values in a single call, so the chunks get collected in
+ * @ref sqldbal_stmt::stream_list. Inserting a zeroblob() and filling it
+ * through @ref sqldbal_blob_open avoids holding the whole value.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ */
+static void
+sqldbal_sqlite_stmt_bind_blob_stream(struct sqldbal_stmt *const stmt,
+                                     size_t col_idx){
+  if(sqldbal_stmt_stream_begin(stmt, col_idx) == 0){
+    sqldbal_sqlite_stmt_bind_blob_static(stmt, col_idx, "", 0);
+  }
+}
+
+/**
+ * Add the next chunk to a streamed blob placeholder value.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index referenced in prepared statement.
+ * @param[in] chunk   Next bytes of the value.
+ * @param[in] chunksz Number of bytes in @p chunk.
+ */
+static void
+sqldbal_sqlite_stmt_send_blob(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              const void *const chunk,
+                              size_t chunksz){
+  struct sqldbal_stmt_stream *stream;
+
+  stream = sqldbal_stmt_stream_append(stmt, col_idx, chunk, chunksz);
+  if(stream){
+    sqldbal_sqlite_stmt_bind_blob_static(stmt,
+                                         col_idx,
+                                         stream->buf,
+                                         stream->len);
+  }
+}
+
+/**
+ * Step a statement until it completes, and then reset it so that it can run
+ * again.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] sqlite_stmt Compiled SQLite statement.
+ */
+static void
+sqldbal_sqlite_step_reset(struct sqldbal_db *const db,
+                          sqlite3_stmt *const sqlite_stmt){
+  int step_rc;
+  unsigned int num_retries;
+  unsigned int retry_execute;
+
+  num_retries = 0;
+  do{
+    retry_execute = 0;
+
+    /* https://www.sqlite.org/c3ref/step.html */
+    step_rc = sqlite3_step(sqlite_stmt);
+    if(step_rc == SQLITE_DONE || step_rc == SQLITE_ROW){
+      /* https://www.sqlite.org/c3ref/reset.html */
+      if(sqlite3_reset(sqlite_stmt) != SQLITE_OK){
+        sqldbal_sqlite_error(db, 0, SQLDBAL_STATUS_EXEC);
+      }
+    }
+    else if(step_rc == SQLITE_BUSY                  &&
+            db->busy.retry_step                    &&
+            sqldbal_sqlite_busy_wait(db, num_retries)){
+      num_retries += 1;
+      retry_execute = 1;
+    }
+    else{
+      sqldbal_sqlite_error(db, step_rc, SQLDBAL_STATUS_EXEC);
+    }
+  } while(retry_execute);
+}
+
+/**
+ * Execute a compiled statement with bound parameters.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_sqlite_stmt_execute(struct sqldbal_stmt *const stmt){
+  sqldbal_sqlite_step_reset(stmt->db, stmt->handle);
+}
+
+/**
+ * Maximum number of rows inserted by each INSERT statement in a SQLite
+ * bulk load.
+ */
+#define SQLDBAL_SQLITE_BULK_ROWS 128
+
+/**
+ * Bulk load state for SQLite.
+ */
+struct sqldbal_sqlite_bulk{
+  /**
+   * INSERT statement with placeholders for @ref rows_per_insert rows.
+   */
+  sqlite3_stmt *insert;
+
+  /**
+   * Text of the @ref insert statement.
+   */
+  char *sql;
+
+  /**
+   * Length of the INSERT statement text up to the first row of
+   * placeholders.
+   */
+  size_t head_len;
+
+  /**
+   * Length of the placeholders for each row, including the separator.
+   */
+  size_t row_len;
+
+  /**
+   * Number of rows inserted by @ref insert.
+   */
+  size_t rows_per_insert;
+
+  /**
+   * Number of rows encoded in @ref sqldbal_bulk::buf.
+   */
+  size_t num_rows;
+
+  /**
+   * Set to 1 if the bulk load started its own transaction.
+   */
+  int implicit_transaction;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Start a transaction and compile the multi-row INSERT statement.
+ *
+ * @param[in] bulk        See @ref sqldbal_bulk.
+ * @param[in] table       See @ref sqldbal_bulk_begin.
+ * @param[in] column_list See @ref sqldbal_bulk_begin.
+ */
+static void
+sqldbal_sqlite_bulk_begin(struct sqldbal_bulk *const bulk,
+                          const char *const table,
+                          const char *const *const column_list){
+  struct sqldbal_sqlite_bulk *sqlite_bulk;
+  sqlite3 *sqlite_db;
+  size_t row;
+  size_t i;
+  int sql_len;
+  int rc;
+
+  sqlite_db = bulk->db->handle;
+  sqlite_bulk = malloc(sizeof(*sqlite_bulk));
+  if(sqlite_bulk == NULL){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    bulk->handle = sqlite_bulk;
+    sqlite_bulk->insert               = NULL;
+    sqlite_bulk->sql                  = NULL;
+    sqlite_bulk->num_rows             = 0;
+    sqlite_bulk->implicit_transaction = 0;
+
+    sqlite_bulk->rows_per_insert = sqldbal_sqlite_param_limit(bulk->db) /
+                                   bulk->num_cols;
+    if(sqlite_bulk->rows_per_insert > SQLDBAL_SQLITE_BULK_ROWS){
+      sqlite_bulk->rows_per_insert = SQLDBAL_SQLITE_BULK_ROWS;
+    }
+    if(sqlite_bulk->rows_per_insert == 0){
+      sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_PARAM);
+    }
+    else{
+      sqldbal_bulk_append_sql(bulk,
+                              "INSERT INTO ",
+                              table,
+                              column_list,
+                              " VALUES ");
+      sqlite_bulk->head_len = bulk->buf_len;
+      for(row = 0; row < sqlite_bulk->rows_per_insert; row++){
+        sqldbal_bulk_append_str(bulk, row ? ", (?" : "(?");
+        for(i = 1; i < bulk->num_cols; i++){
+          sqldbal_bulk_append_str(bulk, ", ?");
+        }
+        sqldbal_bulk_append_str(bulk, ")");
+      }
+      sqldbal_bulk_append(bulk, "", 1);
+      sqlite_bulk->row_len = bulk->num_cols * 3 + 2;
+    }
+
+    if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+      sqlite_bulk->sql = sqldbal_strdup(bulk->buf);
+      if(sqlite_bulk->sql == NULL ||
+         si_size_to_int(bulk->buf_len, &sql_len)){
+        sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        /* https://www.sqlite.org/c3ref/get_autocommit.html */
+        sqlite_bulk->implicit_transaction = sqlite3_get_autocommit(sqlite_db);
+        if(sqlite_bulk->implicit_transaction){
+          sqldbal_sqlite_begin_transaction(bulk->db);
+        }
+
+        /* https://www.sqlite.org/c3ref/prepare.html */
+        rc = sqlite3_prepare_v2(sqlite_db,
+                                sqlite_bulk->sql,
+                                sql_len,
+                                &sqlite_bulk->insert,
+                                NULL);
+        if(rc != SQLITE_OK){
+          sqldbal_sqlite_error(bulk->db, rc, SQLDBAL_STATUS_PREPARE);
+        }
+      }
+    }
+  }
+  bulk->buf_len = 0;
+}
+
+/**
+ * Bind the rows encoded by @ref sqldbal_sqlite_bulk_row to an INSERT
+ * statement and run it.
+ *
+ * @param[in] bulk        See @ref sqldbal_bulk.
+ * @param[in] sqlite_stmt INSERT statement with placeholders for every
+ *                        encoded row.
+ */
+static void
+sqldbal_sqlite_bulk_insert(struct sqldbal_bulk *const bulk,
+                           sqlite3_stmt *const sqlite_stmt){
+  size_t offset;
+  size_t len;
+  int64_t i64;
+  int len_int;
+  int param_idx;
+  int rc;
+
+  rc = SQLITE_OK;
+  offset = 0;
+  for(param_idx = 1; offset < bulk->buf_len && rc == SQLITE_OK; param_idx++){
+    /* https://www.sqlite.org/c3ref/bind_blob.html */
+    switch(bulk->buf[offset++]){
+      case SQLDBAL_TYPE_INT:
+        memcpy(&i64, &bulk->buf[offset], sizeof(i64));
+        offset += sizeof(i64);
+        rc = sqlite3_bind_int64(sqlite_stmt, param_idx, i64);
+        break;
+      case SQLDBAL_TYPE_TEXT:
+      case SQLDBAL_TYPE_BLOB:
+        memcpy(&len, &bulk->buf[offset], sizeof(len));
+        offset += sizeof(len);
+        if(si_size_to_int(len, &len_int)){
+          rc = SQLITE_TOOBIG;
+        }
+        else if(bulk->buf[offset - sizeof(len) - 1] == SQLDBAL_TYPE_TEXT){
+          rc = sqlite3_bind_text(sqlite_stmt,
+                                 param_idx,
+                                 &bulk->buf[offset],
+                                 len_int,
+                                 SQLITE_STATIC);
+        }
+        else{
+          rc = sqlite3_bind_blob(sqlite_stmt,
+                                 param_idx,
+                                 &bulk->buf[offset],
+                                 len_int,
+                                 SQLITE_STATIC);
+        }
+        offset += len;
+        break;
+      default:
+        rc = sqlite3_bind_null(sqlite_stmt, param_idx);
+        break;
+    }
+  }
+
+  if(rc != SQLITE_OK){
+    sqldbal_sqlite_error(bulk->db, 0, SQLDBAL_STATUS_BIND);
+  }
+  else{
+    sqldbal_sqlite_step_reset(bulk->db, sqlite_stmt);
+  }
+  bulk->buf_len = 0;
+}
+
+/**
+ * Copy a row into the bulk load buffer, and insert the buffered rows once
+ * the buffer has enough rows for the INSERT statement.
+ *
+ * See @ref sqldbal_bulk_append_row for the encoding.
+ *
+ * @param[in] bulk       See @ref sqldbal_bulk.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] row        Row index starting at 0.
+ */
+static void
+sqldbal_sqlite_bulk_row(struct sqldbal_bulk *const bulk,
+                        const struct sqldbal_batch_param *const param_list,
+                        size_t row){
+  struct sqldbal_sqlite_bulk *sqlite_bulk;
+
+  sqlite_bulk = bulk->handle;
+  sqldbal_bulk_append_row(bulk, param_list, row);
+  sqlite_bulk->num_rows += 1;
+  if(sqlite_bulk->num_rows == sqlite_bulk->rows_per_insert &&
+     sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    sqldbal_sqlite_bulk_insert(bulk, sqlite_bulk->insert);
+    sqlite_bulk->num_rows = 0;
+  }
+}
+
+/**
+ * Insert the remaining rows, end the transaction, and free the bulk load
+ * state.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ */
+static void
+sqldbal_sqlite_bulk_end(struct sqldbal_bulk *const bulk){
+  struct sqldbal_sqlite_bulk *sqlite_bulk;
+  sqlite3 *sqlite_db;
+  sqlite3_stmt *sqlite_stmt;
+  size_t sql_len;
+  int rc;
+
+  sqlite_db = bulk->db->handle;
+  sqlite_bulk = bulk->handle;
+  if(sqlite_bulk){
+    if(sqlite_bulk->num_rows &&
+       sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+      /* Use the start of the INSERT statement for the remaining rows. */
+      sql_len = sqlite_bulk->head_len +
+                sqlite_bulk->num_rows * sqlite_bulk->row_len - 2;
+      /* https://www.sqlite.org/c3ref/prepare.html */
+      rc = sqlite3_prepare_v2(sqlite_db,
+                              sqlite_bulk->sql,
+                              (int)sql_len,
+                              &sqlite_stmt,
+                              NULL);
+      if(rc != SQLITE_OK){
+        sqldbal_sqlite_error(bulk->db, rc, SQLDBAL_STATUS_PREPARE);
+      }
+      else{
+        sqldbal_sqlite_bulk_insert(bulk, sqlite_stmt);
+      }
+      /* https://www.sqlite.org/c3ref/finalize.html */
+      sqlite3_finalize(sqlite_stmt);
+    }
+
+    /* https://www.sqlite.org/c3ref/finalize.html */
+    sqlite3_finalize(sqlite_bulk->insert);
+    if(sqlite_bulk->implicit_transaction){
+      if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+        sqldbal_sqlite_commit(bulk->db);
+      }
+      else{
+        sqlite3_exec(sqlite_db, "ROLLBACK", NULL, NULL, NULL);
+      }
+    }
+    free(sqlite_bulk->sql);
+    free(sqlite_bulk);
+  }
+}
+
+/**
+ * Open a BLOB value for incremental I/O.
+ *
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] table  Table in the main database holding the value.
+ * @param[in] column Column holding the value.
+ * @param[in] row_id Rowid of the row holding the value.
+ */
+static void
+sqldbal_sqlite_blob_open(struct sqldbal_blob *const blob,
+                         const char *const table,
+                         const char *const column,
+                         int64_t row_id){
+  sqlite3_blob *sqlite_blob;
+  int rc;
+
+  sqlite_blob = NULL;
+  /* https://www.sqlite.org/c3ref/blob_open.html */
+  rc = sqlite3_blob_open(blob->db->handle,
+                         "main",
+                         table,
+                         column,
+                         row_id,
+                         blob->write,
+                         &sqlite_blob);
+  if(rc != SQLITE_OK){
+    sqldbal_sqlite_error(blob->db, rc, SQLDBAL_STATUS_EXEC);
+    /* https://www.sqlite.org/c3ref/blob_close.html */
+    sqlite3_blob_close(sqlite_blob);
+  }
+  else{
+    blob->handle = sqlite_blob;
+    /* https://www.sqlite.org/c3ref/blob_bytes.html */
+    blob->size = (uint64_t)sqlite3_blob_bytes(sqlite_blob);
+  }
+}
+
+/**
+ * Read part of a BLOB value.
+ *
+ * @param[in]  blob   See @ref sqldbal_blob.
+ * @param[in]  offset Byte offset from the start of the value.
+ * @param[out] buf    Buffer receiving @p len bytes.
+ * @param[in]  len    Number of bytes to read.
+ */
+static void
+sqldbal_sqlite_blob_read(struct sqldbal_blob *const blob,
+                         uint64_t offset,
+                         void *const buf,
+                         size_t len){
+  int len_i;
+  int rc;
+
+  /* The offset is at most sqlite3_blob_bytes, which fits in an int. */
+  if(si_size_to_int(len, &len_i)){
+    sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    /* https://www.sqlite.org/c3ref/blob_read.html */
+    rc = sqlite3_blob_read(blob->handle, buf, len_i, (int)offset);
+    if(rc != SQLITE_OK){
+      sqldbal_sqlite_error(blob->db, rc, SQLDBAL_STATUS_EXEC);
+    }
+  }
+}
+
+/**
+ * Write part of a BLOB value, which cannot change the size of the value.
+ *
+ * @param[in] blob   See @ref sqldbal_blob.
+ * @param[in] offset Byte offset from the start of the value.
+ * @param[in] buf    Bytes to write.
+ * @param[in] len    Number of bytes in @p buf.
+ */
+static void
+sqldbal_sqlite_blob_write(struct sqldbal_blob *const blob,
+                          uint64_t offset,
+                          const void *const buf,
+                          size_t len){
+  int len_i;
+  int rc;
+
+  if(offset > blob->size || len > blob->size - offset){
+    sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_PARAM);
+  }
+  else if(si_size_to_int(len, &len_i)){
+    sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    /* https://www.sqlite.org/c3ref/blob_write.html */
+    rc = sqlite3_blob_write(blob->handle, buf, len_i, (int)offset);
+    if(rc != SQLITE_OK){
+      sqldbal_sqlite_error(blob->db, rc, SQLDBAL_STATUS_EXEC);
+    }
+  }
+}
+
+/**
+ * Close a BLOB handle.
+ *
+ * @param[in] blob See @ref sqldbal_blob.
+ */
+static void
+sqldbal_sqlite_blob_close(struct sqldbal_blob *const blob){
+  int rc;
+
+  if(blob->handle){
+    /* https://www.sqlite.org/c3ref/blob_close.html */
+    rc = sqlite3_blob_close(blob->handle);
+    if(rc != SQLITE_OK){
+      sqldbal_sqlite_error(blob->db, rc, SQLDBAL_STATUS_CLOSE);
+    }
+    blob->handle = NULL;
+  }
+}
+
+/**
+ * SQLite does not have a server connection, so this runs the statement
+ * before returning.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_sqlite_stmt_execute_start(struct sqldbal_stmt *const stmt){
+  sqldbal_sqlite_stmt_execute(stmt);
+}
+
+/**
+ * The statement has already completed in
+ * @ref sqldbal_sqlite_stmt_execute_start.
+ *
+ * @param[in]  stmt        Unused.
+ * @param[out] wait_events Always set to 0.
+ */
+static void
+sqldbal_sqlite_stmt_execute_poll(struct sqldbal_stmt *const stmt,
+                                 int *const wait_events){
+  (void)stmt;
+  *wait_events = 0;
+}
+
+/**
+ * The statement has already completed in
+ * @ref sqldbal_sqlite_stmt_execute_start.
+ *
+ * @param[in] stmt Unused.
+ */
+static void
+sqldbal_sqlite_stmt_execute_finish(struct sqldbal_stmt *const stmt){
+  (void)stmt;
+}
+
+/**
+ * Execute a compiled statement once for each row of column-wise values.
+ *
+ * Runs the bind/step/reset loop inside one transaction if the application
+ * has not already started a transaction, which avoids writing a journal
+ * entry for each row.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in @p param_list.
+ */
+static void
+sqldbal_sqlite_stmt_execute_batch(
+  struct sqldbal_stmt *const stmt,
+  const struct sqldbal_batch_param *const param_list,
+  size_t num_rows){
+  sqlite3 *sqlite_db;
+  sqlite3_stmt *sqlite_stmt;
+  int implicit_transaction;
+
+  sqlite_db = stmt->db->handle;
+  sqlite_stmt = stmt->handle;
+
+  /* https://www.sqlite.org/c3ref/get_autocommit.html */
+  implicit_transaction = sqlite3_get_autocommit(sqlite_db);
+  if(implicit_transaction){
+    sqldbal_sqlite_begin_transaction(stmt->db);
+  }
+  sqldbal_stmt_execute_batch_loop(stmt, param_list, num_rows);
+  if(implicit_transaction){
+    if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      sqldbal_sqlite_commit(stmt->db);
+    }
+    else{
+      /* https://www.sqlite.org/c3ref/reset.html */
+      sqlite3_reset(sqlite_stmt);
+      sqlite3_exec(sqlite_db, "ROLLBACK", NULL, NULL, NULL);
+    }
+  }
+}
+
+/**
+ * Get the next row in the result set.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return See @ref sqldbal_fetch_result.
+ */
+static enum sqldbal_fetch_result
+sqldbal_sqlite_stmt_fetch(struct sqldbal_stmt *const stmt){
+  int step_rc;
+  sqlite3_stmt *sqlite_stmt;
+  unsigned int num_retries;
+  unsigned int retry_execute;
+  enum sqldbal_fetch_result fetch_result;
+
+  sqlite_stmt = stmt->handle;
+  num_retries = 0;
+
+  fetch_result = SQLDBAL_FETCH_ERROR;
+  do{
+    retry_execute = 0;
+
+    /* https://www.sqlite.org/c3ref/step.html */
+    step_rc = sqlite3_step(sqlite_stmt);
+    if(step_rc == SQLITE_ROW){
+      fetch_result = SQLDBAL_FETCH_ROW;
+    }
+    else if(step_rc == SQLITE_DONE){
+      fetch_result = SQLDBAL_FETCH_DONE;
+    }
+    else if(step_rc == SQLITE_BUSY                  &&
+            stmt->db->busy.retry_step              &&
+            sqldbal_sqlite_busy_wait(stmt->db, num_retries)){
+      num_retries += 1;
+      retry_execute = 1;
+    }
+    else{
+      sqldbal_sqlite_error(stmt->db, step_rc, SQLDBAL_STATUS_FETCH);
+    }
+  } while(retry_execute);
+
+  return fetch_result;
+}
+
+/**
+ * SQLite computes the result rows while stepping through them, so the
+ * number of rows is not known in advance.
+ *
+ * @param[in]  stmt     See @ref sqldbal_stmt.
+ * @param[out] num_rows Unused.
+ */
+static void
+sqldbal_sqlite_stmt_num_rows(struct sqldbal_stmt *const stmt,
+                             uint64_t *num_rows){
+  (void)num_rows;
+  sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+}
+
+/**
+ * Move to a row by running the statement again from the start and
+ * stepping over the rows before it.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @param[in] row  Row number starting at 0.
+ */
+static void
+sqldbal_sqlite_stmt_seek(struct sqldbal_stmt *const stmt,
+                         uint64_t row){
+  enum sqldbal_fetch_result fetch_result;
+  uint64_t i;
+
+  /* Do not run statements that do not return rows again. */
+  if(row > 0 && stmt->num_cols_result == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    /* https://www.sqlite.org/c3ref/reset.html */
+    sqlite3_reset(stmt->handle);
+    fetch_result = SQLDBAL_FETCH_ROW;
+    for(i = 0; i < row && fetch_result == SQLDBAL_FETCH_ROW; i++){
+      fetch_result = sqldbal_sqlite_stmt_fetch(stmt);
+    }
+    if(fetch_result == SQLDBAL_FETCH_DONE){
+      sqlite3_reset(stmt->handle);
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+    }
+  }
+}
+
+/**
+ * Get the column result as blob/binary data.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] blob    Binary data.
+ * @param[out] blobsz  Number of bytes in @p blob.
+ */
+static void
+sqldbal_sqlite_stmt_column_blob(struct sqldbal_stmt *const stmt,
+                                size_t col_idx,
+                                const void **blob,
+                                size_t *blobsz){
+  sqlite3_stmt *sqlite_stmt;
+  int col_no_i;
+  int col_bytes;
+
+  sqlite_stmt = stmt->handle;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    /* https://www.sqlite.org/c3ref/column_blob.html */
+    col_bytes = sqlite3_column_bytes(sqlite_stmt, col_no_i);
+    *blob = sqlite3_column_blob(sqlite_stmt, col_no_i);
+
+    if(si_int_to_size(col_bytes, blobsz)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+    }
+    else{
+      if(*blobsz && *blob == NULL){
+        sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_NOMEM);
+      }
+    }
+  }
+}
+
+/**
+ * Copy part of the column result into a buffer.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[in]  offset  Read the bytes starting at this position.
+ * @param[out] buf     Buffer receiving the bytes.
+ * @param[in]  bufsz   Maximum number of bytes to read.
+ * @param[out] len     Number of bytes read.
+ */
+static void
+sqldbal_sqlite_stmt_column_blob_read(struct sqldbal_stmt *const stmt,
+                                     size_t col_idx,
+                                     uint64_t offset,
+                                     void *const buf,
+                                     size_t bufsz,
+                                     size_t *const len){
+  const void *blob;
+  size_t blobsz;
+
+  *len = 0;
+  blob = NULL;
+  blobsz = 0;
+  sqldbal_sqlite_stmt_column_blob(stmt, col_idx, &blob, &blobsz);
+  sqldbal_blob_copy(blob, blobsz, offset, buf, bufsz, len);
+}
+
+/**
+ * Get the column result as a 64-bit integer.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] i64     64-bit integer.
+ */
+static void
+sqldbal_sqlite_stmt_column_int64(struct sqldbal_stmt *const stmt,
+                                 size_t col_idx,
+                                 int64_t *i64){
+  sqlite3_stmt *sqlite_stmt;
+  int col_no_i;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    sqlite_stmt = stmt->handle;
+
+    /* https://www.sqlite.org/c3ref/column_blob.html */
+    *i64 = sqlite3_column_int64(sqlite_stmt, col_no_i);
+  }
+}
+
+/**
+ * Get the column result as a string.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] text    Null-terminated string.
+ * @param[out] textsz  Number of bytes in @p text.
+ */
+static void
+sqldbal_sqlite_stmt_column_text(struct sqldbal_stmt *const stmt,
+                                size_t col_idx,
+                                const char **text,
+                                size_t *textsz){
+  sqlite3_stmt *sqlite_stmt;
+  int col_no_i;
+  int col_bytes;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    sqlite_stmt = stmt->handle;
+
+    /* https://www.sqlite.org/c3ref/column_blob.html */
+    col_bytes = sqlite3_column_bytes(sqlite_stmt, col_no_i);
+    *text = (const char*)sqlite3_column_text(sqlite_stmt, col_no_i);
+
+    if(si_int_to_size(col_bytes, textsz)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+    }
+    else{
+      if(*textsz){
+        *textsz -= 1;
+        if(*text == NULL){
+          sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_NOMEM);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Get the column result as a double-precision floating point number.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] d       Floating point number.
+ */
+static void
+sqldbal_sqlite_stmt_column_double(struct sqldbal_stmt *const stmt,
+                                  size_t col_idx,
+                                  double *d){
+  sqlite3_stmt *sqlite_stmt;
+  int col_no_i;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    sqlite_stmt = stmt->handle;
+
+    /* https://www.sqlite.org/c3ref/column_blob.html */
+    *d = sqlite3_column_double(sqlite_stmt, col_no_i);
+  }
+}
+
+/**
+ * Get the column result as a timestamp.
+ *
+ * Integer values have the number of seconds since 1970-01-01 00:00:00 UTC.
+ * Other values get parsed from their text representation.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] ts      Microseconds since 1970-01-01 00:00:00 UTC.
+ */
+static void
+sqldbal_sqlite_stmt_column_timestamp(struct sqldbal_stmt *const stmt,
+                                     size_t col_idx,
+                                     int64_t *ts){
+  sqlite3_stmt *sqlite_stmt;
+  const char *text;
+  size_t textsz;
+  int64_t seconds;
+  int col_no_i;
+
+  *ts = 0;
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+  }
+  else{
+    sqlite_stmt = stmt->handle;
+
+    /* https://www.sqlite.org/c3ref/column_blob.html */
+    switch(sqlite3_column_type(sqlite_stmt, col_no_i)){
+      case SQLITE_NULL:
+        break;
+      case SQLITE_INTEGER:
+        seconds = sqlite3_column_int64(sqlite_stmt, col_no_i);
+        if(seconds > INT64_MAX / SQLDBAL_USEC_PER_SEC ||
+           seconds < INT64_MIN / SQLDBAL_USEC_PER_SEC){
+          sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+        }
+        else{
+          *ts = seconds * SQLDBAL_USEC_PER_SEC;
+        }
+        break;
+      default:
+        sqldbal_sqlite_stmt_column_text(stmt, col_idx, &text, &textsz);
+        if(text){
+          sqldbal_strtotimestamp(stmt->db, text, ts);
+        }
+        break;
+    }
+  }
+}
+
+/**
+ * Get the column data type.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @return See @ref sqldbal_column_type.
+ */
+static enum sqldbal_column_type
+sqldbal_sqlite_stmt_column_type(struct sqldbal_stmt *const stmt,
+                                size_t col_idx){
+  sqlite3_stmt *sqlite_stmt;
+  enum sqldbal_column_type col_type;
+  int sqlite_col_type;
+  int col_no_i;
+
+  if(si_size_to_int(col_idx, &col_no_i)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+    col_type = SQLDBAL_TYPE_ERROR;
+  }
+  else{
+    sqlite_stmt = stmt->handle;
+
+    /* https://www.sqlite.org/c3ref/column_blob.html */
+    sqlite_col_type = sqlite3_column_type(sqlite_stmt, col_no_i);
+
+    switch(sqlite_col_type){
+      case SQLITE_INTEGER:
+        col_type = SQLDBAL_TYPE_INT;
+        break;
+      case SQLITE_FLOAT:
+        col_type = SQLDBAL_TYPE_DOUBLE;
+        break;
+      case SQLITE_TEXT:
+        col_type = SQLDBAL_TYPE_TEXT;
+        break;
+      case SQLITE_BLOB:
+        col_type = SQLDBAL_TYPE_BLOB;
+        break;
+      case SQLITE_NULL:
+        col_type = SQLDBAL_TYPE_NULL;
+        break;
+      default:
+        col_type = SQLDBAL_TYPE_OTHER;
+        break;
+    }
+  }
+  return col_type;
+}
+
+/**
+ * Reset the statement so that it can run again and set every placeholder
+ * back to NULL.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_sqlite_stmt_reset(struct sqldbal_stmt *const stmt){
+  sqlite3_stmt *sqlite_stmt;
+
+  sqlite_stmt = stmt->handle;
+
+  /* https://www.sqlite.org/c3ref/reset.html */
+  if(sqlite3_reset(sqlite_stmt) != SQLITE_OK){
+    sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_EXEC);
+  }
+  /* https://www.sqlite.org/c3ref/clear_bindings.html */
+  sqlite3_clear_bindings(sqlite_stmt);
+}
+
+/**
+ * Free prepared statement resources.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_sqlite_stmt_close(struct sqldbal_stmt *const stmt){
+  sqlite3_stmt *sqlite_stmt;
+
+  sqlite_stmt = stmt->handle;
+
+  /* https://www.sqlite.org/c3ref/finalize.html */
+  if(sqlite3_finalize(sqlite_stmt) != SQLITE_OK){
+    sqldbal_sqlite_error(stmt->db, 0, SQLDBAL_STATUS_CLOSE);
+  }
+}
+
+#endif /* SQLDBAL_SQLITE */
+
+enum sqldbal_status_code
+sqldbal_status_code_get(const struct sqldbal_db *const db){
+  return db->status_code;
+}
+
+enum sqldbal_status_code
+sqldbal_status_code_clear(struct sqldbal_db *const db){
+  enum sqldbal_status_code status;
+
+  status = sqldbal_status_code_get(db);
+  sqldbal_status_code_set(db, SQLDBAL_STATUS_OK);
+  return status;
+}
+
+enum sqldbal_driver
+sqldbal_driver_type(const struct sqldbal_db *const db){
+  return db->type;
+}
+
+enum sqldbal_status_code
+sqldbal_errstr(const struct sqldbal_db *const db,
+               const char **errstr){
+  enum sqldbal_status_code status;
+  const char *const sqldbal_errstr_list[] = {
+    /* SQLDBAL_STATUS_OK */
+    "Success",
+    /* SQLDBAL_STATUS_PARAM */
+    "Invalid parameter",
+    /* SQLDBAL_STATUS_NOMEM */
+    "Memory allocation failed",
+    /* SQLDBAL_STATUS_OVERFLOW */
+    "Overflow/wrap/conversion",
+    /* SQLDBAL_STATUS_EXEC */
+    "Failed to execute SQL statement",
+    /* SQLDBAL_STATUS_PREPARE */
+    "Failed to prepare statement",
+    /* SQLDBAL_STATUS_BIND */
+    "Failed to bind parameter",
+    /* SQLDBAL_STATUS_FETCH */
+    "Failed to fetch next statement result",
+    /* SQLDBAL_STATUS_COLUMN_COERCE */
+    "Error coercing the requested column value",
+    /* SQLDBAL_STATUS_DRIVER_NOSUPPORT */
+    "Driver not supported",
+    /* SQLDBAL_STATUS_OPEN */
+    "Failed to open database context",
+    /* SQLDBAL_STATUS_CLOSE */
+    "Failed to close database context",
+    /* SQLDBAL_STATUS_TIMEOUT */
+    "Timed out waiting for a connection",
+    /* SQLDBAL_STATUS__LAST */
+    "Unknown error"
+  };
+
+  status = sqldbal_status_code_get(db);
+  if(db->errstr){
+    *errstr = db->errstr;
+  }
+  else{
+    if((unsigned)status >= SQLDBAL_STATUS__LAST){
+      status = SQLDBAL_STATUS__LAST;
+    }
+    *errstr = sqldbal_errstr_list[status];
+  }
+  return status;
+}
+
+/**
+ * Continue a 64-bit FNV-1a hash with more bytes.
+ *
+ * @param[in] hash Hash of the previous bytes.
+ * @param[in] data Bytes to add to the hash.
+ * @param[in] len  Number of bytes in @p data.
+ * @return         Updated hash value.
+ */
+static uint64_t
+sqldbal_result_hash(uint64_t hash,
+                    const void *const data,
+                    size_t len){
+  const unsigned char *bytes;
+  size_t i;
+
+  bytes = data;
+  for(i = 0; i < len; i++){
+    hash ^= bytes[i];
+    hash *= UINT64_C(1099511628211);
+  }
+  return hash;
+}
+
+/**
+ * Check if a character can appear in an unquoted SQL identifier.
+ *
+ * @param[in] c Character to check.
+ * @retval 1 Letter, digit, or underscore.
+ * @retval 0 Other character.
+ */
+static int
+sqldbal_sql_is_ident_char(char c){
+  return (c >= 'a' && c <= 'z') ||
+         (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') ||
+         c == '_';
+}
+
+/**
+ * Convert an ASCII letter to lowercase.
+ *
+ * @param[in] c Character to convert.
+ * @return      Lowercase letter, or @p c if not an uppercase letter.
+ */
+static char
+sqldbal_ascii_lower(char c){
+  if(c >= 'A' && c <= 'Z'){
+    c = (char)(c - 'A' + 'a');
+  }
+  return c;
+}
+
+/**
+ * Check if SQL text contains a word, ignoring case.
+ *
+ * The word only matches if the characters around it can not belong to the
+ * same identifier. For example, "article" matches "FROM article" and
+ * "public.article", but not "FROM article_tag".
+ *
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes.
+ * @param[in] word    Null-terminated word to find.
+ * @retval 1 Found @p word in @p sql.
+ * @retval 0 @p sql does not contain @p word.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_sql_has_word(const char *const sql,
+                     size_t sql_len,
+                     const char *const word){
+  size_t word_len;
+  size_t i;
+  size_t j;
+  int found;
+
+  word_len = strlen(word);
+  found = 0;
+  for(i = 0; word_len && word_len <= sql_len - i && found == 0; i++){
+    if(i == 0 || !sqldbal_sql_is_ident_char(sql[i - 1])){
+      j = 0;
+      while(j < word_len &&
+            sqldbal_ascii_lower(sql[i + j]) == sqldbal_ascii_lower(word[j])){
+        j++;
+      }
+      if(j == word_len &&
+         (i + j == sql_len || !sqldbal_sql_is_ident_char(sql[i + j]))){
+        found = 1;
+      }
+    }
+  }
+  return found;
+}
+
+/**
+ * Check if a SQL statement starts with a keyword, ignoring case.
+ *
+ * Skips leading white space and parentheses.
+ *
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes.
+ * @param[in] keyword Null-terminated lowercase keyword.
+ * @return            Offset in @p sql after the keyword, or 0 if @p sql
+ *                    does not start with @p keyword.
+ */
+static size_t
+sqldbal_sql_keyword_end(const char *const sql,
+                        size_t sql_len,
+                        const char *const keyword){
+  size_t i;
+  size_t j;
+  size_t end;
+
+  i = 0;
+  while(i < sql_len &&
+        (sql[i] == ' '  || sql[i] == '\t' || sql[i] == '\n' ||
+         sql[i] == '\r' || sql[i] == '(')){
+    i++;
+  }
+
+  end = 0;
+  if(sql_len - i >= strlen(keyword)){
+    end = i + strlen(keyword);
+  }
+  for(j = 0; end && keyword[j]; j++){
+    /* Only letters match the keyword after setting the lowercase bit. */
+    if((sql[i + j] | 0x20) != keyword[j]){
+      end = 0;
+    }
+  }
+  if(end && end < sql_len && sqldbal_sql_is_ident_char(sql[end])){
+    end = 0;
+  }
+  return end;
+}
+
+/**
+ * Check if a SQL statement only reads data and can therefore run on a
+ * replica.
+ *
+ * Only statements starting with SELECT qualify, ignoring leading white
+ * space and parentheses. A SELECT still gets rejected if it contains a
+ * word that can write data, take locks, or depend on session state, like
+ * INTO, FOR UPDATE, LOCK IN SHARE MODE, or nextval(). The words also match
+ * inside string literals and identifiers, which only keeps more
+ * statements on the primary.
+ *
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes, or -1 if null-terminated.
+ * @retval 1 Read-only statement.
+ * @retval 0 Statement may change data.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_sql_is_read_only(const char *const sql,
+                         size_t sql_len){
+  const char *const write_word_list[] = {
+    "into",
+    "update",
+    "share",
+    "nextval",
+    "setval",
+    "currval",
+    "lastval",
+    "last_insert_id",
+    "get_lock",
+    "release_lock",
+    "pg_advisory_lock",
+    "pg_advisory_lock_shared",
+    "pg_advisory_xact_lock",
+    "pg_advisory_xact_lock_shared",
+    "pg_try_advisory_lock",
+    "pg_try_advisory_lock_shared",
+    "pg_try_advisory_xact_lock",
+    "pg_try_advisory_xact_lock_shared",
+    "pg_advisory_unlock",
+    "pg_advisory_unlock_all"
+  };
+  size_t end;
+  size_t i;
+  int read_only;
+
+  if(sql_len == (size_t)-1){
+    sql_len = strlen(sql);
+  }
+  end = sqldbal_sql_keyword_end(sql, sql_len, "select");
+  read_only = end && end < sql_len;
+  for(i = 0;
+      read_only &&
+      i < sizeof(write_word_list) / sizeof(write_word_list[0]);
+      i++){
+    if(sqldbal_sql_has_word(sql, sql_len, write_word_list[i])){
+      read_only = 0;
+    }
+  }
+  return read_only;
+}
+
+/**
+ * Check if a SQL statement starts or ends a transaction.
+ *
+ * Recognizes BEGIN, START TRANSACTION, COMMIT, END, and ROLLBACK. A
+ * ROLLBACK TO a savepoint keeps the transaction open.
+ *
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes, or -1 if null-terminated.
+ * @retval 1  Statement starts a transaction.
+ * @retval 0  Statement ends a transaction.
+ * @retval -1 Statement does not change the transaction state.
+ */
+SQLDBAL_LINKAGE int
+sqldbal_sql_transaction_change(const char *const sql,
+                               size_t sql_len){
+  int change;
+
+  if(sql_len == (size_t)-1){
+    sql_len = strlen(sql);
+  }
+  change = -1;
+  if(sqldbal_sql_keyword_end(sql, sql_len, "begin") ||
+     sqldbal_sql_keyword_end(sql, sql_len, "start")){
+    change = 1;
+  }
+  else if(sqldbal_sql_keyword_end(sql, sql_len, "commit") ||
+          sqldbal_sql_keyword_end(sql, sql_len, "end")){
+    change = 0;
+  }
+  else if(sqldbal_sql_keyword_end(sql, sql_len, "rollback") &&
+          sqldbal_sql_has_word(sql, sql_len, "to") == 0){
+    change = 0;
+  }
+  return change;
+}
+
+/**
+ * Value of one column in a row stored in the @ref sqldbal_result_cache.
+ */
+struct sqldbal_result_cell{
+  /**
+   * Value of @ref SQLDBAL_TYPE_INT, @ref SQLDBAL_TYPE_BOOL, and
+   * @ref SQLDBAL_TYPE_TIMESTAMP columns.
+   */
+  int64_t i64;
+
+  /**
+   * Value of @ref SQLDBAL_TYPE_DOUBLE columns.
+   */
+  double d;
+
+  /**
+   * Offset in @ref sqldbal_result_entry::data of the column bytes, which
+   * hold the text form of every column except blobs.
+   */
+  size_t offset;
+
+  /**
+   * Length of the value reported by the driver when the row was fetched.
+   *
+   * Text lengths from some drivers leave out a final byte, so this can be
+   * less than the number of bytes stored at @ref offset.
+   */
+  size_t len;
+
+  /**
+   * See @ref sqldbal_column_type.
+   */
+  enum sqldbal_column_type type;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Result of a query stored in the @ref sqldbal_result_cache.
+ */
+struct sqldbal_result_entry{
+  /**
+   * More recently used result in the cache.
+   */
+  struct sqldbal_result_entry *prev;
+
+  /**
+   * Less recently used result in the cache.
+   */
+  struct sqldbal_result_entry *next;
+
+  /**
+   * Next result in the same hash bucket.
+   */
+  struct sqldbal_result_entry *bucket_next;
+
+  /**
+   * Null-terminated copy of the SQL text, followed by the bytes of
+   * @ref param in the same allocation.
+   */
+  char *sql;
+
+  /**
+   * Length of @ref sql in bytes.
+   */
+  size_t sql_len;
+
+  /**
+   * Type, length, and bytes of every bound parameter value, as encoded by
+   * @ref sqldbal_result_stmt_cacheable. Empty for @ref sqldbal_exec_cached.
+   */
+  char *param;
+
+  /**
+   * Number of bytes in @ref param.
+   */
+  size_t param_len;
+
+  /**
+   * Hash of @ref sql and @ref param, which selects the hash table bucket.
+   */
+  uint64_t hash;
+
+  /**
+   * The result stops being valid at this time.
+   *
+   * See @ref sqldbal_time_ns.
+   */
+  uint64_t expire_ns;
+
+  /**
+   * Values of every row, stored row by row.
+   */
+  struct sqldbal_result_cell *cell_list;
+
+  /**
+   * Number of entries in @ref cell_list.
+   */
+  size_t num_cells;
+
+  /**
+   * Number of entries allocated in @ref cell_list.
+   */
+  size_t cell_size;
+
+  /**
+   * Text and blob bytes referenced by @ref cell_list.
+   */
+  char *data;
+
+  /**
+   * Number of bytes used in @ref data.
+   */
+  size_t data_len;
+
+  /**
+   * Number of bytes allocated in @ref data.
+   */
+  size_t data_size;
+
+  /**
+   * Number of columns in each row.
+   */
+  size_t num_cols;
+
+  /**
+   * Number of rows in the result.
+   */
+  size_t num_rows;
+
+  /**
+   * Number of bytes counted against
+   * @ref sqldbal_result_cache::max_bytes.
+   */
+  size_t num_bytes;
+
+  /**
+   * Number of references held by the cache and by statements returning the
+   * rows. The result gets freed when this drops to 0.
+   */
+  size_t num_refs;
+
+  /**
+   * Set to 1 if the result came from @ref sqldbal_exec_cached.
+   */
+  int exec;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Compute the hash of a result cache key.
+ *
+ * @param[in] sql       SQL text.
+ * @param[in] sql_len   Length of @p sql in bytes.
+ * @param[in] param     See @ref sqldbal_result_entry::param.
+ * @param[in] param_len Number of bytes in @p param.
+ * @return              See @ref sqldbal_result_entry::hash.
+ */
+static uint64_t
+sqldbal_result_key_hash(const char *const sql,
+                        size_t sql_len,
+                        const char *const param,
+                        size_t param_len){
+  return sqldbal_result_hash(sqldbal_stmt_cache_hash(sql, sql_len),
+                             param,
+                             param_len);
+}
+
+/**
+ * Get the hash table bucket that stores results with a given hash.
+ *
+ * @param[in] db   See @ref sqldbal_db.
+ * @param[in] hash See @ref sqldbal_result_entry::hash.
+ * @return         Pointer to the first result in the bucket.
+ */
+static struct sqldbal_result_entry **
+sqldbal_result_cache_bucket(const struct sqldbal_db *const db,
+                            uint64_t hash){
+  size_t bucket_idx;
+
+  bucket_idx = (size_t)(hash & (db->result_cache.num_buckets - 1));
+  return &db->result_cache.bucket_list[bucket_idx];
+}
+
+/**
+ * Drop a reference to a result and free the result once unused.
+ *
+ * @param[in] entry See @ref sqldbal_result_entry.
+ */
+static void
+sqldbal_result_entry_release(struct sqldbal_result_entry *const entry){
+  entry->num_refs -= 1;
+  if(entry->num_refs == 0){
+    free(entry->sql);
+    free(entry->cell_list);
+    free(entry->data);
+    free(entry);
+  }
+}
+
+/**
+ * Allocate an empty result for a query.
+ *
+ * @param[in] sql       SQL text.
+ * @param[in] sql_len   Length of @p sql in bytes.
+ * @param[in] param     See @ref sqldbal_result_entry::param.
+ * @param[in] param_len Number of bytes in @p param.
+ * @param[in] exec      See @ref sqldbal_result_entry::exec.
+ * @return              New result with one reference, or NULL if out of
+ *                      memory.
+ */
+static struct sqldbal_result_entry *
+sqldbal_result_entry_new(const char *const sql,
+                         size_t sql_len,
+                         const char *const param,
+                         size_t param_len,
+                         int exec){
+  struct sqldbal_result_entry *entry;
+
+  entry = malloc(sizeof(*entry));
+  if(entry){
+    entry->sql = malloc(sql_len + 1 + param_len);
+    if(entry->sql == NULL){
+      free(entry);
+      entry = NULL;
+    }
+  }
+  if(entry){
+    memcpy(entry->sql, sql, sql_len);
+    entry->sql[sql_len] = '\0';
+    entry->param = &entry->sql[sql_len + 1];
+    if(param_len){
+      memcpy(entry->param, param, param_len);
+    }
+    entry->prev        = NULL;
+    entry->next        = NULL;
+    entry->bucket_next = NULL;
+    entry->sql_len     = sql_len;
+    entry->param_len   = param_len;
+    entry->hash        = sqldbal_result_key_hash(sql,
+                                                 sql_len,
+                                                 param,
+                                                 param_len);
+    entry->expire_ns   = 0;
+    entry->cell_list   = NULL;
+    entry->num_cells   = 0;
+    entry->cell_size   = 0;
+    entry->data        = NULL;
+    entry->data_len    = 0;
+    entry->data_size   = 0;
+    entry->num_cols    = 0;
+    entry->num_rows    = 0;
+    entry->num_bytes   = 0;
+    entry->num_refs    = 1;
+    entry->exec        = exec;
+  }
+  return entry;
+}
+
+/**
+ * Count the memory used by a result.
+ *
+ * @param[in] entry See @ref sqldbal_result_entry.
+ * @return          Number of bytes allocated for @p entry.
+ */
+static size_t
+sqldbal_result_entry_bytes(const struct sqldbal_result_entry *const entry){
+  return sizeof(*entry) +
+         entry->sql_len + 1 +
+         entry->param_len +
+         entry->cell_size * sizeof(*entry->cell_list) +
+         entry->data_size;
+}
+
+/**
+ * Append a column value to a result.
+ *
+ * @param[in] db    See @ref sqldbal_db.
+ * @param[in] entry See @ref sqldbal_result_entry.
+ * @param[in] type  See @ref sqldbal_column_type.
+ * @param[in] i64   See @ref sqldbal_result_cell::i64.
+ * @param[in] d     See @ref sqldbal_result_cell::d.
+ * @param[in] data  Text or blob bytes of the value.
+ * @param[in] size  Number of bytes in @p data.
+ * @param[in] len   Length of the value reported by the driver, which
+ *                  can not exceed @p size.
+ * @retval  0 Added the value.
+ * @retval -1 Out of memory, or the result does not fit in the cache.
+ */
+static int
+sqldbal_result_entry_add(const struct sqldbal_db *const db,
+                         struct sqldbal_result_entry *const entry,
+                         enum sqldbal_column_type type,
+                         int64_t i64,
+                         double d,
+                         const void *const data,
+                         size_t size,
+                         size_t len){
+  struct sqldbal_result_cell *cell_list;
+  struct sqldbal_result_cell *cell;
+  size_t max_bytes;
+  size_t used;
+  size_t alloc_size;
+  char *buf;
+  int rc;
+
+  rc = 0;
+  max_bytes = db->result_cache.max_bytes;
+  used = sqldbal_result_entry_bytes(entry);
+  if(used > max_bytes ||
+     max_bytes - used < sizeof(*cell) + 1 ||
+     size > max_bytes - used - sizeof(*cell) - 1){
+    rc = -1;
+  }
+
+  if(rc == 0 && entry->num_cells == entry->cell_size){
+    alloc_size = entry->cell_size ? entry->cell_size * 2 : 16;
+    cell_list = sqldbal_reallocarray(entry->cell_list,
+                                     alloc_size,
+                                     sizeof(*cell_list));
+    if(cell_list == NULL){
+      rc = -1;
+    }
+    else{
+      entry->cell_list = cell_list;
+      entry->cell_size = alloc_size;
+    }
+  }
+
+  if(rc == 0 && size + 1 > entry->data_size - entry->data_len){
+    alloc_size = entry->data_size ? entry->data_size : 256;
+    while(size + 1 > alloc_size - entry->data_len &&
+          alloc_size <= SIZE_MAX / 2){
+      alloc_size *= 2;
+    }
+    buf = realloc(entry->data, alloc_size);
+    if(buf == NULL || size + 1 > alloc_size - entry->data_len){
+      if(buf){
+        entry->data = buf;
+        entry->data_size = alloc_size;
+      }
+      rc = -1;
+    }
+    else{
+      entry->data = buf;
+      entry->data_size = alloc_size;
+    }
+  }
+
+  if(rc == 0){
+    cell = &entry->cell_list[entry->num_cells];
+    cell->i64    = i64;
+    cell->d      = d;
+    cell->offset = entry->data_len;
+    cell->len    = len;
+    cell->type   = type;
+    if(size){
+      memcpy(&entry->data[entry->data_len], data, size);
+    }
+    entry->data[entry->data_len + size] = '\0';
+    entry->data_len += size + 1;
+    entry->num_cells += 1;
+  }
+  return rc;
+}
+
+/**
+ * Remove a result from the LRU list.
+ *
+ * @param[in] cache See @ref sqldbal_result_cache.
+ * @param[in] entry Result currently in the cache.
+ */
+static void
+sqldbal_result_cache_lru_remove(struct sqldbal_result_cache *const cache,
+                                struct sqldbal_result_entry *const entry){
+  if(entry->prev){
+    entry->prev->next = entry->next;
+  }
+  else{
+    cache->lru_head = entry->next;
+  }
+  if(entry->next){
+    entry->next->prev = entry->prev;
+  }
+  else{
+    cache->lru_tail = entry->prev;
+  }
+  entry->prev = NULL;
+  entry->next = NULL;
+}
+
+/**
+ * Add a result to the front of the LRU list.
+ *
+ * @param[in] cache See @ref sqldbal_result_cache.
+ * @param[in] entry Result not currently in the LRU list.
+ */
+static void
+sqldbal_result_cache_lru_push(struct sqldbal_result_cache *const cache,
+                              struct sqldbal_result_entry *const entry){
+  entry->prev = NULL;
+  entry->next = cache->lru_head;
+  if(cache->lru_head){
+    cache->lru_head->prev = entry;
+  }
+  else{
+    cache->lru_tail = entry;
+  }
+  cache->lru_head = entry;
+}
+
+/**
+ * Remove a result from the cache and drop the reference held by the
+ * cache.
+ *
+ * @param[in] db    See @ref sqldbal_db.
+ * @param[in] entry Result currently in the cache.
+ */
+static void
+sqldbal_result_cache_unlink(struct sqldbal_db *const db,
+                            struct sqldbal_result_entry *const entry){
+  struct sqldbal_result_entry **link;
+
+  link = sqldbal_result_cache_bucket(db, entry->hash);
+  while(*link != entry){
+    link = &(*link)->bucket_next;
+  }
+  *link = entry->bucket_next;
+  entry->bucket_next = NULL;
+  sqldbal_result_cache_lru_remove(&db->result_cache, entry);
+  db->result_cache.num_bytes -= entry->num_bytes;
+  sqldbal_result_entry_release(entry);
+}
+
+/**
+ * Remove every result from the cache.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_result_cache_flush(struct sqldbal_db *const db){
+  while(db->result_cache.lru_head){
+    sqldbal_result_cache_unlink(db, db->result_cache.lru_head);
+  }
+}
+
+/**
+ * Find a cached result for a query.
+ *
+ * The hash only narrows down the search, and a result must have the same
+ * SQL text and parameter bytes to match.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sql       SQL text.
+ * @param[in] sql_len   Length of @p sql in bytes.
+ * @param[in] param     See @ref sqldbal_result_entry::param.
+ * @param[in] param_len Number of bytes in @p param.
+ * @param[in] exec      See @ref sqldbal_result_entry::exec.
+ * @retval sqldbal_result_entry* Cached result.
+ * @retval NULL                  Result not in the cache.
+ */
+static struct sqldbal_result_entry *
+sqldbal_result_cache_find(const struct sqldbal_db *const db,
+                          const char *const sql,
+                          size_t sql_len,
+                          const char *const param,
+                          size_t param_len,
+                          int exec){
+  struct sqldbal_result_entry *entry;
+  uint64_t hash;
+
+  hash = sqldbal_result_key_hash(sql, sql_len, param, param_len);
+  entry = *sqldbal_result_cache_bucket(db, hash);
+  while(entry &&
+        (entry->hash != hash ||
+         entry->exec != exec ||
+         entry->sql_len != sql_len ||
+         entry->param_len != param_len ||
+         memcmp(entry->sql, sql, sql_len) != 0 ||
+         (param_len && memcmp(entry->param, param, param_len) != 0))){
+    entry = entry->bucket_next;
+  }
+  return entry;
+}
+
+/**
+ * Get a cached result that has not expired, and count the cache hit or
+ * miss.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sql       SQL text.
+ * @param[in] sql_len   Length of @p sql in bytes.
+ * @param[in] param     See @ref sqldbal_result_entry::param.
+ * @param[in] param_len Number of bytes in @p param.
+ * @param[in] exec      See @ref sqldbal_result_entry::exec.
+ * @retval sqldbal_result_entry* Cached result, which stays owned by the
+ *                               cache.
+ * @retval NULL                  Result not in the cache.
+ */
+static struct sqldbal_result_entry *
+sqldbal_result_cache_get(struct sqldbal_db *const db,
+                         const char *const sql,
+                         size_t sql_len,
+                         const char *const param,
+                         size_t param_len,
+                         int exec){
+  struct sqldbal_result_entry *entry;
+
+  entry = sqldbal_result_cache_find(db,
+                                    sql,
+                                    sql_len,
+                                    param,
+                                    param_len,
+                                    exec);
+  if(entry && entry->expire_ns <= sqldbal_time_ns()){
+    sqldbal_result_cache_unlink(db, entry);
+    entry = NULL;
+  }
+  if(entry){
+    sqldbal_result_cache_lru_remove(&db->result_cache, entry);
+    sqldbal_result_cache_lru_push(&db->result_cache, entry);
+    db->result_cache.num_hits += 1;
+  }
+  else{
+    db->result_cache.num_misses += 1;
+  }
+  return entry;
+}
+
+/**
+ * Add a complete result to the cache, replacing any older result of the
+ * same query, and evict the least recently used results until the cache
+ * fits in its memory budget.
+ *
+ * @param[in] db    See @ref sqldbal_db.
+ * @param[in] entry Result whose reference moves to the cache.
+ */
+static void
+sqldbal_result_cache_put(struct sqldbal_db *const db,
+                         struct sqldbal_result_entry *const entry){
+  struct sqldbal_result_cache *cache;
+  struct sqldbal_result_entry *old;
+  struct sqldbal_result_entry **bucket;
+  uint64_t now_ns;
+
+  cache = &db->result_cache;
+  entry->num_bytes = sqldbal_result_entry_bytes(entry);
+  if(cache->max_bytes == 0 || entry->num_bytes > cache->max_bytes){
+    sqldbal_result_entry_release(entry);
+  }
+  else{
+    old = sqldbal_result_cache_find(db,
+                                    entry->sql,
+                                    entry->sql_len,
+                                    entry->param,
+                                    entry->param_len,
+                                    entry->exec);
+    if(old){
+      sqldbal_result_cache_unlink(db, old);
+    }
+    while(cache->num_bytes > cache->max_bytes - entry->num_bytes){
+      sqldbal_result_cache_unlink(db, cache->lru_tail);
+    }
+
+    now_ns = sqldbal_time_ns();
+    if(cache->ttl_ns > UINT64_MAX - now_ns){
+      entry->expire_ns = UINT64_MAX;
+    }
+    else{
+      entry->expire_ns = now_ns + cache->ttl_ns;
+    }
+    bucket = sqldbal_result_cache_bucket(db, entry->hash);
+    entry->bucket_next = *bucket;
+    *bucket = entry;
+    sqldbal_result_cache_lru_push(cache, entry);
+    cache->num_bytes += entry->num_bytes;
+  }
+}
+
+/**
+ * Stop returning or collecting a cached result for a statement.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_result_stmt_clear(struct sqldbal_stmt *const stmt){
+  if(stmt->result_entry){
+    sqldbal_result_entry_release(stmt->result_entry);
+    stmt->result_entry = NULL;
+  }
+  if(stmt->result_capture){
+    sqldbal_result_entry_release(stmt->result_capture);
+    stmt->result_capture = NULL;
+  }
+  stmt->result_row = 0;
+}
+
+#ifdef SQLDBAL_TRACE
+/**
+ * Keep the start of the SQL text for the trace entries of a statement.
+ *
+ * The entries have an empty SQL text if this runs out of memory.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes.
+ */
+static void
+sqldbal_trace_stmt_init(struct sqldbal_stmt *const stmt,
+                        const char *const sql,
+                        size_t sql_len){
+  size_t copy_len;
+
+  copy_len = sql_len;
+  if(copy_len > SQLDBAL_TRACE_SQL_MAX - 1){
+    copy_len = SQLDBAL_TRACE_SQL_MAX - 1;
+  }
+  stmt->trace_sql = malloc(copy_len + 1);
+  if(stmt->trace_sql){
+    memcpy(stmt->trace_sql, sql, copy_len);
+    stmt->trace_sql[copy_len] = '\0';
+    stmt->trace_sql_len = sql_len;
+  }
+}
+#endif /* SQLDBAL_TRACE */
+
+/**
+ * Keep the SQL text of a read-only statement so that
+ * @ref sqldbal_stmt_set_result_cache can enable the result cache.
+ *
+ * The statement can not use the cache if this runs out of memory.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes, or -1 if null-terminated.
+ */
+static void
+sqldbal_result_stmt_init(struct sqldbal_stmt *const stmt,
+                         const char *const sql,
+                         size_t sql_len){
+  if(sql_len == (size_t)-1){
+    sql_len = strlen(sql);
+  }
+  stmt->result_sql = malloc(sql_len + 1);
+  if(stmt->result_sql){
+    memcpy(stmt->result_sql, sql, sql_len);
+    stmt->result_sql[sql_len] = '\0';
+    stmt->result_sql_len = sql_len;
+  }
+}
+
+/**
+ * Stop using the result cache for a statement and free the recorded
+ * parameter values.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_result_param_free(struct sqldbal_stmt *const stmt){
+  size_t i;
+
+  if(stmt->result_param_list){
+    for(i = 0; i < stmt->num_params; i++){
+      free(stmt->result_param_list[i].buf);
+    }
+    free(stmt->result_param_list);
+    stmt->result_param_list = NULL;
+  }
+}
+
+/**
+ * Record that every parameter of a statement went back to NULL.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_result_param_reset(struct sqldbal_stmt *const stmt){
+  struct sqldbal_result_param *param;
+  size_t i;
+
+  if(stmt->result_param_list){
+    for(i = 0; i < stmt->num_params; i++){
+      param = &stmt->result_param_list[i];
+      param->data      = NULL;
+      param->len       = 0;
+      param->type      = SQLDBAL_TYPE_NULL;
+      param->cacheable = 1;
+    }
+  }
+}
+
+/**
+ * Record the value bound to a parameter for the result cache key.
+ *
+ * The bytes of a static bind only get read when the statement executes,
+ * like the driver does.
+ *
+ * @param[in] stmt      See @ref sqldbal_stmt.
+ * @param[in] col_idx   Parameter index.
+ * @param[in] type      See @ref sqldbal_column_type.
+ * @param[in] data      Bytes of the bound value.
+ * @param[in] len       Number of bytes in @p data.
+ * @param[in] is_static Set to 1 if @p data stays valid until the
+ *                      statement executes.
+ */
+static void
+sqldbal_result_bind(struct sqldbal_stmt *const stmt,
+                    size_t col_idx,
+                    enum sqldbal_column_type type,
+                    const void *const data,
+                    size_t len,
+                    int is_static){
+  struct sqldbal_result_param *param;
+  char *buf;
+
+  if(stmt->result_param_list){
+    param = &stmt->result_param_list[col_idx];
+    param->data      = data;
+    param->len       = len;
+    param->type      = type;
+    param->cacheable = 1;
+    if(is_static == 0 && len){
+      if(len > param->size){
+        buf = realloc(param->buf, len);
+        if(buf == NULL){
+          param->cacheable = 0;
+        }
+        else{
+          param->buf = buf;
+          param->size = len;
+        }
+      }
+      if(param->cacheable){
+        memcpy(param->buf, data, len);
+        param->data = param->buf;
+      }
+    }
+  }
+}
+
+/**
+ * Check if the next execution of a statement can use the result cache,
+ * and encode the bound parameter values for the cache key.
+ *
+ * Each parameter adds its type byte, its length, and its bytes.
+ *
+ * @param[in]  stmt      See @ref sqldbal_stmt.
+ * @param[out] param     Encoded parameter values, which the caller must
+ *                       free.
+ * @param[out] param_len Number of bytes in @p param.
+ * @retval 1 The result can come from or go into the cache.
+ * @retval 0 The statement must run without the cache.
+ */
+static int
+sqldbal_result_stmt_cacheable(const struct sqldbal_stmt *const stmt,
+                              char **param,
+                              size_t *param_len){
+  const struct sqldbal_result_param *bound;
+  unsigned char type_byte;
+  size_t len;
+  size_t i;
+  int cacheable;
+
+  *param = NULL;
+  *param_len = 0;
+  cacheable = 0;
+  if(stmt->result_param_list &&
+     stmt->db->result_cache.max_bytes &&
+     stmt->db->transaction == 0 &&
+     stmt->db->pipeline == 0){
+    cacheable = 1;
+    len = 0;
+    for(i = 0; i < stmt->num_params && cacheable; i++){
+      bound = &stmt->result_param_list[i];
+      if(bound->cacheable == 0 ||
+         len > SIZE_MAX - 1 - sizeof(bound->len) ||
+         bound->len > SIZE_MAX - 1 - sizeof(bound->len) - len){
+        cacheable = 0;
+      }
+      else{
+        len += 1 + sizeof(bound->len) + bound->len;
+      }
+    }
+    if(cacheable){
+      *param = malloc(len ? len : 1);
+      if(*param == NULL){
+        cacheable = 0;
+      }
+    }
+  }
+
+  if(cacheable){
+    for(i = 0; i < stmt->num_params; i++){
+      bound = &stmt->result_param_list[i];
+      type_byte = (unsigned char)bound->type;
+      memcpy(&(*param)[*param_len], &type_byte, 1);
+      memcpy(&(*param)[*param_len + 1], &bound->len, sizeof(bound->len));
+      *param_len += 1 + sizeof(bound->len);
+      if(bound->len){
+        memcpy(&(*param)[*param_len], bound->data, bound->len);
+        *param_len += bound->len;
+      }
+    }
+  }
+  return cacheable;
+}
+
+/**
+ * Copy the current row from the driver into the result being collected
+ * for the cache.
+ *
+ * Stops collecting the result if it does not fit in the cache or a value
+ * can not get read, without changing what the application sees.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_result_capture_row(struct sqldbal_stmt *const stmt){
+  const struct sqldbal_driver_functions *func;
+  enum sqldbal_column_type type;
+  const void *blob;
+  const char *text;
+  size_t col_idx;
+  size_t size;
+  size_t len;
+  int64_t i64;
+  double d;
+  int rc;
+
+  func = SQLDBAL_FUNCTIONS(stmt->db);
+  rc = 0;
+  if(sqldbal_status_code_get(stmt->db) != SQLDBAL_STATUS_OK){
+    rc = -1;
+  }
+  for(col_idx = 0; col_idx < stmt->num_cols_result && rc == 0; col_idx++){
+    type = func->sqldbal_fp_stmt_column_type(stmt, col_idx);
+    i64 = 0;
+    d = 0;
+    blob = NULL;
+    size = 0;
+    len = 0;
+    if(type == SQLDBAL_TYPE_BLOB){
+      func->sqldbal_fp_stmt_column_blob(stmt, col_idx, &blob, &len);
+      size = len;
+    }
+    else if(type != SQLDBAL_TYPE_NULL && type != SQLDBAL_TYPE_ERROR){
+      if(type == SQLDBAL_TYPE_INT || type == SQLDBAL_TYPE_BOOL){
+        func->sqldbal_fp_stmt_column_int64(stmt, col_idx, &i64);
+      }
+      else if(type == SQLDBAL_TYPE_DOUBLE){
+        func->sqldbal_fp_stmt_column_double(stmt, col_idx, &d);
+      }
+      else if(type == SQLDBAL_TYPE_TIMESTAMP){
+        func->sqldbal_fp_stmt_column_timestamp(stmt, col_idx, &i64);
+      }
+      text = NULL;
+      func->sqldbal_fp_stmt_column_text(stmt, col_idx, &text, &len);
+      blob = text;
+
+      /*
+       * The SQLite and MariaDB lengths leave out the last byte, which only
+       * holds the null-terminator for text bound by sqldbal. Keep every
+       * byte up to the terminator so hits return the same string.
+       */
+      size = text ? strlen(text) : 0;
+      if(size < len){
+        size = len;
+      }
+    }
+
+    if(sqldbal_status_code_get(stmt->db) != SQLDBAL_STATUS_OK){
+      /* The application did not ask for this conversion. */
+      sqldbal_status_code_clear(stmt->db);
+      rc = -1;
+    }
+    else if(type == SQLDBAL_TYPE_ERROR){
+      rc = -1;
+    }
+    else{
+      rc = sqldbal_result_entry_add(stmt->db,
+                                    stmt->result_capture,
+                                    type,
+                                    i64,
+                                    d,
+                                    blob,
+                                    size,
+                                    len);
+    }
+  }
+
+  if(rc == 0){
+    stmt->result_capture->num_rows += 1;
+  }
+  else{
+    sqldbal_result_entry_release(stmt->result_capture);
+    stmt->result_capture = NULL;
+  }
+}
+
+/**
+ * Collect the rows fetched from the driver, and move the result into the
+ * cache after the last row.
+ *
+ * @param[in] stmt         See @ref sqldbal_stmt.
+ * @param[in] fetch_result Value returned by the driver fetch.
+ */
+static void
+sqldbal_result_capture(struct sqldbal_stmt *const stmt,
+                       enum sqldbal_fetch_result fetch_result){
+  if(fetch_result == SQLDBAL_FETCH_ROW){
+    sqldbal_result_capture_row(stmt);
+  }
+  else if(fetch_result == SQLDBAL_FETCH_DONE){
+    sqldbal_result_cache_put(stmt->db, stmt->result_capture);
+    stmt->result_capture = NULL;
+  }
+  else{
+    sqldbal_result_entry_release(stmt->result_capture);
+    stmt->result_capture = NULL;
+  }
+}
+
+/**
+ * Get the next row of a cached result.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return         See @ref sqldbal_fetch_result.
+ */
+static enum sqldbal_fetch_result
+sqldbal_result_fetch(struct sqldbal_stmt *const stmt){
+  enum sqldbal_fetch_result fetch_result;
+
+  fetch_result = SQLDBAL_FETCH_DONE;
+  if(stmt->result_row < stmt->result_entry->num_rows){
+    stmt->result_row += 1;
+    fetch_result = SQLDBAL_FETCH_ROW;
+  }
+  else{
+    stmt->result_row = stmt->result_entry->num_rows + 1;
+  }
+  return fetch_result;
+}
+
+/**
+ * Get a column value in the current row of a cached result.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Column index.
+ * @return            Column value, or NULL if no current row.
+ */
+static const struct sqldbal_result_cell *
+sqldbal_result_cell(struct sqldbal_stmt *const stmt,
+                    size_t col_idx){
+  const struct sqldbal_result_entry *entry;
+  const struct sqldbal_result_cell *cell;
+
+  entry = stmt->result_entry;
+  cell = NULL;
+  if(stmt->result_row == 0 || stmt->result_row > entry->num_rows){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    cell = &entry->cell_list[(stmt->result_row - 1) * entry->num_cols +
+                             col_idx];
+  }
+  return cell;
+}
+
+/**
+ * Get a blob or text column value from a cached result.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] data    Column bytes, or NULL for a NULL value.
+ * @param[out] len     Number of bytes in @p data.
+ */
+static void
+sqldbal_result_column_bytes(struct sqldbal_stmt *const stmt,
+                            size_t col_idx,
+                            const char **data,
+                            size_t *len){
+  const struct sqldbal_result_cell *cell;
+
+  *data = NULL;
+  *len = 0;
+  cell = sqldbal_result_cell(stmt, col_idx);
+  if(cell && cell->type != SQLDBAL_TYPE_NULL){
+    *data = &stmt->result_entry->data[cell->offset];
+    *len = cell->len;
+  }
+}
+
+/**
+ * Get a blob column value from a cached result.
+ *
+ * See @ref sqldbal_driver_functions::sqldbal_fp_stmt_column_blob.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] blob    See @ref sqldbal_stmt_column_blob.
+ * @param[out] blobsz  See @ref sqldbal_stmt_column_blob.
+ */
+static void
+sqldbal_result_column_blob(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           const void **blob,
+                           size_t *blobsz){
+  const char *data;
+
+  sqldbal_result_column_bytes(stmt, col_idx, &data, blobsz);
+  *blob = data;
+}
+
+/**
+ * Get an integer column value from a cached result.
+ *
+ * Text values get converted the same way as the MariaDB driver.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] i64     See @ref sqldbal_stmt_column_int64.
+ */
+static void
+sqldbal_result_column_int64(struct sqldbal_stmt *const stmt,
+                            size_t col_idx,
+                            int64_t *i64){
+  const struct sqldbal_result_cell *cell;
+  const char *text;
+  char *ep;
+  long long int lli;
+
+  *i64 = 0;
+  cell = sqldbal_result_cell(stmt, col_idx);
+  if(cell == NULL || cell->type == SQLDBAL_TYPE_NULL){
+    /* Leave the value at 0. */
+  }
+  else if(cell->type == SQLDBAL_TYPE_DOUBLE){
+    *i64 = (int64_t)cell->d;
+  }
+  else if(cell->type == SQLDBAL_TYPE_INT ||
+          cell->type == SQLDBAL_TYPE_BOOL ||
+          cell->type == SQLDBAL_TYPE_TIMESTAMP){
+    *i64 = cell->i64;
+  }
+  else{
+    text = &stmt->result_entry->data[cell->offset];
+    errno = 0;
+    lli = strtoll(text, &ep, 10);
+    if(text[0] == '\0' || *ep != '\0' || errno == ERANGE){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+    }
+    else{
+      *i64 = (int64_t)lli;
+    }
+  }
+}
+
+/**
+ * Get a text column value from a cached result.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] text    See @ref sqldbal_stmt_column_text.
+ * @param[out] textsz  See @ref sqldbal_stmt_column_text.
+ */
+static void
+sqldbal_result_column_text(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           const char **text,
+                           size_t *textsz){
+  sqldbal_result_column_bytes(stmt, col_idx, text, textsz);
+}
+
+/**
+ * Get a floating point column value from a cached result.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] d       See @ref sqldbal_stmt_column_double.
+ */
+static void
+sqldbal_result_column_double(struct sqldbal_stmt *const stmt,
+                             size_t col_idx,
+                             double *d){
+  const struct sqldbal_result_cell *cell;
+  const char *text;
+  char *ep;
+
+  *d = 0;
+  cell = sqldbal_result_cell(stmt, col_idx);
+  if(cell == NULL || cell->type == SQLDBAL_TYPE_NULL){
+    /* Leave the value at 0. */
+  }
+  else if(cell->type == SQLDBAL_TYPE_DOUBLE){
+    *d = cell->d;
+  }
+  else if(cell->type == SQLDBAL_TYPE_INT ||
+          cell->type == SQLDBAL_TYPE_BOOL ||
+          cell->type == SQLDBAL_TYPE_TIMESTAMP){
+    *d = (double)cell->i64;
+  }
+  else{
+    text = &stmt->result_entry->data[cell->offset];
+    errno = 0;
+    *d = strtod(text, &ep);
+    if(text[0] == '\0' || *ep != '\0' || errno == ERANGE){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+      *d = 0;
+    }
+  }
+}
+
+/**
+ * Get a timestamp column value from a cached result.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index.
+ * @param[out] ts      See @ref sqldbal_stmt_column_timestamp.
+ */
+static void
+sqldbal_result_column_timestamp(struct sqldbal_stmt *const stmt,
+                                size_t col_idx,
+                                int64_t *ts){
+  const struct sqldbal_result_cell *cell;
+
+  *ts = 0;
+  cell = sqldbal_result_cell(stmt, col_idx);
+  if(cell == NULL || cell->type == SQLDBAL_TYPE_NULL){
+    /* Leave the value at 0. */
+  }
+  else if(cell->type == SQLDBAL_TYPE_TEXT ||
+          cell->type == SQLDBAL_TYPE_OTHER){
+    sqldbal_strtotimestamp(stmt->db,
+                           &stmt->result_entry->data[cell->offset],
+                           ts);
+  }
+  else{
+    sqldbal_result_column_int64(stmt, col_idx, ts);
+  }
+}
+
+/**
+ * Get the type of a column value from a cached result.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Column index.
+ * @return            See @ref sqldbal_column_type.
+ */
+static enum sqldbal_column_type
+sqldbal_result_column_type(struct sqldbal_stmt *const stmt,
+                           size_t col_idx){
+  const struct sqldbal_result_cell *cell;
+  enum sqldbal_column_type type;
+
+  type = SQLDBAL_TYPE_ERROR;
+  cell = sqldbal_result_cell(stmt, col_idx);
+  if(cell){
+    type = cell->type;
+  }
+  return type;
+}
+
+/**
+ * Get the hash table bucket that stores statements with a given hash.
+ *
+ * @param[in] db   See @ref sqldbal_db.
+ * @param[in] hash See @ref sqldbal_stmt_cache_hash.
+ * @return         Pointer to the first statement in the bucket.
+ */
+static struct sqldbal_stmt **
+sqldbal_stmt_cache_bucket(const struct sqldbal_db *const db,
+                          uint64_t hash){
+  size_t bucket_idx;
+
+  bucket_idx = (size_t)(hash & (db->stmt_cache.num_buckets - 1));
+  return &db->stmt_cache.bucket_list[bucket_idx];
+}
+
+/**
+ * Remove a statement from the hash table and the LRU list.
+ *
+ * @param[in] db   See @ref sqldbal_db.
+ * @param[in] stmt Statement currently in the cache.
+ */
+static void
+sqldbal_stmt_cache_unlink(struct sqldbal_db *const db,
+                          struct sqldbal_stmt *const stmt){
+  struct sqldbal_stmt_cache *cache;
+  struct sqldbal_stmt **link;
+
+  cache = &db->stmt_cache;
+  link = sqldbal_stmt_cache_bucket(db, stmt->cache_hash);
+  while(*link != stmt){
+    link = &(*link)->cache_bucket_next;
+  }
+  *link = stmt->cache_bucket_next;
+
+  if(stmt->cache_prev){
+    stmt->cache_prev->cache_next = stmt->cache_next;
+  }
+  else{
+    cache->lru_head = stmt->cache_next;
+  }
+  if(stmt->cache_next){
+    stmt->cache_next->cache_prev = stmt->cache_prev;
+  }
+  else{
+    cache->lru_tail = stmt->cache_prev;
+  }
+  stmt->cache_prev        = NULL;
+  stmt->cache_next        = NULL;
+  stmt->cache_bucket_next = NULL;
+  cache->num_stmts -= 1;
+}
+
+/**
+ * Close the driver statement and free the statement memory.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_stmt_free(struct sqldbal_stmt *const stmt){
+  size_t i;
+
+  SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_close(stmt);
+  sqldbal_result_stmt_clear(stmt);
+  if(stmt->stream_list){
+    for(i = 0; i < stmt->num_params; i++){
+      free(stmt->stream_list[i].buf);
+    }
+    free(stmt->stream_list);
+  }
+  free(stmt->result_sql);
+  free(stmt->trace_sql);
+  sqldbal_result_param_free(stmt);
+  free(stmt->cache_sql);
+  free(stmt);
+}
+
+/**
+ * Close every statement in the cache.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ */
+static void
+sqldbal_stmt_cache_flush(struct sqldbal_db *const db){
+  struct sqldbal_stmt *stmt;
+
+  while((stmt = db->stmt_cache.lru_head) != NULL){
+    sqldbal_stmt_cache_unlink(db, stmt);
+    sqldbal_stmt_free(stmt);
+  }
+}
+
+/**
+ * Remove and return a cached statement compiled from the same SQL text.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] sql     SQL text.
+ * @param[in] sql_len Length of @p sql in bytes.
+ * @param[in] hash    See @ref sqldbal_stmt_cache_hash.
+ * @retval sqldbal_stmt* Cached statement.
+ * @retval NULL          Statement not in the cache.
+ */
+static struct sqldbal_stmt *
+sqldbal_stmt_cache_take(struct sqldbal_db *const db,
+                        const char *const sql,
+                        size_t sql_len,
+                        uint64_t hash){
+  struct sqldbal_stmt *stmt;
+
+  stmt = *sqldbal_stmt_cache_bucket(db, hash);
+  while(stmt &&
+        (stmt->cache_hash != hash ||
+         stmt->cache_sql_len != sql_len ||
+         memcmp(stmt->cache_sql, sql, sql_len) != 0)){
+    stmt = stmt->cache_bucket_next;
+  }
+  if(stmt){
+    sqldbal_stmt_cache_unlink(db, stmt);
+  }
+  return stmt;
+}
+
+/**
+ * Add a statement to the cache as the most recently used entry, and close
+ * the least recently used statement if the cache has too many entries.
+ *
+ * @param[in] db   See @ref sqldbal_db.
+ * @param[in] stmt Reset statement not currently in the cache.
+ */
+static void
+sqldbal_stmt_cache_put(struct sqldbal_db *const db,
+                       struct sqldbal_stmt *const stmt){
+  struct sqldbal_stmt_cache *cache;
+  struct sqldbal_stmt **bucket;
+  struct sqldbal_stmt *evict;
+
+  cache = &db->stmt_cache;
+  bucket = sqldbal_stmt_cache_bucket(db, stmt->cache_hash);
+  stmt->cache_bucket_next = *bucket;
+  *bucket = stmt;
+
+  stmt->cache_prev = NULL;
+  stmt->cache_next = cache->lru_head;
+  if(cache->lru_head){
+    cache->lru_head->cache_prev = stmt;
+  }
+  else{
+    cache->lru_tail = stmt;
+  }
+  cache->lru_head = stmt;
+  cache->num_stmts += 1;
+
+  if(cache->num_stmts > cache->capacity){
+    evict = cache->lru_tail;
+    sqldbal_stmt_cache_unlink(db, evict);
+    sqldbal_stmt_free(evict);
+  }
+}
+
+/**
+ * Functions used by connections without a supported driver, which only
+ * ever get passed to @ref sqldbal_close.
+ */
+static const struct sqldbal_driver_functions g_sqldbal_no_functions;
+
+#ifdef SQLDBAL_MARIADB
+/**
+ * Functions shared by every MariaDB/MySQL connection.
+ */
+static const struct sqldbal_driver_functions
+g_sqldbal_mariadb_functions = {
+  sqldbal_mariadb_open,                  /* sqldbal_fp_open                  */
+  sqldbal_mariadb_connect_start,         /* sqldbal_fp_connect_start         */
+  sqldbal_mariadb_connect_poll,          /* sqldbal_fp_connect_poll          */
+  sqldbal_mariadb_close,                 /* sqldbal_fp_close                 */
+  sqldbal_mariadb_db_handle,             /* sqldbal_fp_db_handle             */
+  sqldbal_mariadb_stmt_handle,           /* sqldbal_fp_stmt_handle           */
+  sqldbal_mariadb_begin_transaction,     /* sqldbal_fp_begin_transaction     */
+  sqldbal_mariadb_commit,                /* sqldbal_fp_commit                */
+  sqldbal_mariadb_rollback,              /* sqldbal_fp_rollback              */
+  sqldbal_mariadb_pipeline_begin,        /* sqldbal_fp_pipeline_begin        */
+  sqldbal_mariadb_pipeline_end,          /* sqldbal_fp_pipeline_end          */
+  sqldbal_mariadb_bulk_begin,            /* sqldbal_fp_bulk_begin            */
+  sqldbal_mariadb_bulk_row,              /* sqldbal_fp_bulk_row              */
+  sqldbal_mariadb_bulk_end,              /* sqldbal_fp_bulk_end              */
+  sqldbal_mariadb_blob_open,             /* sqldbal_fp_blob_open             */
+  sqldbal_mariadb_blob_read,             /* sqldbal_fp_blob_read             */
+  sqldbal_mariadb_blob_write,            /* sqldbal_fp_blob_write            */
+  sqldbal_mariadb_blob_close,            /* sqldbal_fp_blob_close            */
+  sqldbal_mariadb_exec,                  /* sqldbal_fp_exec                  */
+  sqldbal_mariadb_last_insert_id,        /* sqldbal_fp_last_insert_id        */
+  sqldbal_mariadb_ping,                  /* sqldbal_fp_ping                  */
+  sqldbal_mariadb_socket_fd,             /* sqldbal_fp_socket_fd             */
+  sqldbal_mariadb_param_limit,           /* sqldbal_fp_param_limit           */
+  sqldbal_mariadb_stmt_prepare,          /* sqldbal_fp_stmt_prepare          */
+  sqldbal_mariadb_stmt_cursor,           /* sqldbal_fp_stmt_cursor           */
+  sqldbal_mariadb_stmt_bind_blob,        /* sqldbal_fp_stmt_bind_blob        */
+  sqldbal_mariadb_stmt_bind_int64,       /* sqldbal_fp_stmt_bind_int64       */
+  sqldbal_mariadb_stmt_bind_text,        /* sqldbal_fp_stmt_bind_text        */
+  sqldbal_mariadb_stmt_bind_blob_static, /* sqldbal_fp_stmt_bind_blob_static */
+  sqldbal_mariadb_stmt_bind_text_static, /* sqldbal_fp_stmt_bind_text_static */
+  sqldbal_mariadb_stmt_bind_double,      /* sqldbal_fp_stmt_bind_double      */
+  sqldbal_mariadb_stmt_bind_timestamp,   /* sqldbal_fp_stmt_bind_timestamp   */
+  sqldbal_mariadb_stmt_bind_null,        /* sqldbal_fp_stmt_bind_null        */
+  sqldbal_mariadb_stmt_bind_blob_stream, /* sqldbal_fp_stmt_bind_blob_stream */
+  sqldbal_mariadb_stmt_send_blob,        /* sqldbal_fp_stmt_send_blob        */
+  sqldbal_mariadb_stmt_execute,          /* sqldbal_fp_stmt_execute          */
+  sqldbal_mariadb_stmt_execute_batch,    /* sqldbal_fp_stmt_execute_batch    */
+  sqldbal_mariadb_stmt_execute_start,    /* sqldbal_fp_stmt_execute_start    */
+  sqldbal_mariadb_stmt_execute_poll,     /* sqldbal_fp_stmt_execute_poll     */
+  sqldbal_mariadb_stmt_execute_finish,   /* sqldbal_fp_stmt_execute_finish   */
+  sqldbal_mariadb_stmt_fetch,            /* sqldbal_fp_stmt_fetch            */
+  sqldbal_mariadb_stmt_num_rows,         /* sqldbal_fp_stmt_num_rows         */
+  sqldbal_mariadb_stmt_seek,             /* sqldbal_fp_stmt_seek             */
+  sqldbal_mariadb_stmt_column_blob,      /* sqldbal_fp_stmt_column_blob      */
+  sqldbal_mariadb_stmt_column_blob_read, /* sqldbal_fp_stmt_column_blob_read */
+  sqldbal_mariadb_stmt_column_int64,     /* sqldbal_fp_stmt_column_int64     */
+  sqldbal_mariadb_stmt_column_text,      /* sqldbal_fp_stmt_column_text      */
+  sqldbal_mariadb_stmt_column_double,    /* sqldbal_fp_stmt_column_double    */
+  sqldbal_mariadb_stmt_column_timestamp, /* sqldbal_fp_stmt_column_timestamp */
+  sqldbal_mariadb_stmt_column_type,      /* sqldbal_fp_stmt_column_type      */
+  sqldbal_mariadb_stmt_reset,            /* sqldbal_fp_stmt_reset            */
+  sqldbal_mariadb_stmt_close             /* sqldbal_fp_stmt_close            */
+};
+#endif /* SQLDBAL_MARIADB */
+
+#ifdef SQLDBAL_POSTGRESQL
+/**
+ * Functions shared by every PostgreSQL connection.
+ */
+static const struct sqldbal_driver_functions
+g_sqldbal_pq_functions = {
+  sqldbal_pq_open,                  /* sqldbal_fp_open                  */
+  sqldbal_pq_connect_start,         /* sqldbal_fp_connect_start         */
+  sqldbal_pq_connect_poll,          /* sqldbal_fp_connect_poll          */
+  sqldbal_pq_close,                 /* sqldbal_fp_close                 */
+  sqldbal_pq_db_handle,             /* sqldbal_fp_db_handle             */
+  sqldbal_pq_stmt_handle,           /* sqldbal_fp_stmt_handle           */
+  sqldbal_pq_begin_transaction,     /* sqldbal_fp_begin_transaction     */
+  sqldbal_pq_commit,                /* sqldbal_fp_commit                */
+  sqldbal_pq_rollback,              /* sqldbal_fp_rollback              */
+  sqldbal_pq_pipeline_begin,        /* sqldbal_fp_pipeline_begin        */
+  sqldbal_pq_pipeline_end,          /* sqldbal_fp_pipeline_end          */
+  sqldbal_pq_bulk_begin,            /* sqldbal_fp_bulk_begin            */
+  sqldbal_pq_bulk_row,              /* sqldbal_fp_bulk_row              */
+  sqldbal_pq_bulk_end,              /* sqldbal_fp_bulk_end              */
+  sqldbal_pq_blob_open,             /* sqldbal_fp_blob_open             */
+  sqldbal_pq_blob_read,             /* sqldbal_fp_blob_read             */
+  sqldbal_pq_blob_write,            /* sqldbal_fp_blob_write            */
+  sqldbal_pq_blob_close,            /* sqldbal_fp_blob_close            */
+  sqldbal_pq_exec,                  /* sqldbal_fp_exec                  */
+  sqldbal_pq_last_insert_id,        /* sqldbal_fp_last_insert_id        */
+  sqldbal_pq_ping,                  /* sqldbal_fp_ping                  */
+  sqldbal_pq_socket_fd,             /* sqldbal_fp_socket_fd             */
+  sqldbal_pq_param_limit,           /* sqldbal_fp_param_limit           */
+  sqldbal_pq_stmt_prepare,          /* sqldbal_fp_stmt_prepare          */
+  sqldbal_pq_stmt_cursor,           /* sqldbal_fp_stmt_cursor           */
+  sqldbal_pq_stmt_bind_blob,        /* sqldbal_fp_stmt_bind_blob        */
+  sqldbal_pq_stmt_bind_int64,       /* sqldbal_fp_stmt_bind_int64       */
+  sqldbal_pq_stmt_bind_text,        /* sqldbal_fp_stmt_bind_text        */
+  sqldbal_pq_stmt_bind_blob_static, /* sqldbal_fp_stmt_bind_blob_static */
+  sqldbal_pq_stmt_bind_text_static, /* sqldbal_fp_stmt_bind_text_static */
+  sqldbal_pq_stmt_bind_double,      /* sqldbal_fp_stmt_bind_double      */
+  sqldbal_pq_stmt_bind_timestamp,   /* sqldbal_fp_stmt_bind_timestamp   */
+  sqldbal_pq_stmt_bind_null,        /* sqldbal_fp_stmt_bind_null        */
+  sqldbal_pq_stmt_bind_blob_stream, /* sqldbal_fp_stmt_bind_blob_stream */
+  sqldbal_pq_stmt_send_blob,        /* sqldbal_fp_stmt_send_blob        */
+  sqldbal_pq_stmt_execute,          /* sqldbal_fp_stmt_execute          */
+  sqldbal_pq_stmt_execute_batch,    /* sqldbal_fp_stmt_execute_batch    */
+  sqldbal_pq_stmt_execute_start,    /* sqldbal_fp_stmt_execute_start    */
+  sqldbal_pq_stmt_execute_poll,     /* sqldbal_fp_stmt_execute_poll     */
+  sqldbal_pq_stmt_execute_finish,   /* sqldbal_fp_stmt_execute_finish   */
+  sqldbal_pq_stmt_fetch,            /* sqldbal_fp_stmt_fetch            */
+  sqldbal_pq_stmt_num_rows,         /* sqldbal_fp_stmt_num_rows         */
+  sqldbal_pq_stmt_seek,             /* sqldbal_fp_stmt_seek             */
+  sqldbal_pq_stmt_column_blob,      /* sqldbal_fp_stmt_column_blob      */
+  sqldbal_pq_stmt_column_blob_read, /* sqldbal_fp_stmt_column_blob_read */
+  sqldbal_pq_stmt_column_int64,     /* sqldbal_fp_stmt_column_int64     */
+  sqldbal_pq_stmt_column_text,      /* sqldbal_fp_stmt_column_text      */
+  sqldbal_pq_stmt_column_double,    /* sqldbal_fp_stmt_column_double    */
+  sqldbal_pq_stmt_column_timestamp, /* sqldbal_fp_stmt_column_timestamp */
+  sqldbal_pq_stmt_column_type,      /* sqldbal_fp_stmt_column_type      */
+  sqldbal_pq_stmt_reset,            /* sqldbal_fp_stmt_reset            */
+  sqldbal_pq_stmt_close             /* sqldbal_fp_stmt_close            */
+};
+#endif /* SQLDBAL_POSTGRESQL */
+
+#ifdef SQLDBAL_SQLITE
+/**
+ * Functions shared by every SQLite connection.
+ */
+static const struct sqldbal_driver_functions
+g_sqldbal_sqlite_functions = {
+  sqldbal_sqlite_open,                  /* sqldbal_fp_open                  */
+  sqldbal_sqlite_connect_start,         /* sqldbal_fp_connect_start         */
+  sqldbal_sqlite_connect_poll,          /* sqldbal_fp_connect_poll          */
+  sqldbal_sqlite_close,                 /* sqldbal_fp_close                 */
+  sqldbal_sqlite_db_handle,             /* sqldbal_fp_db_handle             */
+  sqldbal_sqlite_stmt_handle,           /* sqldbal_fp_stmt_handle           */
+  sqldbal_sqlite_begin_transaction,     /* sqldbal_fp_begin_transaction     */
+  sqldbal_sqlite_commit,                /* sqldbal_fp_commit                */
+  sqldbal_sqlite_rollback,              /* sqldbal_fp_rollback              */
+  sqldbal_sqlite_pipeline_begin,        /* sqldbal_fp_pipeline_begin        */
+  sqldbal_sqlite_pipeline_end,          /* sqldbal_fp_pipeline_end          */
+  sqldbal_sqlite_bulk_begin,            /* sqldbal_fp_bulk_begin            */
+  sqldbal_sqlite_bulk_row,              /* sqldbal_fp_bulk_row              */
+  sqldbal_sqlite_bulk_end,              /* sqldbal_fp_bulk_end              */
+  sqldbal_sqlite_blob_open,             /* sqldbal_fp_blob_open             */
+  sqldbal_sqlite_blob_read,             /* sqldbal_fp_blob_read             */
+  sqldbal_sqlite_blob_write,            /* sqldbal_fp_blob_write            */
+  sqldbal_sqlite_blob_close,            /* sqldbal_fp_blob_close            */
+  sqldbal_sqlite_exec,                  /* sqldbal_fp_exec                  */
+  sqldbal_sqlite_last_insert_id,        /* sqldbal_fp_last_insert_id        */
+  sqldbal_sqlite_ping,                  /* sqldbal_fp_ping                  */
+  sqldbal_sqlite_socket_fd,             /* sqldbal_fp_socket_fd             */
+  sqldbal_sqlite_param_limit,           /* sqldbal_fp_param_limit           */
+  sqldbal_sqlite_stmt_prepare,          /* sqldbal_fp_stmt_prepare          */
+  sqldbal_sqlite_stmt_cursor,           /* sqldbal_fp_stmt_cursor           */
+  sqldbal_sqlite_stmt_bind_blob,        /* sqldbal_fp_stmt_bind_blob        */
+  sqldbal_sqlite_stmt_bind_int64,       /* sqldbal_fp_stmt_bind_int64       */
+  sqldbal_sqlite_stmt_bind_text,        /* sqldbal_fp_stmt_bind_text        */
+  sqldbal_sqlite_stmt_bind_blob_static, /* sqldbal_fp_stmt_bind_blob_static */
+  sqldbal_sqlite_stmt_bind_text_static, /* sqldbal_fp_stmt_bind_text_static */
+  sqldbal_sqlite_stmt_bind_double,      /* sqldbal_fp_stmt_bind_double      */
+  sqldbal_sqlite_stmt_bind_timestamp,   /* sqldbal_fp_stmt_bind_timestamp   */
+  sqldbal_sqlite_stmt_bind_null,        /* sqldbal_fp_stmt_bind_null        */
+  sqldbal_sqlite_stmt_bind_blob_stream, /* sqldbal_fp_stmt_bind_blob_stream */
+  sqldbal_sqlite_stmt_send_blob,        /* sqldbal_fp_stmt_send_blob        */
+  sqldbal_sqlite_stmt_execute,          /* sqldbal_fp_stmt_execute          */
+  sqldbal_sqlite_stmt_execute_batch,    /* sqldbal_fp_stmt_execute_batch    */
+  sqldbal_sqlite_stmt_execute_start,    /* sqldbal_fp_stmt_execute_start    */
+  sqldbal_sqlite_stmt_execute_poll,     /* sqldbal_fp_stmt_execute_poll     */
+  sqldbal_sqlite_stmt_execute_finish,   /* sqldbal_fp_stmt_execute_finish   */
+  sqldbal_sqlite_stmt_fetch,            /* sqldbal_fp_stmt_fetch            */
+  sqldbal_sqlite_stmt_num_rows,         /* sqldbal_fp_stmt_num_rows         */
+  sqldbal_sqlite_stmt_seek,             /* sqldbal_fp_stmt_seek             */
+  sqldbal_sqlite_stmt_column_blob,      /* sqldbal_fp_stmt_column_blob      */
+  sqldbal_sqlite_stmt_column_blob_read, /* sqldbal_fp_stmt_column_blob_read */
+  sqldbal_sqlite_stmt_column_int64,     /* sqldbal_fp_stmt_column_int64     */
+  sqldbal_sqlite_stmt_column_text,      /* sqldbal_fp_stmt_column_text      */
+  sqldbal_sqlite_stmt_column_double,    /* sqldbal_fp_stmt_column_double    */
+  sqldbal_sqlite_stmt_column_timestamp, /* sqldbal_fp_stmt_column_timestamp */
+  sqldbal_sqlite_stmt_column_type,      /* sqldbal_fp_stmt_column_type      */
+  sqldbal_sqlite_stmt_reset,            /* sqldbal_fp_stmt_reset            */
+  sqldbal_sqlite_stmt_close             /* sqldbal_fp_stmt_close            */
+};
+#endif /* SQLDBAL_SQLITE */
+
+/**
+ * Get the number of bytes needed to copy a string, including the
+ * null-terminator.
+ *
+ * @param[in]     s    String to copy, or NULL.
+ * @param[in,out] size Add the number of bytes to this value.
+ * @retval 0 Success.
+ * @retval 1 Size wrapped.
+ */
+static int
+sqldbal_params_str_size(const char *const s,
+                        size_t *const size){
+  int wraps;
+
+  wraps = 0;
+  if(s){
+    wraps = si_add_size_t(*size, strlen(s), size) ||
+            si_add_size_t(*size, 1, size);
+  }
+  return wraps;
+}
+
+/**
+ * Copy a string into the parameter string buffer.
+ *
+ * @param[in,out] buf Copy @p s to this location and then advance the
+ *                    pointer past the copied string.
+ * @param[in]     s   String to copy, or NULL.
+ * @retval const char* Pointer to the copied string.
+ * @retval NULL        @p s was NULL.
+ */
+static const char *
+sqldbal_params_str_copy(char **const buf,
+                        const char *const s){
+  const char *copy;
+  size_t len;
+
+  if(s == NULL){
+    copy = NULL;
+  }
+  else{
+    len = strlen(s) + 1;
+    memcpy(*buf, s, len);
+    copy = *buf;
+    *buf += len;
+  }
+  return copy;
+}
+
+/**
+ * Copy the connection parameters passed to @ref sqldbal_open.
+ *
+ * @param[out] params      See @ref sqldbal_params.
+ * @param[in]  location    See @ref sqldbal_open.
+ * @param[in]  port        See @ref sqldbal_open.
+ * @param[in]  username    See @ref sqldbal_open.
+ * @param[in]  password    See @ref sqldbal_open.
+ * @param[in]  database    See @ref sqldbal_open.
+ * @param[in]  option_list See @ref sqldbal_open.
+ * @param[in]  num_options See @ref sqldbal_open.
+ * @retval  0 Success.
+ * @retval -1 Memory allocation failed.
+ */
+static int
+sqldbal_params_copy(struct sqldbal_params *const params,
+                    const char *const location,
+                    const char *const port,
+                    const char *const username,
+                    const char *const password,
+                    const char *const database,
+                    const struct sqldbal_driver_option *const option_list,
+                    size_t num_options){
+  size_t i;
+  size_t buf_size;
+  char *buf;
+  int rc;
+
+  rc = 0;
+  params->str_buf = NULL;
+  params->option_list = NULL;
+  buf_size = 0;
+  if(sqldbal_params_str_size(location, &buf_size) ||
+     sqldbal_params_str_size(port, &buf_size) ||
+     sqldbal_params_str_size(username, &buf_size) ||
+     sqldbal_params_str_size(password, &buf_size) ||
+     sqldbal_params_str_size(database, &buf_size)){
+    rc = -1;
+  }
+  for(i = 0; rc == 0 && i < num_options; i++){
+    if(sqldbal_params_str_size(option_list[i].key, &buf_size) ||
+       sqldbal_params_str_size(option_list[i].value, &buf_size)){
+      rc = -1;
+    }
+  }
+  if(rc == 0){
+    /* Allocate at least one byte so that NULL always means failure. */
+    params->str_buf = malloc(buf_size + 1);
+    params->option_list = sqldbal_reallocarray(NULL,
+                                               num_options + 1,
+                                               sizeof(*params->option_list));
+    if(params->str_buf == NULL || params->option_list == NULL){
+      free(params->str_buf);
+      free(params->option_list);
+      params->str_buf = NULL;
+      params->option_list = NULL;
+      rc = -1;
+    }
+    else{
+      buf = params->str_buf;
+      params->location = sqldbal_params_str_copy(&buf, location);
+      params->port     = sqldbal_params_str_copy(&buf, port);
+      params->username = sqldbal_params_str_copy(&buf, username);
+      params->password = sqldbal_params_str_copy(&buf, password);
+      params->database = sqldbal_params_str_copy(&buf, database);
+      for(i = 0; i < num_options; i++){
+        params->option_list[i].key =
+          sqldbal_params_str_copy(&buf, option_list[i].key);
+        params->option_list[i].value =
+          sqldbal_params_str_copy(&buf, option_list[i].value);
+      }
+      params->num_options = num_options;
+    }
+  }
+  return rc;
+}
+
+/**
+ * Free the strings copied by @ref sqldbal_params_copy.
+ *
+ * @param[in] params See @ref sqldbal_params.
+ */
+static void
+sqldbal_params_free(struct sqldbal_params *const params){
+  free(params->option_list);
+  free(params->str_buf);
+}
+
+/**
+ * This error structure used for the single error case where we cannot
+ * initially allocate memory.
+ *
+ * This makes it easier to propagate any error codes when calling
+ * other external header functions because the caller will always
+ * get a valid SQLDBAL structure returned. Each thread has its own copy
+ * so that failures in different threads do not overwrite each other.
+ */
+static SQLDBAL_THREAD_LOCAL struct sqldbal_db g_db_error = {
+  NULL,                        /* errstr                        */
+  0,                           /* errstr_size                   */
+  NULL,                        /* handle                        */
+  &g_sqldbal_no_functions,     /* functions                     */
+  {                            /* stmt_cache                    */
+    NULL,                      /* bucket_list                   */
+    0,                         /* num_buckets                   */
+    NULL,                      /* lru_head                      */
+    NULL,                      /* lru_tail                      */
+    0,                         /* num_stmts                     */
+    0,                         /* capacity                      */
+    0,                         /* num_hits                      */
+    0                          /* num_misses                    */
+  },                           /* stmt_cache                    */
+  {                            /* busy                          */
+    0,                         /* num_retries                   */
+    0,                         /* wait_ms                       */
+    0,                         /* start_ms                      */
+    0,                         /* rand_state                    */
+    0,                         /* timeout_ms                    */
+    0,                         /* backoff_min_ms                */
+    0,                         /* backoff_max_ms                */
+    0                          /* retry_step                    */
+  },                           /* busy                          */
+  {                            /* result_cache                  */
+    NULL,                      /* bucket_list                   */
+    0,                         /* num_buckets                   */
+    NULL,                      /* lru_head                      */
+    NULL,                      /* lru_tail                      */
+    0,                         /* num_bytes                     */
+    0,                         /* max_bytes                     */
+    0,                         /* ttl_ns                        */
+    0,                         /* num_hits                      */
+    0                          /* num_misses                    */
+  },                           /* result_cache                  */
+  NULL,                        /* metrics_fp                    */
+  NULL,                        /* metrics_user_data             */
+  NULL,                        /* replica_list                  */
+  0,                           /* num_replicas                  */
+  0,                           /* replica_next                  */
+  NULL,                        /* replica                       */
+  NULL,                        /* trace                         */
+  NULL,                        /* lazy                          */
+  NULL,                        /* pool                          */
+  SQLDBAL_STATUS_NOMEM,        /* status_code                   */
+  SQLDBAL_DRIVER_INVALID,      /* type                          */
+  0,                           /* pipeline                      */
+  0,                           /* transaction                   */
+  0,                           /* trace_driver                  */
+  {0},                         /* pad                           */
+  SQLDBAL_FLAG_INVALID_MEMORY  /* flags                         */
+};
+
+/**
+ * Allocate a new database connection and select the driver functions,
+ * without connecting.
+ *
+ * @param[in]  driver See @ref sqldbal_driver.
+ * @param[in]  flags  See @ref sqldbal_flag.
+ * @param[out] db     See @ref sqldbal_db.
+ * @return            See @ref sqldbal_status_code.
+ */
+static enum sqldbal_status_code
+sqldbal_db_new(enum sqldbal_driver driver,
+               const unsigned long flags,
+               struct sqldbal_db **db){
+  struct sqldbal_db *new_db;
+  int found_driver;
+
+  new_db = malloc(sizeof(*new_db));
+  if(new_db == NULL){
+    *db = &g_db_error;
+    sqldbal_status_code_set(*db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    *db = new_db;
+
+    sqldbal_status_code_set(new_db, SQLDBAL_STATUS_OK);
+    new_db->errstr = NULL;
+    new_db->errstr_size = 0;
+    new_db->flags = flags;
+    new_db->type = driver;
+    new_db->handle = NULL;
+    new_db->pipeline = 0;
+    memset(&new_db->stmt_cache, 0, sizeof(new_db->stmt_cache));
+    memset(&new_db->busy, 0, sizeof(new_db->busy));
+    memset(&new_db->result_cache, 0, sizeof(new_db->result_cache));
+    new_db->metrics_fp = NULL;
+    new_db->metrics_user_data = NULL;
+    new_db->replica_list = NULL;
+    new_db->num_replicas = 0;
+    new_db->replica_next = 0;
+    new_db->replica = NULL;
+    new_db->trace = NULL;
+    new_db->lazy = NULL;
+    new_db->pool = NULL;
+    new_db->transaction = 0;
+    new_db->trace_driver = 0;
+
+    new_db->functions = &g_sqldbal_no_functions;
+    found_driver = 0;
+#ifdef SQLDBAL_MARIADB
+    if(driver == SQLDBAL_DRIVER_MARIADB ||
+       driver == SQLDBAL_DRIVER_MYSQL){
+      found_driver = 1;
+      new_db->functions = &g_sqldbal_mariadb_functions;
+    }
+#endif /* SQLDBAL_MARIADB */
+#ifdef SQLDBAL_POSTGRESQL
+    if(driver == SQLDBAL_DRIVER_POSTGRESQL){
+      found_driver = 1;
+      new_db->functions = &g_sqldbal_pq_functions;
+    }
+#endif /* SQLDBAL_POSTGRESQL */
+#ifdef SQLDBAL_SQLITE
+    if(driver == SQLDBAL_DRIVER_SQLITE){
+      found_driver = 1;
+      new_db->functions = &g_sqldbal_sqlite_functions;
+    }
+#endif /* SQLDBAL_SQLITE */
+#ifdef SQLDBAL_SINGLE_DRIVER
+    if(new_db->functions != &SQLDBAL_SINGLE_FUNCTIONS){
+      found_driver = 0;
+    }
+#endif /* SQLDBAL_SINGLE_DRIVER */
+
+    if(!found_driver){
+      sqldbal_status_code_set(new_db, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+    }
+  }
+  return sqldbal_status_code_get(*db);
+}
+
+enum sqldbal_status_code
+sqldbal_open(enum sqldbal_driver driver,
+             const char *const location,
+             const char *const port,
+             const char *const username,
+             const char *const password,
+             const char *const database,
+             const unsigned long flags,
+             const struct sqldbal_driver_option *const option_list,
+             size_t num_options,
+             struct sqldbal_db **db){
+  struct sqldbal_params *params;
+
+  if(sqldbal_db_new(driver, flags, db) == SQLDBAL_STATUS_OK){
+    if(flags & SQLDBAL_FLAG_LAZY_CONNECT){
+      params = malloc(sizeof(*params));
+      if(params == NULL ||
+         sqldbal_params_copy(params,
+                             location,
+                             port,
+                             username,
+                             password,
+                             database,
+                             option_list,
+                             num_options)){
+        free(params);
+        sqldbal_status_code_set(*db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        (*db)->lazy = params;
+      }
+    }
+    else{
+      SQLDBAL_FUNCTIONS(*db)->sqldbal_fp_open(*db,
+                                              location,
+                                              port,
+                                              username,
+                                              password,
+                                              database,
+                                              option_list,
+                                              num_options);
+    }
+  }
+  return sqldbal_status_code_get(*db);
+}
+
+/**
+ * Connect using the parameters saved by @ref SQLDBAL_FLAG_LAZY_CONNECT
+ * before the connection gets used.
+ *
+ * A status code set before connecting stays in place. If connecting
+ * fails, the driver handle gets closed and the next use tries again.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @retval  0 The driver handle can get used.
+ * @retval -1 Failed to connect.
+ */
+static int
+sqldbal_lazy_connect(struct sqldbal_db *const db){
+  struct sqldbal_params *params;
+  enum sqldbal_status_code status;
+  int rc;
+
+  rc = 0;
+  params = db->lazy;
+  if(params){
+    status = sqldbal_status_code_get(db);
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_OK);
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_open(db,
+                                           params->location,
+                                           params->port,
+                                           params->username,
+                                           params->password,
+                                           params->database,
+                                           params->option_list,
+                                           params->num_options);
+    if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+      sqldbal_status_code_set(db, status);
+      db->lazy = NULL;
+      sqldbal_params_free(params);
+      free(params);
+#if defined(SQLDBAL_TRACE) && defined(SQLDBAL_SQLITE)
+      if(db->trace && db->type == SQLDBAL_DRIVER_SQLITE){
+        sqldbal_sqlite_trace_set(db);
+      }
+#endif /* SQLDBAL_TRACE && SQLDBAL_SQLITE */
+    }
+    else{
+      status = sqldbal_status_code_get(db);
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_close(db);
+      db->handle = NULL;
+      sqldbal_status_code_set(db, status);
+      rc = -1;
+    }
+  }
+  return rc;
+}
+
+enum sqldbal_status_code
+sqldbal_connect(struct sqldbal_db *const db){
+  sqldbal_lazy_connect(db);
+  return sqldbal_status_code_get(db);
+}
+
+/**
+ * Get the time when @ref sqldbal_open_parallel stops waiting for the
+ * connections, from the number of seconds in the CONNECT_TIMEOUT option.
+ *
+ * Invalid values get ignored here because the drivers report them.
+ *
+ * @param[in] option_list See @ref sqldbal_open.
+ * @param[in] num_options See @ref sqldbal_open.
+ * @return                Deadline (see @ref sqldbal_time_ns), or 0 to
+ *                        wait without a time limit.
+ */
+static uint64_t
+sqldbal_open_parallel_deadline(
+  const struct sqldbal_driver_option *const option_list,
+  size_t num_options){
+  const struct sqldbal_driver_option *option;
+  unsigned long seconds;
+  uint64_t deadline_ns;
+  char *ep;
+  size_t i;
+
+  deadline_ns = 0;
+  for(i = 0; i < num_options; i++){
+    option = &option_list[i];
+    if(strcmp(option->key, "CONNECT_TIMEOUT") == 0 && option->value){
+      seconds = strtoul(option->value, &ep, 10);
+      if(option->value[0] != '\0' &&
+         *ep == '\0' &&
+         seconds > 0 &&
+         seconds <= UINT32_MAX){
+        deadline_ns = sqldbal_time_ns() + (uint64_t)seconds * 1000000000;
+      }
+    }
+  }
+  return deadline_ns;
+}
+
+/**
+ * Wait until at least one of the connections started by
+ * @ref sqldbal_open_parallel can make progress, and then continue
+ * connecting the ones that can.
+ *
+ * @param[in]     db_list    Connections getting opened.
+ * @param[in,out] wait_list  Events that each connection waits for, or 0
+ *                           after the connection has finished.
+ * @param[in]     pfd_list   Buffer with one entry for each connection.
+ * @param[in]     num_dbs    Number of entries in @p db_list.
+ * @param[in]     timeout_ms Maximum number of milliseconds to wait, or -1
+ *                           to wait without a time limit.
+ * @return Number of connections that still have to wait.
+ */
+static size_t
+sqldbal_open_parallel_poll(struct sqldbal_db **const db_list,
+                           int *const wait_list,
+                           struct pollfd *const pfd_list,
+                           size_t num_dbs,
+                           int timeout_ms){
+  struct sqldbal_db *db;
+  size_t i;
+  size_t num_pfds;
+  size_t num_waiting;
+  int events;
+  int fd;
+  int rc;
+
+  num_pfds = 0;
+  for(i = 0; i < num_dbs; i++){
+    db = db_list[i];
+    if(wait_list[i]){
+      fd = -1;
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_socket_fd(db, &fd);
+      if(fd < 0){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_OPEN);
+        wait_list[i] = 0;
+      }
+      else{
+        events = 0;
+        if(wait_list[i] & SQLDBAL_WAIT_READ){
+          events |= POLLIN;
+        }
+        if(wait_list[i] & SQLDBAL_WAIT_WRITE){
+          events |= POLLOUT;
+        }
+#ifdef SQLDBAL_IS_WINDOWS
+        pfd_list[num_pfds].fd = (SOCKET)fd;
+#else /* POSIX */
+        pfd_list[num_pfds].fd = fd;
+#endif /* SQLDBAL_IS_WINDOWS */
+        pfd_list[num_pfds].events = (short)events;
+        pfd_list[num_pfds].revents = 0;
+        num_pfds += 1;
+      }
+    }
+  }
+
+  rc = 0;
+  if(num_pfds){
+#ifdef SQLDBAL_IS_WINDOWS
+    rc = WSAPoll(pfd_list, (ULONG)num_pfds, timeout_ms);
+#else /* POSIX */
+    rc = poll(pfd_list, (nfds_t)num_pfds, timeout_ms);
+#endif /* SQLDBAL_IS_WINDOWS */
+    if(rc < 0 && errno == EINTR){
+      rc = 0;
+    }
+  }
+
+  num_pfds = 0;
+  num_waiting = 0;
+  for(i = 0; i < num_dbs; i++){
+    db = db_list[i];
+    if(wait_list[i]){
+      events = pfd_list[num_pfds].revents;
+      num_pfds += 1;
+      if(rc < 0){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_OPEN);
+        wait_list[i] = 0;
+      }
+      else if(events){
+        wait_list[i] = 0;
+        if(events & POLLOUT){
+          wait_list[i] |= SQLDBAL_WAIT_WRITE;
+        }
+        /* Let the driver read the error on a hang up. */
+        if(events & ~POLLOUT){
+          wait_list[i] |= SQLDBAL_WAIT_READ;
+        }
+        SQLDBAL_FUNCTIONS(db)->sqldbal_fp_connect_poll(db, &wait_list[i]);
+        if(sqldbal_status_code_get(db) != SQLDBAL_STATUS_OK){
+          wait_list[i] = 0;
+        }
+      }
+      if(wait_list[i]){
+        num_waiting += 1;
+      }
+    }
+  }
+  return num_waiting;
+}
+
+enum sqldbal_status_code
+sqldbal_open_parallel(enum sqldbal_driver driver,
+                      const char *const location,
+                      const char *const port,
+                      const char *const username,
+                      const char *const password,
+                      const char *const database,
+                      const unsigned long flags,
+                      const struct sqldbal_driver_option *const option_list,
+                      size_t num_options,
+                      size_t num_dbs,
+                      struct sqldbal_db **db_list){
+  struct sqldbal_db *db;
+  struct pollfd *pfd_list;
+  int *wait_list;
+  enum sqldbal_status_code status;
+  uint64_t deadline_ns;
+  uint64_t now_ns;
+  size_t num_waiting;
+  size_t i;
+  int timeout_ms;
+
+  if(flags & SQLDBAL_FLAG_LAZY_CONNECT){
+    for(i = 0; i < num_dbs; i++){
+      sqldbal_open(driver,
+                   location,
+                   port,
+                   username,
+                   password,
+                   database,
+                   flags,
+                   option_list,
+                   num_options,
+                   &db_list[i]);
+    }
+  }
+  else{
+    for(i = 0; i < num_dbs; i++){
+      sqldbal_db_new(driver, flags, &db_list[i]);
+    }
+    wait_list = sqldbal_reallocarray(NULL, num_dbs + 1, sizeof(*wait_list));
+    pfd_list = sqldbal_reallocarray(NULL, num_dbs + 1, sizeof(*pfd_list));
+    deadline_ns = sqldbal_open_parallel_deadline(option_list, num_options);
+    num_waiting = 0;
+    for(i = 0; i < num_dbs; i++){
+      db = db_list[i];
+      if(wait_list == NULL || pfd_list == NULL){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        wait_list[i] = 0;
+        if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+          SQLDBAL_FUNCTIONS(db)->sqldbal_fp_connect_start(db,
+                                                          location,
+                                                          port,
+                                                          username,
+                                                          password,
+                                                          database,
+                                                          option_list,
+                                                          num_options,
+                                                          &wait_list[i]);
+          if(sqldbal_status_code_get(db) != SQLDBAL_STATUS_OK){
+            wait_list[i] = 0;
+          }
+          if(wait_list[i]){
+            num_waiting += 1;
+          }
+        }
+      }
+    }
+    while(num_waiting){
+      timeout_ms = -1;
+      if(deadline_ns){
+        now_ns = sqldbal_time_ns();
+        timeout_ms = 0;
+        if(now_ns < deadline_ns){
+          /* Round up so that the wait does not end just short of it. */
+          if((deadline_ns - now_ns) / 1000000 >= INT_MAX){
+            timeout_ms = INT_MAX;
+          }
+          else{
+            timeout_ms = (int)((deadline_ns - now_ns) / 1000000) + 1;
+          }
+        }
+      }
+      if(timeout_ms == 0){
+        for(i = 0; i < num_dbs; i++){
+          if(wait_list[i]){
+            sqldbal_status_code_set(db_list[i], SQLDBAL_STATUS_OPEN);
+            wait_list[i] = 0;
+          }
+        }
+        num_waiting = 0;
+      }
+      else{
+        num_waiting = sqldbal_open_parallel_poll(db_list,
+                                                 wait_list,
+                                                 pfd_list,
+                                                 num_dbs,
+                                                 timeout_ms);
+      }
+    }
+    free(wait_list);
+    free(pfd_list);
+  }
+
+  status = SQLDBAL_STATUS_OK;
+  for(i = 0; i < num_dbs && status == SQLDBAL_STATUS_OK; i++){
+    status = sqldbal_status_code_get(db_list[i]);
+  }
+  return status;
+}
+
+enum sqldbal_status_code
+sqldbal_close(struct sqldbal_db *db){
+  enum sqldbal_status_code status;
+  size_t i;
+
+  status = sqldbal_status_code_get(db);
+  if((db->flags & SQLDBAL_FLAG_INVALID_MEMORY) == 0){
+    for(i = 0; i < db->num_replicas; i++){
+      sqldbal_close(db->replica_list[i]);
+    }
+    free(db->replica_list);
+    db->replica_list = NULL;
+    db->num_replicas = 0;
+    if(db->lazy){
+      /* Never connected, so the driver has nothing to close. */
+      sqldbal_params_free(db->lazy);
+      free(db->lazy);
+      db->lazy = NULL;
+    }
+    else if(db->functions != &g_sqldbal_no_functions){
+      if(status == SQLDBAL_STATUS_DRIVER_NOSUPPORT){
+        /* An unsupported operation leaves the connection usable. */
+        sqldbal_status_code_clear(db);
+        status = SQLDBAL_STATUS_OK;
+      }
+      sqldbal_stmt_cache_flush(db);
+      sqldbal_result_cache_flush(db);
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_close(db);
+      if(status == SQLDBAL_STATUS_OK){
+        status = sqldbal_status_code_get(db);
+      }
+    }
+    if(status != SQLDBAL_STATUS_CLOSE){
+      free(db->stmt_cache.bucket_list);
+      free(db->result_cache.bucket_list);
+      free(db->replica);
+      free(db->errstr);
+      free(db);
+    }
+  }
+  return status;
+}
+
+void *
+sqldbal_db_handle(const struct sqldbal_db *const db){
+  void *handle;
+
+  handle = NULL;
+  if(db->lazy == NULL){
+    handle = SQLDBAL_FUNCTIONS(db)->sqldbal_fp_db_handle(db);
+  }
+  return handle;
+}
+
+void *
+sqldbal_stmt_handle(const struct sqldbal_stmt *const stmt){
+  return SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_handle(stmt);
+}
+
+enum sqldbal_status_code
+sqldbal_begin_transaction(struct sqldbal_db *const db){
+  if(sqldbal_lazy_connect(db) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_begin_transaction(db);
+    if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+      db->transaction = 1;
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_commit(struct sqldbal_db *const db){
+  if(sqldbal_lazy_connect(db) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_commit(db);
+  }
+  db->transaction = 0;
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_rollback(struct sqldbal_db *const db){
+  if(sqldbal_lazy_connect(db) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_rollback(db);
+  }
+  db->transaction = 0;
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_pipeline_begin(struct sqldbal_db *const db){
+  if(db->pipeline){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  }
+  else if(sqldbal_lazy_connect(db) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_pipeline_begin(db);
+    if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+      db->pipeline = 1;
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+/**
+ * Returned by @ref sqldbal_bulk_begin if the library could not allocate
+ * memory for the @ref sqldbal_bulk.
+ *
+ * Each thread has its own copy, which refers to the @ref g_db_error of the
+ * same thread.
+ */
+static SQLDBAL_THREAD_LOCAL struct sqldbal_bulk
+g_bulk_error = {
+  NULL,                             /* db                */
+  NULL,                             /* handle            */
+  NULL,                             /* insert            */
+  NULL,                             /* buf               */
+  0   ,                             /* buf_len           */
+  0   ,                             /* buf_size          */
+  0                                 /* num_cols          */
+};
+
+/**
+ * Default number of rows inserted by each statement of
+ * @ref sqldbal_bulk_begin_insert.
+ */
+#define SQLDBAL_BULK_INSERT_ROWS 128
+
+/**
+ * Multi-row INSERT state of a bulk load started by
+ * @ref sqldbal_bulk_begin_insert.
+ */
+struct sqldbal_bulk_insert{
+  /**
+   * Statement with placeholders for @ref rows_per_insert rows.
+   */
+  struct sqldbal_stmt *stmt;
+
+  /**
+   * SQL text before the first row of placeholders.
+   */
+  char *head;
+
+  /**
+   * SQL text after the last row of placeholders, which has the upsert
+   * clause.
+   */
+  char *tail;
+
+  /**
+   * Number of rows inserted by @ref stmt.
+   */
+  size_t rows_per_insert;
+
+  /**
+   * Number of rows encoded in @ref sqldbal_bulk::buf.
+   */
+  size_t num_rows;
+
+  /**
+   * Set to 1 for each column that belongs to the upsert key, or NULL if
+   * the rows do not get checked for repeated keys.
+   */
+  unsigned char *is_key_list;
+
+  /**
+   * Offset in @ref sqldbal_bulk::buf where each encoded row starts.
+   */
+  size_t *row_offset_list;
+
+  /**
+   * Open addressing hash table of the encoded rows by their key values.
+   * Each slot holds the row index plus 1, or 0 if empty.
+   */
+  size_t *slot_list;
+
+  /**
+   * Number of entries in @ref slot_list, which is a power of 2.
+   */
+  size_t num_slots;
+};
+
+/**
+ * Allocate a bulk load handle.
+ *
+ * @param[in]  db       See @ref sqldbal_db.
+ * @param[in]  num_cols See @ref sqldbal_bulk_begin.
+ * @param[out] bulk     New bulk load handle, or @ref g_bulk_error if the
+ *                      memory allocation failed.
+ * @retval  0 Allocated the handle.
+ * @retval -1 Failed to allocate the handle or invalid parameters.
+ */
+static int
+sqldbal_bulk_new(struct sqldbal_db *const db,
+                 size_t num_cols,
+                 struct sqldbal_bulk **bulk){
+  struct sqldbal_bulk *new_bulk;
+  int rc;
+
+  rc = -1;
+  new_bulk = malloc(sizeof(*new_bulk));
+  if(new_bulk == NULL){
+    g_bulk_error.db = &g_db_error;
+    *bulk = &g_bulk_error;
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    *bulk = new_bulk;
+    new_bulk->db       = db;
+    new_bulk->handle   = NULL;
+    new_bulk->insert   = NULL;
+    new_bulk->buf      = NULL;
+    new_bulk->buf_len  = 0;
+    new_bulk->buf_size = 0;
+    new_bulk->num_cols = num_cols;
+    if(num_cols == 0 || db->pipeline){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+    }
+    else if(sqldbal_lazy_connect(db) == 0){
+      rc = 0;
+    }
+  }
+  return rc;
+}
+
+enum sqldbal_status_code
+sqldbal_bulk_begin(struct sqldbal_db *const db,
+                   const char *const table,
+                   const char *const *const column_list,
+                   size_t num_cols,
+                   struct sqldbal_bulk **bulk){
+  if(sqldbal_bulk_new(db, num_cols, bulk) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_bulk_begin(*bulk, table, column_list);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+/**
+ * Check if the database connection uses the MariaDB driver.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @retval 1 MariaDB or MySQL driver.
+ * @retval 0 Other driver.
+ */
+static int
+sqldbal_is_mariadb(const struct sqldbal_db *const db){
+  int is_mariadb;
+
+  (void)db;
+  is_mariadb = 0;
+#ifdef SQLDBAL_MARIADB
+  if(db->type == SQLDBAL_DRIVER_MARIADB ||
+     db->type == SQLDBAL_DRIVER_MYSQL){
+    is_mariadb = 1;
+  }
+#endif /* SQLDBAL_MARIADB */
+  return is_mariadb;
+}
+
+/**
+ * Check if the database connection uses the PostgreSQL driver.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @retval 1 PostgreSQL driver.
+ * @retval 0 Other driver.
+ */
+static int
+sqldbal_is_pq(const struct sqldbal_db *const db){
+  int is_pq;
+
+  (void)db;
+  is_pq = 0;
+#ifdef SQLDBAL_POSTGRESQL
+  if(db->type == SQLDBAL_DRIVER_POSTGRESQL){
+    is_pq = 1;
+  }
+#endif /* SQLDBAL_POSTGRESQL */
+  return is_pq;
+}
+
+/**
+ * Check if a column name appears in a list of names.
+ *
+ * @param[in] name      Column name.
+ * @param[in] name_list List of column names.
+ * @param[in] num_names Number of entries in @p name_list.
+ * @retval 1 Found @p name in @p name_list.
+ * @retval 0 @p name not in @p name_list.
+ */
+static int
+sqldbal_bulk_insert_is_key(const char *const name,
+                           const char *const *const name_list,
+                           size_t num_names){
+  size_t i;
+  int found;
+
+  found = 0;
+  for(i = 0; i < num_names && found == 0; i++){
+    if(strcmp(name, name_list[i]) == 0){
+      found = 1;
+    }
+  }
+  return found;
+}
+
+/**
+ * Append the upsert clause that updates every column not in @p key_list
+ * when a row conflicts with an existing row.
+ *
+ * @param[in] sql         SQL text buffer. See @ref sqldbal_bulk.
+ * @param[in] column_list See @ref sqldbal_bulk_begin_insert.
+ * @param[in] key_list    See @ref sqldbal_bulk_begin_insert.
+ * @param[in] num_keys    See @ref sqldbal_bulk_begin_insert.
+ */
+static void
+sqldbal_bulk_insert_append_upsert(struct sqldbal_bulk *const sql,
+                                  const char *const *const column_list,
+                                  const char *const *const key_list,
+                                  size_t num_keys){
+  const char *separator;
+  size_t i;
+  int mariadb;
+
+  mariadb = sqldbal_is_mariadb(sql->db);
+  if(mariadb){
+    sqldbal_bulk_append_str(sql, " ON DUPLICATE KEY UPDATE ");
+  }
+  else{
+    sqldbal_bulk_append_str(sql, " ON CONFLICT (");
+    for(i = 0; i < num_keys; i++){
+      if(i){
+        sqldbal_bulk_append_str(sql, ", ");
+      }
+      sqldbal_bulk_append_str(sql, key_list[i]);
+    }
+    sqldbal_bulk_append_str(sql, ") DO UPDATE SET ");
+  }
+
+  separator = "";
+  for(i = 0; i < sql->num_cols; i++){
+    if(!sqldbal_bulk_insert_is_key(column_list[i], key_list, num_keys)){
+      sqldbal_bulk_append_str(sql, separator);
+      sqldbal_bulk_append_str(sql, column_list[i]);
+      sqldbal_bulk_append_str(sql, mariadb ? " = VALUES(" : " = excluded.");
+      sqldbal_bulk_append_str(sql, column_list[i]);
+      sqldbal_bulk_append_str(sql, mariadb ? ")" : "");
+      separator = ", ";
+    }
+  }
+
+  /* Every column belongs to the key, so only skip the conflicting rows. */
+  if(separator[0] == '\0'){
+    if(mariadb){
+      sqldbal_bulk_append_str(sql, key_list[0]);
+      sqldbal_bulk_append_str(sql, " = ");
+      sqldbal_bulk_append_str(sql, key_list[0]);
+    }
+    else{
+      sql->buf_len -= strlen(" DO UPDATE SET ");
+      sqldbal_bulk_append_str(sql, " DO NOTHING");
+    }
+  }
+}
+
+/**
+ * Compile the INSERT statement for a number of rows.
+ *
+ * PostgreSQL uses numbered placeholders ($1, $2, ...) and the other
+ * drivers use question marks.
+ *
+ * @param[in]  bulk     See @ref sqldbal_bulk.
+ * @param[in]  num_rows Number of rows of placeholders.
+ * @param[out] stmt     See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_bulk_insert_prepare(struct sqldbal_bulk *const bulk,
+                            size_t num_rows,
+                            struct sqldbal_stmt **stmt){
+  struct sqldbal_bulk sql;
+  char placeholder[MAX_I64_STR_SZ + 3];
+  size_t param_idx;
+  size_t row;
+  size_t i;
+
+  memset(&sql, 0, sizeof(sql));
+  sql.db = bulk->db;
+  sql.num_cols = bulk->num_cols;
+  sqldbal_bulk_append_str(&sql, bulk->insert->head);
+  param_idx = 0;
+  for(row = 0; row < num_rows; row++){
+    sqldbal_bulk_append_str(&sql, row ? ", (" : "(");
+    for(i = 0; i < bulk->num_cols; i++){
+      param_idx += 1;
+      if(sqldbal_is_pq(bulk->db)){
+        sprintf(placeholder,
+                "%s$%" PRIu64,
+                i ? ", " : "",
+                (uint64_t)param_idx);
+      }
+      else{
+        strcpy(placeholder, i ? ", ?" : "?");
+      }
+      sqldbal_bulk_append_str(&sql, placeholder);
+    }
+    sqldbal_bulk_append_str(&sql, ")");
+  }
+  sqldbal_bulk_append_str(&sql, bulk->insert->tail);
+  sqldbal_bulk_append(&sql, "", 1);
+
+  if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    sqldbal_stmt_prepare(bulk->db, sql.buf, sql.buf_len - 1, stmt);
+  }
+  free(sql.buf);
+}
+
+/**
+ * Set up the hash table that finds rows with the same key values before
+ * they end up in the same INSERT statement.
+ *
+ * @param[in] bulk        See @ref sqldbal_bulk.
+ * @param[in] column_list See @ref sqldbal_bulk_begin_insert.
+ * @param[in] key_list    See @ref sqldbal_bulk_begin_insert.
+ * @param[in] num_keys    See @ref sqldbal_bulk_begin_insert.
+ */
+static void
+sqldbal_bulk_insert_key_init(struct sqldbal_bulk *const bulk,
+                             const char *const *const column_list,
+                             const char *const *const key_list,
+                             size_t num_keys){
+  struct sqldbal_bulk_insert *insert;
+  size_t i;
+
+  insert = bulk->insert;
+
+  /* Keep the table at most half full. */
+  insert->num_slots = 1;
+  while(insert->num_slots < insert->rows_per_insert * 2){
+    insert->num_slots *= 2;
+  }
+  insert->is_key_list = malloc(bulk->num_cols);
+  insert->row_offset_list =
+    sqldbal_reallocarray(NULL,
+                         insert->rows_per_insert,
+                         sizeof(*insert->row_offset_list));
+  insert->slot_list = calloc(insert->num_slots,
+                             sizeof(*insert->slot_list));
+  if(insert->is_key_list == NULL ||
+     insert->row_offset_list == NULL ||
+     insert->slot_list == NULL){
+    sqldbal_status_code_set(bulk->db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    for(i = 0; i < bulk->num_cols; i++){
+      insert->is_key_list[i] =
+        (unsigned char)sqldbal_bulk_insert_is_key(column_list[i],
+                                                  key_list,
+                                                  num_keys);
+    }
+  }
+}
+
+enum sqldbal_status_code
+sqldbal_bulk_begin_insert(struct sqldbal_db *const db,
+                          const char *const table,
+                          const char *const *const column_list,
+                          size_t num_cols,
+                          const char *const *const key_list,
+                          size_t num_keys,
+                          size_t rows_per_insert,
+                          struct sqldbal_bulk **bulk){
+  struct sqldbal_bulk_insert *insert;
+  struct sqldbal_bulk sql;
+  size_t max_rows;
+
+  if(sqldbal_bulk_new(db, num_cols, bulk) == 0){
+    insert = malloc(sizeof(*insert));
+    max_rows = SQLDBAL_FUNCTIONS(db)->sqldbal_fp_param_limit(db) / num_cols;
+    if(rows_per_insert == 0){
+      rows_per_insert = SQLDBAL_BULK_INSERT_ROWS;
+    }
+    if(insert == NULL){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else if(max_rows == 0 || (num_keys && key_list == NULL)){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+      free(insert);
+    }
+    else{
+      (*bulk)->insert = insert;
+      insert->stmt            = NULL;
+      insert->head            = NULL;
+      insert->tail            = NULL;
+      insert->num_rows        = 0;
+      insert->is_key_list     = NULL;
+      insert->row_offset_list = NULL;
+      insert->slot_list       = NULL;
+      insert->num_slots       = 0;
+      insert->rows_per_insert = rows_per_insert;
+      if(insert->rows_per_insert > max_rows){
+        insert->rows_per_insert = max_rows;
+      }
+      if(num_keys && sqldbal_is_pq(db)){
+        sqldbal_bulk_insert_key_init(*bulk, column_list, key_list, num_keys);
+      }
+
+      memset(&sql, 0, sizeof(sql));
+      sql.db = db;
+      sql.num_cols = num_cols;
+      sqldbal_bulk_append_sql(&sql,
+                              "INSERT INTO ",
+                              table,
+                              column_list,
+                              " VALUES ");
+      sqldbal_bulk_append(&sql, "", 1);
+      insert->head = sql.buf;
+
+      memset(&sql, 0, sizeof(sql));
+      sql.db = db;
+      sql.num_cols = num_cols;
+      if(num_keys){
+        sqldbal_bulk_insert_append_upsert(&sql,
+                                          column_list,
+                                          key_list,
+                                          num_keys);
+      }
+      sqldbal_bulk_append(&sql, "", 1);
+      insert->tail = sql.buf;
+
+      if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+        sqldbal_bulk_insert_prepare(*bulk,
+                                    insert->rows_per_insert,
+                                    &insert->stmt);
+      }
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+/**
+ * Get the end of a value encoded by @ref sqldbal_bulk_append_row.
+ *
+ * @param[in] buf    Encoded values.
+ * @param[in] offset Position of the type byte of the value.
+ * @return           Position of the next value.
+ */
+static size_t
+sqldbal_bulk_insert_field_end(const char *const buf,
+                              size_t offset){
+  size_t len;
+  char type;
+
+  type = buf[offset++];
+  if(type == SQLDBAL_TYPE_INT){
+    offset += sizeof(int64_t);
+  }
+  else if(type == SQLDBAL_TYPE_TEXT || type == SQLDBAL_TYPE_BLOB){
+    memcpy(&len, &buf[offset], sizeof(len));
+    offset += sizeof(len) + len;
+  }
+  return offset;
+}
+
+/**
+ * Hash the key values of an encoded row.
+ *
+ * @param[in]  bulk   See @ref sqldbal_bulk.
+ * @param[in]  offset Position of the row in @ref sqldbal_bulk::buf.
+ * @param[out] hash   Hash of the key values.
+ * @retval  0 Hashed the key values.
+ * @retval -1 A key value is NULL, which never conflicts with another row.
+ */
+static int
+sqldbal_bulk_insert_key_hash(const struct sqldbal_bulk *const bulk,
+                             size_t offset,
+                             uint64_t *const hash){
+  size_t end;
+  size_t i;
+  int rc;
+
+  rc = 0;
+  *hash = UINT64_C(14695981039346656037);
+  for(i = 0; i < bulk->num_cols; i++){
+    end = sqldbal_bulk_insert_field_end(bulk->buf, offset);
+    if(bulk->insert->is_key_list[i]){
+      if(bulk->buf[offset] == SQLDBAL_TYPE_NULL){
+        rc = -1;
+      }
+      *hash = sqldbal_result_hash(*hash, &bulk->buf[offset], end - offset);
+    }
+    offset = end;
+  }
+  return rc;
+}
+
+/**
+ * Compare the key values of two encoded rows.
+ *
+ * @param[in] bulk     See @ref sqldbal_bulk.
+ * @param[in] offset_a Position of the first row in @ref sqldbal_bulk::buf.
+ * @param[in] offset_b Position of the second row in
+ *                     @ref sqldbal_bulk::buf.
+ * @retval 1 Both rows have the same key values.
+ * @retval 0 The key values differ.
+ */
+static int
+sqldbal_bulk_insert_key_equal(const struct sqldbal_bulk *const bulk,
+                              size_t offset_a,
+                              size_t offset_b){
+  size_t end_a;
+  size_t end_b;
+  size_t i;
+  int equal;
+
+  equal = 1;
+  for(i = 0; i < bulk->num_cols && equal; i++){
+    end_a = sqldbal_bulk_insert_field_end(bulk->buf, offset_a);
+    end_b = sqldbal_bulk_insert_field_end(bulk->buf, offset_b);
+    if(bulk->insert->is_key_list[i] &&
+       (end_a - offset_a != end_b - offset_b ||
+        memcmp(&bulk->buf[offset_a],
+               &bulk->buf[offset_b],
+               end_a - offset_a) != 0)){
+      equal = 0;
+    }
+    offset_a = end_a;
+    offset_b = end_b;
+  }
+  return equal;
+}
+
+/**
+ * Add the last encoded row to the key hash table, unless one of the other
+ * rows waiting for the next INSERT statement has the same key values.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ * @retval 0 Added the row, or the row has a NULL key value.
+ * @retval 1 Another waiting row has the same key values.
+ */
+static int
+sqldbal_bulk_insert_key_add(struct sqldbal_bulk *const bulk){
+  struct sqldbal_bulk_insert *insert;
+  uint64_t hash;
+  size_t slot;
+  size_t row;
+  size_t other;
+  int found;
+
+  insert = bulk->insert;
+  row = insert->num_rows;
+  found = 0;
+  if(sqldbal_bulk_insert_key_hash(bulk,
+                                  insert->row_offset_list[row],
+                                  &hash) == 0){
+    slot = (size_t)hash & (insert->num_slots - 1);
+    while(found == 0 && insert->slot_list[slot]){
+      other = insert->row_offset_list[insert->slot_list[slot] - 1];
+      if(sqldbal_bulk_insert_key_equal(bulk,
+                                       other,
+                                       insert->row_offset_list[row])){
+        found = 1;
+      }
+      else{
+        slot = (slot + 1) & (insert->num_slots - 1);
+      }
+    }
+    if(found == 0){
+      insert->slot_list[slot] = row + 1;
+    }
+  }
+  return found;
+}
+
+/**
+ * Bind the rows encoded by @ref sqldbal_bulk_append_row to an INSERT
+ * statement and run it.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ * @param[in] stmt INSERT statement with placeholders for every encoded
+ *                 row.
+ */
+static void
+sqldbal_bulk_insert_exec(struct sqldbal_bulk *const bulk,
+                         struct sqldbal_stmt *const stmt){
+  size_t offset;
+  size_t len;
+  size_t param_idx;
+  int64_t i64;
+  char type;
+
+  offset = 0;
+  for(param_idx = 0;
+      offset < bulk->buf_len &&
+      sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK;
+      param_idx++){
+    type = bulk->buf[offset++];
+    if(type == SQLDBAL_TYPE_INT){
+      memcpy(&i64, &bulk->buf[offset], sizeof(i64));
+      offset += sizeof(i64);
+      sqldbal_stmt_bind_int64(stmt, param_idx, i64);
+    }
+    else if(type == SQLDBAL_TYPE_TEXT || type == SQLDBAL_TYPE_BLOB){
+      memcpy(&len, &bulk->buf[offset], sizeof(len));
+      offset += sizeof(len);
+      if(type == SQLDBAL_TYPE_TEXT){
+        sqldbal_stmt_bind_text_static(stmt,
+                                      param_idx,
+                                      &bulk->buf[offset],
+                                      len - 1);
+      }
+      else{
+        sqldbal_stmt_bind_blob_static(stmt,
+                                      param_idx,
+                                      &bulk->buf[offset],
+                                      len);
+      }
+      offset += len;
+    }
+    else{
+      sqldbal_stmt_bind_null(stmt, param_idx);
+    }
+  }
+
+  if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    sqldbal_stmt_execute(stmt);
+  }
+  bulk->buf_len = 0;
+  bulk->insert->num_rows = 0;
+  if(bulk->insert->slot_list){
+    memset(bulk->insert->slot_list,
+           0,
+           bulk->insert->num_slots * sizeof(*bulk->insert->slot_list));
+  }
+}
+
+/**
+ * Insert the rows waiting in the buffer with a statement compiled for
+ * fewer rows than @ref sqldbal_bulk_insert::rows_per_insert.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ */
+static void
+sqldbal_bulk_insert_flush(struct sqldbal_bulk *const bulk){
+  struct sqldbal_stmt *stmt;
+
+  if(bulk->insert->num_rows &&
+     sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    sqldbal_bulk_insert_prepare(bulk, bulk->insert->num_rows, &stmt);
+    if(sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+      sqldbal_bulk_insert_exec(bulk, stmt);
+    }
+    sqldbal_stmt_close(stmt);
+  }
+}
+
+/**
+ * Copy a row into the bulk load buffer, and insert the buffered rows once
+ * the buffer has enough rows for the INSERT statement.
+ *
+ * @param[in] bulk       See @ref sqldbal_bulk.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] row        Row index starting at 0.
+ */
+static void
+sqldbal_bulk_insert_row(struct sqldbal_bulk *const bulk,
+                        const struct sqldbal_batch_param *const param_list,
+                        size_t row){
+  struct sqldbal_bulk_insert *insert;
+  size_t offset;
+  size_t len;
+
+  insert = bulk->insert;
+  offset = bulk->buf_len;
+  sqldbal_bulk_append_row(bulk, param_list, row);
+  if(insert->slot_list &&
+     sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    insert->row_offset_list[insert->num_rows] = offset;
+    if(sqldbal_bulk_insert_key_add(bulk)){
+      /*
+       * PostgreSQL refuses to update the same row twice in one statement,
+       * so insert the rows before this one first. The flush leaves the
+       * bytes of this row in place after the end of the buffer.
+       */
+      len = bulk->buf_len - offset;
+      bulk->buf_len = offset;
+      sqldbal_bulk_insert_flush(bulk);
+      memmove(bulk->buf, &bulk->buf[offset], len);
+      bulk->buf_len = len;
+      insert->row_offset_list[0] = 0;
+      sqldbal_bulk_insert_key_add(bulk);
+    }
+  }
+  insert->num_rows += 1;
+  if(insert->num_rows == insert->rows_per_insert &&
+     sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK){
+    sqldbal_bulk_insert_exec(bulk, insert->stmt);
+  }
+}
+
+/**
+ * Insert the remaining rows and free the multi-row INSERT state.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk.
+ */
+static void
+sqldbal_bulk_insert_end(struct sqldbal_bulk *const bulk){
+  struct sqldbal_bulk_insert *insert;
+
+  insert = bulk->insert;
+  sqldbal_bulk_insert_flush(bulk);
+  if(insert->stmt){
+    sqldbal_stmt_close(insert->stmt);
+  }
+  free(insert->head);
+  free(insert->tail);
+  free(insert->is_key_list);
+  free(insert->row_offset_list);
+  free(insert->slot_list);
+  free(insert);
+}
+
+enum sqldbal_status_code
+sqldbal_bulk_rows(struct sqldbal_bulk *const bulk,
+                  const struct sqldbal_batch_param *const param_list,
+                  size_t num_rows){
+  size_t row;
+
+  for(row = 0;
+      row < num_rows &&
+      sqldbal_status_code_get(bulk->db) == SQLDBAL_STATUS_OK;
+      row++){
+    if(bulk->insert){
+      sqldbal_bulk_insert_row(bulk, param_list, row);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(bulk->db)->sqldbal_fp_bulk_row(bulk, param_list, row);
+    }
+  }
+  return sqldbal_status_code_get(bulk->db);
+}
+
+enum sqldbal_status_code
+sqldbal_bulk_end(struct sqldbal_bulk *const bulk){
+  struct sqldbal_db *db;
+
+  db = bulk->db;
+  if(bulk != &g_bulk_error){
+    if(bulk->insert){
+      sqldbal_bulk_insert_end(bulk);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_bulk_end(bulk);
+    }
+    free(bulk->buf);
+    free(bulk);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+/**
+ * Returned by @ref sqldbal_blob_open if the library could not allocate
+ * memory for the @ref sqldbal_blob.
+ *
+ * Each thread has its own copy, which refers to the @ref g_db_error of the
+ * same thread.
+ */
+static SQLDBAL_THREAD_LOCAL struct sqldbal_blob
+g_blob_error = {
+  NULL,                             /* db                */
+  NULL,                             /* handle            */
+  0   ,                             /* size              */
+  -1  ,                             /* fd                */
+  0                                 /* write             */
+};
+
+enum sqldbal_status_code
+sqldbal_blob_open(struct sqldbal_db *const db,
+                  const char *const table,
+                  const char *const column,
+                  int64_t row_id,
+                  int write,
+                  struct sqldbal_blob **blob){
+  struct sqldbal_blob *new_blob;
+
+  new_blob = malloc(sizeof(*new_blob));
+  if(new_blob == NULL){
+    g_blob_error.db = &g_db_error;
+    *blob = &g_blob_error;
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+  }
+  else{
+    *blob = new_blob;
+    new_blob->db     = db;
+    new_blob->handle = NULL;
+    new_blob->size   = 0;
+    new_blob->fd     = -1;
+    new_blob->write  = write != 0;
+    if(sqldbal_lazy_connect(db) == 0){
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_blob_open(new_blob,
+                                                  table,
+                                                  column,
+                                                  row_id);
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+void
+sqldbal_blob_size(const struct sqldbal_blob *const blob,
+                  uint64_t *const size){
+  *size = blob->size;
+}
+
+enum sqldbal_status_code
+sqldbal_blob_read(struct sqldbal_blob *const blob,
+                  uint64_t offset,
+                  void *const buf,
+                  size_t len){
+  if(sqldbal_status_code_get(blob->db) == SQLDBAL_STATUS_OK){
+    if(offset > blob->size || len > blob->size - offset){
+      sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_PARAM);
+    }
+    else if(len){
+      SQLDBAL_FUNCTIONS(blob->db)->sqldbal_fp_blob_read(blob,
+                                                        offset,
+                                                        buf,
+                                                        len);
+    }
+  }
+  return sqldbal_status_code_get(blob->db);
+}
+
+enum sqldbal_status_code
+sqldbal_blob_write(struct sqldbal_blob *const blob,
+                   uint64_t offset,
+                   const void *const buf,
+                   size_t len){
+  if(sqldbal_status_code_get(blob->db) == SQLDBAL_STATUS_OK){
+    if(blob->write == 0){
+      sqldbal_status_code_set(blob->db, SQLDBAL_STATUS_PARAM);
+    }
+    else if(len){
+      SQLDBAL_FUNCTIONS(blob->db)->sqldbal_fp_blob_write(blob,
+                                                         offset,
+                                                         buf,
+                                                         len);
+    }
+  }
+  return sqldbal_status_code_get(blob->db);
+}
+
+enum sqldbal_status_code
+sqldbal_blob_close(struct sqldbal_blob *const blob){
+  struct sqldbal_db *db;
+
+  db = blob->db;
+  if(blob != &g_blob_error){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_blob_close(blob);
+    free(blob);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_pipeline_end(struct sqldbal_db *const db){
+  if(db->pipeline == 0){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_pipeline_end(db);
+    db->pipeline = 0;
+  }
+  return sqldbal_status_code_get(db);
+}
+
+void
+sqldbal_metrics_hook(struct sqldbal_db *const db,
+                     sqldbal_metrics_fp metrics,
+                     void *const user_data){
+  db->metrics_fp        = metrics;
+  db->metrics_user_data = user_data;
+}
+
+/**
+ * Start measuring an operation if the metrics hook has been set.
+ *
+ * @param[in]  db      See @ref sqldbal_db.
+ * @param[in]  event   See @ref sqldbal_metrics_event.
+ * @param[out] metrics Measurements to pass to @ref sqldbal_metrics_end.
+ * @retval 1 Started measuring the operation.
+ * @retval 0 The metrics hook has not been set.
+ */
+static int
+sqldbal_metrics_start(const struct sqldbal_db *const db,
+                      enum sqldbal_metrics_event event,
+                      struct sqldbal_metrics *const metrics){
+  int measure;
+
+  measure = 0;
+  if(db->metrics_fp || SQLDBAL_TRACE_DISPATCH(db)){
+    measure = 1;
+    metrics->sql         = NULL;
+    metrics->sql_len     = 0;
+    metrics->sql_hash    = 0;
+    metrics->num_rows    = 0;
+    metrics->num_bytes   = 0;
+    metrics->event       = event;
+    metrics->status      = SQLDBAL_STATUS_OK;
+
+    /* Converted to the differences in sqldbal_metrics_end. */
+    metrics->num_retries = db->busy.num_retries;
+    metrics->elapsed_ns  = sqldbal_time_ns();
+  }
+  return measure;
+}
+
+/**
+ * Finish measuring an operation and pass the measurements to the metrics
+ * hook.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] metrics Measurements from @ref sqldbal_metrics_start.
+ */
+static void
+sqldbal_metrics_end(struct sqldbal_db *const db,
+                    struct sqldbal_metrics *const metrics){
+  metrics->elapsed_ns  = sqldbal_time_ns() - metrics->elapsed_ns;
+  metrics->num_retries = db->busy.num_retries - metrics->num_retries;
+  metrics->status      = sqldbal_status_code_get(db);
+  if(db->metrics_fp){
+    db->metrics_fp(db->metrics_user_data, metrics);
+  }
+}
+
+/**
+ * Record a statement measured by the library in the trace of the
+ * connection.
+ *
+ * @param[in] db      See @ref sqldbal_db.
+ * @param[in] metrics Measurements from @ref sqldbal_metrics_end.
+ * @param[in] sql     SQL text, or NULL if not known.
+ * @param[in] sql_len Length of @p sql in bytes.
+ */
+static void
+sqldbal_metrics_trace(const struct sqldbal_db *const db,
+                      const struct sqldbal_metrics *const metrics,
+                      const char *const sql,
+                      size_t sql_len){
+#ifdef SQLDBAL_TRACE
+  int slow;
+
+  if(SQLDBAL_TRACE_DISPATCH(db) &&
+     sqldbal_trace_keep(db->trace, metrics->elapsed_ns, &slow)){
+    sqldbal_trace_push(db,
+                       metrics->event,
+                       sql,
+                       sql_len,
+                       metrics->sql_hash,
+                       metrics->elapsed_ns,
+                       metrics->num_rows,
+                       slow);
+  }
+#else /* !(SQLDBAL_TRACE) */
+  (void)db;
+  (void)metrics;
+  (void)sql;
+  (void)sql_len;
+#endif /* SQLDBAL_TRACE */
+}
+
+/**
+ * Report the fetch measurements for the current result set, if any.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_stmt_metrics_flush(struct sqldbal_stmt *const stmt){
+  if(stmt->metrics_fetch_active){
+    stmt->metrics_fetch_active = 0;
+    stmt->metrics_fetch.status = sqldbal_status_code_get(stmt->db);
+    if(stmt->db->metrics_fp){
+      stmt->db->metrics_fp(stmt->db->metrics_user_data,
+                           &stmt->metrics_fetch);
+    }
+  }
+}
+
+/**
+ * Count the text and blob bytes bound to a statement parameter.
+ *
+ * @param[in] stmt  See @ref sqldbal_stmt.
+ * @param[in] bytes Number of bytes in the parameter value.
+ */
+static void
+sqldbal_stmt_metrics_bind(struct sqldbal_stmt *const stmt,
+                          size_t bytes){
+  if(stmt->db->metrics_fp){
+    stmt->metrics_bind_bytes += bytes;
+  }
+}
+
+/**
+ * Passes the rows from @ref sqldbal_exec to the application callback while
+ * counting them for the metrics hook.
+ */
+struct sqldbal_metrics_exec{
+  /**
+   * Application callback passed to @ref sqldbal_exec.
+   */
+  sqldbal_exec_callback_fp callback;
+
+  /**
+   * User data passed to @ref sqldbal_exec.
+   */
+  void *user_data;
+
+  /**
+   * Number of rows passed to @ref callback.
+   */
+  uint64_t num_rows;
+};
+
+/**
+ * Count a row and pass it to the application callback.
+ *
+ * See @ref sqldbal_exec_callback_fp.
+ *
+ * @param[in] user_data       See @ref sqldbal_metrics_exec.
+ * @param[in] num_cols        Number of columns in the row.
+ * @param[in] col_result_list Column values.
+ * @param[in] col_length_list Length of each column value.
+ * @return Value returned by the application callback.
+ */
+static int
+sqldbal_metrics_exec_callback(void *user_data,
+                              size_t num_cols,
+                              char **col_result_list,
+                              size_t *col_length_list){
+  struct sqldbal_metrics_exec *exec;
+
+  exec = user_data;
+  exec->num_rows += 1;
+  return exec->callback(exec->user_data,
+                        num_cols,
+                        col_result_list,
+                        col_length_list);
+}
+
+/**
+ * Run a SQL query directly on the driver.
+ *
+ * See @ref sqldbal_exec.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sql       See @ref sqldbal_exec.
+ * @param[in] callback  See @ref sqldbal_exec.
+ * @param[in] user_data See @ref sqldbal_exec.
+ */
+static void
+sqldbal_exec_db(struct sqldbal_db *const db,
+                const char *const sql,
+                sqldbal_exec_callback_fp callback,
+                void *user_data){
+  struct sqldbal_metrics metrics;
+  struct sqldbal_metrics_exec exec;
+
+  if(sqldbal_lazy_connect(db)){
+    /* No connection to run the statement on. */
+  }
+  else if(sqldbal_metrics_start(db, SQLDBAL_METRICS_EXEC, &metrics) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_exec(db, sql, callback, user_data);
+  }
+  else{
+    exec.callback  = callback;
+    exec.user_data = user_data;
+    exec.num_rows  = 0;
+    if(callback){
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_exec(db,
+                                             sql,
+                                             sqldbal_metrics_exec_callback,
+                                             &exec);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_exec(db, sql, NULL, user_data);
+    }
+    metrics.sql       = sql;
+    metrics.sql_len   = strlen(sql);
+    metrics.sql_hash  = sqldbal_stmt_cache_hash(sql, metrics.sql_len);
+    metrics.num_rows  = exec.num_rows;
+    metrics.num_bytes = metrics.sql_len;
+    sqldbal_metrics_end(db, &metrics);
+    sqldbal_metrics_trace(db, &metrics, sql, metrics.sql_len);
+  }
+}
+
+/**
+ * Collects the rows from @ref sqldbal_exec_cached for the result cache
+ * while passing them to the application callback.
+ */
+struct sqldbal_result_exec{
+  /**
+   * Database connection running the query.
+   */
+  struct sqldbal_db *db;
+
+  /**
+   * Application callback passed to @ref sqldbal_exec_cached.
+   */
+  sqldbal_exec_callback_fp callback;
+
+  /**
+   * User data passed to @ref sqldbal_exec_cached.
+   */
+  void *user_data;
+
+  /**
+   * Result being collected, or NULL if the result does not fit in the
+   * cache.
+   */
+  struct sqldbal_result_entry *entry;
+
+  /**
+   * Set to 1 if the application callback stopped the query early.
+   */
+  int stopped;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Copy a row into the result cache and pass it to the application
+ * callback.
+ *
+ * See @ref sqldbal_exec_callback_fp.
+ *
+ * @param[in] user_data       See @ref sqldbal_result_exec.
+ * @param[in] num_cols        Number of columns in the row.
+ * @param[in] col_result_list Column values.
+ * @param[in] col_length_list Length of each column value.
+ * @return Value returned by the application callback.
+ */
+static int
+sqldbal_result_exec_callback(void *user_data,
+                             size_t num_cols,
+                             char **col_result_list,
+                             size_t *col_length_list){
+  struct sqldbal_result_exec *exec;
+  enum sqldbal_column_type type;
+  size_t col_idx;
+  size_t len;
+  int rc;
+
+  exec = user_data;
+  if(exec->entry){
+    rc = 0;
+    if(exec->entry->num_rows == 0){
+      exec->entry->num_cols = num_cols;
+    }
+    for(col_idx = 0; col_idx < num_cols && rc == 0; col_idx++){
+      type = SQLDBAL_TYPE_TEXT;
+      len = col_length_list[col_idx];
+      if(col_result_list[col_idx] == NULL){
+        type = SQLDBAL_TYPE_NULL;
+        len = 0;
+      }
+      rc = sqldbal_result_entry_add(exec->db,
+                                    exec->entry,
+                                    type,
+                                    0,
+                                    0,
+                                    col_result_list[col_idx],
+                                    len,
+                                    len);
+    }
+    if(rc == 0 && num_cols == exec->entry->num_cols){
+      exec->entry->num_rows += 1;
+    }
+    else{
+      sqldbal_result_entry_release(exec->entry);
+      exec->entry = NULL;
+    }
+  }
+  rc = exec->callback(exec->user_data,
+                      num_cols,
+                      col_result_list,
+                      col_length_list);
+  if(rc){
+    exec->stopped = 1;
+  }
+  return rc;
+}
+
+/**
+ * Pass the rows of a cached result to an @ref sqldbal_exec_cached callback.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] entry     Result from @ref sqldbal_exec_cached.
+ * @param[in] callback  See @ref sqldbal_exec_cached.
+ * @param[in] user_data See @ref sqldbal_exec_cached.
+ */
+static void
+sqldbal_result_exec_replay(struct sqldbal_db *const db,
+                           const struct sqldbal_result_entry *const entry,
+                           sqldbal_exec_callback_fp callback,
+                           void *user_data){
+  const struct sqldbal_result_cell *cell;
+  char **col_result_list;
+  size_t *col_length_list;
+  size_t row;
+  size_t col_idx;
+  int rc;
+
+  if(entry->num_rows && entry->num_cols){
+    col_result_list = sqldbal_reallocarray(NULL,
+                                           entry->num_cols,
+                                           sizeof(*col_result_list));
+    col_length_list = sqldbal_reallocarray(NULL,
+                                           entry->num_cols,
+                                           sizeof(*col_length_list));
+    if(col_result_list == NULL || col_length_list == NULL){
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      rc = 0;
+      for(row = 0; row < entry->num_rows && rc == 0; row++){
+        for(col_idx = 0; col_idx < entry->num_cols; col_idx++){
+          cell = &entry->cell_list[row * entry->num_cols + col_idx];
+          col_result_list[col_idx] = NULL;
+          col_length_list[col_idx] = 0;
+          if(cell->type != SQLDBAL_TYPE_NULL){
+            col_result_list[col_idx] = &entry->data[cell->offset];
+            col_length_list[col_idx] = cell->len;
+          }
+        }
+        rc = callback(user_data,
+                      entry->num_cols,
+                      col_result_list,
+                      col_length_list);
+      }
+    }
+    free(col_result_list);
+    free(col_length_list);
+  }
+}
+
+enum sqldbal_status_code
+sqldbal_exec(struct sqldbal_db *const db,
+             const char *const sql,
+             sqldbal_exec_callback_fp callback,
+             void *user_data){
+  int change;
+
+  sqldbal_exec_db(db, sql, callback, user_data);
+  /* Keep read-only statements on db while SQL holds a transaction open. */
+  change = sqldbal_sql_transaction_change(sql, (size_t)-1);
+  if(change == 0 ||
+     (change == 1 && sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK)){
+    db->transaction = change;
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_exec_cached(struct sqldbal_db *const db,
+                    const char *const sql,
+                    sqldbal_exec_callback_fp callback,
+                    void *user_data){
+  struct sqldbal_result_exec exec;
+  struct sqldbal_result_entry *entry;
+  size_t sql_len;
+
+  if(callback &&
+     db->result_cache.max_bytes &&
+     db->transaction == 0 &&
+     db->pipeline == 0 &&
+     sqldbal_sql_is_read_only(sql, (size_t)-1)){
+    sql_len = strlen(sql);
+    entry = sqldbal_result_cache_get(db, sql, sql_len, NULL, 0, 1);
+    if(entry){
+      /* The callback may invalidate the cache while this uses the rows. */
+      entry->num_refs += 1;
+      sqldbal_result_exec_replay(db, entry, callback, user_data);
+      sqldbal_result_entry_release(entry);
+    }
+    else{
+      exec.db        = db;
+      exec.callback  = callback;
+      exec.user_data = user_data;
+      exec.entry     = sqldbal_result_entry_new(sql, sql_len, NULL, 0, 1);
+      exec.stopped   = 0;
+      sqldbal_exec_db(db, sql, sqldbal_result_exec_callback, &exec);
+      if(exec.entry){
+        if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK &&
+           exec.stopped == 0){
+          sqldbal_result_cache_put(db, exec.entry);
+        }
+        else{
+          sqldbal_result_entry_release(exec.entry);
+        }
+      }
+    }
+  }
+  else{
+    sqldbal_exec(db, sql, callback, user_data);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_last_insert_id(struct sqldbal_db *const db,
+                       const char *const name,
+                       uint64_t *insert_id){
+  if(sqldbal_lazy_connect(db) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_last_insert_id(db, name, insert_id);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_ping(struct sqldbal_db *const db){
+  if(sqldbal_lazy_connect(db) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_ping(db);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_db_socket_fd(struct sqldbal_db *const db,
+                     int *const fd){
+  *fd = -1;
+  if(sqldbal_lazy_connect(db) == 0){
+    SQLDBAL_FUNCTIONS(db)->sqldbal_fp_socket_fd(db, fd);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_cache_set_capacity(struct sqldbal_db *const db,
+                                size_t capacity){
+  struct sqldbal_stmt **bucket_list;
+  size_t num_buckets;
+
+  if((db->flags & SQLDBAL_FLAG_INVALID_MEMORY) == 0){
+    sqldbal_stmt_cache_flush(db);
+    free(db->stmt_cache.bucket_list);
+    db->stmt_cache.bucket_list = NULL;
+    db->stmt_cache.num_buckets = 0;
+    db->stmt_cache.capacity    = 0;
+    if(capacity){
+      num_buckets = 1;
+      while(num_buckets < capacity && num_buckets <= SIZE_MAX / 2){
+        num_buckets *= 2;
+      }
+      bucket_list = calloc(num_buckets, sizeof(*bucket_list));
+      if(bucket_list == NULL){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        db->stmt_cache.bucket_list = bucket_list;
+        db->stmt_cache.num_buckets = num_buckets;
+        db->stmt_cache.capacity    = capacity;
+      }
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+void
+sqldbal_stmt_cache_stats(const struct sqldbal_db *const db,
+                         uint64_t *const num_hits,
+                         uint64_t *const num_misses,
+                         size_t *const num_stmts){
+  *num_hits   = db->stmt_cache.num_hits;
+  *num_misses = db->stmt_cache.num_misses;
+  *num_stmts  = db->stmt_cache.num_stmts;
+}
+
+void
+sqldbal_busy_stats(const struct sqldbal_db *const db,
+                   uint64_t *const num_retries,
+                   uint64_t *const wait_ms){
+  *num_retries = db->busy.num_retries;
+  *wait_ms     = db->busy.wait_ms;
+}
+
+/**
+ * Every this many bytes of the result cache budget add one hash table
+ * bucket.
+ */
+#define SQLDBAL_RESULT_CACHE_BUCKET_BYTES 1024
+
+/**
+ * Maximum number of hash table buckets in the result cache.
+ */
+#define SQLDBAL_RESULT_CACHE_MAX_BUCKETS 65536
+
+enum sqldbal_status_code
+sqldbal_result_cache_set(struct sqldbal_db *const db,
+                         size_t max_bytes,
+                         long ttl_ms){
+  struct sqldbal_result_cache *cache;
+  size_t num_buckets;
+
+  cache = &db->result_cache;
+  if((db->flags & SQLDBAL_FLAG_INVALID_MEMORY) == 0){
+    sqldbal_result_cache_flush(db);
+    free(cache->bucket_list);
+    cache->bucket_list = NULL;
+    cache->num_buckets = 0;
+    cache->max_bytes   = 0;
+    if(ttl_ms < 0){
+      cache->ttl_ns = UINT64_MAX;
+    }
+    else{
+      cache->ttl_ns = (uint64_t)ttl_ms * 1000000;
+    }
+    if(max_bytes){
+      num_buckets = 16;
+      while(num_buckets < max_bytes / SQLDBAL_RESULT_CACHE_BUCKET_BYTES &&
+            num_buckets < SQLDBAL_RESULT_CACHE_MAX_BUCKETS){
+        num_buckets *= 2;
+      }
+      cache->bucket_list = calloc(num_buckets, sizeof(*cache->bucket_list));
+      if(cache->bucket_list == NULL){
+        sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+      }
+      else{
+        cache->num_buckets = num_buckets;
+        cache->max_bytes   = max_bytes;
+      }
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_result_cache_invalidate(struct sqldbal_db *const db,
+                                const char *const name){
+  struct sqldbal_result_entry *entry;
+  struct sqldbal_result_entry *next;
+
+  for(entry = db->result_cache.lru_head; entry; entry = next){
+    next = entry->next;
+    if(name == NULL ||
+       sqldbal_sql_has_word(entry->sql, entry->sql_len, name)){
+      sqldbal_result_cache_unlink(db, entry);
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+void
+sqldbal_result_cache_stats(const struct sqldbal_db *const db,
+                           uint64_t *const num_hits,
+                           uint64_t *const num_misses,
+                           size_t *const num_bytes){
+  *num_hits   = db->result_cache.num_hits;
+  *num_misses = db->result_cache.num_misses;
+  *num_bytes  = db->result_cache.num_bytes;
+}
+
+/**
+ * Replicas that fail get skipped by the read routing for this many
+ * milliseconds before @ref sqldbal_stmt_prepare tries them again.
+ */
+#define SQLDBAL_REPLICA_EJECT_MS 5000
+
+/**
+ * Routing state of a connection added with @ref sqldbal_replica_add.
+ */
+struct sqldbal_replica{
+  /**
+   * Moving average of the statement execution times in nanoseconds.
+   */
+  uint64_t latency_ns;
+
+  /**
+   * Skip the replica until this time.
+   *
+   * See @ref sqldbal_time_ns.
+   */
+  uint64_t eject_until_ns;
+
+  /**
+   * Number of statements prepared on the replica that have not been
+   * closed yet.
+   */
+  size_t num_outstanding;
+};
+
+/**
+ * Choose the replica for a read-only statement.
+ *
+ * Picks the replica with the lowest product of open statements and
+ * average execution time, which favors idle and fast replicas. Ejected
+ * replicas get skipped.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @return       Replica connection, or NULL if all replicas have been
+ *               ejected.
+ */
+static struct sqldbal_db *
+sqldbal_replica_select(struct sqldbal_db *const db){
+  struct sqldbal_db *best;
+  struct sqldbal_replica *replica;
+  uint64_t now_ns;
+  uint64_t score;
+  uint64_t best_score;
+  size_t i;
+  size_t idx;
+
+  best = NULL;
+  best_score = UINT64_MAX;
+  now_ns = sqldbal_time_ns();
+  for(i = 0; i < db->num_replicas; i++){
+    idx = (db->replica_next + i) % db->num_replicas;
+    replica = db->replica_list[idx]->replica;
+    if(replica->eject_until_ns <= now_ns){
+      score = ((uint64_t)replica->num_outstanding + 1) *
+              (replica->latency_ns / 1000 + 1);
+      if(score < best_score){
+        best = db->replica_list[idx];
+        best_score = score;
+      }
+    }
+  }
+  db->replica_next = (db->replica_next + 1) % db->num_replicas;
+  return best;
+}
+
+/**
+ * Skip a replica for a period of time.
+ *
+ * @param[in] replica See @ref sqldbal_replica.
+ * @param[in] eject_ms Number of milliseconds to skip the replica.
+ */
+static void
+sqldbal_replica_eject_ms(struct sqldbal_replica *const replica,
+                         long eject_ms){
+  if(eject_ms > 0){
+    replica->eject_until_ns = sqldbal_time_ns() +
+                              (uint64_t)eject_ms * 1000000;
+  }
+  else{
+    replica->eject_until_ns = 0;
+  }
+}
+
+/**
+ * Eject a replica after a failed statement if the connection no longer
+ * responds.
+ *
+ * Errors in the statement itself, like a syntax error or a constraint
+ * violation, would fail on every replica and do not eject the replica.
+ * The status code of @p db stays the same.
+ *
+ * @param[in] db Replica connection. See @ref sqldbal_db.
+ */
+static void
+sqldbal_replica_check_failure(struct sqldbal_db *const db){
+  enum sqldbal_status_code status;
+
+  status = sqldbal_status_code_clear(db);
+  if(sqldbal_ping(db) != SQLDBAL_STATUS_OK){
+    sqldbal_replica_eject_ms(db->replica, SQLDBAL_REPLICA_EJECT_MS);
+  }
+  sqldbal_status_code_set(db, status);
+}
+
+/**
+ * Update the average execution time of a replica after running a
+ * statement, and eject the replica if the connection failed.
+ *
+ * @param[in] db       Replica connection. See @ref sqldbal_db.
+ * @param[in] start_ns Time when the statement started.
+ */
+static void
+sqldbal_replica_measure(struct sqldbal_db *const db,
+                        uint64_t start_ns){
+  struct sqldbal_replica *replica;
+  uint64_t elapsed_ns;
+
+  replica = db->replica;
+  elapsed_ns = sqldbal_time_ns() - start_ns;
+  if(replica->latency_ns == 0){
+    replica->latency_ns = elapsed_ns;
+  }
+  else{
+    replica->latency_ns = replica->latency_ns - replica->latency_ns / 8 +
+                          elapsed_ns / 8;
+  }
+  if(sqldbal_status_code_get(db) != SQLDBAL_STATUS_OK){
+    sqldbal_replica_check_failure(db);
+  }
+}
+
+/**
+ * Find the index of a replica connection.
+ *
+ * @param[in]  db      Primary connection. See @ref sqldbal_db.
+ * @param[in]  replica Replica connection.
+ * @param[out] idx     Index in @ref sqldbal_db::replica_list.
+ * @retval 1 Found @p replica.
+ * @retval 0 @p replica does not belong to @p db.
+ */
+static int
+sqldbal_replica_find(const struct sqldbal_db *const db,
+                     const struct sqldbal_db *const replica,
+                     size_t *const idx){
+  size_t i;
+  int found;
+
+  found = 0;
+  for(i = 0; i < db->num_replicas && found == 0; i++){
+    if(db->replica_list[i] == replica){
+      *idx = i;
+      found = 1;
+    }
+  }
+  return found;
+}
+
+enum sqldbal_status_code
+sqldbal_replica_add(struct sqldbal_db *const db,
+                    struct sqldbal_db *const replica){
+  struct sqldbal_db **replica_list;
+  struct sqldbal_replica *state;
+
+  if(replica == db ||
+     db->replica ||
+     replica->replica ||
+     replica->num_replicas ||
+     (replica->flags & SQLDBAL_FLAG_INVALID_MEMORY) ||
+     sqldbal_status_code_get(replica) != SQLDBAL_STATUS_OK){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    state = malloc(sizeof(*state));
+    replica_list = sqldbal_reallocarray(db->replica_list,
+                                        db->num_replicas + 1,
+                                        sizeof(*replica_list));
+    if(replica_list){
+      db->replica_list = replica_list;
+    }
+    if(state == NULL || replica_list == NULL){
+      free(state);
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      state->latency_ns      = 0;
+      state->eject_until_ns  = 0;
+      state->num_outstanding = 0;
+      replica->replica = state;
+      db->replica_list[db->num_replicas] = replica;
+      db->num_replicas += 1;
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_replica_eject(struct sqldbal_db *const db,
+                      struct sqldbal_db *const replica,
+                      long eject_ms){
+  size_t idx;
+
+  if(sqldbal_replica_find(db, replica, &idx)){
+    sqldbal_replica_eject_ms(db->replica_list[idx]->replica, eject_ms);
+  }
+  else{
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_PARAM);
+  }
+  return sqldbal_status_code_get(db);
+}
+
+enum sqldbal_status_code
+sqldbal_replica_check_lag(struct sqldbal_db *const db,
+                          const char *const sql,
+                          int64_t max_lag,
+                          long eject_ms){
+  struct sqldbal_db *replica;
+  struct sqldbal_stmt *stmt;
+  int64_t lag;
+  size_t i;
+  int eject;
+
+  for(i = 0; i < db->num_replicas; i++){
+    replica = db->replica_list[i];
+    lag = 0;
+    eject = 1;
+    sqldbal_stmt_prepare(replica, sql, (size_t)-1, &stmt);
+    if(sqldbal_status_code_get(replica) == SQLDBAL_STATUS_OK){
+      sqldbal_stmt_execute(stmt);
+    }
+    if(sqldbal_status_code_get(replica) == SQLDBAL_STATUS_OK &&
+       sqldbal_stmt_fetch(stmt) == SQLDBAL_FETCH_ROW){
+      sqldbal_stmt_column_int64(stmt, 0, &lag);
+      if(sqldbal_status_code_get(replica) == SQLDBAL_STATUS_OK &&
+         lag <= max_lag){
+        eject = 0;
+      }
+    }
+    sqldbal_stmt_close(stmt);
+    if(eject){
+      sqldbal_replica_eject_ms(replica->replica, eject_ms);
+      sqldbal_status_code_clear(replica);
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+/**
+ * This error structure used for the single error case where we cannot
+ * initially allocate memory for the @ref sqldbal_stmt.
+ *
+ * Each thread has its own copy, which refers to the @ref g_db_error of the
+ * same thread.
+ */
+static SQLDBAL_THREAD_LOCAL struct sqldbal_stmt
+g_stmt_error = {
+  NULL,                             /* db                */
+  0   ,                             /* num_params        */
+  0   ,                             /* num_cols_result   */
+  NULL,                             /* handle            */
+  NULL,                             /* cache_sql         */
+  0   ,                             /* cache_sql_len     */
+  0   ,                             /* cache_hash        */
+  NULL,                             /* cache_prev        */
+  NULL,                             /* cache_next        */
+  NULL,                             /* cache_bucket_next */
+  0   ,                             /* cursor_prefetch   */
+  {                                 /* metrics_fetch     */
+    NULL,                           /* sql               */
+    0   ,                           /* sql_len           */
+    0   ,                           /* sql_hash          */
+    0   ,                           /* elapsed_ns        */
+    0   ,                           /* num_rows          */
+    0   ,                           /* num_bytes         */
+    0   ,                           /* num_retries       */
+    SQLDBAL_METRICS_FETCH,          /* event             */
+    SQLDBAL_STATUS_OK               /* status            */
+  },                                /* metrics_fetch     */
+  0   ,                             /* metrics_hash      */
+  0   ,                             /* metrics_bind_bytes*/
+  0   ,                             /* metrics_start_ns  */
+  NULL,                             /* result_sql        */
+  0   ,                             /* result_sql_len    */
+  NULL,                             /* trace_sql         */
+  0   ,                             /* trace_sql_len     */
+  NULL,                             /* result_param_list */
+  NULL,                             /* result_entry      */
+  NULL,                             /* result_capture    */
+  0   ,                             /* result_row        */
+  NULL,                             /* stream_list       */
+  0   ,                             /* valid             */
+  0   ,                             /* fetch_pending     */
+  0   ,                             /* fetch_done        */
+  0   ,                             /* async_pending     */
+  0   ,                             /* metrics_fetch_active */
+  {0}                               /* pad               */
+};
+
+/**
+ * Compile a SQL query on a specific connection.
+ *
+ * See @ref sqldbal_stmt_prepare.
+ *
+ * @param[in]  db      See @ref sqldbal_db.
+ * @param[in]  sql     See @ref sqldbal_stmt_prepare.
+ * @param[in]  sql_len See @ref sqldbal_stmt_prepare.
+ * @param[out] stmt    See @ref sqldbal_stmt_prepare.
+ */
+static void
+sqldbal_stmt_prepare_db(struct sqldbal_db *const db,
+                        const char *const sql,
+                        size_t sql_len,
+                        struct sqldbal_stmt **stmt){
+  struct sqldbal_metrics metrics;
+  struct sqldbal_stmt *new_stmt;
+  size_t cache_sql_len;
+  uint64_t cache_hash;
+  int measure;
+
+  measure = sqldbal_metrics_start(db, SQLDBAL_METRICS_PREPARE, &metrics);
+  new_stmt = NULL;
+  cache_sql_len = 0;
+  cache_hash = 0;
+  if(db->stmt_cache.capacity){
+    if(sql_len == (size_t)-1){
+      cache_sql_len = strlen(sql);
+    }
+    else{
+      cache_sql_len = sql_len;
+    }
+    cache_hash = sqldbal_stmt_cache_hash(sql, cache_sql_len);
+    new_stmt = sqldbal_stmt_cache_take(db, sql, cache_sql_len, cache_hash);
+    if(new_stmt){
+      db->stmt_cache.num_hits += 1;
+    }
+    else{
+      db->stmt_cache.num_misses += 1;
+    }
+  }
+
+  if(new_stmt){
+    *stmt = new_stmt;
+    new_stmt->fetch_pending = 0;
+    new_stmt->fetch_done    = 0;
+    new_stmt->async_pending = 0;
+    new_stmt->metrics_bind_bytes = 0;
+  }
+  else{
+    new_stmt = malloc(sizeof(*new_stmt));
+    if(new_stmt == NULL){
+      g_stmt_error.db = &g_db_error;
+      *stmt = &g_stmt_error;
+      sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      *stmt = new_stmt;
+      new_stmt->db                = db;
+      new_stmt->num_params        = 0;
+      new_stmt->num_cols_result   = 0;
+      new_stmt->handle            = NULL;
+      new_stmt->cache_sql         = NULL;
+      new_stmt->cache_sql_len     = 0;
+      new_stmt->cache_hash        = 0;
+      new_stmt->cache_prev        = NULL;
+      new_stmt->cache_next        = NULL;
+      new_stmt->cache_bucket_next = NULL;
+      new_stmt->cursor_prefetch   = 0;
+      new_stmt->metrics_hash      = 0;
+      new_stmt->metrics_bind_bytes = 0;
+      new_stmt->metrics_start_ns  = 0;
+      new_stmt->result_sql        = NULL;
+      new_stmt->result_sql_len    = 0;
+      new_stmt->trace_sql         = NULL;
+      new_stmt->trace_sql_len     = 0;
+      new_stmt->result_param_list = NULL;
+      new_stmt->result_entry      = NULL;
+      new_stmt->result_capture    = NULL;
+      new_stmt->result_row        = 0;
+      new_stmt->stream_list       = NULL;
+      new_stmt->metrics_fetch_active = 0;
+      new_stmt->valid             = 1;
+      new_stmt->fetch_pending     = 0;
+      new_stmt->fetch_done        = 0;
+      new_stmt->async_pending     = 0;
+      if(sqldbal_lazy_connect(db) == 0){
+        SQLDBAL_FUNCTIONS(db)->sqldbal_fp_stmt_prepare(db,
+                                                       sql,
+                                                       sql_len,
+                                                       new_stmt);
+      }
+
+      /*
+       * The statement still works without the SQL copy, but
+       * @ref sqldbal_stmt_close has to free it instead of caching it.
+       */
+      if(db->stmt_cache.capacity &&
+         sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+        new_stmt->cache_sql = malloc(cache_sql_len + 1);
+        if(new_stmt->cache_sql){
+          memcpy(new_stmt->cache_sql, sql, cache_sql_len);
+          new_stmt->cache_sql[cache_sql_len] = '\0';
+          new_stmt->cache_sql_len = cache_sql_len;
+          new_stmt->cache_hash    = cache_hash;
+        }
+      }
+    }
+  }
+
+  if(measure){
+    metrics.sql = sql;
+    if(sql_len == (size_t)-1){
+      metrics.sql_len = strlen(sql);
+    }
+    else{
+      metrics.sql_len = sql_len;
+    }
+    if(db->stmt_cache.capacity){
+      metrics.sql_hash = cache_hash;
+    }
+    else{
+      metrics.sql_hash = sqldbal_stmt_cache_hash(sql, metrics.sql_len);
+    }
+    metrics.num_bytes = metrics.sql_len;
+    if(*stmt != &g_stmt_error){
+      (*stmt)->metrics_hash = metrics.sql_hash;
+    }
+    sqldbal_metrics_end(db, &metrics);
+#ifdef SQLDBAL_TRACE
+    if(SQLDBAL_TRACE_DISPATCH(db) &&
+       *stmt != &g_stmt_error &&
+       (*stmt)->trace_sql == NULL){
+      sqldbal_trace_stmt_init(*stmt, sql, metrics.sql_len);
+    }
+#endif /* SQLDBAL_TRACE */
+  }
+  if(db->replica && *stmt != &g_stmt_error){
+    db->replica->num_outstanding += 1;
+  }
+  if(*stmt != &g_stmt_error &&
+     (*stmt)->result_sql == NULL &&
+     db->result_cache.max_bytes &&
+     sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK &&
+     sqldbal_sql_is_read_only(sql, sql_len)){
+    sqldbal_result_stmt_init(*stmt, sql, sql_len);
+  }
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_prepare(struct sqldbal_db *const db,
+                     const char *const sql,
+                     size_t sql_len,
+                     struct sqldbal_stmt **stmt){
+  struct sqldbal_db *replica;
+
+  replica = NULL;
+  if(db->num_replicas &&
+     db->transaction == 0 &&
+     db->pipeline == 0 &&
+     sqldbal_sql_is_read_only(sql, sql_len)){
+    replica = sqldbal_replica_select(db);
+  }
+  if(replica){
+    sqldbal_stmt_prepare_db(replica, sql, sql_len, stmt);
+    if(sqldbal_status_code_get(replica) != SQLDBAL_STATUS_OK){
+      sqldbal_stmt_close(*stmt);
+      sqldbal_replica_check_failure(replica);
+      sqldbal_status_code_clear(replica);
+      replica = NULL;
+    }
+  }
+  if(replica == NULL){
+    sqldbal_stmt_prepare_db(db, sql, sql_len, stmt);
+  }
+  return sqldbal_status_code_get(replica ? replica : db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_set_cursor(struct sqldbal_stmt *const stmt,
+                        size_t prefetch_rows){
+  if(stmt != &g_stmt_error){
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_cursor(stmt, prefetch_rows);
+    if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      stmt->cursor_prefetch = prefetch_rows;
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_set_result_cache(struct sqldbal_stmt *const stmt,
+                              int enable){
+  struct sqldbal_result_param *param_list;
+
+  if(stmt == &g_stmt_error){
+    /* The failed prepare already set the status code. */
+  }
+  else if(enable == 0){
+    sqldbal_result_stmt_clear(stmt);
+    sqldbal_result_param_free(stmt);
+  }
+  else if(stmt->result_sql == NULL){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else if(stmt->result_param_list == NULL){
+    param_list = calloc(stmt->num_params ? stmt->num_params : 1,
+                        sizeof(*param_list));
+    if(param_list == NULL){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      stmt->result_param_list = param_list;
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+/**
+ * Ensures the bind index provided by the application stays within bounds.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Column index.
+ * @retval 1 Column index is valid.
+ * @retval 0 Column index is not valid.
+ */
+static int
+sqldbal_stmt_bind_in_range(const struct sqldbal_stmt *const stmt,
+                           size_t col_idx){
+  int rc;
+
+  rc = 1;
+  if(col_idx >= stmt->num_params){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+    rc = 0;
+  }
+  return rc;
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_blob(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       const void *const blob,
+                       size_t blobsz){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    sqldbal_stmt_metrics_bind(stmt, blobsz);
+    sqldbal_result_bind(stmt, col_idx, SQLDBAL_TYPE_BLOB, blob, blobsz, 0);
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_blob(stmt,
+                                                           col_idx,
+                                                           blob,
+                                                           blobsz);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_int64(struct sqldbal_stmt *const stmt,
+                        size_t col_idx,
+                        int64_t i64){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    sqldbal_result_bind(stmt,
+                        col_idx,
+                        SQLDBAL_TYPE_INT,
+                        &i64,
+                        sizeof(i64),
+                        0);
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_int64(stmt, col_idx, i64);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_text(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       const char *const s,
+                       size_t slen){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    if(slen == (size_t)-1){
+      slen = strlen(s);
+    }
+    sqldbal_stmt_metrics_bind(stmt, slen);
+    sqldbal_result_bind(stmt, col_idx, SQLDBAL_TYPE_TEXT, s, slen, 0);
+
+    /* Add one more byte to include null-terminator character. */
+    if(si_add_size_t(slen, 1, &slen)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_text(stmt,
+                                                             col_idx,
+                                                             s,
+                                                             slen);
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_blob_static(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              const void *const blob,
+                              size_t blobsz){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    sqldbal_stmt_metrics_bind(stmt, blobsz);
+    sqldbal_result_bind(stmt, col_idx, SQLDBAL_TYPE_BLOB, blob, blobsz, 1);
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_blob_static(stmt,
+                                                                  col_idx,
+                                                                  blob,
+                                                                  blobsz);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_text_static(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              const char *const s,
+                              size_t slen){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    if(slen == (size_t)-1){
+      slen = strlen(s);
+    }
+    sqldbal_stmt_metrics_bind(stmt, slen);
+    sqldbal_result_bind(stmt, col_idx, SQLDBAL_TYPE_TEXT, s, slen, 1);
+
+    /* Add one more byte to include null-terminator character. */
+    if(si_add_size_t(slen, 1, &slen)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_text_static(stmt,
+                                                                    col_idx,
+                                                                    s,
+                                                                    slen);
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_double(struct sqldbal_stmt *const stmt,
+                         size_t col_idx,
+                         double d){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    sqldbal_result_bind(stmt, col_idx, SQLDBAL_TYPE_DOUBLE, &d, sizeof(d), 0);
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_double(stmt, col_idx, d);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_int32(struct sqldbal_stmt *const stmt,
+                        size_t col_idx,
+                        int32_t i32){
+  return sqldbal_stmt_bind_int64(stmt, col_idx, i32);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_bool(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       int b){
+  return sqldbal_stmt_bind_int64(stmt, col_idx, b != 0);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_timestamp(struct sqldbal_stmt *const stmt,
+                            size_t col_idx,
+                            int64_t ts){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    sqldbal_result_bind(stmt,
+                        col_idx,
+                        SQLDBAL_TYPE_TIMESTAMP,
+                        &ts,
+                        sizeof(ts),
+                        0);
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_timestamp(stmt,
+                                                                col_idx,
+                                                                ts);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_null(struct sqldbal_stmt *const stmt,
+                       size_t col_idx){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    sqldbal_result_bind(stmt, col_idx, SQLDBAL_TYPE_NULL, NULL, 0, 0);
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_null(stmt, col_idx);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_bind_blob_stream(struct sqldbal_stmt *const stmt,
+                              size_t col_idx){
+  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    if(stmt->result_param_list){
+      /* The cache key can not include bytes sent after the bind. */
+      stmt->result_param_list[col_idx].cacheable = 0;
+    }
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_bind_blob_stream(stmt,
+                                                                  col_idx);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_send_blob(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       const void *const chunk,
+                       size_t chunksz){
+  if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK &&
+     sqldbal_stmt_bind_in_range(stmt, col_idx)){
+    sqldbal_stmt_metrics_bind(stmt, chunksz);
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_send_blob(stmt,
+                                                           col_idx,
+                                                           chunk,
+                                                           chunksz);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_execute(struct sqldbal_stmt *const stmt){
+  struct sqldbal_metrics metrics;
+  uint64_t start_ns;
+  char *param;
+  size_t param_len;
+  int cacheable;
+  int measure;
+
+  sqldbal_stmt_metrics_flush(stmt);
+  sqldbal_result_stmt_clear(stmt);
+  stmt->fetch_pending = 0;
+  stmt->fetch_done    = 0;
+  cacheable = sqldbal_result_stmt_cacheable(stmt, &param, &param_len);
+  if(cacheable){
+    stmt->result_entry = sqldbal_result_cache_get(stmt->db,
+                                                  stmt->result_sql,
+                                                  stmt->result_sql_len,
+                                                  param,
+                                                  param_len,
+                                                  0);
+  }
+
+  if(stmt->result_entry){
+    stmt->result_entry->num_refs += 1;
+  }
+  else{
+    measure = sqldbal_metrics_start(stmt->db,
+                                    SQLDBAL_METRICS_EXECUTE,
+                                    &metrics);
+    start_ns = 0;
+    if(stmt->db->replica){
+      start_ns = sqldbal_time_ns();
+    }
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_execute(stmt);
+    if(stmt->db->replica){
+      sqldbal_replica_measure(stmt->db, start_ns);
+    }
+    if(measure){
+      metrics.sql_hash  = stmt->metrics_hash;
+      metrics.num_bytes = stmt->metrics_bind_bytes;
+      sqldbal_metrics_end(stmt->db, &metrics);
+      sqldbal_metrics_trace(stmt->db,
+                            &metrics,
+                            stmt->trace_sql,
+                            stmt->trace_sql_len);
+    }
+    if(cacheable &&
+       stmt->num_cols_result &&
+       sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      stmt->result_capture = sqldbal_result_entry_new(stmt->result_sql,
+                                                      stmt->result_sql_len,
+                                                      param,
+                                                      param_len,
+                                                      0);
+      if(stmt->result_capture){
+        stmt->result_capture->num_cols = stmt->num_cols_result;
+      }
+    }
+  }
+  free(param);
+  stmt->metrics_bind_bytes = 0;
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_execute_batch(struct sqldbal_stmt *const stmt,
+                           const struct sqldbal_batch_param *const param_list,
+                           size_t num_rows){
+  struct sqldbal_metrics metrics;
+  const struct sqldbal_batch_param *param;
+  size_t i;
+  int measure;
+
+  sqldbal_stmt_metrics_flush(stmt);
+  sqldbal_result_stmt_clear(stmt);
+  measure = sqldbal_metrics_start(stmt->db, SQLDBAL_METRICS_EXECUTE, &metrics);
+  for(i = 0; i < stmt->num_params; i++){
+    param = &param_list[i];
+    if((param->type == SQLDBAL_TYPE_INT  && param->i64_list  == NULL) ||
+       (param->type == SQLDBAL_TYPE_TEXT && param->text_list == NULL) ||
+       (param->type == SQLDBAL_TYPE_BLOB && (param->blob_list   == NULL ||
+                                             param->length_list == NULL)) ||
+       (param->type != SQLDBAL_TYPE_INT  &&
+        param->type != SQLDBAL_TYPE_TEXT &&
+        param->type != SQLDBAL_TYPE_BLOB &&
+        param->type != SQLDBAL_TYPE_NULL)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+      break;
+    }
+  }
+
+  if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK && num_rows){
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_execute_batch(stmt,
+                                                               param_list,
+                                                               num_rows);
+  }
+  if(measure){
+    metrics.sql_hash = stmt->metrics_hash;
+    metrics.num_rows = num_rows;
+    sqldbal_metrics_end(stmt->db, &metrics);
+    sqldbal_metrics_trace(stmt->db,
+                          &metrics,
+                          stmt->trace_sql,
+                          stmt->trace_sql_len);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_execute_start(struct sqldbal_stmt *const stmt){
+  if(stmt->async_pending || stmt->db->pipeline){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    sqldbal_stmt_metrics_flush(stmt);
+    sqldbal_result_stmt_clear(stmt);
+    stmt->metrics_start_ns = 0;
+    if(stmt->db->metrics_fp || SQLDBAL_TRACE_DISPATCH(stmt->db)){
+      stmt->metrics_start_ns = sqldbal_time_ns();
+    }
+    stmt->fetch_pending = 0;
+    stmt->fetch_done    = 0;
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_execute_start(stmt);
+    if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      stmt->async_pending = 1;
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_execute_poll(struct sqldbal_stmt *const stmt,
+                          int *const wait_events){
+  *wait_events = 0;
+  if(stmt->async_pending == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_execute_poll(stmt,
+                                                              wait_events);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+/**
+ * Block until the socket becomes ready for one of the requested events.
+ *
+ * @param[in] db          See @ref sqldbal_db.
+ * @param[in] fd          Socket descriptor.
+ * @param[in] wait_events See @ref sqldbal_wait_event.
+ */
+static void
+sqldbal_socket_wait(struct sqldbal_db *const db,
+                    int fd,
+                    int wait_events){
+  struct pollfd pfd;
+  int events;
+  int rc;
+
+  events = 0;
+  if(wait_events & SQLDBAL_WAIT_READ){
+    events |= POLLIN;
+  }
+  if(wait_events & SQLDBAL_WAIT_WRITE){
+    events |= POLLOUT;
+  }
+  pfd.events = (short)events;
+  pfd.revents = 0;
+#ifdef SQLDBAL_IS_WINDOWS
+  pfd.fd = (SOCKET)fd;
+  rc = WSAPoll(&pfd, 1, -1);
+#else /* POSIX */
+  pfd.fd = fd;
+  rc = poll(&pfd, 1, -1);
+#endif /* SQLDBAL_IS_WINDOWS */
+  if(rc < 0 && errno != EINTR){
+    sqldbal_status_code_set(db, SQLDBAL_STATUS_EXEC);
+  }
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_execute_finish(struct sqldbal_stmt *const stmt){
+  struct sqldbal_metrics metrics;
+  int wait_events;
+  int fd;
+
+  if(stmt->async_pending == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+  }
+  else{
+    fd = -1;
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_socket_fd(stmt->db, &fd);
+    do{
+      wait_events = 0;
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_execute_poll(stmt,
+                                                                &wait_events);
+      if(wait_events && sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+        sqldbal_socket_wait(stmt->db, fd, wait_events);
+      }
+    } while(wait_events &&
+            sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK);
+    stmt->async_pending = 0;
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_execute_finish(stmt);
+    if(stmt->metrics_start_ns &&
+       sqldbal_metrics_start(stmt->db, SQLDBAL_METRICS_EXECUTE, &metrics)){
+      /* Measure from the time the statement got sent. */
+      metrics.elapsed_ns = stmt->metrics_start_ns;
+      metrics.sql_hash   = stmt->metrics_hash;
+      metrics.num_bytes  = stmt->metrics_bind_bytes;
+      sqldbal_metrics_end(stmt->db, &metrics);
+      sqldbal_metrics_trace(stmt->db,
+                            &metrics,
+                            stmt->trace_sql,
+                            stmt->trace_sql_len);
+    }
+    stmt->metrics_bind_bytes = 0;
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+/**
+ * Get the next row while adding the time spent to
+ * @ref sqldbal_stmt::metrics_fetch.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return See @ref sqldbal_fetch_result.
+ */
+static enum sqldbal_fetch_result
+sqldbal_stmt_fetch_measure(struct sqldbal_stmt *const stmt){
+  struct sqldbal_metrics *metrics;
+  enum sqldbal_fetch_result fetch_result;
+  uint64_t start_ns;
+  uint64_t num_retries;
+
+  metrics = &stmt->metrics_fetch;
+  if(stmt->metrics_fetch_active == 0){
+    sqldbal_metrics_start(stmt->db, SQLDBAL_METRICS_FETCH, metrics);
+    metrics->sql_hash    = stmt->metrics_hash;
+    metrics->elapsed_ns  = 0;
+    metrics->num_retries = 0;
+    stmt->metrics_fetch_active = 1;
+  }
+
+  num_retries = stmt->db->busy.num_retries;
+  start_ns = sqldbal_time_ns();
+  fetch_result = SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_fetch(stmt);
+  metrics->elapsed_ns  += sqldbal_time_ns() - start_ns;
+  metrics->num_retries += stmt->db->busy.num_retries - num_retries;
+  if(fetch_result == SQLDBAL_FETCH_ROW){
+    metrics->num_rows += 1;
+  }
+  else{
+    sqldbal_stmt_metrics_flush(stmt);
+  }
+  return fetch_result;
+}
+
+enum sqldbal_fetch_result
+sqldbal_stmt_fetch(struct sqldbal_stmt *const stmt){
+  enum sqldbal_fetch_result fetch_result;
+
+  if(stmt->fetch_pending){
+    stmt->fetch_pending = 0;
+    fetch_result = SQLDBAL_FETCH_ROW;
+  }
+  else if(stmt->fetch_done){
+    fetch_result = SQLDBAL_FETCH_DONE;
+  }
+  else if(stmt->result_entry){
+    fetch_result = sqldbal_result_fetch(stmt);
+  }
+  else{
+    if(stmt->db->metrics_fp){
+      fetch_result = sqldbal_stmt_fetch_measure(stmt);
+    }
+    else{
+      fetch_result = SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_fetch(stmt);
+    }
+    if(stmt->result_capture){
+      sqldbal_result_capture(stmt, fetch_result);
+    }
+  }
+  return fetch_result;
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_num_rows(struct sqldbal_stmt *const stmt,
+                      uint64_t *num_rows){
+  *num_rows = 0;
+  if(stmt->result_entry){
+    *num_rows = stmt->result_entry->num_rows;
+  }
+  else if(stmt != &g_stmt_error){
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_num_rows(stmt, num_rows);
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_seek(struct sqldbal_stmt *const stmt,
+                  uint64_t row){
+  if(stmt->result_entry){
+    if(row > stmt->result_entry->num_rows){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+    }
+    else{
+      stmt->result_row = (size_t)row;
+      stmt->fetch_pending = 0;
+      stmt->fetch_done    = 0;
+    }
+  }
+  else if(stmt != &g_stmt_error){
+    if(stmt->result_capture){
+      sqldbal_result_entry_release(stmt->result_capture);
+      stmt->result_capture = NULL;
+    }
+    SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_seek(stmt, row);
+    if(sqldbal_status_code_get(stmt->db) == SQLDBAL_STATUS_OK){
+      stmt->fetch_pending = 0;
+      stmt->fetch_done    = 0;
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+/**
+ * Ensures the column index provided by the application stays within bounds.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Column index.
+ * @retval 0 Column index not valid.
+ * @retval 1 Column index valid.
+ */
+static int
+sqldbal_stmt_column_in_range(const struct sqldbal_stmt *const stmt,
+                             size_t col_idx){
+  int rc;
+
+  rc = 1;
+  if(col_idx >= stmt->num_cols_result){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+    rc = 0;
+  }
+  return rc;
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_blob(struct sqldbal_stmt *const stmt,
+                         size_t col_idx,
+                         const void **blob,
+                         size_t *blobsz){
+  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
+    if(stmt->result_entry){
+      sqldbal_result_column_blob(stmt, col_idx, blob, blobsz);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_column_blob(stmt,
+                                                               col_idx,
+                                                               blob,
+                                                               blobsz);
+    }
+    if(stmt->metrics_fetch_active){
+      stmt->metrics_fetch.num_bytes += *blobsz;
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_blob_read(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              uint64_t offset,
+                              void *const buf,
+                              size_t bufsz,
+                              size_t *const len){
+  const void *blob;
+  size_t blobsz;
+
+  *len = 0;
+  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
+    if(stmt->result_entry){
+      sqldbal_result_column_blob(stmt, col_idx, &blob, &blobsz);
+      sqldbal_blob_copy(blob, blobsz, offset, buf, bufsz, len);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_column_blob_read(stmt,
+                                                                    col_idx,
+                                                                    offset,
+                                                                    buf,
+                                                                    bufsz,
+                                                                    len);
+    }
+    if(stmt->metrics_fetch_active){
+      stmt->metrics_fetch.num_bytes += *len;
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_int64(struct sqldbal_stmt *const stmt,
+                          size_t col_idx,
+                          int64_t *i64){
+  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
+    if(stmt->result_entry){
+      sqldbal_result_column_int64(stmt, col_idx, i64);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_column_int64(stmt,
+                                                                col_idx,
+                                                                i64);
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_text(struct sqldbal_stmt *const stmt,
+                         size_t col_idx,
+                         const char **text,
+                         size_t *textsz){
+  size_t text_len;
+
+  text_len = 0;
+  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
+    if(stmt->result_entry){
+      sqldbal_result_column_text(stmt, col_idx, text, &text_len);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_column_text(stmt,
+                                                               col_idx,
+                                                               text,
+                                                               &text_len);
+    }
+    if(textsz){
+      *textsz = text_len;
+    }
+    if(stmt->metrics_fetch_active){
+      stmt->metrics_fetch.num_bytes += text_len;
+    }
+  }
+
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_double(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           double *d){
+  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
+    if(stmt->result_entry){
+      sqldbal_result_column_double(stmt, col_idx, d);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_column_double(stmt,
+                                                                 col_idx,
+                                                                 d);
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_int32(struct sqldbal_stmt *const stmt,
+                          size_t col_idx,
+                          int32_t *i32){
+  int64_t i64;
+
+  i64 = 0;
+  if(sqldbal_stmt_column_int64(stmt, col_idx, &i64) == SQLDBAL_STATUS_OK &&
+     (i64 > INT32_MAX || i64 < INT32_MIN)){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_COLUMN_COERCE);
+    i64 = 0;
+  }
+  *i32 = (int32_t)i64;
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_bool(struct sqldbal_stmt *const stmt,
+                         size_t col_idx,
+                         int *b){
+  int64_t i64;
+
+  i64 = 0;
+  sqldbal_stmt_column_int64(stmt, col_idx, &i64);
+  *b = i64 != 0;
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_column_timestamp(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              int64_t *ts){
+  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
+    if(stmt->result_entry){
+      sqldbal_result_column_timestamp(stmt, col_idx, ts);
+    }
+    else{
+      SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_column_timestamp(stmt,
+                                                                    col_idx,
+                                                                    ts);
+    }
+  }
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_column_type
+sqldbal_stmt_column_type(struct sqldbal_stmt *const stmt,
+                         size_t col_idx){
+  enum sqldbal_column_type type;
+
+  if(stmt->result_entry && sqldbal_stmt_column_in_range(stmt, col_idx)){
+    type = sqldbal_result_column_type(stmt, col_idx);
+  }
+  else if(sqldbal_stmt_column_in_range(stmt, col_idx)){
+    type = SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_column_type(stmt,
+                                                                    col_idx);
+  }
+  else{
+    type = SQLDBAL_TYPE_ERROR;
+  }
+  return type;
+}
+
+/**
+ * Check that a column vector passed to @ref sqldbal_stmt_fetch_columns has
+ * a supported data type and the buffers needed for it.
+ *
+ * @param[in] vector See @ref sqldbal_column_vector.
+ * @retval 1 Column vector valid.
+ * @retval 0 Column vector not valid.
+ */
+static int
+sqldbal_column_vector_valid(const struct sqldbal_column_vector *const vector){
+  int valid;
+
+  switch(vector->type){
+    case SQLDBAL_TYPE_INT:
+    case SQLDBAL_TYPE_BOOL:
+    case SQLDBAL_TYPE_TIMESTAMP:
+      valid = vector->i64_list != NULL;
+      break;
+    case SQLDBAL_TYPE_DOUBLE:
+      valid = vector->d_list != NULL;
+      break;
+    case SQLDBAL_TYPE_TEXT:
+    case SQLDBAL_TYPE_BLOB:
+      valid = vector->offset_list != NULL &&
+              (vector->data != NULL || vector->data_size == 0);
+      break;
+    case SQLDBAL_TYPE_ERROR:
+    case SQLDBAL_TYPE_NULL:
+    case SQLDBAL_TYPE_OTHER:
+    default:
+      valid = 0;
+      break;
+  }
+  return valid;
+}
+
+/**
+ * Copy the current row into one entry of each column vector.
+ *
+ * This calls the driver functions directly because
+ * @ref sqldbal_stmt_fetch_columns has already checked the column vectors
+ * against the statement result.
+ *
+ * @param[in] stmt        See @ref sqldbal_stmt.
+ * @param[in] vector_list One entry for each column in the result.
+ * @param[in] row_idx     Index of the entry to set in each column vector.
+ * @retval  1 Row copied.
+ * @retval  0 A text or blob value did not fit in the remaining space of
+ *            its data buffer.
+ * @retval -1 Error occurred.
+ */
+static int
+sqldbal_stmt_fetch_columns_row(struct sqldbal_stmt *const stmt,
+                               struct sqldbal_column_vector *const vector_list,
+                               size_t row_idx){
+  struct sqldbal_driver_functions result_func;
+  const struct sqldbal_driver_functions *func;
+  struct sqldbal_column_vector *vector;
+  enum sqldbal_column_type type;
+  const void *blob;
+  const char *text;
+  size_t col_idx;
+  size_t offset;
+  size_t len;
+  int64_t i64;
+  unsigned char bit;
+  int rc;
+
+  func = SQLDBAL_FUNCTIONS(stmt->db);
+  if(stmt->result_entry){
+    /* Read the columns below from the cached result instead. */
+    result_func = *func;
+    result_func.sqldbal_fp_stmt_column_type = sqldbal_result_column_type;
+    result_func.sqldbal_fp_stmt_column_text = sqldbal_result_column_text;
+    result_func.sqldbal_fp_stmt_column_blob = sqldbal_result_column_blob;
+    result_func.sqldbal_fp_stmt_column_double = sqldbal_result_column_double;
+    result_func.sqldbal_fp_stmt_column_timestamp =
+      sqldbal_result_column_timestamp;
+    result_func.sqldbal_fp_stmt_column_int64 = sqldbal_result_column_int64;
+    func = &result_func;
+  }
+  bit = (unsigned char)(1u << (row_idx % 8));
+  rc = 1;
+  for(col_idx = 0; col_idx < stmt->num_cols_result && rc == 1; col_idx++){
+    vector = &vector_list[col_idx];
+    type = func->sqldbal_fp_stmt_column_type(stmt, col_idx);
+    if(vector->validity_bitmap){
+      if(type == SQLDBAL_TYPE_NULL){
+        vector->validity_bitmap[row_idx / 8] &= (unsigned char)~bit;
+      }
+      else{
+        vector->validity_bitmap[row_idx / 8] |= bit;
+      }
+    }
+
+    if(type == SQLDBAL_TYPE_ERROR){
+      rc = -1;
+    }
+    else if(vector->type == SQLDBAL_TYPE_TEXT ||
+            vector->type == SQLDBAL_TYPE_BLOB){
+      blob = NULL;
+      len = 0;
+      if(type == SQLDBAL_TYPE_NULL){
+        /* Empty value. */
+      }
+      else if(vector->type == SQLDBAL_TYPE_TEXT){
+        func->sqldbal_fp_stmt_column_text(stmt, col_idx, &text, &len);
+        blob = text;
+      }
+      else{
+        func->sqldbal_fp_stmt_column_blob(stmt, col_idx, &blob, &len);
+      }
+      /* The offsets stay below INT32_MAX as required by the Arrow format. */
+      offset = (size_t)vector->offset_list[row_idx];
+      if(len > vector->data_size - offset ||
+         len > (size_t)INT32_MAX - offset){
+        rc = 0;
+      }
+      else{
+        if(len){
+          memcpy((unsigned char *)vector->data + offset, blob, len);
+        }
+        vector->offset_list[row_idx + 1] = (int32_t)(offset + len);
+        if(stmt->metrics_fetch_active){
+          stmt->metrics_fetch.num_bytes += len;
+        }
+      }
+    }
+    else if(type == SQLDBAL_TYPE_NULL){
+      if(vector->type == SQLDBAL_TYPE_DOUBLE){
+        vector->d_list[row_idx] = 0;
+      }
+      else{
+        vector->i64_list[row_idx] = 0;
+      }
+    }
+    else if(vector->type == SQLDBAL_TYPE_DOUBLE){
+      func->sqldbal_fp_stmt_column_double(stmt,
+                                          col_idx,
+                                          &vector->d_list[row_idx]);
+    }
+    else if(vector->type == SQLDBAL_TYPE_TIMESTAMP){
+      func->sqldbal_fp_stmt_column_timestamp(stmt,
+                                             col_idx,
+                                             &vector->i64_list[row_idx]);
+    }
+    else{
+      i64 = 0;
+      func->sqldbal_fp_stmt_column_int64(stmt, col_idx, &i64);
+      if(vector->type == SQLDBAL_TYPE_BOOL){
+        i64 = i64 != 0;
+      }
+      vector->i64_list[row_idx] = i64;
+    }
+  }
+  if(sqldbal_status_code_get(stmt->db) != SQLDBAL_STATUS_OK){
+    rc = -1;
+  }
+  return rc;
+}
+
+enum sqldbal_fetch_result
+sqldbal_stmt_fetch_columns(struct sqldbal_stmt *const stmt,
+                           size_t max_rows,
+                           struct sqldbal_column_vector *const vector_list,
+                           size_t *const num_rows){
+  enum sqldbal_fetch_result fetch_result;
+  struct sqldbal_column_vector *vector;
+  size_t col_idx;
+  size_t row_idx;
+  int rc;
+
+  *num_rows = 0;
+  fetch_result = SQLDBAL_FETCH_ROW;
+  if(max_rows == 0){
+    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+    fetch_result = SQLDBAL_FETCH_ERROR;
+  }
+  for(col_idx = 0; col_idx < stmt->num_cols_result; col_idx++){
+    vector = &vector_list[col_idx];
+    vector->null_count = 0;
+    if(!sqldbal_column_vector_valid(vector)){
+      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
+      fetch_result = SQLDBAL_FETCH_ERROR;
+    }
+    else if(vector->offset_list){
+      vector->offset_list[0] = 0;
+    }
+  }
+
+  row_idx = 0;
+  while(fetch_result == SQLDBAL_FETCH_ROW && row_idx < max_rows){
+    fetch_result = sqldbal_stmt_fetch(stmt);
+    if(fetch_result == SQLDBAL_FETCH_DONE){
+      stmt->fetch_done = 1;
+    }
+    else if(fetch_result == SQLDBAL_FETCH_ROW){
+      rc = sqldbal_stmt_fetch_columns_row(stmt, vector_list, row_idx);
+      if(rc == 1){
+        row_idx += 1;
+      }
+      else if(rc == 0 && row_idx > 0){
+        /* Return this row first on the next call. */
+        stmt->fetch_pending = 1;
+        break;
+      }
+      else{
+        if(rc == 0){
+          sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_OVERFLOW);
+        }
+        fetch_result = SQLDBAL_FETCH_ERROR;
+      }
+    }
+  }
+
+  if(fetch_result != SQLDBAL_FETCH_ERROR){
+    *num_rows = row_idx;
+    if(row_idx > 0){
+      fetch_result = SQLDBAL_FETCH_ROW;
+    }
+    for(col_idx = 0; col_idx < stmt->num_cols_result; col_idx++){
+      vector = &vector_list[col_idx];
+      if(vector->validity_bitmap){
+        for(row_idx = 0; row_idx < *num_rows; row_idx++){
+          if(((vector->validity_bitmap[row_idx / 8] >> (row_idx % 8)) & 1) ==
+             0){
+            vector->null_count += 1;
+          }
+        }
+      }
+    }
+  }
+  return fetch_result;
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_reset(struct sqldbal_stmt *const stmt){
+  if(stmt->async_pending){
+    sqldbal_stmt_execute_finish(stmt);
+  }
+  sqldbal_stmt_metrics_flush(stmt);
+  sqldbal_result_stmt_clear(stmt);
+  sqldbal_result_param_reset(stmt);
+  SQLDBAL_FUNCTIONS(stmt->db)->sqldbal_fp_stmt_reset(stmt);
+  return sqldbal_status_code_get(stmt->db);
+}
+
+enum sqldbal_status_code
+sqldbal_stmt_close(struct sqldbal_stmt *const stmt){
+  struct sqldbal_db *db;
+
+  db = stmt->db;
+  if(stmt != &g_stmt_error){
+    if(db->replica){
+      db->replica->num_outstanding -= 1;
+    }
+    if(stmt->async_pending){
+      sqldbal_stmt_execute_finish(stmt);
+    }
+    sqldbal_stmt_metrics_flush(stmt);
+    sqldbal_result_stmt_clear(stmt);
+    if(stmt->cache_sql &&
+       db->stmt_cache.capacity &&
+       sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+      SQLDBAL_FUNCTIONS(db)->sqldbal_fp_stmt_reset(stmt);
+      if(stmt->cursor_prefetch){
+        sqldbal_stmt_set_cursor(stmt, 0);
+      }
+      sqldbal_result_param_free(stmt);
+      if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+        sqldbal_stmt_cache_put(db, stmt);
+      }
+      else{
+        sqldbal_stmt_free(stmt);
+      }
+    }
+    else{
+      sqldbal_stmt_free(stmt);
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+
+#ifdef SQLDBAL_TRACE
+/**
+ * Drain the trace every @ref sqldbal_trace::flush_interval_ms until
+ * @ref sqldbal_trace_close sets @ref sqldbal_trace::stop.
+ *
+ * @param[in] arg See @ref sqldbal_trace.
+ * @return        Unused.
+ */
+#ifdef SQLDBAL_IS_WINDOWS
+static DWORD WINAPI
+sqldbal_trace_thread(LPVOID arg){
+#else /* POSIX */
+static void *
+sqldbal_trace_thread(void *arg){
+#endif /* SQLDBAL_IS_WINDOWS */
+  struct sqldbal_trace *trace;
+  long wait_ms;
+#ifndef SQLDBAL_IS_WINDOWS
+  struct timespec abstime;
+#endif /* !(SQLDBAL_IS_WINDOWS) */
+
+  trace = arg;
+  wait_ms = trace->flush_interval_ms;
+#ifdef SQLDBAL_IS_WINDOWS
+  EnterCriticalSection(&trace->thread_mutex);
+  while(trace->stop == 0){
+    SleepConditionVariableCS(&trace->thread_cond,
+                             &trace->thread_mutex,
+                             (DWORD)wait_ms);
+    LeaveCriticalSection(&trace->thread_mutex);
+    sqldbal_trace_drain(trace);
+    EnterCriticalSection(&trace->thread_mutex);
+  }
+  LeaveCriticalSection(&trace->thread_mutex);
+  return 0;
+#else /* POSIX */
+  pthread_mutex_lock(&trace->thread_mutex);
+  while(trace->stop == 0){
+    abstime.tv_sec = 0;
+    abstime.tv_nsec = 0;
+    clock_gettime(CLOCK_REALTIME, &abstime);
+    abstime.tv_sec += wait_ms / 1000;
+    abstime.tv_nsec += (wait_ms % 1000) * 1000000;
+    if(abstime.tv_nsec >= 1000000000){
+      abstime.tv_sec += 1;
+      abstime.tv_nsec -= 1000000000;
+    }
+    pthread_cond_timedwait(&trace->thread_cond,
+                           &trace->thread_mutex,
+                           &abstime);
+    pthread_mutex_unlock(&trace->thread_mutex);
+    sqldbal_trace_drain(trace);
+    pthread_mutex_lock(&trace->thread_mutex);
+  }
+  pthread_mutex_unlock(&trace->thread_mutex);
+  return NULL;
+#endif /* SQLDBAL_IS_WINDOWS */
+}
+
+/**
+ * Initialize the trace mutexes and condition variable.
+ *
+ * @param[in] trace See @ref sqldbal_trace.
+ * @retval  0 Success.
+ * @retval -1 Failed to initialize the synchronization objects.
+ */
+static int
+sqldbal_trace_sync_init(struct sqldbal_trace *const trace){
+  int rc;
+
+  rc = 0;
+#ifdef SQLDBAL_IS_WINDOWS
+  InitializeCriticalSection(&trace->drain_mutex);
+  InitializeCriticalSection(&trace->thread_mutex);
+  InitializeConditionVariable(&trace->thread_cond);
+#else /* POSIX */
+  if(pthread_mutex_init(&trace->drain_mutex, NULL) != 0){
+    rc = -1;
+  }
+  else if(pthread_mutex_init(&trace->thread_mutex, NULL) != 0){
+    pthread_mutex_destroy(&trace->drain_mutex);
+    rc = -1;
+  }
+  else if(pthread_cond_init(&trace->thread_cond, NULL) != 0){
+    pthread_mutex_destroy(&trace->thread_mutex);
+    pthread_mutex_destroy(&trace->drain_mutex);
+    rc = -1;
+  }
+#endif /* SQLDBAL_IS_WINDOWS */
+  return rc;
+}
+
+/**
+ * Free the trace mutexes and condition variable.
+ *
+ * @param[in] trace See @ref sqldbal_trace.
+ */
+static void
+sqldbal_trace_sync_destroy(struct sqldbal_trace *const trace){
+#ifdef SQLDBAL_IS_WINDOWS
+  DeleteCriticalSection(&trace->thread_mutex);
+  DeleteCriticalSection(&trace->drain_mutex);
+#else /* POSIX */
+  pthread_cond_destroy(&trace->thread_cond);
+  pthread_mutex_destroy(&trace->thread_mutex);
+  pthread_mutex_destroy(&trace->drain_mutex);
+#endif /* SQLDBAL_IS_WINDOWS */
+}
+
+/**
+ * Start the background thread that drains the trace.
+ *
+ * @param[in] trace See @ref sqldbal_trace.
+ * @retval  0 Started the thread.
+ * @retval -1 Failed to start the thread.
+ */
+static int
+sqldbal_trace_thread_start(struct sqldbal_trace *const trace){
+  int rc;
+
+  rc = 0;
+#ifdef SQLDBAL_IS_WINDOWS
+  trace->thread = CreateThread(NULL, 0, sqldbal_trace_thread, trace, 0, NULL);
+  if(trace->thread == NULL){
+    rc = -1;
+  }
+#else /* POSIX */
+  if(pthread_create(&trace->thread, NULL, sqldbal_trace_thread, trace) != 0){
+    rc = -1;
+  }
+#endif /* SQLDBAL_IS_WINDOWS */
+  if(rc == 0){
+    trace->has_thread = 1;
+  }
+  return rc;
+}
+
+enum sqldbal_status_code
+sqldbal_trace_open(size_t num_entries,
+                   uint64_t slow_ns,
+                   double sample_rate,
+                   sqldbal_trace_fp callback,
+                   void *user_data,
+                   long flush_interval_ms,
+                   struct sqldbal_trace **trace){
+  enum sqldbal_status_code status;
+  struct sqldbal_trace *new_trace;
+  size_t num_slots;
+  size_t i;
+
+  *trace = NULL;
+
+  /*
+   * A single slot would look free again to the next writer as soon as
+   * the previous entry got published.
+   */
+  num_slots = 2;
+  while(num_slots < num_entries && num_slots <= SIZE_MAX / 2){
+    num_slots *= 2;
+  }
+  if(callback == NULL ||
+     num_entries == 0 ||
+     num_slots < num_entries ||
+     flush_interval_ms == 0 ||
+     !(sample_rate >= 0 && sample_rate <= 1)){
+    status = SQLDBAL_STATUS_PARAM;
+  }
+  else{
+    status = SQLDBAL_STATUS_NOMEM;
+    new_trace = malloc(sizeof(*new_trace));
+    if(new_trace){
+      new_trace->slot_list = calloc(num_slots, sizeof(*new_trace->slot_list));
+      if(new_trace->slot_list == NULL){
+        free(new_trace);
+      }
+      else if(sqldbal_trace_sync_init(new_trace) < 0){
+        free(new_trace->slot_list);
+        free(new_trace);
+      }
+      else{
+        for(i = 0; i < num_slots; i++){
+          new_trace->slot_list[i].seq = i;
+        }
+        new_trace->mask              = num_slots - 1;
+        new_trace->head              = 0;
+        new_trace->tail              = 0;
+        new_trace->slow_ns           = slow_ns;
+        new_trace->sample_threshold  =
+          (uint64_t)(sample_rate * (double)UINT64_C(4294967296));
+        new_trace->num_recorded      = 0;
+        new_trace->num_dropped       = 0;
+        new_trace->callback          = callback;
+        new_trace->user_data         = user_data;
+        new_trace->flush_interval_ms = flush_interval_ms;
+        new_trace->has_thread        = 0;
+        new_trace->stop              = 0;
+        if(flush_interval_ms >= 0 &&
+           sqldbal_trace_thread_start(new_trace) < 0){
+          sqldbal_trace_sync_destroy(new_trace);
+          free(new_trace->slot_list);
+          free(new_trace);
+        }
+        else{
+          *trace = new_trace;
+          status = SQLDBAL_STATUS_OK;
+        }
+      }
+    }
+  }
+  return status;
+}
+
+enum sqldbal_status_code
+sqldbal_trace_attach(struct sqldbal_db *const db,
+                     struct sqldbal_trace *const trace){
+  size_t i;
+
+  if(sqldbal_status_code_get(db) == SQLDBAL_STATUS_OK){
+    db->trace = trace;
+    db->trace_driver = 0;
+#ifdef SQLDBAL_SQLITE
+    /* A lazy connection installs the hook after connecting. */
+    if(db->type == SQLDBAL_DRIVER_SQLITE && db->lazy == NULL){
+      sqldbal_sqlite_trace_set(db);
+    }
+#endif /* SQLDBAL_SQLITE */
+    for(i = 0; i < db->num_replicas; i++){
+      sqldbal_trace_attach(db->replica_list[i], trace);
+    }
+  }
+  return sqldbal_status_code_get(db);
+}
+
+size_t
+sqldbal_trace_drain(struct sqldbal_trace *const trace){
+  struct sqldbal_trace_slot *slot;
+  size_t num_drained;
+  uint64_t pos;
+
+  num_drained = 0;
+#ifdef SQLDBAL_IS_WINDOWS
+  EnterCriticalSection(&trace->drain_mutex);
+#else /* POSIX */
+  pthread_mutex_lock(&trace->drain_mutex);
+#endif /* SQLDBAL_IS_WINDOWS */
+  pos = trace->tail;
+  slot = &trace->slot_list[pos & trace->mask];
+  while(SQLDBAL_ATOMIC_LOAD(&slot->seq) == pos + 1){
+    trace->callback(trace->user_data, &slot->entry);
+
+    /* Hand the slot to the writer one lap ahead. */
+    SQLDBAL_ATOMIC_STORE(&slot->seq, pos + trace->mask + 1);
+    pos += 1;
+    num_drained += 1;
+    slot = &trace->slot_list[pos & trace->mask];
+  }
+  trace->tail = pos;
+#ifdef SQLDBAL_IS_WINDOWS
+  LeaveCriticalSection(&trace->drain_mutex);
+#else /* POSIX */
+  pthread_mutex_unlock(&trace->drain_mutex);
+#endif /* SQLDBAL_IS_WINDOWS */
+  return num_drained;
+}
+
+void
+sqldbal_trace_stats(struct sqldbal_trace *const trace,
+                    uint64_t *const num_recorded,
+                    uint64_t *const num_dropped){
+  *num_recorded = SQLDBAL_ATOMIC_LOAD(&trace->num_recorded);
+  *num_dropped  = SQLDBAL_ATOMIC_LOAD(&trace->num_dropped);
+}
+
+void
+sqldbal_trace_close(struct sqldbal_trace *const trace){
+  if(trace->has_thread){
+#ifdef SQLDBAL_IS_WINDOWS
+    EnterCriticalSection(&trace->thread_mutex);
+    trace->stop = 1;
+    WakeConditionVariable(&trace->thread_cond);
+    LeaveCriticalSection(&trace->thread_mutex);
+    WaitForSingleObject(trace->thread, INFINITE);
+    CloseHandle(trace->thread);
+#else /* POSIX */
+    pthread_mutex_lock(&trace->thread_mutex);
+    trace->stop = 1;
+    pthread_cond_signal(&trace->thread_cond);
+    pthread_mutex_unlock(&trace->thread_mutex);
+    pthread_join(trace->thread, NULL);
+#endif /* SQLDBAL_IS_WINDOWS */
+  }
+  sqldbal_trace_drain(trace);
+  sqldbal_trace_sync_destroy(trace);
+  free(trace->slot_list);
+  free(trace);
+}
+#endif /* SQLDBAL_TRACE */
+
+#ifdef SQLDBAL_POOL
+/**
+ * Connections that stayed idle in the pool for at least this many
+ * milliseconds get checked with @ref sqldbal_ping before
+ * @ref sqldbal_pool_acquire hands them out again.
+ */
+#define SQLDBAL_POOL_HEALTH_CHECK_MS 1000
+
+/**
+ * Idle connection stored in the @ref sqldbal_pool.
+ */
+struct sqldbal_pool_idle{
+  /**
+   * Open database connection.
+   */
+  struct sqldbal_db *db;
+
+  /**
+   * Time in milliseconds when the connection got returned to the pool.
+   *
+   * See @ref sqldbal_time_ms.
+   */
+  uint64_t idle_since_ms;
+};
+
+/**
+ * Pool of database connections shared between multiple threads.
+ */
+struct sqldbal_pool{
+#ifdef SQLDBAL_IS_WINDOWS
+  /**
+   * Protects all of the pool members below.
+   */
+  CRITICAL_SECTION mutex;
+
+  /**
+   * Signals threads waiting in @ref sqldbal_pool_acquire.
+   */
+  CONDITION_VARIABLE cond;
+#else /* POSIX */
+  /**
+   * Protects all of the pool members below.
+   */
+  pthread_mutex_t mutex;
+
+  /**
+   * Signals threads waiting in @ref sqldbal_pool_acquire.
+   */
+  pthread_cond_t cond;
+#endif /* SQLDBAL_IS_WINDOWS */
+
+  /**
+   * Copy of the connection parameters passed to @ref sqldbal_pool_open.
+   */
+  struct sqldbal_params params;
+
+  /**
+   * Stack of idle connections with room for @ref max_size entries.
+   *
+   * The most recently released connection sits at the top of the stack,
+   * and the connection idle for the longest time sits at the bottom.
+   */
+  struct sqldbal_pool_idle *idle_list;
+
+  /**
+   * Number of connections in @ref idle_list.
+   */
+  size_t num_idle;
+
+  /**
+   * Number of open connections, including idle and acquired connections.
+   */
+  size_t num_open;
+
+  /**
+   * Keep at least this many connections open.
+   */
+  size_t min_size;
+
+  /**
+   * Maximum number of connections allowed open at the same time.
+   */
+  size_t max_size;
+
+  /**
+   * Close idle connections after this many milliseconds, or a negative
+   * value to keep idle connections open.
+   */
+  long idle_timeout_ms;
+
+  /**
+   * See @ref sqldbal_flag.
+   */
+  unsigned long flags;
+
+  /**
+   * See @ref sqldbal_driver.
+   */
+  enum sqldbal_driver driver;
+
+#ifdef SQLDBAL_IS_WINDOWS
+  /**
+   * Fiber local storage index holding the @ref sqldbal_pool_thread of
+   * each thread.
+   */
+  DWORD thread_key;
+#else /* POSIX */
+  /**
+   * Thread-specific data key holding the @ref sqldbal_pool_thread of each
+   * thread.
+   */
+  pthread_key_t thread_key;
+#endif /* SQLDBAL_IS_WINDOWS */
+};
+
+/**
+ * Connection assigned to one thread by @ref sqldbal_pool_thread_db.
+ */
+struct sqldbal_pool_thread{
+  /**
+   * Pool that the connection came from.
+   */
+  struct sqldbal_pool *pool;
+
+  /**
+   * Connection acquired for the thread.
+   */
+  struct sqldbal_db *db;
+};
+
+/**
+ * Return the connection of a thread to the pool when the thread exits.
+ *
+ * @param[in] value See @ref sqldbal_pool_thread.
+ */
+#ifdef SQLDBAL_IS_WINDOWS
+static VOID WINAPI
+#else /* POSIX */
+static void
+#endif /* SQLDBAL_IS_WINDOWS */
+sqldbal_pool_thread_exit(void *value){
+  struct sqldbal_pool_thread *thread;
+
+  thread = value;
+  if(thread){
+    sqldbal_pool_release(thread->pool, thread->db);
+    free(thread);
+  }
+}
+
+/**
+ * Initialize the pool mutex, condition variable, and thread key.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ * @retval  0 Success.
+ * @retval -1 Failed to initialize the synchronization objects.
+ */
+static int
+sqldbal_pool_sync_init(struct sqldbal_pool *const pool){
+  int rc;
+
+#ifdef SQLDBAL_IS_WINDOWS
+  rc = 0;
+  pool->thread_key = FlsAlloc(sqldbal_pool_thread_exit);
+  if(pool->thread_key == FLS_OUT_OF_INDEXES){
+    rc = -1;
+  }
+  else{
+    InitializeCriticalSection(&pool->mutex);
+    InitializeConditionVariable(&pool->cond);
+  }
+#else /* POSIX */
+  rc = 0;
+  if(pthread_mutex_init(&pool->mutex, NULL) != 0){
+    rc = -1;
+  }
+  else if(pthread_cond_init(&pool->cond, NULL) != 0){
+    pthread_mutex_destroy(&pool->mutex);
+    rc = -1;
+  }
+  else if(pthread_key_create(&pool->thread_key,
+                             sqldbal_pool_thread_exit) != 0){
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->mutex);
+    rc = -1;
+  }
+#endif /* SQLDBAL_IS_WINDOWS */
+  return rc;
 }
 
 /**
- * This error structure used for the single error case where we cannot
- * initially allocate memory for the @ref sqldbal_stmt.
+ * Free the pool mutex, condition variable, and thread key.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
  */
-static struct sqldbal_stmt
-g_stmt_error = {
-  &g_db_error,                      /* db              */
-  0   ,                             /* num_params      */
-  0   ,                             /* num_cols_result */
-  NULL,                             /* handle          */
-  0   ,                             /* valid           */
-  {0}                               /* pad             */
-};
-
-enum sqldbal_status_code
-sqldbal_stmt_prepare(struct sqldbal_db *const db,
-                     const char *const sql,
-                     size_t sql_len,
-                     struct sqldbal_stmt **stmt){
-  struct sqldbal_stmt *new_stmt;
+static void
+sqldbal_pool_sync_destroy(struct sqldbal_pool *const pool){
+#ifdef SQLDBAL_IS_WINDOWS
+  FlsFree(pool->thread_key);
+  DeleteCriticalSection(&pool->mutex);
+#else /* POSIX */
+  pthread_key_delete(pool->thread_key);
+  pthread_cond_destroy(&pool->cond);
+  pthread_mutex_destroy(&pool->mutex);
+#endif /* SQLDBAL_IS_WINDOWS */
+}
 
-  new_stmt = malloc(sizeof(*new_stmt));
-  if(new_stmt == NULL){
-    *stmt = &g_stmt_error;
-    sqldbal_status_code_set(db, SQLDBAL_STATUS_NOMEM);
-  }
-  else{
-    *stmt = new_stmt;
-    new_stmt->db              = db;
-    new_stmt->num_params      = 0;
-    new_stmt->num_cols_result = 0;
-    new_stmt->handle          = NULL;
-    new_stmt->valid           = 1;
-    db->functions.sqldbal_fp_stmt_prepare(db, sql, sql_len, new_stmt);
-  }
-  return sqldbal_status_code_get(db);
+/**
+ * Get the connection assigned to the calling thread.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ * @retval sqldbal_pool_thread* Connection assigned to the thread.
+ * @retval NULL                 No connection assigned to the thread.
+ */
+static struct sqldbal_pool_thread *
+sqldbal_pool_thread_get(const struct sqldbal_pool *const pool){
+#ifdef SQLDBAL_IS_WINDOWS
+  return FlsGetValue(pool->thread_key);
+#else /* POSIX */
+  return pthread_getspecific(pool->thread_key);
+#endif /* SQLDBAL_IS_WINDOWS */
 }
 
 /**
- * Ensures the bind index provided by the application stays within bounds.
+ * Assign a connection to the calling thread.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Column index.
- * @retval 1 Column index is valid.
- * @retval 0 Column index is not valid.
+ * @param[in] pool   See @ref sqldbal_pool.
+ * @param[in] thread See @ref sqldbal_pool_thread, or NULL to remove the
+ *                   assignment.
+ * @retval  0 Success.
+ * @retval -1 Failed to store the assignment.
  */
 static int
-sqldbal_stmt_bind_in_range(const struct sqldbal_stmt *const stmt,
-                           size_t col_idx){
+sqldbal_pool_thread_set(const struct sqldbal_pool *const pool,
+                        struct sqldbal_pool_thread *const thread){
   int rc;
 
-  rc = 1;
-  if(col_idx >= stmt->num_params){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
-    rc = 0;
+  rc = 0;
+#ifdef SQLDBAL_IS_WINDOWS
+  if(!FlsSetValue(pool->thread_key, thread)){
+    rc = -1;
   }
+#else /* POSIX */
+  if(pthread_setspecific(pool->thread_key, thread) != 0){
+    rc = -1;
+  }
+#endif /* SQLDBAL_IS_WINDOWS */
   return rc;
 }
 
-enum sqldbal_status_code
-sqldbal_stmt_bind_blob(struct sqldbal_stmt *const stmt,
-                       size_t col_idx,
-                       const void *const blob,
-                       size_t blobsz){
-  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
-    stmt->db->functions.sqldbal_fp_stmt_bind_blob(stmt,
-                                                  col_idx,
-                                                  blob,
-                                                  blobsz);
-  }
-  return sqldbal_status_code_get(stmt->db);
+/**
+ * Lock the pool mutex.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ */
+static void
+sqldbal_pool_lock(struct sqldbal_pool *const pool){
+#ifdef SQLDBAL_IS_WINDOWS
+  EnterCriticalSection(&pool->mutex);
+#else /* POSIX */
+  pthread_mutex_lock(&pool->mutex);
+#endif /* SQLDBAL_IS_WINDOWS */
 }
 
-enum sqldbal_status_code
-sqldbal_stmt_bind_int64(struct sqldbal_stmt *const stmt,
-                        size_t col_idx,
-                        int64_t i64){
-  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
-    stmt->db->functions.sqldbal_fp_stmt_bind_int64(stmt, col_idx, i64);
-  }
-  return sqldbal_status_code_get(stmt->db);
+/**
+ * Unlock the pool mutex.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ */
+static void
+sqldbal_pool_unlock(struct sqldbal_pool *const pool){
+#ifdef SQLDBAL_IS_WINDOWS
+  LeaveCriticalSection(&pool->mutex);
+#else /* POSIX */
+  pthread_mutex_unlock(&pool->mutex);
+#endif /* SQLDBAL_IS_WINDOWS */
 }
 
-enum sqldbal_status_code
-sqldbal_stmt_bind_text(struct sqldbal_stmt *const stmt,
-                       size_t col_idx,
-                       const char *const s,
-                       size_t slen){
-  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
-    if(slen == (size_t)-1){
-      slen = strlen(s);
-    }
+/**
+ * Wake up one thread waiting for a connection.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ */
+static void
+sqldbal_pool_signal(struct sqldbal_pool *const pool){
+#ifdef SQLDBAL_IS_WINDOWS
+  WakeConditionVariable(&pool->cond);
+#else /* POSIX */
+  pthread_cond_signal(&pool->cond);
+#endif /* SQLDBAL_IS_WINDOWS */
+}
 
-    /* Add one more byte to include null-terminator character. */
-    if(si_add_size_t(slen, 1, &slen)){
-      sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_NOMEM);
-    }
-    else{
-      stmt->db->functions.sqldbal_fp_stmt_bind_text(stmt, col_idx, s, slen);
+/**
+ * Wait for another thread to signal the pool.
+ *
+ * The caller must hold the pool mutex. This function can return early
+ * because of spurious wakeups, so the caller has to check the pool
+ * state and the remaining time again afterwards.
+ *
+ * @param[in] pool    See @ref sqldbal_pool.
+ * @param[in] wait_ms Maximum time to wait in milliseconds, or a negative
+ *                    value to wait until signaled.
+ */
+static void
+sqldbal_pool_wait(struct sqldbal_pool *const pool,
+                  long wait_ms){
+#ifdef SQLDBAL_IS_WINDOWS
+  DWORD timeout;
+
+  if(wait_ms < 0){
+    timeout = INFINITE;
+  }
+  else{
+    timeout = (DWORD)wait_ms;
+  }
+  SleepConditionVariableCS(&pool->cond, &pool->mutex, timeout);
+#else /* POSIX */
+  struct timespec abstime;
+
+  if(wait_ms < 0){
+    pthread_cond_wait(&pool->cond, &pool->mutex);
+  }
+  else{
+    abstime.tv_sec = 0;
+    abstime.tv_nsec = 0;
+    clock_gettime(CLOCK_REALTIME, &abstime);
+    abstime.tv_sec += wait_ms / 1000;
+    abstime.tv_nsec += (wait_ms % 1000) * 1000000;
+    if(abstime.tv_nsec >= 1000000000){
+      abstime.tv_sec += 1;
+      abstime.tv_nsec -= 1000000000;
     }
+    pthread_cond_timedwait(&pool->cond, &pool->mutex, &abstime);
   }
-  return sqldbal_status_code_get(stmt->db);
+#endif /* SQLDBAL_IS_WINDOWS */
 }
 
-enum sqldbal_status_code
-sqldbal_stmt_bind_null(struct sqldbal_stmt *const stmt,
-                       size_t col_idx){
-  if(sqldbal_stmt_bind_in_range(stmt, col_idx)){
-    stmt->db->functions.sqldbal_fp_stmt_bind_null(stmt, col_idx);
+/**
+ * Open a new connection using the parameters saved in the pool.
+ *
+ * @param[in]  pool See @ref sqldbal_pool.
+ * @param[out] db   New database connection, or NULL on failure.
+ * @return          See @ref sqldbal_status_code.
+ */
+static enum sqldbal_status_code
+sqldbal_pool_open_db(const struct sqldbal_pool *const pool,
+                     struct sqldbal_db **const db){
+  enum sqldbal_status_code status;
+
+  status = sqldbal_open(pool->driver,
+                        pool->params.location,
+                        pool->params.port,
+                        pool->params.username,
+                        pool->params.password,
+                        pool->params.database,
+                        pool->flags,
+                        pool->params.option_list,
+                        pool->params.num_options,
+                        db);
+  if(status != SQLDBAL_STATUS_OK){
+    sqldbal_close(*db);
+    *db = NULL;
   }
-  return sqldbal_status_code_get(stmt->db);
+  return status;
 }
 
-enum sqldbal_status_code
-sqldbal_stmt_execute(struct sqldbal_stmt *const stmt){
-  stmt->db->functions.sqldbal_fp_stmt_execute(stmt);
-  return sqldbal_status_code_get(stmt->db);
-}
+/**
+ * Close connections that stayed idle longer than the idle timeout while
+ * the pool has more than the minimum number of connections open.
+ *
+ * The caller must not hold the pool mutex.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ */
+static void
+sqldbal_pool_evict(struct sqldbal_pool *const pool){
+  struct sqldbal_db *db;
+  uint64_t now_ms;
 
-enum sqldbal_fetch_result
-sqldbal_stmt_fetch(struct sqldbal_stmt *const stmt){
-  return stmt->db->functions.sqldbal_fp_stmt_fetch(stmt);
+  now_ms = sqldbal_time_ms();
+  do{
+    db = NULL;
+    sqldbal_pool_lock(pool);
+    if(pool->idle_timeout_ms >= 0 &&
+       pool->num_idle > 0 &&
+       pool->num_open > pool->min_size &&
+       now_ms - pool->idle_list[0].idle_since_ms >=
+       (uint64_t)pool->idle_timeout_ms){
+      db = pool->idle_list[0].db;
+      pool->num_idle -= 1;
+      pool->num_open -= 1;
+      memmove(&pool->idle_list[0],
+              &pool->idle_list[1],
+              pool->num_idle * sizeof(*pool->idle_list));
+      sqldbal_pool_signal(pool);
+    }
+    sqldbal_pool_unlock(pool);
+    if(db){
+      sqldbal_close(db);
+    }
+  } while(db);
 }
 
 /**
- * Ensures the column index provided by the application stays within bounds.
+ * Open the initial idle connections of a new pool at the same time using
+ * @ref sqldbal_open_parallel.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Column index.
- * @retval 0 Column index not valid.
- * @retval 1 Column index valid.
+ * @param[in] pool    See @ref sqldbal_pool.
+ * @param[in] num_dbs Number of connections to open.
+ * @return            See @ref sqldbal_status_code.
  */
-static int
-sqldbal_stmt_column_in_range(const struct sqldbal_stmt *const stmt,
-                             size_t col_idx){
-  int rc;
+static enum sqldbal_status_code
+sqldbal_pool_warm(struct sqldbal_pool *const pool,
+                  size_t num_dbs){
+  struct sqldbal_db **db_list;
+  enum sqldbal_status_code status;
+  uint64_t now_ms;
+  size_t i;
 
-  rc = 1;
-  if(col_idx >= stmt->num_cols_result){
-    sqldbal_status_code_set(stmt->db, SQLDBAL_STATUS_PARAM);
-    rc = 0;
+  status = SQLDBAL_STATUS_OK;
+  if(num_dbs){
+    db_list = sqldbal_reallocarray(NULL, num_dbs, sizeof(*db_list));
+    if(db_list == NULL){
+      status = SQLDBAL_STATUS_NOMEM;
+    }
+    else{
+      status = sqldbal_open_parallel(pool->driver,
+                                     pool->params.location,
+                                     pool->params.port,
+                                     pool->params.username,
+                                     pool->params.password,
+                                     pool->params.database,
+                                     pool->flags,
+                                     pool->params.option_list,
+                                     pool->params.num_options,
+                                     num_dbs,
+                                     db_list);
+      now_ms = sqldbal_time_ms();
+      for(i = 0; i < num_dbs; i++){
+        if(status == SQLDBAL_STATUS_OK){
+          pool->idle_list[pool->num_idle].db = db_list[i];
+          pool->idle_list[pool->num_idle].idle_since_ms = now_ms;
+          pool->num_idle += 1;
+          pool->num_open += 1;
+        }
+        else{
+          sqldbal_close(db_list[i]);
+        }
+      }
+      free(db_list);
+    }
   }
-  return rc;
+  return status;
 }
 
 enum sqldbal_status_code
-sqldbal_stmt_column_blob(struct sqldbal_stmt *const stmt,
-                         size_t col_idx,
-                         const void **blob,
-                         size_t *blobsz){
-  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
-    stmt->db->functions.sqldbal_fp_stmt_column_blob(stmt,
-                                                    col_idx,
-                                                    blob,
-                                                    blobsz);
+sqldbal_pool_open(enum sqldbal_driver driver,
+                  const char *const location,
+                  const char *const port,
+                  const char *const username,
+                  const char *const password,
+                  const char *const database,
+                  const unsigned long flags,
+                  const struct sqldbal_driver_option *const option_list,
+                  size_t num_options,
+                  size_t min_size,
+                  size_t max_size,
+                  long idle_timeout_ms,
+                  struct sqldbal_pool **pool){
+  struct sqldbal_pool *new_pool;
+  enum sqldbal_status_code status;
+
+  *pool = NULL;
+  status = SQLDBAL_STATUS_OK;
+  if(max_size == 0 || min_size > max_size){
+    status = SQLDBAL_STATUS_PARAM;
   }
-  return sqldbal_status_code_get(stmt->db);
+  else{
+    new_pool = calloc(1, sizeof(*new_pool));
+    if(new_pool == NULL){
+      status = SQLDBAL_STATUS_NOMEM;
+    }
+    else{
+      new_pool->min_size        = min_size;
+      new_pool->max_size        = max_size;
+      new_pool->idle_timeout_ms = idle_timeout_ms;
+      new_pool->flags           = flags;
+      new_pool->driver          = driver;
+      new_pool->idle_list = sqldbal_reallocarray(NULL,
+                                                 max_size,
+                                                 sizeof(*new_pool->idle_list));
+      if(new_pool->idle_list == NULL ||
+         sqldbal_params_copy(&new_pool->params,
+                             location,
+                             port,
+                             username,
+                             password,
+                             database,
+                             option_list,
+                             num_options) ||
+         sqldbal_pool_sync_init(new_pool)){
+        free(new_pool->idle_list);
+        sqldbal_params_free(&new_pool->params);
+        free(new_pool);
+        status = SQLDBAL_STATUS_NOMEM;
+      }
+      else{
+        *pool = new_pool;
+        status = sqldbal_pool_warm(new_pool, min_size);
+        if(status != SQLDBAL_STATUS_OK){
+          sqldbal_pool_close(new_pool);
+          *pool = NULL;
+        }
+      }
+    }
+  }
+  return status;
 }
 
 enum sqldbal_status_code
-sqldbal_stmt_column_int64(struct sqldbal_stmt *const stmt,
-                          size_t col_idx,
-                          int64_t *i64){
-  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
-    stmt->db->functions.sqldbal_fp_stmt_column_int64(stmt, col_idx, i64);
+sqldbal_pool_acquire(struct sqldbal_pool *const pool,
+                     long timeout_ms,
+                     struct sqldbal_db **db){
+  struct sqldbal_db *idle_db;
+  uint64_t start_ms;
+  uint64_t idle_ms;
+  uint64_t elapsed_ms;
+  enum sqldbal_status_code status;
+
+  *db = NULL;
+  status = SQLDBAL_STATUS_OK;
+  sqldbal_pool_evict(pool);
+  start_ms = sqldbal_time_ms();
+  sqldbal_pool_lock(pool);
+  while(*db == NULL && status == SQLDBAL_STATUS_OK){
+    if(pool->num_idle > 0){
+      /*
+       * Take the most recently used connection so that the connections
+       * in use keep their driver and server-side caches warm.
+       */
+      pool->num_idle -= 1;
+      idle_db = pool->idle_list[pool->num_idle].db;
+      idle_ms = sqldbal_time_ms() -
+                pool->idle_list[pool->num_idle].idle_since_ms;
+      sqldbal_pool_unlock(pool);
+      if(idle_ms < SQLDBAL_POOL_HEALTH_CHECK_MS ||
+         sqldbal_ping(idle_db) == SQLDBAL_STATUS_OK){
+        *db = idle_db;
+      }
+      else{
+        sqldbal_close(idle_db);
+      }
+      sqldbal_pool_lock(pool);
+      if(*db == NULL){
+        pool->num_open -= 1;
+      }
+    }
+    else if(pool->num_open < pool->max_size){
+      /* Reserve the slot before opening the connection without the lock. */
+      pool->num_open += 1;
+      sqldbal_pool_unlock(pool);
+      status = sqldbal_pool_open_db(pool, db);
+      sqldbal_pool_lock(pool);
+      if(status != SQLDBAL_STATUS_OK){
+        pool->num_open -= 1;
+        sqldbal_pool_signal(pool);
+      }
+    }
+    else{
+      elapsed_ms = sqldbal_time_ms() - start_ms;
+      if(timeout_ms < 0){
+        sqldbal_pool_wait(pool, -1);
+      }
+      else if(elapsed_ms >= (uint64_t)timeout_ms){
+        status = SQLDBAL_STATUS_TIMEOUT;
+      }
+      else{
+        sqldbal_pool_wait(pool, timeout_ms - (long)elapsed_ms);
+      }
+    }
   }
-  return sqldbal_status_code_get(stmt->db);
+  sqldbal_pool_unlock(pool);
+  if(*db){
+    (*db)->pool = pool;
+  }
+  return status;
 }
 
 enum sqldbal_status_code
-sqldbal_stmt_column_text(struct sqldbal_stmt *const stmt,
-                         size_t col_idx,
-                         const char **text,
-                         size_t *textsz){
-  size_t text_len;
+sqldbal_pool_release(struct sqldbal_pool *const pool,
+                     struct sqldbal_db *const db){
+  enum sqldbal_status_code status;
 
-  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
-    stmt->db->functions.sqldbal_fp_stmt_column_text(stmt,
-                                                    col_idx,
-                                                    text,
-                                                    &text_len);
-    if(textsz){
-      *textsz = text_len;
+  status = SQLDBAL_STATUS_OK;
+  if(db->pool != pool){
+    /* Already idle, released twice, or acquired from another pool. */
+    status = SQLDBAL_STATUS_PARAM;
+  }
+  else{
+    db->pool = NULL;
+    if(sqldbal_status_code_clear(db) != SQLDBAL_STATUS_OK){
+      status = sqldbal_ping(db);
+    }
+    /* The next caller must not inherit queued statements or a transaction. */
+    if(status == SQLDBAL_STATUS_OK && db->pipeline){
+      status = sqldbal_pipeline_end(db);
+    }
+    if(status == SQLDBAL_STATUS_OK && db->transaction){
+      status = sqldbal_rollback(db);
+    }
+    sqldbal_pool_lock(pool);
+    if(status != SQLDBAL_STATUS_OK){
+      pool->num_open -= 1;
+    }
+    else{
+      pool->idle_list[pool->num_idle].db = db;
+      pool->idle_list[pool->num_idle].idle_since_ms = sqldbal_time_ms();
+      pool->num_idle += 1;
+    }
+    sqldbal_pool_signal(pool);
+    sqldbal_pool_unlock(pool);
+    if(status != SQLDBAL_STATUS_OK){
+      sqldbal_close(db);
     }
+    sqldbal_pool_evict(pool);
   }
-
-  return sqldbal_status_code_get(stmt->db);
+  return status;
 }
 
-enum sqldbal_column_type
-sqldbal_stmt_column_type(struct sqldbal_stmt *const stmt,
-                         size_t col_idx){
-  enum sqldbal_column_type type;
+enum sqldbal_status_code
+sqldbal_pool_thread_db(struct sqldbal_pool *const pool,
+                       long timeout_ms,
+                       struct sqldbal_db **db){
+  struct sqldbal_pool_thread *thread;
+  enum sqldbal_status_code status;
 
-  if(sqldbal_stmt_column_in_range(stmt, col_idx)){
-    type = stmt->db->functions.sqldbal_fp_stmt_column_type(stmt, col_idx);
+  thread = sqldbal_pool_thread_get(pool);
+  if(thread){
+    *db = thread->db;
+    status = SQLDBAL_STATUS_OK;
   }
   else{
-    type = SQLDBAL_TYPE_ERROR;
+    status = sqldbal_pool_acquire(pool, timeout_ms, db);
+    if(status == SQLDBAL_STATUS_OK){
+      thread = malloc(sizeof(*thread));
+      if(thread){
+        thread->pool = pool;
+        thread->db   = *db;
+      }
+      if(thread == NULL || sqldbal_pool_thread_set(pool, thread)){
+        free(thread);
+        sqldbal_pool_release(pool, *db);
+        *db = NULL;
+        status = SQLDBAL_STATUS_NOMEM;
+      }
+    }
   }
-  return type;
+  return status;
 }
 
 enum sqldbal_status_code
-sqldbal_stmt_close(struct sqldbal_stmt *const stmt){
-  const struct sqldbal_db *db;
+sqldbal_pool_thread_release(struct sqldbal_pool *const pool){
+  struct sqldbal_pool_thread *thread;
+  enum sqldbal_status_code status;
 
-  db = stmt->db;
-  if(stmt != &g_stmt_error){
-    db->functions.sqldbal_fp_stmt_close(stmt);
-    free(stmt);
+  status = SQLDBAL_STATUS_OK;
+  thread = sqldbal_pool_thread_get(pool);
+  if(thread){
+    sqldbal_pool_thread_set(pool, NULL);
+    status = sqldbal_pool_release(pool, thread->db);
+    free(thread);
   }
-  return sqldbal_status_code_get(db);
+  return status;
+}
+
+void
+sqldbal_pool_stats(struct sqldbal_pool *const pool,
+                   size_t *const num_open,
+                   size_t *const num_idle){
+  sqldbal_pool_lock(pool);
+  *num_open = pool->num_open;
+  *num_idle = pool->num_idle;
+  sqldbal_pool_unlock(pool);
 }
 
+enum sqldbal_status_code
+sqldbal_pool_close(struct sqldbal_pool *const pool){
+  enum sqldbal_status_code status;
+  enum sqldbal_status_code close_status;
+  size_t i;
+
+  status = SQLDBAL_STATUS_OK;
+  for(i = 0; i < pool->num_idle; i++){
+    close_status = sqldbal_close(pool->idle_list[i].db);
+    if(status == SQLDBAL_STATUS_OK){
+      status = close_status;
+    }
+  }
+  sqldbal_pool_sync_destroy(pool);
+  free(pool->idle_list);
+  sqldbal_params_free(&pool->params);
+  free(pool);
+  return status;
+}
+#endif /* SQLDBAL_POOL */
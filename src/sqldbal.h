@@ -7,6 +7,16 @@
  * SQL Database Abstraction Library that provides a high-level interface
  * for multiple database engines.
  *
+ * Threads: Only one thread at a time can use a connection and the
+ * statements prepared on it. Different threads can use different
+ * connections at the same time without any locking because connections
+ * only share read-only data. If the library cannot allocate a handle, the
+ * error handle it returns belongs to the calling thread. The database
+ * client libraries must get built thread-safe, and the MariaDB client
+ * library must get initialized before starting other threads, for
+ * example by opening the first connection. See
+ * @ref sqldbal_pool_thread_db for giving each thread its own connection.
+ *
  * This software has been placed into the public domain using CC0.
  */
 #ifndef SQLDBAL_H
@@ -48,9 +58,55 @@
  * @ingroup sqldbal_flag
  *
  * Print debug/tracing information to stderr.
+ *
+ * Only the PostgreSQL driver prints anything, using PQtrace. See
+ * @ref sqldbal_trace_open for timing the SQL statements of every driver.
  */
 #define SQLDBAL_FLAG_DEBUG                 (1 << 0)
 
+/**
+ * @ingroup sqldbal_flag
+ *
+ * Stream result rows from the server as the application fetches them
+ * instead of reading the entire result set into memory during
+ * @ref sqldbal_stmt_execute and @ref sqldbal_exec.
+ *
+ * Used by the MariaDB and PostgreSQL drivers. The SQLite driver always reads
+ * results one row at a time.
+ *
+ * While a streamed result has unread rows, the application must not run
+ * other statements on the same database connection. Fetch every row,
+ * execute the statement again, or close the statement to discard the
+ * remaining rows.
+ */
+#define SQLDBAL_FLAG_STREAM_RESULTS        (1 << 1)
+
+/**
+ * @ingroup sqldbal_flag
+ *
+ * Save the connection parameters in @ref sqldbal_open and connect the
+ * first time the application uses the connection, or when calling
+ * @ref sqldbal_connect.
+ *
+ * Errors from connecting, such as @ref SQLDBAL_STATUS_OPEN, get returned
+ * by the function that used the connection. The next use tries to
+ * connect again.
+ */
+#define SQLDBAL_FLAG_LAZY_CONNECT          (1 << 2)
+
+#ifdef SQLDBAL_MARIADB
+/**
+ * @ingroup sqldbal_flag
+ *
+ * Enable the MariaDB non-blocking client API on the connection, which
+ * @ref sqldbal_stmt_execute_start requires.
+ *
+ * This allocates a separate stack for the connection. The blocking
+ * functions continue to work on the same connection.
+ */
+#define SQLDBAL_FLAG_MARIADB_NONBLOCK      (1 << 12)
+#endif /* SQLDBAL_MARIADB */
+
 #ifdef SQLDBAL_SQLITE
 /**
  * @ingroup sqldbal_flag
@@ -72,8 +128,48 @@
  * Create the SQLite database if it does not exist yet.
  */
 #define SQLDBAL_FLAG_SQLITE_OPEN_CREATE    (1 << 18)
+
+/**
+ * @ingroup sqldbal_flag
+ *
+ * Open the SQLite database in multi-thread mode, which skips the mutexes
+ * on the connection. The application must not use the connection from
+ * more than one thread at a time.
+ */
+#define SQLDBAL_FLAG_SQLITE_OPEN_NOMUTEX   (1 << 19)
+
+/**
+ * @ingroup sqldbal_flag
+ *
+ * Open the SQLite database in serialized mode, which protects the
+ * connection with mutexes.
+ */
+#define SQLDBAL_FLAG_SQLITE_OPEN_FULLMUTEX (1 << 20)
+
+/**
+ * @ingroup sqldbal_flag
+ *
+ * Share the page cache with other connections to the same database in
+ * this process.
+ */
+#define SQLDBAL_FLAG_SQLITE_OPEN_SHAREDCACHE (1 << 21)
 #endif /* SQLDBAL_SQLITE */
 
+#ifdef SQLDBAL_POSTGRESQL
+/**
+ * @ingroup sqldbal_flag
+ *
+ * Use the PostgreSQL binary wire format for prepared statements.
+ *
+ * Integers get sent to int2, int4 and int8 placeholders in network byte
+ * order instead of as text. Results get requested in binary when every
+ * column has an integer, bytea or text data type, which avoids parsing
+ * integers and decoding hex bytea values while fetching. Statements with
+ * other column types continue to use the text format.
+ */
+#define SQLDBAL_FLAG_PQ_BINARY             (1 << 24)
+#endif /* SQLDBAL_POSTGRESQL */
+
 /**
  * @ingroup sqldbal_flag
  *
@@ -194,6 +290,11 @@ enum sqldbal_status_code{
    */
   SQLDBAL_STATUS_CLOSE,
 
+  /**
+   * Timed out waiting for an available connection in a @ref sqldbal_pool.
+   */
+  SQLDBAL_STATUS_TIMEOUT,
+
   /**
    * Indicates the last status code in the enumeration, useful for
    * bounds checking.
@@ -229,14 +330,35 @@ enum sqldbal_fetch_result{
   SQLDBAL_FETCH_ERROR
 };
 
+/**
+ * Socket events returned by @ref sqldbal_stmt_execute_poll.
+ *
+ * The application waits for any of these events on the socket from
+ * @ref sqldbal_db_socket_fd before calling @ref sqldbal_stmt_execute_poll
+ * again.
+ */
+enum sqldbal_wait_event{
+  /**
+   * Wait until the socket has data to read.
+   */
+  SQLDBAL_WAIT_READ  = 1 << 0,
+
+  /**
+   * Wait until the socket can accept more data to send.
+   */
+  SQLDBAL_WAIT_WRITE = 1 << 1
+};
+
 /**
  * Column data type in the result set of a prepared statement.
  *
  * Applications can determine data types by calling
  * @ref sqldbal_stmt_column_type.
  *
- * Some drivers may consider text and integers as blobs. However, applications
- * can still use this to check if the result has a NULL value.
+ * The drivers report the type declared by the database where possible.
+ * Columns that the driver cannot classify have the
+ * @ref SQLDBAL_TYPE_OTHER type, but applications can still read them as
+ * text.
  */
 enum sqldbal_column_type{
   /**
@@ -259,6 +381,21 @@ enum sqldbal_column_type{
    */
   SQLDBAL_TYPE_NULL,
 
+  /**
+   * Floating point number.
+   */
+  SQLDBAL_TYPE_DOUBLE,
+
+  /**
+   * Boolean value.
+   */
+  SQLDBAL_TYPE_BOOL,
+
+  /**
+   * Date or timestamp.
+   */
+  SQLDBAL_TYPE_TIMESTAMP,
+
   /**
    * Non-standard data type.
    */
@@ -286,6 +423,238 @@ struct sqldbal_driver_option{
   const char *value;
 };
 
+/**
+ * Column-wise placeholder values used by @ref sqldbal_stmt_execute_batch.
+ *
+ * Each entry describes every value for one placeholder across all of
+ * the rows in the batch. Only the list matching @ref type gets used.
+ */
+struct sqldbal_batch_param{
+  /**
+   * Values for @ref SQLDBAL_TYPE_INT.
+   */
+  const int64_t *i64_list;
+
+  /**
+   * Null-terminated strings for @ref SQLDBAL_TYPE_TEXT.
+   */
+  const char *const *text_list;
+
+  /**
+   * Binary data for @ref SQLDBAL_TYPE_BLOB.
+   */
+  const void *const *blob_list;
+
+  /**
+   * Length in bytes of each entry in @ref blob_list or @ref text_list.
+   *
+   * Required for blobs. The text lengths can get set to NULL to have the
+   * library compute the string lengths.
+   */
+  const size_t *length_list;
+
+  /**
+   * Bitmap marking which rows contain a NULL value, or NULL if no rows have
+   * NULL values.
+   *
+   * Row n has a NULL value if bit (n % 8) has been set in byte (n / 8).
+   */
+  const unsigned char *null_bitmap;
+
+  /**
+   * Data type stored in this placeholder, which must have one of the
+   * following values:
+   *   - @ref SQLDBAL_TYPE_INT
+   *   - @ref SQLDBAL_TYPE_TEXT
+   *   - @ref SQLDBAL_TYPE_BLOB
+   *   - @ref SQLDBAL_TYPE_NULL (every row gets the NULL value)
+   */
+  enum sqldbal_column_type type;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Column-wise result buffers filled by @ref sqldbal_stmt_fetch_columns.
+ *
+ * The application owns every buffer and sizes them for the maximum number
+ * of rows requested. The buffers follow the Apache Arrow columnar layout so
+ * that they can get passed to Arrow consumers without copying:
+ *   - @ref SQLDBAL_TYPE_INT      : Int64 values in @ref i64_list.
+ *   - @ref SQLDBAL_TYPE_BOOL     : 0 or 1 stored as Int64 values in
+ *                                  @ref i64_list.
+ *   - @ref SQLDBAL_TYPE_TIMESTAMP: Timestamp(microsecond, "UTC") values in
+ *                                  @ref i64_list. See
+ *                                  @ref sqldbal_stmt_column_timestamp.
+ *   - @ref SQLDBAL_TYPE_DOUBLE   : Float64 values in @ref d_list.
+ *   - @ref SQLDBAL_TYPE_TEXT     : Utf8 values, with the bytes of row n in
+ *                                  @ref data from offset_list[n] up to
+ *                                  offset_list[n + 1].
+ *   - @ref SQLDBAL_TYPE_BLOB     : Binary values with the same layout as
+ *                                  @ref SQLDBAL_TYPE_TEXT.
+ *
+ * NULL values have 0 or an empty value in the data buffers.
+ */
+struct sqldbal_column_vector{
+  /**
+   * Values for @ref SQLDBAL_TYPE_INT, @ref SQLDBAL_TYPE_BOOL, and
+   * @ref SQLDBAL_TYPE_TIMESTAMP, with room for the maximum number of rows.
+   */
+  int64_t *i64_list;
+
+  /**
+   * Values for @ref SQLDBAL_TYPE_DOUBLE, with room for the maximum number
+   * of rows.
+   */
+  double *d_list;
+
+  /**
+   * Offsets into @ref data for @ref SQLDBAL_TYPE_TEXT and
+   * @ref SQLDBAL_TYPE_BLOB, with room for the maximum number of rows plus
+   * one. The first offset always has the value 0.
+   */
+  int32_t *offset_list;
+
+  /**
+   * Buffer holding the bytes of every value for @ref SQLDBAL_TYPE_TEXT and
+   * @ref SQLDBAL_TYPE_BLOB. Text values do not have a null-terminator.
+   */
+  void *data;
+
+  /**
+   * Number of bytes available in @ref data.
+   */
+  size_t data_size;
+
+  /**
+   * Arrow validity bitmap, or NULL if the application does not need to
+   * distinguish NULL values.
+   *
+   * Row n has a non-NULL value if bit (n % 8) has been set in byte (n / 8).
+   * Note that this has the opposite meaning of
+   * @ref sqldbal_batch_param::null_bitmap.
+   */
+  unsigned char *validity_bitmap;
+
+  /**
+   * Number of NULL values returned in the last call, or 0 if
+   * @ref validity_bitmap has not been set.
+   */
+  size_t null_count;
+
+  /**
+   * Data type stored in this column vector. See the structure description
+   * for the supported types. Column values get converted to this type in
+   * the same way as the sqldbal_stmt_column_* functions.
+   */
+  enum sqldbal_column_type type;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Operation measured by a @ref sqldbal_metrics report.
+ */
+enum sqldbal_metrics_event{
+  /**
+   * One call to @ref sqldbal_exec, including the result callbacks.
+   */
+  SQLDBAL_METRICS_EXEC,
+
+  /**
+   * One call to @ref sqldbal_stmt_prepare.
+   */
+  SQLDBAL_METRICS_PREPARE,
+
+  /**
+   * One call to @ref sqldbal_stmt_execute or
+   * @ref sqldbal_stmt_execute_batch, or the time from
+   * @ref sqldbal_stmt_execute_start to @ref sqldbal_stmt_execute_finish.
+   * In a pipeline, this only measures the time to queue the statement.
+   */
+  SQLDBAL_METRICS_EXECUTE,
+
+  /**
+   * Every @ref sqldbal_stmt_fetch call for one result set. Gets reported
+   * when the fetch reaches the end of the results or fails, or when the
+   * statement executes again, resets, or closes before reading every row.
+   */
+  SQLDBAL_METRICS_FETCH
+};
+
+/**
+ * Measurements passed to the hook set by @ref sqldbal_metrics_hook.
+ */
+struct sqldbal_metrics{
+  /**
+   * SQL text for @ref SQLDBAL_METRICS_EXEC and
+   * @ref SQLDBAL_METRICS_PREPARE, or NULL for the other events. Only valid
+   * during the hook. Not null-terminated if the application passed an
+   * explicit length to @ref sqldbal_stmt_prepare.
+   */
+  const char *sql;
+
+  /**
+   * Number of bytes in @ref sql.
+   */
+  size_t sql_len;
+
+  /**
+   * 64-bit FNV-1a hash of the SQL text. The statement events have the
+   * same hash as the @ref SQLDBAL_METRICS_PREPARE event of the statement,
+   * or 0 if the statement got prepared before installing the hook.
+   */
+  uint64_t sql_hash;
+
+  /**
+   * Time spent in the operation, in nanoseconds from a monotonic clock.
+   */
+  uint64_t elapsed_ns;
+
+  /**
+   * Number of rows fetched, passed to the @ref sqldbal_exec callback, or
+   * sent by @ref sqldbal_stmt_execute_batch.
+   */
+  uint64_t num_rows;
+
+  /**
+   * Number of text and blob bytes bound with the sqldbal_stmt_bind_*
+   * functions for @ref SQLDBAL_METRICS_EXECUTE, or read from the text and
+   * blob columns for @ref SQLDBAL_METRICS_FETCH. Number of bytes in the
+   * SQL text for the other events.
+   */
+  uint64_t num_bytes;
+
+  /**
+   * Number of times the operation waited for a locked database before
+   * trying again. See @ref sqldbal_busy_stats.
+   */
+  uint64_t num_retries;
+
+  /**
+   * See @ref sqldbal_metrics_event.
+   */
+  enum sqldbal_metrics_event event;
+
+  /**
+   * Status code after the operation. See @ref sqldbal_status_code.
+   */
+  enum sqldbal_status_code status;
+};
+
+/**
+ * Callback function type that receives the @ref sqldbal_metrics reports.
+ */
+typedef void
+(*sqldbal_metrics_fp)(void *user_data,
+                      const struct sqldbal_metrics *const metrics);
+
 /**
  * Callback function type used to process returned SQL results.
  */
@@ -299,6 +668,10 @@ struct sqldbal_db;
 
 struct sqldbal_stmt;
 
+struct sqldbal_bulk;
+
+struct sqldbal_blob;
+
 /**
  * Get the last error code set by the library.
  *
@@ -384,6 +757,31 @@ sqldbal_errstr(const struct sqldbal_db *const db,
  * Ignores the @p port, @p username, @p password, and @p database parameters.
  * Supports the following options in @p option_list:
  *   - VFS (Name of Virtual File System to use)
+ *   - BUSY_HANDLER (How to retry statements while another connection has
+ *                   the database locked)
+ *     - SQLDBAL - (Default) Retry the statement after an exponential
+ *                 backoff with random jitter.
+ *     - HANDLER - Install the same backoff with sqlite3_busy_handler() so
+ *                 that SQLite retries internally.
+ *     - TIMEOUT - Use sqlite3_busy_timeout() with BUSY_TIMEOUT_MS.
+ *                 @ref sqldbal_busy_stats does not count these retries.
+ *   - BUSY_TIMEOUT_MS (Stop retrying a statement after waiting this long
+ *                      in total, default 100)
+ *   - BUSY_BACKOFF_MIN_MS (Wait time before the first retry, default 1)
+ *   - BUSY_BACKOFF_MAX_MS (The wait time doubles after each retry up to
+ *                          this limit, default 50)
+ *   - PAGE_SIZE (PRAGMA page_size, a power of two from 512 to 65536)
+ *   - JOURNAL_MODE (PRAGMA journal_mode: DELETE, TRUNCATE, PERSIST, MEMORY,
+ *                   WAL, or OFF)
+ *   - SYNCHRONOUS (PRAGMA synchronous: OFF, NORMAL, FULL, or EXTRA)
+ *   - CACHE_SIZE (PRAGMA cache_size, number of pages or the negative
+ *                 number of KiB)
+ *   - MMAP_SIZE (PRAGMA mmap_size, maximum number of bytes to memory-map)
+ *   - TEMP_STORE (PRAGMA temp_store: DEFAULT, FILE, or MEMORY)
+ *
+ * The PRAGMA options get applied in the order listed above before this
+ * function returns. It fails with @ref SQLDBAL_STATUS_OPEN if SQLite
+ * rejects any of them or cannot switch to the requested JOURNAL_MODE.
  *
  * @param[in]  driver      See @ref sqldbal_driver.
  * @param[in]  location    File path, host name, or IP address.
@@ -411,6 +809,66 @@ sqldbal_open(enum sqldbal_driver driver,
              size_t num_options,
              struct sqldbal_db **db);
 
+/**
+ * Open several connections to the same database at the same time.
+ *
+ * This takes the same parameters as @ref sqldbal_open, and starts every
+ * connection before waiting on any of them. The MariaDB and PostgreSQL
+ * drivers use the non-blocking connect functions
+ * (mysql_real_connect_start and PQconnectStart), so the connections
+ * complete in about the time of the slowest one instead of the sum of
+ * all of them. SQLite opens the files one after another.
+ *
+ * Each entry in @p db_list gets a database context, even when that
+ * connection failed. Applications must call @ref sqldbal_close on every
+ * entry. With @ref SQLDBAL_FLAG_LAZY_CONNECT, this only saves the
+ * parameters in each connection.
+ *
+ * The CONNECT_TIMEOUT option limits the total time spent waiting for all
+ * of the connections. Connections still in progress after that many
+ * seconds fail with @ref SQLDBAL_STATUS_OPEN. Without the option, this
+ * waits until every connection succeeds or fails.
+ *
+ * @param[in]  driver      See @ref sqldbal_open.
+ * @param[in]  location    See @ref sqldbal_open.
+ * @param[in]  port        See @ref sqldbal_open.
+ * @param[in]  username    See @ref sqldbal_open.
+ * @param[in]  password    See @ref sqldbal_open.
+ * @param[in]  database    See @ref sqldbal_open.
+ * @param[in]  flags       See @ref sqldbal_open.
+ * @param[in]  option_list See @ref sqldbal_open.
+ * @param[in]  num_options See @ref sqldbal_open.
+ * @param[in]  num_dbs     Number of connections to open.
+ * @param[out] db_list     Array of @p num_dbs connections.
+ * @return                 Status code of the first connection that failed,
+ *                         or @ref SQLDBAL_STATUS_OK if all of them
+ *                         succeeded.
+ */
+enum sqldbal_status_code
+sqldbal_open_parallel(enum sqldbal_driver driver,
+                      const char *const location,
+                      const char *const port,
+                      const char *const username,
+                      const char *const password,
+                      const char *const database,
+                      const unsigned long flags,
+                      const struct sqldbal_driver_option *const option_list,
+                      size_t num_options,
+                      size_t num_dbs,
+                      struct sqldbal_db **db_list);
+
+/**
+ * Connect a database opened with @ref SQLDBAL_FLAG_LAZY_CONNECT now
+ * instead of waiting for the first use.
+ *
+ * This does nothing if the connection has already connected.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @return       See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_connect(struct sqldbal_db *const db);
+
 /**
  * Close the database handle previously opened by @ref sqldbal_open.
  *
@@ -432,8 +890,12 @@ sqldbal_close(struct sqldbal_db *db);
  *   - PostgreSQL: PGconn *
  *   - SQLite    : sqlite3 *
  *
+ * A connection opened with @ref SQLDBAL_FLAG_LAZY_CONNECT does not have a
+ * driver handle until it connects.
+ *
  * @param[in] db See @ref sqldbal_db.
- * @return       Driver database handle.
+ * @retval void* Driver database handle.
+ * @retval NULL  The connection has not connected yet.
  */
 void *
 sqldbal_db_handle(const struct sqldbal_db *const db);
@@ -485,103 +947,791 @@ enum sqldbal_status_code
 sqldbal_rollback(struct sqldbal_db *const db);
 
 /**
- * Execute a SQL query directly without preparing statements.
+ * Queue statements instead of waiting for each result.
  *
- * Invokes the application @p callback function for each row in the result set.
+ * After calling this, @ref sqldbal_stmt_execute sends the statement to the
+ * server without waiting for the result. @ref sqldbal_pipeline_end then
+ * reads every result in the order the statements got executed, so the
+ * whole group only waits on a single network round trip. Each statement
+ * keeps its own result for @ref sqldbal_stmt_fetch after
+ * @ref sqldbal_pipeline_end returns. Only the last result gets kept when
+ * executing the same statement more than once in a pipeline.
  *
- * @param[in] db        See @ref sqldbal_db.
- * @param[in] sql       SQL query to execute.
- * @param[in] callback  Function called for each result row. The application
- *                      can set this to NULL if it does not need to process
- *                      the results.
- * @param[in] user_data Application data to send to @p callback.
- * @return              See @ref sqldbal_status_code.
+ * Only prepare statements and execute them between
+ * @ref sqldbal_pipeline_begin and @ref sqldbal_pipeline_end. Prepare the
+ * statements before starting the pipeline. The results do not get streamed
+ * when using @ref SQLDBAL_FLAG_STREAM_RESULTS. A failed statement causes
+ * every statement after it in the pipeline to fail, and
+ * @ref sqldbal_pipeline_end returns the first error.
+ *
+ * Drivers:
+ *   - MariaDB   : Executes each statement immediately.
+ *   - PostgreSQL: Uses pipeline mode when supported by the pq library.
+ *                 Otherwise executes each statement immediately.
+ *   - SQLite    : Executes each statement immediately.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @retval SQLDBAL_STATUS_OK    Started the pipeline.
+ * @retval SQLDBAL_STATUS_PARAM A pipeline has already started.
+ * @retval SQLDBAL_STATUS_EXEC  Failed to start the pipeline.
  */
 enum sqldbal_status_code
-sqldbal_exec(struct sqldbal_db *const db,
-             const char *const sql,
-             sqldbal_exec_callback_fp callback,
-             void *user_data);
+sqldbal_pipeline_begin(struct sqldbal_db *const db);
 
 /**
- * Get the insert id from the last SQL insert statement.
- *
- * The PostgreSQL driver uses the @p name parameter. When creating tables
- * in PostgreSQL, use the SERIAL data type and then concatenate the table name
- * with the sequence name and add '_seq' to the end to use as the @p name
- * parameter. For example, if you have table name 'table' and primary key
- * sequence named 'id', then the @p name parameter would get set to
- * "table_id_seq".
+ * Read the results of every statement executed since
+ * @ref sqldbal_pipeline_begin.
  *
- * @param[in]  db        See @ref sqldbal_db.
- * @param[in]  name      Sequence name.
- * @param[out] insert_id Last insert id.
- * @return               See @ref sqldbal_status_code.
+ * @param[in] db See @ref sqldbal_db.
+ * @retval SQLDBAL_STATUS_OK    Every queued statement succeeded.
+ * @retval SQLDBAL_STATUS_PARAM No pipeline has started.
+ * @retval SQLDBAL_STATUS_EXEC  A queued statement failed.
+ * @retval SQLDBAL_STATUS_NOMEM Memory allocation failed.
  */
 enum sqldbal_status_code
-sqldbal_last_insert_id(struct sqldbal_db *const db,
-                       const char *const name,
-                       uint64_t *insert_id);
+sqldbal_pipeline_end(struct sqldbal_db *const db);
 
 /**
- * Compile a SQL query and return a statement handle.
+ * Start loading rows into a table using the fastest method available in
+ * the driver.
  *
- * @param[in]  db      See @ref sqldbal_db.
- * @param[in]  sql     Null-terminated SQL string.
- * @param[in]  sql_len Length of @p sql in bytes up to the null-terminator,
- *                     or -1 to have the library compute the string length.
- * @param[out] stmt    See @ref sqldbal_stmt.
- * @return             See @ref sqldbal_status_code.
+ * Add the rows with @ref sqldbal_bulk_rows and then call
+ * @ref sqldbal_bulk_end, which also frees @p bulk. Always call
+ * @ref sqldbal_bulk_end, even if this function fails. The library encodes
+ * the rows into a single reusable buffer and sends it to the database
+ * whenever it fills up, so memory use does not depend on the number of
+ * rows. The table and column names get copied into the SQL statements
+ * without quoting.
+ *
+ * Drivers:
+ *   - MariaDB   : LOAD DATA LOCAL INFILE. The rows get written to a
+ *                 temporary file and sent when calling
+ *                 @ref sqldbal_bulk_end. The server must have local_infile
+ *                 enabled. The connection only allows LOCAL INFILE
+ *                 while @ref sqldbal_bulk_end runs the statement.
+ *   - PostgreSQL: COPY FROM STDIN using the binary format, or the text
+ *                 format if a column has a data type without a known
+ *                 binary format. Integer values written to timestamp
+ *                 columns get treated as microseconds since
+ *                 1970-01-01 00:00:00 UTC.
+ *   - SQLite    : INSERT statements with many rows each, inside one
+ *                 transaction unless the application has already started
+ *                 a transaction.
+ *
+ * @param[in]  db          See @ref sqldbal_db.
+ * @param[in]  table       Name of the table receiving the rows.
+ * @param[in]  column_list Names of the columns receiving values.
+ * @param[in]  num_cols    Number of entries in @p column_list.
+ * @param[out] bulk        Bulk load handle.
+ * @return                 See @ref sqldbal_status_code.
  */
 enum sqldbal_status_code
-sqldbal_stmt_prepare(struct sqldbal_db *const db,
-                     const char *const sql,
-                     size_t sql_len,
-                     struct sqldbal_stmt **stmt);
+sqldbal_bulk_begin(struct sqldbal_db *const db,
+                   const char *const table,
+                   const char *const *const column_list,
+                   size_t num_cols,
+                   struct sqldbal_bulk **bulk);
 
 /**
- * Assign binary data to a prepared statement placeholder.
+ * Start a bulk load that inserts the rows with multi-row INSERT
+ * statements.
  *
- * @param[in] stmt    See @ref sqldbal_stmt.
- * @param[in] col_idx Placeholder index starting at 0.
- * @param[in] blob    Binary data saved to BLOB or BYTEA types.
- * @param[in] blobsz  Length of @p blob in bytes.
- * @return            See @ref sqldbal_status_code.
+ * Works like @ref sqldbal_bulk_begin, but sends the rows as
+ * INSERT INTO table (columns) VALUES (...), (...), ... for every driver.
+ * The library prepares one statement for @p rows_per_insert rows and
+ * reuses it each time that many rows have been added with
+ * @ref sqldbal_bulk_rows. @ref sqldbal_bulk_end inserts the remaining
+ * rows.
+ *
+ * The number of rows in each statement gets reduced to fit the driver
+ * placeholder limit: 65535 for MariaDB and PostgreSQL, and
+ * SQLITE_MAX_VARIABLE_NUMBER for SQLite.
+ *
+ * If @p num_keys is not 0, rows that conflict with an existing row on the
+ * @p key_list columns update the other columns instead. This uses
+ * ON CONFLICT (keys) DO UPDATE for PostgreSQL and SQLite, and
+ * ON DUPLICATE KEY UPDATE for MariaDB. Rows that repeat the key values of
+ * an earlier row get applied in order, so the last row wins. PostgreSQL
+ * can not update the same row twice in one statement, so the library
+ * inserts the waiting rows early when a row repeats their key values.
+ *
+ * Unlike @ref sqldbal_bulk_begin, this does not start a transaction, so
+ * the rows inserted before an error stay in the database unless the
+ * application wraps the bulk load in a transaction.
+ *
+ * @param[in]  db              See @ref sqldbal_db.
+ * @param[in]  table           Table to load the rows into.
+ * @param[in]  column_list     Column names, in the order of the values
+ *                             given to @ref sqldbal_bulk_rows.
+ * @param[in]  num_cols        Number of columns in @p column_list.
+ * @param[in]  key_list        Columns of the unique key used for the
+ *                             upsert, or NULL.
+ * @param[in]  num_keys        Number of columns in @p key_list, or 0 for a
+ *                             plain INSERT.
+ * @param[in]  rows_per_insert Number of rows in each INSERT statement, or
+ *                             0 for the default of 128.
+ * @param[out] bulk            Bulk load handle. Always call
+ *                             @ref sqldbal_bulk_end on this handle, even
+ *                             if this function returns an error.
+ * @return                     See @ref sqldbal_status_code.
  */
 enum sqldbal_status_code
-sqldbal_stmt_bind_blob(struct sqldbal_stmt *const stmt,
-                       size_t col_idx,
-                       const void *const blob,
-                       size_t blobsz);
+sqldbal_bulk_begin_insert(struct sqldbal_db *const db,
+                          const char *const table,
+                          const char *const *const column_list,
+                          size_t num_cols,
+                          const char *const *const key_list,
+                          size_t num_keys,
+                          size_t rows_per_insert,
+                          struct sqldbal_bulk **bulk);
+
+/**
+ * Add rows to a bulk load started by @ref sqldbal_bulk_begin.
+ *
+ * The values use the same column-wise layout as
+ * @ref sqldbal_stmt_execute_batch, with one entry in @p param_list for each
+ * column. The library has finished with the values when this returns.
+ *
+ * @param[in] bulk       See @ref sqldbal_bulk_begin.
+ * @param[in] param_list See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in each of the @p param_list values.
+ * @return               See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_bulk_rows(struct sqldbal_bulk *const bulk,
+                  const struct sqldbal_batch_param *const param_list,
+                  size_t num_rows);
+
+/**
+ * Send the remaining rows, finish the bulk load, and free @p bulk.
+ *
+ * None of the rows get loaded if an error occurred during the bulk load.
+ * The exception is a SQLite bulk load inside a transaction started by the
+ * application. There, the rows inserted before the error stay in that
+ * transaction.
+ *
+ * @param[in] bulk See @ref sqldbal_bulk_begin.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_bulk_end(struct sqldbal_bulk *const bulk);
+
+/**
+ * Open a single large value for reading or writing in chunks.
+ *
+ * The value never has to fit in memory all at once, because
+ * @ref sqldbal_blob_read and @ref sqldbal_blob_write only move the bytes
+ * given to them.
+ *
+ * Driver support:
+ *   - MariaDB   : Fails with @ref SQLDBAL_STATUS_DRIVER_NOSUPPORT. Use
+ *                 @ref sqldbal_stmt_send_blob and
+ *                 @ref sqldbal_stmt_column_blob_read instead.
+ *   - PostgreSQL: Opens the large object with Oid @p row_id, ignoring
+ *                 @p table and @p column. Call this inside a transaction
+ *                 because the large object closes when it ends.
+ *   - SQLite    : Opens the BLOB in @p column of the row with rowid
+ *                 @p row_id in @p table.
+ *
+ * The caller must always call @ref sqldbal_blob_close, even on error.
+ *
+ * @param[in]  db     See @ref sqldbal_db.
+ * @param[in]  table  Table holding the value.
+ * @param[in]  column Column holding the value.
+ * @param[in]  row_id Identifies the row, see the driver notes above.
+ * @param[in]  write  Set to 1 to allow @ref sqldbal_blob_write.
+ * @param[out] blob   Large object handle.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_blob_open(struct sqldbal_db *const db,
+                  const char *const table,
+                  const char *const column,
+                  int64_t row_id,
+                  int write,
+                  struct sqldbal_blob **blob);
+
+/**
+ * Get the number of bytes in a value opened by @ref sqldbal_blob_open.
+ *
+ * @param[in]  blob See @ref sqldbal_blob_open.
+ * @param[out] size Number of bytes in the value.
+ */
+void
+sqldbal_blob_size(const struct sqldbal_blob *const blob,
+                  uint64_t *const size);
+
+/**
+ * Read part of a value opened by @ref sqldbal_blob_open.
+ *
+ * Reading past the end fails with @ref SQLDBAL_STATUS_PARAM.
+ *
+ * @param[in]  blob   See @ref sqldbal_blob_open.
+ * @param[in]  offset Byte offset from the start of the value.
+ * @param[out] buf    Buffer receiving @p len bytes.
+ * @param[in]  len    Number of bytes to read.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_blob_read(struct sqldbal_blob *const blob,
+                  uint64_t offset,
+                  void *const buf,
+                  size_t len);
+
+/**
+ * Write part of a value opened by @ref sqldbal_blob_open for writing.
+ *
+ * SQLite cannot change the size of the value this way, so writing past the
+ * end fails with @ref SQLDBAL_STATUS_PARAM. Insert a zeroblob() of the final
+ * size first. PostgreSQL large objects grow as needed.
+ *
+ * @param[in] blob   See @ref sqldbal_blob_open.
+ * @param[in] offset Byte offset from the start of the value.
+ * @param[in] buf    Bytes to write.
+ * @param[in] len    Number of bytes in @p buf.
+ * @return           See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_blob_write(struct sqldbal_blob *const blob,
+                   uint64_t offset,
+                   const void *const buf,
+                   size_t len);
+
+/**
+ * Close and free a value opened by @ref sqldbal_blob_open.
+ *
+ * @param[in] blob See @ref sqldbal_blob_open.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_blob_close(struct sqldbal_blob *const blob);
+
+/**
+ * Execute a SQL query directly without preparing statements.
+ *
+ * Invokes the application @p callback function for each row in the result set.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sql       SQL query to execute.
+ * @param[in] callback  Function called for each result row. The application
+ *                      can set this to NULL if it does not need to process
+ *                      the results.
+ * @param[in] user_data Application data to send to @p callback.
+ * @return              See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_exec(struct sqldbal_db *const db,
+             const char *const sql,
+             sqldbal_exec_callback_fp callback,
+             void *user_data);
+
+/**
+ * Same as @ref sqldbal_exec, but the rows can come from and go into the
+ * result cache set with @ref sqldbal_result_cache_set.
+ *
+ * Only use this for queries whose rows only change when the tables they
+ * read change. The cache does not know that a query calls functions like
+ * now() or random(). Statements that do not start with SELECT, statements
+ * that write or lock rows, queries without a @p callback, and queries in
+ * a transaction or pipeline run the same as @ref sqldbal_exec.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] sql       See @ref sqldbal_exec.
+ * @param[in] callback  See @ref sqldbal_exec.
+ * @param[in] user_data See @ref sqldbal_exec.
+ * @return              See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_exec_cached(struct sqldbal_db *const db,
+                    const char *const sql,
+                    sqldbal_exec_callback_fp callback,
+                    void *user_data);
+
+/**
+ * Get the insert id from the last SQL insert statement.
+ *
+ * The PostgreSQL driver uses the @p name parameter. When creating tables
+ * in PostgreSQL, use the SERIAL data type and then concatenate the table name
+ * with the sequence name and add '_seq' to the end to use as the @p name
+ * parameter. For example, if you have table name 'table' and primary key
+ * sequence named 'id', then the @p name parameter would get set to
+ * "table_id_seq".
+ *
+ * @param[in]  db        See @ref sqldbal_db.
+ * @param[in]  name      Sequence name.
+ * @param[out] insert_id Last insert id.
+ * @return               See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_last_insert_id(struct sqldbal_db *const db,
+                       const char *const name,
+                       uint64_t *insert_id);
+
+/**
+ * Check if the connection to the database server still works.
+ *
+ * The SQLite driver always succeeds because it does not have a server
+ * connection.
+ *
+ * @param[in] db See @ref sqldbal_db.
+ * @return       See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_ping(struct sqldbal_db *const db);
+
+/**
+ * Get the socket connected to the database server so that the application
+ * can add it to an event loop such as poll, epoll, or kqueue.
+ *
+ * The socket belongs to the driver, so the application must not read from,
+ * write to, or close it. The socket can change after reconnecting.
+ *
+ * @param[in]  db See @ref sqldbal_db.
+ * @param[out] fd Socket descriptor, or -1 if the driver does not have a
+ *                server connection (SQLite).
+ * @return        See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_db_socket_fd(struct sqldbal_db *const db,
+                     int *const fd);
+
+/**
+ * Enable the prepared statement cache, change its capacity, or disable it.
+ *
+ * While enabled, @ref sqldbal_stmt_close resets the statement and keeps
+ * it in a per-connection cache instead of freeing it, and
+ * @ref sqldbal_stmt_prepare returns a cached statement compiled from the
+ * same SQL text instead of compiling the statement again. When the cache
+ * holds more than @p capacity statements, it frees the least recently
+ * used statement.
+ *
+ * Changing the capacity frees all statements currently in the cache.
+ *
+ * @param[in] db       See @ref sqldbal_db.
+ * @param[in] capacity Maximum number of statements to keep in the cache,
+ *                     or 0 to disable the cache.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_cache_set_capacity(struct sqldbal_db *const db,
+                                size_t capacity);
+
+/**
+ * Get the prepared statement cache counters.
+ *
+ * @param[in]  db         See @ref sqldbal_db.
+ * @param[out] num_hits   Number of times @ref sqldbal_stmt_prepare used a
+ *                        cached statement.
+ * @param[out] num_misses Number of times @ref sqldbal_stmt_prepare had to
+ *                        compile a new statement while the cache was
+ *                        enabled.
+ * @param[out] num_stmts  Number of statements currently in the cache.
+ */
+void
+sqldbal_stmt_cache_stats(const struct sqldbal_db *const db,
+                         uint64_t *const num_hits,
+                         uint64_t *const num_misses,
+                         size_t *const num_stmts);
+
+/**
+ * Keep the rows returned by read-only queries on this connection and
+ * return them again for the same query without asking the database.
+ *
+ * Only queries run with @ref sqldbal_exec_cached and statements enabled
+ * with @ref sqldbal_stmt_set_result_cache use the cache, and only outside
+ * of transactions and pipelines. Results get found by the SQL text and,
+ * for prepared statements, the type and bytes of the values bound to the
+ * parameters. A cached result replays through the
+ * @ref sqldbal_exec_cached callback or through @ref sqldbal_stmt_fetch and
+ * the column functions. Cache hits do not call the
+ * @ref sqldbal_metrics_hook.
+ *
+ * Changes to the database do not remove cached results. The application
+ * must call @ref sqldbal_result_cache_invalidate after writing to a table,
+ * or use a TTL short enough to accept stale rows. Each connection,
+ * including each replica, has its own cache.
+ *
+ * Calling this again frees every result currently in the cache.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] max_bytes Maximum memory used by the cached results, or 0 to
+ *                      disable the cache. Results larger than this never
+ *                      get cached, and the least recently used results
+ *                      get freed to make room.
+ * @param[in] ttl_ms    Number of milliseconds a result stays valid, or -1
+ *                      to keep results until they get freed to make room
+ *                      or invalidated.
+ * @return              See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_result_cache_set(struct sqldbal_db *const db,
+                         size_t max_bytes,
+                         long ttl_ms);
+
+/**
+ * Remove cached results that mention a table or tag.
+ *
+ * A result gets removed if @p name appears in its SQL text as a whole word,
+ * ignoring case. Put tags in SQL comments, like "SELECT ... -- user_42", to
+ * invalidate groups of queries that do not share a table name.
+ *
+ * @param[in] db   See @ref sqldbal_db.
+ * @param[in] name Table name or tag, or NULL to remove every result.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_result_cache_invalidate(struct sqldbal_db *const db,
+                                const char *const name);
+
+/**
+ * Get the result cache counters.
+ *
+ * @param[in]  db         See @ref sqldbal_db.
+ * @param[out] num_hits   Number of queries answered from the cache.
+ * @param[out] num_misses Number of cacheable queries sent to the database.
+ * @param[out] num_bytes  Memory used by the results currently in the cache.
+ */
+void
+sqldbal_result_cache_stats(const struct sqldbal_db *const db,
+                           uint64_t *const num_hits,
+                           uint64_t *const num_misses,
+                           size_t *const num_bytes);
+
+/**
+ * Get the number of retries and the time spent waiting while the database
+ * was locked by another connection.
+ *
+ * Only the SQLite driver retries statements. The other drivers always
+ * report 0. See the BUSY_HANDLER option in @ref sqldbal_open.
+ *
+ * @param[in]  db          See @ref sqldbal_db.
+ * @param[out] num_retries Number of times a statement waited before trying
+ *                         again.
+ * @param[out] wait_ms     Total number of milliseconds spent waiting.
+ */
+void
+sqldbal_busy_stats(const struct sqldbal_db *const db,
+                   uint64_t *const num_retries,
+                   uint64_t *const wait_ms);
+
+/**
+ * Report the time spent and the amount of data handled by each statement on
+ * this connection.
+ *
+ * The library only reads the clock while a hook is set. The hook runs on
+ * the thread that called the measured function and must not use the
+ * connection.
+ *
+ * @param[in] db        See @ref sqldbal_db.
+ * @param[in] metrics   Gets called after each @ref sqldbal_metrics_event,
+ *                      or NULL to stop reporting.
+ * @param[in] user_data Passed to @p metrics.
+ */
+void
+sqldbal_metrics_hook(struct sqldbal_db *const db,
+                     sqldbal_metrics_fp metrics,
+                     void *const user_data);
+
+/**
+ * Route read-only statements from @p db to a replica connection.
+ *
+ * After adding replicas, @ref sqldbal_stmt_prepare compiles statements
+ * starting with SELECT on one of the replicas, and the returned statement
+ * runs there. A SELECT that mentions INTO, FOR UPDATE, FOR SHARE, LOCK IN
+ * SHARE MODE, sequence functions like nextval(), or advisory locks stays
+ * on @p db, as do all other statements and every statement prepared
+ * inside a transaction. Transactions started with
+ * @ref sqldbal_begin_transaction or with a BEGIN or START TRANSACTION run
+ * through @ref sqldbal_exec both count. Run a SELECT that calls other
+ * functions with side effects, or that must see the latest writes,
+ * inside a transaction to keep it on @p db. @ref sqldbal_exec always runs
+ * on @p db.
+ *
+ * Each statement goes to the replica with the fewest open statements,
+ * weighted by the average time the replica took to execute statements.
+ * When a statement fails to prepare or execute on a replica, the replica
+ * gets pinged and skipped for a few seconds if the connection does not
+ * respond. Errors in the statement itself do not skip the replica.
+ * Statements go to @p db while every replica is skipped. Use
+ * @ref sqldbal_replica_check_lag or @ref sqldbal_replica_eject to skip
+ * replicas that fall behind.
+ *
+ * Open @p replica with @ref sqldbal_open using the same driver as @p db.
+ * The replica then belongs to @p db, and @ref sqldbal_close on @p db also
+ * closes the replica. Use @p db and its replicas from one thread at a
+ * time.
+ *
+ * @param[in] db      Primary database connection. See @ref sqldbal_db.
+ * @param[in] replica Replica database connection.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_replica_add(struct sqldbal_db *const db,
+                    struct sqldbal_db *const replica);
+
+/**
+ * Stop routing statements to a replica for a period of time.
+ *
+ * @param[in] db       Primary database connection. See @ref sqldbal_db.
+ * @param[in] replica  Replica added with @ref sqldbal_replica_add.
+ * @param[in] eject_ms Number of milliseconds to skip the replica, or 0 to
+ *                     use the replica again immediately.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_replica_eject(struct sqldbal_db *const db,
+                      struct sqldbal_db *const replica,
+                      long eject_ms);
+
+/**
+ * Run a query on every replica that returns how far the replica lags
+ * behind, and skip the replicas that lag too much.
+ *
+ * The query must return the lag as an integer in the first column of the
+ * first row, for example with PostgreSQL:
+ * SELECT CAST(EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp())
+ * * 1000 AS BIGINT).
+ * Replicas that fail to run the query also get skipped.
+ *
+ * @param[in] db       Primary database connection. See @ref sqldbal_db.
+ * @param[in] sql      Null-terminated SQL query that returns the lag.
+ * @param[in] max_lag  Skip replicas that return a larger value.
+ * @param[in] eject_ms See @ref sqldbal_replica_eject.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_replica_check_lag(struct sqldbal_db *const db,
+                          const char *const sql,
+                          int64_t max_lag,
+                          long eject_ms);
+
+/**
+ * Compile a SQL query and return a statement handle.
+ *
+ * See @ref sqldbal_stmt_cache_set_capacity for reusing statements
+ * compiled earlier on the same connection.
+ *
+ * @param[in]  db      See @ref sqldbal_db.
+ * @param[in]  sql     Null-terminated SQL string.
+ * @param[in]  sql_len Length of @p sql in bytes up to the null-terminator,
+ *                     or -1 to have the library compute the string length.
+ * @param[out] stmt    See @ref sqldbal_stmt.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_prepare(struct sqldbal_db *const db,
+                     const char *const sql,
+                     size_t sql_len,
+                     struct sqldbal_stmt **stmt);
+
+/**
+ * Read the results of a statement through a server-side cursor, so that
+ * @ref sqldbal_stmt_fetch gets @p prefetch_rows rows from the server in
+ * each round trip. The client only holds one batch of rows at a time.
+ *
+ * The setting applies to each later @ref sqldbal_stmt_execute and takes
+ * precedence over @ref SQLDBAL_FLAG_STREAM_RESULTS. Unlike streaming, the
+ * connection can run other statements while the cursor has unread rows.
+ * Pipelines (@ref sqldbal_pipeline_begin) and asynchronous execution
+ * (@ref sqldbal_stmt_execute_start) read the full result without the
+ * cursor. A statement returned to the statement cache by
+ * @ref sqldbal_stmt_close no longer uses the cursor.
+ *
+ * MariaDB opens a read-only cursor with STMT_ATTR_CURSOR_TYPE and
+ * STMT_ATTR_PREFETCH_ROWS. PostgreSQL runs DECLARE ... CURSOR WITH HOLD
+ * using the SQL text of the statement, then FETCH FORWARD with the prefetch
+ * count, and only for statements that return rows. Outside of a
+ * transaction, the PostgreSQL server computes the full result when
+ * declaring the cursor. SQLite already reads the results one row at a
+ * time, so this setting has no effect there.
+ *
+ * @param[in] stmt          See @ref sqldbal_stmt.
+ * @param[in] prefetch_rows Number of rows to fetch in each round trip, or
+ *                          0 to read the results without a cursor.
+ * @return                  See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_set_cursor(struct sqldbal_stmt *const stmt,
+                        size_t prefetch_rows);
+
+/**
+ * Let the results of a statement come from and go into the result cache
+ * set with @ref sqldbal_result_cache_set.
+ *
+ * Call this before binding the parameters. The values bound afterwards
+ * become part of the cache key. Static binds get read when the statement
+ * executes, and a statement with a blob from
+ * @ref sqldbal_stmt_bind_blob_stream runs without the cache. Only enable
+ * this for queries whose rows only change when the tables they read
+ * change, since the cache does not know that a query calls functions like
+ * now() or random(). A statement returned to the statement cache by
+ * @ref sqldbal_stmt_close no longer uses the result cache.
+ *
+ * Fails with @ref SQLDBAL_STATUS_PARAM if the statement does not start
+ * with SELECT, if it writes or locks rows, or if the result cache was
+ * disabled when the statement got prepared.
+ *
+ * @param[in] stmt   See @ref sqldbal_stmt.
+ * @param[in] enable Set to 1 to use the result cache, or 0 to always run
+ *                   the statement on the database.
+ * @return           See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_set_result_cache(struct sqldbal_stmt *const stmt,
+                              int enable);
+
+/**
+ * Assign binary data to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_blob(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       const void *const blob,
+                       size_t blobsz);
 
 /**
  * Assign a 64-bit integer to a prepared statement placeholder.
  *
  * @param[in] stmt    See @ref sqldbal_stmt.
  * @param[in] col_idx Placeholder index starting at 0.
- * @param[in] i64     Integer to bind.
+ * @param[in] i64     Integer to bind.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_int64(struct sqldbal_stmt *const stmt,
+                        size_t col_idx,
+                        int64_t i64);
+
+/**
+ * Assign a string to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] s       Null-terminated string to bind.
+ * @param[in] slen    Length of @p s in bytes up to the null-terminator,
+ *                    or -1 to have the library compute the string length.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_text(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       const char *const s,
+                       size_t slen);
+
+/**
+ * Assign binary data to a prepared statement placeholder without copying
+ * it.
+ *
+ * This works like @ref sqldbal_stmt_bind_blob except that the statement
+ * references @p blob directly, so binding does not allocate memory. The
+ * caller must keep @p blob valid and unchanged until the statement gets
+ * executed for the last time with this value, gets bound to another value,
+ * or gets closed.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] blob    Binary data saved to BLOB or BYTEA types.
+ * @param[in] blobsz  Length of @p blob in bytes.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_blob_static(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              const void *const blob,
+                              size_t blobsz);
+
+/**
+ * Assign a string to a prepared statement placeholder without copying it.
+ *
+ * This works like @ref sqldbal_stmt_bind_text except that the statement
+ * references @p s directly, so binding does not allocate memory. The
+ * caller must keep @p s valid and unchanged until the statement gets
+ * executed for the last time with this value, gets bound to another value,
+ * or gets closed.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] s       Null-terminated string to bind.
+ * @param[in] slen    Length of @p s in bytes up to the null-terminator,
+ *                    or -1 to have the library compute the string length.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_text_static(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              const char *const s,
+                              size_t slen);
+
+/**
+ * Assign a double-precision floating point number to a prepared statement
+ * placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] d       Floating point number to bind.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_double(struct sqldbal_stmt *const stmt,
+                         size_t col_idx,
+                         double d);
+
+/**
+ * Assign a 32-bit integer to a prepared statement placeholder.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] i32     Integer to bind.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_int32(struct sqldbal_stmt *const stmt,
+                        size_t col_idx,
+                        int32_t i32);
+
+/**
+ * Assign a boolean value to a prepared statement placeholder.
+ *
+ * The value gets sent as the integer 1 or 0, which every driver accepts
+ * for boolean columns.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] b       Non-zero for true, or 0 for false.
  * @return            See @ref sqldbal_status_code.
  */
 enum sqldbal_status_code
-sqldbal_stmt_bind_int64(struct sqldbal_stmt *const stmt,
-                        size_t col_idx,
-                        int64_t i64);
+sqldbal_stmt_bind_bool(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       int b);
 
 /**
- * Assign a string to a prepared statement placeholder.
+ * Assign a timestamp to a prepared statement placeholder.
+ *
+ * Timestamps have the number of microseconds since
+ * 1970-01-01 00:00:00 UTC, ignoring leap seconds. Each driver sends them
+ * in the following form:
+ *   - MariaDB   : DATETIME value in UTC (range 0000-01-01 to 9999-12-31).
+ *   - PostgreSQL: timestamp in UTC, or the binary format with
+ *                 @ref SQLDBAL_FLAG_PQ_BINARY.
+ *   - SQLite    : Text in the form "YYYY-MM-DD HH:MM:SS[.ffffff]", which
+ *                 works with the SQLite date and time functions.
  *
  * @param[in] stmt    See @ref sqldbal_stmt.
  * @param[in] col_idx Placeholder index starting at 0.
- * @param[in] s       Null-terminated string to bind.
- * @param[in] slen    Length of @p s in bytes up to the null-terminator,
- *                    or -1 to have the library compute the string length.
+ * @param[in] ts      Microseconds since 1970-01-01 00:00:00 UTC.
  * @return            See @ref sqldbal_status_code.
  */
 enum sqldbal_status_code
-sqldbal_stmt_bind_text(struct sqldbal_stmt *const stmt,
-                       size_t col_idx,
-                       const char *const s,
-                       size_t slen);
+sqldbal_stmt_bind_timestamp(struct sqldbal_stmt *const stmt,
+                            size_t col_idx,
+                            int64_t ts);
 
 /**
  * Assign a NULL value to a prepared statement placeholder.
@@ -594,6 +1744,48 @@ enum sqldbal_status_code
 sqldbal_stmt_bind_null(struct sqldbal_stmt *const stmt,
                        size_t col_idx);
 
+/**
+ * Bind a blob placeholder whose value gets sent in chunks with
+ * @ref sqldbal_stmt_send_blob.
+ *
+ * The value starts out empty and each chunk gets appended to it.
+ *
+ * Driver support:
+ *   - MariaDB   : Each chunk goes straight to the server with
+ *                 mysql_stmt_send_long_data. Bind the other placeholders
+ *                 before sending the first chunk, and do not bind any
+ *                 placeholder again until @ref sqldbal_stmt_execute.
+ *   - PostgreSQL: The library collects the chunks and sends them when
+ *                 executing. Use @ref sqldbal_blob_open to avoid this.
+ *   - SQLite    : The library collects the chunks. Use
+ *                 @ref sqldbal_blob_open to avoid this.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_bind_blob_stream(struct sqldbal_stmt *const stmt,
+                              size_t col_idx);
+
+/**
+ * Append the next chunk to a placeholder bound with
+ * @ref sqldbal_stmt_bind_blob_stream.
+ *
+ * The library has finished with @p chunk when this returns.
+ *
+ * @param[in] stmt    See @ref sqldbal_stmt.
+ * @param[in] col_idx Placeholder index starting at 0.
+ * @param[in] chunk   Next bytes of the value.
+ * @param[in] chunksz Number of bytes in @p chunk.
+ * @return            See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_send_blob(struct sqldbal_stmt *const stmt,
+                       size_t col_idx,
+                       const void *const chunk,
+                       size_t chunksz);
+
 /**
  * Execute a compiled statement with bound parameters.
  *
@@ -608,6 +1800,90 @@ sqldbal_stmt_bind_null(struct sqldbal_stmt *const stmt,
 enum sqldbal_status_code
 sqldbal_stmt_execute(struct sqldbal_stmt *const stmt);
 
+/**
+ * Execute a compiled statement once for each row of column-wise values.
+ *
+ * This has the same effect as binding and executing each row with
+ * @ref sqldbal_stmt_execute, but uses the fastest bulk mechanism offered by
+ * each driver:
+ *   - MariaDB   : Array binding (STMT_ATTR_ARRAY_SIZE) on MariaDB servers.
+ *   - PostgreSQL: Pipeline mode with a single synchronization point.
+ *   - SQLite    : Bind/step/reset loop.
+ *
+ * If the application has not already started a transaction, the PostgreSQL
+ * and SQLite drivers run the entire batch in one implicit transaction so
+ * that no rows get applied if any of them fail.
+ *
+ * Any result sets produced by the statement get discarded. The placeholder
+ * values after this call are unspecified, so the application must bind every
+ * parameter again before calling @ref sqldbal_stmt_execute.
+ *
+ * @param[in] stmt       See @ref sqldbal_stmt.
+ * @param[in] param_list One entry for each placeholder in the statement.
+ *                       See @ref sqldbal_batch_param.
+ * @param[in] num_rows   Number of rows in each of the @p param_list values.
+ * @return               See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_execute_batch(struct sqldbal_stmt *const stmt,
+                           const struct sqldbal_batch_param *const param_list,
+                           size_t num_rows);
+
+/**
+ * Start executing a compiled statement without waiting for the server.
+ *
+ * This works like @ref sqldbal_stmt_execute, except that the function
+ * returns once the driver has queued the statement. Call
+ * @ref sqldbal_stmt_execute_poll when the socket from
+ * @ref sqldbal_db_socket_fd becomes ready, and then call
+ * @ref sqldbal_stmt_execute_finish before fetching the results. The
+ * application must not use any other statement on the same database
+ * connection until then. This fails with @ref SQLDBAL_STATUS_PARAM
+ * between @ref sqldbal_pipeline_begin and @ref sqldbal_pipeline_end.
+ *
+ * Driver support:
+ *   - MariaDB   : Requires @ref SQLDBAL_FLAG_MARIADB_NONBLOCK, otherwise this
+ *                 fails with @ref SQLDBAL_STATUS_PARAM.
+ *   - PostgreSQL: Always available.
+ *   - SQLite    : Runs the statement before returning because it does not
+ *                 have a server connection.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_execute_start(struct sqldbal_stmt *const stmt);
+
+/**
+ * Continue a statement started by @ref sqldbal_stmt_execute_start without
+ * blocking.
+ *
+ * Calling this function before the socket becomes ready does no harm.
+ *
+ * @param[in]  stmt        See @ref sqldbal_stmt.
+ * @param[out] wait_events Set of @ref sqldbal_wait_event to wait for before
+ *                         calling this function again, or 0 if the result
+ *                         has arrived and @ref sqldbal_stmt_execute_finish
+ *                         will not block.
+ * @return                 See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_execute_poll(struct sqldbal_stmt *const stmt,
+                          int *const wait_events);
+
+/**
+ * Complete a statement started by @ref sqldbal_stmt_execute_start.
+ *
+ * This blocks until the result arrives if @ref sqldbal_stmt_execute_poll
+ * has not returned 0 yet. Afterwards, the application can fetch the
+ * results in the same way as after @ref sqldbal_stmt_execute.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_execute_finish(struct sqldbal_stmt *const stmt);
+
 /**
  * Get the next row in the result set.
  *
@@ -621,9 +1897,94 @@ sqldbal_stmt_execute(struct sqldbal_stmt *const stmt);
 enum sqldbal_fetch_result
 sqldbal_stmt_fetch(struct sqldbal_stmt *const stmt);
 
+/**
+ * Get up to @p max_rows rows from the result set in column-wise buffers.
+ *
+ * Each call replaces the contents of the column vectors. The rows get
+ * converted in the same way as calling the sqldbal_stmt_column_* functions
+ * after each @ref sqldbal_stmt_fetch, but without checking the column
+ * index of every value.
+ *
+ * A call returns fewer than @p max_rows rows when the result set runs out
+ * or when the next row does not fit in the @ref sqldbal_column_vector::data
+ * buffer of a text or blob column. In the latter case, the next call
+ * returns that row first. The function fails with
+ * @ref SQLDBAL_STATUS_OVERFLOW if a single row does not fit.
+ *
+ * This function and @ref sqldbal_stmt_fetch can get mixed on the same
+ * result set.
+ *
+ * @param[in]     stmt        See @ref sqldbal_stmt.
+ * @param[in]     max_rows    Maximum number of rows to return, which must
+ *                            be greater than 0.
+ * @param[in,out] vector_list One entry for each column in the result.
+ *                            See @ref sqldbal_column_vector.
+ * @param[out]    num_rows    Number of rows stored in each column vector.
+ * @retval SQLDBAL_FETCH_ROW   Stored at least one row.
+ * @retval SQLDBAL_FETCH_DONE  No more rows available.
+ * @retval SQLDBAL_FETCH_ERROR Error occurred. See @ref sqldbal_status_code.
+ */
+enum sqldbal_fetch_result
+sqldbal_stmt_fetch_columns(struct sqldbal_stmt *const stmt,
+                           size_t max_rows,
+                           struct sqldbal_column_vector *const vector_list,
+                           size_t *const num_rows);
+
+/**
+ * Get the number of rows in the result set of the last
+ * @ref sqldbal_stmt_execute without fetching them.
+ *
+ * Only works when the client holds the full result set. This excludes
+ * results read with @ref SQLDBAL_FLAG_STREAM_RESULTS or
+ * @ref sqldbal_stmt_set_cursor, and every SQLite result because SQLite
+ * computes the rows while fetching them. These cases fail with
+ * @ref SQLDBAL_STATUS_DRIVER_NOSUPPORT.
+ *
+ * @param[in]  stmt     See @ref sqldbal_stmt.
+ * @param[out] num_rows Number of rows in the result set, or 0 on failure.
+ * @return              See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_num_rows(struct sqldbal_stmt *const stmt,
+                      uint64_t *num_rows);
+
+/**
+ * Move to a row in the result set, so that the next
+ * @ref sqldbal_stmt_fetch returns row number @p row.
+ *
+ * Seeking is a constant time operation when the client holds the full
+ * result set, under the same conditions as @ref sqldbal_stmt_num_rows.
+ * SQLite instead runs the statement again from the start and steps over
+ * the rows before @p row. Streamed and cursor results fail with
+ * @ref SQLDBAL_STATUS_DRIVER_NOSUPPORT.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @param[in] row  Row number starting at 0. Seeking to the number of rows
+ *                 makes the next fetch return @ref SQLDBAL_FETCH_DONE. A
+ *                 larger value fails with @ref SQLDBAL_STATUS_PARAM.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_seek(struct sqldbal_stmt *const stmt,
+                  uint64_t row);
+
 /**
  * Retrieve the result column as blob/binary data.
  *
+ * The library does not copy the value. @p blob points directly into the
+ * result memory of the driver: the PGresult for PostgreSQL, the result
+ * bind buffers for MariaDB/MySQL, and the column memory of SQLite. Values
+ * that the driver has to decode or convert, like PostgreSQL bytea columns
+ * in text format or numeric columns, get stored in a buffer that belongs
+ * to the statement and gets reused by later rows.
+ *
+ * Either way, the pointer remains valid until the next call to
+ * @ref sqldbal_stmt_fetch, @ref sqldbal_stmt_fetch_columns,
+ * @ref sqldbal_stmt_execute, @ref sqldbal_stmt_reset, or
+ * @ref sqldbal_stmt_close on the same statement. Retrieving the same
+ * column with a different sqldbal_stmt_column_* function can also
+ * invalidate it.
+ *
  * @param[in]  stmt    See @ref sqldbal_stmt.
  * @param[in]  col_idx Column index starting at 0.
  * @param[out] blob    Binary data.
@@ -636,6 +1997,33 @@ sqldbal_stmt_column_blob(struct sqldbal_stmt *const stmt,
                          const void **blob,
                          size_t *blobsz);
 
+/**
+ * Copy part of the result column into a buffer provided by the caller.
+ *
+ * Calling this with increasing @p offset values reads a large value in
+ * chunks. MariaDB/MySQL fetches each chunk from the result with
+ * mysql_stmt_fetch_column instead of sizing a buffer for the whole value.
+ * The other drivers already hold the value and only copy the requested
+ * bytes. PostgreSQL bytea columns in text format get decoded one chunk at
+ * a time.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index starting at 0.
+ * @param[in]  offset  Byte offset from the start of the value.
+ * @param[out] buf     Buffer receiving the bytes.
+ * @param[in]  bufsz   Maximum number of bytes to copy into @p buf.
+ * @param[out] len     Number of bytes copied, which is 0 once @p offset
+ *                     reaches the end of the value.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_column_blob_read(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              uint64_t offset,
+                              void *const buf,
+                              size_t bufsz,
+                              size_t *const len);
+
 /**
  * Retrieve the result column as an integer.
  *
@@ -652,6 +2040,9 @@ sqldbal_stmt_column_int64(struct sqldbal_stmt *const stmt,
 /**
  * Retrieve the result column as a string.
  *
+ * The string has the same lifetime as the data returned by
+ * @ref sqldbal_stmt_column_blob and does not get copied either.
+ *
  * @param[in]  stmt    See @ref sqldbal_stmt.
  * @param[in]  col_idx Column index starting at 0.
  * @param[out] text    Null-terminated string.
@@ -665,11 +2056,81 @@ sqldbal_stmt_column_text(struct sqldbal_stmt *const stmt,
                          const char **text,
                          size_t *textsz);
 
+/**
+ * Retrieve the result column as a double-precision floating point number.
+ *
+ * Floating point columns get converted directly from the driver result.
+ * Other columns get converted from their text value.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index starting at 0.
+ * @param[out] d       Floating point value, or 0 for NULL values.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_column_double(struct sqldbal_stmt *const stmt,
+                           size_t col_idx,
+                           double *d);
+
+/**
+ * Retrieve the result column as a 32-bit integer.
+ *
+ * Fails with @ref SQLDBAL_STATUS_COLUMN_COERCE if the value does not fit.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index starting at 0.
+ * @param[out] i32     32-bit integer value.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_column_int32(struct sqldbal_stmt *const stmt,
+                          size_t col_idx,
+                          int32_t *i32);
+
+/**
+ * Retrieve the result column as a boolean value.
+ *
+ * Integer columns convert to true for any non-zero value. The PostgreSQL
+ * boolean type also works in both the text and the binary format.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index starting at 0.
+ * @param[out] b       1 for true, or 0 for false and NULL values.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_column_bool(struct sqldbal_stmt *const stmt,
+                         size_t col_idx,
+                         int *b);
+
+/**
+ * Retrieve the result column as a timestamp.
+ *
+ * See @ref sqldbal_stmt_bind_timestamp for the timestamp format. Date and
+ * timestamp columns get converted directly from the driver result where
+ * possible. Text values must have the ISO 8601 form
+ * "YYYY-MM-DD[ HH:MM[:SS[.ffffff]]][+HH[:MM]]" and values without an
+ * offset get treated as UTC. The SQLite driver also treats integer values
+ * as seconds since 1970-01-01 00:00:00 UTC.
+ *
+ * @param[in]  stmt    See @ref sqldbal_stmt.
+ * @param[in]  col_idx Column index starting at 0.
+ * @param[out] ts      Microseconds since 1970-01-01 00:00:00 UTC, or 0 for
+ *                     NULL values.
+ * @return             See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_column_timestamp(struct sqldbal_stmt *const stmt,
+                              size_t col_idx,
+                              int64_t *ts);
+
 /**
  * Get the column data type.
  *
- * @note The Mariadb and PostgreSQL drivers currently only return the null
- *       and blob data types.
+ * @note The MariaDB and PostgreSQL drivers classify the columns using the
+ *       result metadata, so types like @ref SQLDBAL_TYPE_TEXT get reported
+ *       from the column declaration. The SQLite driver reports the storage
+ *       class of the current value.
  *
  * @param[in] stmt    See @ref sqldbal_stmt.
  * @param[in] col_idx Column index.
@@ -679,14 +2140,346 @@ enum sqldbal_column_type
 sqldbal_stmt_column_type(struct sqldbal_stmt *const stmt,
                          size_t col_idx);
 
+/**
+ * Discard any pending results and set every placeholder back to NULL so
+ * that the statement can run again with new parameters.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_stmt_reset(struct sqldbal_stmt *const stmt);
+
 /**
  * Free statement resources.
  *
+ * If the statement cache has been enabled, this resets the statement and
+ * returns it to the cache instead. See
+ * @ref sqldbal_stmt_cache_set_capacity.
+ *
  * @param[in] stmt See @ref sqldbal_stmt.
  * @return         See @ref sqldbal_status_code.
  */
 enum sqldbal_status_code
 sqldbal_stmt_close(struct sqldbal_stmt *const stmt);
 
+#ifdef SQLDBAL_POOL
+struct sqldbal_pool;
+
+/**
+ * Create a pool of database connections that multiple threads can share.
+ *
+ * The pool copies all of the connection parameters, including the
+ * @p option_list, and uses them to open new connections with
+ * @ref sqldbal_open when needed. The pool opens @p min_size connections
+ * at the same time with @ref sqldbal_open_parallel before returning.
+ *
+ * @param[in]  driver          See @ref sqldbal_open.
+ * @param[in]  location        See @ref sqldbal_open.
+ * @param[in]  port            See @ref sqldbal_open.
+ * @param[in]  username        See @ref sqldbal_open.
+ * @param[in]  password        See @ref sqldbal_open.
+ * @param[in]  database        See @ref sqldbal_open.
+ * @param[in]  flags           See @ref sqldbal_open.
+ * @param[in]  option_list     See @ref sqldbal_open.
+ * @param[in]  num_options     See @ref sqldbal_open.
+ * @param[in]  min_size        Keep at least this many connections open.
+ * @param[in]  max_size        Maximum number of open connections, which
+ *                             must be at least 1 and at least
+ *                             @p min_size.
+ * @param[in]  idle_timeout_ms Close connections idle for this many
+ *                             milliseconds while more than @p min_size
+ *                             connections remain open, or a negative
+ *                             value to keep idle connections open.
+ * @param[out] pool            New connection pool, or NULL on failure.
+ * @return                     See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_pool_open(enum sqldbal_driver driver,
+                  const char *const location,
+                  const char *const port,
+                  const char *const username,
+                  const char *const password,
+                  const char *const database,
+                  const unsigned long flags,
+                  const struct sqldbal_driver_option *const option_list,
+                  size_t num_options,
+                  size_t min_size,
+                  size_t max_size,
+                  long idle_timeout_ms,
+                  struct sqldbal_pool **pool);
+
+/**
+ * Get a database connection from the pool.
+ *
+ * This returns the most recently released idle connection first, which
+ * keeps the connection caches warm. Connections that stayed idle for a
+ * while get checked with @ref sqldbal_ping and replaced if no longer
+ * working. If no idle connections exist, this opens a new connection
+ * unless the pool already has the maximum number of connections open,
+ * in which case this waits for another thread to release a connection.
+ *
+ * @param[in]  pool       See @ref sqldbal_pool.
+ * @param[in]  timeout_ms Maximum time to wait for a connection in
+ *                        milliseconds, 0 to return immediately, or a
+ *                        negative value to wait indefinitely.
+ * @param[out] db         Database connection, or NULL on failure.
+ * @retval SQLDBAL_STATUS_OK      Got a connection.
+ * @retval SQLDBAL_STATUS_TIMEOUT No connection available in time.
+ * @return                        See @ref sqldbal_open for other errors.
+ */
+enum sqldbal_status_code
+sqldbal_pool_acquire(struct sqldbal_pool *const pool,
+                     long timeout_ms,
+                     struct sqldbal_db **db);
+
+/**
+ * Return a connection from @ref sqldbal_pool_acquire back to the pool.
+ *
+ * Close all statements using the connection before releasing it. If the
+ * connection has an error status, this clears the status and checks the
+ * connection with @ref sqldbal_ping. This also ends an active pipeline
+ * with @ref sqldbal_pipeline_end and rolls back a transaction started by
+ * @ref sqldbal_begin_transaction. The pool closes the connection if any
+ * of these steps fail.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ * @param[in] db   See @ref sqldbal_db.
+ * @retval SQLDBAL_STATUS_OK    Returned the connection to the pool.
+ * @retval SQLDBAL_STATUS_PARAM @p db did not come from
+ *                              @ref sqldbal_pool_acquire on @p pool, or
+ *                              has already been released.
+ * @return                      See @ref sqldbal_status_code for the
+ *                              errors that closed the connection.
+ */
+enum sqldbal_status_code
+sqldbal_pool_release(struct sqldbal_pool *const pool,
+                     struct sqldbal_db *const db);
+
+/**
+ * Get the connection assigned to the calling thread.
+ *
+ * The first call in each thread gets a connection with
+ * @ref sqldbal_pool_acquire and assigns it to the thread. Later calls in
+ * the same thread return the same connection without locking the pool.
+ * The connection goes back to the pool when the thread calls
+ * @ref sqldbal_pool_thread_release or when the thread exits.
+ *
+ * Do not pass the connection to @ref sqldbal_pool_release.
+ *
+ * @param[in]  pool       See @ref sqldbal_pool.
+ * @param[in]  timeout_ms See @ref sqldbal_pool_acquire.
+ * @param[out] db         Database connection, or NULL on failure.
+ * @return                See @ref sqldbal_pool_acquire.
+ */
+enum sqldbal_status_code
+sqldbal_pool_thread_db(struct sqldbal_pool *const pool,
+                       long timeout_ms,
+                       struct sqldbal_db **db);
+
+/**
+ * Return the connection assigned to the calling thread by
+ * @ref sqldbal_pool_thread_db back to the pool.
+ *
+ * Does nothing if the thread does not have a connection from this pool.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ * @return         See @ref sqldbal_pool_release.
+ */
+enum sqldbal_status_code
+sqldbal_pool_thread_release(struct sqldbal_pool *const pool);
+
+/**
+ * Get the number of connections tracked by the pool.
+ *
+ * @param[in]  pool     See @ref sqldbal_pool.
+ * @param[out] num_open Number of open connections, including the
+ *                      acquired connections.
+ * @param[out] num_idle Number of connections waiting in the pool.
+ */
+void
+sqldbal_pool_stats(struct sqldbal_pool *const pool,
+                   size_t *const num_open,
+                   size_t *const num_idle);
+
+/**
+ * Close all connections in the pool and free the pool.
+ *
+ * Release every acquired connection before calling this function,
+ * including the connections assigned to threads with
+ * @ref sqldbal_pool_thread_db.
+ *
+ * @param[in] pool See @ref sqldbal_pool.
+ * @return         See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_pool_close(struct sqldbal_pool *const pool);
+#endif /* SQLDBAL_POOL */
+
+#ifdef SQLDBAL_TRACE
+/**
+ * Maximum number of SQL bytes stored in @ref sqldbal_trace_entry::sql,
+ * including the null-terminator.
+ */
+#define SQLDBAL_TRACE_SQL_MAX 256
+
+/**
+ * Statement recorded by @ref sqldbal_trace_open.
+ */
+struct sqldbal_trace_entry{
+  /**
+   * SQL text, truncated to fit and always null-terminated. Empty for
+   * statements prepared before attaching the trace.
+   */
+  char sql[SQLDBAL_TRACE_SQL_MAX];
+
+  /**
+   * Length of the SQL text before truncating it.
+   */
+  size_t sql_len;
+
+  /**
+   * See @ref sqldbal_metrics::sql_hash.
+   */
+  uint64_t sql_hash;
+
+  /**
+   * Time spent running the statement in nanoseconds.
+   */
+  uint64_t elapsed_ns;
+
+  /**
+   * Number of rows passed to the @ref sqldbal_exec callback or sent by
+   * @ref sqldbal_stmt_execute_batch. SQLite always reports 0.
+   */
+  uint64_t num_rows;
+
+  /**
+   * Driver of the connection that ran the statement.
+   */
+  enum sqldbal_driver driver;
+
+  /**
+   * Either @ref SQLDBAL_METRICS_EXEC or @ref SQLDBAL_METRICS_EXECUTE.
+   * SQLite reports every statement as @ref SQLDBAL_METRICS_EXECUTE.
+   */
+  enum sqldbal_metrics_event event;
+
+  /**
+   * Status code after the statement. SQLite only reports statements that
+   * ran, so this is always @ref SQLDBAL_STATUS_OK there.
+   */
+  enum sqldbal_status_code status;
+
+  /**
+   * Set to 1 if the statement took at least the slow query threshold, or
+   * 0 if the statement got sampled.
+   */
+  int slow;
+};
+
+/**
+ * Callback function type that receives the @ref sqldbal_trace_entry
+ * records.
+ */
+typedef void
+(*sqldbal_trace_fp)(void *user_data,
+                    const struct sqldbal_trace_entry *const entry);
+
+struct sqldbal_trace;
+
+/**
+ * Create a slow query log and statement sampler.
+ *
+ * Connections attached with @ref sqldbal_trace_attach record every
+ * statement that takes at least @p slow_ns, and a random @p sample_rate
+ * fraction of the other statements. Recording copies the entry into a
+ * lock-free ring buffer and never waits for the @p callback. The entry
+ * gets dropped if the ring buffer is full.
+ *
+ * The entries get passed to @p callback when the application calls
+ * @ref sqldbal_trace_drain, or periodically from a background thread if
+ * @p flush_interval_ms is not negative.
+ *
+ * The SQLite driver uses the SQLITE_TRACE_PROFILE timings. The other
+ * drivers get timed by the library in the same places as the
+ * @ref sqldbal_metrics_hook.
+ *
+ * @param[in]  num_entries       Size of the ring buffer, rounded up to a
+ *                               power of 2 of at least 2.
+ * @param[in]  slow_ns           Slow query threshold in nanoseconds.
+ * @param[in]  sample_rate       Fraction of the faster statements to
+ *                               record, from 0 to 1.
+ * @param[in]  callback          Receives each recorded entry.
+ * @param[in]  user_data         Passed to @p callback.
+ * @param[in]  flush_interval_ms Positive number of milliseconds between
+ *                               drains by the background thread, or a
+ *                               negative value to not start the thread.
+ * @param[out] trace             New trace, or NULL on failure.
+ * @return                       See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_trace_open(size_t num_entries,
+                   uint64_t slow_ns,
+                   double sample_rate,
+                   sqldbal_trace_fp callback,
+                   void *user_data,
+                   long flush_interval_ms,
+                   struct sqldbal_trace **trace);
+
+/**
+ * Start or stop recording the statements of a connection.
+ *
+ * Several connections, including connections used by different threads,
+ * can record into the same trace. The replica connections already added
+ * with @ref sqldbal_replica_add get attached too.
+ *
+ * @param[in] db    See @ref sqldbal_db.
+ * @param[in] trace See @ref sqldbal_trace_open, or NULL to stop recording.
+ * @return          See @ref sqldbal_status_code.
+ */
+enum sqldbal_status_code
+sqldbal_trace_attach(struct sqldbal_db *const db,
+                     struct sqldbal_trace *const trace);
+
+/**
+ * Pass the recorded entries to the trace callback.
+ *
+ * Only one thread drains at a time, so this waits if the background
+ * thread is already draining.
+ *
+ * @param[in] trace See @ref sqldbal_trace_open.
+ * @return          Number of entries passed to the callback.
+ */
+size_t
+sqldbal_trace_drain(struct sqldbal_trace *const trace);
+
+/**
+ * Get the number of entries recorded and dropped since
+ * @ref sqldbal_trace_open.
+ *
+ * @param[in]  trace        See @ref sqldbal_trace_open.
+ * @param[out] num_recorded Number of entries added to the ring buffer.
+ * @param[out] num_dropped  Number of entries dropped because the ring
+ *                          buffer was full.
+ */
+void
+sqldbal_trace_stats(struct sqldbal_trace *const trace,
+                    uint64_t *const num_recorded,
+                    uint64_t *const num_dropped);
+
+/**
+ * Stop the background thread, drain the remaining entries, and free the
+ * trace.
+ *
+ * Detach or close every connection using the trace before calling this
+ * function.
+ *
+ * @param[in] trace See @ref sqldbal_trace_open.
+ */
+void
+sqldbal_trace_close(struct sqldbal_trace *const trace);
+#endif /* SQLDBAL_TRACE */
+
 #endif /* SQLDBAL_H */
 
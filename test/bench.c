@@ -0,0 +1,953 @@
+/**
+ * @file
+ * @brief Benchmark the SQLDBAL library.
+ * @author James Humphrey (mail@somnisoft.com)
+ * @version 0.99
+ *
+ * Measures the driver hot paths so that changes to the library can get
+ * compared against earlier builds. Each benchmark repeats one operation and
+ * reports the operations per second, the latency percentiles, and the number
+ * of library memory allocations per operation.
+ *
+ * This program links with the test seams, which count the allocations made
+ * by the library. Allocations made inside the database client libraries do
+ * not get counted.
+ *
+ * Usage: bench [-n num_ops] [-d mariadb|postgresql|sqlite]...
+ *
+ * The bench_sqlite program runs the same benchmarks with the library
+ * compiled for SQLDBAL_SINGLE_DRIVER=sqlite, so its results can get compared
+ * against the sqlite results of the bench program.
+ *
+ * This software has been placed into the public domain using CC0.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "test.h"
+
+/**
+ * Number of rows in the bench table read by the fetch benchmarks.
+ */
+#define SQLDBAL_BENCH_ROWS 1000
+
+/**
+ * Number of rows sent by each batch and bulk load operation.
+ */
+#define SQLDBAL_BENCH_BATCH_ROWS 100
+
+/**
+ * Number of bytes in the blob column of each bench table row.
+ */
+#define SQLDBAL_BENCH_ROW_BLOB_SZ 64
+
+/**
+ * Number of bytes in the blob round trip benchmark.
+ */
+#define SQLDBAL_BENCH_BLOB_SZ 4096
+
+/**
+ * Number of rows read ahead by the cursor fetch benchmark.
+ */
+#define SQLDBAL_BENCH_CURSOR_PREFETCH 100
+
+/**
+ * Operations that process @ref SQLDBAL_BENCH_ROWS rows run this many times
+ * less often than the single row operations.
+ */
+#define SQLDBAL_BENCH_HEAVY_DIVISOR 10
+
+/**
+ * Maximum SQL query length used by the benchmarks.
+ */
+#define SQLDBAL_BENCH_SQL_SZ 1000
+
+/**
+ * Function type for a single benchmark operation.
+ *
+ * @param[in] i Operation number starting from 0.
+ */
+typedef void
+(*sqldbal_bench_fp)(size_t i);
+
+/**
+ * Database driver that can get selected with the -d option.
+ */
+struct sqldbal_bench_driver{
+  /**
+   * Driver name, which also names the configuration file.
+   */
+  const char *const name;
+
+  /**
+   * See @ref sqldbal_driver.
+   */
+  enum sqldbal_driver driver;
+
+  /**
+   * Padding structure to align.
+   */
+  char pad[4];
+};
+
+/**
+ * Drivers benchmarked by this program.
+ */
+static const struct sqldbal_bench_driver
+g_bench_driver_list[] = {
+  {"mariadb"   , SQLDBAL_DRIVER_MARIADB   , {0}},
+  {"postgresql", SQLDBAL_DRIVER_POSTGRESQL, {0}},
+  {"sqlite"    , SQLDBAL_DRIVER_SQLITE    , {0}}
+};
+
+/**
+ * Column values used to fill the bench tables with
+ * @ref sqldbal_stmt_execute_batch and @ref sqldbal_bulk_rows.
+ */
+struct sqldbal_bench_batch{
+  /**
+   * Values for the id column.
+   */
+  int64_t id_list[SQLDBAL_BENCH_ROWS];
+
+  /**
+   * Values for the num column.
+   */
+  int64_t num_list[SQLDBAL_BENCH_ROWS];
+
+  /**
+   * Values for the name column.
+   */
+  const char *name_list[SQLDBAL_BENCH_ROWS];
+
+  /**
+   * Values for the data column.
+   */
+  const void *data_list[SQLDBAL_BENCH_ROWS];
+
+  /**
+   * Number of bytes in each @ref data_list entry.
+   */
+  size_t data_len_list[SQLDBAL_BENCH_ROWS];
+
+  /**
+   * Storage for @ref name_list.
+   */
+  char name_buf[SQLDBAL_BENCH_ROWS][16];
+
+  /**
+   * Storage for @ref data_list.
+   */
+  unsigned char data_buf[SQLDBAL_BENCH_ROW_BLOB_SZ];
+
+  /**
+   * See @ref sqldbal_batch_param.
+   */
+  struct sqldbal_batch_param param_list[4];
+};
+
+/**
+ * Database handle used by the current benchmark.
+ */
+static struct sqldbal_db *g_db;
+
+/**
+ * Statement used by the current benchmark.
+ */
+static struct sqldbal_stmt *g_stmt;
+
+/**
+ * Second statement used by the blob round trip benchmark.
+ */
+static struct sqldbal_stmt *g_stmt2;
+
+/**
+ * Values used by the batch and bulk load benchmarks.
+ */
+static struct sqldbal_bench_batch *g_batch;
+
+/**
+ * Data sent by the blob round trip benchmark.
+ */
+static unsigned char g_blob[SQLDBAL_BENCH_BLOB_SZ];
+
+/**
+ * Number of times to run each single row operation.
+ */
+static size_t g_num_ops = 1000;
+
+/**
+ * Label printed in front of each result line.
+ */
+static char g_label[32];
+
+/**
+ * Buffer for constructing SQL queries.
+ */
+static char g_sql[SQLDBAL_BENCH_SQL_SZ];
+
+/**
+ * Get a monotonic time in nanoseconds.
+ *
+ * @return Nanoseconds since an unspecified starting point.
+ */
+static uint64_t
+sqldbal_bench_time_ns(void){
+  struct timespec ts;
+  int rc;
+
+  rc = clock_gettime(CLOCK_MONOTONIC, &ts);
+  assert(rc == 0);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Compare two latency samples for qsort().
+ *
+ * @param[in] a First sample.
+ * @param[in] b Second sample.
+ * @retval -1 @p a is less than @p b.
+ * @retval  0 @p a equals @p b.
+ * @retval  1 @p a is greater than @p b.
+ */
+static int
+sqldbal_bench_cmp_latency(const void *a,
+                          const void *b){
+  uint64_t la;
+  uint64_t lb;
+  int rc;
+
+  la = *(const uint64_t *)a;
+  lb = *(const uint64_t *)b;
+  if(la < lb){
+    rc = -1;
+  }
+  else if(la > lb){
+    rc = 1;
+  }
+  else{
+    rc = 0;
+  }
+  return rc;
+}
+
+/**
+ * Convert a latency sample to microseconds.
+ *
+ * @param[in] latency_list Sorted latency samples in nanoseconds.
+ * @param[in] num_ops      Number of entries in @p latency_list.
+ * @param[in] percentile   Percentile to return, from 0 to 100.
+ * @return Latency in microseconds.
+ */
+static double
+sqldbal_bench_percentile_us(const uint64_t *const latency_list,
+                            size_t num_ops,
+                            size_t percentile){
+  size_t idx;
+
+  idx = (num_ops - 1) * percentile / 100;
+  return (double)latency_list[idx] / 1000;
+}
+
+/**
+ * Run a benchmark operation and print the results.
+ *
+ * @param[in] name    Benchmark name.
+ * @param[in] op      Operation to measure.
+ * @param[in] num_ops Number of times to run @p op.
+ */
+static void
+sqldbal_bench_run(const char *const name,
+                  sqldbal_bench_fp op,
+                  size_t num_ops){
+  uint64_t *latency_list;
+  uint64_t start;
+  uint64_t total;
+  size_t num_alloc;
+  size_t i;
+
+  if(num_ops == 0){
+    num_ops = 1;
+  }
+  latency_list = malloc(num_ops * sizeof(*latency_list));
+  assert(latency_list);
+
+  total = 0;
+  num_alloc = g_sqldbal_test_num_alloc;
+  for(i = 0; i < num_ops; i++){
+    start = sqldbal_bench_time_ns();
+    op(i);
+    latency_list[i] = sqldbal_bench_time_ns() - start;
+    total += latency_list[i];
+  }
+  num_alloc = g_sqldbal_test_num_alloc - num_alloc;
+
+  qsort(latency_list,
+        num_ops,
+        sizeof(*latency_list),
+        sqldbal_bench_cmp_latency);
+  if(total == 0){
+    total = 1;
+  }
+  printf("%-18s %-26s %12.0f %10.1f %10.1f %10.1f %10.1f %10.2f\n",
+         g_label,
+         name,
+         (double)num_ops * 1000000000 / (double)total,
+         sqldbal_bench_percentile_us(latency_list, num_ops, 50),
+         sqldbal_bench_percentile_us(latency_list, num_ops, 90),
+         sqldbal_bench_percentile_us(latency_list, num_ops, 99),
+         sqldbal_bench_percentile_us(latency_list, num_ops, 100),
+         (double)num_alloc / (double)num_ops);
+  free(latency_list);
+}
+
+/**
+ * Print the result column headings.
+ */
+static void
+sqldbal_bench_print_header(void){
+  printf("%-18s %-26s %12s %10s %10s %10s %10s %10s\n",
+         "driver",
+         "benchmark",
+         "ops/s",
+         "p50(us)",
+         "p90(us)",
+         "p99(us)",
+         "max(us)",
+         "allocs/op");
+}
+
+/**
+ * Check the result of a library call.
+ *
+ * Prints the database error message before aborting so that a misconfigured
+ * server can get diagnosed.
+ *
+ * @param[in] rc See @ref sqldbal_status_code.
+ */
+static void
+sqldbal_bench_check(enum sqldbal_status_code rc){
+  const char *errstr;
+
+  if(rc != SQLDBAL_STATUS_OK){
+    sqldbal_errstr(g_db, &errstr);
+    fprintf(stderr, "%s: status %d: %s\n", g_label, (int)rc, errstr);
+  }
+  assert(rc == SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Run a SQL query without a result set.
+ *
+ * @param[in] sql SQL query.
+ */
+static void
+sqldbal_bench_exec(const char *const sql){
+  sqldbal_bench_check(sqldbal_exec(g_db, sql, NULL, NULL));
+}
+
+/**
+ * Get the placeholder text for a statement parameter.
+ *
+ * @param[in] idx Placeholder index starting from 0.
+ * @return Placeholder text for the current database driver.
+ */
+static const char *
+sqldbal_bench_placeholder(size_t idx){
+  static const char *const pq_placeholder_list[] = {
+    "$1",
+    "$2",
+    "$3",
+    "$4"
+  };
+  const char *placeholder;
+
+  assert(idx < sizeof(pq_placeholder_list) / sizeof(pq_placeholder_list[0]));
+  if(sqldbal_driver_type(g_db) == SQLDBAL_DRIVER_POSTGRESQL){
+    placeholder = pq_placeholder_list[idx];
+  }
+  else{
+    placeholder = "?";
+  }
+  return placeholder;
+}
+
+/**
+ * Compile the global statement.
+ *
+ * @param[in]  sql  SQL query.
+ * @param[out] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_bench_prepare(const char *const sql,
+                      struct sqldbal_stmt **stmt){
+  sqldbal_bench_check(sqldbal_stmt_prepare(g_db, sql, SIZE_MAX, stmt));
+}
+
+/**
+ * Close a statement.
+ *
+ * @param[in] stmt See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_bench_close(struct sqldbal_stmt *const stmt){
+  sqldbal_bench_check(sqldbal_stmt_close(stmt));
+}
+
+/**
+ * Fill @ref g_batch with the rows starting at @p first_id.
+ *
+ * @param[in] first_id Value of the id column in the first row.
+ * @param[in] num_rows Number of rows to fill.
+ */
+static void
+sqldbal_bench_batch_fill(int64_t first_id,
+                         size_t num_rows){
+  size_t i;
+
+  for(i = 0; i < num_rows; i++){
+    g_batch->id_list[i]  = first_id + (int64_t)i;
+    g_batch->num_list[i] = g_batch->id_list[i] * 7;
+  }
+}
+
+/**
+ * Set up @ref g_batch.
+ */
+static void
+sqldbal_bench_batch_init(void){
+  struct sqldbal_batch_param *param;
+  size_t i;
+
+  g_batch = calloc(1, sizeof(*g_batch));
+  assert(g_batch);
+  memset(g_batch->data_buf, 'd', sizeof(g_batch->data_buf));
+  for(i = 0; i < SQLDBAL_BENCH_ROWS; i++){
+    sprintf(g_batch->name_buf[i], "name-%04zu", i);
+    g_batch->name_list[i]     = g_batch->name_buf[i];
+    g_batch->data_list[i]     = g_batch->data_buf;
+    g_batch->data_len_list[i] = sizeof(g_batch->data_buf);
+  }
+
+  param = &g_batch->param_list[0];
+  param->type = SQLDBAL_TYPE_INT;
+  param->i64_list = g_batch->id_list;
+
+  param = &g_batch->param_list[1];
+  param->type = SQLDBAL_TYPE_INT;
+  param->i64_list = g_batch->num_list;
+
+  param = &g_batch->param_list[2];
+  param->type = SQLDBAL_TYPE_TEXT;
+  param->text_list = g_batch->name_list;
+
+  param = &g_batch->param_list[3];
+  param->type = SQLDBAL_TYPE_BLOB;
+  param->blob_list = g_batch->data_list;
+  param->length_list = g_batch->data_len_list;
+}
+
+/**
+ * Compile the statement that inserts one row into a bench table.
+ *
+ * @param[in]  table Table name.
+ * @param[out] stmt  See @ref sqldbal_stmt.
+ */
+static void
+sqldbal_bench_prepare_insert(const char *const table,
+                             struct sqldbal_stmt **stmt){
+  sprintf(g_sql,
+          "INSERT INTO %s(id, num, name, data) VALUES(%s, %s, %s, %s)",
+          table,
+          sqldbal_bench_placeholder(0),
+          sqldbal_bench_placeholder(1),
+          sqldbal_bench_placeholder(2),
+          sqldbal_bench_placeholder(3));
+  sqldbal_bench_prepare(g_sql, stmt);
+}
+
+/**
+ * Create the bench tables and fill the bench table with
+ * @ref SQLDBAL_BENCH_ROWS rows.
+ */
+static void
+sqldbal_bench_create_tables(void){
+  const char *const table_list[] = {
+    "bench",
+    "bench_insert"
+  };
+  const char *blob_type;
+  size_t i;
+
+  if(sqldbal_driver_type(g_db) == SQLDBAL_DRIVER_POSTGRESQL){
+    blob_type = "BYTEA";
+  }
+  else{
+    blob_type = "BLOB";
+  }
+  for(i = 0; i < sizeof(table_list) / sizeof(table_list[0]); i++){
+    sprintf(g_sql, "DROP TABLE IF EXISTS %s", table_list[i]);
+    sqldbal_bench_exec(g_sql);
+    sprintf(g_sql,
+            "CREATE TABLE %s("
+            "  id   INTEGER,"
+            "  num  BIGINT,"
+            "  name TEXT,"
+            "  data %s,"
+            "  PRIMARY KEY(id)"
+            ")",
+            table_list[i],
+            blob_type);
+    sqldbal_bench_exec(g_sql);
+  }
+
+  sqldbal_bench_batch_fill(1, SQLDBAL_BENCH_ROWS);
+  sqldbal_bench_prepare_insert("bench", &g_stmt);
+  sqldbal_bench_check(sqldbal_stmt_execute_batch(g_stmt,
+                                                 g_batch->param_list,
+                                                 SQLDBAL_BENCH_ROWS));
+  sqldbal_bench_close(g_stmt);
+}
+
+/**
+ * Remove every row from the bench_insert table and start a transaction.
+ */
+static void
+sqldbal_bench_insert_begin(void){
+  sqldbal_bench_exec("DELETE FROM bench_insert");
+  sqldbal_bench_check(sqldbal_begin_transaction(g_db));
+}
+
+/**
+ * Commit the rows added by an insert benchmark.
+ */
+static void
+sqldbal_bench_insert_end(void){
+  sqldbal_bench_check(sqldbal_commit(g_db));
+}
+
+/**
+ * Compile and free the single row select statement.
+ *
+ * @param[in] i Unused.
+ */
+static void
+sqldbal_bench_op_prepare(size_t i){
+  (void)i;
+  sqldbal_bench_prepare(g_sql, &g_stmt);
+  sqldbal_bench_close(g_stmt);
+}
+
+/**
+ * Look up one row by the primary key, resetting the statement from the
+ * previous lookup first.
+ *
+ * @param[in] i Operation number used to pick the row.
+ */
+static void
+sqldbal_bench_op_select_row(size_t i){
+  int64_t id;
+  int64_t num;
+
+  id = (int64_t)(i % SQLDBAL_BENCH_ROWS) + 1;
+  sqldbal_bench_check(sqldbal_stmt_reset(g_stmt));
+  sqldbal_bench_check(sqldbal_stmt_bind_int64(g_stmt, 0, id));
+  sqldbal_bench_check(sqldbal_stmt_execute(g_stmt));
+  assert(sqldbal_stmt_fetch(g_stmt) == SQLDBAL_FETCH_ROW);
+  sqldbal_bench_check(sqldbal_stmt_column_int64(g_stmt, 0, &num));
+  assert(num == id * 7);
+  assert(sqldbal_stmt_fetch(g_stmt) == SQLDBAL_FETCH_DONE);
+}
+
+/**
+ * Insert one row by binding every column.
+ *
+ * @param[in] i Operation number used as the primary key.
+ */
+static void
+sqldbal_bench_op_insert_bind(size_t i){
+  const char *name;
+
+  name = g_batch->name_list[i % SQLDBAL_BENCH_ROWS];
+  sqldbal_bench_check(sqldbal_stmt_bind_int64(g_stmt, 0, (int64_t)i));
+  sqldbal_bench_check(sqldbal_stmt_bind_int64(g_stmt, 1, (int64_t)i * 7));
+  sqldbal_bench_check(sqldbal_stmt_bind_text(g_stmt,
+                                             2,
+                                             name,
+                                             SIZE_MAX));
+  sqldbal_bench_check(sqldbal_stmt_bind_blob(g_stmt,
+                                             3,
+                                             g_batch->data_buf,
+                                             sizeof(g_batch->data_buf)));
+  sqldbal_bench_check(sqldbal_stmt_execute(g_stmt));
+}
+
+/**
+ * Insert @ref SQLDBAL_BENCH_BATCH_ROWS rows with one call to
+ * @ref sqldbal_stmt_execute_batch.
+ *
+ * @param[in] i Operation number used to pick the primary keys.
+ */
+static void
+sqldbal_bench_op_insert_batch(size_t i){
+  sqldbal_bench_batch_fill((int64_t)(i * SQLDBAL_BENCH_BATCH_ROWS),
+                           SQLDBAL_BENCH_BATCH_ROWS);
+  sqldbal_bench_check(sqldbal_stmt_execute_batch(g_stmt,
+                                                 g_batch->param_list,
+                                                 SQLDBAL_BENCH_BATCH_ROWS));
+}
+
+/**
+ * Insert @ref SQLDBAL_BENCH_BATCH_ROWS rows with one bulk load.
+ *
+ * @param[in] i Operation number used to pick the primary keys.
+ */
+static void
+sqldbal_bench_op_insert_bulk(size_t i){
+  const char *const column_list[] = {
+    "id",
+    "num",
+    "name",
+    "data"
+  };
+  struct sqldbal_bulk *bulk;
+
+  sqldbal_bench_batch_fill((int64_t)(i * SQLDBAL_BENCH_BATCH_ROWS),
+                           SQLDBAL_BENCH_BATCH_ROWS);
+  sqldbal_bench_check(sqldbal_bulk_begin(g_db,
+                                         "bench_insert",
+                                         column_list,
+                                         4,
+                                         &bulk));
+  sqldbal_bench_check(sqldbal_bulk_rows(bulk,
+                                        g_batch->param_list,
+                                        SQLDBAL_BENCH_BATCH_ROWS));
+  sqldbal_bench_check(sqldbal_bulk_end(bulk));
+}
+
+/**
+ * Insert @ref SQLDBAL_BENCH_BATCH_ROWS rows with one multi-row INSERT
+ * statement from @ref sqldbal_bulk_begin_insert.
+ *
+ * @param[in] i Operation number used to pick the primary keys.
+ */
+static void
+sqldbal_bench_op_insert_multirow(size_t i){
+  const char *const column_list[] = {
+    "id",
+    "num",
+    "name",
+    "data"
+  };
+  struct sqldbal_bulk *bulk;
+
+  sqldbal_bench_batch_fill((int64_t)(i * SQLDBAL_BENCH_BATCH_ROWS),
+                           SQLDBAL_BENCH_BATCH_ROWS);
+  sqldbal_bench_check(sqldbal_bulk_begin_insert(g_db,
+                                                "bench_insert",
+                                                column_list,
+                                                4,
+                                                NULL,
+                                                0,
+                                                SQLDBAL_BENCH_BATCH_ROWS,
+                                                &bulk));
+  sqldbal_bench_check(sqldbal_bulk_rows(bulk,
+                                        g_batch->param_list,
+                                        SQLDBAL_BENCH_BATCH_ROWS));
+  sqldbal_bench_check(sqldbal_bulk_end(bulk));
+}
+
+/**
+ * Read every row and column from the bench table.
+ *
+ * @param[in] i Unused.
+ */
+static void
+sqldbal_bench_op_fetch_all(size_t i){
+  const void *blob;
+  const char *text;
+  size_t num_rows;
+  size_t len;
+  int64_t i64;
+
+  (void)i;
+  num_rows = 0;
+  sqldbal_bench_check(sqldbal_stmt_execute(g_stmt));
+  while(sqldbal_stmt_fetch(g_stmt) == SQLDBAL_FETCH_ROW){
+    sqldbal_bench_check(sqldbal_stmt_column_int64(g_stmt, 0, &i64));
+    sqldbal_bench_check(sqldbal_stmt_column_int64(g_stmt, 1, &i64));
+    sqldbal_bench_check(sqldbal_stmt_column_text(g_stmt, 2, &text, &len));
+    sqldbal_bench_check(sqldbal_stmt_column_blob(g_stmt, 3, &blob, &len));
+    num_rows += 1;
+  }
+  sqldbal_bench_check(sqldbal_status_code_get(g_db));
+  assert(num_rows == SQLDBAL_BENCH_ROWS);
+}
+
+/**
+ * Write a blob to a row and read it back.
+ *
+ * @param[in] i Operation number used to change the blob contents.
+ */
+static void
+sqldbal_bench_op_blob_round_trip(size_t i){
+  const void *blob;
+  size_t blobsz;
+
+  g_blob[0] = (unsigned char)i;
+  sqldbal_bench_check(sqldbal_stmt_bind_blob(g_stmt,
+                                             0,
+                                             g_blob,
+                                             sizeof(g_blob)));
+  sqldbal_bench_check(sqldbal_stmt_execute(g_stmt));
+
+  sqldbal_bench_check(sqldbal_stmt_execute(g_stmt2));
+  assert(sqldbal_stmt_fetch(g_stmt2) == SQLDBAL_FETCH_ROW);
+  sqldbal_bench_check(sqldbal_stmt_column_blob(g_stmt2, 0, &blob, &blobsz));
+  assert(blobsz == sizeof(g_blob));
+  assert(memcmp(blob, g_blob, blobsz) == 0);
+  assert(sqldbal_stmt_fetch(g_stmt2) == SQLDBAL_FETCH_DONE);
+}
+
+/**
+ * Count the rows passed to the @ref sqldbal_exec callback.
+ *
+ * @param[in] user_data       Number of rows.
+ * @param[in] num_cols        Unused.
+ * @param[in] col_result_list Unused.
+ * @param[in] col_length_list Unused.
+ * @retval 0 Continue processing the results.
+ */
+static int
+sqldbal_bench_exec_callback(void *user_data,
+                            size_t num_cols,
+                            char **col_result_list,
+                            size_t *col_length_list){
+  size_t *num_rows;
+
+  (void)num_cols;
+  (void)col_result_list;
+  (void)col_length_list;
+  num_rows = user_data;
+  *num_rows += 1;
+  return 0;
+}
+
+/**
+ * Read every row from the bench table with @ref sqldbal_exec.
+ *
+ * @param[in] i Unused.
+ */
+static void
+sqldbal_bench_op_exec_callback(size_t i){
+  size_t num_rows;
+
+  (void)i;
+  num_rows = 0;
+  sqldbal_bench_check(sqldbal_exec(g_db,
+                                   "SELECT id, num, name FROM bench",
+                                   sqldbal_bench_exec_callback,
+                                   &num_rows));
+  assert(num_rows == SQLDBAL_BENCH_ROWS);
+}
+
+/**
+ * Run the fetch benchmarks, which also run on the streaming connection.
+ */
+static void
+sqldbal_bench_fetch(void){
+  sqldbal_bench_prepare("SELECT id, num, name, data FROM bench ORDER BY id",
+                        &g_stmt);
+  sqldbal_bench_run("fetch_1000_rows",
+                    sqldbal_bench_op_fetch_all,
+                    g_num_ops / SQLDBAL_BENCH_HEAVY_DIVISOR);
+  sqldbal_bench_close(g_stmt);
+
+  sqldbal_bench_run("exec_callback_1000_rows",
+                    sqldbal_bench_op_exec_callback,
+                    g_num_ops / SQLDBAL_BENCH_HEAVY_DIVISOR);
+}
+
+/**
+ * Run every benchmark on one database connection.
+ */
+static void
+sqldbal_bench_all(void){
+  sprintf(g_sql,
+          "SELECT num, name FROM bench WHERE id = %s",
+          sqldbal_bench_placeholder(0));
+  sqldbal_bench_run("prepare", sqldbal_bench_op_prepare, g_num_ops);
+  sqldbal_bench_check(sqldbal_stmt_cache_set_capacity(g_db, 16));
+  sqldbal_bench_run("prepare_cached", sqldbal_bench_op_prepare, g_num_ops);
+  sqldbal_bench_check(sqldbal_stmt_cache_set_capacity(g_db, 0));
+
+  sqldbal_bench_prepare(g_sql, &g_stmt);
+  sqldbal_bench_run("execute_select_row",
+                    sqldbal_bench_op_select_row,
+                    g_num_ops);
+  sqldbal_bench_close(g_stmt);
+
+  sqldbal_bench_insert_begin();
+  sqldbal_bench_prepare_insert("bench_insert", &g_stmt);
+  sqldbal_bench_run("insert_bind", sqldbal_bench_op_insert_bind, g_num_ops);
+  sqldbal_bench_close(g_stmt);
+  sqldbal_bench_insert_end();
+
+  sqldbal_bench_insert_begin();
+  sqldbal_bench_prepare_insert("bench_insert", &g_stmt);
+  sqldbal_bench_run("insert_batch_x100",
+                    sqldbal_bench_op_insert_batch,
+                    g_num_ops / SQLDBAL_BENCH_HEAVY_DIVISOR);
+  sqldbal_bench_close(g_stmt);
+  sqldbal_bench_insert_end();
+
+  sqldbal_bench_insert_begin();
+  sqldbal_bench_run("insert_bulk_x100",
+                    sqldbal_bench_op_insert_bulk,
+                    g_num_ops / SQLDBAL_BENCH_HEAVY_DIVISOR);
+  sqldbal_bench_insert_end();
+
+  sqldbal_bench_insert_begin();
+  sqldbal_bench_run("insert_multirow_x100",
+                    sqldbal_bench_op_insert_multirow,
+                    g_num_ops / SQLDBAL_BENCH_HEAVY_DIVISOR);
+  sqldbal_bench_insert_end();
+
+  sqldbal_bench_fetch();
+
+  sqldbal_bench_prepare("SELECT id, num, name, data FROM bench ORDER BY id",
+                        &g_stmt);
+  sqldbal_bench_check(sqldbal_stmt_set_cursor(g_stmt,
+                                              SQLDBAL_BENCH_CURSOR_PREFETCH));
+  sqldbal_bench_run("fetch_cursor_1000_rows",
+                    sqldbal_bench_op_fetch_all,
+                    g_num_ops / SQLDBAL_BENCH_HEAVY_DIVISOR);
+  sqldbal_bench_close(g_stmt);
+
+  sprintf(g_sql,
+          "UPDATE bench SET data = %s WHERE id = 1",
+          sqldbal_bench_placeholder(0));
+  sqldbal_bench_prepare(g_sql, &g_stmt);
+  sqldbal_bench_prepare("SELECT data FROM bench WHERE id = 1", &g_stmt2);
+  sqldbal_bench_run("blob_round_trip_4k",
+                    sqldbal_bench_op_blob_round_trip,
+                    g_num_ops);
+  sqldbal_bench_close(g_stmt2);
+  sqldbal_bench_close(g_stmt);
+}
+
+/**
+ * Open a database connection for the benchmarks.
+ *
+ * @param[in] config See @ref sqldbal_test_db_config.
+ * @param[in] flags  Flags added to the configuration flags.
+ */
+static void
+sqldbal_bench_open(const struct sqldbal_test_db_config *const config,
+                   unsigned long flags){
+  enum sqldbal_status_code rc;
+
+  rc = sqldbal_open(config->driver,
+                    config->location,
+                    config->port,
+                    config->username,
+                    config->password,
+                    config->database,
+                    config->flags | flags,
+                    NULL,
+                    0,
+                    &g_db);
+  sqldbal_bench_check(rc);
+}
+
+/**
+ * Run the benchmarks for one database driver.
+ *
+ * @param[in] driver See @ref sqldbal_bench_driver.
+ */
+static void
+sqldbal_bench_driver(const struct sqldbal_bench_driver *const driver){
+  struct sqldbal_test_db_config config;
+  char path[100];
+
+  sprintf(path, "%s/%s.txt", PATH_CONFIG_PREFIX, driver->name);
+  sqldbal_test_load_config_file(path, driver->driver, &config);
+
+  sprintf(g_label, "%s", driver->name);
+  sqldbal_bench_open(&config, SQLDBAL_FLAG_NONE);
+  sqldbal_bench_create_tables();
+  sqldbal_bench_all();
+  sqldbal_bench_check(sqldbal_close(g_db));
+
+  sprintf(g_label, "%s/stream", driver->name);
+  sqldbal_bench_open(&config, SQLDBAL_FLAG_STREAM_RESULTS);
+  sqldbal_bench_fetch();
+  sqldbal_bench_check(sqldbal_close(g_db));
+}
+
+/**
+ * Main entry point for the benchmark program.
+ *
+ * @param[in] argc Number of arguments in @p argv.
+ * @param[in] argv String array containing the program name and
+ *                 optional arguments.
+ * @retval 0 All benchmarks finished.
+ * @retval 1 Invalid arguments.
+ */
+int main(int argc,
+         char *argv[]){
+  int driver_list[sizeof(g_bench_driver_list) /
+                  sizeof(g_bench_driver_list[0])];
+  size_t num_drivers;
+  size_t i;
+  int all_drivers;
+  int c;
+
+  num_drivers = sizeof(driver_list) / sizeof(driver_list[0]);
+  memset(driver_list, 0, sizeof(driver_list));
+  all_drivers = 1;
+  while((c = getopt(argc, argv, "d:n:")) != -1){
+    switch(c){
+      case 'd':
+        for(i = 0; i < num_drivers; i++){
+          if(strcmp(optarg, g_bench_driver_list[i].name) == 0){
+            driver_list[i] = 1;
+            all_drivers = 0;
+            break;
+          }
+        }
+        if(i == num_drivers){
+          fprintf(stderr, "unknown driver: %s\n", optarg);
+          return 1;
+        }
+        break;
+      case 'n':
+        g_num_ops = (size_t)strtoul(optarg, NULL, 10);
+        if(g_num_ops == 0){
+          fprintf(stderr, "invalid number of operations: %s\n", optarg);
+          return 1;
+        }
+        break;
+      default:
+        return 1;
+    }
+  }
+
+  sqldbal_bench_batch_init();
+  memset(g_blob, 'b', sizeof(g_blob));
+  sqldbal_bench_print_header();
+  for(i = 0; i < num_drivers; i++){
+    if(all_drivers || driver_list[i]){
+      sqldbal_bench_driver(&g_bench_driver_list[i]);
+    }
+  }
+  free(g_batch);
+
+  return 0;
+}
@@ -20,6 +20,11 @@
 
 #include "test.h"
 
+/**
+ * See @ref g_sqldbal_test_num_alloc.
+ */
+size_t g_sqldbal_test_num_alloc = 0;
+
 /**
  * See @ref g_sqldbal_err_calloc_ctr and @ref test_seams_countdown_global.
  */
@@ -60,6 +65,12 @@ int g_sqldbal_err_mysql_init_ctr = -1;
  */
 int g_sqldbal_err_mysql_options_ctr = -1;
 
+/**
+ * See @ref g_sqldbal_err_mysql_ping_ctr and
+ * @ref test_seams_countdown_global.
+ */
+int g_sqldbal_err_mysql_ping_ctr = -1;
+
 /**
  * See @ref g_sqldbal_err_mysql_rollback_ctr and
  * @ref test_seams_countdown_global.
@@ -132,6 +143,12 @@ int g_sqldbal_err_mysql_store_result_ctr = -1;
  */
 int g_sqldbal_err_PQconnectdb_ctr = -1;
 
+/**
+ * See @ref g_sqldbal_err_PQconnectStart_ctr and
+ * @ref test_seams_countdown_global.
+ */
+int g_sqldbal_err_PQconnectStart_ctr = -1;
+
 /**
  * See @ref g_sqldbal_err_PQexec_ctr and
  * @ref test_seams_countdown_global.
@@ -373,6 +390,9 @@ sqldbal_test_seam_calloc(size_t nelem,
   }
   else{
     alloc = calloc(nelem, elsize);
+    if(alloc){
+      g_sqldbal_test_num_alloc += 1;
+    }
   }
   return alloc;
 }
@@ -394,6 +414,9 @@ sqldbal_test_seam_malloc(size_t size){
   }
   else{
     alloc = malloc(size);
+    if(alloc){
+      g_sqldbal_test_num_alloc += 1;
+    }
   }
   return alloc;
 }
@@ -506,6 +529,26 @@ sqldbal_test_seam_mysql_options(MYSQL *mysql,
   return rc;
 }
 
+/**
+ * Allows the test harness to control when mysql_ping() fails.
+ *
+ * @param[in] mysql MySQL database handle.
+ * @retval  0 Connection works.
+ * @retval !0 Error occurred.
+ */
+int
+sqldbal_test_seam_mysql_ping(MYSQL *mysql){
+  int rc;
+
+  if(sqldbal_test_seam_dec_err_ctr(&g_sqldbal_err_mysql_ping_ctr)){
+    rc = 1;
+  }
+  else{
+    rc = mysql_ping(mysql);
+  }
+  return rc;
+}
+
 /**
  * Allows the test harness to control when mysql_rollback() fails.
  *
@@ -755,6 +798,26 @@ sqldbal_test_seam_PQconnectdb(const char *conninfo){
   return result;
 }
 
+/**
+ * Allows the test harness to control when PQconnectStart() fails.
+ *
+ * @param[in] conninfo Database connection parameters.
+ * @retval PGconn* Database connection handle.
+ * @retval NULL    Out of memory.
+ */
+PGconn *
+sqldbal_test_seam_PQconnectStart(const char *conninfo){
+  PGconn *result;
+
+  if(sqldbal_test_seam_dec_err_ctr(&g_sqldbal_err_PQconnectStart_ctr)){
+    result = NULL;
+  }
+  else{
+    result = PQconnectStart(conninfo);
+  }
+  return result;
+}
+
 /**
  * Allows the test harness to control when PQexec() fails.
  *
@@ -892,6 +955,9 @@ sqldbal_test_seam_realloc(void *ptr,
   }
   else{
     alloc = realloc(ptr, size);
+    if(alloc){
+      g_sqldbal_test_num_alloc += 1;
+    }
   }
   return alloc;
 }
@@ -28,6 +28,7 @@
 #undef mysql_errno
 #undef mysql_init
 #undef mysql_options
+#undef mysql_ping
 #undef mysql_rollback
 #undef mysql_stmt_attr_set
 #undef mysql_stmt_bind_param
@@ -40,6 +41,7 @@
 #undef mysql_stmt_store_result
 #undef mysql_store_result
 #undef PQconnectdb
+#undef PQconnectStart
 #undef PQexec
 #undef PQexecParams
 #undef PQprepare
@@ -105,6 +107,12 @@
  */
 #define mysql_options              sqldbal_test_seam_mysql_options
 
+/**
+ * Inject a test seam on calls to mysql_ping() that can control
+ * when this function fails.
+ */
+#define mysql_ping                 sqldbal_test_seam_mysql_ping
+
 /**
  * Inject a test seam on calls to mysql_rollback() that can control
  * when this function fails.
@@ -177,6 +185,12 @@
  */
 #define PQconnectdb                sqldbal_test_seam_PQconnectdb
 
+/**
+ * Inject a test seam on calls to PQconnectStart() that can control
+ * when this function fails.
+ */
+#define PQconnectStart             sqldbal_test_seam_PQconnectStart
+
 /**
  * Inject a test seam on calls to PQexec() that can control
  * when this function fails.
@@ -14,12 +14,16 @@
  *
  * This software has been placed into the public domain using CC0.
  */
+#include <arpa/inet.h>
 #include <assert.h>
 #include <limits.h>
+#include <netinet/in.h>
+#include <pthread.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include "config.h"
@@ -41,6 +45,18 @@
  */
 #define SQLDBAL_TEST_SQL_LIMIT 1000
 
+/**
+ * Number of threads sharing the connection pool in
+ * @ref sqldbal_functional_test_pool_threads.
+ */
+#define SQLDBAL_TEST_POOL_NUM_THREADS 4
+
+/**
+ * Size of the buffers passed to @ref sqldbal_double_to_str and
+ * @ref sqldbal_timestamp_to_str.
+ */
+#define SQLDBAL_TEST_CONV_STR_SZ 32
+
 /**
  * Parameterized placeholders to use when constructing queries.
  *
@@ -215,48 +231,257 @@ sqldbal_test_get_driver_config_i(enum sqldbal_driver driver){
 }
 
 /**
- * Test harness for @ref sqldbal_str_hex2bin.
+ * Test harness for @ref sqldbal_hex2bin_buf.
  *
- * @param[in] hex_str    Hex string to convert to binary.
- * @param[in] expect_str Expected binary string value.
- * @param[in] expect_len Expected length of binary data.
+ * @param[in] hex_str    Hex characters to convert to binary.
+ * @param[in] hexlen     Number of characters in @p hex_str.
+ * @param[in] expect_rc  Expected return code.
+ * @param[in] expect_bin Expected binary data, which has @p hexlen / 2 bytes.
  */
 static void
-sqldbal_unit_test_hex2bin(const char *const hex_str,
-                          const char *const expect_str,
-                          size_t expect_len){
-  char *result;
-  size_t result_len;
+sqldbal_unit_test_hex2bin_buf(const char *const hex_str,
+                              size_t hexlen,
+                              int expect_rc,
+                              const char *const expect_bin){
+  unsigned char bin[64];
+  int rc;
 
-  result = sqldbal_str_hex2bin(hex_str, &result_len);
-  if(expect_str){
-    assert(result_len == expect_len);
-    assert(memcmp(result, expect_str, expect_len) == 0);
-    free(result);
+  rc = sqldbal_hex2bin_buf(hex_str, hexlen, bin);
+  assert(rc == expect_rc);
+  if(rc == 0){
+    assert(memcmp(bin, expect_bin, hexlen / 2) == 0);
   }
-  else{
-    assert(result == expect_str);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_hex2bin_buf.
+ */
+static void
+sqldbal_unit_test_all_hex2bin_buf(void){
+  sqldbal_unit_test_hex2bin_buf("", 0, 0, "");
+  sqldbal_unit_test_hex2bin_buf("4", 1, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("ZZ", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("0Z", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("Z0", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("004500", 6, 0, "\0E\0");
+  sqldbal_unit_test_hex2bin_buf("202345", 6, 0, " #E");
+  sqldbal_unit_test_hex2bin_buf("34545567", 8, 0, "4TUg");
+
+  /* Long enough to use the vectorized path, with upper and lower case. */
+  sqldbal_unit_test_hex2bin_buf("000102030405060708090a0b0c0d0e0f"
+                                "F0E1D2C3B4A5968778695A4B3C2D1E0F"
+                                "4142",
+                                68,
+                                0,
+                                "\x00\x01\x02\x03\x04\x05\x06\x07"
+                                "\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f"
+                                "\xf0\xe1\xd2\xc3\xb4\xa5\x96\x87"
+                                "\x78\x69\x5a\x4b\x3c\x2d\x1e\x0f"
+                                "AB");
+  sqldbal_unit_test_hex2bin_buf("0001020304050607080g0a0b0c0d0e0f"
+                                "000102030405060708090a0b0c0d0e0f",
+                                64,
+                                -1,
+                                NULL);
+  sqldbal_unit_test_hex2bin_buf("000102030405060708090a0b0c0d0e0f"
+                                "000102030405060708090a0b0c0d0e:f",
+                                64,
+                                -1,
+                                NULL);
+  sqldbal_unit_test_hex2bin_buf("000102030405060708090a0b0c0d0e0f"
+                                "000102030405060708090a0b0c0d0e0f"
+                                "G0",
+                                66,
+                                -1,
+                                NULL);
+
+  /* Stops at hexlen without a null-terminator. */
+  sqldbal_unit_test_hex2bin_buf("4142ZZ", 4, 0, "AB");
+
+  /* Every character that is not a hex digit fails in both paths. */
+  sqldbal_unit_test_hex2bin_buf("/0", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf(":0", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("@0", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("`0", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("\xb0" "0", 2, -1, NULL);
+  sqldbal_unit_test_hex2bin_buf("0123456789abcdefABCDEF0123456789"
+                                "\xc1\xc1",
+                                34,
+                                -1,
+                                NULL);
+  sqldbal_unit_test_hex2bin_buf("\xb0" "123456789abcdefABCDEF0123456789",
+                                32,
+                                -1,
+                                NULL);
+  sqldbal_unit_test_hex2bin_buf("0123456789abcdefABCDEF012345678G",
+                                32,
+                                -1,
+                                NULL);
+  sqldbal_unit_test_hex2bin_buf("0123456789abcdefABCDEF0123456789",
+                                32,
+                                0,
+                                "\x01\x23\x45\x67\x89\xab\xcd\xef"
+                                "\xab\xcd\xef\x01\x23\x45\x67\x89");
+}
+
+/**
+ * Test harness for @ref sqldbal_pq_int_to_bin and @ref sqldbal_pq_bin_to_int.
+ *
+ * @param[in] i64        Integer to convert.
+ * @param[in] nbytes     Number of bytes in the binary integer.
+ * @param[in] expect_bin Expected binary integer in network byte order.
+ */
+static void
+sqldbal_unit_test_pq_int_bin(int64_t i64,
+                             size_t nbytes,
+                             const char *const expect_bin){
+  unsigned char bin[8];
+
+  sqldbal_pq_int_to_bin(i64, nbytes, bin);
+  assert(memcmp(bin, expect_bin, nbytes) == 0);
+  assert(sqldbal_pq_bin_to_int(bin, nbytes) == i64);
+}
+
+/**
+ * Run all test cases for the PostgreSQL binary integer conversions.
+ */
+static void
+sqldbal_unit_test_all_pq_int_bin(void){
+  sqldbal_unit_test_pq_int_bin(0, 2, "\x00\x00");
+  sqldbal_unit_test_pq_int_bin(1, 2, "\x00\x01");
+  sqldbal_unit_test_pq_int_bin(-1, 2, "\xff\xff");
+  sqldbal_unit_test_pq_int_bin(INT16_MAX, 2, "\x7f\xff");
+  sqldbal_unit_test_pq_int_bin(INT16_MIN, 2, "\x80\x00");
+  sqldbal_unit_test_pq_int_bin(258, 4, "\x00\x00\x01\x02");
+  sqldbal_unit_test_pq_int_bin(-2, 4, "\xff\xff\xff\xfe");
+  sqldbal_unit_test_pq_int_bin(INT32_MAX, 4, "\x7f\xff\xff\xff");
+  sqldbal_unit_test_pq_int_bin(INT32_MIN, 4, "\x80\x00\x00\x00");
+  sqldbal_unit_test_pq_int_bin(0x0102030405060708,
+                               8,
+                               "\x01\x02\x03\x04\x05\x06\x07\x08");
+  sqldbal_unit_test_pq_int_bin(-1,
+                               8,
+                               "\xff\xff\xff\xff\xff\xff\xff\xff");
+  sqldbal_unit_test_pq_int_bin(INT64_MAX,
+                               8,
+                               "\x7f\xff\xff\xff\xff\xff\xff\xff");
+  sqldbal_unit_test_pq_int_bin(INT64_MIN,
+                               8,
+                               "\x80\x00\x00\x00\x00\x00\x00\x00");
+}
+
+/**
+ * Test harness for @ref sqldbal_pq_double_to_bin and
+ * @ref sqldbal_pq_bin_to_double.
+ *
+ * @param[in] d          Floating point number to convert, which must fit
+ *                       exactly in @p nbytes.
+ * @param[in] nbytes     Number of bytes in the binary value.
+ * @param[in] expect_bin Expected binary value in network byte order.
+ */
+static void
+sqldbal_unit_test_pq_float_bin(double d,
+                               size_t nbytes,
+                               const char *const expect_bin){
+  unsigned char bin[8];
+  double result;
+
+  sqldbal_pq_double_to_bin(d, nbytes, bin);
+  assert(memcmp(bin, expect_bin, nbytes) == 0);
+  result = sqldbal_pq_bin_to_double(bin, nbytes);
+  assert(memcmp(&result, &d, sizeof(d)) == 0);
+}
+
+/**
+ * Run all test cases for the PostgreSQL binary floating point conversions.
+ */
+static void
+sqldbal_unit_test_all_pq_float_bin(void){
+  sqldbal_unit_test_pq_float_bin(0, 8, "\x00\x00\x00\x00\x00\x00\x00\x00");
+  sqldbal_unit_test_pq_float_bin((double)5 / 4,
+                                 8,
+                                 "\x3f\xf4\x00\x00\x00\x00\x00\x00");
+  sqldbal_unit_test_pq_float_bin((double)-1 / 10,
+                                 8,
+                                 "\xbf\xb9\x99\x99\x99\x99\x99\x9a");
+  sqldbal_unit_test_pq_float_bin(0, 4, "\x00\x00\x00\x00");
+  sqldbal_unit_test_pq_float_bin((double)5 / 4, 4, "\x3f\xa0\x00\x00");
+}
+
+/**
+ * Test harness for @ref sqldbal_pq_bin_to_timestamp.
+ *
+ * @param[in] value     PostgreSQL date or timestamp value.
+ * @param[in] nbytes    8 for timestamps, or 4 for dates.
+ * @param[in] expect_rc Expected return code.
+ * @param[in] expect_ts Expected timestamp if @p expect_rc is 0.
+ */
+static void
+sqldbal_unit_test_pq_bin_to_timestamp(int64_t value,
+                                      size_t nbytes,
+                                      int expect_rc,
+                                      int64_t expect_ts){
+  unsigned char bin[8];
+  int64_t ts;
+  int rc;
+
+  sqldbal_pq_int_to_bin(value, nbytes, bin);
+  ts = 0;
+  rc = sqldbal_pq_bin_to_timestamp(bin, nbytes, &ts);
+  assert(rc == expect_rc);
+  if(rc == 0){
+    assert(ts == expect_ts);
   }
 }
 
 /**
- * Run all test cases for @ref sqldbal_str_hex2bin.
+ * Test harness for @ref sqldbal_pq_timestamp_to_bin.
+ *
+ * @param[in] ts           Timestamp to convert.
+ * @param[in] expect_rc    Expected return code.
+ * @param[in] expect_value Expected PostgreSQL timestamp if @p expect_rc
+ *                         is 0.
  */
 static void
-sqldbal_unit_test_all_hex2bin(void){
-  sqldbal_unit_test_hex2bin("", "", 0);
-  sqldbal_unit_test_hex2bin("0", NULL, 0);
-  sqldbal_unit_test_hex2bin("1", NULL, 0);
-  sqldbal_unit_test_hex2bin("ZZ", NULL, 0);
-  sqldbal_unit_test_hex2bin("0Z", NULL, 0);
-  sqldbal_unit_test_hex2bin("Z0", NULL, 0);
-  sqldbal_unit_test_hex2bin("004500", "\0E\0", 3);
-  sqldbal_unit_test_hex2bin("202345", " #E", 3);
-  sqldbal_unit_test_hex2bin("34545567", "4TUg", 4);
+sqldbal_unit_test_pq_timestamp_to_bin(int64_t ts,
+                                      int expect_rc,
+                                      int64_t expect_value){
+  unsigned char bin[8];
+  int rc;
 
-  g_sqldbal_err_malloc_ctr = 0;
-  sqldbal_unit_test_hex2bin("00", NULL, 0);
-  g_sqldbal_err_malloc_ctr = -1;
+  rc = sqldbal_pq_timestamp_to_bin(ts, bin);
+  assert(rc == expect_rc);
+  if(rc == 0){
+    assert(sqldbal_pq_bin_to_int(bin, 8) == expect_value);
+  }
+}
+
+/**
+ * Run all test cases for the PostgreSQL binary date and timestamp
+ * conversions.
+ */
+static void
+sqldbal_unit_test_all_pq_timestamp_bin(void){
+  const int64_t pq_epoch = INT64_C(946684800000000);
+
+  sqldbal_unit_test_pq_bin_to_timestamp(0, 8, 0, pq_epoch);
+  sqldbal_unit_test_pq_bin_to_timestamp(-pq_epoch, 8, 0, 0);
+  sqldbal_unit_test_pq_bin_to_timestamp(INT64_MAX, 8, 0, INT64_MAX);
+  sqldbal_unit_test_pq_bin_to_timestamp(INT64_MIN, 8, 0, INT64_MIN);
+  sqldbal_unit_test_pq_bin_to_timestamp(INT64_MAX - 1, 8, -1, 0);
+  sqldbal_unit_test_pq_bin_to_timestamp(0, 4, 0, pq_epoch);
+  sqldbal_unit_test_pq_bin_to_timestamp(-10957, 4, 0, 0);
+  sqldbal_unit_test_pq_bin_to_timestamp(1, 4, 0, pq_epoch + 86400000000);
+  sqldbal_unit_test_pq_bin_to_timestamp(INT32_MAX, 4, 0, INT64_MAX);
+  sqldbal_unit_test_pq_bin_to_timestamp(INT32_MIN, 4, 0, INT64_MIN);
+  sqldbal_unit_test_pq_bin_to_timestamp(INT32_MAX - 1, 4, -1, 0);
+  sqldbal_unit_test_pq_bin_to_timestamp(INT32_MIN + 1, 4, -1, 0);
+
+  sqldbal_unit_test_pq_timestamp_to_bin(pq_epoch, 0, 0);
+  sqldbal_unit_test_pq_timestamp_to_bin(0, 0, -pq_epoch);
+  sqldbal_unit_test_pq_timestamp_to_bin(INT64_MAX, 0, INT64_MAX);
+  sqldbal_unit_test_pq_timestamp_to_bin(INT64_MIN, 0, INT64_MIN);
+  sqldbal_unit_test_pq_timestamp_to_bin(INT64_MIN + 1, -1, 0);
 }
 
 /**
@@ -760,18 +985,424 @@ sqldbal_unit_test_all_strtoi64(void){
   g_sqldbal_err_si_llong_to_int64_ctr = -1;
 }
 
+/**
+ * Test harness for @ref sqldbal_strtod.
+ *
+ * @param[in] str           See @ref sqldbal_strtod.
+ * @param[in] expect_double Expected conversion result.
+ * @param[in] expect_status Expected status code response.
+ */
+static void
+sqldbal_unit_test_strtod(const char *const str,
+                         double expect_double,
+                         enum sqldbal_status_code expect_status){
+  double result;
+
+  sqldbal_test_open_db_sqlite();
+  sqldbal_strtod(g_db, str, &result);
+  g_rc = sqldbal_status_code_get(g_db);
+  assert(g_rc == expect_status);
+  assert(memcmp(&result, &expect_double, sizeof(result)) == 0);
+  sqldbal_close(g_db);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_strtod.
+ */
+static void
+sqldbal_unit_test_all_strtod(void){
+  sqldbal_unit_test_strtod("", 0, SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtod("a", 0, SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtod("1.25a", 0, SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtod("1.25", (double)5 / 4, SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtod("-0.1", (double)-1 / 10, SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtod("1e999", 0, SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtod("-1e999", 0, SQLDBAL_STATUS_COLUMN_COERCE);
+
+  /* ERANGE but not out of range */
+  sqldbal_unit_test_strtod("1e-999", 0, SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Test harness for @ref sqldbal_double_to_str.
+ *
+ * @param[in] d          Floating point number to convert.
+ * @param[in] expect_str Expected string.
+ */
+static void
+sqldbal_unit_test_double_to_str(double d,
+                                const char *const expect_str){
+  char str[SQLDBAL_TEST_CONV_STR_SZ];
+  size_t slen;
+
+  slen = sqldbal_double_to_str(d, str);
+  assert(slen == strlen(expect_str));
+  assert(strcmp(str, expect_str) == 0);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_double_to_str.
+ */
+static void
+sqldbal_unit_test_all_double_to_str(void){
+  sqldbal_unit_test_double_to_str(0, "0");
+  sqldbal_unit_test_double_to_str((double)5 / 4, "1.25");
+  sqldbal_unit_test_double_to_str((double)-1 / 10, "-0.1");
+  sqldbal_unit_test_double_to_str((double)1 / 3, "0.33333333333333331");
+  sqldbal_unit_test_double_to_str((double)(INT64_C(1) << 60),
+                                  "1.152921504606847e+18");
+}
+
+/**
+ * Test harness for @ref sqldbal_timestamp_to_str and
+ * @ref sqldbal_strtotimestamp.
+ *
+ * @param[in] ts         Timestamp to convert.
+ * @param[in] expect_str Expected string.
+ */
+static void
+sqldbal_unit_test_timestamp_to_str(int64_t ts,
+                                   const char *const expect_str){
+  char str[SQLDBAL_TEST_CONV_STR_SZ];
+  size_t slen;
+  int64_t result;
+
+  slen = sqldbal_timestamp_to_str(ts, str);
+  assert(slen == strlen(expect_str));
+  assert(strcmp(str, expect_str) == 0);
+
+  sqldbal_test_open_db_sqlite();
+  sqldbal_strtotimestamp(g_db, str, &result);
+  g_rc = sqldbal_status_code_get(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(result == ts);
+  sqldbal_close(g_db);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_days_from_civil and
+ * @ref sqldbal_timestamp_to_str.
+ */
+static void
+sqldbal_unit_test_all_timestamp_to_str(void){
+  assert(sqldbal_days_from_civil(1970, 1, 1) == 0);
+  assert(sqldbal_days_from_civil(1969, 12, 31) == -1);
+  assert(sqldbal_days_from_civil(2000, 1, 1) == 10957);
+  assert(sqldbal_days_from_civil(2020, 2, 29) == 18321);
+  assert(sqldbal_days_from_civil(1, 1, 1) == -719162);
+  assert(sqldbal_days_from_civil(9999, 12, 31) == 2932896);
+
+  sqldbal_unit_test_timestamp_to_str(0, "1970-01-01 00:00:00");
+  sqldbal_unit_test_timestamp_to_str(-1, "1969-12-31 23:59:59.999999");
+  sqldbal_unit_test_timestamp_to_str(INT64_C(951825600000000),
+                                     "2000-02-29 12:00:00");
+  sqldbal_unit_test_timestamp_to_str(INT64_C(1600000000123456),
+                                     "2020-09-13 12:26:40.123456");
+  sqldbal_unit_test_timestamp_to_str(INT64_MAX, "infinity");
+  sqldbal_unit_test_timestamp_to_str(INT64_MIN, "-infinity");
+}
+
+/**
+ * Test harness for @ref sqldbal_strtotimestamp.
+ *
+ * @param[in] str           See @ref sqldbal_strtotimestamp.
+ * @param[in] expect_ts     Expected conversion timestamp.
+ * @param[in] expect_status Expected status code response.
+ */
+static void
+sqldbal_unit_test_strtotimestamp(const char *const str,
+                                 int64_t expect_ts,
+                                 enum sqldbal_status_code expect_status){
+  int64_t result;
+
+  sqldbal_test_open_db_sqlite();
+  sqldbal_strtotimestamp(g_db, str, &result);
+  g_rc = sqldbal_status_code_get(g_db);
+  assert(g_rc == expect_status);
+  assert(result == expect_ts);
+  sqldbal_close(g_db);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_strtotimestamp.
+ */
+static void
+sqldbal_unit_test_all_strtotimestamp(void){
+  const int64_t ts_2020 = INT64_C(1577836800000000);
+
+  sqldbal_unit_test_strtotimestamp("2020-01-01", ts_2020, SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00",
+                                   ts_2020,
+                                   SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2020-01-01T00:00:00Z",
+                                   ts_2020,
+                                   SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 05:30:00+05:30",
+                                   ts_2020,
+                                   SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 05:30:00+0530",
+                                   ts_2020,
+                                   SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2019-12-31 18:30:00-05:30:00",
+                                   ts_2020,
+                                   SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00+00",
+                                   ts_2020,
+                                   SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00.1234567",
+                                   ts_2020 + 123456,
+                                   SQLDBAL_STATUS_OK);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00.5",
+                                   ts_2020 + 500000,
+                                   SQLDBAL_STATUS_OK);
+
+  sqldbal_unit_test_strtotimestamp("", 0, SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("a", 0, SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-1-01",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-00-01",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-13-01",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2019-02-29",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-00",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 24:00:00",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:60:00",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:60",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00.",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00 ",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00+16",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00+00:60",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("2020-01-01 00:00:00+00:00:60",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_unit_test_strtotimestamp("infinityx",
+                                   0,
+                                   SQLDBAL_STATUS_COLUMN_COERCE);
+}
+
+/**
+ * Test harness for @ref sqldbal_stmt_cache_hash.
+ *
+ * @param[in] sql         Null-terminated SQL text to hash.
+ * @param[in] expect_hash Expected 64-bit FNV-1a hash of @p sql.
+ */
+static void
+sqldbal_unit_test_stmt_cache_hash(const char *const sql,
+                                  uint64_t expect_hash){
+  uint64_t hash;
+
+  hash = sqldbal_stmt_cache_hash(sql, strlen(sql));
+  assert(hash == expect_hash);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_stmt_cache_hash.
+ */
+static void
+sqldbal_unit_test_all_stmt_cache_hash(void){
+  sqldbal_unit_test_stmt_cache_hash("", UINT64_C(0xcbf29ce484222325));
+  sqldbal_unit_test_stmt_cache_hash("a", UINT64_C(0xaf63dc4c8601ec8c));
+  sqldbal_unit_test_stmt_cache_hash("foobar", UINT64_C(0x85944171f73967e8));
+}
+
+/**
+ * Test harness for @ref sqldbal_bulk_escape.
+ *
+ * @param[in] src        Bytes to escape.
+ * @param[in] len        Number of bytes in @p src.
+ * @param[in] expect_dst Expected null-terminated escaped string.
+ */
+static void
+sqldbal_unit_test_bulk_escape(const char *const src,
+                              size_t len,
+                              const char *const expect_dst){
+  char dst[100];
+  size_t dst_len;
+
+  dst_len = sqldbal_bulk_escape(src, len, dst);
+  assert(dst_len == strlen(expect_dst));
+  assert(memcmp(dst, expect_dst, dst_len) == 0);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_bulk_escape.
+ */
+static void
+sqldbal_unit_test_all_bulk_escape(void){
+  sqldbal_unit_test_bulk_escape("", 0, "");
+  sqldbal_unit_test_bulk_escape("abc", 3, "abc");
+  sqldbal_unit_test_bulk_escape("a\tb", 3, "a\\tb");
+  sqldbal_unit_test_bulk_escape("a\tb\n", 4, "a\\tb\\n");
+  sqldbal_unit_test_bulk_escape("\t\n\r", 3, "\\t\\n\\r");
+  sqldbal_unit_test_bulk_escape("a\0b", 3, "a\\0b");
+  sqldbal_unit_test_bulk_escape("\\N", 2, "\\\\N");
+}
+
+/**
+ * Run all test cases for @ref sqldbal_sql_is_read_only.
+ */
+static void
+sqldbal_unit_test_all_sql_is_read_only(void){
+  assert(sqldbal_sql_is_read_only("SELECT 1", (size_t)-1) == 1);
+  assert(sqldbal_sql_is_read_only("select 1", (size_t)-1) == 1);
+  assert(sqldbal_sql_is_read_only(" \t\r\n(SELECT 1)", (size_t)-1) == 1);
+  assert(sqldbal_sql_is_read_only("SeLeCt\n*", (size_t)-1) == 1);
+  assert(sqldbal_sql_is_read_only("SELECT 1", 7) == 1);
+  assert(sqldbal_sql_is_read_only("SELECT 1", 6) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECTED", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT_1", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELEC1 1", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("INSERT INTO t VALUES(1)", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("  ", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT * INTO t2 FROM t",
+                                  (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT * FROM t FOR UPDATE",
+                                  (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT * FROM t FOR SHARE",
+                                  (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT * FROM t LOCK IN SHARE MODE",
+                                  (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT nextval('s')", (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT pg_advisory_lock(1)",
+                                  (size_t)-1) == 0);
+  assert(sqldbal_sql_is_read_only("SELECT updated FROM t",
+                                  (size_t)-1) == 1);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_sql_transaction_change.
+ */
+static void
+sqldbal_unit_test_all_sql_transaction_change(void){
+  assert(sqldbal_sql_transaction_change("BEGIN", (size_t)-1) == 1);
+  assert(sqldbal_sql_transaction_change(" begin work", (size_t)-1) == 1);
+  assert(sqldbal_sql_transaction_change("START TRANSACTION",
+                                        (size_t)-1) == 1);
+  assert(sqldbal_sql_transaction_change("COMMIT", (size_t)-1) == 0);
+  assert(sqldbal_sql_transaction_change("END", (size_t)-1) == 0);
+  assert(sqldbal_sql_transaction_change("ROLLBACK", (size_t)-1) == 0);
+  assert(sqldbal_sql_transaction_change("ROLLBACK TO SAVEPOINT s",
+                                        (size_t)-1) == -1);
+  assert(sqldbal_sql_transaction_change("BEGINNING", (size_t)-1) == -1);
+  assert(sqldbal_sql_transaction_change("SELECT 1", (size_t)-1) == -1);
+  assert(sqldbal_sql_transaction_change("BEGIN", 3) == -1);
+  assert(sqldbal_sql_transaction_change("", (size_t)-1) == -1);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_sql_has_word.
+ */
+static void
+sqldbal_unit_test_all_sql_has_word(void){
+  assert(sqldbal_sql_has_word("SELECT * FROM article", 21, "article") == 1);
+  assert(sqldbal_sql_has_word("SELECT * FROM ARTICLE", 21, "Article") == 1);
+  assert(sqldbal_sql_has_word("article", 7, "article") == 1);
+  assert(sqldbal_sql_has_word("FROM public.article x", 21, "article") == 1);
+  assert(sqldbal_sql_has_word("SELECT 1 -- user_42", 19, "user_42") == 1);
+  assert(sqldbal_sql_has_word("FROM article_tag", 16, "article") == 0);
+  assert(sqldbal_sql_has_word("FROM my_article", 15, "article") == 0);
+  assert(sqldbal_sql_has_word("FROM article", 11, "article") == 0);
+  assert(sqldbal_sql_has_word("FROM art", 8, "article") == 0);
+  assert(sqldbal_sql_has_word("FROM article", 12, "") == 0);
+  assert(sqldbal_sql_has_word("", 0, "article") == 0);
+}
+
+/**
+ * Check the counters reported by @ref sqldbal_busy_stats.
+ *
+ * @param[in] db                See @ref sqldbal_db.
+ * @param[in] min_num_retries   Expected minimum number of retries.
+ * @param[in] max_num_retries   Expected maximum number of retries.
+ * @param[in] min_wait_ms       Expected minimum total wait time.
+ */
+static void
+sqldbal_test_busy_stats(const struct sqldbal_db *const db,
+                        uint64_t min_num_retries,
+                        uint64_t max_num_retries,
+                        uint64_t min_wait_ms){
+  uint64_t num_retries;
+  uint64_t wait_ms;
+
+  sqldbal_busy_stats(db, &num_retries, &wait_ms);
+  assert(num_retries >= min_num_retries);
+  assert(num_retries <= max_num_retries);
+  assert(wait_ms >= min_wait_ms);
+}
+
+/**
+ * Run all test cases for @ref sqldbal_sqlite_busy_wait.
+ */
+static void
+sqldbal_unit_test_all_sqlite_busy_wait(void){
+  unsigned int attempt;
+
+  sqldbal_test_open_db_sqlite();
+  sqldbal_test_busy_stats(g_db, 0, 0, 0);
+
+  /* Keep retrying until reaching the default timeout. */
+  attempt = 0;
+  while(sqldbal_sqlite_busy_wait(g_db, attempt)){
+    attempt += 1;
+  }
+  assert(attempt >= 2);
+  sqldbal_test_busy_stats(g_db, attempt, attempt, 50);
+
+  /* The wait time stops doubling after reaching the maximum. */
+  assert(sqldbal_sqlite_busy_wait(g_db, 0) == 1);
+  assert(sqldbal_sqlite_busy_wait(g_db, 40) == 1);
+  sqldbal_test_busy_stats(g_db, attempt + 2, attempt + 2, 50);
+  sqldbal_close(g_db);
+}
+
 /**
  * Unit testing functions.
  */
 static void
 sqldbal_unit_test_all(void){
-  sqldbal_unit_test_all_hex2bin();
+  sqldbal_unit_test_all_bulk_escape();
+  sqldbal_unit_test_all_double_to_str();
+  sqldbal_unit_test_all_hex2bin_buf();
+  sqldbal_unit_test_all_pq_float_bin();
+  sqldbal_unit_test_all_pq_int_bin();
+  sqldbal_unit_test_all_pq_timestamp_bin();
   sqldbal_unit_test_all_reallocarray();
   sqldbal_unit_test_all_si();
+  sqldbal_unit_test_all_sql_is_read_only();
+  sqldbal_unit_test_all_sql_transaction_change();
+  sqldbal_unit_test_all_sql_has_word();
+  sqldbal_unit_test_all_sqlite_busy_wait();
+  sqldbal_unit_test_all_stmt_cache_hash();
   sqldbal_unit_test_all_stpcpy();
   sqldbal_unit_test_all_strdup();
+  sqldbal_unit_test_all_strtod();
   sqldbal_unit_test_all_strtoui();
   sqldbal_unit_test_all_strtoi64();
+  sqldbal_unit_test_all_strtotimestamp();
+  sqldbal_unit_test_all_timestamp_to_str();
 }
 
 /**
@@ -797,6 +1428,30 @@ sqldbal_test_db_open(enum sqldbal_driver driver){
   assert(g_rc == SQLDBAL_STATUS_OK);
 }
 
+/**
+ * Open another connection to the same database as @ref g_db.
+ *
+ * @param[out] db New connection.
+ */
+static void
+sqldbal_test_db_open_other(struct sqldbal_db **db){
+  struct sqldbal_test_db_config *config;
+
+  config = &g_db_config_list[
+             sqldbal_test_get_driver_config_i(sqldbal_driver_type(g_db))];
+  g_rc = sqldbal_open(config->driver,
+                      config->location,
+                      config->port,
+                      config->username,
+                      config->password,
+                      config->database,
+                      config->flags,
+                      NULL,
+                      0,
+                      db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
 /**
  * Prepare the @ref g_sql SQL statement and check the result.
  */
@@ -858,6 +1513,29 @@ sqldbal_test_get_db_blob_type(void){
   }
 }
 
+/**
+ * Return the timestamp data type used when creating tables.
+ *
+ * @retval "TIMESTAMP"   Returned for PostgreSQL database driver.
+ * @retval "DATETIME(6)" Returned for MariaDB database driver.
+ * @retval "TEXT"        Returned for all other database drivers.
+ */
+static const char *
+sqldbal_test_get_db_timestamp_type(void){
+  enum sqldbal_driver driver;
+
+  driver = sqldbal_driver_type(g_db);
+  if(driver == SQLDBAL_DRIVER_POSTGRESQL){
+    return "TIMESTAMP";
+  }
+  else if(driver == SQLDBAL_DRIVER_MARIADB || driver == SQLDBAL_DRIVER_MYSQL){
+    return "DATETIME(6)";
+  }
+  else{
+    return "TEXT";
+  }
+}
+
 /**
  * Return the sequence data type used when creating tables.
  *
@@ -935,6 +1613,18 @@ sqldbal_functional_test_create_table(void){
   sqldbal_test_exec_plain("DROP TABLE IF EXISTS test_float");
   sqldbal_test_exec_plain(g_sql);
 
+  sprintf(g_sql,
+          "CREATE TABLE test_typed("
+          "  test_typed_id INTEGER,"
+          "  d             DOUBLE PRECISION,"
+          "  b             BOOLEAN,"
+          "  ts            %s,"
+          "  PRIMARY KEY(test_typed_id)"
+          ")",
+          sqldbal_test_get_db_timestamp_type());
+  sqldbal_test_exec_plain("DROP TABLE IF EXISTS test_typed");
+  sqldbal_test_exec_plain(g_sql);
+
   sprintf(g_sql,
           "CREATE TABLE simple("
           "  simple_id INTEGER,"
@@ -963,6 +1653,28 @@ sqldbal_functional_test_create_table(void){
           seq_attribute);
   sqldbal_test_exec_plain("DROP TABLE IF EXISTS test_sequence");
   sqldbal_test_exec_plain(g_sql);
+
+  sprintf(g_sql,
+          "CREATE TABLE test_batch("
+          "  test_batch_id INTEGER,"
+          "  label         TEXT,"
+          "  data          %s,"
+          "  PRIMARY KEY(test_batch_id)"
+          ")",
+          blob_type);
+  sqldbal_test_exec_plain("DROP TABLE IF EXISTS test_batch");
+  sqldbal_test_exec_plain(g_sql);
+
+  sprintf(g_sql,
+          "CREATE TABLE test_bulk("
+          "  test_bulk_id INTEGER,"
+          "  label        TEXT,"
+          "  data         %s,"
+          "  PRIMARY KEY(test_bulk_id)"
+          ")",
+          blob_type);
+  sqldbal_test_exec_plain("DROP TABLE IF EXISTS test_bulk");
+  sqldbal_test_exec_plain(g_sql);
 }
 
 /**
@@ -1264,15 +1976,12 @@ sqldbal_functional_test_exec_insert(void){
 static void
 sqldbal_functional_test_prepared_select(void){
   enum sqldbal_column_type expect_type;
-  enum sqldbal_driver driver;
   const char *title;
   size_t titlesz;
   int64_t view_count;
   const void *content;
   size_t content_sz;
 
-  driver = sqldbal_driver_type(g_db);
-
   sprintf(g_sql,
           "SELECT a.title      AS title,"
           "       a.view_count AS view_count,"
@@ -1292,15 +2001,7 @@ sqldbal_functional_test_prepared_select(void){
   g_fetch_rc = sqldbal_stmt_fetch(g_stmt);
   assert(g_fetch_rc == SQLDBAL_FETCH_ROW);
 
-  /*
-   * The PostgreSQL and MariaDB drivers return BLOB data type.
-   */
-  if(driver == SQLDBAL_DRIVER_MARIADB || driver == SQLDBAL_DRIVER_POSTGRESQL){
-    expect_type = SQLDBAL_TYPE_BLOB;
-  }
-  else{
-    expect_type = SQLDBAL_TYPE_TEXT;
-  }
+  expect_type = SQLDBAL_TYPE_TEXT;
   sqldbal_test_stmt_column_type(0, expect_type, SQLDBAL_STATUS_OK);
 
   g_rc = sqldbal_stmt_column_text(g_stmt, 0, &title, &titlesz);
@@ -1313,17 +2014,7 @@ sqldbal_functional_test_prepared_select(void){
   assert(g_rc == SQLDBAL_STATUS_OK);
   assert(strcmp(title, g_article_list[0].title) == 0);
 
-  /*
-   * The PostgreSQL and MariaDB drivers return BLOB data type.
-   */
-  if(driver == SQLDBAL_DRIVER_MARIADB ||
-     driver == SQLDBAL_DRIVER_MYSQL ||
-     driver == SQLDBAL_DRIVER_POSTGRESQL){
-    expect_type = SQLDBAL_TYPE_BLOB;
-  }
-  else{
-    expect_type = SQLDBAL_TYPE_INT;
-  }
+  expect_type = SQLDBAL_TYPE_INT;
   sqldbal_test_stmt_column_type(1, expect_type, SQLDBAL_STATUS_OK);
 
   g_rc = sqldbal_stmt_column_int64(g_stmt, 1, &view_count);
@@ -1690,11 +2381,10 @@ sqldbal_functional_test_null(void){
  */
 static void
 sqldbal_functional_test_float(void){
-  enum sqldbal_driver driver;
   enum sqldbal_column_type type;
+  double d;
 
   sqldbal_test_stmt_generate_placeholders();
-  driver = sqldbal_driver_type(g_db);
 
   sprintf(g_sql, "INSERT INTO test_float(test_float_id, test) VALUES(1, 1.0)");
   g_rc = sqldbal_exec(g_db, g_sql, NULL, NULL);
@@ -1706,37 +2396,2460 @@ sqldbal_functional_test_float(void){
   sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
 
   type = sqldbal_stmt_column_type(g_stmt, 0);
+  assert(type == SQLDBAL_TYPE_DOUBLE);
 
-  if(driver == SQLDBAL_DRIVER_SQLITE){
-    assert(type == SQLDBAL_TYPE_OTHER);
-  }
-  else{
-    assert(type == SQLDBAL_TYPE_BLOB);
-  }
+  g_rc = sqldbal_stmt_column_double(g_stmt, 0, &d);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(d > 0 && d < 2);
 
   sqldbal_test_stmt_close_sql();
 }
 
 /**
- * Test reading a blank string.
+ * Test the typed bind and column functions for double-precision floating
+ * point, 32-bit integer, boolean, and timestamp values.
  */
 static void
-sqldbal_functional_test_blank_string(void){
+sqldbal_functional_test_typed(void){
+  const double d_list[] = {(double)5 / 4, (double)-1 / 10};
+  const int64_t ts_list[] = {
+    INT64_C(1600000000123456),
+    INT64_C(-86400000000)
+  };
+  double d;
+  int32_t i32;
+  int64_t ts;
+  int b;
   const char *text;
-  size_t textsz;
+  size_t i;
 
   sqldbal_test_stmt_generate_placeholders();
-  sprintf(g_sql, "SELECT author FROM article WHERE article_id = 4");
+
+  sprintf(g_sql,
+          "INSERT INTO test_typed(test_typed_id, d, b, ts) "
+          "VALUES(%s, %s, %s, %s)",
+          g_q[0],
+          g_q[1],
+          g_q[2],
+          g_q[3]);
   sqldbal_test_stmt_prepare_sql();
+  for(i = 0; i < 2; i++){
+    g_rc = sqldbal_stmt_bind_int32(g_stmt, 0, (int32_t)i - 1);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_bind_double(g_stmt, 1, d_list[i]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_bind_bool(g_stmt, 2, (int)(i + 1) % 2 * 10);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_bind_timestamp(g_stmt, 3, ts_list[i]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  }
+  g_rc = sqldbal_stmt_bind_int32(g_stmt, 0, INT32_MAX);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  for(i = 1; i < 4; i++){
+    g_rc = sqldbal_stmt_bind_null(g_stmt, i);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
   sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
-  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
-  g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text, &textsz);
-  assert(strcmp(text, "") == 0);
-  assert(textsz == 0);
   sqldbal_test_stmt_close_sql();
-}
 
-/**
+  sprintf(g_sql,
+          "SELECT test_typed_id, d, b, ts "
+          "  FROM test_typed "
+          "  ORDER BY test_typed_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  for(i = 0; i < 2; i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+
+    g_rc = sqldbal_stmt_column_int32(g_stmt, 0, &i32);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(i32 == (int32_t)i - 1);
+
+    sqldbal_test_stmt_column_type(1, SQLDBAL_TYPE_DOUBLE, SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_column_double(g_stmt, 1, &d);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(memcmp(&d, &d_list[i], sizeof(d)) == 0);
+
+    g_rc = sqldbal_stmt_column_bool(g_stmt, 2, &b);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(b == (int)(i + 1) % 2);
+
+    g_rc = sqldbal_stmt_column_timestamp(g_stmt, 3, &ts);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(ts == ts_list[i]);
+  }
+  g_rc = sqldbal_stmt_column_text(g_stmt, 3, &text, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(strncmp(text, "1969-12-31 00:00:00", 19) == 0);
+
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_double(g_stmt, 1, &d);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(d < 1 && d > -1);
+  g_rc = sqldbal_stmt_column_bool(g_stmt, 2, &b);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(b == 0);
+  g_rc = sqldbal_stmt_column_timestamp(g_stmt, 3, &ts);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(ts == 0);
+  g_rc = sqldbal_stmt_column_int32(g_stmt, 0, &i32);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(i32 == INT32_MAX);
+
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+
+  /* Does not fit in a 32-bit integer. */
+  sprintf(g_sql, "SELECT 4294967296");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_int32(g_stmt, 0, &i32);
+  assert(g_rc == SQLDBAL_STATUS_COLUMN_COERCE);
+  assert(i32 == 0);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Test harness for @ref sqldbal_stmt_fetch_columns.
+ *
+ * @param[in] max_rows      Maximum number of rows to fetch.
+ * @param[in] vector_list   See @ref sqldbal_column_vector.
+ * @param[in] expect_status Expected status return code of the function under
+ *                          test.
+ * @param[in] expect_fetch  Expected fetch result.
+ * @param[in] expect_rows   Expected number of rows returned.
+ */
+static void
+sqldbal_test_stmt_fetch_columns(
+  size_t max_rows,
+  struct sqldbal_column_vector *const vector_list,
+  enum sqldbal_status_code expect_status,
+  enum sqldbal_fetch_result expect_fetch,
+  size_t expect_rows){
+  enum sqldbal_fetch_result fetch;
+  size_t num_rows;
+
+  fetch = sqldbal_stmt_fetch_columns(g_stmt, max_rows, vector_list, &num_rows);
+  assert(fetch == expect_fetch);
+  assert(num_rows == expect_rows);
+
+  g_rc = sqldbal_status_code_get(g_db);
+  assert(g_rc == expect_status);
+  sqldbal_status_code_clear(g_db);
+}
+
+/**
+ * Fetch results into column-wise arrays.
+ */
+static void
+sqldbal_functional_test_fetch_columns(void){
+  struct sqldbal_column_vector vector_list[4];
+  int64_t i64_list[4][8];
+  double d_list[8];
+  int32_t offset_list[2][9];
+  char title[40];
+  char content[128];
+  unsigned char validity_bitmap[4];
+  struct sqldbal_test_article *article;
+  int64_t article_id;
+  int64_t ts;
+  size_t i;
+
+  memset(vector_list, 0, sizeof(vector_list));
+  vector_list[0].type        = SQLDBAL_TYPE_INT;
+  vector_list[0].i64_list    = i64_list[0];
+  vector_list[1].type        = SQLDBAL_TYPE_TEXT;
+  vector_list[1].offset_list = offset_list[0];
+  vector_list[1].data        = title;
+  vector_list[1].data_size   = sizeof(title);
+  vector_list[2].type        = SQLDBAL_TYPE_INT;
+  vector_list[2].i64_list    = i64_list[2];
+  vector_list[3].type        = SQLDBAL_TYPE_BLOB;
+  vector_list[3].offset_list = offset_list[1];
+  vector_list[3].data        = content;
+  vector_list[3].data_size   = sizeof(content);
+
+  sprintf(g_sql,
+          "SELECT article_id, title, view_count, content "
+          "  FROM article "
+          "  WHERE article_id < 5 "
+          "  ORDER BY article_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+
+  /* The third title does not fit, so it gets returned by the next fetch. */
+  sqldbal_test_stmt_fetch_columns(4,
+                                  vector_list,
+                                  SQLDBAL_STATUS_OK,
+                                  SQLDBAL_FETCH_ROW,
+                                  2);
+  for(i = 0; i < 2; i++){
+    article = &g_article_list[i];
+    assert(i64_list[0][i] == article->article_id);
+    assert(i64_list[2][i] == (int64_t)article->view_count);
+    assert((size_t)(offset_list[0][i + 1] - offset_list[0][i]) ==
+           strlen(article->title));
+    assert(memcmp(&title[offset_list[0][i]],
+                  article->title,
+                  strlen(article->title)) == 0);
+    assert((size_t)(offset_list[1][i + 1] - offset_list[1][i]) ==
+           strlen(article->content));
+    assert(memcmp(&content[offset_list[1][i]],
+                  article->content,
+                  strlen(article->content)) == 0);
+  }
+  assert(offset_list[0][0] == 0);
+  assert(vector_list[0].null_count == 0);
+
+  /* Mix with the row-wise interface. */
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &article_id);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(article_id == g_article_list[2].article_id);
+
+  sqldbal_test_stmt_fetch_columns(4,
+                                  vector_list,
+                                  SQLDBAL_STATUS_OK,
+                                  SQLDBAL_FETCH_ROW,
+                                  1);
+  assert(i64_list[0][0] == g_article_list[3].article_id);
+  assert(offset_list[0][1] == 3);
+  assert(memcmp(title, "abc", 3) == 0);
+
+  sqldbal_test_stmt_fetch_columns(4,
+                                  vector_list,
+                                  SQLDBAL_STATUS_OK,
+                                  SQLDBAL_FETCH_DONE,
+                                  0);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+
+  /* A single row does not fit. */
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  vector_list[1].data_size = 2;
+  sqldbal_test_stmt_fetch_columns(4,
+                                  vector_list,
+                                  SQLDBAL_STATUS_OVERFLOW,
+                                  SQLDBAL_FETCH_ERROR,
+                                  0);
+
+  /* Invalid parameters. */
+  sqldbal_test_stmt_fetch_columns(0,
+                                  vector_list,
+                                  SQLDBAL_STATUS_PARAM,
+                                  SQLDBAL_FETCH_ERROR,
+                                  0);
+  vector_list[1].type = SQLDBAL_TYPE_NULL;
+  sqldbal_test_stmt_fetch_columns(4,
+                                  vector_list,
+                                  SQLDBAL_STATUS_PARAM,
+                                  SQLDBAL_FETCH_ERROR,
+                                  0);
+  vector_list[1].type = SQLDBAL_TYPE_TEXT;
+  vector_list[1].offset_list = NULL;
+  sqldbal_test_stmt_fetch_columns(4,
+                                  vector_list,
+                                  SQLDBAL_STATUS_PARAM,
+                                  SQLDBAL_FETCH_ERROR,
+                                  0);
+  sqldbal_test_stmt_close_sql();
+
+  /* Native types with NULL values. */
+  memset(vector_list, 0, sizeof(vector_list));
+  memset(validity_bitmap, 0xff, sizeof(validity_bitmap));
+  vector_list[0].type            = SQLDBAL_TYPE_INT;
+  vector_list[0].i64_list        = i64_list[0];
+  vector_list[0].validity_bitmap = &validity_bitmap[0];
+  vector_list[1].type            = SQLDBAL_TYPE_DOUBLE;
+  vector_list[1].d_list          = d_list;
+  vector_list[1].validity_bitmap = &validity_bitmap[1];
+  vector_list[2].type            = SQLDBAL_TYPE_BOOL;
+  vector_list[2].i64_list        = i64_list[2];
+  vector_list[2].validity_bitmap = &validity_bitmap[2];
+  vector_list[3].type            = SQLDBAL_TYPE_TIMESTAMP;
+  vector_list[3].i64_list        = i64_list[3];
+  vector_list[3].validity_bitmap = &validity_bitmap[3];
+
+  sprintf(g_sql,
+          "SELECT test_typed_id, d, b, ts "
+          "  FROM test_typed "
+          "  ORDER BY test_typed_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_columns(8,
+                                  vector_list,
+                                  SQLDBAL_STATUS_OK,
+                                  SQLDBAL_FETCH_ROW,
+                                  3);
+  assert(i64_list[0][0] == -1);
+  assert(i64_list[0][2] == INT32_MAX);
+  assert(d_list[0] > 1 && d_list[0] < 2);
+  assert(d_list[1] < 0);
+  assert(i64_list[2][0] == 1);
+  assert(i64_list[2][1] == 0);
+  ts = INT64_C(1600000000123456);
+  assert(i64_list[3][0] == ts);
+  assert(i64_list[3][2] == 0);
+  assert((validity_bitmap[0] & 0x07) == 0x07);
+  assert(vector_list[0].null_count == 0);
+  for(i = 1; i < 4; i++){
+    assert((validity_bitmap[i] & 0x07) == 0x03);
+    assert(vector_list[i].null_count == 1);
+  }
+  sqldbal_test_stmt_fetch_columns(8,
+                                  vector_list,
+                                  SQLDBAL_STATUS_OK,
+                                  SQLDBAL_FETCH_DONE,
+                                  0);
+  assert(vector_list[1].null_count == 0);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Test harness for @ref sqldbal_stmt_execute_batch.
+ *
+ * @param[in] param_list    See @ref sqldbal_batch_param.
+ * @param[in] num_rows      Number of rows in @p param_list.
+ * @param[in] expect_status Expected status return code of the function under
+ *                          test.
+ */
+static void
+sqldbal_test_stmt_execute_batch(
+  const struct sqldbal_batch_param *const param_list,
+  size_t num_rows,
+  enum sqldbal_status_code expect_status){
+  g_rc = sqldbal_stmt_execute_batch(g_stmt, param_list, num_rows);
+  assert(g_rc == expect_status);
+}
+
+/**
+ * Insert multiple rows using column-wise arrays.
+ */
+static void
+sqldbal_functional_test_execute_batch(void){
+  const int64_t id_list[] = {1, 2, 3};
+  const int64_t dup_id_list[] = {4, 1};
+  const char *const label_list[] = {"one", NULL, "three"};
+  const void *const data_list[] = {"a", "bb", "ccc"};
+  const size_t data_len_list[] = {1, 2, 3};
+  const unsigned char label_null_bitmap[] = {0x02};
+  struct sqldbal_batch_param param_list[3];
+  enum sqldbal_driver driver;
+  const char *text;
+  const void *blob;
+  size_t textsz;
+  size_t blobsz;
+  int64_t i64;
+  size_t i;
+
+  driver = sqldbal_driver_type(g_db);
+
+  memset(param_list, 0, sizeof(param_list));
+  param_list[0].type = SQLDBAL_TYPE_INT;
+  param_list[0].i64_list = id_list;
+  param_list[1].type = SQLDBAL_TYPE_TEXT;
+  param_list[1].text_list = label_list;
+  param_list[1].null_bitmap = label_null_bitmap;
+  param_list[2].type = SQLDBAL_TYPE_BLOB;
+  param_list[2].blob_list = data_list;
+  param_list[2].length_list = data_len_list;
+
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql,
+          "INSERT INTO test_batch(test_batch_id, label, data)"
+          "                VALUES(%s           , %s   , %s  )",
+          g_q[0],
+          g_q[1],
+          g_q[2]);
+  sqldbal_test_stmt_prepare_sql();
+
+  /* Zero rows does nothing. */
+  sqldbal_test_stmt_execute_batch(param_list, 0, SQLDBAL_STATUS_OK);
+
+  sqldbal_test_stmt_execute_batch(param_list, 3, SQLDBAL_STATUS_OK);
+
+  /* Duplicate key in the last row. */
+  param_list[0].i64_list = dup_id_list;
+  sqldbal_test_stmt_execute_batch(param_list, 2, SQLDBAL_STATUS_EXEC);
+  g_rc = sqldbal_status_code_clear(g_db);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+
+  /* Invalid parameter type. */
+  param_list[0].type = SQLDBAL_TYPE_OTHER;
+  sqldbal_test_stmt_execute_batch(param_list, 2, SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_status_code_clear(g_db);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+
+  /* Missing blob lengths. */
+  param_list[0].type = SQLDBAL_TYPE_INT;
+  param_list[2].length_list = NULL;
+  sqldbal_test_stmt_execute_batch(param_list, 2, SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_status_code_clear(g_db);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_test_stmt_close_sql();
+
+  sprintf(g_sql,
+          "SELECT test_batch_id, label, data FROM test_batch"
+          " ORDER BY test_batch_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  for(i = 0; i < 3; i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &i64);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(i64 == id_list[i]);
+
+    g_rc = sqldbal_stmt_column_text(g_stmt, 1, &text, &textsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    if(label_list[i]){
+      assert(strcmp(text, label_list[i]) == 0);
+      assert(textsz == strlen(label_list[i]));
+    }
+    else{
+      assert(text == NULL);
+    }
+
+    g_rc = sqldbal_stmt_column_blob(g_stmt, 2, &blob, &blobsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(blobsz == data_len_list[i]);
+    assert(memcmp(blob, data_list[i], blobsz) == 0);
+  }
+
+  /* The failed batch did not insert any rows. */
+  if(driver != SQLDBAL_DRIVER_MARIADB && driver != SQLDBAL_DRIVER_MYSQL){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  }
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Test fetching column values larger than the initial fetch buffers used by
+ * some of the drivers, across multiple executions of the same statement.
+ */
+static void
+sqldbal_functional_test_large_column(void){
+  char label[1001];
+  unsigned char data[3000];
+  const char *text;
+  const void *blob;
+  size_t textsz;
+  size_t blobsz;
+  int64_t i64;
+  size_t i;
+
+  memset(label, 'x', sizeof(label) - 1);
+  label[sizeof(label) - 1] = '\0';
+  for(i = 0; i < sizeof(data); i++){
+    data[i] = (unsigned char)i;
+  }
+
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql,
+          "INSERT INTO test_batch(test_batch_id, label, data)"
+          "                VALUES(100          , %s   , %s  )",
+          g_q[0],
+          g_q[1]);
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_text(g_stmt, 0, label, SIZE_MAX);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_blob(g_stmt, 1, data, sizeof(data));
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_close_sql();
+
+  sprintf(g_sql,
+          "SELECT test_batch_id, label, data FROM test_batch"
+          " WHERE test_batch_id = 100");
+  sqldbal_test_stmt_prepare_sql();
+  for(i = 0; i < 2; i++){
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &i64);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(i64 == 100);
+
+    g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text, &textsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strcmp(text, "100") == 0);
+
+    g_rc = sqldbal_stmt_column_text(g_stmt, 1, &text, &textsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strcmp(text, label) == 0);
+    assert(textsz == strlen(label));
+
+    g_rc = sqldbal_stmt_column_blob(g_stmt, 2, &blob, &blobsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(blobsz == sizeof(data));
+    assert(memcmp(blob, data, blobsz) == 0);
+
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  }
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Test binding values without copying them, and rebinding copied values
+ * that grow and shrink between executions.
+ */
+static void
+sqldbal_functional_test_bind_static(void){
+  const char *const label_list[] = {"ab", "abcdefghij", "abc"};
+  const unsigned char data[] = {0x00, 0x01, 0xfe, 0xff};
+  const char *text;
+  const void *blob;
+  size_t textsz;
+  size_t blobsz;
+  int64_t i64;
+  size_t i;
+
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql,
+          "INSERT INTO test_batch(test_batch_id, label, data)"
+          "                VALUES(%s           , %s   , %s  )",
+          g_q[0],
+          g_q[1],
+          g_q[2]);
+  sqldbal_test_stmt_prepare_sql();
+  for(i = 0; i < 6; i++){
+    g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, 200 + (int64_t)i);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    if(i < 3){
+      g_rc = sqldbal_stmt_bind_text_static(g_stmt, 1, label_list[i], SIZE_MAX);
+      assert(g_rc == SQLDBAL_STATUS_OK);
+      g_rc = sqldbal_stmt_bind_blob_static(g_stmt, 2, data, sizeof(data));
+      assert(g_rc == SQLDBAL_STATUS_OK);
+    }
+    else{
+      g_rc = sqldbal_stmt_bind_text(g_stmt, 1, label_list[i - 3], SIZE_MAX);
+      assert(g_rc == SQLDBAL_STATUS_OK);
+      g_rc = sqldbal_stmt_bind_blob(g_stmt, 2, data, i - 2);
+      assert(g_rc == SQLDBAL_STATUS_OK);
+    }
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  }
+  sqldbal_test_stmt_close_sql();
+
+  sprintf(g_sql,
+          "SELECT test_batch_id, label, data FROM test_batch"
+          " WHERE test_batch_id >= 200 ORDER BY test_batch_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  for(i = 0; i < 6; i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &i64);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(i64 == 200 + (int64_t)i);
+
+    g_rc = sqldbal_stmt_column_text(g_stmt, 1, &text, &textsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strcmp(text, label_list[i % 3]) == 0);
+
+    g_rc = sqldbal_stmt_column_blob(g_stmt, 2, &blob, &blobsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    if(i < 3){
+      assert(blobsz == sizeof(data));
+    }
+    else{
+      assert(blobsz == i - 2);
+    }
+    assert(memcmp(blob, data, blobsz) == 0);
+  }
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Test reading a blank string.
+ */
+static void
+sqldbal_functional_test_blank_string(void){
+  const char *text;
+  const void *blob;
+  size_t textsz;
+  size_t blobsz;
+
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql, "SELECT author FROM article WHERE article_id = 4");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text, &textsz);
+  assert(strcmp(text, "") == 0);
+  assert(textsz == 0);
+  sqldbal_test_stmt_close_sql();
+
+  /* Copy empty parameter values into the statement buffers. */
+  sqldbal_test_exec_plain("DELETE FROM test_bulk");
+  sprintf(g_sql,
+          "INSERT INTO test_bulk(test_bulk_id, label, data) VALUES(%s, %s, %s)",
+          g_q[0], g_q[1], g_q[2]);
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_text(g_stmt, 1, "", SIZE_MAX);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_blob(g_stmt, 2, "", 0);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_close_sql();
+  sprintf(g_sql, "SELECT data FROM test_bulk WHERE test_bulk_id = 1");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_blob(g_stmt, 0, &blob, &blobsz);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(blobsz == 0);
+  sqldbal_test_stmt_close_sql();
+  sqldbal_test_exec_plain("DELETE FROM test_bulk");
+}
+
+/**
+ * Check the prepared statement cache counters.
+ *
+ * @param[in] expect_hits   Expected number of cache hits.
+ * @param[in] expect_misses Expected number of cache misses.
+ * @param[in] expect_stmts  Expected number of statements in the cache.
+ */
+static void
+sqldbal_test_stmt_cache_stats(uint64_t expect_hits,
+                              uint64_t expect_misses,
+                              size_t expect_stmts){
+  uint64_t num_hits;
+  uint64_t num_misses;
+  size_t num_stmts;
+
+  sqldbal_stmt_cache_stats(g_db, &num_hits, &num_misses, &num_stmts);
+  assert(num_hits == expect_hits);
+  assert(num_misses == expect_misses);
+  assert(num_stmts == expect_stmts);
+}
+
+/**
+ * Test reusing prepared statements from the statement cache.
+ */
+static void
+sqldbal_functional_test_stmt_cache(void){
+  const char *const sql_a = "SELECT * FROM article";
+  const char *const sql_b = "SELECT article_id FROM article";
+  struct sqldbal_stmt *stmt1;
+  struct sqldbal_stmt *stmt2;
+  uint64_t hits;
+  uint64_t misses;
+  size_t num_stmts;
+
+  g_rc = sqldbal_stmt_cache_set_capacity(g_db, 2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_stmt_cache_stats(g_db, &hits, &misses, &num_stmts);
+  assert(num_stmts == 0);
+
+  /* Closing returns the statement to the cache. */
+  g_rc = sqldbal_stmt_prepare(g_db, sql_a, (size_t)-1, &stmt1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_execute(stmt1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_fetch_rc = sqldbal_stmt_fetch(stmt1);
+  assert(g_fetch_rc == SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_close(stmt1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_cache_stats(hits, misses + 1, 1);
+
+  /* The same SQL text gets the cached statement. */
+  g_rc = sqldbal_stmt_prepare(g_db, sql_a, strlen(sql_a), &stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(stmt2 == stmt1);
+  sqldbal_test_stmt_cache_stats(hits + 1, misses + 1, 0);
+  g_rc = sqldbal_stmt_execute(stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_fetch_rc = sqldbal_stmt_fetch(stmt2);
+  assert(g_fetch_rc == SQLDBAL_FETCH_ROW);
+
+  /* Statements in use do not get shared. */
+  g_rc = sqldbal_stmt_prepare(g_db, sql_a, (size_t)-1, &stmt1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(stmt1 != stmt2);
+  sqldbal_test_stmt_cache_stats(hits + 1, misses + 2, 0);
+  g_rc = sqldbal_stmt_close(stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_close(stmt1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_cache_stats(hits + 1, misses + 2, 2);
+
+  /* Evict the least recently used statement. */
+  g_rc = sqldbal_stmt_prepare(g_db, sql_b, (size_t)-1, &stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_close(stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_cache_stats(hits + 1, misses + 3, 2);
+  g_rc = sqldbal_stmt_prepare(g_db, sql_a, (size_t)-1, &stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(stmt2 == stmt1);
+  sqldbal_test_stmt_cache_stats(hits + 2, misses + 3, 1);
+
+  /* Reset runs the statement again without closing it. */
+  g_rc = sqldbal_stmt_execute(stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_fetch_rc = sqldbal_stmt_fetch(stmt2);
+  assert(g_fetch_rc == SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_reset(stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_execute(stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_fetch_rc = sqldbal_stmt_fetch(stmt2);
+  assert(g_fetch_rc == SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_close(stmt2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* The connection still works after closing partially read results. */
+  sqldbal_functional_test_exec_select();
+
+  g_rc = sqldbal_stmt_cache_set_capacity(g_db, 0);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_cache_stats(hits + 2, misses + 3, 0);
+}
+
+/**
+ * Queue statements between @ref sqldbal_pipeline_begin and
+ * @ref sqldbal_pipeline_end and then fetch each result in order.
+ */
+static void
+sqldbal_functional_test_pipeline(void){
+  struct sqldbal_stmt *stmt_list[3];
+  struct sqldbal_stmt *stmt_close;
+  const char *title;
+  size_t i;
+
+  g_rc = sqldbal_pipeline_end(g_db);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql, "SELECT title FROM article WHERE article_id = %s", g_q[0]);
+  for(i = 0; i < 3; i++){
+    g_rc = sqldbal_stmt_prepare(g_db, g_sql, SIZE_MAX, &stmt_list[i]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+  g_rc = sqldbal_stmt_prepare(g_db, g_sql_valid_sel, SIZE_MAX, &stmt_close);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  g_rc = sqldbal_pipeline_begin(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pipeline_begin(g_db);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  /* Execute in the opposite order of the article list. */
+  for(i = 3; i > 0; i--){
+    g_rc = sqldbal_stmt_bind_int64(stmt_list[i - 1],
+                                   0,
+                                   g_article_list[i - 1].article_id);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_execute(stmt_list[i - 1]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+
+  /* The asynchronous interface can not get used in a pipeline. */
+  g_rc = sqldbal_stmt_execute_start(stmt_list[0]);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  /* Close a statement with a queued result. */
+  g_rc = sqldbal_stmt_execute(stmt_close);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_close(stmt_close);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  g_rc = sqldbal_pipeline_end(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  for(i = 0; i < 3; i++){
+    g_stmt = stmt_list[i];
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_stmt_column_text(g_stmt, 0, &title, NULL);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strcmp(title, g_article_list[i].title) == 0);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+    sqldbal_test_stmt_close(SQLDBAL_STATUS_OK);
+  }
+
+  /* Statements execute immediately again after the pipeline ends. */
+  sqldbal_functional_test_exec_select();
+}
+
+/**
+ * Load rows with @ref sqldbal_bulk_begin and read them back.
+ */
+static void
+sqldbal_functional_test_bulk(void){
+  const char *const column_list[] = {"test_bulk_id", "label", "data"};
+  const char *const label_list[] = {"plain", "tab\there", "line\nbreak\r",
+                                    "back\\slash", "\\N"};
+  const unsigned char data[] = {0x00, '\t', '\\', 0xff, '\n'};
+  struct sqldbal_batch_param param_list[3];
+  struct sqldbal_bulk *bulk;
+  int64_t id_list[130];
+  const char *text_list[130];
+  const void *blob_list[130];
+  size_t length_list[130];
+  unsigned char null_bitmap[(130 + 7) / 8];
+  enum sqldbal_driver driver;
+  const char *text;
+  const void *blob;
+  size_t textsz;
+  size_t blobsz;
+  int64_t i64;
+  size_t i;
+  unsigned int local_infile;
+
+  driver = sqldbal_driver_type(g_db);
+
+  memset(null_bitmap, 0, sizeof(null_bitmap));
+  for(i = 0; i < 130; i++){
+    id_list[i] = (int64_t)i + 1;
+    text_list[i] = label_list[i % 5];
+    blob_list[i] = data;
+    length_list[i] = i % (sizeof(data) + 1);
+    if(i % 7 == 0){
+      null_bitmap[i / 8] |= (unsigned char)(1 << (i % 8));
+    }
+  }
+  memset(param_list, 0, sizeof(param_list));
+  param_list[0].type = SQLDBAL_TYPE_INT;
+  param_list[0].i64_list = id_list;
+  param_list[1].type = SQLDBAL_TYPE_TEXT;
+  param_list[1].text_list = text_list;
+  param_list[1].null_bitmap = null_bitmap;
+  param_list[2].type = SQLDBAL_TYPE_BLOB;
+  param_list[2].blob_list = blob_list;
+  param_list[2].length_list = length_list;
+
+  /* A bulk load needs at least one column. */
+  g_rc = sqldbal_bulk_begin(g_db, "test_bulk", column_list, 0, &bulk);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_bulk_end(bulk);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  /* Load the rows using several calls. */
+  g_rc = sqldbal_bulk_begin(g_db, "test_bulk", column_list, 3, &bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_rows(bulk, param_list, 0);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_rows(bulk, param_list, 50);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  param_list[0].i64_list = &id_list[50];
+  param_list[1].text_list = &text_list[50];
+  param_list[1].null_bitmap = NULL;
+  param_list[2].blob_list = &blob_list[50];
+  param_list[2].length_list = &length_list[50];
+  g_rc = sqldbal_bulk_rows(bulk, param_list, 80);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_end(bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* LOCAL INFILE gets turned back off after the load. */
+  if(driver == SQLDBAL_DRIVER_MARIADB || driver == SQLDBAL_DRIVER_MYSQL){
+    local_infile = 1;
+    mysql_get_option(sqldbal_db_handle(g_db),
+                     MYSQL_OPT_LOCAL_INFILE,
+                     &local_infile);
+    assert(local_infile == 0);
+  }
+
+  sprintf(g_sql,
+          "SELECT test_bulk_id, label, data FROM test_bulk"
+          " ORDER BY test_bulk_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  for(i = 0; i < 130; i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &i64);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(i64 == id_list[i]);
+
+    g_rc = sqldbal_stmt_column_text(g_stmt, 1, &text, &textsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    if(i < 50 && i % 7 == 0){
+      assert(text == NULL);
+    }
+    else{
+      assert(strcmp(text, text_list[i]) == 0);
+      assert(textsz == strlen(text_list[i]));
+    }
+
+    g_rc = sqldbal_stmt_column_blob(g_stmt, 2, &blob, &blobsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(blobsz == length_list[i]);
+    assert(blobsz == 0 || memcmp(blob, data, blobsz) == 0);
+  }
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+
+  /* A failed bulk load does not keep any rows. */
+  if(driver != SQLDBAL_DRIVER_MARIADB && driver != SQLDBAL_DRIVER_MYSQL){
+    sqldbal_test_exec_plain("DELETE FROM test_bulk WHERE test_bulk_id > 1");
+    g_rc = sqldbal_bulk_begin(g_db, "test_bulk", column_list, 3, &bulk);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_bulk_rows(bulk, param_list, 80);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    param_list[0].i64_list = id_list;
+    g_rc = sqldbal_bulk_rows(bulk, param_list, 1);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_bulk_end(bulk);
+    assert(g_rc == SQLDBAL_STATUS_EXEC);
+    sqldbal_status_code_clear(g_db);
+
+    sprintf(g_sql, "SELECT test_bulk_id FROM test_bulk");
+    sqldbal_test_stmt_prepare_sql();
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+    sqldbal_test_stmt_close_sql();
+  }
+}
+
+/**
+ * Check the label of every row in the test_bulk table.
+ *
+ * @param[in] num_rows  Expected number of rows, with ids starting at 1.
+ * @param[in] first_new First id loaded with @p new_label.
+ * @param[in] old_label Label of the rows before @p first_new.
+ * @param[in] new_label Label of the rows starting at @p first_new.
+ */
+static void
+sqldbal_test_bulk_insert_labels(size_t num_rows,
+                                int64_t first_new,
+                                const char *const old_label,
+                                const char *const new_label){
+  const char *text;
+  int64_t i64;
+  size_t i;
+
+  sprintf(g_sql,
+          "SELECT test_bulk_id, label FROM test_bulk ORDER BY test_bulk_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  for(i = 0; i < num_rows; i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &i64);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(i64 == (int64_t)i + 1);
+    g_rc = sqldbal_stmt_column_text(g_stmt, 1, &text, NULL);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strcmp(text, i64 < first_new ? old_label : new_label) == 0);
+  }
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Load rows with @ref sqldbal_bulk_begin_insert, including upserts.
+ */
+static void
+sqldbal_functional_test_bulk_insert(void){
+  const char *const column_list[] = {"test_bulk_id", "label", "data"};
+  const char *const label_list[] = {"a", "b", "c", "d", "e"};
+  const char *const expect_list[] = {"e", "b", "d"};
+  struct sqldbal_batch_param param_list[3];
+  struct sqldbal_bulk *bulk;
+  int64_t id_list[40];
+  const char *text_list[40];
+  const void *blob_list[40];
+  size_t length_list[40];
+  const char *text;
+  size_t i;
+
+  for(i = 0; i < 40; i++){
+    id_list[i] = (int64_t)i + 1;
+    text_list[i] = "old";
+    blob_list[i] = "ab";
+    length_list[i] = 2;
+  }
+  memset(param_list, 0, sizeof(param_list));
+  param_list[0].type = SQLDBAL_TYPE_INT;
+  param_list[0].i64_list = id_list;
+  param_list[1].type = SQLDBAL_TYPE_TEXT;
+  param_list[1].text_list = text_list;
+  param_list[2].type = SQLDBAL_TYPE_BLOB;
+  param_list[2].blob_list = blob_list;
+  param_list[2].length_list = length_list;
+
+  sqldbal_test_exec_plain("DELETE FROM test_bulk");
+
+  /* A bulk load needs at least one column. */
+  g_rc = sqldbal_bulk_begin_insert(g_db,
+                                   "test_bulk",
+                                   column_list,
+                                   0,
+                                   NULL,
+                                   0,
+                                   0,
+                                   &bulk);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_bulk_end(bulk);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  /* Two full INSERT statements and one partial statement. */
+  g_rc = sqldbal_bulk_begin_insert(g_db,
+                                   "test_bulk",
+                                   column_list,
+                                   3,
+                                   NULL,
+                                   0,
+                                   16,
+                                   &bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_rows(bulk, param_list, 40);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_end(bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_bulk_insert_labels(40, 41, "old", "new");
+
+  /* Update rows 21 - 40 and insert rows 41 - 60. */
+  for(i = 0; i < 40; i++){
+    id_list[i] = (int64_t)i + 21;
+    text_list[i] = "new";
+  }
+  g_rc = sqldbal_bulk_begin_insert(g_db,
+                                   "test_bulk",
+                                   column_list,
+                                   3,
+                                   column_list,
+                                   1,
+                                   0,
+                                   &bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_rows(bulk, param_list, 40);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_end(bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_bulk_insert_labels(60, 21, "old", "new");
+
+  /* Conflicting rows get skipped when every column belongs to the key. */
+  for(i = 0; i < 40; i++){
+    id_list[i] = (int64_t)i + 31;
+  }
+  g_rc = sqldbal_bulk_begin_insert(g_db,
+                                   "test_bulk",
+                                   column_list,
+                                   1,
+                                   column_list,
+                                   1,
+                                   7,
+                                   &bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_rows(bulk, param_list, 40);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_end(bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sprintf(g_sql, "SELECT COUNT(*) FROM test_bulk WHERE label IS NULL");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &id_list[0]);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(id_list[0] == 10);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+
+  /* Rows that repeat a key get applied in order. */
+  for(i = 0; i < 5; i++){
+    id_list[i] = (int64_t)(i % 2 ? i / 2 + 2 : 1);
+    text_list[i] = label_list[i];
+  }
+  g_rc = sqldbal_bulk_begin_insert(g_db,
+                                   "test_bulk",
+                                   column_list,
+                                   3,
+                                   column_list,
+                                   1,
+                                   4,
+                                   &bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_rows(bulk, param_list, 5);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_bulk_end(bulk);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sprintf(g_sql,
+          "SELECT label FROM test_bulk WHERE test_bulk_id < 4"
+          " ORDER BY test_bulk_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  for(i = 0; i < 3; i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text, NULL);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strcmp(text, expect_list[i]) == 0);
+  }
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Read the data column of a test_bulk row in chunks and compare it with
+ * @p expect.
+ *
+ * @param[in] id       Value of test_bulk_id in the row to read.
+ * @param[in] expect   Expected value of the data column.
+ * @param[in] expectsz Number of bytes in @p expect.
+ */
+static void
+sqldbal_test_blob_column_read(int64_t id,
+                              const unsigned char *const expect,
+                              size_t expectsz){
+  unsigned char buf[700];
+  size_t offset;
+  size_t len;
+
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql, "SELECT data FROM test_bulk WHERE test_bulk_id = %s", g_q[0]);
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, id);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  offset = 0;
+  do{
+    g_rc = sqldbal_stmt_column_blob_read(g_stmt,
+                                         0,
+                                         offset,
+                                         buf,
+                                         sizeof(buf),
+                                         &len);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(offset + len <= expectsz);
+    assert(memcmp(buf, &expect[offset], len) == 0);
+    offset += len;
+  } while(len);
+  assert(offset == expectsz);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Move large values in chunks with @ref sqldbal_stmt_send_blob,
+ * @ref sqldbal_stmt_column_blob_read, and @ref sqldbal_blob_open.
+ */
+static void
+sqldbal_functional_test_blob_stream(void){
+  unsigned char data[3000];
+  unsigned char buf[1000];
+  struct sqldbal_blob *blob;
+  struct sqldbal_db *db;
+  enum sqldbal_driver driver;
+  uint64_t size;
+  int64_t oid;
+  size_t i;
+
+  driver = sqldbal_driver_type(g_db);
+  for(i = 0; i < sizeof(data); i++){
+    data[i] = (unsigned char)(i * 7);
+  }
+  sqldbal_test_exec_plain("DELETE FROM test_bulk");
+
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql,
+          "INSERT INTO test_bulk(test_bulk_id, label, data) VALUES(%s, %s, %s)",
+          g_q[0], g_q[1], g_q[2]);
+  sqldbal_test_stmt_prepare_sql();
+
+  /* Sending a chunk requires a streamed placeholder. */
+  g_rc = sqldbal_stmt_send_blob(g_stmt, 2, data, 10);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_null(g_stmt, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_blob_stream(g_stmt, 2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  for(i = 0; i < sizeof(data); i += 1000){
+    g_rc = sqldbal_stmt_send_blob(g_stmt, 2, &data[i], 1000);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+
+  /* An empty streamed value. */
+  g_rc = sqldbal_stmt_reset(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, 2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_null(g_stmt, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_blob_stream(g_stmt, 2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_close_sql();
+
+  sqldbal_test_blob_column_read(1, data, sizeof(data));
+  sqldbal_test_blob_column_read(2, data, 0);
+
+  if(driver == SQLDBAL_DRIVER_SQLITE){
+    sqldbal_test_exec_plain("INSERT INTO test_bulk(test_bulk_id, data)"
+                            " VALUES(3, zeroblob(3000))");
+    g_rc = sqldbal_blob_open(g_db, "test_bulk", "data", 3, 1, &blob);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_blob_size(blob, &size);
+    assert(size == sizeof(data));
+    for(i = 0; i < sizeof(data); i += sizeof(buf)){
+      g_rc = sqldbal_blob_write(blob, i, &data[i], sizeof(buf));
+      assert(g_rc == SQLDBAL_STATUS_OK);
+    }
+    g_rc = sqldbal_blob_read(blob, 1000, buf, sizeof(buf));
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(memcmp(buf, &data[1000], sizeof(buf)) == 0);
+
+    /* SQLite cannot grow the value. */
+    g_rc = sqldbal_blob_write(blob, 2500, data, sizeof(buf));
+    assert(g_rc == SQLDBAL_STATUS_PARAM);
+    g_rc = sqldbal_blob_close(blob);
+    assert(g_rc == SQLDBAL_STATUS_PARAM);
+    sqldbal_status_code_clear(g_db);
+    sqldbal_test_blob_column_read(3, data, sizeof(data));
+
+    /* Read past the end of a read-only handle. */
+    g_rc = sqldbal_blob_open(g_db, "test_bulk", "data", 3, 0, &blob);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_blob_read(blob, 2500, buf, sizeof(buf));
+    assert(g_rc == SQLDBAL_STATUS_PARAM);
+    g_rc = sqldbal_blob_close(blob);
+    assert(g_rc == SQLDBAL_STATUS_PARAM);
+    sqldbal_status_code_clear(g_db);
+  }
+  else if(driver == SQLDBAL_DRIVER_POSTGRESQL){
+    g_rc = sqldbal_begin_transaction(g_db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sprintf(g_sql,
+            "SELECT lo_from_bytea(0, data) FROM test_bulk"
+            " WHERE test_bulk_id = 1");
+    sqldbal_test_stmt_prepare_sql();
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &oid);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+    sqldbal_test_stmt_close_sql();
+
+    g_rc = sqldbal_blob_open(g_db, NULL, NULL, oid, 1, &blob);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_blob_size(blob, &size);
+    assert(size == sizeof(data));
+    g_rc = sqldbal_blob_read(blob, 2000, buf, sizeof(buf));
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(memcmp(buf, &data[2000], sizeof(buf)) == 0);
+
+    /* Large objects grow when writing past the end. */
+    g_rc = sqldbal_blob_write(blob, 2500, data, sizeof(buf));
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_blob_size(blob, &size);
+    assert(size == 3500);
+    g_rc = sqldbal_blob_read(blob, 2500, buf, sizeof(buf));
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(memcmp(buf, data, sizeof(buf)) == 0);
+    g_rc = sqldbal_blob_close(blob);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+
+    sprintf(g_sql, "SELECT lo_unlink(%lld)", (long long)oid);
+    sqldbal_test_exec_plain(g_sql);
+    g_rc = sqldbal_commit(g_db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+  else{
+    /* Close must still release the connection after the failed open. */
+    sqldbal_test_db_open_other(&db);
+    g_rc = sqldbal_blob_open(db, "test_bulk", "data", 1, 0, &blob);
+    assert(g_rc == SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+    g_rc = sqldbal_blob_close(blob);
+    assert(g_rc == SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+    g_rc = sqldbal_close(db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+}
+
+/**
+ * Fetch every row from the statement and verify the article_id column
+ * matches @ref g_article_list.
+ */
+static void
+sqldbal_test_stmt_fetch_article_id_list(void){
+  size_t i;
+  int64_t article_id;
+
+  for(i = 0; i < sizeof(g_article_list) / sizeof(g_article_list[0]); i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &article_id);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(article_id == g_article_list[i].article_id);
+  }
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+}
+
+/**
+ * Read results through a server-side cursor using
+ * @ref sqldbal_stmt_set_cursor.
+ */
+static void
+sqldbal_functional_test_cursor(void){
+  sprintf(g_sql, "SELECT article_id FROM article ORDER BY article_id");
+  sqldbal_test_stmt_prepare_sql();
+
+  /* The last batch has fewer rows than the prefetch count. */
+  g_rc = sqldbal_stmt_set_cursor(g_stmt, 2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_article_id_list();
+
+  /* The last batch has the same number of rows as the prefetch count. */
+  g_rc = sqldbal_stmt_set_cursor(g_stmt, 3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_article_id_list();
+
+  /* Run other statements while the cursor has unread rows. */
+  g_rc = sqldbal_stmt_set_cursor(g_stmt, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  sqldbal_functional_test_exec_select();
+
+  /* Execute again before reading every row. */
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_article_id_list();
+
+  /* Reset closes the cursor. */
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_reset(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* The PostgreSQL cursor stays open after the transaction commits. */
+  if(sqldbal_driver_type(g_db) == SQLDBAL_DRIVER_POSTGRESQL){
+    g_rc = sqldbal_begin_transaction(g_db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_commit(g_db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  }
+
+  /* Turn off the cursor. */
+  g_rc = sqldbal_stmt_set_cursor(g_stmt, 0);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_article_id_list();
+  sqldbal_test_stmt_close_sql();
+
+  /* Statements that do not return rows run without a cursor. */
+  sprintf(g_sql, "DELETE FROM article WHERE article_id = 0");
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_set_cursor(g_stmt, 10);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Measurements collected by @ref sqldbal_test_metrics_hook.
+ */
+struct sqldbal_test_metrics{
+  /**
+   * Number of reports for each @ref sqldbal_metrics_event.
+   */
+  size_t num_events[SQLDBAL_METRICS_FETCH + 1];
+
+  /**
+   * Last report for each @ref sqldbal_metrics_event.
+   */
+  struct sqldbal_metrics last[SQLDBAL_METRICS_FETCH + 1];
+};
+
+/**
+ * Record a report from the metrics hook.
+ *
+ * @param[in] user_data See @ref sqldbal_test_metrics.
+ * @param[in] metrics   See @ref sqldbal_metrics.
+ */
+static void
+sqldbal_test_metrics_hook(void *user_data,
+                          const struct sqldbal_metrics *const metrics){
+  struct sqldbal_test_metrics *test_metrics;
+
+  test_metrics = user_data;
+  test_metrics->num_events[metrics->event] += 1;
+  test_metrics->last[metrics->event] = *metrics;
+}
+
+/**
+ * Collect statement measurements using @ref sqldbal_metrics_hook.
+ */
+static void
+sqldbal_functional_test_metrics(void){
+  struct sqldbal_test_metrics test_metrics;
+  const char *text;
+  size_t num_articles;
+  size_t num_bytes;
+  size_t i;
+  size_t textsz;
+
+  num_articles = sizeof(g_article_list) / sizeof(g_article_list[0]);
+  memset(&test_metrics, 0, sizeof(test_metrics));
+  sqldbal_metrics_hook(g_db, sqldbal_test_metrics_hook, &test_metrics);
+
+  sqldbal_functional_test_exec_select();
+  assert(test_metrics.num_events[SQLDBAL_METRICS_EXEC] == 1);
+  assert(test_metrics.last[SQLDBAL_METRICS_EXEC].num_rows == num_articles);
+  assert(test_metrics.last[SQLDBAL_METRICS_EXEC].status ==
+         SQLDBAL_STATUS_OK);
+  assert(test_metrics.last[SQLDBAL_METRICS_EXEC].sql_hash != 0);
+
+  sprintf(g_sql, "SELECT title FROM article ORDER BY article_id");
+  sqldbal_test_stmt_prepare_sql();
+  assert(test_metrics.num_events[SQLDBAL_METRICS_PREPARE] == 1);
+  assert(test_metrics.last[SQLDBAL_METRICS_PREPARE].sql_len ==
+         strlen(g_sql));
+  assert(test_metrics.last[SQLDBAL_METRICS_PREPARE].sql_hash ==
+         sqldbal_stmt_cache_hash(g_sql, strlen(g_sql)));
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  assert(test_metrics.num_events[SQLDBAL_METRICS_EXECUTE] == 1);
+  num_bytes = 0;
+  for(i = 0; i < num_articles; i++){
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text, &textsz);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    num_bytes += textsz;
+  }
+  assert(test_metrics.num_events[SQLDBAL_METRICS_FETCH] == 0);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  assert(test_metrics.num_events[SQLDBAL_METRICS_FETCH] == 1);
+  assert(test_metrics.last[SQLDBAL_METRICS_FETCH].num_rows == num_articles);
+  assert(test_metrics.last[SQLDBAL_METRICS_FETCH].num_bytes == num_bytes);
+  assert(test_metrics.last[SQLDBAL_METRICS_FETCH].sql_hash ==
+         test_metrics.last[SQLDBAL_METRICS_PREPARE].sql_hash);
+
+  /* Closing before reading every row reports the fetch. */
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  sqldbal_test_stmt_close_sql();
+  assert(test_metrics.num_events[SQLDBAL_METRICS_FETCH] == 2);
+  assert(test_metrics.last[SQLDBAL_METRICS_FETCH].num_rows == 1);
+
+  /* Bound text counts toward the execute bytes. */
+  sprintf(g_sql, "SELECT article_id FROM article WHERE title = ?");
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_text(g_stmt, 0, "none", SIZE_MAX);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  assert(test_metrics.num_events[SQLDBAL_METRICS_EXECUTE] == 3);
+  assert(test_metrics.last[SQLDBAL_METRICS_EXECUTE].num_bytes == 4);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  assert(test_metrics.num_events[SQLDBAL_METRICS_FETCH] == 3);
+  assert(test_metrics.last[SQLDBAL_METRICS_FETCH].num_rows == 0);
+  sqldbal_test_stmt_close_sql();
+
+  /* Nothing gets reported after removing the hook. */
+  sqldbal_metrics_hook(g_db, NULL, NULL);
+  sqldbal_functional_test_exec_select();
+  assert(test_metrics.num_events[SQLDBAL_METRICS_EXEC] == 1);
+  assert(test_metrics.num_events[SQLDBAL_METRICS_PREPARE] == 2);
+}
+
+/**
+ * Test harness for @ref sqldbal_stmt_seek.
+ *
+ * @param[in] row           Row number to move to.
+ * @param[in] expect_status Expected status return code of the function under
+ *                          test.
+ */
+static void
+sqldbal_test_stmt_seek(uint64_t row,
+                       enum sqldbal_status_code expect_status){
+  g_rc = sqldbal_stmt_seek(g_stmt, row);
+  assert(g_rc == expect_status);
+  if(g_rc != SQLDBAL_STATUS_OK){
+    g_rc = sqldbal_status_code_clear(g_db);
+    assert(g_rc == expect_status);
+  }
+}
+
+/**
+ * Count and skip rows with @ref sqldbal_stmt_num_rows and
+ * @ref sqldbal_stmt_seek.
+ */
+static void
+sqldbal_functional_test_seek(void){
+  struct sqldbal_column_vector vector;
+  int64_t article_id;
+  int64_t id_list[2];
+  uint64_t num_rows;
+  size_t num_fetched;
+  enum sqldbal_fetch_result fetch_result;
+
+  sprintf(g_sql, "SELECT article_id FROM article ORDER BY article_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+
+  g_rc = sqldbal_stmt_num_rows(g_stmt, &num_rows);
+  if(sqldbal_driver_type(g_db) == SQLDBAL_DRIVER_SQLITE){
+    assert(g_rc == SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+    assert(num_rows == 0);
+    sqldbal_status_code_clear(g_db);
+  }
+  else{
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(num_rows == g_num_articles);
+  }
+
+  /* Skip ahead to the last row. */
+  sqldbal_test_stmt_seek(g_num_articles - 1, SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &article_id);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(article_id == g_article_list[g_num_articles - 1].article_id);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+
+  /* Go back to the start after reaching the end. */
+  sqldbal_test_stmt_seek(0, SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_article_id_list();
+
+  /* Seeking also resets the end of the result set in fetch_columns. */
+  memset(&vector, 0, sizeof(vector));
+  vector.type     = SQLDBAL_TYPE_INT;
+  vector.i64_list = id_list;
+  sqldbal_test_stmt_seek(g_num_articles - 1, SQLDBAL_STATUS_OK);
+  fetch_result = sqldbal_stmt_fetch_columns(g_stmt, 2, &vector, &num_fetched);
+  assert(fetch_result == SQLDBAL_FETCH_ROW);
+  assert(num_fetched == 1);
+  assert(id_list[0] == g_article_list[g_num_articles - 1].article_id);
+  sqldbal_test_stmt_seek(1, SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &article_id);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(article_id == g_article_list[1].article_id);
+
+  /* Seek to the end and past the end. */
+  sqldbal_test_stmt_seek(g_num_articles, SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  sqldbal_test_stmt_seek(g_num_articles + 1, SQLDBAL_STATUS_PARAM);
+
+  /* Streamed rows through a cursor do not support seeking. */
+  if(sqldbal_driver_type(g_db) != SQLDBAL_DRIVER_SQLITE){
+    g_rc = sqldbal_stmt_set_cursor(g_stmt, 1);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_num_rows(g_stmt, &num_rows);
+    assert(g_rc == SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+    sqldbal_status_code_clear(g_db);
+    sqldbal_test_stmt_seek(0, SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+    sqldbal_test_stmt_fetch_article_id_list();
+  }
+  sqldbal_test_stmt_close_sql();
+
+  /* Statements that do not return rows only have the end of the result. */
+  sprintf(g_sql, "DELETE FROM article WHERE article_id = 0");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_seek(0, SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_seek(1, SQLDBAL_STATUS_PARAM);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Close a connection right after an operation the driver does not support,
+ * without clearing the status first.
+ */
+static void
+sqldbal_functional_test_close_nosupport(void){
+  struct sqldbal_db *db;
+  struct sqldbal_stmt *stmt;
+  uint64_t num_rows;
+
+  sqldbal_test_db_open_other(&db);
+  g_rc = sqldbal_stmt_prepare(db,
+                              "SELECT article_id FROM article",
+                              SIZE_MAX,
+                              &stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  if(sqldbal_driver_type(db) != SQLDBAL_DRIVER_SQLITE){
+    g_rc = sqldbal_stmt_set_cursor(stmt, 1);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+  g_rc = sqldbal_stmt_execute(stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_num_rows(stmt, &num_rows);
+  assert(g_rc == SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+  g_rc = sqldbal_stmt_close(stmt);
+  assert(g_rc == SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+
+  /* The driver still has to close the connection and flush the caches. */
+  g_rc = sqldbal_close(db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Check that retrieving text and blob columns does not copy the values.
+ */
+static void
+sqldbal_functional_test_column_zero_copy(void){
+  const char *text1;
+  const char *text2;
+  const void *blob1;
+  const void *blob2;
+  size_t textsz1;
+  size_t textsz2;
+  size_t blobsz1;
+  size_t blobsz2;
+  size_t num_alloc;
+  size_t num_rows;
+
+  sprintf(g_sql,
+          "SELECT title, content FROM article ORDER BY article_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  num_rows = 0;
+  while(sqldbal_stmt_fetch(g_stmt) == SQLDBAL_FETCH_ROW){
+    g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text1, &textsz1);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_column_blob(g_stmt, 1, &blob1, &blobsz1);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+
+    /* The same row returns the same memory without allocating. */
+    num_alloc = g_sqldbal_test_num_alloc;
+    g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text2, &textsz2);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_column_blob(g_stmt, 1, &blob2, &blobsz2);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(g_sqldbal_test_num_alloc == num_alloc);
+    assert(text1 == text2);
+    assert(textsz1 == textsz2);
+    assert(blob1 == blob2);
+    assert(blobsz1 == blobsz2);
+    num_rows += 1;
+  }
+  assert(num_rows > 0);
+  sqldbal_test_stmt_close_sql();
+}
+
+/**
+ * Check the change in the result cache counters since the start of
+ * @ref sqldbal_functional_test_result_cache.
+ *
+ * @param[in] base_hits     Number of hits at the start of the test.
+ * @param[in] base_misses   Number of misses at the start of the test.
+ * @param[in] expect_hits   Expected number of new cache hits.
+ * @param[in] expect_misses Expected number of new cache misses.
+ * @return                  Number of bytes used by the cache.
+ */
+static size_t
+sqldbal_test_result_cache_stats(uint64_t base_hits,
+                                uint64_t base_misses,
+                                uint64_t expect_hits,
+                                uint64_t expect_misses){
+  uint64_t num_hits;
+  uint64_t num_misses;
+  size_t num_bytes;
+
+  sqldbal_result_cache_stats(g_db, &num_hits, &num_misses, &num_bytes);
+  assert(num_hits == base_hits + expect_hits);
+  assert(num_misses == base_misses + expect_misses);
+  return num_bytes;
+}
+
+/**
+ * Run the articles query from @ref sqldbal_functional_test_exec_select
+ * through @ref sqldbal_exec_cached.
+ *
+ * @param[in] sql SQL statement returning every article.
+ */
+static void
+sqldbal_test_result_cache_exec(const char *const sql){
+  struct sqldbal_test_exec_sel_data user_data;
+
+  user_data.row_i = 0;
+  g_rc = sqldbal_exec_cached(g_db,
+                             sql,
+                             sqldbal_test_exec_callback,
+                             &user_data);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(user_data.row_i == g_num_articles);
+}
+
+/**
+ * Execute @ref g_stmt with an article_id parameter and count the rows.
+ *
+ * @param[in] min_article_id Value bound to the only parameter.
+ * @return                   Number of rows fetched.
+ */
+static size_t
+sqldbal_test_result_cache_rows(int64_t min_article_id){
+  const char *title;
+  int64_t article_id;
+  size_t num_rows;
+
+  g_rc = sqldbal_stmt_reset(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, min_article_id);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  num_rows = 0;
+  while(sqldbal_stmt_fetch(g_stmt) == SQLDBAL_FETCH_ROW){
+    g_rc = sqldbal_stmt_column_int64(g_stmt, 0, &article_id);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_column_text(g_stmt, 1, &title, NULL);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    if(article_id <= (int64_t)g_num_articles){
+      assert(strcmp(title, g_article_list[article_id - 1].title) == 0);
+    }
+    num_rows += 1;
+  }
+  assert(sqldbal_status_code_get(g_db) == SQLDBAL_STATUS_OK);
+  return num_rows;
+}
+
+/**
+ * Return the rows of repeated queries from the client-side cache set with
+ * @ref sqldbal_result_cache_set.
+ */
+static void
+sqldbal_functional_test_result_cache(void){
+  struct sqldbal_test_metrics test_metrics;
+  const char *const sql =
+  "SELECT article_id AS article_id,"
+  "       author     AS author    ,"
+  "       title      AS title     ,"
+  "       view_count AS view_count,"
+  "       content    AS content    "
+  "  FROM article";
+  const char *const sql_other =
+  "SELECT article_id, author, title, view_count, content FROM article";
+  struct sqldbal_test_exec_sel_data user_data;
+  char text_list[2][2][16];
+  size_t textsz_list[2][2];
+  const char *text;
+  char title[8];
+  uint64_t base_hits;
+  uint64_t base_misses;
+  size_t num_bytes;
+  size_t num_rows;
+  size_t i;
+
+  sqldbal_result_cache_stats(g_db, &base_hits, &base_misses, &num_bytes);
+  assert(num_bytes == 0);
+  g_rc = sqldbal_result_cache_set(g_db, 1024 * 1024, -1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* The second query replays the rows through the callback. */
+  sqldbal_test_result_cache_exec(sql);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 0, 1);
+  sqldbal_test_result_cache_exec(sql);
+  num_bytes = sqldbal_test_result_cache_stats(base_hits, base_misses, 1, 1);
+  assert(num_bytes > 0);
+
+  /* Queries only use the cache when the application asks for it. */
+  user_data.row_i = 0;
+  g_rc = sqldbal_exec(g_db, sql, sqldbal_test_exec_callback, &user_data);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(user_data.row_i == g_num_articles);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 1, 1);
+  strcpy(g_sql, "DELETE FROM article WHERE article_id = 0");
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_set_result_cache(g_stmt, 1);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* Prepared statements get cached for each parameter value. */
+  memset(&test_metrics, 0, sizeof(test_metrics));
+  sqldbal_metrics_hook(g_db, sqldbal_test_metrics_hook, &test_metrics);
+  sqldbal_test_stmt_generate_placeholders();
+  sprintf(g_sql,
+          "SELECT article_id, title FROM article"
+          " WHERE article_id >= %s ORDER BY article_id",
+          g_q[0]);
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_set_result_cache(g_stmt, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_test_result_cache_rows(1) == g_num_articles);
+  assert(sqldbal_test_result_cache_rows(1) == g_num_articles);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 2, 2);
+  assert(test_metrics.num_events[SQLDBAL_METRICS_EXECUTE] == 1);
+  assert(sqldbal_test_result_cache_rows(2) == g_num_articles - 1);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 2, 3);
+  assert(test_metrics.num_events[SQLDBAL_METRICS_EXECUTE] == 2);
+  sqldbal_metrics_hook(g_db, NULL, NULL);
+
+  /* Cached rows support the same navigation as the driver rows. */
+  g_rc = sqldbal_stmt_reset(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_num_rows(g_stmt, &num_rows);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(num_rows == g_num_articles);
+  sqldbal_test_stmt_fetch_article_id_list();
+  sqldbal_test_stmt_seek(0, SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_article_id_list();
+  sqldbal_test_stmt_seek(g_num_articles + 1, SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_stmt_reset(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 3, 3);
+
+  /* Writes return stale rows until the application invalidates them. */
+  sqldbal_test_exec_plain("INSERT INTO article(article_id, title)"
+                          " VALUES(100, 'cached')");
+  assert(sqldbal_test_result_cache_rows(1) == g_num_articles);
+  g_rc = sqldbal_result_cache_invalidate(g_db, "article_tag");
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_test_result_cache_rows(1) == g_num_articles);
+  g_rc = sqldbal_result_cache_invalidate(g_db, "ARTICLE");
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_test_result_cache_stats(base_hits,
+                                         base_misses,
+                                         5,
+                                         3) == 0);
+  assert(sqldbal_test_result_cache_rows(1) == g_num_articles + 1);
+  sqldbal_test_exec_plain("DELETE FROM article WHERE article_id = 100");
+  g_rc = sqldbal_result_cache_invalidate(g_db, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_test_result_cache_rows(1) == g_num_articles);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 5, 5);
+
+  /* Transactions always read from the database. */
+  g_rc = sqldbal_begin_transaction(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_test_result_cache_rows(1) == g_num_articles);
+  sqldbal_test_result_cache_exec(sql);
+  g_rc = sqldbal_commit(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 5, 5);
+  sqldbal_test_stmt_close_sql();
+
+  /* Static binds become part of the key when the statement executes. */
+  sprintf(g_sql, "SELECT article_id FROM article WHERE title <> %s", g_q[0]);
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_set_result_cache(g_stmt, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  strcpy(title, "first");
+  g_rc = sqldbal_stmt_bind_text_static(g_stmt, 0, title, SIZE_MAX);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  num_rows = 0;
+  while(sqldbal_stmt_fetch(g_stmt) == SQLDBAL_FETCH_ROW){
+    num_rows += 1;
+  }
+  assert(num_rows == g_num_articles);
+  strcpy(title, "second");
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  num_rows = 0;
+  while(sqldbal_stmt_fetch(g_stmt) == SQLDBAL_FETCH_ROW){
+    num_rows += 1;
+  }
+  assert(num_rows == g_num_articles);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 6, 7);
+  sqldbal_test_stmt_close_sql();
+
+  /* Hits return the same text as the driver for values not bound here. */
+  sqldbal_test_exec_plain("INSERT INTO article(article_id, title)"
+                          " VALUES(100, 'literal')");
+  sprintf(g_sql,
+          "SELECT title, article_id FROM article WHERE article_id = %s",
+          g_q[0]);
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_set_result_cache(g_stmt, 1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  for(i = 0; i < 2; i++){
+    g_rc = sqldbal_stmt_reset(g_stmt);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_bind_int64(g_stmt, 0, 100);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+    g_rc = sqldbal_stmt_column_text(g_stmt, 0, &text, &textsz_list[i][0]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strlen(text) < sizeof(text_list[i][0]));
+    strcpy(text_list[i][0], text);
+    g_rc = sqldbal_stmt_column_text(g_stmt, 1, &text, &textsz_list[i][1]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert(strlen(text) < sizeof(text_list[i][1]));
+    strcpy(text_list[i][1], text);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_DONE);
+  }
+  assert(strcmp(text_list[0][0], "literal") == 0);
+  assert(strcmp(text_list[1][0], text_list[0][0]) == 0);
+  assert(textsz_list[1][0] == textsz_list[0][0]);
+  assert(strcmp(text_list[0][1], "100") == 0);
+  assert(strcmp(text_list[1][1], text_list[0][1]) == 0);
+  assert(textsz_list[1][1] == textsz_list[0][1]);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 7, 8);
+  sqldbal_test_stmt_close_sql();
+  sqldbal_test_exec_plain("DELETE FROM article WHERE article_id = 100");
+  g_rc = sqldbal_result_cache_invalidate(g_db, "article");
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* The least recently used result makes room for a new result. */
+  g_rc = sqldbal_result_cache_set(g_db, num_bytes + num_bytes / 2, -1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_result_cache_exec(sql);
+  sqldbal_test_result_cache_exec(sql_other);
+  sqldbal_test_result_cache_exec(sql_other);
+  sqldbal_test_result_cache_exec(sql);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 8, 11);
+
+  /* Results larger than the cache do not get cached. */
+  g_rc = sqldbal_result_cache_set(g_db, 64, -1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_result_cache_exec(sql);
+  sqldbal_test_result_cache_exec(sql);
+  assert(sqldbal_test_result_cache_stats(base_hits,
+                                         base_misses,
+                                         8,
+                                         13) == 0);
+
+  /* Results expire immediately with a TTL of 0. */
+  g_rc = sqldbal_result_cache_set(g_db, 1024 * 1024, 0);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_result_cache_exec(sql);
+  sqldbal_test_result_cache_exec(sql);
+  sqldbal_test_result_cache_stats(base_hits, base_misses, 8, 15);
+
+  /* Disabling the cache frees every result. */
+  g_rc = sqldbal_result_cache_set(g_db, 0, -1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_result_cache_exec(sql);
+  assert(sqldbal_test_result_cache_stats(base_hits,
+                                         base_misses,
+                                         8,
+                                         15) == 0);
+}
+
+/**
+ * Prepare a statement through the primary connection in @ref g_db and
+ * check whether the replica compiled it.
+ *
+ * @param[in] sql            SQL statement.
+ * @param[in] test_metrics   Metrics collected from the replica.
+ * @param[in] expect_replica Set to 1 if the statement should run on the
+ *                           replica.
+ */
+static void
+sqldbal_test_replica_route(const char *const sql,
+                           struct sqldbal_test_metrics *const test_metrics,
+                           int expect_replica){
+  size_t num_prepare;
+
+  num_prepare = test_metrics->num_events[SQLDBAL_METRICS_PREPARE];
+  strcpy(g_sql, sql);
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_reset(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_close_sql();
+  assert(test_metrics->num_events[SQLDBAL_METRICS_PREPARE] ==
+         num_prepare + (size_t)expect_replica);
+}
+
+/**
+ * Route read-only statements to a replica with @ref sqldbal_replica_add.
+ *
+ * The replica is a second connection to the same test database.
+ */
+static void
+sqldbal_functional_test_replica(void){
+  struct sqldbal_test_metrics test_metrics;
+  struct sqldbal_test_db_config *config;
+  struct sqldbal_db *db_saved;
+  struct sqldbal_db *primary;
+  struct sqldbal_db *replica;
+  enum sqldbal_driver driver;
+  size_t i;
+
+  driver = sqldbal_driver_type(g_db);
+  if(driver == SQLDBAL_DRIVER_MYSQL){
+    driver = SQLDBAL_DRIVER_MARIADB;
+  }
+  config = NULL;
+  for(i = 0; i < g_db_num; i++){
+    if(g_db_config_list[i].driver == driver){
+      config = &g_db_config_list[i];
+    }
+  }
+  assert(config);
+
+  g_rc = sqldbal_open(config->driver,
+                      config->location,
+                      config->port,
+                      config->username,
+                      config->password,
+                      config->database,
+                      config->flags,
+                      NULL,
+                      0,
+                      &primary);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_open(config->driver,
+                      config->location,
+                      config->port,
+                      config->username,
+                      config->password,
+                      config->database,
+                      config->flags,
+                      NULL,
+                      0,
+                      &replica);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  memset(&test_metrics, 0, sizeof(test_metrics));
+  sqldbal_metrics_hook(replica, sqldbal_test_metrics_hook, &test_metrics);
+
+  /* A connection can not replicate itself. */
+  g_rc = sqldbal_replica_add(primary, primary);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(primary);
+
+  g_rc = sqldbal_replica_add(primary, replica);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* A replica belongs to a single primary connection. */
+  g_rc = sqldbal_replica_add(primary, replica);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(primary);
+  g_rc = sqldbal_replica_add(replica, primary);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(replica);
+
+  db_saved = g_db;
+  g_db = primary;
+
+  /* Reads go to the replica and the statements return the same rows. */
+  strcpy(g_sql, "SELECT article_id FROM article ORDER BY article_id");
+  sqldbal_test_stmt_prepare_sql();
+  assert(test_metrics.num_events[SQLDBAL_METRICS_PREPARE] == 1);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch_article_id_list();
+  sqldbal_test_stmt_close_sql();
+  sqldbal_test_replica_route("\n  select article_id FROM article",
+                             &test_metrics,
+                             1);
+
+  /* Writes stay on the primary. */
+  sqldbal_test_replica_route("DELETE FROM article WHERE article_id = 0",
+                             &test_metrics,
+                             0);
+
+  /* Transactions stay on the primary. */
+  g_rc = sqldbal_begin_transaction(primary);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             0);
+  g_rc = sqldbal_commit(primary);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             1);
+  g_rc = sqldbal_exec(primary, "BEGIN", NULL, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             0);
+  g_rc = sqldbal_exec(primary, "ROLLBACK", NULL, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             1);
+
+  /* Errors in the statement do not eject a replica that still responds. */
+  g_rc = sqldbal_stmt_prepare(primary,
+                              "SELECT no_such_column FROM article",
+                              SIZE_MAX,
+                              &g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_PREPARE);
+  sqldbal_stmt_close(g_stmt);
+  sqldbal_status_code_clear(primary);
+  assert(sqldbal_status_code_get(replica) == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             1);
+
+  /* Ejected replicas get skipped. */
+  g_rc = sqldbal_replica_eject(primary, replica, 60000);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             0);
+  g_rc = sqldbal_replica_eject(primary, replica, 0);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             1);
+  g_rc = sqldbal_replica_eject(primary, primary, 0);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(primary);
+
+  /* Replicas that lag too far behind get skipped. */
+  g_rc = sqldbal_replica_check_lag(primary, "SELECT 5", 10, 60000);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             1);
+  g_rc = sqldbal_replica_check_lag(primary, "SELECT 50", 10, 60000);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             0);
+
+  /* A failed query ejects the replica for the given period. */
+  g_rc = sqldbal_replica_eject(primary, replica, 0);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_replica_check_lag(primary, "SELEC", 10, 60000);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_status_code_get(replica) == SQLDBAL_STATUS_OK);
+  sqldbal_test_replica_route("SELECT article_id FROM article",
+                             &test_metrics,
+                             0);
+
+  /* Closing the primary connection also closes the replica. */
+  g_db = db_saved;
+  g_rc = sqldbal_close(primary);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Entries collected by @ref sqldbal_test_trace_callback.
+ */
+struct sqldbal_test_trace{
+  /**
+   * Number of entries received.
+   */
+  size_t num_entries;
+
+  /**
+   * Number of entries received with the slow flag set.
+   */
+  size_t num_slow;
+
+  /**
+   * Last entry received.
+   */
+  struct sqldbal_trace_entry last;
+};
+
+/**
+ * Record an entry drained from the @ref sqldbal_trace.
+ *
+ * @param[in] user_data See @ref sqldbal_test_trace.
+ * @param[in] entry     See @ref sqldbal_trace_entry.
+ */
+static void
+sqldbal_test_trace_callback(void *user_data,
+                            const struct sqldbal_trace_entry *const entry){
+  struct sqldbal_test_trace *test_trace;
+
+  test_trace = user_data;
+  test_trace->num_entries += 1;
+  if(entry->slow){
+    test_trace->num_slow += 1;
+  }
+  test_trace->last = *entry;
+}
+
+/**
+ * Record statements into a @ref sqldbal_trace and drain them.
+ */
+static void
+sqldbal_functional_test_trace(void){
+  struct sqldbal_test_trace test_trace;
+  struct sqldbal_trace *trace;
+  uint64_t num_recorded;
+  uint64_t num_dropped;
+  size_t num_drained;
+  size_t i;
+
+  /* Invalid parameters. */
+  g_rc = sqldbal_trace_open(8,
+                            0,
+                            0,
+                            NULL,
+                            NULL,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  assert(trace == NULL);
+  g_rc = sqldbal_trace_open(0,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            NULL,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_trace_open(SIZE_MAX,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            NULL,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_trace_open(8,
+                            0,
+                            2,
+                            sqldbal_test_trace_callback,
+                            NULL,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_trace_open(8,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            NULL,
+                            0,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+
+  /* Every statement counts as slow with a zero threshold. */
+  memset(&test_trace, 0, sizeof(test_trace));
+  g_rc = sqldbal_trace_open(64,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            &test_trace,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_trace_attach(g_db, trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  sqldbal_functional_test_exec_select();
+  num_drained = sqldbal_trace_drain(trace);
+  assert(num_drained >= 1);
+  assert(test_trace.num_entries == num_drained);
+  assert(test_trace.num_slow == num_drained);
+  assert(test_trace.last.event == SQLDBAL_METRICS_EXECUTE ||
+         test_trace.last.event == SQLDBAL_METRICS_EXEC);
+  assert(test_trace.last.driver == sqldbal_driver_type(g_db));
+  assert(test_trace.last.status == SQLDBAL_STATUS_OK);
+  assert(test_trace.last.sql_len == strlen(test_trace.last.sql));
+  assert(test_trace.last.sql_hash ==
+         sqldbal_stmt_cache_hash(test_trace.last.sql,
+                                 test_trace.last.sql_len));
+  assert(sqldbal_trace_drain(trace) == 0);
+
+  sprintf(g_sql, "SELECT title FROM article ORDER BY article_id");
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+  sqldbal_test_stmt_close_sql();
+  num_drained = sqldbal_trace_drain(trace);
+  assert(num_drained >= 1);
+  assert(strcmp(test_trace.last.sql, g_sql) == 0);
+  assert(test_trace.last.event == SQLDBAL_METRICS_EXECUTE);
+
+  /* Nothing gets recorded after detaching. */
+  g_rc = sqldbal_trace_attach(g_db, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_functional_test_exec_select();
+  assert(sqldbal_trace_drain(trace) == 0);
+  sqldbal_trace_stats(trace, &num_recorded, &num_dropped);
+  assert(num_recorded == test_trace.num_entries);
+  assert(num_dropped == 0);
+  sqldbal_trace_close(trace);
+
+  /* Fast statements never get sampled with a zero sample rate. */
+  memset(&test_trace, 0, sizeof(test_trace));
+  g_rc = sqldbal_trace_open(64,
+                            UINT64_MAX,
+                            0,
+                            sqldbal_test_trace_callback,
+                            &test_trace,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_trace_attach(g_db, trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_functional_test_exec_select();
+  assert(sqldbal_trace_drain(trace) == 0);
+  g_rc = sqldbal_trace_attach(g_db, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_trace_close(trace);
+
+  /* Entries get dropped when the ring buffer fills up. */
+  memset(&test_trace, 0, sizeof(test_trace));
+  g_rc = sqldbal_trace_open(2,
+                            UINT64_MAX,
+                            1,
+                            sqldbal_test_trace_callback,
+                            &test_trace,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_trace_attach(g_db, trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  for(i = 0; i < 4; i++){
+    sqldbal_functional_test_exec_select();
+  }
+  assert(sqldbal_trace_drain(trace) == 2);
+  assert(test_trace.num_slow == 0);
+  sqldbal_trace_stats(trace, &num_recorded, &num_dropped);
+  assert(num_recorded == 2);
+  assert(num_dropped >= 2);
+  g_rc = sqldbal_trace_attach(g_db, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_trace_close(trace);
+
+  /* The background thread drains the rest when closing. */
+  memset(&test_trace, 0, sizeof(test_trace));
+  g_rc = sqldbal_trace_open(64,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            &test_trace,
+                            10,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_trace_attach(g_db, trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_functional_test_exec_select();
+  g_rc = sqldbal_trace_attach(g_db, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_trace_close(trace);
+  assert(test_trace.num_entries >= 1);
+}
+
+/**
+ * Open connections with @ref SQLDBAL_FLAG_LAZY_CONNECT and
+ * @ref sqldbal_open_parallel.
+ */
+static void
+sqldbal_functional_test_lazy_connect(void){
+  struct sqldbal_test_db_config *config;
+  struct sqldbal_db *db_list[3];
+  struct sqldbal_db *db;
+  enum sqldbal_driver driver;
+  size_t i;
+
+  driver = sqldbal_driver_type(g_db);
+  if(driver == SQLDBAL_DRIVER_MYSQL){
+    driver = SQLDBAL_DRIVER_MARIADB;
+  }
+  config = NULL;
+  for(i = 0; i < g_db_num; i++){
+    if(g_db_config_list[i].driver == driver){
+      config = &g_db_config_list[i];
+    }
+  }
+  assert(config);
+
+  /* The first statement opens the connection. */
+  g_rc = sqldbal_open(config->driver,
+                      config->location,
+                      config->port,
+                      config->username,
+                      config->password,
+                      config->database,
+                      config->flags | SQLDBAL_FLAG_LAZY_CONNECT,
+                      NULL,
+                      0,
+                      &db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_db_handle(db) == NULL);
+  g_rc = sqldbal_exec(db, "SELECT article_id FROM article", NULL, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_db_handle(db));
+  g_rc = sqldbal_connect(db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_close(db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* Connect explicitly. */
+  g_rc = sqldbal_open(config->driver,
+                      config->location,
+                      config->port,
+                      config->username,
+                      config->password,
+                      config->database,
+                      config->flags | SQLDBAL_FLAG_LAZY_CONNECT,
+                      NULL,
+                      0,
+                      &db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_connect(db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_db_handle(db));
+  g_rc = sqldbal_close(db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* Close without ever connecting. */
+  g_rc = sqldbal_open(config->driver,
+                      config->location,
+                      config->port,
+                      config->username,
+                      config->password,
+                      config->database,
+                      config->flags | SQLDBAL_FLAG_LAZY_CONNECT,
+                      NULL,
+                      0,
+                      &db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_close(db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* Open several connections at the same time. */
+  g_rc = sqldbal_open_parallel(config->driver,
+                               config->location,
+                               config->port,
+                               config->username,
+                               config->password,
+                               config->database,
+                               config->flags,
+                               NULL,
+                               0,
+                               3,
+                               db_list);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  for(i = 0; i < 3; i++){
+    assert(sqldbal_db_handle(db_list[i]));
+    g_rc = sqldbal_ping(db_list[i]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_close(db_list[i]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+
+  /* Lazy connections in parallel only save the parameters. */
+  g_rc = sqldbal_open_parallel(config->driver,
+                               config->location,
+                               config->port,
+                               config->username,
+                               config->password,
+                               config->database,
+                               config->flags | SQLDBAL_FLAG_LAZY_CONNECT,
+                               NULL,
+                               0,
+                               3,
+                               db_list);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  for(i = 0; i < 3; i++){
+    assert(sqldbal_db_handle(db_list[i]) == NULL);
+    g_rc = sqldbal_ping(db_list[i]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_close(db_list[i]);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+  }
+}
+
+/**
  * Run various tests for a single database driver.
  */
 static void
@@ -1763,7 +4876,26 @@ sqldbal_functional_test_db(void){
   sqldbal_functional_test_stmt_explicit_sql_len();
   sqldbal_functional_test_null();
   sqldbal_functional_test_float();
+  sqldbal_functional_test_typed();
+  sqldbal_functional_test_fetch_columns();
   sqldbal_functional_test_blank_string();
+  sqldbal_functional_test_execute_batch();
+  sqldbal_functional_test_large_column();
+  sqldbal_functional_test_bind_static();
+  sqldbal_functional_test_stmt_cache();
+  sqldbal_functional_test_pipeline();
+  sqldbal_functional_test_bulk();
+  sqldbal_functional_test_bulk_insert();
+  sqldbal_functional_test_blob_stream();
+  sqldbal_functional_test_cursor();
+  sqldbal_functional_test_seek();
+  sqldbal_functional_test_close_nosupport();
+  sqldbal_functional_test_metrics();
+  sqldbal_functional_test_column_zero_copy();
+  sqldbal_functional_test_result_cache();
+  sqldbal_functional_test_replica();
+  sqldbal_functional_test_trace();
+  sqldbal_functional_test_lazy_connect();
 
   if(driver != SQLDBAL_DRIVER_SQLITE){
     sqldbal_test_exec_plain("DROP DATABASE test_db");
@@ -1942,46 +5074,612 @@ sqldbal_functional_test_timeout(void){
                     option_list,
                     SQLDBAL_STATUS_OK);
 
-  sqldbal_test_open(SQLDBAL_DRIVER_POSTGRESQL,
-                    g_db_config_list[1].location,
-                    g_db_config_list[1].port,
-                    g_db_config_list[1].username,
-                    g_db_config_list[1].password,
-                    g_db_config_list[1].database,
-                    g_db_config_list[1].flags,
-                    num_option_list,
-                    option_list,
-                    SQLDBAL_STATUS_OK);
+  sqldbal_test_open(SQLDBAL_DRIVER_POSTGRESQL,
+                    g_db_config_list[1].location,
+                    g_db_config_list[1].port,
+                    g_db_config_list[1].username,
+                    g_db_config_list[1].password,
+                    g_db_config_list[1].database,
+                    g_db_config_list[1].flags,
+                    num_option_list,
+                    option_list,
+                    SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Test enabling debug and trace mode.
+ */
+static void
+sqldbal_functional_test_debug(void){
+  size_t i;
+  struct sqldbal_test_db_config *config;
+
+  for(i = 0; i < g_db_num; i++){
+    config = &g_db_config_list[i];
+    g_rc = sqldbal_open(config->driver,
+                        config->location,
+                        config->port,
+                        config->username,
+                        config->password,
+                        config->database,
+                        config->flags | SQLDBAL_FLAG_DEBUG,
+                        NULL,
+                        0,
+                        &g_db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+
+    sqldbal_functional_test_exec_select();
+
+    sqldbal_test_db_close();
+  }
+}
+
+/**
+ * Test streaming results one row at a time.
+ *
+ * Runs the same tests in @ref sqldbal_functional_test_db and also checks
+ * discarding a partially fetched result.
+ */
+static void
+sqldbal_functional_test_stream_results(void){
+  size_t i;
+  struct sqldbal_test_db_config *config;
+
+  for(i = 0; i < g_db_num; i++){
+    config = &g_db_config_list[i];
+    g_rc = sqldbal_open(config->driver,
+                        config->location,
+                        config->port,
+                        config->username,
+                        config->password,
+                        config->database,
+                        config->flags | SQLDBAL_FLAG_STREAM_RESULTS,
+                        NULL,
+                        0,
+                        &g_db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+
+    sqldbal_functional_test_db();
+
+    sqldbal_test_stmt_generate_select_article();
+    sqldbal_test_stmt_prepare_sql();
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+
+    /* Execute again before reading every row. */
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
+
+    /* Close before reading every row. */
+    sqldbal_test_stmt_close_sql();
+    sqldbal_functional_test_exec_select();
+
+    sqldbal_test_db_close();
+  }
+}
+
+/**
+ * Run a statement through @ref sqldbal_stmt_execute_start and
+ * @ref sqldbal_stmt_execute_poll until it no longer needs to wait on the
+ * socket, and then call @ref sqldbal_stmt_execute_finish.
+ *
+ * @param[in] expect_status Expected status return code of
+ *                          @ref sqldbal_stmt_execute_finish.
+ */
+static void
+sqldbal_test_stmt_execute_async(enum sqldbal_status_code expect_status){
+  int wait_events;
+
+  g_rc = sqldbal_stmt_execute_start(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  do{
+    g_rc = sqldbal_stmt_execute_poll(g_stmt, &wait_events);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    assert((wait_events & ~(SQLDBAL_WAIT_READ | SQLDBAL_WAIT_WRITE)) == 0);
+  } while(wait_events);
+  g_rc = sqldbal_stmt_execute_finish(g_stmt);
+  assert(g_rc == expect_status);
+}
+
+/**
+ * Test the non-blocking statement interface.
+ *
+ * Runs the same tests in @ref sqldbal_functional_test_db with the
+ * non-blocking MariaDB client enabled and then executes statements using
+ * @ref sqldbal_stmt_execute_start.
+ */
+static void
+sqldbal_functional_test_async(void){
+  size_t i;
+  struct sqldbal_test_db_config *config;
+  int wait_events;
+  int fd;
+
+  for(i = 0; i < g_db_num; i++){
+    config = &g_db_config_list[i];
+    g_rc = sqldbal_open(config->driver,
+                        config->location,
+                        config->port,
+                        config->username,
+                        config->password,
+                        config->database,
+                        config->flags | SQLDBAL_FLAG_MARIADB_NONBLOCK,
+                        NULL,
+                        0,
+                        &g_db);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+
+    sqldbal_functional_test_db();
+
+    g_rc = sqldbal_db_socket_fd(g_db, &fd);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    if(config->driver == SQLDBAL_DRIVER_SQLITE){
+      assert(fd == -1);
+    }
+    else{
+      assert(fd >= 0);
+    }
+
+    sprintf(g_sql, "SELECT article_id FROM article ORDER BY article_id");
+    sqldbal_test_stmt_prepare_sql();
+
+    /* Poll and finish without starting a statement. */
+    g_rc = sqldbal_stmt_execute_poll(g_stmt, &wait_events);
+    assert(g_rc == SQLDBAL_STATUS_PARAM);
+    assert(wait_events == 0);
+    sqldbal_status_code_clear(g_db);
+    g_rc = sqldbal_stmt_execute_finish(g_stmt);
+    assert(g_rc == SQLDBAL_STATUS_PARAM);
+    sqldbal_status_code_clear(g_db);
+
+    sqldbal_test_stmt_execute_async(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch_article_id_list();
+
+    /* Finish blocks until the result arrives. */
+    g_rc = sqldbal_stmt_execute_start(g_stmt);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    g_rc = sqldbal_stmt_execute_start(g_stmt);
+    assert(g_rc == SQLDBAL_STATUS_PARAM);
+    sqldbal_status_code_clear(g_db);
+    g_rc = sqldbal_stmt_execute_finish(g_stmt);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch_article_id_list();
+
+    /* Mix with the blocking interface. */
+    sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_fetch_article_id_list();
+
+    /* Close while the statement is still running. */
+    g_rc = sqldbal_stmt_execute_start(g_stmt);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    sqldbal_test_stmt_close_sql();
+    sqldbal_functional_test_exec_select();
+
+    sqldbal_test_db_close();
+  }
 }
 
 /**
- * Test enabling debug and trace mode.
+ * Run the same tests in @ref sqldbal_functional_test_db with the prepared
+ * statement cache enabled.
  */
 static void
-sqldbal_functional_test_debug(void){
+sqldbal_functional_test_stmt_cache_db_list(void){
   size_t i;
   struct sqldbal_test_db_config *config;
+  uint64_t num_hits;
+  uint64_t num_misses;
+  size_t num_stmts;
 
   for(i = 0; i < g_db_num; i++){
     config = &g_db_config_list[i];
+    sqldbal_test_db_open(config->driver);
+    g_rc = sqldbal_stmt_cache_set_capacity(g_db, 16);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+
+    sqldbal_functional_test_db();
+    sqldbal_stmt_cache_stats(g_db, &num_hits, &num_misses, &num_stmts);
+    assert(num_hits > 0);
+
+    /* Closing the database also closes the cached statements. */
+    g_rc = sqldbal_stmt_cache_set_capacity(g_db, 16);
+    assert(g_rc == SQLDBAL_STATUS_OK);
+    strcpy(g_sql, "SELECT 1");
+    sqldbal_test_stmt_prepare_sql();
+    sqldbal_test_stmt_close_sql();
+    sqldbal_stmt_cache_stats(g_db, &num_hits, &num_misses, &num_stmts);
+    assert(num_stmts == 1);
+    sqldbal_test_db_close();
+  }
+}
+
+/**
+ * Run the functional tests with the PostgreSQL binary wire format, with and
+ * without streaming the results.
+ */
+static void
+sqldbal_functional_test_pq_binary(void){
+  struct sqldbal_test_db_config *config;
+  const unsigned long flag_list[] = {
+    SQLDBAL_FLAG_PQ_BINARY,
+    SQLDBAL_FLAG_PQ_BINARY | SQLDBAL_FLAG_STREAM_RESULTS
+  };
+  size_t i;
+
+  config = &g_db_config_list[
+             sqldbal_test_get_driver_config_i(SQLDBAL_DRIVER_POSTGRESQL)];
+  for(i = 0; i < sizeof(flag_list) / sizeof(flag_list[0]); i++){
     g_rc = sqldbal_open(config->driver,
                         config->location,
                         config->port,
                         config->username,
                         config->password,
                         config->database,
-                        config->flags | SQLDBAL_FLAG_DEBUG,
+                        config->flags | flag_list[i],
                         NULL,
                         0,
                         &g_db);
     assert(g_rc == SQLDBAL_STATUS_OK);
 
-    sqldbal_functional_test_exec_select();
+    sqldbal_functional_test_db();
 
     sqldbal_test_db_close();
   }
 }
 
+/**
+ * Test harness for @ref sqldbal_pool_open using the connection settings in
+ * @ref g_db_config_list.
+ *
+ * @param[in]  driver          See @ref sqldbal_driver.
+ * @param[in]  min_size        See @ref sqldbal_pool_open.
+ * @param[in]  max_size        See @ref sqldbal_pool_open.
+ * @param[in]  idle_timeout_ms See @ref sqldbal_pool_open.
+ * @param[in]  expect_status   Expected status return code of
+ *                             @ref sqldbal_pool_open.
+ * @param[out] pool            See @ref sqldbal_pool_open.
+ */
+static void
+sqldbal_test_pool_open(enum sqldbal_driver driver,
+                       size_t min_size,
+                       size_t max_size,
+                       long idle_timeout_ms,
+                       enum sqldbal_status_code expect_status,
+                       struct sqldbal_pool **pool){
+  struct sqldbal_test_db_config *config;
+  const struct sqldbal_driver_option *option;
+  const struct sqldbal_driver_option timeout_option = {
+    "CONNECT_TIMEOUT", "100"
+  };
+  const struct sqldbal_driver_option vfs_option = {
+    "VFS", NULL
+  };
+
+  if(driver == SQLDBAL_DRIVER_SQLITE){
+    option = &vfs_option;
+  }
+  else{
+    option = &timeout_option;
+  }
+  config = &g_db_config_list[sqldbal_test_get_driver_config_i(driver)];
+  g_rc = sqldbal_pool_open(driver,
+                           config->location,
+                           config->port,
+                           config->username,
+                           config->password,
+                           config->database,
+                           config->flags,
+                           option,
+                           1,
+                           min_size,
+                           max_size,
+                           idle_timeout_ms,
+                           pool);
+  assert(g_rc == expect_status);
+  if(g_rc != SQLDBAL_STATUS_OK){
+    assert(*pool == NULL);
+  }
+}
+
+/**
+ * Check the number of connections tracked by a pool.
+ *
+ * @param[in] pool        See @ref sqldbal_pool.
+ * @param[in] expect_open Expected number of open connections.
+ * @param[in] expect_idle Expected number of idle connections.
+ */
+static void
+sqldbal_test_pool_stats(struct sqldbal_pool *const pool,
+                        size_t expect_open,
+                        size_t expect_idle){
+  size_t num_open;
+  size_t num_idle;
+
+  sqldbal_pool_stats(pool, &num_open, &num_idle);
+  assert(num_open == expect_open);
+  assert(num_idle == expect_idle);
+}
+
+/**
+ * Thread entry point that repeatedly acquires a connection, runs a query,
+ * and releases the connection.
+ *
+ * @param[in] arg See @ref sqldbal_pool.
+ * @return        NULL.
+ */
+static void *
+sqldbal_test_pool_thread(void *arg){
+  struct sqldbal_pool *pool;
+  struct sqldbal_db *db;
+  enum sqldbal_status_code rc;
+  size_t num_open;
+  size_t num_idle;
+  size_t i;
+
+  pool = arg;
+  for(i = 0; i < 50; i++){
+    rc = sqldbal_pool_acquire(pool, -1, &db);
+    assert(rc == SQLDBAL_STATUS_OK);
+    rc = sqldbal_exec(db, "SELECT 1", NULL, NULL);
+    assert(rc == SQLDBAL_STATUS_OK);
+    sqldbal_pool_stats(pool, &num_open, &num_idle);
+    assert(num_open <= 2);
+    rc = sqldbal_pool_release(pool, db);
+    assert(rc == SQLDBAL_STATUS_OK);
+  }
+  return NULL;
+}
+
+/**
+ * Share a connection pool smaller than the number of threads.
+ */
+static void
+sqldbal_functional_test_pool_threads(void){
+  struct sqldbal_pool *pool;
+  pthread_t thread_list[SQLDBAL_TEST_POOL_NUM_THREADS];
+  size_t i;
+  size_t num_open;
+  size_t num_idle;
+  int rc;
+
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         0,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_OK,
+                         &pool);
+  for(i = 0; i < SQLDBAL_TEST_POOL_NUM_THREADS; i++){
+    rc = pthread_create(&thread_list[i],
+                        NULL,
+                        sqldbal_test_pool_thread,
+                        pool);
+    assert(rc == 0);
+  }
+  for(i = 0; i < SQLDBAL_TEST_POOL_NUM_THREADS; i++){
+    rc = pthread_join(thread_list[i], NULL);
+    assert(rc == 0);
+  }
+
+  /* The threads may finish before they ever contend for a connection. */
+  sqldbal_pool_stats(pool, &num_open, &num_idle);
+  assert(num_open >= 1 && num_open <= 2);
+  assert(num_idle == num_open);
+  g_rc = sqldbal_pool_close(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Thread entry point that gets a thread connection twice and exits
+ * without releasing it.
+ *
+ * @param[in] arg See @ref sqldbal_pool.
+ * @return        NULL.
+ */
+static void *
+sqldbal_test_pool_thread_db_exit(void *arg){
+  struct sqldbal_pool *pool;
+  struct sqldbal_db *db1;
+  struct sqldbal_db *db2;
+  enum sqldbal_status_code rc;
+
+  pool = arg;
+  rc = sqldbal_pool_thread_db(pool, -1, &db1);
+  assert(rc == SQLDBAL_STATUS_OK);
+  rc = sqldbal_pool_thread_db(pool, -1, &db2);
+  assert(rc == SQLDBAL_STATUS_OK);
+  assert(db1 == db2);
+  rc = sqldbal_exec(db1, "SELECT 1", NULL, NULL);
+  assert(rc == SQLDBAL_STATUS_OK);
+  return NULL;
+}
+
+/**
+ * Test assigning pool connections to threads.
+ */
+static void
+sqldbal_functional_test_pool_thread_db(void){
+  struct sqldbal_pool *pool;
+  struct sqldbal_db *db1;
+  struct sqldbal_db *db2;
+  pthread_t thread;
+  int rc;
+
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_OK,
+                         &pool);
+
+  /* Nothing assigned to this thread yet. */
+  g_rc = sqldbal_pool_thread_release(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* The same connection comes back until the thread releases it. */
+  g_rc = sqldbal_pool_thread_db(pool, 0, &db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_pool_stats(pool, 1, 0);
+  g_rc = sqldbal_pool_thread_db(pool, 0, &db2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(db1 == db2);
+  sqldbal_test_pool_stats(pool, 1, 0);
+  g_rc = sqldbal_pool_thread_release(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_pool_stats(pool, 1, 1);
+  g_rc = sqldbal_pool_thread_release(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* Failed to allocate the thread assignment. */
+  g_sqldbal_err_malloc_ctr = 0;
+  g_rc = sqldbal_pool_thread_db(pool, 0, &db1);
+  g_sqldbal_err_malloc_ctr = -1;
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  assert(db1 == NULL);
+  sqldbal_test_pool_stats(pool, 1, 1);
+
+  /* Thread exits without releasing the connection. */
+  rc = pthread_create(&thread, NULL, sqldbal_test_pool_thread_db_exit, pool);
+  assert(rc == 0);
+  rc = pthread_join(thread, NULL);
+  assert(rc == 0);
+  sqldbal_test_pool_stats(pool, 1, 1);
+
+  g_rc = sqldbal_pool_close(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Test acquiring, releasing, and evicting connections in a pool.
+ */
+static void
+sqldbal_functional_test_pool(void){
+  struct sqldbal_pool *pool;
+  struct sqldbal_db *db1;
+  struct sqldbal_db *db2;
+  struct sqldbal_db *db3;
+
+  /* Invalid pool sizes. */
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         0,
+                         0,
+                         -1,
+                         SQLDBAL_STATUS_PARAM,
+                         &pool);
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         2,
+                         1,
+                         -1,
+                         SQLDBAL_STATUS_PARAM,
+                         &pool);
+
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_OK,
+                         &pool);
+  sqldbal_test_pool_stats(pool, 1, 1);
+
+  g_rc = sqldbal_pool_acquire(pool, 0, &db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_pool_stats(pool, 1, 0);
+  g_rc = sqldbal_pool_acquire(pool, 0, &db2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(db1 != db2);
+  sqldbal_test_pool_stats(pool, 2, 0);
+
+  /* Pool exhausted. */
+  g_rc = sqldbal_pool_acquire(pool, 0, &db3);
+  assert(g_rc == SQLDBAL_STATUS_TIMEOUT);
+  assert(db3 == NULL);
+  g_rc = sqldbal_pool_acquire(pool, 10, &db3);
+  assert(g_rc == SQLDBAL_STATUS_TIMEOUT);
+  assert(db3 == NULL);
+
+  /* The most recently released connection comes back first. */
+  g_rc = sqldbal_pool_release(pool, db2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_pool_stats(pool, 2, 1);
+  g_rc = sqldbal_pool_acquire(pool, -1, &db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(db3 == db2);
+
+  /* Release a connection with an error status. */
+  g_rc = sqldbal_exec(db3, g_sql_invalid, NULL, NULL);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  g_rc = sqldbal_pool_release(pool, db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(sqldbal_status_code_get(db3) == SQLDBAL_STATUS_OK);
+
+  /* Release the same connection twice. */
+  g_rc = sqldbal_pool_release(pool, db3);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_test_pool_stats(pool, 2, 1);
+
+  /* Release a connection that did not come from the pool. */
+  sqldbal_test_open_db_sqlite();
+  g_rc = sqldbal_pool_release(pool, g_db);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_test_db_close();
+
+  /* Release rolls back an open transaction. */
+  g_rc = sqldbal_pool_acquire(pool, 0, &db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_begin_transaction(db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_release(pool, db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_acquire(pool, 0, &db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_begin_transaction(db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_commit(db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* Release ends an active pipeline. */
+  g_rc = sqldbal_pipeline_begin(db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_release(pool, db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_acquire(pool, 0, &db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pipeline_begin(db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pipeline_end(db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_release(pool, db3);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  g_rc = sqldbal_pool_release(pool, db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_pool_stats(pool, 2, 2);
+  g_rc = sqldbal_pool_close(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* Evict idle connections down to the minimum pool size. */
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         0,
+                         SQLDBAL_STATUS_OK,
+                         &pool);
+  g_rc = sqldbal_pool_acquire(pool, 0, &db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_acquire(pool, 0, &db2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_release(pool, db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_pool_stats(pool, 1, 0);
+  g_rc = sqldbal_pool_release(pool, db2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_pool_stats(pool, 1, 1);
+  g_rc = sqldbal_pool_close(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  sqldbal_functional_test_pool_threads();
+  sqldbal_functional_test_pool_thread_db();
+}
+
 /**
  * Test harness for @ref sqldbal_stmt_bind_text.
  *
@@ -2037,24 +5735,405 @@ sqldbal_functional_test_sqlite_open_options(void){
 
   /* Read-only database. */
   g_rc = sqldbal_open(SQLDBAL_DRIVER_SQLITE,
-                      g_db_config_list[2].location,
+                      g_db_config_list[2].location,
+                      g_db_config_list[2].port,
+                      g_db_config_list[2].username,
+                      g_db_config_list[2].password,
+                      g_db_config_list[2].database,
+                      g_db_config_list[2].flags |
+                        SQLDBAL_FLAG_SQLITE_OPEN_READONLY,
+                      NULL,
+                      0,
+                      &g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_generate_insert_id();
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_stmt_bind_text(0, SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_EXEC);
+  g_rc = sqldbal_stmt_close(g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_CLOSE);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_db_close();
+}
+
+/**
+ * Open a SQLite database with the busy handling options.
+ *
+ * @param[in]  busy_handler  Value of the BUSY_HANDLER option.
+ * @param[in]  timeout_ms    Value of the BUSY_TIMEOUT_MS option.
+ * @param[in]  backoff_min   Value of the BUSY_BACKOFF_MIN_MS option.
+ * @param[in]  backoff_max   Value of the BUSY_BACKOFF_MAX_MS option.
+ * @param[in]  expect_status Expected status code from @ref sqldbal_open.
+ * @param[out] db            See @ref sqldbal_db.
+ */
+static void
+sqldbal_test_sqlite_busy_open(const char *const busy_handler,
+                              const char *const timeout_ms,
+                              const char *const backoff_min,
+                              const char *const backoff_max,
+                              enum sqldbal_status_code expect_status,
+                              struct sqldbal_db **db){
+  struct sqldbal_driver_option option_list[4];
+
+  option_list[0].key   = "BUSY_HANDLER";
+  option_list[0].value = busy_handler;
+  option_list[1].key   = "BUSY_TIMEOUT_MS";
+  option_list[1].value = timeout_ms;
+  option_list[2].key   = "BUSY_BACKOFF_MIN_MS";
+  option_list[2].value = backoff_min;
+  option_list[3].key   = "BUSY_BACKOFF_MAX_MS";
+  option_list[3].value = backoff_max;
+  g_rc = sqldbal_open(SQLDBAL_DRIVER_SQLITE,
+                      g_db_config_list[2].location,
+                      g_db_config_list[2].port,
+                      g_db_config_list[2].username,
+                      g_db_config_list[2].password,
+                      g_db_config_list[2].database,
+                      g_db_config_list[2].flags,
+                      option_list,
+                      sizeof(option_list) / sizeof(option_list[0]),
+                      db);
+  assert(g_rc == expect_status);
+  if(g_rc != SQLDBAL_STATUS_OK){
+    g_rc = sqldbal_close(*db);
+    assert(g_rc == expect_status);
+  }
+}
+
+/**
+ * Run an insert statement while another connection holds an exclusive
+ * lock on the SQLite database.
+ *
+ * @param[in] busy_handler      Value of the BUSY_HANDLER option.
+ * @param[in] min_num_retries   Expected minimum number of retries.
+ * @param[in] max_num_retries   Expected maximum number of retries.
+ */
+static void
+sqldbal_test_sqlite_busy_lock(const char *const busy_handler,
+                              uint64_t min_num_retries,
+                              uint64_t max_num_retries){
+  struct sqldbal_db *db;
+  struct sqldbal_stmt *stmt;
+
+  sqldbal_test_sqlite_busy_open(busy_handler,
+                                "20",
+                                "1",
+                                "4",
+                                SQLDBAL_STATUS_OK,
+                                &db);
+  g_rc = sqldbal_stmt_prepare(db,
+                              "INSERT INTO test_busy(test_busy_id) VALUES(1)",
+                              SIZE_MAX,
+                              &stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  sqldbal_test_exec_plain("BEGIN EXCLUSIVE");
+  g_rc = sqldbal_stmt_execute(stmt);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  sqldbal_status_code_clear(db);
+  sqldbal_test_busy_stats(db, min_num_retries, max_num_retries, 0);
+  sqldbal_test_exec_plain("ROLLBACK");
+
+  g_rc = sqldbal_stmt_execute(stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_stmt_close(stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_close(db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Test the SQLite busy handling options.
+ */
+static void
+sqldbal_functional_test_sqlite_busy(void){
+  struct sqldbal_db *db;
+
+  /* Invalid options. */
+  sqldbal_test_sqlite_busy_open(NULL,
+                                "20",
+                                "1",
+                                "4",
+                                SQLDBAL_STATUS_PARAM,
+                                &db);
+  sqldbal_test_sqlite_busy_open("INVALID",
+                                "20",
+                                "1",
+                                "4",
+                                SQLDBAL_STATUS_PARAM,
+                                &db);
+  sqldbal_test_sqlite_busy_open("SQLDBAL",
+                                "abc",
+                                "1",
+                                "4",
+                                SQLDBAL_STATUS_PARAM,
+                                &db);
+  sqldbal_test_sqlite_busy_open("SQLDBAL",
+                                "20",
+                                "0",
+                                "4",
+                                SQLDBAL_STATUS_PARAM,
+                                &db);
+  sqldbal_test_sqlite_busy_open("SQLDBAL",
+                                "20",
+                                "5",
+                                "4",
+                                SQLDBAL_STATUS_PARAM,
+                                &db);
+
+  sqldbal_test_db_open(SQLDBAL_DRIVER_SQLITE);
+  sqldbal_test_exec_plain("DROP TABLE IF EXISTS test_busy");
+  sqldbal_test_exec_plain("CREATE TABLE test_busy(test_busy_id INTEGER)");
+
+  sqldbal_test_sqlite_busy_lock("SQLDBAL", 1, UINT64_MAX);
+  sqldbal_test_sqlite_busy_lock("HANDLER", 1, UINT64_MAX);
+  sqldbal_test_sqlite_busy_lock("TIMEOUT", 0, 0);
+
+  /* The connection holding the lock never had to wait. */
+  sqldbal_test_busy_stats(g_db, 0, 0, 0);
+  sqldbal_test_exec_plain("DROP TABLE test_busy");
+  sqldbal_test_db_close();
+}
+
+/**
+ * Callback for @ref sqldbal_exec that compares the value returned by a
+ * PRAGMA statement.
+ *
+ * @param[in] user_data       Expected value.
+ * @param[in] num_cols        Number of columns in the result.
+ * @param[in] col_result_list Column values.
+ * @param[in] col_length_list Length of each column value.
+ * @return 0 to continue processing rows.
+ */
+static int
+sqldbal_test_sqlite_pragma_callback(void *user_data,
+                                    size_t num_cols,
+                                    char **col_result_list,
+                                    size_t *col_length_list){
+  const char *expect;
+
+  (void)col_length_list;
+
+  expect = user_data;
+  assert(num_cols == 1);
+  assert(strcmp(col_result_list[0], expect) == 0);
+  return 0;
+}
+
+/**
+ * Open a SQLite database with a single PRAGMA option.
+ *
+ * @param[in] location      Path to the database file.
+ * @param[in] key           Option key.
+ * @param[in] value         Option value.
+ * @param[in] expect_status Expected status code from @ref sqldbal_open.
+ */
+static void
+sqldbal_test_sqlite_pragma_open(const char *const location,
+                                const char *const key,
+                                const char *const value,
+                                enum sqldbal_status_code expect_status){
+  struct sqldbal_driver_option option;
+
+  option.key   = key;
+  option.value = value;
+  sqldbal_test_open(SQLDBAL_DRIVER_SQLITE,
+                    location,
+                    g_db_config_list[2].port,
+                    g_db_config_list[2].username,
+                    g_db_config_list[2].password,
+                    g_db_config_list[2].database,
+                    g_db_config_list[2].flags,
+                    1,
+                    &option,
+                    expect_status);
+}
+
+/**
+ * Test the SQLite PRAGMA options and the mutex/shared cache flags.
+ */
+static void
+sqldbal_functional_test_sqlite_pragma(void){
+  const struct sqldbal_driver_option option_list[] = {
+    {"PAGE_SIZE",    "8192"},
+    {"JOURNAL_MODE", "wal"},
+    {"SYNCHRONOUS",  "NORMAL"},
+    {"CACHE_SIZE",   "-4096"},
+    {"MMAP_SIZE",    "1048576"},
+    {"TEMP_STORE",   "MEMORY"}
+  };
+  const char *const location = g_db_config_list[2].location;
+  char journal_mode[] = "wal";
+  char synchronous[] = "1";
+  char cache_size[] = "-4096";
+  char temp_store[] = "2";
+
+  /* Invalid values. */
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "JOURNAL_MODE",
+                                  "INVALID",
+                                  SQLDBAL_STATUS_PARAM);
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "JOURNAL_MODE",
+                                  NULL,
+                                  SQLDBAL_STATUS_PARAM);
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "SYNCHRONOUS",
+                                  "0; DROP TABLE article",
+                                  SQLDBAL_STATUS_PARAM);
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "TEMP_STORE",
+                                  "",
+                                  SQLDBAL_STATUS_PARAM);
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "PAGE_SIZE",
+                                  "-4096",
+                                  SQLDBAL_STATUS_PARAM);
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "MMAP_SIZE",
+                                  "12a",
+                                  SQLDBAL_STATUS_PARAM);
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "CACHE_SIZE",
+                                  "-",
+                                  SQLDBAL_STATUS_PARAM);
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "CACHE_SIZE",
+                                  "1234567890123456789",
+                                  SQLDBAL_STATUS_PARAM);
+
+  /* In-memory databases cannot switch to WAL mode. */
+  sqldbal_test_sqlite_pragma_open(":memory:",
+                                  "JOURNAL_MODE",
+                                  "WAL",
+                                  SQLDBAL_STATUS_OPEN);
+
+  /* sqlite3_exec */
+  g_sqldbal_err_sqlite3_exec_ctr = 0;
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "SYNCHRONOUS",
+                                  "FULL",
+                                  SQLDBAL_STATUS_OPEN);
+  g_sqldbal_err_sqlite3_exec_ctr = -1;
+
+  sqldbal_test_open(SQLDBAL_DRIVER_SQLITE,
+                    location,
+                    g_db_config_list[2].port,
+                    g_db_config_list[2].username,
+                    g_db_config_list[2].password,
+                    g_db_config_list[2].database,
+                    g_db_config_list[2].flags |
+                      SQLDBAL_FLAG_SQLITE_OPEN_FULLMUTEX |
+                      SQLDBAL_FLAG_SQLITE_OPEN_SHAREDCACHE,
+                    0,
+                    NULL,
+                    SQLDBAL_STATUS_OK);
+
+  g_rc = sqldbal_open(SQLDBAL_DRIVER_SQLITE,
+                      location,
                       g_db_config_list[2].port,
                       g_db_config_list[2].username,
                       g_db_config_list[2].password,
                       g_db_config_list[2].database,
                       g_db_config_list[2].flags |
-                        SQLDBAL_FLAG_SQLITE_OPEN_READONLY,
-                      NULL,
-                      0,
+                        SQLDBAL_FLAG_SQLITE_OPEN_NOMUTEX,
+                      option_list,
+                      sizeof(option_list) / sizeof(option_list[0]),
                       &g_db);
   assert(g_rc == SQLDBAL_STATUS_OK);
-  sqldbal_test_stmt_generate_insert_id();
-  sqldbal_test_stmt_prepare_sql();
-  sqldbal_test_stmt_bind_text(0, SQLDBAL_STATUS_OK);
-  sqldbal_test_stmt_execute(SQLDBAL_STATUS_EXEC);
-  g_rc = sqldbal_stmt_close(g_stmt);
-  assert(g_rc == SQLDBAL_STATUS_CLOSE);
-  sqldbal_status_code_clear(g_db);
+  g_rc = sqldbal_exec(g_db,
+                      "PRAGMA journal_mode",
+                      sqldbal_test_sqlite_pragma_callback,
+                      journal_mode);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_exec(g_db,
+                      "PRAGMA synchronous",
+                      sqldbal_test_sqlite_pragma_callback,
+                      synchronous);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_exec(g_db,
+                      "PRAGMA cache_size",
+                      sqldbal_test_sqlite_pragma_callback,
+                      cache_size);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_exec(g_db,
+                      "PRAGMA temp_store",
+                      sqldbal_test_sqlite_pragma_callback,
+                      temp_store);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_db_close();
+
+  /* Switch back so that the remaining tests use the default journal. */
+  sqldbal_test_sqlite_pragma_open(location,
+                                  "JOURNAL_MODE",
+                                  "DELETE",
+                                  SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Count the rows returned by @ref sqldbal_exec and check the text and
+ * blob lengths in @ref sqldbal_functional_test_sqlite_exec.
+ *
+ * @param[in] user_data       Number of rows processed so far.
+ * @param[in] num_cols        Number of columns in @p col_result_list
+ *                            and @p col_length_list.
+ * @param[in] col_result_list Column values in the current row.
+ * @param[in] col_length_list Length of the corresponding column
+ *                            in @p col_result_list.
+ * @retval 0 This function always succeeds or throws an assertion.
+ */
+static int
+sqldbal_test_sqlite_exec_fp(void *user_data,
+                            size_t num_cols,
+                            char **col_result_list,
+                            size_t *col_length_list){
+  size_t *num_rows;
+
+  num_rows = user_data;
+  if(*num_rows == 0){
+    assert(num_cols == 1);
+    assert(strcmp(col_result_list[0], "1") == 0);
+  }
+  else{
+    assert(num_cols == 3);
+    assert(col_length_list[0] == 3);
+    assert(memcmp(col_result_list[0], "a\0b", 3) == 0);
+    assert(col_result_list[1] == NULL);
+    assert(col_length_list[1] == 0);
+    assert(strcmp(col_result_list[2], "xyz") == 0);
+    assert(col_length_list[2] == 3);
+  }
+  *num_rows += 1;
+  return 0;
+}
+
+/**
+ * Run several SQLite statements in one call to @ref sqldbal_exec.
+ */
+static void
+sqldbal_functional_test_sqlite_exec(void){
+  size_t num_rows;
+
+  sqldbal_test_db_open(SQLDBAL_DRIVER_SQLITE);
+  num_rows = 0;
+  g_rc = sqldbal_exec(g_db,
+                      "SELECT 1;"
+                      "  SELECT x'610062', NULL, 'xyz'; "
+                      "  SELECT x'610062', NULL, 'xyz'; "
+                      "-- Trailing comment",
+                      sqldbal_test_sqlite_exec_fp,
+                      &num_rows);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  assert(num_rows == 3);
+
+  /* Stops at the first statement that fails. */
+  num_rows = 0;
+  g_rc = sqldbal_exec(g_db,
+                      "SELECT 1; SELECT * FROM missing_table; SELECT 1",
+                      sqldbal_test_sqlite_exec_fp,
+                      &num_rows);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  assert(num_rows == 1);
   sqldbal_test_db_close();
 }
 
@@ -2329,48 +6408,6 @@ sqldbal_test_all_error_open(void){
                     NULL,
                     SQLDBAL_STATUS_OPEN);
 
-  /* sqldbal_pq_query_oid_list - PQexec */
-  g_sqldbal_err_PQexec_ctr = 0;
-  sqldbal_test_open(SQLDBAL_DRIVER_POSTGRESQL,
-                    g_db_config_list[1].location,
-                    g_db_config_list[1].port,
-                    g_db_config_list[1].username,
-                    g_db_config_list[1].password,
-                    g_db_config_list[1].database,
-                    g_db_config_list[1].flags,
-                    0,
-                    NULL,
-                    SQLDBAL_STATUS_EXEC);
-  g_sqldbal_err_PQexec_ctr = -1;
-
-  /* sqldbal_pq_query_oid_list - reallocarray */
-  g_sqldbal_err_realloc_ctr = 0;
-  sqldbal_test_open(SQLDBAL_DRIVER_POSTGRESQL,
-                    g_db_config_list[1].location,
-                    g_db_config_list[1].port,
-                    g_db_config_list[1].username,
-                    g_db_config_list[1].password,
-                    g_db_config_list[1].database,
-                    g_db_config_list[1].flags,
-                    0,
-                    NULL,
-                    SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_realloc_ctr = -1;
-
-  /* sqldbal_pq_query_oid_list - sqldbal_strtoui */
-  g_sqldbal_err_strtoul_ctr = 0;
-  sqldbal_test_open(SQLDBAL_DRIVER_POSTGRESQL,
-                    g_db_config_list[1].location,
-                    g_db_config_list[1].port,
-                    g_db_config_list[1].username,
-                    g_db_config_list[1].password,
-                    g_db_config_list[1].database,
-                    g_db_config_list[1].flags,
-                    0,
-                    NULL,
-                    SQLDBAL_STATUS_COLUMN_COERCE);
-  g_sqldbal_err_strtoul_ctr = -1;
-
   /* sqldbal_sqlite_open - SQLDBAL_DRIVER_SQLITE */
 
   /* invalid option */
@@ -2397,19 +6434,6 @@ sqldbal_test_all_error_open(void){
                     NULL,
                     SQLDBAL_STATUS_OPEN);
 
-  /* sqlite3_trace_v2 */
-  g_sqldbal_err_sqlite3_trace_v2_ctr = 0;
-  sqldbal_test_open(SQLDBAL_DRIVER_SQLITE,
-                    g_db_config_list[2].location,
-                    g_db_config_list[2].port,
-                    g_db_config_list[2].username,
-                    g_db_config_list[2].password,
-                    g_db_config_list[2].database,
-                    g_db_config_list[2].flags | SQLDBAL_FLAG_DEBUG,
-                    0,
-                    NULL,
-                    SQLDBAL_STATUS_OPEN);
-  g_sqldbal_err_sqlite3_trace_v2_ctr = -1;
 }
 
 /**
@@ -2624,14 +6648,14 @@ sqldbal_test_all_error_exec(void){
                     SQLDBAL_STATUS_NOMEM);
   g_sqldbal_err_si_int_to_size_ctr = -1;
 
-  /* sqldbal_str_hex2bin */
-  g_sqldbal_err_malloc_ctr = 3;
+  /* sqldbal_pq_exec_buf_reserve_bin - realloc */
+  g_sqldbal_err_realloc_ctr = 4;
   sqldbal_test_exec(SQLDBAL_DRIVER_POSTGRESQL,
                     g_sql_valid_sel,
                     sqldbal_test_exec_do_nothing_fp,
                     NULL,
                     SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_malloc_ctr = -1;
+  g_sqldbal_err_realloc_ctr = -1;
 
   /* callback */
   sqldbal_test_exec(SQLDBAL_DRIVER_POSTGRESQL,
@@ -2642,15 +6666,49 @@ sqldbal_test_all_error_exec(void){
 
   /* sqldbal_sqlite_exec - SQLDBAL_DRIVER_SQLITE */
 
-  /* sqldbal_sqlite_exec_callback - sqldbal_reallocarray */
+  /* sqlite3_prepare_v2 */
+  sqldbal_test_exec(SQLDBAL_DRIVER_SQLITE,
+                    g_sql_invalid,
+                    NULL,
+                    NULL,
+                    SQLDBAL_STATUS_EXEC);
+
+  /* sqldbal_sqlite_exec_buf_reserve - sqldbal_reallocarray - 1 */
   g_sqldbal_err_realloc_ctr = 0;
   sqldbal_test_exec(SQLDBAL_DRIVER_SQLITE,
                     g_sql_valid_sel,
                     sqldbal_test_exec_do_nothing_fp,
                     NULL,
-                    SQLDBAL_STATUS_EXEC);
+                    SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_realloc_ctr = -1;
+
+  /* sqldbal_sqlite_exec_buf_reserve - sqldbal_reallocarray - 2 */
+  g_sqldbal_err_realloc_ctr = 1;
+  sqldbal_test_exec(SQLDBAL_DRIVER_SQLITE,
+                    g_sql_valid_sel,
+                    sqldbal_test_exec_do_nothing_fp,
+                    NULL,
+                    SQLDBAL_STATUS_NOMEM);
   g_sqldbal_err_realloc_ctr = -1;
 
+  /* sqlite3_step */
+  g_sqldbal_err_sqlite3_step_ctr = 0;
+  sqldbal_test_exec(SQLDBAL_DRIVER_SQLITE,
+                    g_sql_valid_sel,
+                    NULL,
+                    NULL,
+                    SQLDBAL_STATUS_EXEC);
+  g_sqldbal_err_sqlite3_step_ctr = -1;
+
+  /* sqlite3_column_text */
+  g_sqldbal_err_sqlite3_column_text_ctr = 0;
+  sqldbal_test_exec(SQLDBAL_DRIVER_SQLITE,
+                    g_sql_valid_sel,
+                    sqldbal_test_exec_do_nothing_fp,
+                    NULL,
+                    SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_sqlite3_column_text_ctr = -1;
+
   /* callback */
   sqldbal_test_exec(SQLDBAL_DRIVER_SQLITE,
                     g_sql_valid_sel,
@@ -2728,6 +6786,242 @@ sqldbal_test_all_error_last_insert_id(void){
   sqldbal_test_db_close();
 }
 
+/**
+ * Prepare @ref g_sql_valid_sel into @ref g_stmt and check the result.
+ */
+static void
+sqldbal_test_stmt_prepare_valid_sel(void){
+  g_rc = sqldbal_stmt_prepare(g_db, g_sql_valid_sel, (size_t)-1, &g_stmt);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
+/**
+ * Run through different failure scenarios when using the prepared
+ * statement cache.
+ */
+static void
+sqldbal_test_all_error_stmt_cache(void){
+  /* sqldbal_stmt_cache_set_capacity - calloc */
+  sqldbal_test_db_open(SQLDBAL_DRIVER_SQLITE);
+  g_sqldbal_err_calloc_ctr = 0;
+  g_rc = sqldbal_stmt_cache_set_capacity(g_db, 4);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_calloc_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_prepare_valid_sel();
+  sqldbal_test_stmt_close(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_cache_stats(0, 0, 0);
+
+  /* sqldbal_stmt_prepare - malloc SQL copy */
+  g_rc = sqldbal_stmt_cache_set_capacity(g_db, 4);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_sqldbal_err_malloc_ctr = 1;
+  sqldbal_test_stmt_prepare_valid_sel();
+  g_sqldbal_err_malloc_ctr = -1;
+  sqldbal_test_stmt_close(SQLDBAL_STATUS_OK);
+  sqldbal_test_stmt_cache_stats(0, 1, 0);
+
+  /* sqldbal_stmt_close - sqlite3_reset */
+  sqldbal_test_stmt_prepare_valid_sel();
+  g_sqldbal_err_sqlite3_reset_ctr = 0;
+  sqldbal_test_stmt_close(SQLDBAL_STATUS_EXEC);
+  g_sqldbal_err_sqlite3_reset_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_cache_stats(0, 2, 0);
+
+  /* sqldbal_stmt_close - database already has an error */
+  sqldbal_test_stmt_prepare_valid_sel();
+  sqldbal_status_code_set(g_db, SQLDBAL_STATUS_EXEC);
+  sqldbal_test_stmt_close(SQLDBAL_STATUS_EXEC);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_cache_stats(0, 3, 0);
+  sqldbal_test_db_close();
+
+  /* sqldbal_stmt_cache_set_capacity - invalid database handle */
+  g_sqldbal_err_malloc_ctr = 0;
+  g_rc = sqldbal_open(SQLDBAL_DRIVER_SQLITE,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      SQLDBAL_FLAG_NONE,
+                      NULL,
+                      0,
+                      &g_db);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_malloc_ctr = -1;
+  g_rc = sqldbal_stmt_cache_set_capacity(g_db, 4);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  g_rc = sqldbal_close(g_db);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+}
+
+/**
+ * Run through different failure scenarios when calling @ref sqldbal_ping.
+ */
+static void
+sqldbal_test_all_error_ping(void){
+  sqldbal_test_db_open(SQLDBAL_DRIVER_MARIADB);
+  g_rc = sqldbal_ping(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* mysql_ping */
+  g_sqldbal_err_mysql_ping_ctr = 0;
+  g_rc = sqldbal_ping(g_db);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  g_sqldbal_err_mysql_ping_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_db_close();
+
+  sqldbal_test_db_open(SQLDBAL_DRIVER_POSTGRESQL);
+  g_rc = sqldbal_ping(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* PQexec */
+  g_sqldbal_err_PQexec_ctr = 0;
+  g_rc = sqldbal_ping(g_db);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  g_sqldbal_err_PQexec_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_db_close();
+
+  sqldbal_test_db_open(SQLDBAL_DRIVER_SQLITE);
+  g_rc = sqldbal_ping(g_db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sqldbal_test_db_close();
+}
+
+/**
+ * Run through different failure scenarios when using a
+ * @ref sqldbal_pool.
+ */
+static void
+sqldbal_test_all_error_pool(void){
+  struct sqldbal_pool *pool;
+  struct sqldbal_db *db1;
+  struct sqldbal_db *db2;
+
+  /* sqldbal_pool_open - calloc */
+  g_sqldbal_err_calloc_ctr = 0;
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_NOMEM,
+                         &pool);
+  g_sqldbal_err_calloc_ctr = -1;
+
+  /* sqldbal_reallocarray - idle list */
+  g_sqldbal_err_realloc_ctr = 0;
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_NOMEM,
+                         &pool);
+  g_sqldbal_err_realloc_ctr = -1;
+
+  /* sqldbal_params_str_size - si_add_size_t */
+  g_sqldbal_err_si_add_size_t_ctr = 0;
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_NOMEM,
+                         &pool);
+  g_sqldbal_err_si_add_size_t_ctr = -1;
+
+  /* sqldbal_params_copy - malloc */
+  g_sqldbal_err_malloc_ctr = 0;
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_NOMEM,
+                         &pool);
+  g_sqldbal_err_malloc_ctr = -1;
+
+  /* sqldbal_reallocarray - option list */
+  g_sqldbal_err_realloc_ctr = 1;
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_NOMEM,
+                         &pool);
+  g_sqldbal_err_realloc_ctr = -1;
+
+  /* sqldbal_pool_warm - sqldbal_reallocarray */
+  g_sqldbal_err_realloc_ctr = 2;
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         1,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_NOMEM,
+                         &pool);
+  g_sqldbal_err_realloc_ctr = -1;
+
+  /* sqldbal_open_parallel - second connection */
+  g_sqldbal_err_malloc_ctr = 2;
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         2,
+                         2,
+                         -1,
+                         SQLDBAL_STATUS_NOMEM,
+                         &pool);
+  g_sqldbal_err_malloc_ctr = -1;
+
+  /* sqldbal_pool_acquire - sqldbal_open */
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_SQLITE,
+                         0,
+                         1,
+                         -1,
+                         SQLDBAL_STATUS_OK,
+                         &pool);
+  g_sqldbal_err_malloc_ctr = 0;
+  g_rc = sqldbal_pool_acquire(pool, 0, &db1);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  assert(db1 == NULL);
+  g_sqldbal_err_malloc_ctr = -1;
+  sqldbal_test_pool_stats(pool, 0, 0);
+  g_rc = sqldbal_pool_close(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+
+  /* sqldbal_pool_release - sqldbal_ping */
+  sqldbal_test_pool_open(SQLDBAL_DRIVER_POSTGRESQL,
+                         0,
+                         1,
+                         -1,
+                         SQLDBAL_STATUS_OK,
+                         &pool);
+  g_rc = sqldbal_pool_acquire(pool, 0, &db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_exec(db1, g_sql_invalid, NULL, NULL);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  g_sqldbal_err_PQexec_ctr = 0;
+  g_rc = sqldbal_pool_release(pool, db1);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  g_sqldbal_err_PQexec_ctr = -1;
+  sqldbal_test_pool_stats(pool, 0, 0);
+
+  /* sqldbal_pool_acquire - replace a broken idle connection */
+  g_rc = sqldbal_pool_acquire(pool, 0, &db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_release(pool, db1);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  sleep(1);
+  g_sqldbal_err_PQexec_ctr = 0;
+  g_rc = sqldbal_pool_acquire(pool, 0, &db2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_sqldbal_err_PQexec_ctr = -1;
+  sqldbal_test_pool_stats(pool, 1, 0);
+  g_rc = sqldbal_pool_release(pool, db2);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_pool_close(pool);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+}
+
 /**
  * Test harness for @ref sqldbal_begin_transaction, @ref sqldbal_commit,
  * and @ref sqldbal_rollback.
@@ -2827,6 +7121,12 @@ sqldbal_test_all_error_stmt_prepare(void){
   sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
   g_sqldbal_err_realloc_ctr = -1;
 
+  /* calloc */
+  sqldbal_status_code_clear(g_db);
+  g_sqldbal_err_calloc_ctr = 0;
+  sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_calloc_ctr = -1;
+
   /* sqldbal_mariadb_stmt_get_num_cols */
 
   /* mysql_stmt_errno */
@@ -2885,12 +7185,24 @@ sqldbal_test_all_error_stmt_prepare(void){
   sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_OVERFLOW);
   g_sqldbal_err_si_int_to_size_ctr = -1;
 
-  /* calloc */
+  /* calloc - 1 */
   sqldbal_status_code_clear(g_db);
   g_sqldbal_err_calloc_ctr = 0;
   sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
   g_sqldbal_err_calloc_ctr = -1;
 
+  /* calloc - 2 */
+  sqldbal_status_code_clear(g_db);
+  g_sqldbal_err_calloc_ctr = 1;
+  sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_calloc_ctr = -1;
+
+  /* calloc - 3 */
+  sqldbal_status_code_clear(g_db);
+  g_sqldbal_err_calloc_ctr = 2;
+  sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_calloc_ctr = -1;
+
   /* sqldbal_reallocarray - 1 */
   sqldbal_status_code_clear(g_db);
   g_sqldbal_err_realloc_ctr = 0;
@@ -2903,6 +7215,24 @@ sqldbal_test_all_error_stmt_prepare(void){
   sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
   g_sqldbal_err_realloc_ctr = -1;
 
+  /* sqldbal_pq_stmt_describe_types - sqldbal_reallocarray - 1 */
+  sqldbal_status_code_clear(g_db);
+  g_sqldbal_err_realloc_ctr = 2;
+  sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_realloc_ctr = -1;
+
+  /* sqldbal_pq_stmt_describe_types - sqldbal_reallocarray - 2 */
+  sqldbal_status_code_clear(g_db);
+  g_sqldbal_err_realloc_ctr = 3;
+  sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_realloc_ctr = -1;
+
+  /* sqldbal_pq_stmt_describe_types - sqldbal_reallocarray - 3 */
+  sqldbal_status_code_clear(g_db);
+  g_sqldbal_err_realloc_ctr = 4;
+  sqldbal_test_stmt_prepare(g_sql_valid_sel, SIZE_MAX, SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_realloc_ctr = -1;
+
   sqldbal_test_db_close();
 
   /* SQLDBAL_DRIVER_SQLITE */
@@ -3022,15 +7352,6 @@ sqldbal_test_all_error_stmt_execute(void){
   sqldbal_test_db_open(SQLDBAL_DRIVER_MARIADB);
   sqldbal_test_stmt_generate_update();
 
-  /* mysql_stmt_attr_set */
-  sqldbal_test_stmt_prepare_sql();
-  sqldbal_test_bind_text_noerror();
-  g_sqldbal_err_mysql_stmt_attr_set_ctr = 0;
-  sqldbal_test_stmt_execute(SQLDBAL_STATUS_EXEC);
-  g_sqldbal_err_mysql_stmt_attr_set_ctr = -1;
-  sqldbal_status_code_clear(g_db);
-  sqldbal_test_stmt_close_sql();
-
   /* mysql_stmt_bind_param */
   sqldbal_test_stmt_prepare_sql();
   sqldbal_test_bind_text_noerror();
@@ -3108,6 +7429,26 @@ sqldbal_test_all_error_stmt_execute(void){
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
+  /* calloc - 4 */
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_bind_text_noerror();
+  g_sqldbal_err_calloc_ctr = 3;
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_calloc_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* The bind list from the first execution gets reused. */
+  sqldbal_test_stmt_prepare_sql();
+  sqldbal_test_bind_text_noerror();
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  g_sqldbal_err_calloc_ctr = 0;
+  g_sqldbal_err_malloc_ctr = 0;
+  sqldbal_test_stmt_execute(SQLDBAL_STATUS_OK);
+  g_sqldbal_err_calloc_ctr = -1;
+  g_sqldbal_err_malloc_ctr = -1;
+  sqldbal_test_stmt_close_sql();
+
   /* si_size_to_uint */
   sqldbal_test_stmt_prepare_sql();
   sqldbal_test_bind_text_noerror();
@@ -3175,10 +7516,10 @@ sqldbal_test_all_error_stmt_execute(void){
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
-  /* sqlite3_step - num_retries >= SQLDBAL_SQLITE_MAX_NUM_RETRIES */
+  /* sqlite3_step - SQLITE_BUSY until SQLDBAL_SQLITE_BUSY_TIMEOUT_MS */
   sqldbal_test_stmt_prepare_sql();
   sqldbal_test_bind_text_noerror();
-  g_sqldbal_busy_sqlite3_step_ctr = 11;
+  g_sqldbal_busy_sqlite3_step_ctr = 1000;
   sqldbal_test_stmt_execute(SQLDBAL_STATUS_EXEC);
   g_sqldbal_busy_sqlite3_step_ctr = -1;
   sqldbal_status_code_clear(g_db);
@@ -3231,14 +7572,14 @@ sqldbal_test_all_error_stmt_fetch(void){
   g_sqldbal_err_sqlite3_step_ctr = -1;
   sqldbal_status_code_clear(g_db);
 
-  /* sqlite3_step - SQLITE_BUSY < SQLDBAL_SQLITE_MAX_NUM_RETRIES */
+  /* sqlite3_step - SQLITE_BUSY before SQLDBAL_SQLITE_BUSY_TIMEOUT_MS */
   g_sqldbal_busy_sqlite3_step_ctr = 3;
   sqldbal_test_stmt_fetch(SQLDBAL_STATUS_OK, SQLDBAL_FETCH_ROW);
   g_sqldbal_busy_sqlite3_step_ctr = -1;
   sqldbal_status_code_clear(g_db);
 
-  /* sqlite3_step - SQLITE_BUSY >= SQLDBAL_SQLITE_MAX_NUM_RETRIES */
-  g_sqldbal_busy_sqlite3_step_ctr = 11;
+  /* sqlite3_step - SQLITE_BUSY until SQLDBAL_SQLITE_BUSY_TIMEOUT_MS */
+  g_sqldbal_busy_sqlite3_step_ctr = 1000;
   sqldbal_test_stmt_fetch(SQLDBAL_STATUS_FETCH, SQLDBAL_FETCH_ERROR);
   g_sqldbal_busy_sqlite3_step_ctr = -1;
   sqldbal_status_code_clear(g_db);
@@ -3250,8 +7591,10 @@ sqldbal_test_all_error_stmt_fetch(void){
 /**
  * Run through different failure scenarios when calling these functions.
  *   - @ref sqldbal_stmt_bind_blob
+ *   - @ref sqldbal_stmt_bind_double
  *   - @ref sqldbal_stmt_bind_int64
  *   - @ref sqldbal_stmt_bind_text
+ *   - @ref sqldbal_stmt_bind_timestamp
  */
 static void
 sqldbal_test_all_error_stmt_bind(void){
@@ -3275,11 +7618,18 @@ sqldbal_test_all_error_stmt_bind(void){
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
-  /* malloc */
+  /* realloc */
   sqldbal_test_stmt_prepare_sql();
-  g_sqldbal_err_malloc_ctr = 0;
+  g_sqldbal_err_realloc_ctr = 0;
   sqldbal_test_bind_blob(0, SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_malloc_ctr = -1;
+  g_sqldbal_err_realloc_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* blob static - sqldbal_stmt_bind_in_range */
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_blob_static(g_stmt, 1, "test", 4);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
@@ -3299,11 +7649,38 @@ sqldbal_test_all_error_stmt_bind(void){
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
-  /* malloc */
+  /* double - sqldbal_stmt_bind_in_range */
   sqldbal_test_stmt_prepare_sql();
-  g_sqldbal_err_malloc_ctr = 0;
-  sqldbal_test_bind_int64(0, 1, SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_malloc_ctr = -1;
+  g_rc = sqldbal_stmt_bind_double(g_stmt, 1, 0);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* int32 and bool - sqldbal_stmt_bind_in_range */
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_int32(g_stmt, 1, 0);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  g_rc = sqldbal_stmt_bind_bool(g_stmt, 1, 0);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* sqldbal_mariadb_stmt_bind_timestamp */
+
+  /* timestamp - sqldbal_stmt_bind_in_range */
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_timestamp(g_stmt, 1, 0);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* Year does not fit in DATETIME. */
+  sqldbal_test_stmt_prepare_sql();
+  g_rc = sqldbal_stmt_bind_timestamp(g_stmt, 0, INT64_MAX);
+  assert(g_rc == SQLDBAL_STATUS_OVERFLOW);
+  sqldbal_status_code_clear(g_db);
+  g_rc = sqldbal_stmt_bind_timestamp(g_stmt, 0, INT64_MIN);
+  assert(g_rc == SQLDBAL_STATUS_OVERFLOW);
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
@@ -3323,11 +7700,27 @@ sqldbal_test_all_error_stmt_bind(void){
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
-  /* malloc */
+  /* text static - sqldbal_stmt_bind_in_range */
   sqldbal_test_stmt_prepare_sql();
-  g_sqldbal_err_malloc_ctr = 0;
+  g_rc = sqldbal_stmt_bind_text_static(g_stmt, 1, "test", SIZE_MAX);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* sqldbal_stmt_bind_text_static - si_add_size_t */
+  sqldbal_test_stmt_prepare_sql();
+  g_sqldbal_err_si_add_size_t_ctr = 0;
+  g_rc = sqldbal_stmt_bind_text_static(g_stmt, 0, "test", SIZE_MAX);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_si_add_size_t_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* realloc */
+  sqldbal_test_stmt_prepare_sql();
+  g_sqldbal_err_realloc_ctr = 0;
   sqldbal_test_stmt_bind_text(0, SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_malloc_ctr = -1;
+  g_sqldbal_err_realloc_ctr = -1;
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
@@ -3345,11 +7738,11 @@ sqldbal_test_all_error_stmt_bind(void){
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
-  /* malloc */
+  /* realloc */
   sqldbal_test_stmt_prepare_sql();
-  g_sqldbal_err_malloc_ctr = 0;
+  g_sqldbal_err_realloc_ctr = 0;
   sqldbal_test_bind_blob(0, SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_malloc_ctr = -1;
+  g_sqldbal_err_realloc_ctr = -1;
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
@@ -3365,11 +7758,11 @@ sqldbal_test_all_error_stmt_bind(void){
 
   /* sqldbal_pq_stmt_bind_text */
 
-  /* malloc */
+  /* realloc */
   sqldbal_test_stmt_prepare_sql();
-  g_sqldbal_err_malloc_ctr = 0;
+  g_sqldbal_err_realloc_ctr = 0;
   sqldbal_test_stmt_bind_text(0, SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_malloc_ctr = -1;
+  g_sqldbal_err_realloc_ctr = -1;
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
@@ -3441,6 +7834,24 @@ sqldbal_test_all_error_stmt_bind(void){
   sqldbal_status_code_clear(g_db);
   sqldbal_test_stmt_close_sql();
 
+  /* sqldbal_sqlite_stmt_bind_double - si_size_to_int */
+  sqldbal_test_stmt_prepare_sql();
+  g_sqldbal_err_si_size_to_int_ctr = 0;
+  g_rc = sqldbal_stmt_bind_double(g_stmt, 0, 1);
+  assert(g_rc == SQLDBAL_STATUS_OVERFLOW);
+  g_sqldbal_err_si_size_to_int_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
+  /* sqldbal_sqlite_stmt_bind_timestamp - si_size_to_int */
+  sqldbal_test_stmt_prepare_sql();
+  g_sqldbal_err_si_size_to_int_ctr = 0;
+  g_rc = sqldbal_stmt_bind_timestamp(g_stmt, 0, 0);
+  assert(g_rc == SQLDBAL_STATUS_OVERFLOW);
+  g_sqldbal_err_si_size_to_int_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+  sqldbal_test_stmt_close_sql();
+
   /* sqldbal_sqlite_stmt_bind_text */
 
   /* si_size_to_int - 1 */
@@ -3473,11 +7884,18 @@ sqldbal_test_all_error_stmt_bind(void){
 /**
  * Run through different failure scenarios when calling these functions.
  *   - @ref sqldbal_stmt_column_blob
+ *   - @ref sqldbal_stmt_column_double
  *   - @ref sqldbal_stmt_column_int64
  *   - @ref sqldbal_stmt_column_text
+ *   - @ref sqldbal_stmt_column_timestamp
  */
 static void
 sqldbal_test_all_error_stmt_column(void){
+  double d;
+  int32_t i32;
+  int64_t ts;
+  int b;
+
   sqldbal_test_db_open(SQLDBAL_DRIVER_MARIADB);
   sqldbal_test_stmt_generate_select_article();
   sqldbal_test_stmt_prepare_sql();
@@ -3501,10 +7919,16 @@ sqldbal_test_all_error_stmt_column(void){
 
   /* sqldbal_mariadb_stmt_column_int64 */
 
-  /* strtoll */
+  /* si_llong_to_int64 */
+  g_sqldbal_err_si_llong_to_int64_ctr = 0;
+  sqldbal_test_stmt_column_int64(0, SQLDBAL_STATUS_COLUMN_COERCE);
+  g_sqldbal_err_si_llong_to_int64_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+
+  /* strtoll - integer conversion only happens for non-integer columns */
   g_sqldbal_err_strtoll_ctr = 0;
   g_sqldbal_err_strtoll_value = LLONG_MAX;
-  sqldbal_test_stmt_column_int64(0, SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_test_stmt_column_int64(1, SQLDBAL_STATUS_COLUMN_COERCE);
   g_sqldbal_err_strtoll_ctr = -1;
   g_sqldbal_err_strtoll_value = -1;
   sqldbal_status_code_clear(g_db);
@@ -3515,6 +7939,39 @@ sqldbal_test_all_error_stmt_column(void){
   sqldbal_test_stmt_column_text(12, SQLDBAL_STATUS_PARAM);
   sqldbal_status_code_clear(g_db);
 
+  /* sqldbal_stmt_column_double - sqldbal_stmt_column_in_range */
+  g_rc = sqldbal_stmt_column_double(g_stmt, 12, &d);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  /* sqldbal_stmt_column_int32 - sqldbal_stmt_column_in_range */
+  g_rc = sqldbal_stmt_column_int32(g_stmt, 12, &i32);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  assert(i32 == 0);
+  sqldbal_status_code_clear(g_db);
+
+  /* sqldbal_stmt_column_bool - sqldbal_stmt_column_in_range */
+  g_rc = sqldbal_stmt_column_bool(g_stmt, 12, &b);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  assert(b == 0);
+  sqldbal_status_code_clear(g_db);
+
+  /* sqldbal_stmt_column_timestamp - sqldbal_stmt_column_in_range */
+  g_rc = sqldbal_stmt_column_timestamp(g_stmt, 12, &ts);
+  assert(g_rc == SQLDBAL_STATUS_PARAM);
+  sqldbal_status_code_clear(g_db);
+
+  /* sqldbal_mariadb_stmt_column_double - text column */
+  g_rc = sqldbal_stmt_column_double(g_stmt, 1, &d);
+  assert(g_rc == SQLDBAL_STATUS_COLUMN_COERCE);
+  sqldbal_status_code_clear(g_db);
+
+  /* sqldbal_mariadb_stmt_column_timestamp - integer column */
+  g_rc = sqldbal_stmt_column_timestamp(g_stmt, 0, &ts);
+  assert(g_rc == SQLDBAL_STATUS_COLUMN_COERCE);
+  assert(ts == 0);
+  sqldbal_status_code_clear(g_db);
+
   sqldbal_test_stmt_close_sql();
   sqldbal_test_db_close();
 
@@ -3546,10 +8003,10 @@ sqldbal_test_all_error_stmt_column(void){
   g_sqldbal_err_si_int_to_size_ctr = -1;
   sqldbal_status_code_clear(g_db);
 
-  /* sqldbal_str_hex2bin */
-  g_sqldbal_err_malloc_ctr = 0;
+  /* sqldbal_pq_stmt_column_buf - realloc */
+  g_sqldbal_err_realloc_ctr = 0;
   sqldbal_test_stmt_column_blob(4, SQLDBAL_STATUS_NOMEM);
-  g_sqldbal_err_malloc_ctr = -1;
+  g_sqldbal_err_realloc_ctr = -1;
   sqldbal_status_code_clear(g_db);
 
   /* sqldbal_pq_stmt_column_text */
@@ -3734,29 +8191,282 @@ sqldbal_test_all_error_transaction(void){
 }
 
 /**
- * Test failure in @ref sqldbal_pq_is_oid.
+ * Test all failures in @ref sqldbal_trace_open, @ref sqldbal_trace_attach,
+ * and @ref sqldbal_sqlite_trace_profile.
  */
 static void
-sqldbal_test_all_error_pq_is_oid(void){
-  const struct sqldbal_pq_db *pq_db;
+sqldbal_test_all_error_trace(void){
+  struct sqldbal_trace *trace;
   int rc;
 
-  sqldbal_test_db_open(SQLDBAL_DRIVER_POSTGRESQL);
-  pq_db = sqldbal_pq_get_pq_db_handle(g_db);
-  rc = sqldbal_pq_is_oid(pq_db, 9999, "does not exist");
-  assert(rc == 1);
+  /* sqldbal_trace_open - malloc */
+  g_sqldbal_err_malloc_ctr = 0;
+  g_rc = sqldbal_trace_open(8,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            NULL,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_malloc_ctr = -1;
+
+  /* sqldbal_trace_open - calloc */
+  g_sqldbal_err_calloc_ctr = 0;
+  g_rc = sqldbal_trace_open(8,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            NULL,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_calloc_ctr = -1;
+
+  /* sqlite3_trace_v2 */
+  sqldbal_test_open_db_sqlite();
+  g_rc = sqldbal_trace_open(8,
+                            0,
+                            0,
+                            sqldbal_test_trace_callback,
+                            NULL,
+                            -1,
+                            &trace);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_sqldbal_err_sqlite3_trace_v2_ctr = 0;
+  g_rc = sqldbal_trace_attach(g_db, trace);
+  assert(g_rc == SQLDBAL_STATUS_EXEC);
+  g_sqldbal_err_sqlite3_trace_v2_ctr = -1;
+  sqldbal_status_code_clear(g_db);
+
+  /* Other trace events get ignored. */
+  rc = sqldbal_sqlite_trace_profile(9999, g_db, NULL, NULL);
+  assert(rc == 0);
+
+  /* Connection without a trace. */
+  rc = sqldbal_sqlite_trace_profile(SQLITE_TRACE_PROFILE, g_db, NULL, NULL);
+  assert(rc == 0);
+
   sqldbal_test_db_close();
+  sqldbal_trace_close(trace);
 }
 
 /**
- * Test all failures in @ref sqldbal_sqlite_trace_hook.
+ * Open two connections with @ref sqldbal_open_parallel, check the
+ * result, and then close them.
+ *
+ * @param[in] driver        See @ref sqldbal_driver.
+ * @param[in] location      See @ref sqldbal_open.
+ * @param[in] port          See @ref sqldbal_open.
+ * @param[in] expect_status Expected status return code of
+ *                          @ref sqldbal_open_parallel.
  */
 static void
-sqldbal_test_all_error_trace(void){
+sqldbal_test_open_parallel(enum sqldbal_driver driver,
+                           const char *const location,
+                           const char *const port,
+                           enum sqldbal_status_code expect_status){
+  struct sqldbal_db *db_list[2];
+  size_t i;
+
+  g_rc = sqldbal_open_parallel(driver,
+                               location,
+                               port,
+                               NULL,
+                               NULL,
+                               NULL,
+                               SQLDBAL_FLAG_NONE,
+                               NULL,
+                               0,
+                               2,
+                               db_list);
+  assert(g_rc == expect_status);
+  for(i = 0; i < 2; i++){
+    sqldbal_close(db_list[i]);
+  }
+}
+
+/**
+ * Give up on connections in @ref sqldbal_open_parallel after the
+ * CONNECT_TIMEOUT option, using a local socket that accepts connections
+ * but never answers.
+ *
+ * @param[in] driver See @ref sqldbal_driver.
+ */
+static void
+sqldbal_test_open_parallel_timeout(enum sqldbal_driver driver){
+  struct sqldbal_driver_option option;
+  struct sqldbal_db *db_list[2];
+  struct sockaddr_in addr;
+  socklen_t addr_len;
+  char port[16];
+  size_t i;
+  int fd;
   int rc;
 
-  rc = sqldbal_sqlite_trace_hook(9999, NULL, NULL, NULL);
+  fd = socket(AF_INET, SOCK_STREAM, 0);
+  assert(fd >= 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
   assert(rc == 0);
+  rc = listen(fd, 4);
+  assert(rc == 0);
+  addr_len = sizeof(addr);
+  rc = getsockname(fd, (struct sockaddr *)&addr, &addr_len);
+  assert(rc == 0);
+  sprintf(port, "%u", (unsigned int)ntohs(addr.sin_port));
+
+  option.key   = "CONNECT_TIMEOUT";
+  option.value = "1";
+  g_rc = sqldbal_open_parallel(driver,
+                               "127.0.0.1",
+                               port,
+                               NULL,
+                               NULL,
+                               NULL,
+                               SQLDBAL_FLAG_NONE,
+                               &option,
+                               1,
+                               2,
+                               db_list);
+  assert(g_rc == SQLDBAL_STATUS_OPEN);
+  for(i = 0; i < 2; i++){
+    sqldbal_close(db_list[i]);
+  }
+  close(fd);
+}
+
+/**
+ * Run through different failure scenarios when calling
+ * @ref sqldbal_open with @ref SQLDBAL_FLAG_LAZY_CONNECT and
+ * @ref sqldbal_open_parallel.
+ */
+static void
+sqldbal_test_all_error_lazy_connect(void){
+  struct sqldbal_db *db;
+
+  /* sqldbal_open - malloc */
+  g_sqldbal_err_malloc_ctr = 1;
+  sqldbal_test_open(SQLDBAL_DRIVER_SQLITE,
+                    NULL,
+                    NULL,
+                    NULL,
+                    NULL,
+                    NULL,
+                    SQLDBAL_FLAG_LAZY_CONNECT,
+                    0,
+                    NULL,
+                    SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_malloc_ctr = -1;
+
+  /* sqldbal_params_copy - malloc */
+  g_sqldbal_err_malloc_ctr = 2;
+  sqldbal_test_open(SQLDBAL_DRIVER_SQLITE,
+                    NULL,
+                    NULL,
+                    NULL,
+                    NULL,
+                    NULL,
+                    SQLDBAL_FLAG_LAZY_CONNECT,
+                    0,
+                    NULL,
+                    SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_malloc_ctr = -1;
+
+  /* sqldbal_params_str_size - si_add_size_t */
+  g_sqldbal_err_si_add_size_t_ctr = 0;
+  sqldbal_test_open(SQLDBAL_DRIVER_SQLITE,
+                    "/invalid",
+                    NULL,
+                    NULL,
+                    NULL,
+                    NULL,
+                    SQLDBAL_FLAG_LAZY_CONNECT,
+                    0,
+                    NULL,
+                    SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_si_add_size_t_ctr = -1;
+
+  /* sqldbal_lazy_connect - keeps the parameters to try again */
+  g_rc = sqldbal_open(SQLDBAL_DRIVER_SQLITE,
+                      "/invalid",
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      SQLDBAL_FLAG_LAZY_CONNECT,
+                      NULL,
+                      0,
+                      &db);
+  assert(g_rc == SQLDBAL_STATUS_OK);
+  g_rc = sqldbal_exec(db, "SELECT 1", NULL, NULL);
+  assert(g_rc == SQLDBAL_STATUS_OPEN);
+  assert(sqldbal_db_handle(db) == NULL);
+  sqldbal_status_code_clear(db);
+  g_rc = sqldbal_connect(db);
+  assert(g_rc == SQLDBAL_STATUS_OPEN);
+  g_rc = sqldbal_close(db);
+  assert(g_rc == SQLDBAL_STATUS_OPEN);
+
+  /* sqldbal_open_parallel - sqldbal_db_new */
+  g_sqldbal_err_malloc_ctr = 1;
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_SQLITE,
+                             NULL,
+                             NULL,
+                             SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_malloc_ctr = -1;
+
+  /* sqldbal_open_parallel - sqldbal_reallocarray */
+  g_sqldbal_err_realloc_ctr = 0;
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_SQLITE,
+                             NULL,
+                             NULL,
+                             SQLDBAL_STATUS_NOMEM);
+  g_sqldbal_err_realloc_ctr = -1;
+
+  /* sqldbal_open_parallel - driver does not exist */
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_INVALID,
+                             NULL,
+                             NULL,
+                             SQLDBAL_STATUS_DRIVER_NOSUPPORT);
+
+  /* sqldbal_sqlite_connect_start - sqlite3_open_v2 */
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_SQLITE,
+                             "/invalid",
+                             NULL,
+                             SQLDBAL_STATUS_OPEN);
+
+  /* sqldbal_mariadb_connect_start - sqldbal_strtoui */
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_MARIADB,
+                             NULL,
+                             "---",
+                             SQLDBAL_STATUS_PARAM);
+
+  /* sqldbal_mariadb_connect_start - mysql_real_connect_start */
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_MARIADB,
+                             "invalid",
+                             NULL,
+                             SQLDBAL_STATUS_OPEN);
+
+  /* sqldbal_pq_connect_start - PQconnectStart */
+  g_sqldbal_err_PQconnectStart_ctr = 0;
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_POSTGRESQL,
+                             "invalid",
+                             NULL,
+                             SQLDBAL_STATUS_OPEN);
+  g_sqldbal_err_PQconnectStart_ctr = -1;
+
+  /* sqldbal_pq_connect_poll - PQconnectPoll */
+  sqldbal_test_open_parallel(SQLDBAL_DRIVER_POSTGRESQL,
+                             "invalid",
+                             NULL,
+                             SQLDBAL_STATUS_OPEN);
+
+  /* sqldbal_open_parallel - CONNECT_TIMEOUT */
+  sqldbal_test_open_parallel_timeout(SQLDBAL_DRIVER_MARIADB);
+  sqldbal_test_open_parallel_timeout(SQLDBAL_DRIVER_POSTGRESQL);
 }
 
 /**
@@ -3771,6 +8481,9 @@ sqldbal_functional_test_error_conditions(void){
   sqldbal_test_all_error_close();
   sqldbal_test_all_error_exec();
   sqldbal_test_all_error_last_insert_id();
+  sqldbal_test_all_error_ping();
+  sqldbal_test_all_error_stmt_cache();
+  sqldbal_test_all_error_pool();
   sqldbal_test_all_error_stmt_prepare();
   sqldbal_test_all_error_stmt_execute();
   sqldbal_test_all_error_stmt_fetch();
@@ -3778,8 +8491,8 @@ sqldbal_functional_test_error_conditions(void){
   sqldbal_test_all_error_stmt_column();
   sqldbal_test_all_error_stmt_close();
   sqldbal_test_all_error_transaction();
-  sqldbal_test_all_error_pq_is_oid();
   sqldbal_test_all_error_trace();
+  sqldbal_test_all_error_lazy_connect();
 }
 
 /**
@@ -3803,7 +8516,15 @@ sqldbal_functional_test_all(void){
   sqldbal_functional_test_encryption();
   sqldbal_functional_test_timeout();
   sqldbal_functional_test_debug();
+  sqldbal_functional_test_stream_results();
+  sqldbal_functional_test_async();
+  sqldbal_functional_test_pq_binary();
+  sqldbal_functional_test_stmt_cache_db_list();
+  sqldbal_functional_test_pool();
   sqldbal_functional_test_sqlite_open_options();
+  sqldbal_functional_test_sqlite_busy();
+  sqldbal_functional_test_sqlite_pragma();
+  sqldbal_functional_test_sqlite_exec();
   sqldbal_functional_test_errstr();
   sqldbal_functional_test_error_conditions();
 }
@@ -25,25 +25,37 @@
 
 #include "../src/sqldbal.h"
 
-struct sqldbal_pq_db;
+int
+sqldbal_hex2bin_buf(const char *const hex_str,
+                    size_t hexlen,
+                    unsigned char *const bin);
 
-/**
- * Get the PostgreSQL database structure, used by test suite.
- *
- * @param[in] db See @ref sqldbal_db.
- * @return See @ref sqldbal_pq_db.
- */
-const struct sqldbal_pq_db *
-sqldbal_pq_get_pq_db_handle(const struct sqldbal_db *const db);
+void
+sqldbal_pq_int_to_bin(int64_t i64,
+                      size_t nbytes,
+                      unsigned char *const bin);
+
+int64_t
+sqldbal_pq_bin_to_int(const unsigned char *const bin,
+                      size_t nbytes);
+
+double
+sqldbal_pq_bin_to_double(const unsigned char *const bin,
+                         size_t nbytes);
+
+void
+sqldbal_pq_double_to_bin(double d,
+                         size_t nbytes,
+                         unsigned char *const bin);
 
 int
-sqldbal_pq_is_oid(const struct sqldbal_pq_db *const pq_db,
-                  Oid oid,
-                  const char *const typname);
+sqldbal_pq_bin_to_timestamp(const unsigned char *const bin,
+                            size_t nbytes,
+                            int64_t *const ts);
 
-char *
-sqldbal_str_hex2bin(const char *const hex_str,
-                    size_t *const binlen);
+int
+sqldbal_pq_timestamp_to_bin(int64_t ts,
+                            unsigned char *const bin);
 
 void *
 sqldbal_reallocarray(void *ptr,
@@ -95,11 +107,56 @@ sqldbal_stpcpy(char *s1,
 char *
 sqldbal_strdup(const char *s);
 
+uint64_t
+sqldbal_stmt_cache_hash(const char *const sql,
+                        size_t sql_len);
+
+size_t
+sqldbal_bulk_escape(const void *const src,
+                    size_t len,
+                    char *const dst);
+
+int
+sqldbal_sql_has_word(const char *const sql,
+                     size_t sql_len,
+                     const char *const word);
+
+int
+sqldbal_sql_is_read_only(const char *const sql,
+                         size_t sql_len);
+
+int
+sqldbal_sql_transaction_change(const char *const sql,
+                               size_t sql_len);
+
 void
 sqldbal_strtoi64(struct sqldbal_db *const db,
                  const char *const text,
                  int64_t *const lli);
 
+void
+sqldbal_strtod(struct sqldbal_db *const db,
+               const char *const text,
+               double *const d);
+
+size_t
+sqldbal_double_to_str(double d,
+                      char *const str);
+
+int64_t
+sqldbal_days_from_civil(int64_t year,
+                        unsigned int month,
+                        unsigned int day);
+
+size_t
+sqldbal_timestamp_to_str(int64_t ts,
+                         char *const str);
+
+void
+sqldbal_strtotimestamp(struct sqldbal_db *const db,
+                       const char *const text,
+                       int64_t *const ts);
+
 enum sqldbal_status_code
 sqldbal_strtoui(struct sqldbal_db *const db,
                 const char *const str,
@@ -142,6 +199,9 @@ sqldbal_test_seam_mysql_options(MYSQL *mysql,
                                 enum mysql_option option,
                                 const void *arg);
 
+int
+sqldbal_test_seam_mysql_ping(MYSQL *mysql);
+
 int
 sqldbal_test_seam_mysql_rollback(MYSQL *mysql);
 
@@ -182,6 +242,9 @@ sqldbal_test_seam_mysql_stmt_store_result(MYSQL_STMT *stmt);
 PGconn *
 sqldbal_test_seam_PQconnectdb(const char *conninfo);
 
+PGconn *
+sqldbal_test_seam_PQconnectStart(const char *conninfo);
+
 PGresult *
 sqldbal_test_seam_PQexec(PGconn *conn,
                          const char *command);
@@ -283,10 +346,14 @@ int
 sqldbal_test_seam_sqlite3_step(sqlite3_stmt *stmt);
 
 int
-sqldbal_sqlite_trace_hook(unsigned mask,
-                          void *context,
-                          void *P,
-                          void *X);
+sqldbal_sqlite_busy_wait(struct sqldbal_db *const db,
+                         unsigned int attempt);
+
+int
+sqldbal_sqlite_trace_profile(unsigned mask,
+                             void *context,
+                             void *P,
+                             void *X);
 
 int
 sqldbal_test_seam_sqlite3_trace_v2(sqlite3 *db,
@@ -314,6 +381,13 @@ sqldbal_test_seam_sqlite3_trace_v2(sqlite3 *db,
  * condition on the second time it gets called.
  */
 
+/**
+ * Number of successful memory allocations made through
+ * @ref sqldbal_test_seam_calloc, @ref sqldbal_test_seam_malloc, and
+ * @ref sqldbal_test_seam_realloc.
+ */
+extern size_t g_sqldbal_test_num_alloc;
+
 /**
  * Counter for @ref sqldbal_test_seam_calloc.
  *
@@ -363,6 +437,13 @@ extern int g_sqldbal_err_mysql_init_ctr;
  */
 extern int g_sqldbal_err_mysql_options_ctr;
 
+/**
+ * Counter for @ref sqldbal_test_seam_mysql_ping.
+ *
+ * See @ref test_seams_countdown_global for more details.
+ */
+extern int g_sqldbal_err_mysql_ping_ctr;
+
 /**
  * Counter for @ref sqldbal_test_seam_mysql_rollback.
  *
@@ -447,6 +528,13 @@ extern int g_sqldbal_err_mysql_store_result_ctr;
  */
 extern int g_sqldbal_err_PQconnectdb_ctr;
 
+/**
+ * Counter for @ref sqldbal_test_seam_PQconnectStart.
+ *
+ * See @ref test_seams_countdown_global for more details.
+ */
+extern int g_sqldbal_err_PQconnectStart_ctr;
+
 /**
  * Counter for @ref sqldbal_test_seam_PQexec.
  *